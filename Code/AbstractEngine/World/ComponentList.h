@@ -41,6 +41,15 @@ public:
     virtual void Swap(SizeT oldIndex, SizeT newIndex) = 0;
     virtual ComponentData* GetData(SizeT index) = 0;
 
+    // Operations on a single item of the component data type, used by collections
+    // that manage the memory of the items themselves. (ECSUtil::EntityStorageMode::BLOCK)
+    virtual SizeT GetItemSize() const = 0;
+    virtual SizeT GetItemAlignment() const = 0;
+    virtual void ConstructItem(void* item) const = 0;
+    virtual void CopyConstructItem(void* item, const void* source) const = 0;
+    virtual void MoveItem(void* item, void* source) const = 0;
+    virtual void DestroyItem(void* item) const = 0;
+
     void SetType(const Type* value) { mComponentType = value; }
     const Type* GetType() const { return mComponentType; }
 private:
@@ -86,6 +95,25 @@ public:
         return &mComponents[index];
     }
 
+    SizeT GetItemSize() const override { return sizeof(ComponentDataType); }
+    SizeT GetItemAlignment() const override { return alignof(ComponentDataType); }
+    void ConstructItem(void* item) const override
+    {
+        new(item) ComponentDataType();
+    }
+    void CopyConstructItem(void* item, const void* source) const override
+    {
+        new(item) ComponentDataType(*static_cast<const ComponentDataType*>(source));
+    }
+    void MoveItem(void* item, void* source) const override
+    {
+        *static_cast<ComponentDataType*>(item) = std::move(*static_cast<ComponentDataType*>(source));
+    }
+    void DestroyItem(void* item) const override
+    {
+        static_cast<ComponentDataType*>(item)->~ComponentDataType();
+    }
+
 
     TVector<ComponentDataType>* GetArray() { return &mComponents; }
 private:
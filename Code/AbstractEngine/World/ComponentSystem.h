@@ -20,6 +20,7 @@
 // ********************************************************************
 #pragma once
 
+#include "Core/Concurrent/ParallelFor.h"
 #include "Core/Reflection/Object.h"
 #include "Core/Utility/APIResult.h"
 #include "Core/Utility/StdVector.h"
@@ -32,6 +33,9 @@ namespace lf
 
 class World;
 
+// Default amount of component data a single ParallelForEach chunk processes (half of a typical L1 data cache)
+const SizeT COMPONENT_SYSTEM_CHUNK_BYTES = 16 * 1024;
+
 class LF_ABSTRACT_ENGINE_API ComponentSystemFence : public Object
 {
     DECLARE_CLASS(ComponentSystemFence, Object);
@@ -107,6 +111,24 @@ protected:
     template<typename TupleT, typename CallbackT>
     void ForEachEntity(TupleT& tuple, const CallbackT& callback);
 
+    // ********************************************************************
+    // Helper to iterate over a tuple in parallel on the world's task scheduler, 
+    // see ComponentSystemTuple.h
+    // 
+    // The collections are split into chunks of at most 'grainSize' entities and
+    // the callback is invoked once per chunk with contiguous spans of the component
+    // arrays:
+    // 
+    //      callback(SizeT count, ComponentDataA* a, ComponentDataB* b, ...)
+    // 
+    // note: The callback is invoked concurrently from multiple threads, chunks 
+    // never overlap. Returns once every chunk has been processed.
+    // @param grainSize - The maximum number of entities per chunk, 0 sizes the chunk
+    //                    so the data of one chunk is COMPONENT_SYSTEM_CHUNK_BYTES
+    // ********************************************************************
+    template<typename TupleT, typename CallbackT>
+    void ParallelForEach(TupleT& tuple, const CallbackT& callback, SizeT grainSize = 0);
+
     World* GetWorld() { return mWorld; }
 private:
     World* mWorld;
@@ -139,12 +161,15 @@ void ComponentSystem::ForEach(TupleT& tuple, const CallbackT& callback)
     SizeT collectionCount = typedTuple->CollectionCount();
     for (SizeT collection = 0; collection < collectionCount; ++collection)
     {
-        for (SizeT componentIdx = 0, componentCount = typedTuple->Count(collection);
-            componentIdx < componentCount;
-            ++componentIdx
-            )
+        // Iterate block by block, items within a block are contiguous.
+        const SizeT blockCapacity = typedTuple->BlockCapacity(collection);
+        const SizeT componentCount = typedTuple->Count(collection);
+        for (SizeT componentIdx = 0; componentIdx < componentCount;)
         {
-            typedTuple->InvokeWithItems(callback, collection, componentIdx);
+            const SizeT remaining = componentCount - componentIdx;
+            const SizeT count = remaining > blockCapacity ? blockCapacity : remaining;
+            typedTuple->InvokeWithSpanItems(callback, collection, componentIdx, count);
+            componentIdx += count;
         }
     }
 }
@@ -154,12 +179,14 @@ void ComponentSystem::ForEach(TupleT& tuple, SizeT collectionID, const CallbackT
 {
     using TupleType = typename TupleT::TupleType;
     TupleType* typedTuple = reinterpret_cast<TupleType*>(&tuple);
-    for (SizeT componentIdx = 0, componentCount = typedTuple->Count(collectionID);
-        componentIdx < componentCount;
-        ++componentIdx
-        )
+    const SizeT blockCapacity = typedTuple->BlockCapacity(collectionID);
+    const SizeT componentCount = typedTuple->Count(collectionID);
+    for (SizeT componentIdx = 0; componentIdx < componentCount;)
     {
-        typedTuple->InvokeWithItems(callback, collectionID, componentIdx);
+        const SizeT remaining = componentCount - componentIdx;
+        const SizeT count = remaining > blockCapacity ? blockCapacity : remaining;
+        typedTuple->InvokeWithSpanItems(callback, collectionID, componentIdx, count);
+        componentIdx += count;
     }
 }
 
@@ -182,6 +209,52 @@ void ComponentSystem::ForEachEntity(TupleT& tuple, const CallbackT& callback)
     }
 }
 
+// Helper to iterate over a tuple in parallel, see ComponentSystemTuple.h
+template<typename TupleT, typename CallbackT>
+void ComponentSystem::ParallelForEach(TupleT& tuple, const CallbackT& callback, SizeT grainSize)
+{
+    using TupleType = typename TupleT::TupleType;
+    TupleType* typedTuple = reinterpret_cast<TupleType*>(&tuple);
+    if (grainSize == 0)
+    {
+        const SizeT itemSize = TupleType::ITEM_SIZE > 0 ? TupleType::ITEM_SIZE : 1;
+        grainSize = COMPONENT_SYSTEM_CHUNK_BYTES > itemSize ? COMPONENT_SYSTEM_CHUNK_BYTES / itemSize : 1;
+    }
+
+    // Chunks never cross collections or blocks so each chunk is contiguous in every array.
+    struct Chunk
+    {
+        SizeT mCollection;
+        SizeT mBegin;
+        SizeT mCount;
+    };
+    TVector<Chunk> chunks;
+    SizeT collectionCount = typedTuple->CollectionCount();
+    for (SizeT collection = 0; collection < collectionCount; ++collection)
+    {
+        const SizeT blockCapacity = typedTuple->BlockCapacity(collection);
+        const SizeT componentCount = typedTuple->Count(collection);
+        for (SizeT componentIdx = 0; componentIdx < componentCount;)
+        {
+            const SizeT remaining = componentCount - componentIdx;
+            const SizeT blockRemaining = Valid(blockCapacity) ? blockCapacity - componentIdx % blockCapacity : remaining;
+            SizeT count = remaining > grainSize ? grainSize : remaining;
+            count = count > blockRemaining ? blockRemaining : count;
+            chunks.push_back({ collection, componentIdx, count });
+            componentIdx += count;
+        }
+    }
+
+    ParallelFor(GetWorld()->GetScheduler(), 0, chunks.size(), 1, [typedTuple, &chunks, &callback](SizeT begin, SizeT end)
+        {
+            for (SizeT i = begin; i < end; ++i)
+            {
+                const Chunk& chunk = chunks[i];
+                typedTuple->InvokeWithSpans(callback, chunk.mCollection, chunk.mBegin, chunk.mCount);
+            }
+        });
+}
+
 // Built-in Fences
 
 class LF_ABSTRACT_ENGINE_API ComponentSystemRegisterFence : public ComponentSystemFence
@@ -99,13 +99,13 @@ public:
         SizeT componentIndex = mCollection->GetNewIndex(GetId());
         if (Valid(componentIndex))
         {
-            return &(*mCollection->GetNewArray<T>())[componentIndex];
+            return mCollection->GetNewItem<T>(componentIndex);
         }
 
         componentIndex = mCollection->GetIndex(GetId());
         if (Valid(componentIndex))
         {
-            return &(*mCollection->GetCurrentArray<T>())[componentIndex];
+            return mCollection->GetCurrentItem<T>(componentIndex);
         }
 
         return nullptr;
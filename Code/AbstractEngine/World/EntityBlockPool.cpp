@@ -0,0 +1,92 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "AbstractEngine/PCH.h"
+#include "EntityBlockPool.h"
+
+namespace lf
+{
+
+EntityBlockPool::EntityBlockPool()
+: mLock()
+, mFreeBlocks()
+, mBlockCount(0)
+{
+}
+
+EntityBlockPool::~EntityBlockPool()
+{
+    Trim();
+    // If this trips a collection outlived the pool it allocated from.
+    Assert(mBlockCount == 0);
+}
+
+UInt8* EntityBlockPool::Allocate()
+{
+    {
+        ScopeLock lock(mLock);
+        if (!mFreeBlocks.empty())
+        {
+            UInt8* block = mFreeBlocks.back();
+            mFreeBlocks.pop_back();
+            return block;
+        }
+        ++mBlockCount;
+    }
+    return static_cast<UInt8*>(LFAlloc(ENTITY_BLOCK_SIZE, ENTITY_BLOCK_ALIGNMENT));
+}
+
+void EntityBlockPool::Free(UInt8* block)
+{
+    if (!block)
+    {
+        return;
+    }
+    ScopeLock lock(mLock);
+    mFreeBlocks.push_back(block);
+}
+
+void EntityBlockPool::Trim()
+{
+    TVector<UInt8*> blocks;
+    {
+        ScopeLock lock(mLock);
+        blocks.swap(mFreeBlocks);
+        mBlockCount -= blocks.size();
+    }
+    for (UInt8* block : blocks)
+    {
+        LFFree(block);
+    }
+}
+
+SizeT EntityBlockPool::GetBlockCount() const
+{
+    ScopeLock lock(mLock);
+    return mBlockCount;
+}
+
+SizeT EntityBlockPool::GetFreeCount() const
+{
+    ScopeLock lock(mLock);
+    return mFreeBlocks.size();
+}
+
+} // namespace lf
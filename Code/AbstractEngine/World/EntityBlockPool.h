@@ -0,0 +1,65 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Platform/SpinLock.h"
+#include "AbstractEngine/World/WorldTypes.h"
+
+namespace lf
+{
+
+// Size in bytes of a block of entity component data
+constexpr SizeT ENTITY_BLOCK_SIZE = 16 * 1024;
+constexpr SizeT ENTITY_BLOCK_ALIGNMENT = 64;
+
+// ********************************************************************
+// Pool of fixed size (ENTITY_BLOCK_SIZE) blocks used by EntityCollection's
+// in ECSUtil::EntityStorageMode::BLOCK. Blocks returned to the pool are 
+// kept and handed out again on the next allocation instead of going back
+// to the heap.
+// 
+// Thread-Safe: Allocate/Free may be called from any thread.
+// ********************************************************************
+class LF_ABSTRACT_ENGINE_API EntityBlockPool
+{
+public:
+    EntityBlockPool();
+    EntityBlockPool(const EntityBlockPool&) = delete;
+    ~EntityBlockPool();
+    EntityBlockPool& operator=(const EntityBlockPool&) = delete;
+
+    // ** Returns an uninitialized block of ENTITY_BLOCK_SIZE bytes
+    UInt8* Allocate();
+    // ** Returns the block to the pool
+    void Free(UInt8* block);
+    // ** Releases the free blocks back to the heap (blocks in use are unaffected)
+    void Trim();
+
+    // ** Returns the number of blocks allocated from the heap (in use + free)
+    SizeT GetBlockCount() const;
+    // ** Returns the number of blocks waiting in the pool
+    SizeT GetFreeCount() const;
+private:
+    mutable SpinLock mLock;
+    TVector<UInt8*>  mFreeBlocks;
+    SizeT            mBlockCount;
+};
+
+} // namespace lf
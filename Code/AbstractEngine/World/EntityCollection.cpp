@@ -42,15 +42,41 @@ LF_INLINE bool IsValidComponentType(const Type* type)
 EntityCollection::EntityCollection()
 : mEntities()
 , mComponents()
+, mIndex()
 , mNewEntities()
 , mNewComponents()
+, mNewIndex()
 , mDefinitions()
 , mTypes()
 , mStatic(false)
+, mStorageMode(ECSUtil::EntityStorageMode::VECTOR)
+, mBlockPool(nullptr)
+, mBlockCapacity(0)
+, mBlockOffsets()
+, mBlockItemSizes()
+, mBlocks()
+, mNewBlocks()
 {
 
 }
 
+EntityCollection::EntityCollection(ECSUtil::EntityStorageMode storageMode, EntityBlockPool* blockPool)
+: EntityCollection()
+{
+    CriticalAssert(storageMode != ECSUtil::EntityStorageMode::BLOCK || blockPool);
+    mStorageMode = storageMode;
+    mBlockPool = blockPool;
+}
+
+EntityCollection::~EntityCollection()
+{
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        ClearBlocks(mBlocks, mEntities.size());
+        ClearBlocks(mNewBlocks, mNewEntities.size());
+    }
+}
+
 bool EntityCollection::Initialize(const EntityDefinitionAssetType& definition, const TVector<const Component*>& sortedComponents)
 {
     bool staticDef = !definition;
@@ -87,6 +113,12 @@ bool EntityCollection::Initialize(const EntityDefinitionAssetType& definition, c
         {
             mTypes.push_back(component->GetType());
         }
+
+        if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK && !InitializeBlockLayout())
+        {
+            gSysLog.Warning(LogMessage("Entity components do not fit in a block, using vector storage for collection of ") << (definition ? definition.GetPath().AsToken() : Token()));
+            mStorageMode = ECSUtil::EntityStorageMode::VECTOR;
+        }
     }
 
     mStatic = mStatic || staticDef;
@@ -114,10 +146,20 @@ void EntityCollection::Release(const EntityDefinitionAssetType& definition)
 void EntityCollection::ClearData()
 {
     Assert(mDefinitions.empty());
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        ClearBlocks(mBlocks, mEntities.size());
+        ClearBlocks(mNewBlocks, mNewEntities.size());
+    }
     mEntities.clear();
     mComponents.clear();
+    mIndex.Clear();
+    mNewEntities.clear();
     mNewComponents.clear();
+    mNewIndex.Clear();
     mTypes.clear();
+    mBlockOffsets.clear();
+    mBlockItemSizes.clear();
 }
 
 bool EntityCollection::UpdateEntity(EntityId entityId, EntityId updatedFlags)
@@ -140,21 +182,21 @@ bool EntityCollection::UpdateEntity(EntityId entityId, EntityId updatedFlags)
         }
     }
 
-    auto entity = std::find_if(mEntities.begin(), mEntities.end(), [entityId](const EntityIdAtomic& id) { return AtomicLoad(&id) == entityId; });
-    if (entity != mEntities.end())
+    SizeT index = GetIndex(entityId);
+    if (Valid(index))
     {
-        AtomicStore(&(*entity), updatedFlags);
+        AtomicStore(&mEntities[index], updatedFlags);
         return true;
     }
 
     ScopeLock lock(mNewEntityLock);
-    entity = std::find(mNewEntities.begin(), mNewEntities.end(), entityId);
-    if (entity == mNewEntities.end())
+    index = GetNewIndex(entityId);
+    if (Invalid(index))
     {
         gSysLog.Error(LogMessage("Unable to update entity with id ") << id << ", they don't exist.");
         return false;
     }
-    AtomicStore(&(*entity), updatedFlags);
+    AtomicStore(&mNewEntities[index], updatedFlags);
     return true;
 }
 
@@ -162,11 +204,19 @@ void EntityCollection::CreateEntity(EntityId entityId)
 {
     Assert(!Empty());
     ScopeLock lock(mNewEntityLock);
-    mNewEntities.push_back(entityId);
-    for (ComponentList* list : mNewComponents)
+    mNewIndex.Set(entityId, mNewEntities.size());
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
     {
-        list->AddDefault();
+        AddBlockRow(mNewBlocks, mNewEntities.size());
     }
+    else
+    {
+        for (ComponentList* list : mNewComponents)
+        {
+            list->AddDefault();
+        }
+    }
+    mNewEntities.push_back(entityId);
 }
 
 
@@ -196,12 +246,32 @@ void EntityCollection::CommitChanges()
         case ECSUtil::EntityLifeState::DESTROYED:
         {
             SizeT index = static_cast<SizeT>(it - mEntities.begin());
-            for (auto list = mComponents.begin(); list != mComponents.end(); ++list)
+            if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
             {
-                (*list)->SwapRemove(index);
+                const SizeT last = mEntities.size() - 1;
+                if (index != last)
+                {
+                    for (SizeT i = 0; i < mComponents.size(); ++i)
+                    {
+                        mComponents[i]->MoveItem(GetBlockItem(mBlocks, index, i), GetBlockItem(mBlocks, last, i));
+                    }
+                }
+                RemoveBlockRow(mBlocks, mEntities.size());
             }
-            // Remove the entity
+            else
+            {
+                for (auto list = mComponents.begin(); list != mComponents.end(); ++list)
+                {
+                    (*list)->SwapRemove(index);
+                }
+            }
+            // Remove the entity, the last entity takes its row.
+            mIndex.Reset(id);
             it = mEntities.swap_erase(it);
+            if (it != mEntities.end())
+            {
+                mIndex.Set(AtomicLoad(&(*it)), index);
+            }
         } break;
         default:
             break;
@@ -214,18 +284,40 @@ void EntityCollection::CommitChanges()
     for (auto it = mNewEntities.begin(); it != mNewEntities.end(); ++it)
     {
         EntityId id = AtomicLoad(&(*it));
+        mNewIndex.Reset(id);
         if (!ECSUtil::IsDestroyed(id))
         {
             SizeT index = static_cast<SizeT>(it - mNewEntities.begin());
-            for(SizeT i = 0; i < mComponents.size(); ++i)
+            if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
             {
-                mComponents[i]->AddCopy(mNewComponents[i], index);
+                // Rows are only ever appended to the last block, existing rows never move.
+                const SizeT row = mEntities.size();
+                if (row % mBlockCapacity == 0)
+                {
+                    mBlocks.push_back(mBlockPool->Allocate());
+                }
+                for (SizeT i = 0; i < mComponents.size(); ++i)
+                {
+                    mComponents[i]->CopyConstructItem(GetBlockItem(mBlocks, row, i), GetBlockItem(mNewBlocks, index, i));
+                }
             }
+            else
+            {
+                for (SizeT i = 0; i < mComponents.size(); ++i)
+                {
+                    mComponents[i]->AddCopy(mNewComponents[i], index);
+                }
+            }
+            mIndex.Set(id, mEntities.size());
             mEntities.push_back(id);
         }
     }
 
     // Reset the lists
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        ClearBlocks(mNewBlocks, mNewEntities.size());
+    }
     mNewEntities.resize(0);
     for (ComponentList* list : mNewComponents)
     {
@@ -235,48 +327,38 @@ void EntityCollection::CommitChanges()
 
 SizeT EntityCollection::GetIndex(EntityId entityId) const
 {
-    for (SizeT i = 0; i < mEntities.size(); ++i)
+    const SizeT index = mIndex.Get(entityId);
+    if (index < mEntities.size() && AtomicLoad(&mEntities[index]) == entityId)
     {
-        if (AtomicLoad(&mEntities[i]) == entityId)
-        {
-            return i;
-        }
+        return index;
     }
     return INVALID;
 }
 SizeT EntityCollection::GetNewIndex(EntityId entityId) const
 {
-    for (SizeT i = 0; i < mNewEntities.size(); ++i)
+    const SizeT index = mNewIndex.Get(entityId);
+    if (index < mNewEntities.size() && AtomicLoad(&mNewEntities[index]) == entityId)
     {
-        if (AtomicLoad(&mNewEntities[i]) == entityId)
-        {
-            return i;
-        }
+        return index;
     }
     return INVALID;
 }
 
 SizeT EntityCollection::GetIndexSlow(EntityId entityId) const
 {
-    EntityId rawId = ECSUtil::GetId(entityId);
-    for (SizeT i = 0; i < mEntities.size(); ++i)
+    const SizeT index = mIndex.Get(entityId);
+    if (index < mEntities.size() && ECSUtil::GetHandle(AtomicLoad(&mEntities[index])) == ECSUtil::GetHandle(entityId))
     {
-        if (ECSUtil::GetId(AtomicLoad(&mEntities[i])) == rawId)
-        {
-            return i;
-        }
+        return index;
     }
     return INVALID;
 }
 SizeT EntityCollection::GetNewIndexSlow(EntityId entityId) const
 {
-    EntityId rawId = ECSUtil::GetId(entityId);
-    for (SizeT i = 0; i < mNewEntities.size(); ++i)
+    const SizeT index = mNewIndex.Get(entityId);
+    if (index < mNewEntities.size() && ECSUtil::GetHandle(AtomicLoad(&mNewEntities[index])) == ECSUtil::GetHandle(entityId))
     {
-        if (ECSUtil::GetId(AtomicLoad(&mNewEntities[i])) == rawId)
-        {
-            return i;
-        }
+        return index;
     }
     return INVALID;
 }
@@ -298,13 +380,59 @@ EntityId EntityCollection::GetNewEntity(SizeT index) const
     return INVALID_ENTITY_ID;
 }
 
+SizeT EntityCollection::GetTypeIndex(const Type* type) const
+{
+    for (SizeT i = 0; i < mTypes.size(); ++i)
+    {
+        if (mTypes[i] == type)
+        {
+            return i;
+        }
+    }
+    return INVALID;
+}
+
+SizeT EntityCollection::GetBlockCount() const
+{
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        return mBlocks.size();
+    }
+    return mEntities.empty() ? 0 : 1;
+}
+
+SizeT EntityCollection::GetBlockRows(SizeT block) const
+{
+    if (block >= GetBlockCount())
+    {
+        return 0;
+    }
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        const SizeT first = block * mBlockCapacity;
+        const SizeT remaining = mEntities.size() - first;
+        return remaining < mBlockCapacity ? remaining : mBlockCapacity;
+    }
+    return mEntities.size();
+}
+
 ComponentData* EntityCollection::GetCurrentComponent(SizeT entityIndex, SizeT typeIndex)
 {
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        CriticalAssert(entityIndex < mEntities.size() && typeIndex < mTypes.size());
+        return reinterpret_cast<ComponentData*>(GetBlockItem(mBlocks, entityIndex, typeIndex));
+    }
     return mComponents[typeIndex]->GetData(entityIndex);
 }
 
 ComponentData* EntityCollection::GetNewComponent(SizeT entityIndex, SizeT typeIndex)
 {
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        CriticalAssert(entityIndex < mNewEntities.size() && typeIndex < mTypes.size());
+        return reinterpret_cast<ComponentData*>(GetBlockItem(mNewBlocks, entityIndex, typeIndex));
+    }
     return mNewComponents[typeIndex]->GetData(entityIndex);
 }
 
@@ -339,4 +467,84 @@ ComponentList* EntityCollection::GetNewList(const Type* type)
     return nullptr;
 }
 
+bool EntityCollection::InitializeBlockLayout()
+{
+    mBlockOffsets.resize(mComponents.size());
+    mBlockItemSizes.resize(mComponents.size());
+
+    SizeT rowSize = 0;
+    for (SizeT i = 0; i < mComponents.size(); ++i)
+    {
+        if (mComponents[i]->GetItemAlignment() > ENTITY_BLOCK_ALIGNMENT)
+        {
+            return false;
+        }
+        mBlockItemSizes[i] = mComponents[i]->GetItemSize();
+        rowSize += mBlockItemSizes[i];
+    }
+
+    // Each component type gets its own array in the block, the capacity shrinks until 
+    // the arrays fit with their alignment padding.
+    for (mBlockCapacity = ENTITY_BLOCK_SIZE / rowSize; mBlockCapacity > 0; --mBlockCapacity)
+    {
+        SizeT offset = 0;
+        for (SizeT i = 0; i < mComponents.size(); ++i)
+        {
+            const SizeT alignment = mComponents[i]->GetItemAlignment();
+            offset = (offset + alignment - 1) & ~(alignment - 1);
+            mBlockOffsets[i] = offset;
+            offset += mBlockItemSizes[i] * mBlockCapacity;
+        }
+        if (offset <= ENTITY_BLOCK_SIZE)
+        {
+            return true;
+        }
+    }
+    mBlockOffsets.clear();
+    mBlockItemSizes.clear();
+    return false;
+}
+
+void EntityCollection::AddBlockRow(TVector<UInt8*>& blocks, SizeT rows)
+{
+    if (rows % mBlockCapacity == 0)
+    {
+        blocks.push_back(mBlockPool->Allocate());
+    }
+    for (SizeT i = 0; i < mComponents.size(); ++i)
+    {
+        mComponents[i]->ConstructItem(GetBlockItem(blocks, rows, i));
+    }
+}
+
+void EntityCollection::RemoveBlockRow(TVector<UInt8*>& blocks, SizeT rows)
+{
+    const SizeT last = rows - 1;
+    for (SizeT i = 0; i < mComponents.size(); ++i)
+    {
+        mComponents[i]->DestroyItem(GetBlockItem(blocks, last, i));
+    }
+    if (last % mBlockCapacity == 0)
+    {
+        mBlockPool->Free(blocks.back());
+        blocks.pop_back();
+    }
+}
+
+void EntityCollection::ClearBlocks(TVector<UInt8*>& blocks, SizeT rows)
+{
+    for (SizeT row = 0; row < rows; ++row)
+    {
+        for (SizeT i = 0; i < mComponents.size(); ++i)
+        {
+            mComponents[i]->DestroyItem(GetBlockItem(blocks, row, i));
+        }
+    }
+    for (UInt8* block : blocks)
+    {
+        mBlockPool->Free(block);
+    }
+    blocks.clear();
+}
+
 } // namespace lf
\ No newline at end of file
@@ -23,6 +23,8 @@
 #include "Runtime/Asset/AssetReferenceTypes.h"
 #include "AbstractEngine/World/WorldTypes.h"
 #include "AbstractEngine/World/ComponentList.h"
+#include "AbstractEngine/World/EntitySparseIndex.h"
+#include "AbstractEngine/World/EntityBlockPool.h"
 
 namespace lf
 {
@@ -49,6 +51,15 @@ class LF_ABSTRACT_ENGINE_API EntityCollection
 {
 public:
     EntityCollection();
+    // ********************************************************************
+    // Creates a collection with the storage mode, in EntityStorageMode::BLOCK
+    // the blocks are allocated from the block pool which must outlive the 
+    // collection.
+    // ********************************************************************
+    EntityCollection(ECSUtil::EntityStorageMode storageMode, EntityBlockPool* blockPool);
+    EntityCollection(const EntityCollection&) = delete;
+    ~EntityCollection();
+    EntityCollection& operator=(const EntityCollection&) = delete;
 
     // Initialize the collection with the definition. (If first definition, components lists are created)
     // ********************************************************************
@@ -73,20 +84,50 @@ public:
 
     void CommitChanges();
 
+    // Returns the row of the entity, the id must match exactly (including flags)
     SizeT GetIndex(EntityId entityId) const;
     SizeT GetNewIndex(EntityId entityId) const;
 
+    // Returns the row of the entity, ignoring the priority/life flags of the id.
     SizeT GetIndexSlow(EntityId entityId) const;
     SizeT GetNewIndexSlow(EntityId entityId) const;
 
     EntityId GetEntity(SizeT index) const;
     EntityId GetNewEntity(SizeT index) const;
 
+    // Returns the number of 'updating' entities
+    SizeT Size() const { return mEntities.size(); }
+
+    ECSUtil::EntityStorageMode GetStorageMode() const { return mStorageMode; }
+    // Returns the index of the component type in GetTypes() or INVALID
+    SizeT GetTypeIndex(const Type* type) const;
+
+    // ********************************************************************
+    // Block Accessors, rows [block * GetBlockCapacity(), block * GetBlockCapacity() + GetBlockRows(block))
+    // of every component type are contiguous within a block.
+    //
+    // In EntityStorageMode::VECTOR the whole collection is one block and 
+    // the capacity is INVALID.
+    // ********************************************************************
+    SizeT GetBlockCapacity() const { return mStorageMode == ECSUtil::EntityStorageMode::BLOCK ? mBlockCapacity : INVALID; }
+    SizeT GetBlockCount() const;
+    SizeT GetBlockRows(SizeT block) const;
+    template<typename ComponentT>
+    typename ComponentT::ComponentDataType* GetBlockArray(SizeT block);
+
+    // ********************************************************************
+    // EntityStorageMode::BLOCK only, returns the address of the component
+    // of the 'updating' entity at index. (No bounds checking)
+    // ********************************************************************
+    UInt8* GetBlockItem(SizeT index, SizeT typeIndex) { return GetBlockItem(mBlocks, index, typeIndex); }
+
     // ********************************************************************
     // Accessor to the 'Entity' component array (intended use for data 
     // traversal, do not manipulate the array itself!)
     // 
     // Pointer is invalidated if the collection becomes empty/reinitializes.
+    // 
+    // Returns null in EntityStorageMode::BLOCK, see GetBlockArray.
     // ********************************************************************
     template<typename ComponentT>
     TVector<typename ComponentT::ComponentDataType>* GetCurrentArray();
@@ -95,10 +136,18 @@ public:
     // traversal, do not manipulate the array itself!)
     // 
     // Pointer is invalidated if the collection becomes empty/reinitializes.
+    // 
+    // Returns null in EntityStorageMode::BLOCK.
     // ********************************************************************
     template<typename ComponentT>
     TVector<typename ComponentT::ComponentDataType>* GetNewArray();
 
+    // Accessors to the component of the 'updating'/'new' entity at index in either storage mode.
+    template<typename ComponentT>
+    typename ComponentT::ComponentDataType* GetCurrentItem(SizeT index);
+    template<typename ComponentT>
+    typename ComponentT::ComponentDataType* GetNewItem(SizeT index);
+
     ComponentData* GetCurrentComponent(SizeT entityIndex, SizeT typeIndex);
     ComponentData* GetNewComponent(SizeT entityIndex, SizeT typeIndex);
 
@@ -107,24 +156,52 @@ private:
     ComponentList* GetCurrentList(const Type* type);
     ComponentList* GetNewList(const Type* type);
 
+    // Computes the offset of each component array within a block, returns false if a row doesn't fit in a block.
+    bool InitializeBlockLayout();
+    UInt8* GetBlockItem(const TVector<UInt8*>& blocks, SizeT index, SizeT typeIndex) const
+    {
+        return blocks[index / mBlockCapacity] + mBlockOffsets[typeIndex] + (index % mBlockCapacity) * mBlockItemSizes[typeIndex];
+    }
+    // Default constructs the components of a new last row (rows = number of rows before the new row)
+    void AddBlockRow(TVector<UInt8*>& blocks, SizeT rows);
+    // Destroys the components of the last row (rows = number of rows including the last row)
+    void RemoveBlockRow(TVector<UInt8*>& blocks, SizeT rows);
+    // Destroys the components of all rows and returns the blocks to the pool
+    void ClearBlocks(TVector<UInt8*>& blocks, SizeT rows);
+
     // List of 'updating' entities
     TVector<EntityIdAtomic> mEntities; // note: EntityId (flags) can change at anytime on any thread.
     TVector<ComponentListPtr> mComponents;
+    EntitySparseIndex       mIndex; // Raw Id => mEntities row
 
     // List of 'entities just created'
     SpinLock mNewEntityLock;
     TVector<EntityIdAtomic> mNewEntities;
     TVector<ComponentListPtr> mNewComponents;
+    EntitySparseIndex       mNewIndex; // Raw Id => mNewEntities row
 
     TVector<EntityDefinitionAssetType>   mDefinitions;
     TVector<const Type*>                 mTypes; // Debug Information/Utility
     bool                                mStatic;
+
+    // Block Storage
+    ECSUtil::EntityStorageMode mStorageMode;
+    EntityBlockPool*           mBlockPool;
+    SizeT                      mBlockCapacity;  // Rows per block
+    TVector<SizeT>             mBlockOffsets;   // Type Index => Offset of the component array within a block
+    TVector<SizeT>             mBlockItemSizes; // Type Index => Size of the component
+    TVector<UInt8*>            mBlocks;         // Blocks of 'updating' entities
+    TVector<UInt8*>            mNewBlocks;      // Blocks of 'entities just created'
 };
 
 template<typename ComponentT>
 TVector<typename ComponentT::ComponentDataType>* EntityCollection::GetCurrentArray()
 {
     LF_STATIC_IS_A(ComponentT, Component);
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        return nullptr;
+    }
     ComponentList* list = GetCurrentList(typeof(ComponentT));
     if (!list)
     {
@@ -139,6 +216,10 @@ template<typename ComponentT>
 TVector<typename ComponentT::ComponentDataType>* EntityCollection::GetNewArray()
 {
     LF_STATIC_IS_A(ComponentT, Component);
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        return nullptr;
+    }
     ComponentList* list = GetNewList(typeof(ComponentT));
     if (!list)
     {
@@ -149,4 +230,62 @@ TVector<typename ComponentT::ComponentDataType>* EntityCollection::GetNewArray()
     return componentList->GetArray();
 }
 
+template<typename ComponentT>
+typename ComponentT::ComponentDataType* EntityCollection::GetBlockArray(SizeT block)
+{
+    LF_STATIC_IS_A(ComponentT, Component);
+    using ComponentDataType = typename ComponentT::ComponentDataType;
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        const SizeT typeIndex = GetTypeIndex(typeof(ComponentT));
+        if (Invalid(typeIndex) || block >= mBlocks.size())
+        {
+            return nullptr;
+        }
+        return reinterpret_cast<ComponentDataType*>(mBlocks[block] + mBlockOffsets[typeIndex]);
+    }
+
+    TVector<ComponentDataType>* components = GetCurrentArray<ComponentT>();
+    return components && block == 0 && !components->empty() ? components->data() : nullptr;
+}
+
+template<typename ComponentT>
+typename ComponentT::ComponentDataType* EntityCollection::GetCurrentItem(SizeT index)
+{
+    LF_STATIC_IS_A(ComponentT, Component);
+    using ComponentDataType = typename ComponentT::ComponentDataType;
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        const SizeT typeIndex = GetTypeIndex(typeof(ComponentT));
+        if (Invalid(typeIndex) || index >= mEntities.size())
+        {
+            return nullptr;
+        }
+        return reinterpret_cast<ComponentDataType*>(GetBlockItem(mBlocks, index, typeIndex));
+    }
+
+    TVector<ComponentDataType>* components = GetCurrentArray<ComponentT>();
+    return components && index < components->size() ? &(*components)[index] : nullptr;
+}
+
+template<typename ComponentT>
+typename ComponentT::ComponentDataType* EntityCollection::GetNewItem(SizeT index)
+{
+    LF_STATIC_IS_A(ComponentT, Component);
+    using ComponentDataType = typename ComponentT::ComponentDataType;
+    if (mStorageMode == ECSUtil::EntityStorageMode::BLOCK)
+    {
+        const SizeT typeIndex = GetTypeIndex(typeof(ComponentT));
+        ScopeLock lock(mNewEntityLock);
+        if (Invalid(typeIndex) || index >= mNewEntities.size())
+        {
+            return nullptr;
+        }
+        return reinterpret_cast<ComponentDataType*>(GetBlockItem(mNewBlocks, index, typeIndex));
+    }
+
+    TVector<ComponentDataType>* components = GetNewArray<ComponentT>();
+    return components && index < components->size() ? &(*components)[index] : nullptr;
+}
+
 } // namespace lf
\ No newline at end of file
@@ -0,0 +1,142 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "AbstractEngine/PCH.h"
+#include "EntityCommandBuffer.h"
+
+namespace lf
+{
+
+EntityCommandBuffer::EntityCommandBuffer(SizeT threadId)
+: mThreadId(threadId)
+, mPages()
+, mPageIndex(0)
+, mPageOffset(0)
+, mFirst(nullptr)
+, mLast(nullptr)
+, mCommandCount(0)
+, mDeferredCount(0)
+{
+}
+
+EntityCommandBuffer::~EntityCommandBuffer()
+{
+    Reset();
+    for (Page& page : mPages)
+    {
+        LFFree(page.mData);
+    }
+    mPages.clear();
+}
+
+EntityCommandBuffer::DeferredEntity EntityCommandBuffer::Create(const EntityDefinition* definition, UInt32 sortKey)
+{
+    Assert(definition != nullptr);
+    Command* command = AddCommand(CT_CREATE, sortKey);
+    command->mDeferred = mDeferredCount++;
+    command->mDefinition = definition;
+    return { command->mDeferred };
+}
+
+void EntityCommandBuffer::Destroy(EntityId entity, UInt32 sortKey)
+{
+    Command* command = AddCommand(CT_DESTROY, sortKey);
+    command->mEntity = entity;
+}
+
+void EntityCommandBuffer::Destroy(const DeferredEntity& entity, UInt32 sortKey)
+{
+    Assert(entity.mIndex < mDeferredCount);
+    Command* command = AddCommand(CT_DESTROY, sortKey);
+    command->mDeferred = entity.mIndex;
+}
+
+void EntityCommandBuffer::Reset()
+{
+    for (Command* command = mFirst; command; command = command->mNext)
+    {
+        if (command->mDestroy)
+        {
+            command->mDestroy(command->mData);
+        }
+    }
+    mFirst = nullptr;
+    mLast = nullptr;
+    mCommandCount = 0;
+    mDeferredCount = 0;
+    mPageIndex = 0;
+    mPageOffset = 0;
+}
+
+EntityCommandBuffer::Command* EntityCommandBuffer::AddCommand(CommandType type, UInt32 sortKey)
+{
+    Command* command = static_cast<Command*>(Allocate(sizeof(Command), alignof(Command)));
+    command->mNext = nullptr;
+    command->mType = type;
+    command->mSortKey = sortKey;
+    command->mDeferred = INVALID32;
+    command->mEntity = INVALID_ENTITY_ID;
+    command->mDefinition = nullptr;
+    command->mComponentType = nullptr;
+    command->mData = nullptr;
+    command->mCopy = nullptr;
+    command->mDestroy = nullptr;
+
+    if (mLast)
+    {
+        mLast->mNext = command;
+    }
+    else
+    {
+        mFirst = command;
+    }
+    mLast = command;
+    ++mCommandCount;
+    return command;
+}
+
+void* EntityCommandBuffer::Allocate(SizeT size, SizeT alignment)
+{
+    // Offsets are aligned relative to the start of the page.
+    Assert(alignment <= PAGE_ALIGNMENT);
+    while (mPageIndex < mPages.size())
+    {
+        const Page& page = mPages[mPageIndex];
+        const SizeT offset = (mPageOffset + alignment - 1) & ~(alignment - 1);
+        if (offset + size <= page.mSize)
+        {
+            mPageOffset = offset + size;
+            return page.mData + offset;
+        }
+        ++mPageIndex;
+        mPageOffset = 0;
+    }
+
+    // Out of pages, oversized allocations get a page of their own.
+    Page page;
+    page.mSize = size > PAGE_SIZE ? size : PAGE_SIZE;
+    page.mData = static_cast<UInt8*>(LFAlloc(page.mSize, PAGE_ALIGNMENT));
+    mPages.push_back(page);
+    mPageIndex = mPages.size() - 1;
+    mPageOffset = size;
+    return page.mData;
+}
+
+} // namespace lf
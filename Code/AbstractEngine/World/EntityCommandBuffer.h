@@ -0,0 +1,172 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Memory/SmartPointer.h"
+#include "Runtime/Reflection/ReflectionTypes.h"
+#include "AbstractEngine/World/WorldTypes.h"
+#include "AbstractEngine/World/Component.h"
+
+namespace lf
+{
+
+class EntityDefinition;
+class Type;
+
+// ********************************************************************
+// Records entity commands (create/destroy/set component) to be played 
+// back by the world when it commits the frame's changes to the entity 
+// collections. (World::GetCommandBuffer)
+// 
+// Each thread records into its own buffer so recording takes no locks,
+// commands and their component data are stored in arena pages that are
+// reused from frame to frame.
+// 
+// Playback order is deterministic: all creates, then all component writes,
+// then all destroys. Within each batch commands are sorted by their sort
+// key and commands with the same key keep the order they were recorded in.
+// (Use unique keys, eg. the item index of a parallel loop, when the order 
+// of commands recorded on different threads matters)
+// 
+// Thread-Safety: A buffer may only be used by the thread that owns it.
+// ********************************************************************
+class LF_ABSTRACT_ENGINE_API EntityCommandBuffer
+{
+public:
+    using CopyFunc = void(*)(void* dest, const void* source);
+    using DestroyFunc = void(*)(void* data);
+
+    enum CommandType : UInt32
+    {
+        CT_CREATE,
+        CT_SET_COMPONENT,
+        CT_DESTROY
+    };
+
+    struct Command
+    {
+        Command*                mNext;
+        CommandType             mType;
+        UInt32                  mSortKey;
+        UInt32                  mDeferred;      // Index of the entity created by this buffer, or INVALID32 (see mEntity)
+        EntityId                mEntity;        // Id of an existing entity
+        const EntityDefinition* mDefinition;    // CT_CREATE
+        const Type*             mComponentType; // CT_SET_COMPONENT
+        void*                   mData;          // CT_SET_COMPONENT
+        CopyFunc                mCopy;          // CT_SET_COMPONENT
+        DestroyFunc             mDestroy;       // CT_SET_COMPONENT
+    };
+
+    // Handle to an entity that will be created when the buffer is played back.
+    struct DeferredEntity
+    {
+        UInt32 mIndex;
+    };
+
+    EntityCommandBuffer(SizeT threadId);
+    EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+    ~EntityCommandBuffer();
+    EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+    // ** Records the creation of an entity with the definition (must be registered with the world)
+    DeferredEntity Create(const EntityDefinition* definition, UInt32 sortKey = 0);
+    // ** Records the destruction of an existing entity (ignores the life/priority flags of the id)
+    void Destroy(EntityId entity, UInt32 sortKey = 0);
+    // ** Records the destruction of an entity created by the buffer
+    void Destroy(const DeferredEntity& entity, UInt32 sortKey = 0);
+
+    // ** Records a write of the component data of an existing entity
+    template<typename ComponentT>
+    void SetComponent(EntityId entity, const typename ComponentT::ComponentDataType& data, UInt32 sortKey = 0);
+    // ** Records a write of the component data of an entity created by the buffer
+    template<typename ComponentT>
+    void SetComponent(const DeferredEntity& entity, const typename ComponentT::ComponentDataType& data, UInt32 sortKey = 0);
+
+    // ** Releases the commands, the arena pages are kept for the next frame.
+    void Reset();
+
+    SizeT GetThreadId() const { return mThreadId; }
+    SizeT GetCommandCount() const { return mCommandCount; }
+    SizeT GetDeferredCount() const { return mDeferredCount; }
+    const Command* GetFirstCommand() const { return mFirst; }
+    bool Empty() const { return mCommandCount == 0; }
+private:
+    enum : SizeT 
+    { 
+        PAGE_SIZE = 16 * 1024,
+        PAGE_ALIGNMENT = 64
+    };
+    struct Page
+    {
+        UInt8* mData;
+        SizeT  mSize;
+    };
+
+    Command* AddCommand(CommandType type, UInt32 sortKey);
+    void* Allocate(SizeT size, SizeT alignment);
+
+    template<typename DataT>
+    static void CopyData(void* dest, const void* source) { *static_cast<DataT*>(dest) = *static_cast<const DataT*>(source); }
+    template<typename DataT>
+    static void DestroyData(void* data) { static_cast<DataT*>(data)->~DataT(); }
+
+    template<typename ComponentT>
+    void AddSetComponent(UInt32 deferred, EntityId entity, const typename ComponentT::ComponentDataType& data, UInt32 sortKey);
+
+    SizeT         mThreadId;
+    TVector<Page> mPages;
+    SizeT         mPageIndex;
+    SizeT         mPageOffset;
+
+    Command*      mFirst;
+    Command*      mLast;
+    SizeT         mCommandCount;
+    UInt32        mDeferredCount;
+};
+DECLARE_PTR(EntityCommandBuffer);
+
+template<typename ComponentT>
+void EntityCommandBuffer::SetComponent(EntityId entity, const typename ComponentT::ComponentDataType& data, UInt32 sortKey)
+{
+    AddSetComponent<ComponentT>(INVALID32, entity, data, sortKey);
+}
+
+template<typename ComponentT>
+void EntityCommandBuffer::SetComponent(const DeferredEntity& entity, const typename ComponentT::ComponentDataType& data, UInt32 sortKey)
+{
+    Assert(entity.mIndex < mDeferredCount);
+    AddSetComponent<ComponentT>(entity.mIndex, INVALID_ENTITY_ID, data, sortKey);
+}
+
+template<typename ComponentT>
+void EntityCommandBuffer::AddSetComponent(UInt32 deferred, EntityId entity, const typename ComponentT::ComponentDataType& data, UInt32 sortKey)
+{
+    LF_STATIC_IS_A(ComponentT, Component);
+    using ComponentDataType = typename ComponentT::ComponentDataType;
+    Command* command = AddCommand(CT_SET_COMPONENT, sortKey);
+    command->mDeferred = deferred;
+    command->mEntity = entity;
+    command->mComponentType = typeof(ComponentT);
+    command->mData = new(Allocate(sizeof(ComponentDataType), alignof(ComponentDataType))) ComponentDataType(data);
+    command->mCopy = &CopyData<ComponentDataType>;
+    command->mDestroy = &DestroyData<ComponentDataType>;
+}
+
+} // namespace lf
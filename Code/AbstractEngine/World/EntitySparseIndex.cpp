@@ -0,0 +1,72 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "AbstractEngine/PCH.h"
+#include "EntitySparseIndex.h"
+
+namespace lf
+{
+
+EntitySparseIndex::EntitySparseIndex()
+: mPages()
+{
+}
+
+EntitySparseIndex::~EntitySparseIndex()
+{
+    Clear();
+}
+
+void EntitySparseIndex::Set(EntityId id, SizeT index)
+{
+    Assert(index < INVALID32);
+    const EntityId rawId = ECSUtil::GetId(id);
+    UInt32*& page = mPages[rawId / PAGE_SIZE];
+    if (!page)
+    {
+        page = static_cast<UInt32*>(LFAlloc(sizeof(UInt32) * PAGE_SIZE, alignof(UInt32)));
+        memset(page, 0xFF, sizeof(UInt32) * PAGE_SIZE);
+    }
+    page[rawId % PAGE_SIZE] = static_cast<UInt32>(index);
+}
+
+void EntitySparseIndex::Reset(EntityId id)
+{
+    const EntityId rawId = ECSUtil::GetId(id);
+    UInt32* page = mPages[rawId / PAGE_SIZE];
+    if (page)
+    {
+        page[rawId % PAGE_SIZE] = INVALID32;
+    }
+}
+
+void EntitySparseIndex::Clear()
+{
+    for (UInt32*& page : mPages)
+    {
+        if (page)
+        {
+            LFFree(page);
+            page = nullptr;
+        }
+    }
+}
+
+} // namespace lf
@@ -0,0 +1,78 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "AbstractEngine/World/WorldTypes.h"
+
+namespace lf
+{
+
+// ********************************************************************
+// Sparse half of a sparse set keyed by the raw id of an entity. Maps
+// ECSUtil::GetId(id) to a dense index (eg. the row of an entity within
+// an EntityCollection) in O(1).
+// 
+// The owner keeps the dense array of entity ids, a lookup is only valid
+// if the id at the dense index matches the id being searched for. Since
+// the id includes the generation (ECSUtil::GetGeneration) a recycled raw 
+// id never resolves for a stale id.
+// 
+// Slots are stored in fixed size pages that are allocated the first time
+// an id in their range is set. Pages are never moved so a lookup may run
+// while another thread sets an id in a different page. (Same rules as the
+// dense array otherwise, mutation must be synchronized by the owner)
+// ********************************************************************
+class LF_ABSTRACT_ENGINE_API EntitySparseIndex
+{
+public:
+    EntitySparseIndex();
+    EntitySparseIndex(const EntitySparseIndex&) = delete;
+    ~EntitySparseIndex();
+    EntitySparseIndex& operator=(const EntitySparseIndex&) = delete;
+
+    // ** Returns the dense index of the raw id or INVALID
+    SizeT Get(EntityId id) const
+    {
+        const EntityId rawId = ECSUtil::GetId(id);
+        const UInt32* page = mPages[rawId / PAGE_SIZE];
+        if (!page)
+        {
+            return INVALID;
+        }
+        const UInt32 index = page[rawId % PAGE_SIZE];
+        return Invalid(index) ? INVALID : static_cast<SizeT>(index);
+    }
+    // ** Maps the raw id to the dense index
+    void Set(EntityId id, SizeT index);
+    // ** Unmaps the raw id
+    void Reset(EntityId id);
+    // ** Unmaps all ids and releases the pages
+    void Clear();
+private:
+    enum : SizeT 
+    { 
+        PAGE_SIZE = 4096,
+        PAGE_COUNT = (ECSUtil::ENTITY_ID_BITMASK + 1) / PAGE_SIZE
+    };
+
+    UInt32* mPages[PAGE_COUNT];
+};
+
+} // namespace lf
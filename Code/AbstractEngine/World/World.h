@@ -32,6 +32,8 @@ class EntityCollection;
 DECLARE_ATOMIC_WPTR(Entity);
 DECLARE_ASSET(EntityDefinition);
 class ComponentSystem;
+class TaskSchedulerBase;
+class EntityCommandBuffer;
 DECLARE_ATOMIC_PTR(WorldScene);
 
 
@@ -144,6 +146,20 @@ public:
 
     virtual void RegisterScene(const WorldSceneAtomicPtr& scene) = 0;
 
+    // ********************************************************************
+    // Accessor to the scheduler systems can distribute work on during their 
+    // update. (eg. ComponentSystem::ParallelForEach)
+    // ********************************************************************
+    virtual TaskSchedulerBase& GetScheduler() = 0;
+    // ********************************************************************
+    // Accessor to the command buffer of the calling thread. Commands are 
+    // played back when the world commits the frame's changes. (end of frame)
+    //
+    // Systems should acquire the buffer once per update (or per parallel 
+    // work item) rather than once per command.
+    // ********************************************************************
+    virtual EntityCommandBuffer& GetCommandBuffer() = 0;
+
     virtual bool LogEntityIdChanges() const = 0;
     virtual bool LogEntityAddRemove() const = 0;
     virtual bool LogFenceUpdate() const = 0;
@@ -40,19 +40,15 @@ enum : EntityId { INVALID_ENTITY_ID = INVALID32 };
 namespace ECSUtil
 {
 constexpr EntityId ENTITY_ID_BITMASK = 0xFFFFFU;
-constexpr EntityId ENTITY_FLAG_BITMASK = 0xFFF0000;
+constexpr EntityId ENTITY_FLAG_BITMASK = 0xFFF00000;
 constexpr EntityId ENTITY_FLAG_HIGH_PRIORITY = 1U << 31U;
 constexpr EntityId ENTITY_FLAG_LOW_PRIORITY = 1U << 30U;
 constexpr EntityId ENTITY_FLAG_LIFE_MINOR_BIT = 1U << 29U;
 constexpr EntityId ENTITY_FLAG_LIFE_MAJOR_BIT = 1U << 28U;
-constexpr EntityId ENTITY_FLAG_RESERVED_2 = 1U << 27U;
-constexpr EntityId ENTITY_FLAG_RESERVED_3 = 1U << 26U;
-constexpr EntityId ENTITY_FLAG_RESERVED_4 = 1U << 25U;
-constexpr EntityId ENTITY_FLAG_RESERVED_5 = 1U << 24U;
-constexpr EntityId ENTITY_FLAG_RESERVED_6 = 1U << 23U;
-constexpr EntityId ENTITY_FLAG_RESERVED_7 = 1U << 22U;
-constexpr EntityId ENTITY_FLAG_RESERVED_8 = 1U << 21U;
-constexpr EntityId ENTITY_FLAG_RESERVED_9 = 1U << 20U;
+// Generation of the raw id, incremented each time the world recycles the raw id so
+// stale ids of destroyed entities no longer match. (Bits 20-27)
+constexpr EntityId ENTITY_GENERATION_BITMASK = 0xFF00000U;
+constexpr EntityId ENTITY_GENERATION_SHIFT = 20U;
 
 // Entity Priority is extra information used by systems.
 // 
@@ -120,6 +116,14 @@ CONCURRENT,
 SERIAL_DISTRIBUTED,
 CONCURRENT_DISTRIBUTED);
 
+// Defines how an EntityCollection stores the component data of its entities
+// Vector - One growable array per component type, growth may move every row.
+// Block - Rows are stored in fixed size blocks (see EntityBlockPool) with one array per 
+//         component type in each block. Growth allocates a new block and never moves a row.
+DECLARE_STRICT_ENUM(EntityStorageMode,
+VECTOR,
+BLOCK);
+
 using UpdateCallback = TCallback<void>;
 
 // Priority
@@ -219,6 +223,20 @@ LF_FORCE_INLINE EntityId GetId(EntityId id)
 {
     return (id & ENTITY_ID_BITMASK);
 }
+// Generation
+LF_FORCE_INLINE EntityId GetGeneration(EntityId id)
+{
+    return (id & ENTITY_GENERATION_BITMASK) >> ENTITY_GENERATION_SHIFT;
+}
+LF_FORCE_INLINE EntityId SetGeneration(EntityId id, EntityId generation)
+{
+    return (id & ~ENTITY_GENERATION_BITMASK) | ((generation << ENTITY_GENERATION_SHIFT) & ENTITY_GENERATION_BITMASK);
+}
+// Raw id and generation without the priority/life flags, identifies one entity for the lifetime of the world.
+LF_FORCE_INLINE EntityId GetHandle(EntityId id)
+{
+    return (id & (ENTITY_ID_BITMASK | ENTITY_GENERATION_BITMASK));
+}
 
 } // namespace ECSUtil
 
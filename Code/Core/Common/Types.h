@@ -28,6 +28,13 @@
 #elif defined(_WIN32)
 #define LF_OS_WINDOWS
 #define LF_PLATFORM_32
+#elif defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+#define LF_OS_POSIX
+#if defined(__LP64__)
+#define LF_PLATFORM_64
+#else
+#define LF_PLATFORM_32
+#endif
 #else
 #error "Unknown platform"
 #endif
@@ -109,6 +116,7 @@ using AtomicU32 = unsigned long;
 enum CopyOnWriteTag { COPY_ON_WRITE };
 enum LazyTag { LAZY };
 enum AcquireTag { ACQUIRE };
+enum ImmortalTag { IMMORTAL };
 enum ASyncTag { ASYNC };
 
 const UInt8 INVALID8 = static_cast<UInt8>(-1);
@@ -0,0 +1,106 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "ParallelFor.h"
+#include "Core/Platform/Atomic.h"
+#include "Core/Platform/Thread.h"
+
+namespace lf {
+
+struct ParallelForContext
+{
+    TaskSchedulerBase*              mScheduler;
+    const ParallelRangeCallback*    mCallback;
+    SizeT                           mBegin;
+    SizeT                           mEnd;
+    SizeT                           mGrainSize;
+    // Number of queued halves that have not completed yet.
+    volatile Atomic32               mPending;
+};
+
+// A range can be halved at most once per bit of SizeT.
+static const SizeT PARALLEL_MAX_SPLITS = sizeof(SizeT) * 8;
+
+static void ParallelForSplit(ParallelForContext* context, SizeT firstChunk, SizeT lastChunk)
+{
+    TaskHandle handles[PARALLEL_MAX_SPLITS];
+    SizeT numHandles = 0;
+
+    // Queue the upper half and keep splitting the lower half until we're down to a single chunk.
+    while (lastChunk - firstChunk > 1)
+    {
+        const SizeT middle = firstChunk + (lastChunk - firstChunk) / 2;
+        const SizeT upper = lastChunk;
+        AtomicIncrement32(&context->mPending);
+        handles[numHandles++] = context->mScheduler->RunTask([context, middle, upper](void*)
+            {
+                ParallelForSplit(context, middle, upper);
+                AtomicDecrement32(&context->mPending);
+            });
+        lastChunk = middle;
+    }
+
+    const SizeT begin = context->mBegin + firstChunk * context->mGrainSize;
+    const SizeT end = (context->mEnd - begin) > context->mGrainSize ? begin + context->mGrainSize : context->mEnd;
+    context->mCallback->Invoke(begin, end);
+
+    // Join: anything that has not been popped by a worker yet is executed inline, smallest first.
+    // This also guarantees progress when every worker is inside a ParallelFor.
+    while (numHandles > 0)
+    {
+        handles[--numHandles].Wait();
+    }
+}
+
+void ParallelForRange(TaskSchedulerBase& scheduler, SizeT begin, SizeT end, SizeT grainSize, const ParallelRangeCallback& callback)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    // A synchronous scheduler only runs tasks from UpdateSync, splitting would just queue the chunks for
+    // the caller to run anyway.
+    const SizeT grain = ParallelGrainSize(end - begin, grainSize);
+    if (end - begin <= grain || !scheduler.IsAsync())
+    {
+        callback.Invoke(begin, end);
+        return;
+    }
+
+    ParallelForContext context;
+    context.mScheduler = &scheduler;
+    context.mCallback = &callback;
+    context.mBegin = begin;
+    context.mEnd = end;
+    context.mGrainSize = grain;
+    context.mPending = 0;
+
+    ParallelForSplit(&context, 0, (end - begin + grain - 1) / grain);
+
+    // Halves that were popped by workers may still be running.
+    while (AtomicLoad(&context.mPending) > 0)
+    {
+        SleepCallingThread(0);
+    }
+}
+
+} // namespace lf
@@ -0,0 +1,115 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Concurrent/TaskScheduler.h"
+#include "Core/Utility/SmartCallback.h"
+#include "Core/Utility/StdVector.h"
+
+namespace lf {
+
+// Callback invoked with a contiguous sub-range [begin, end) of the parallel loop.
+using ParallelRangeCallback = TCallback<void, SizeT, SizeT>;
+
+// When the grain size is 0 the range is divided into roughly this many chunks.
+const SizeT PARALLEL_AUTO_CHUNK_COUNT = 64;
+
+// **********************************
+// Computes the grain size used for a range of 'count' items.
+// @param count -- The number of items in the range
+// @param grainSize -- The requested grain size, 0 will select one based on PARALLEL_AUTO_CHUNK_COUNT
+// **********************************
+LF_INLINE SizeT ParallelGrainSize(SizeT count, SizeT grainSize)
+{
+    if (grainSize > 0)
+    {
+        return grainSize;
+    }
+    SizeT grain = count / PARALLEL_AUTO_CHUNK_COUNT;
+    return grain > 0 ? grain : 1;
+}
+
+// **********************************
+// Executes the callback over the range [begin, end) in chunks of at most 'grainSize' items.
+//
+// The range is split recursively in halves, one half is queued on the scheduler so idle workers
+// can pick it up and the other half is split further by the current thread. Once a thread reaches
+// a single chunk it executes it and then joins any queued halves it spawned (running them inline
+// if no worker has popped them yet) so the calling thread does useful work instead of blocking.
+//
+// note: The callback may be invoked from any worker thread concurrently.
+// @param scheduler -- The scheduler to distribute the sub-ranges on
+// @param begin -- The first index of the range
+// @param end -- One past the last index of the range
+// @param grainSize -- The maximum number of items a single invocation of the callback processes (0 for automatic)
+// @param callback -- The callback to invoke with each sub-range
+// **********************************
+LF_CORE_API void ParallelForRange(TaskSchedulerBase& scheduler, SizeT begin, SizeT end, SizeT grainSize, const ParallelRangeCallback& callback);
+
+// **********************************
+// Executes 'lambda(SizeT begin, SizeT end)' over the range [begin, end) in parallel, see ParallelForRange.
+// **********************************
+template<typename LambdaT>
+void ParallelFor(TaskSchedulerBase& scheduler, SizeT begin, SizeT end, SizeT grainSize, const LambdaT& lambda)
+{
+    ParallelForRange(scheduler, begin, end, grainSize, ParallelRangeCallback::Make([&lambda](SizeT first, SizeT last) { lambda(first, last); }));
+}
+
+// **********************************
+// Reduces the range [begin, end) in parallel.
+//
+// Each chunk is mapped to a partial result with 'map(SizeT begin, SizeT end) -> T', the partial
+// results are then combined in chunk order on the calling thread with 'reduce(T, T) -> T' so the
+// result is deterministic regardless of how the chunks were scheduled.
+//
+// @param identity -- The value the reduction starts with (and the result of an empty range)
+// **********************************
+template<typename T, typename MapT, typename ReduceT>
+T ParallelReduce(TaskSchedulerBase& scheduler, SizeT begin, SizeT end, SizeT grainSize, const T& identity, const MapT& map, const ReduceT& reduce)
+{
+    if (end <= begin)
+    {
+        return identity;
+    }
+
+    const SizeT grain = ParallelGrainSize(end - begin, grainSize);
+    const SizeT numChunks = (end - begin + grain - 1) / grain;
+    TVector<T> partials;
+    partials.resize(numChunks, identity);
+    auto mapChunks = [&](SizeT firstChunk, SizeT lastChunk)
+    {
+        for (SizeT chunk = firstChunk; chunk < lastChunk; ++chunk)
+        {
+            const SizeT chunkBegin = begin + chunk * grain;
+            const SizeT chunkEnd = (end - chunkBegin) > grain ? chunkBegin + grain : end;
+            partials[chunk] = map(chunkBegin, chunkEnd);
+        }
+    };
+    ParallelFor(scheduler, 0, numChunks, 1, mapChunks);
+
+    T result = identity;
+    for (const T& partial : partials)
+    {
+        result = reduce(result, partial);
+    }
+    return result;
+}
+
+} // namespace lf
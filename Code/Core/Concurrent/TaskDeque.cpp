@@ -0,0 +1,197 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "TaskDeque.h"
+#include "Core/Platform/Atomic.h"
+
+namespace lf {
+
+TaskDeque::TaskDeque()
+: mTop(0)
+, mPadding()
+, mBottom(0)
+, mSlots()
+, mMask(0)
+{}
+
+TaskDeque::~TaskDeque()
+{
+    // If this trips, tasks were left in the deque and will never run.
+    CriticalAssertEx(Size() == 0, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+}
+
+void TaskDeque::Initialize(SizeT capacity)
+{
+    AssertEx(capacity > 0, LF_ERROR_INVALID_ARGUMENT, ERROR_API_CORE);
+    AssertEx(Size() == 0, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+
+    SizeT powerOfTwo = 1;
+    while (powerOfTwo < capacity)
+    {
+        powerOfTwo <<= 1;
+    }
+
+    mSlots.clear();
+    mSlots.resize(powerOfTwo);
+    for (SlotType& slot : mSlots)
+    {
+        AtomicStore(&slot.mState, CRBS_PRODUCER_READY);
+        AtomicStore(&slot.mSerial, 0);
+        slot.mData = TaskTypes::TaskRingBufferTraits::Default();
+    }
+    mMask = powerOfTwo - 1;
+    AtomicStore(&mTop, 0);
+    AtomicStore(&mBottom, 0);
+}
+
+void TaskDeque::Release()
+{
+    AssertEx(Size() == 0, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    mSlots.clear();
+    mMask = 0;
+    AtomicStore(&mTop, 0);
+    AtomicStore(&mBottom, 0);
+}
+
+TaskHandle TaskDeque::Push(const TaskItemType& item)
+{
+    if (mSlots.empty())
+    {
+        return TaskHandle();
+    }
+
+    Atomic64 bottom = AtomicLoad(&mBottom);
+    Atomic64 top = AtomicLoad(&mTop);
+    if (bottom - top >= static_cast<Atomic64>(mSlots.size()))
+    {
+        return TaskHandle();
+    }
+
+    // A thief may have claimed the index but not yet consumed the slot (or a TaskHandle is
+    // executing it), in that case treat the deque as full rather than waiting.
+    SlotType& slot = GetSlot(bottom);
+    Atomic32 reserve = static_cast<Atomic32>(GetPlatformThreadId());
+    AssertEx(reserve != CRBS_PRODUCER_READY && reserve != CRBS_CONSUMER_READY, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    if (AtomicCompareExchange(&slot.mState, reserve, CRBS_PRODUCER_READY) != CRBS_PRODUCER_READY)
+    {
+        return TaskHandle();
+    }
+
+    TaskItemType input = item;
+    TaskTypes::TaskRingBufferTraits::Push(slot.mData, input);
+    if (Invalid(static_cast<Int32>(AtomicIncrement32(&slot.mSerial))))
+    {
+        AtomicIncrement32(&slot.mSerial);
+    }
+    TaskTypes::TaskRingBufferResult result = { TaskTypes::TaskRingBufferTraits::ToResultType(slot), true };
+    Atomic32 state = AtomicCompareExchange(&slot.mState, CRBS_CONSUMER_READY, reserve);
+    AssertEx(state == reserve, LF_ERROR_BAD_STATE, ERROR_API_CORE);
+
+    // Publish the task to thieves.
+    AtomicStore(&mBottom, bottom + 1);
+    return TaskHandle(result);
+}
+
+bool TaskDeque::Pop(TaskItemType& outItem)
+{
+    if (mSlots.empty())
+    {
+        return false;
+    }
+
+    // AtomicStore is a full barrier, the store to bottom must be visible before we read top
+    Atomic64 bottom = AtomicLoad(&mBottom) - 1;
+    AtomicStore(&mBottom, bottom);
+    Atomic64 top = AtomicLoad(&mTop);
+    if (top > bottom)
+    {
+        // Empty
+        AtomicStore(&mBottom, bottom + 1);
+        return false;
+    }
+
+    if (top == bottom)
+    {
+        // Last item, race the thieves for it.
+        bool won = AtomicCompareExchange64(&mTop, top + 1, top) == top;
+        AtomicStore(&mBottom, bottom + 1);
+        if (!won)
+        {
+            return false;
+        }
+    }
+
+    Consume(GetSlot(bottom), outItem);
+    return true;
+}
+
+bool TaskDeque::Steal(TaskItemType& outItem)
+{
+    if (mSlots.empty())
+    {
+        return false;
+    }
+
+    Atomic64 top = AtomicLoad(&mTop);
+    Atomic64 bottom = AtomicLoad(&mBottom);
+    if (top >= bottom)
+    {
+        return false;
+    }
+
+    if (AtomicCompareExchange64(&mTop, top + 1, top) != top)
+    {
+        // Lost the race to another thief or the owner.
+        return false;
+    }
+
+    Consume(GetSlot(top), outItem);
+    return true;
+}
+
+SizeT TaskDeque::Size() const
+{
+    Atomic64 size = AtomicLoad(&mBottom) - AtomicLoad(&mTop);
+    return size > 0 ? static_cast<SizeT>(size) : 0;
+}
+
+void TaskDeque::Consume(SlotType& slot, TaskItemType& outItem)
+{
+    Atomic32 reserve = static_cast<Atomic32>(GetPlatformThreadId());
+    AssertEx(reserve != CRBS_PRODUCER_READY && reserve != CRBS_CONSUMER_READY, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    // We own the index so the slot can only be held temporarily by a TaskHandle::Wait
+    while (AtomicCompareExchange(&slot.mState, reserve, CRBS_CONSUMER_READY) != CRBS_CONSUMER_READY)
+    {
+        SleepCallingThread(0);
+    }
+
+    outItem = slot.mData;
+    TaskTypes::TaskRingBufferTraits::Reset(slot.mData);
+    if (Invalid(static_cast<Int32>(AtomicIncrement32(&slot.mSerial))))
+    {
+        AtomicIncrement32(&slot.mSerial);
+    }
+
+    Atomic32 state = AtomicCompareExchange(&slot.mState, CRBS_PRODUCER_READY, reserve);
+    AssertEx(state == reserve, LF_ERROR_BAD_STATE, ERROR_API_CORE);
+}
+
+} // namespace lf
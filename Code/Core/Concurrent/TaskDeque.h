@@ -0,0 +1,99 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Concurrent/TaskTypes.h"
+#include "Core/Concurrent/TaskHandle.h"
+
+namespace lf {
+
+// **********************************
+// A bounded Chase-Lev work-stealing deque of tasks.
+//
+// The owning worker pushes/pops from the 'bottom' (LIFO) while any other worker
+// may steal from the 'top' (FIFO). Each index maps onto a ring buffer slot that
+// carries the same state/serial protocol as the dispatcher queue so a TaskHandle
+// returned from Push can still 'Wait' on the task.
+//
+// note: Push/Pop may only be called by the owning thread, Steal may be called from any thread.
+// **********************************
+class TaskDeque
+{
+public:
+    using TaskItemType = TaskTypes::TaskItemType;
+    using SlotType = TaskTypes::TaskRingBufferSlot;
+
+    TaskDeque();
+    TaskDeque(const TaskDeque&) = delete;
+    TaskDeque& operator=(const TaskDeque&) = delete;
+    ~TaskDeque();
+
+    // **********************************
+    // Allocates the slots for the deque, the capacity is rounded up to the next power of two.
+    // @param capacity -- The maximum number of tasks the deque can hold before Push fails.
+    // **********************************
+    void Initialize(SizeT capacity);
+    // **********************************
+    // Releases the slots of the deque, there must not be any pending tasks.
+    // **********************************
+    void Release();
+
+    // **********************************
+    // [Owner Only] Attempts to push a task onto the bottom of the deque.
+    // @returns Returns a valid handle if the task was pushed, otherwise the deque is full and the
+    //          caller should fall back to the shared dispatcher queue.
+    // **********************************
+    TaskHandle Push(const TaskItemType& item);
+    // **********************************
+    // [Owner Only] Attempts to pop the most recently pushed task off the bottom of the deque.
+    // @param outItem -- The task that was popped, the callback may be null if the task was already
+    //                   completed by a TaskHandle.
+    // @returns Returns true if a task was popped.
+    // **********************************
+    bool Pop(TaskItemType& outItem);
+    // **********************************
+    // [Any Thread] Attempts to steal the oldest task off the top of the deque.
+    // @param outItem -- The task that was stolen, the callback may be null if the task was already
+    //                   completed by a TaskHandle.
+    // @returns Returns true if a task was stolen.
+    // **********************************
+    bool Steal(TaskItemType& outItem);
+
+    // **********************************
+    // @returns Returns an approximation of the number of tasks in the deque.
+    // **********************************
+    SizeT Size() const;
+    SizeT Capacity() const { return mSlots.size(); }
+private:
+    SlotType& GetSlot(Atomic64 index) { return mSlots[static_cast<SizeT>(index) & mMask]; }
+    // Takes ownership of the slot's task and releases the slot back to the producer.
+    void Consume(SlotType& slot, TaskItemType& outItem);
+
+    // Index of the oldest task, advanced by thieves (and the owner on the last item)
+    volatile Atomic64   mTop;
+    // Padding so thieves polling mTop do not share a cache line with the owner's mBottom
+    ByteT               mPadding[64 - sizeof(Atomic64)];
+    // Index of the next task to be pushed, only written by the owner
+    volatile Atomic64   mBottom;
+    TVector<SlotType>   mSlots;
+    SizeT               mMask;
+};
+
+} // namespace lf
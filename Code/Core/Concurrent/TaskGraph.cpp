@@ -0,0 +1,179 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "TaskGraph.h"
+#include "Core/Platform/Atomic.h"
+
+namespace lf {
+
+TaskGraph::TaskGraph()
+: mNodes()
+, mRoots()
+, mScheduler(nullptr)
+, mFence()
+, mRemaining(0)
+, mBuilt(false)
+{
+    CriticalAssert(mFence.Initialize());
+    mFence.Set(false);
+}
+
+TaskGraph::~TaskGraph()
+{
+    // If this trips the graph is destroyed while tasks still reference the nodes!
+    CriticalAssertEx(IsComplete(), LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    mFence.Set(false);
+    mFence.Destroy();
+}
+
+TaskGraph::NodeId TaskGraph::AddNode(const NodeCallback& callback)
+{
+    AssertEx(!mBuilt, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    mNodes.push_back(Node());
+    mNodes.back().mCallback = callback;
+    return mNodes.size() - 1;
+}
+
+void TaskGraph::AddEdge(NodeId predecessor, NodeId successor)
+{
+    AssertEx(!mBuilt, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    AssertEx(predecessor < mNodes.size() && successor < mNodes.size() && predecessor != successor, LF_ERROR_INVALID_ARGUMENT, ERROR_API_CORE);
+    mNodes[predecessor].mSuccessors.push_back(successor);
+    ++mNodes[successor].mPredecessors;
+}
+
+bool TaskGraph::Build()
+{
+    AssertEx(!mBuilt, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    mRoots.clear();
+    for (NodeId i = 0; i < mNodes.size(); ++i)
+    {
+        if (mNodes[i].mPredecessors == 0)
+        {
+            mRoots.push_back(i);
+        }
+    }
+
+    // Kahn's algorithm, if we can't visit every node there is a cycle.
+    TVector<Atomic32> pending;
+    pending.reserve(mNodes.size());
+    for (const Node& node : mNodes)
+    {
+        pending.push_back(node.mPredecessors);
+    }
+    TVector<NodeId> open(mRoots);
+    SizeT visited = 0;
+    while (!open.empty())
+    {
+        NodeId id = open.back();
+        open.pop_back();
+        ++visited;
+        for (NodeId successor : mNodes[id].mSuccessors)
+        {
+            if (--pending[successor] == 0)
+            {
+                open.push_back(successor);
+            }
+        }
+    }
+
+    if (visited != mNodes.size())
+    {
+        ReportBugMsgEx("TaskGraph::Build failed, the graph contains a cycle.", LF_ERROR_INVALID_ARGUMENT, ERROR_API_CORE);
+        mRoots.clear();
+        return false;
+    }
+    mBuilt = true;
+    return true;
+}
+
+void TaskGraph::Clear()
+{
+    AssertEx(IsComplete(), LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    mNodes.clear();
+    mRoots.clear();
+    mScheduler = nullptr;
+    mBuilt = false;
+}
+
+void TaskGraph::Submit(TaskSchedulerBase& scheduler)
+{
+    AssertEx(mBuilt, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    AssertEx(IsComplete(), LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    if (!mBuilt || !IsComplete() || mNodes.empty())
+    {
+        return;
+    }
+
+    mScheduler = &scheduler;
+    for (Node& node : mNodes)
+    {
+        AtomicStore(&node.mPending, node.mPredecessors);
+    }
+    mFence.Set(true);
+    // +1 so the last node can release the fence before the graph is observed as complete.
+    AtomicStore(&mRemaining, static_cast<Atomic32>(mNodes.size() + 1));
+
+    for (NodeId root : mRoots)
+    {
+        Enqueue(&mNodes[root]);
+    }
+}
+
+void TaskGraph::Wait()
+{
+    while (!IsComplete())
+    {
+        mFence.Wait();
+    }
+}
+
+void TaskGraph::Enqueue(Node* node)
+{
+    mScheduler->RunTask([this](void* param) { Execute(static_cast<Node*>(param)); }, node);
+}
+
+void TaskGraph::Execute(Node* node)
+{
+    if (node->mCallback)
+    {
+        node->mCallback.Invoke();
+    }
+
+    // Successors become ready once all of their predecessors have completed.
+    for (NodeId successor : node->mSuccessors)
+    {
+        Node* next = &mNodes[successor];
+        if (AtomicDecrement32(&next->mPending) == 0)
+        {
+            Enqueue(next);
+        }
+    }
+
+    if (AtomicDecrement32(&mRemaining) == 1)
+    {
+        // Once mRemaining is 0 the owner is free to destroy the graph, so it must be the last thing we touch.
+        mFence.Set(false);
+        AtomicStore(&mRemaining, 0);
+    }
+}
+
+} // namespace lf
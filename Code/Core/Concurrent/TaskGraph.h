@@ -0,0 +1,117 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Concurrent/TaskScheduler.h"
+#include "Core/Platform/ThreadFence.h"
+#include "Core/Utility/SmartCallback.h"
+
+namespace lf {
+
+// **********************************
+// A dependency graph of tasks that can be built once and submitted to a scheduler many times.
+//
+// Nodes are declared with AddNode and ordered with AddEdge, once Build is called the graph is
+// frozen. Submit enqueues every node without predecessors, when a node completes it decrements
+// the pending counter of each successor and enqueues the successors that become ready. The last
+// node to complete releases anyone blocked in Wait.
+//
+// usage:
+//      TaskGraph graph;
+//      TaskGraph::NodeId a = graph.AddNode(TaskGraph::NodeCallback::Make([]() { ... }));
+//      TaskGraph::NodeId b = graph.AddNode(TaskGraph::NodeCallback::Make([]() { ... }));
+//      graph.AddEdge(a, b); // b runs after a
+//      graph.Build();
+//      graph.Submit(scheduler);
+//      graph.Wait();
+// **********************************
+class LF_CORE_API TaskGraph
+{
+public:
+    using NodeId = SizeT;
+    using NodeCallback = TCallback<void>;
+
+    TaskGraph();
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+    // **********************************
+    // Releases the graph, the graph must not be executing.
+    // **********************************
+    ~TaskGraph();
+
+    // **********************************
+    // Adds a node to the graph, the graph must not be built.
+    // @param callback -- The function to execute when the node runs.
+    // @returns Returns the id of the node used to add edges.
+    // **********************************
+    NodeId AddNode(const NodeCallback& callback);
+    // **********************************
+    // Adds an edge to the graph so 'successor' only runs once 'predecessor' has completed.
+    // **********************************
+    void AddEdge(NodeId predecessor, NodeId successor);
+    // **********************************
+    // Validates the graph and freezes it so it can be submitted.
+    // @returns Returns false if the graph contains a cycle.
+    // **********************************
+    bool Build();
+    // **********************************
+    // Releases all nodes and edges, the graph can be rebuilt afterwards.
+    // **********************************
+    void Clear();
+
+    // **********************************
+    // Resets the dependency counters and enqueues all root nodes on the scheduler.
+    // The graph must be built and cannot be submitted again until it has completed.
+    // **********************************
+    void Submit(TaskSchedulerBase& scheduler);
+    // **********************************
+    // Blocks the calling thread until every node of the last submission has completed.
+    // **********************************
+    void Wait();
+    // **********************************
+    // @returns Returns true if every node of the last submission has completed (or the graph was never submitted)
+    // **********************************
+    bool IsComplete() const { return AtomicLoad(&mRemaining) == 0; }
+    bool IsBuilt() const { return mBuilt; }
+    SizeT GetNodeCount() const { return mNodes.size(); }
+private:
+    struct Node
+    {
+        Node() : mCallback(), mSuccessors(), mPredecessors(0), mPending(0) {}
+
+        NodeCallback      mCallback;
+        TVector<NodeId>   mSuccessors;
+        // Number of predecessors, the pending counter is reset to this on submit.
+        Atomic32          mPredecessors;
+        volatile Atomic32 mPending;
+    };
+
+    void Enqueue(Node* node);
+    void Execute(Node* node);
+
+    TVector<Node>       mNodes;
+    TVector<NodeId>     mRoots;
+    TaskSchedulerBase*  mScheduler;
+    ThreadFence         mFence;
+    volatile Atomic32   mRemaining;
+    bool                mBuilt;
+};
+
+} // namespace lf
@@ -29,6 +29,8 @@ namespace lf {
 TaskScheduler::TaskScheduler() :
 mDispatcherQueue(),
 mWorkerThreads(),
+mIdleWorkers(0),
+mMode(TaskTypes::TSM_SHARED_QUEUE),
 mRunning(0),
 mAsync(false)
 {
@@ -59,10 +61,22 @@ void TaskScheduler::Initialize(const OptionsType& options, bool async)
     AssertEx(mDispatcherQueue.Size() == 0, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
 
     mAsync = async;
+    mMode = options.mMode;
     mWorkerThreads.resize(async ? options.mNumWorkerThreads : 1);
     mDispatcherQueue.Resize(options.mDispatcherSize);
     CriticalAssert(mDispatcherFence.Initialize());
     mDispatcherFence.Set(true);
+    AtomicStore(&mIdleWorkers, 0);
+
+    // Every deque must exist before any worker starts stealing
+    if (mMode == TaskTypes::TSM_WORK_STEALING)
+    {
+        AssertEx(options.mLocalQueueSize > 0, LF_ERROR_INVALID_ARGUMENT, ERROR_API_CORE);
+        for (SizeT i = 0; i < mWorkerThreads.size(); ++i)
+        {
+            mWorkerThreads[i].InitializeWorkStealing(mWorkerThreads.data(), mWorkerThreads.size(), i, &mIdleWorkers, options);
+        }
+    }
 
     // Spin up workers first to process work ASAP
     for (TaskWorker& worker : mWorkerThreads)
@@ -97,6 +111,11 @@ void TaskScheduler::Shutdown()
         worker.Join();
     }
 
+    for (TaskWorker& worker : mWorkerThreads)
+    {
+        worker.PopPendingItems(spilledTasks);
+    }
+
     mWorkerThreads.clear();
 
     while (mDispatcherQueue.Size() > 0)
@@ -134,8 +153,32 @@ TaskHandle TaskScheduler::RunTask(TaskCallback func, void* param)
     taskItem.mCallback = func;
     taskItem.mParam = param;
     TaskHandle taskHandle;
+    if (mMode == TaskTypes::TSM_WORK_STEALING)
+    {
+        // Tasks spawned from one of our workers stay on that worker unless stolen.
+        TaskWorker* worker = TaskWorker::GetCurrent();
+        if (worker && worker->IsWorkStealingWith(mWorkerThreads.data()))
+        {
+            taskHandle = worker->PushLocal(taskItem);
+            if (taskHandle)
+            {
+                if (AtomicLoad(&mIdleWorkers) > 0)
+                {
+                    mDispatcherFence.Signal();
+                }
+                return taskHandle;
+            }
+        }
+    }
+
     do {
         taskHandle = mDispatcherQueue.TryPush(taskItem);
+        if (!taskHandle && !mAsync)
+        {
+            // Nothing pops the queue until UpdateSync, waiting for a free slot would never finish.
+            taskItem.mCallback.Invoke(taskItem.mParam);
+            return TaskHandle();
+        }
     } while (!taskHandle);
     mDispatcherFence.Signal();
     return taskHandle;
@@ -148,13 +191,36 @@ void TaskScheduler::UpdateSync(Float64 budgetSeconds)
         CriticalAssert(mWorkerThreads.size() == 1);
         Timer timer;
         timer.Start();
-        while (timer.PeekDelta() < budgetSeconds && mDispatcherQueue.Size() > 0)
+        while (timer.PeekDelta() < budgetSeconds && GetPendingTasks() > 0)
         {
             mWorkerThreads.front().UpdateSync();
         }
     }
 }
 
+SizeT TaskScheduler::GetCurrentWorkerIndex() const
+{
+    const TaskWorker* worker = TaskWorker::GetCurrent();
+    if (!worker || mWorkerThreads.empty() || worker < mWorkerThreads.data() || worker >= mWorkerThreads.data() + mWorkerThreads.size())
+    {
+        return INVALID;
+    }
+    return static_cast<SizeT>(worker - mWorkerThreads.data());
+}
+
+SizeT TaskScheduler::GetPendingTasks() const
+{
+    SizeT pending = mDispatcherQueue.Size();
+    if (mMode == TaskTypes::TSM_WORK_STEALING)
+    {
+        for (const TaskWorker& worker : mWorkerThreads)
+        {
+            pending += worker.GetLocalSize();
+        }
+    }
+    return pending;
+}
+
 #if defined(LF_MPMC_BOUNDLESS_EXP)
 
 TaskScheduler::TaskScheduler() : 
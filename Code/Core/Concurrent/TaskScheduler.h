@@ -36,6 +36,8 @@ class LF_CORE_API TaskSchedulerBase
 public:
     virtual ~TaskSchedulerBase() {}
     virtual TaskHandle RunTask(TaskCallback func, void* param = nullptr) = 0;
+    // ** Returns false if queued tasks only run when the owner explicitly updates the scheduler.
+    virtual bool IsAsync() const { return true; }
 
     template<typename LambdaT>
     TaskHandle RunTask(const LambdaT& lambda, void* param = nullptr)
@@ -94,18 +96,36 @@ public:
     // **********************************
     // Check if the scheduler is running as a asynchronous task scheduler
     // **********************************
-    bool IsAsync() const { return mAsync; }
+    bool IsAsync() const override { return mAsync; }
+    // **********************************
+    // Check how tasks are distributed to the workers (see TaskTypes::TaskSchedulerMode)
+    // **********************************
+    TaskTypes::TaskSchedulerMode GetMode() const { return mMode; }
+    // **********************************
+    // @returns Returns the number of workers, worker indices are [0, GetNumWorkers())
+    // **********************************
+    SizeT GetNumWorkers() const { return mWorkerThreads.size(); }
+    // **********************************
+    // @returns Returns the index of the worker running on the calling thread or INVALID if
+    //          the calling thread is not a worker of this scheduler.
+    // **********************************
+    SizeT GetCurrentWorkerIndex() const;
     // **********************************
     // Manually updates the task scheduler if it's not async
     // **********************************
     void UpdateSync(Float64 budgetSeconds);
 private:
     void SetRunning(bool value) { AtomicStore(&mRunning, value ? 1 : 0); }
+    // Returns the number of tasks in the dispatcher queue and worker local deques.
+    SizeT GetPendingTasks() const;
 
     RingBufferType mDispatcherQueue;
     ThreadFence    mDispatcherFence;
     // Workers:
     TVector<TaskWorker> mWorkerThreads;
+    // Number of workers waiting on the dispatcher fence (TSM_WORK_STEALING)
+    volatile Atomic32 mIdleWorkers;
+    TaskTypes::TaskSchedulerMode mMode;
 
     volatile Atomic32 mRunning;
     bool mAsync;
@@ -110,6 +110,15 @@ enum TaskEnqueueStatus
     TES_LOCK
 };
 
+enum TaskSchedulerMode
+{
+    // All tasks are pushed to a single MPMC ring buffer that every worker pops from.
+    TSM_SHARED_QUEUE,
+    // Tasks spawned from a worker are pushed to that worker's local deque, idle workers
+    // pop from the shared queue and then steal from other workers.
+    TSM_WORK_STEALING
+};
+
 struct TaskDeliveryThreadOptions
 {
     TaskDeliveryThreadOptions() :
@@ -131,6 +140,9 @@ struct TaskSchedulerOptions
     TaskSchedulerOptions() 
     : mNumWorkerThreads(4)
     , mDispatcherSize(512)
+    , mMode(TSM_SHARED_QUEUE)
+    , mLocalQueueSize(256)
+    , mIdleWaitMilliseconds(1)
 #if defined(LF_DEBUG) || defined(LF_TEST)
     , mWorkerName("WorkerThread")
 #endif
@@ -145,6 +157,12 @@ struct TaskSchedulerOptions
     SizeT mNumWorkerThreads;
     // The dispatcher buffer size
     SizeT mDispatcherSize;
+    // How tasks are distributed to the workers
+    TaskSchedulerMode mMode;
+    // [TSM_WORK_STEALING] The capacity of each worker's local deque (rounded up to a power of two)
+    SizeT mLocalQueueSize;
+    // [TSM_WORK_STEALING] How long an idle worker sleeps before it attempts to steal again
+    SizeT mIdleWaitMilliseconds;
 
 #if defined(LF_DEBUG) || defined(LF_TEST)
     const char* mWorkerName;
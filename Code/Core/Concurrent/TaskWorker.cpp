@@ -21,15 +21,26 @@
 #include "Core/PCH.h"
 #include "TaskWorker.h"
 #include "Core/Platform/ThreadFence.h"
+#include "Core/Math/Random.h"
 
 namespace lf {
 
+// The worker running on the calling thread, used to route spawned tasks to the worker's local deque.
+static LF_THREAD_LOCAL TaskWorker* gCurrentWorker = nullptr;
+
 TaskWorker::TaskWorker()
 : mThread()
 , mRunning(0)
 , mDispatcherQueue(nullptr)
 , mDispatcherFence(nullptr)
 , mAsync(false)
+, mLocalQueue()
+, mWorkers(nullptr)
+, mNumWorkers(0)
+, mWorkerIndex(0)
+, mIdleWorkers(nullptr)
+, mIdleWaitMilliseconds(0)
+, mStealSeed(0)
 {}
 TaskWorker::TaskWorker(const TaskWorker&)
 {
@@ -51,6 +62,24 @@ TaskWorker& TaskWorker::operator=(const TaskWorker&)
     return *this;
 }
 
+void TaskWorker::InitializeWorkStealing(TaskWorker* workers
+    , SizeT numWorkers
+    , SizeT workerIndex
+    , volatile Atomic32* idleWorkers
+    , const TaskTypes::TaskSchedulerOptions& options)
+{
+    // Work stealing must be setup before the worker starts running.
+    AssertEx(!IsRunning(), LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    AssertEx(workers && workerIndex < numWorkers && idleWorkers, LF_ERROR_INVALID_ARGUMENT, ERROR_API_CORE);
+    mLocalQueue.Initialize(options.mLocalQueueSize);
+    mWorkers = workers;
+    mNumWorkers = numWorkers;
+    mWorkerIndex = workerIndex;
+    mIdleWorkers = idleWorkers;
+    mIdleWaitMilliseconds = options.mIdleWaitMilliseconds;
+    mStealSeed = static_cast<Int32>(workerIndex * 7919 + 1);
+}
+
 // void TaskWorker::Initialize(RingBufferType* dispatcherQueue, ThreadFence* dispatcherFence, bool async)
 void TaskWorker::Initialize(RingBufferType* dispatcherQueue
     , ThreadFence* dispatcherFence
@@ -103,6 +132,30 @@ void TaskWorker::Join()
     mAsync = false;
 }
 
+void TaskWorker::PopPendingItems(TVector<TaskItemType>& outItems)
+{
+    // If this trips the worker could still be popping from the deque!
+    AssertEx(!IsRunning() && !mThread.IsRunning(), LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    TaskItemType item;
+    while (mLocalQueue.Pop(item))
+    {
+        if (item.mCallback)
+        {
+            outItems.push_back(item);
+        }
+    }
+    mLocalQueue.Release();
+    mWorkers = nullptr;
+    mNumWorkers = 0;
+    mWorkerIndex = 0;
+    mIdleWorkers = nullptr;
+}
+
+TaskWorker* TaskWorker::GetCurrent()
+{
+    return gCurrentWorker;
+}
+
 void TaskWorker::UpdateSync()
 {
     if (IsAsync())
@@ -110,11 +163,26 @@ void TaskWorker::UpdateSync()
         ReportBugMsgEx("TaskWorker::UpdateSync cannot be called on an asynchronous worker!", LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
         return;
     }
+    TaskWorker* previous = gCurrentWorker;
+    gCurrentWorker = this;
     Update();
+    gCurrentWorker = previous;
 }
 
-void TaskWorker::Update()
+bool TaskWorker::Update()
 {
+    TaskItemType item;
+    // Newest local work first, it's most likely to still be in cache.
+    if (mLocalQueue.Pop(item))
+    {
+        // It's possible for a TaskHandle to 'Wait' and complete this task, in that case just skip
+        if (item.mCallback)
+        {
+            item.mCallback.Invoke(item.mParam);
+        }
+        return true;
+    }
+
     TaskTypes::TaskRingBufferResult result = mDispatcherQueue->TryPop();
     if (result)
     {
@@ -124,19 +192,66 @@ void TaskWorker::Update()
         {
             task.mCallback.Invoke(task.mParam);
         }
+        return true;
+    }
+
+    if (Steal(item))
+    {
+        if (item.mCallback)
+        {
+            item.mCallback.Invoke(item.mParam);
+        }
+        return true;
     }
+    return false;
+}
+
+bool TaskWorker::Steal(TaskItemType& outItem)
+{
+    if (!mWorkers || mNumWorkers < 2)
+    {
+        return false;
+    }
+
+    // Start at a random victim then sweep the rest so we don't miss work on the last victim.
+    SizeT start = static_cast<SizeT>(Random::Mod(mStealSeed, static_cast<UInt32>(mNumWorkers)));
+    for (SizeT i = 0; i < mNumWorkers; ++i)
+    {
+        SizeT victim = (start + i) % mNumWorkers;
+        if (victim != mWorkerIndex && mWorkers[victim].mLocalQueue.Steal(outItem))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 void TaskWorker::BackgroundUpdate()
 {
+    gCurrentWorker = this;
     while (IsRunning())
     {
-        Update();
-        if (mDispatcherQueue->Size() == 0)
+        if (mWorkers)
+        {
+            if (!Update())
+            {
+                // Local pushes only signal the fence if someone is waiting, a missed signal costs
+                // at most mIdleWaitMilliseconds.
+                AtomicIncrement32(mIdleWorkers);
+                mDispatcherFence->Wait(mIdleWaitMilliseconds);
+                AtomicDecrement32(mIdleWorkers);
+            }
+        }
+        else
         {
-            mDispatcherFence->Wait();
+            Update();
+            if (mDispatcherQueue->Size() == 0)
+            {
+                mDispatcherFence->Wait();
+            }
         }
     }
+    gCurrentWorker = nullptr;
 }
 
 }
\ No newline at end of file
@@ -21,6 +21,7 @@
 #pragma once
 
 #include "Core/Concurrent/TaskTypes.h"
+#include "Core/Concurrent/TaskDeque.h"
 #include "Core/Platform/Thread.h"
 
 namespace lf {
@@ -50,6 +51,21 @@ public:
     // **********************************
     TaskWorker& operator=(const TaskWorker&);
     // **********************************
+    // Enables TSM_WORK_STEALING for the worker, this must be called on every worker before any of
+    // them are initialized.
+    // @param workers -- The array of workers (including this one) the worker can steal from.
+    // @param numWorkers -- The number of workers in the array.
+    // @param workerIndex -- The index of this worker within the array.
+    // @param idleWorkers -- A counter of workers waiting on the dispatcher fence, producers only
+    //                       signal the fence when this is non-zero.
+    // @param options -- The scheduler options to read the local queue size/idle wait time from.
+    // **********************************
+    void InitializeWorkStealing(TaskWorker* workers
+                                , SizeT numWorkers
+                                , SizeT workerIndex
+                                , volatile Atomic32* idleWorkers
+                                , const TaskTypes::TaskSchedulerOptions& options);
+    // **********************************
     // Initializes the TaskWorker, marking it as 'running'
     // @param dispatcherQueue -- The dispatcher queue the worker will 'pop' items from.
     // @param async -- If true then a background thread will be spun up to process items, otherwise
@@ -70,6 +86,29 @@ public:
 
     void Join();
     // **********************************
+    // Pops all remaining tasks off the worker's local deque, this can only be called
+    // after the worker has been joined.
+    // **********************************
+    void PopPendingItems(TVector<TaskItemType>& outItems);
+    // **********************************
+    // [TSM_WORK_STEALING] Pushes a task onto the worker's local deque, this must be called from the
+    // worker's thread (see GetCurrent).
+    // @returns Returns an invalid handle if the deque is full.
+    // **********************************
+    TaskHandle PushLocal(const TaskItemType& item) { return mLocalQueue.Push(item); }
+    // **********************************
+    // @returns Returns the number of tasks waiting in the worker's local deque.
+    // **********************************
+    SizeT GetLocalSize() const { return mLocalQueue.Size(); }
+    // **********************************
+    // @returns Returns true if the worker steals from the 'workers' array. (ie belongs to that scheduler)
+    // **********************************
+    bool IsWorkStealingWith(const TaskWorker* workers) const { return mWorkers != nullptr && mWorkers == workers; }
+    // **********************************
+    // @returns Returns the worker executing on the calling thread or nullptr if the calling thread is not a worker.
+    // **********************************
+    static TaskWorker* GetCurrent();
+    // **********************************
     // Updates the worker in synchronous fashion, calling this method on a async worker is a invalid
     // operation.
     // **********************************
@@ -85,7 +124,10 @@ public:
 private:
     void SetRunning(bool value) { AtomicStore(&mRunning, value ? 1 : 0); }
     void Fork() { mThread.Fork(BackgroundUpdateEntry, this); }
-    void Update();
+    // Executes a single task, returns true if a task was found.
+    bool Update();
+    // Attempts to steal a task from a random worker.
+    bool Steal(TaskItemType& outItem);
 
     // Background thread updating function, runs until the worker is no longer 'running'
     void BackgroundUpdate();
@@ -100,6 +142,18 @@ private:
     ThreadFence*        mDispatcherFence;
     // Property to contain the async or not state
     bool                mAsync;
+
+    // [TSM_WORK_STEALING] Tasks spawned from this worker
+    TaskDeque           mLocalQueue;
+    // [TSM_WORK_STEALING] The workers we can steal from, null if the worker only uses the dispatcher queue
+    TaskWorker*         mWorkers;
+    SizeT               mNumWorkers;
+    SizeT               mWorkerIndex;
+    // [TSM_WORK_STEALING] Shared counter of workers waiting on the dispatcher fence
+    volatile Atomic32*  mIdleWorkers;
+    SizeT               mIdleWaitMilliseconds;
+    // [TSM_WORK_STEALING] Seed for victim selection
+    Int32               mStealSeed;
 };
 
 } // namespace lf
\ No newline at end of file
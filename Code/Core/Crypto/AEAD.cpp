@@ -0,0 +1,187 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "AEAD.h"
+#include "Core/Crypto/AES.h"
+
+#include <openssl/evp.h>
+#include <utility>
+
+namespace lf {
+
+namespace Crypto
+{
+
+static const EVP_CIPHER* GetEVPCipher(AEADCipher cipher)
+{
+    switch (cipher)
+    {
+        case AEAD_AES_256_GCM: return EVP_aes_256_gcm();
+        case AEAD_CHACHA20_POLY1305: return EVP_chacha20_poly1305();
+        default:
+            return nullptr;
+    }
+}
+
+AEADContext::AEADContext()
+: mContext(nullptr)
+, mCipher(AEAD_Unknown)
+, mEncrypt(false)
+{}
+AEADContext::AEADContext(AEADContext&& other)
+: mContext(other.mContext)
+, mCipher(other.mCipher)
+, mEncrypt(other.mEncrypt)
+{
+    other.mContext = nullptr;
+    other.mCipher = AEAD_Unknown;
+    other.mEncrypt = false;
+}
+AEADContext::~AEADContext()
+{
+    Release();
+}
+
+AEADContext& AEADContext::operator=(AEADContext&& other)
+{
+    if (this != &other)
+    {
+        Release();
+        mContext = other.mContext;
+        mCipher = other.mCipher;
+        mEncrypt = other.mEncrypt;
+        other.mContext = nullptr;
+        other.mCipher = AEAD_Unknown;
+        other.mEncrypt = false;
+    }
+    return *this;
+}
+
+bool AEADContext::Initialize(AEADCipher cipher, const AESKey* key, bool encrypt)
+{
+    Release();
+    const EVP_CIPHER* evpCipher = GetEVPCipher(cipher);
+    if (!evpCipher || !key || key->GetKeySize() != AES_KEY_256)
+    {
+        return false;
+    }
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx)
+    {
+        return false;
+    }
+
+    // Select the cipher first so the nonce length can be configured, then expand the key once.
+    // Subsequent calls only supply the nonce.
+    if (EVP_CipherInit_ex(ctx, evpCipher, NULL, NULL, NULL, encrypt ? 1 : 0) != 1
+        || EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_IVLEN, static_cast<int>(AEAD_NONCE_SIZE), NULL) != 1
+        || EVP_CipherInit_ex(ctx, NULL, NULL, key->GetKey(), NULL, encrypt ? 1 : 0) != 1)
+    {
+        EVP_CIPHER_CTX_free(ctx);
+        return false;
+    }
+
+    mContext = ctx;
+    mCipher = cipher;
+    mEncrypt = encrypt;
+    return true;
+}
+void AEADContext::Release()
+{
+    if (mContext)
+    {
+        EVP_CIPHER_CTX_free(static_cast<EVP_CIPHER_CTX*>(mContext));
+        mContext = nullptr;
+    }
+    mCipher = AEAD_Unknown;
+    mEncrypt = false;
+}
+
+bool AEADContext::Encrypt(const ByteT nonce[AEAD_NONCE_SIZE], const ByteT* aad, SizeT aadLength, const ByteT* inBytes, SizeT inBytesLength, ByteT* outBytes, ByteT outTag[AEAD_TAG_SIZE])
+{
+    if (!mContext || !mEncrypt || !nonce || (!aad && aadLength > 0) || (!inBytes && inBytesLength > 0) || (!outBytes && inBytesLength > 0) || !outTag)
+    {
+        return false;
+    }
+
+    EVP_CIPHER_CTX* ctx = static_cast<EVP_CIPHER_CTX*>(mContext);
+    int len = 0;
+    if (EVP_EncryptInit_ex(ctx, NULL, NULL, NULL, nonce) != 1)
+    {
+        return false;
+    }
+
+    if (aadLength > 0 && EVP_EncryptUpdate(ctx, NULL, &len, aad, static_cast<int>(aadLength)) != 1)
+    {
+        return false;
+    }
+
+    if (inBytesLength > 0 && EVP_EncryptUpdate(ctx, outBytes, &len, inBytes, static_cast<int>(inBytesLength)) != 1)
+    {
+        return false;
+    }
+
+    // Stream ciphers, final does not produce any output.
+    if (EVP_EncryptFinal_ex(ctx, outBytes + inBytesLength, &len) != 1)
+    {
+        return false;
+    }
+
+    return EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, static_cast<int>(AEAD_TAG_SIZE), outTag) == 1;
+}
+
+bool AEADContext::Decrypt(const ByteT nonce[AEAD_NONCE_SIZE], const ByteT* aad, SizeT aadLength, const ByteT* inBytes, SizeT inBytesLength, ByteT* outBytes, const ByteT tag[AEAD_TAG_SIZE])
+{
+    if (!mContext || mEncrypt || !nonce || (!aad && aadLength > 0) || (!inBytes && inBytesLength > 0) || (!outBytes && inBytesLength > 0) || !tag)
+    {
+        return false;
+    }
+
+    EVP_CIPHER_CTX* ctx = static_cast<EVP_CIPHER_CTX*>(mContext);
+    int len = 0;
+    if (EVP_DecryptInit_ex(ctx, NULL, NULL, NULL, nonce) != 1)
+    {
+        return false;
+    }
+
+    if (aadLength > 0 && EVP_DecryptUpdate(ctx, NULL, &len, aad, static_cast<int>(aadLength)) != 1)
+    {
+        return false;
+    }
+
+    if (inBytesLength > 0 && EVP_DecryptUpdate(ctx, outBytes, &len, inBytes, static_cast<int>(inBytesLength)) != 1)
+    {
+        return false;
+    }
+
+    // OpenSSL takes a non-const pointer for the tag but only reads from it.
+    if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, static_cast<int>(AEAD_TAG_SIZE), const_cast<ByteT*>(tag)) != 1)
+    {
+        return false;
+    }
+
+    return EVP_DecryptFinal_ex(ctx, outBytes + inBytesLength, &len) == 1;
+}
+
+} // namespace Crypto
+
+} // namespace lf
@@ -0,0 +1,81 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+
+#include "Core/Common/Types.h"
+#include "Core/Common/API.h"
+
+namespace lf { namespace Crypto {
+class AESKey;
+
+enum AEADCipher
+{
+    AEAD_AES_256_GCM,
+    AEAD_CHACHA20_POLY1305,
+
+    AEAD_Unknown
+};
+
+const SizeT AEAD_NONCE_SIZE = 12;
+const SizeT AEAD_TAG_SIZE = 16;
+
+// An authenticated cipher context that keeps the key schedule alive between calls. Each
+// Encrypt/Decrypt only resets the nonce so the per packet cost is the cipher itself rather
+// than a context allocation and key expansion.
+//
+// note: A context is either an encrypt or decrypt context and may only be used by one thread at a time.
+// note: The output is always the same length as the input, encrypting/decrypting in place is allowed.
+class LF_CORE_API AEADContext
+{
+public:
+    AEADContext();
+    AEADContext(const AEADContext& other) = delete;
+    AEADContext(AEADContext&& other);
+    ~AEADContext();
+
+    AEADContext& operator=(const AEADContext& other) = delete;
+    AEADContext& operator=(AEADContext&& other);
+
+    // ********************************************************************
+    // Creates the cipher context and expands the key. AES_256_GCM requires a 256 bit key,
+    // CHACHA20_POLY1305 uses the 256 bit key as is.
+    // ********************************************************************
+    bool Initialize(AEADCipher cipher, const AESKey* key, bool encrypt);
+    void Release();
+
+    bool Encrypt(const ByteT nonce[AEAD_NONCE_SIZE], const ByteT* aad, SizeT aadLength, const ByteT* inBytes, SizeT inBytesLength, ByteT* outBytes, ByteT outTag[AEAD_TAG_SIZE]);
+    // ********************************************************************
+    // Decrypts and verifies the cipher text/aad against the tag, returns false if the tag 
+    // does not match. (outBytes contents are undefined in that case)
+    // ********************************************************************
+    bool Decrypt(const ByteT nonce[AEAD_NONCE_SIZE], const ByteT* aad, SizeT aadLength, const ByteT* inBytes, SizeT inBytesLength, ByteT* outBytes, const ByteT tag[AEAD_TAG_SIZE]);
+
+    bool IsInitialized() const { return mContext != nullptr; }
+    bool IsEncrypt() const { return mEncrypt; }
+    AEADCipher GetCipher() const { return mCipher; }
+private:
+    void*      mContext;
+    AEADCipher mCipher;
+    bool       mEncrypt;
+};
+
+} // namespace Crypto
+} // namespace lf
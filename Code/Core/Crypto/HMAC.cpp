@@ -44,6 +44,11 @@ bool HMACKey::Generate()
 }
 
 bool HMACKey::Compute(const ByteT* data, SizeT dataLength, HMACBuffer& outBuffer) const
+{
+    return Compute(data, dataLength, nullptr, 0, outBuffer);
+}
+
+bool HMACKey::Compute(const ByteT* data, SizeT dataLength, const ByteT* extraData, SizeT extraDataLength, HMACBuffer& outBuffer) const
 {
     // Still a bit confused on how to do this correctly. 
     // Going based off of https://stackoverflow.com/questions/242665/understanding-engine-initialization-in-openssl
@@ -70,6 +75,11 @@ bool HMACKey::Compute(const ByteT* data, SizeT dataLength, HMACBuffer& outBuffer
             break;
         }
 
+        if (extraDataLength > 0 && HMAC_Update(ctx, extraData, extraDataLength) != OPENSSL_TRUE)
+        {
+            break;
+        }
+
         if (HMAC_Final(ctx, outBuffer.Bytes(), &outBytesLength) != OPENSSL_TRUE)
         {
             break;
@@ -46,6 +46,8 @@ public:
     LF_INLINE bool Load(const ByteT* bytes, SizeT bytesLength);
     bool Generate();
     bool Compute(const ByteT* data, SizeT dataLength, HMACBuffer& outBuffer) const;
+    // Computes the hmac of 'data' followed by 'extraData' without copying them into one buffer.
+    bool Compute(const ByteT* data, SizeT dataLength, const ByteT* extraData, SizeT extraDataLength, HMACBuffer& outBuffer) const;
 private:
     internal_ivector mBytes[2];
 };
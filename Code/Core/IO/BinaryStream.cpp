@@ -30,12 +30,25 @@
 #include "Core/String/String.h"
 #include "Core/Platform/File.h"
 #include "Core/Runtime/ReflectionHooks.h"
+#include "Core/Utility/ByteOrder.h"
 #include "Core/Utility/Utility.h"
 
 #include <map>
 
 namespace lf
 {
+    // ** FORMAT_COMPACT ends with a trailer of [UInt32 tableLocation][UInt32 version][UInt32 magic],
+    // ** the legacy format ends with the object count which will never match the magic.
+    static const UInt32 COMPACT_MAGIC = 0x4253464C; // 'LFSB'
+    static const UInt32 COMPACT_VERSION = 1;
+    static const SizeT COMPACT_TRAILER_SIZE = 12;
+
+    // ** SerializeBulk writes these types as raw bytes, they must match the size Serialize writes.
+    LF_STATIC_ASSERT(sizeof(Vector2) == 8);
+    LF_STATIC_ASSERT(sizeof(Vector3) == 12);
+    LF_STATIC_ASSERT(sizeof(Vector4) == 16);
+    LF_STATIC_ASSERT(sizeof(Color) == 16);
+
     BinaryStream::BinaryStream() : Stream(), mContext(nullptr)
     {}
     BinaryStream::BinaryStream(Stream::StreamMemory, MemoryBuffer* buffer, StreamMode mode) : Stream(), mContext(nullptr)
@@ -74,6 +87,7 @@ namespace lf
             mContext->mType = StreamContext::BINARY;
             mContext->arraySize = INVALID;
             mContext->buffer = buffer;
+            mContext->format = FORMAT_LEGACY;
             mContext->destroyBufferOnClear = false;
             Assert(memory == mContext);
         }
@@ -91,27 +105,7 @@ namespace lf
 
             mContext->buffer = buffer;
             mContext->destroyBufferOnClear = false;
-            // Seek End:
-            mContext->cursor = mContext->buffer->GetSize();
-            // Read Footer:
-            UInt32* footerSize = reinterpret_cast<UInt32*>(ReverseRead(4));
-            for (SizeT i = 0, size = static_cast<SizeT>(*footerSize); i < size; ++i)
-            {
-                UInt32* nameSize = reinterpret_cast<UInt32*>(ReverseRead(4));
-                UInt32* superSize = reinterpret_cast<UInt32*>(ReverseRead(4));
-                UInt32* objLocation = reinterpret_cast<UInt32*>(ReverseRead(4));
-                UInt32* objSize = reinterpret_cast<UInt32*>(ReverseRead(4));
-
-                String name(static_cast<SizeT>(*nameSize), reinterpret_cast<char*>(ReverseRead(static_cast<SizeT>(*nameSize))));
-                String super(static_cast<SizeT>(*superSize), reinterpret_cast<char*>(ReverseRead(static_cast<SizeT>(*superSize))));
-
-                ObjectInfo info;
-                info.name = name;
-                info.super = super;
-                info.location = static_cast<SizeT>(*objLocation);
-                info.size = static_cast<SizeT>(*objSize);
-                mContext->objects.push_back(info);
-            }
+            ReadFooter(mContext->buffer->GetSize());
         }
         // Write Mode:
         else if (mode == SM_WRITE)
@@ -146,6 +140,7 @@ namespace lf
             mContext->mType = StreamContext::BINARY;
             mContext->arraySize = INVALID;
             mContext->buffer = nullptr;
+            mContext->format = FORMAT_LEGACY;
             mContext->destroyBufferOnClear = false;
             Assert(memory == mContext);
         }
@@ -175,28 +170,7 @@ namespace lf
                 file.Read(bufferData, mContext->buffer->GetCapacity());
                 file.Close();
 
-                // Seek End:
-                mContext->cursor = mContext->buffer->GetCapacity();
-                // Read Footer:
-                UInt32* footerSize = reinterpret_cast<UInt32*>(ReverseRead(4));
-                for (SizeT i = 0, size = static_cast<SizeT>(*footerSize); i < size; ++i)
-                {
-                    UInt32* nameSize = reinterpret_cast<UInt32*>(ReverseRead(4));
-                    UInt32* superSize = reinterpret_cast<UInt32*>(ReverseRead(4));
-                    UInt32* objLocation = reinterpret_cast<UInt32*>(ReverseRead(4));
-                    UInt32* objSize = reinterpret_cast<UInt32*>(ReverseRead(4));
-
-                    String name(static_cast<SizeT>(*nameSize), reinterpret_cast<char*>(ReverseRead(static_cast<SizeT>(*nameSize))));
-                    String super(static_cast<SizeT>(*superSize), reinterpret_cast<char*>(ReverseRead(static_cast<SizeT>(*superSize))));
-
-                    ObjectInfo info;
-                    info.name = name;
-                    info.super = super;
-                    info.location = static_cast<SizeT>(*objLocation);
-                    info.size = static_cast<SizeT>(*objSize);
-                    mContext->objects.push_back(info);
-                }
-
+                ReadFooter(mContext->buffer->GetCapacity());
             }
         }
     }
@@ -210,26 +184,7 @@ namespace lf
 
         if (!IsReading())
         {
-            // Save Footer:
-            for (SizeT i = 0, size = mContext->objects.size(); i < size; ++i)
-            {
-                const ObjectInfo& info = mContext->objects[i];
-
-                UInt32 superSize = static_cast<UInt32>(info.super.Size());
-                WriteBytes(info.super.CStr(), superSize);
-
-                UInt32 nameSize = static_cast<UInt32>(info.name.Size());
-                WriteBytes(info.name.CStr(), nameSize);
-
-                UInt32 objLocation = static_cast<UInt32>(info.location);
-                UInt32 objSize = static_cast<UInt32>(info.size);
-                WriteBytes(&objSize, 4);
-                WriteBytes(&objLocation, 4);
-                WriteBytes(&superSize, 4);
-                WriteBytes(&nameSize, 4);
-            }
-            UInt32 footerSize = static_cast<UInt32>(mContext->objects.size());
-            WriteBytes(&footerSize, 4);
+            WriteFooter();
 
             // File file(mContext->filename, io::FM_WRITE);
             File file;
@@ -262,6 +217,8 @@ namespace lf
         }
 
         mContext->objects.clear();
+        mContext->strings.clear();
+        mContext->stringIndices.clear();
         mContext->filename.Clear();
         mContext->arraySize = INVALID;
         mContext->cursor = 0;
@@ -270,200 +227,101 @@ namespace lf
 
     void BinaryStream::Serialize(UInt8& value)
     {
-        if (IsReading())
-        {
-            UInt8* bufferPtr = reinterpret_cast<UInt8*>(ReadBytes(1));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 1);
-        }
+        SerializeValue(&value, 1, 1);
     }
     void BinaryStream::Serialize(UInt16& value)
     {
-        if (IsReading())
-        {
-            UInt16* bufferPtr = reinterpret_cast<UInt16*>(ReadBytes(2));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 2);
-        }
+        SerializeValue(&value, 2, 2);
     }
     void BinaryStream::Serialize(UInt32& value)
     {
-        if (IsReading())
-        {
-            UInt32* bufferPtr = reinterpret_cast<UInt32*>(ReadBytes(4));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 4);
-        }
+        SerializeValue(&value, 4, 4);
     }
     void BinaryStream::Serialize(UInt64& value)
     {
-        if (IsReading())
-        {
-            UInt64* bufferPtr = reinterpret_cast<UInt64*>(ReadBytes(8));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 8);
-        }
+        SerializeValue(&value, 8, 8);
     }
     void BinaryStream::Serialize(Int8& value)
     {
-        if (IsReading())
-        {
-            Int8* bufferPtr = reinterpret_cast<Int8*>(ReadBytes(1));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 1);
-        }
+        SerializeValue(&value, 1, 1);
     }
     void BinaryStream::Serialize(Int16& value)
     {
-        if (IsReading())
-        {
-            Int16* bufferPtr = reinterpret_cast<Int16*>(ReadBytes(2));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 2);
-        }
+        SerializeValue(&value, 2, 2);
     }
     void BinaryStream::Serialize(Int32& value)
     {
-        if (IsReading())
-        {
-            Int32* bufferPtr = reinterpret_cast<Int32*>(ReadBytes(4));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 4);
-        }
+        SerializeValue(&value, 4, 4);
     }
     void BinaryStream::Serialize(Int64& value)
     {
-        if (IsReading())
-        {
-            Int64* bufferPtr = reinterpret_cast<Int64*>(ReadBytes(8));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 8);
-        }
+        SerializeValue(&value, 8, 8);
     }
     void BinaryStream::Serialize(Float32& value)
     {
-        if (IsReading())
-        {
-            Float32* bufferPtr = reinterpret_cast<Float32*>(ReadBytes(4));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 4);
-        }
+        SerializeValue(&value, 4, 4);
     }
     void BinaryStream::Serialize(Float64& value)
     {
-        if (IsReading())
-        {
-            Float64* bufferPtr = reinterpret_cast<Float64*>(ReadBytes(8));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 8);
-        }
+        SerializeValue(&value, 8, 8);
     }
     void BinaryStream::Serialize(Vector2& value)
     {
-        if (IsReading())
-        {
-            Vector2* bufferPtr = reinterpret_cast<Vector2*>(ReadBytes(8));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 8);
-        }
+        SerializeValue(&value, 8, 4);
     }
     void BinaryStream::Serialize(Vector3& value)
     {
-        if (IsReading())
-        {
-            Vector3* bufferPtr = reinterpret_cast<Vector3*>(ReadBytes(12));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 12);
-        }
+        SerializeValue(&value, 12, 4);
     }
     void BinaryStream::Serialize(Vector4& value)
     {
-        if (IsReading())
-        {
-            Vector4* bufferPtr = reinterpret_cast<Vector4*>(ReadBytes(16));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 16);
-        }
+        SerializeValue(&value, 16, 4);
     }
     void BinaryStream::Serialize(Color& value)
     {
-        if (IsReading())
-        {
-            Color* bufferPtr = reinterpret_cast<Color*>(ReadBytes(16));
-            value = *bufferPtr;
-        }
-        else
-        {
-            WriteBytes(&value, 16);
-        }
+        SerializeValue(&value, 16, 4);
     }
     void BinaryStream::Serialize(String& value)
     {
         if (IsReading())
         {
-            UInt32* size = reinterpret_cast<UInt32*>(ReadBytes(4));
-            value.Resize(*size);
+            size_t size = 0;
+            SerializeSize(size);
+            value.Resize(size);
             // Can't edit COW string
             if (value.CopyOnWrite())
             {
                 value = value.CStr();
             }
-            const char* bytes = reinterpret_cast<const char*>(ReadBytes(static_cast<size_t>(*size)));
+            const char* bytes = reinterpret_cast<const char*>(ReadBytes(size));
             char* valueRaw = const_cast<char*>(value.CStr());
-            for (UInt32 i = 0; i < *size; ++i)
+            for (size_t i = 0; i < size; ++i)
             {
                 valueRaw[i] = bytes[i];
             }
         }
         else
         {
-            UInt32 size = static_cast<UInt32>(value.Size());
-            WriteBytes(&size, 4);
+            size_t size = value.Size();
+            SerializeSize(size);
             WriteBytes(value.CStr(), value.Size());
         }
     }
     void BinaryStream::Serialize(Token& value)
     {
-        if (IsReading())
+        if (mContext->format == FORMAT_COMPACT)
+        {
+            if (IsReading())
+            {
+                UInt64 index = ReadVarint();
+                value = index == 0 ? Token() : GetString(index - 1).token;
+            }
+            else
+            {
+                WriteVarint(value.Empty() ? 0 : FindOrAddString(value) + 1);
+            }
+        }
+        else if (IsReading())
         {
             String tmp;
             Serialize(tmp);
@@ -478,7 +336,31 @@ namespace lf
     }
     void BinaryStream::Serialize(const Type*& value)
     {
-        if (IsReading())
+        if (mContext->format == FORMAT_COMPACT)
+        {
+            if (IsReading())
+            {
+                // ** Types are resolved once per string table entry.
+                UInt64 index = ReadVarint();
+                if (index == 0)
+                {
+                    value = nullptr;
+                    return;
+                }
+                StringEntry& entry = GetString(index - 1);
+                if (!entry.typeResolved)
+                {
+                    entry.type = InternalHooks::gFindType(entry.token);
+                    entry.typeResolved = true;
+                }
+                value = entry.type;
+            }
+            else
+            {
+                WriteVarint(value ? FindOrAddString(value->GetFullName()) + 1 : 0);
+            }
+        }
+        else if (IsReading())
         {
             Token typeName;
             Serialize(typeName);
@@ -534,23 +416,23 @@ namespace lf
     {
         if (IsReading())
         {
-            UInt32 size = 0;
-            Serialize(size);
+            size_t size = 0;
+            SerializeSize(size);
             if (size == 0)
             {
                 buffer.Free();
             }
             else
             {
-                buffer.Allocate(static_cast<SizeT>(size), LF_SIMD_ALIGN);
-                void* data = ReadBytes(static_cast<SizeT>(size));
-                memcpy(buffer.GetData(), data, static_cast<SizeT>(size));
+                buffer.Allocate(size, LF_SIMD_ALIGN);
+                void* data = ReadBytes(size);
+                memcpy(buffer.GetData(), data, size);
             }
         }
         else
         {
-            UInt32 size = static_cast<UInt32>(buffer.GetSize());
-            Serialize(size);
+            size_t size = buffer.GetSize();
+            SerializeSize(size);
             if (size != 0)
             {
                 WriteBytes(buffer.GetData(), buffer.GetSize());
@@ -562,6 +444,30 @@ namespace lf
         SerializeBuffer(value);
     }
 
+    bool BinaryStream::SerializeBulk(void* values, SizeT count, SizeT elementSize, SizeT componentSize)
+    {
+        Assert(mContext);
+        const SizeT numBytes = count * elementSize;
+        if (IsReading())
+        {
+            memcpy(values, ReadBytes(numBytes), numBytes);
+            if (IsSwapRequired())
+            {
+                SwapBytesArray(values, numBytes / componentSize, componentSize);
+            }
+        }
+        else
+        {
+            const SizeT location = mContext->cursor;
+            WriteBytes(values, numBytes);
+            if (IsSwapRequired())
+            {
+                SwapBytesArray(reinterpret_cast<ByteT*>(mContext->buffer->GetData()) + location, numBytes / componentSize, componentSize);
+            }
+        }
+        return true;
+    }
+
 
 
     bool BinaryStream::BeginObject(const String& name, const String& super)
@@ -617,9 +523,7 @@ namespace lf
     {
         if (IsReading())
         {
-            UInt32 size = 0;
-            Serialize(size);
-            mContext->arraySize = static_cast<size_t>(size);
+            SerializeSize(mContext->arraySize);
         }
         return true;
     }
@@ -638,8 +542,7 @@ namespace lf
     {
         if (!IsReading())
         {
-            UInt32 size32 = static_cast<UInt32>(size);
-            Serialize(size32);
+            SerializeSize(size);
         }
     }
 
@@ -687,6 +590,266 @@ namespace lf
         return mContext ? mContext->cursor : INVALID;
     }
 
+    void BinaryStream::SetFormat(Format format)
+    {
+        Assert(mContext);
+        Assert(!IsReading());
+        Assert(mContext->cursor == 0 && mContext->objects.empty()); // If this trips the format was changed after writing.
+        mContext->format = format;
+    }
+
+    BinaryStream::Format BinaryStream::GetFormat() const
+    {
+        return mContext ? mContext->format : FORMAT_LEGACY;
+    }
+
+    void BinaryStream::ReadFooter(size_t bufferSize)
+    {
+        mContext->format = FORMAT_LEGACY;
+        mContext->cursor = bufferSize;
+
+        if (bufferSize >= COMPACT_TRAILER_SIZE)
+        {
+            UInt32 trailer[3];
+            memcpy(trailer, reinterpret_cast<const ByteT*>(mContext->buffer->GetData()) + bufferSize - COMPACT_TRAILER_SIZE, COMPACT_TRAILER_SIZE);
+            if (IsBigEndian())
+            {
+                SwapBytesArray(trailer, 3, 4);
+            }
+
+            if (trailer[2] == COMPACT_MAGIC)
+            {
+                if (trailer[1] != COMPACT_VERSION || trailer[0] > bufferSize - COMPACT_TRAILER_SIZE)
+                {
+                    CriticalAssertMsgEx("Unsupported binary stream format.", LF_ERROR_INTERNAL, ERROR_API_CORE);
+                }
+
+                mContext->format = FORMAT_COMPACT;
+                mContext->cursor = static_cast<SizeT>(trailer[0]);
+
+                // Read String Table:
+                const SizeT numStrings = static_cast<SizeT>(ReadVarint());
+                mContext->strings.reserve(numStrings);
+                for (SizeT i = 0; i < numStrings; ++i)
+                {
+                    const SizeT size = static_cast<SizeT>(ReadVarint());
+                    const char* bytes = reinterpret_cast<const char*>(ReadBytes(size));
+                    StringEntry entry;
+                    entry.token = Token(String(size, bytes));
+                    entry.type = nullptr;
+                    entry.typeResolved = false;
+                    mContext->strings.push_back(entry);
+                }
+
+                // Read Objects:
+                const SizeT numObjects = static_cast<SizeT>(ReadVarint());
+                for (SizeT i = 0; i < numObjects; ++i)
+                {
+                    const UInt64 name = ReadVarint();
+                    const UInt64 super = ReadVarint();
+
+                    ObjectInfo info;
+                    info.name = name == 0 ? String() : String(GetString(name - 1).token.CStr());
+                    info.super = super == 0 ? String() : String(GetString(super - 1).token.CStr());
+                    info.location = static_cast<SizeT>(ReadVarint());
+                    info.size = static_cast<SizeT>(ReadVarint());
+                    mContext->objects.push_back(info);
+                }
+                return;
+            }
+        }
+
+        UInt32* footerSize = reinterpret_cast<UInt32*>(ReverseRead(4));
+        for (SizeT i = 0, size = static_cast<SizeT>(*footerSize); i < size; ++i)
+        {
+            UInt32* nameSize = reinterpret_cast<UInt32*>(ReverseRead(4));
+            UInt32* superSize = reinterpret_cast<UInt32*>(ReverseRead(4));
+            UInt32* objLocation = reinterpret_cast<UInt32*>(ReverseRead(4));
+            UInt32* objSize = reinterpret_cast<UInt32*>(ReverseRead(4));
+
+            String name(static_cast<SizeT>(*nameSize), reinterpret_cast<char*>(ReverseRead(static_cast<SizeT>(*nameSize))));
+            String super(static_cast<SizeT>(*superSize), reinterpret_cast<char*>(ReverseRead(static_cast<SizeT>(*superSize))));
+
+            ObjectInfo info;
+            info.name = name;
+            info.super = super;
+            info.location = static_cast<SizeT>(*objLocation);
+            info.size = static_cast<SizeT>(*objSize);
+            mContext->objects.push_back(info);
+        }
+    }
+
+    void BinaryStream::WriteFooter()
+    {
+        if (mContext->format == FORMAT_COMPACT)
+        {
+            // ** Object names go into the string table so it must be complete before it's written.
+            TVector<UInt32> objectNames;
+            objectNames.reserve(mContext->objects.size() * 2);
+            for (const ObjectInfo& info : mContext->objects)
+            {
+                objectNames.push_back(info.name.Empty() ? 0 : FindOrAddString(Token(info.name)) + 1);
+                objectNames.push_back(info.super.Empty() ? 0 : FindOrAddString(Token(info.super)) + 1);
+            }
+
+            UInt32 trailer[3];
+            trailer[0] = static_cast<UInt32>(mContext->cursor);
+            trailer[1] = COMPACT_VERSION;
+            trailer[2] = COMPACT_MAGIC;
+
+            WriteVarint(mContext->strings.size());
+            for (const StringEntry& entry : mContext->strings)
+            {
+                WriteVarint(entry.token.Size());
+                WriteBytes(entry.token.CStr(), entry.token.Size());
+            }
+
+            WriteVarint(mContext->objects.size());
+            for (SizeT i = 0, size = mContext->objects.size(); i < size; ++i)
+            {
+                const ObjectInfo& info = mContext->objects[i];
+                WriteVarint(objectNames[i * 2]);
+                WriteVarint(objectNames[i * 2 + 1]);
+                WriteVarint(info.location);
+                WriteVarint(info.size);
+            }
+
+            if (IsBigEndian())
+            {
+                SwapBytesArray(trailer, 3, 4);
+            }
+            WriteBytes(trailer, COMPACT_TRAILER_SIZE);
+            return;
+        }
+
+        for (SizeT i = 0, size = mContext->objects.size(); i < size; ++i)
+        {
+            const ObjectInfo& info = mContext->objects[i];
+
+            UInt32 superSize = static_cast<UInt32>(info.super.Size());
+            WriteBytes(info.super.CStr(), superSize);
+
+            UInt32 nameSize = static_cast<UInt32>(info.name.Size());
+            WriteBytes(info.name.CStr(), nameSize);
+
+            UInt32 objLocation = static_cast<UInt32>(info.location);
+            UInt32 objSize = static_cast<UInt32>(info.size);
+            WriteBytes(&objSize, 4);
+            WriteBytes(&objLocation, 4);
+            WriteBytes(&superSize, 4);
+            WriteBytes(&nameSize, 4);
+        }
+        UInt32 footerSize = static_cast<UInt32>(mContext->objects.size());
+        WriteBytes(&footerSize, 4);
+    }
+
+    void BinaryStream::SerializeValue(void* value, size_t numBytes, size_t componentSize)
+    {
+        if (IsReading())
+        {
+            memcpy(value, ReadBytes(numBytes), numBytes);
+            if (IsSwapRequired())
+            {
+                SwapBytesArray(value, numBytes / componentSize, componentSize);
+            }
+        }
+        else if (IsSwapRequired())
+        {
+            ByteT bytes[16];
+            Assert(numBytes <= sizeof(bytes));
+            memcpy(bytes, value, numBytes);
+            SwapBytesArray(bytes, numBytes / componentSize, componentSize);
+            WriteBytes(bytes, numBytes);
+        }
+        else
+        {
+            WriteBytes(value, numBytes);
+        }
+    }
+
+    void BinaryStream::SerializeSize(size_t& value)
+    {
+        if (mContext->format == FORMAT_COMPACT)
+        {
+            if (IsReading())
+            {
+                value = static_cast<size_t>(ReadVarint());
+            }
+            else
+            {
+                WriteVarint(value);
+            }
+        }
+        else
+        {
+            UInt32 size32 = static_cast<UInt32>(value);
+            Serialize(size32);
+            value = static_cast<size_t>(size32);
+        }
+    }
+
+    void BinaryStream::WriteVarint(UInt64 value)
+    {
+        ByteT bytes[10];
+        SizeT numBytes = 0;
+        while (value >= 0x80)
+        {
+            bytes[numBytes++] = static_cast<ByteT>(value | 0x80);
+            value >>= 7;
+        }
+        bytes[numBytes++] = static_cast<ByteT>(value);
+        WriteBytes(bytes, numBytes);
+    }
+
+    UInt64 BinaryStream::ReadVarint()
+    {
+        UInt64 value = 0;
+        for (UInt32 shift = 0; shift < 64; shift += 7)
+        {
+            const ByteT byte = *reinterpret_cast<const ByteT*>(ReadBytes(1));
+            value |= static_cast<UInt64>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+        CriticalAssertMsgEx("Invalid varint in binary stream.", LF_ERROR_INTERNAL, ERROR_API_CORE);
+        return value;
+    }
+
+    UInt32 BinaryStream::FindOrAddString(const Token& token)
+    {
+        auto it = mContext->stringIndices.find(token.CStr());
+        if (it != mContext->stringIndices.end())
+        {
+            return it->second;
+        }
+
+        UInt32 index = static_cast<UInt32>(mContext->strings.size());
+        StringEntry entry;
+        entry.token = token;
+        entry.type = nullptr;
+        entry.typeResolved = false;
+        mContext->strings.push_back(entry);
+        mContext->stringIndices[token.CStr()] = index;
+        return index;
+    }
+
+    BinaryStream::StringEntry& BinaryStream::GetString(UInt64 index)
+    {
+        if (index >= mContext->strings.size())
+        {
+            CriticalAssertMsgEx("Invalid string table index in binary stream.", LF_ERROR_INTERNAL, ERROR_API_CORE);
+        }
+        return mContext->strings[static_cast<SizeT>(index)];
+    }
+
+    bool BinaryStream::IsSwapRequired() const
+    {
+        // ** FORMAT_COMPACT is always little endian, FORMAT_LEGACY is native.
+        return mContext->format == FORMAT_COMPACT && IsBigEndian();
+    }
+
     void BinaryStream::WriteBytes(const void* buffer, size_t numBytes)
     {
         Assert(mContext);
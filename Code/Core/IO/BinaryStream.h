@@ -22,13 +22,33 @@
 
 #include "Core/IO/Stream.h"
 #include "Core/Memory/MemoryBuffer.h"
+#include "Core/String/Token.h"
 #include "Core/Utility/Array.h"
+#include "Core/Utility/StdMap.h"
 
 namespace lf
 {
+    // **********************************
+    // Stream that serializes to a binary buffer, objects are located with a footer at the end of the buffer.
+    //
+    // Two formats can be read, the format is detected when the stream is opened for reading.
+    // 
+    // FORMAT_LEGACY: The original format, values are written in native byte order and every
+    //                Token/Type is written as a length prefixed string.
+    // FORMAT_COMPACT: Values are written in little endian, Token/Type are written as a varint
+    //                 index into a string table stored with the footer. Sizes are written as varints.
+    // 
+    // Streams opened for writing use FORMAT_LEGACY unless SetFormat is called.
+    // **********************************
     class LF_CORE_API BinaryStream : public Stream
     {
     public:
+        enum Format
+        {
+            FORMAT_LEGACY,
+            FORMAT_COMPACT
+        };
+
         BinaryStream();
         BinaryStream(Stream::StreamMemory, MemoryBuffer* buffer, StreamMode mode);
         BinaryStream(Stream::StreamFile, const String& filename, StreamMode mode);
@@ -63,6 +83,7 @@ namespace lf
         void Serialize(const StreamPropertyInfo& info) override;
         void Serialize(const ArrayPropertyInfo& info) override;
         void Serialize(MemoryBuffer& value) override;
+        bool SerializeBulk(void* values, SizeT count, SizeT elementSize, SizeT componentSize) override;
         void SerializeBuffer(MemoryBuffer& buffer);
 
         bool BeginObject(const String& name, const String& super) override;
@@ -85,6 +106,13 @@ namespace lf
         const String& GetObjectSuper(const size_t index) const override;
 
         size_t GetCursor() const;
+
+        // **********************************
+        // Sets the format the stream writes in, must be called after opening for write and before
+        // anything is written.
+        // **********************************
+        void SetFormat(Format format);
+        Format GetFormat() const;
     private:
         struct ObjectInfo
         {
@@ -94,17 +122,38 @@ namespace lf
             size_t size;
         };
 
+        // ** An entry in the string table (FORMAT_COMPACT)
+        struct StringEntry
+        {
+            Token token;
+            const Type* type;
+            bool typeResolved;
+        };
+
         class BinaryStreamContext : public StreamContext
         {
         public:
             TVector<ObjectInfo> objects;
+            TVector<StringEntry> strings;
+            TMap<const char*, UInt32> stringIndices; // ** Token string -> index into 'strings', write only
             String filename;
             size_t cursor;
             size_t arraySize;
             MemoryBuffer* buffer;
+            Format format;
             bool destroyBufferOnClear;
         };
 
+        void ReadFooter(size_t bufferSize);
+        void WriteFooter();
+        void SerializeValue(void* value, size_t numBytes, size_t componentSize);
+        void SerializeSize(size_t& value);
+        void WriteVarint(UInt64 value);
+        UInt64 ReadVarint();
+        UInt32 FindOrAddString(const Token& token);
+        StringEntry& GetString(UInt64 index);
+        bool IsSwapRequired() const;
+
         void WriteBytes(const void* buffer, size_t numBytes);
         void* ReadBytes(size_t numBytes);
         void* ReverseRead(size_t numBytes);
@@ -0,0 +1,323 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "FrozenBlob.h"
+#include "Core/Memory/MemoryBuffer.h"
+#include "Core/Reflection/Type.h"
+#include "Core/Utility/ByteOrder.h"
+#include "Core/Utility/FNVHash.h"
+#include "Core/Utility/Utility.h"
+
+namespace lf {
+
+// ** Blob: [FrozenBlobHeader][data...][relocations...]
+struct FrozenBlobHeader
+{
+    UInt32 mMagic;
+    UInt16 mVersion;
+    UInt16 mAlignment;
+    UInt64 mLayoutHash;
+    UInt64 mSize;
+    UInt64 mRootOffset;
+    UInt64 mRootSize;
+    UInt64 mRelocationOffset;
+    UInt64 mRelocationCount;
+    UInt64 mReserved;
+};
+LF_STATIC_ASSERT(sizeof(FrozenBlobHeader) == 64);
+LF_STATIC_ASSERT(sizeof(TFrozenPtr<UInt32>) == 8);
+LF_STATIC_ASSERT(sizeof(TFrozenArray<UInt32>) == 16);
+
+static const UInt32 FROZEN_BLOB_MAGIC = 0x5A46464C; // 'LFFZ'
+static const UInt16 FROZEN_BLOB_VERSION = 1;
+static const SizeT FROZEN_BLOB_MIN_ALIGNMENT = 16;
+static const SizeT FROZEN_BLOB_MAX_ALIGNMENT = 4096;
+
+static UInt64 HashAppend(UInt64 hash, const void* data, SizeT numBytes)
+{
+    const ByteT* bytes = reinterpret_cast<const ByteT*>(data);
+    for (SizeT i = 0; i < numBytes; ++i)
+    {
+        hash = hash * FNV::FNV_PRIME;
+        hash = hash ^ bytes[i];
+    }
+    return hash;
+}
+
+static UInt64 HashAppend(UInt64 hash, UInt64 value)
+{
+    return HashAppend(hash, &value, sizeof(value));
+}
+
+static UInt64 HashAppend(UInt64 hash, const Token& value)
+{
+    return HashAppend(HashAppend(hash, value.CStr(), value.Size()), static_cast<UInt64>(value.Size()));
+}
+
+static SizeT AlignOffset(SizeT offset, SizeT alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+static bool IsPowerOfTwo(SizeT value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+FrozenLayout FrozenLayout::Compute(const Type* type, SizeT rootSize, SizeT rootAlignment, UInt32 version, const FrozenLayoutElement* elements, SizeT numElements)
+{
+    UInt64 hash = FNV::FNV_OFFSET_BASIS;
+    hash = HashAppend(hash, static_cast<UInt64>(version));
+    hash = HashAppend(hash, static_cast<UInt64>(rootSize));
+    hash = HashAppend(hash, static_cast<UInt64>(rootAlignment));
+    hash = HashAppend(hash, static_cast<UInt64>(IsBigEndian() ? 1 : 0));
+    for (const Type* iter = type; iter; iter = iter->GetSuper())
+    {
+        hash = HashAppend(hash, iter->GetFullName());
+        hash = HashAppend(hash, static_cast<UInt64>(iter->GetSize()));
+        hash = HashAppend(hash, static_cast<UInt64>(iter->GetAlignment()));
+    }
+    hash = HashAppend(hash, static_cast<UInt64>(numElements));
+    for (SizeT i = 0; i < numElements; ++i)
+    {
+        hash = HashAppend(hash, static_cast<UInt64>(elements[i].mSize));
+        hash = HashAppend(hash, static_cast<UInt64>(elements[i].mAlignment));
+    }
+    return FrozenLayout(hash);
+}
+
+FrozenBlobWriter::FrozenBlobWriter()
+: mData()
+, mRelocations()
+, mAlignment(FROZEN_BLOB_MIN_ALIGNMENT)
+{
+    // ** Reserve the header so offsets are relative to the start of the blob.
+    mData.resize(sizeof(FrozenBlobHeader), 0);
+}
+
+SizeT FrozenBlobWriter::Allocate(SizeT size, SizeT alignment)
+{
+    Assert(IsPowerOfTwo(alignment) && alignment <= FROZEN_BLOB_MAX_ALIGNMENT);
+    mAlignment = Max(mAlignment, alignment);
+    const SizeT offset = AlignOffset(mData.size(), alignment);
+    mData.resize(offset + size, 0);
+    return offset;
+}
+
+SizeT FrozenBlobWriter::Write(const void* data, SizeT size, SizeT alignment)
+{
+    const SizeT offset = Allocate(size, alignment);
+    if (size > 0)
+    {
+        memcpy(&mData[offset], data, size);
+    }
+    return offset;
+}
+
+void FrozenBlobWriter::AddRelocation(SizeT fieldOffset, SizeT targetOffset, SizeT elementSize, SizeT count, RelocationKind kind)
+{
+    Assert(fieldOffset + sizeof(Int64) <= mData.size());
+    Assert(count == 0 || targetOffset + elementSize * count <= mData.size());
+
+    // ** An empty array is stored as null
+    Int64 offset = count == 0 ? 0 : static_cast<Int64>(targetOffset) - static_cast<Int64>(fieldOffset);
+    memcpy(&mData[fieldOffset], &offset, sizeof(offset));
+
+    Relocation relocation;
+    relocation.mField = static_cast<UInt64>(fieldOffset);
+    relocation.mElementSize = static_cast<UInt32>(elementSize);
+    relocation.mKind = static_cast<UInt32>(kind);
+    mRelocations.push_back(relocation);
+}
+
+bool FrozenBlobWriter::Finish(SizeT rootOffset, SizeT rootSize, const FrozenLayout& layout, MemoryBuffer& buffer) const
+{
+    if (rootOffset < sizeof(FrozenBlobHeader) || rootOffset + rootSize > mData.size())
+    {
+        return false;
+    }
+
+    const SizeT relocationOffset = AlignOffset(mData.size(), alignof(Relocation));
+    const SizeT size = relocationOffset + mRelocations.size() * sizeof(Relocation);
+    if (!buffer.Allocate(size, mAlignment))
+    {
+        return false;
+    }
+    buffer.SetSize(size);
+
+    ByteT* bytes = reinterpret_cast<ByteT*>(buffer.GetData());
+    memcpy(bytes, mData.data(), mData.size());
+    memset(bytes + mData.size(), 0, relocationOffset - mData.size());
+    if (!mRelocations.empty())
+    {
+        memcpy(bytes + relocationOffset, mRelocations.data(), mRelocations.size() * sizeof(Relocation));
+    }
+
+    FrozenBlobHeader header;
+    header.mMagic = FROZEN_BLOB_MAGIC;
+    header.mVersion = FROZEN_BLOB_VERSION;
+    header.mAlignment = static_cast<UInt16>(mAlignment);
+    header.mLayoutHash = layout.mHash;
+    header.mSize = static_cast<UInt64>(size);
+    header.mRootOffset = static_cast<UInt64>(rootOffset);
+    header.mRootSize = static_cast<UInt64>(rootSize);
+    header.mRelocationOffset = static_cast<UInt64>(relocationOffset);
+    header.mRelocationCount = static_cast<UInt64>(mRelocations.size());
+    header.mReserved = 0;
+    memcpy(bytes, &header, sizeof(header));
+    return true;
+}
+
+FrozenBlob::FrozenBlob()
+: mData(nullptr)
+, mSize(0)
+, mRootOffset(0)
+, mRootSize(0)
+, mDataEnd(0)
+{}
+
+FrozenBlob::OpenResult FrozenBlob::Open(const void* data, SizeT size, const FrozenLayout& layout)
+{
+    Close();
+    if (!IsFrozenBlob(data, size))
+    {
+        return OR_INVALID_HEADER;
+    }
+
+    FrozenBlobHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.mVersion != FROZEN_BLOB_VERSION 
+        || header.mSize != static_cast<UInt64>(size)
+        || !IsPowerOfTwo(header.mAlignment)
+        || header.mRootOffset < sizeof(FrozenBlobHeader)
+        || header.mRelocationOffset < sizeof(FrozenBlobHeader)
+        || header.mRelocationOffset > header.mSize
+        || header.mRootSize > header.mRelocationOffset
+        || header.mRootOffset > header.mRelocationOffset - header.mRootSize
+        || header.mRelocationCount > (header.mSize - header.mRelocationOffset) / sizeof(UInt64[2]))
+    {
+        return OR_INVALID_HEADER;
+    }
+
+    if (header.mLayoutHash != layout.mHash)
+    {
+        return OR_LAYOUT_MISMATCH;
+    }
+
+    if ((reinterpret_cast<UIntPtrT>(data) & static_cast<UIntPtrT>(header.mAlignment - 1)) != 0)
+    {
+        return OR_MISALIGNED;
+    }
+
+    // ** Validate every pointer/array recorded by the writer, targets must be within the data section.
+    const ByteT* bytes = reinterpret_cast<const ByteT*>(data);
+    const UInt64 dataBegin = sizeof(FrozenBlobHeader);
+    const UInt64 dataEnd = header.mRelocationOffset;
+    for (UInt64 i = 0; i < header.mRelocationCount; ++i)
+    {
+        UInt64 relocation[2];
+        memcpy(relocation, bytes + header.mRelocationOffset + i * sizeof(relocation), sizeof(relocation));
+        const UInt64 field = relocation[0];
+        const UInt64 elementSize = relocation[1] & 0xFFFFFFFF;
+        const UInt64 kind = relocation[1] >> 32;
+
+        const UInt64 fieldSize = kind == 0 ? sizeof(Int64) : sizeof(Int64) + sizeof(UInt64);
+        if (field < dataBegin || field > dataEnd - fieldSize || (field & (sizeof(Int64) - 1)) != 0 || kind > 1)
+        {
+            return OR_INVALID_RELOCATION;
+        }
+
+        Int64 offset = 0;
+        memcpy(&offset, bytes + field, sizeof(offset));
+        UInt64 count = 1;
+        if (kind == 1)
+        {
+            memcpy(&count, bytes + field + sizeof(Int64), sizeof(count));
+        }
+        if (offset == 0)
+        {
+            if (kind == 1 && count != 0)
+            {
+                return OR_INVALID_RELOCATION;
+            }
+            continue;
+        }
+
+        // ** Every element must be at least a byte, otherwise the count is unbounded.
+        const UInt64 target = field + static_cast<UInt64>(offset);
+        if (elementSize == 0 || target < dataBegin || target > dataEnd || count > (dataEnd - target) / elementSize)
+        {
+            return OR_INVALID_RELOCATION;
+        }
+    }
+
+    mData = bytes;
+    mSize = size;
+    mRootOffset = static_cast<SizeT>(header.mRootOffset);
+    mRootSize = static_cast<SizeT>(header.mRootSize);
+    mDataEnd = static_cast<SizeT>(header.mRelocationOffset);
+    return OR_SUCCESS;
+}
+
+void FrozenBlob::Close()
+{
+    mData = nullptr;
+    mSize = 0;
+    mRootOffset = 0;
+    mRootSize = 0;
+    mDataEnd = 0;
+}
+
+bool FrozenBlob::ContainsRange(const void* data, SizeT count, SizeT elementSize) const
+{
+    if (!IsOpen() || elementSize == 0)
+    {
+        return false;
+    }
+    const UIntPtrT begin = reinterpret_cast<UIntPtrT>(mData) + sizeof(FrozenBlobHeader);
+    const UIntPtrT end = reinterpret_cast<UIntPtrT>(mData) + mDataEnd;
+    const UIntPtrT target = reinterpret_cast<UIntPtrT>(data);
+    return target >= begin && target <= end && count <= (end - target) / elementSize;
+}
+
+bool FrozenBlob::IsFrozenBlob(const void* data, SizeT size)
+{
+    if (!data || size < sizeof(FrozenBlobHeader))
+    {
+        return false;
+    }
+    UInt32 magic = 0;
+    memcpy(&magic, data, sizeof(magic));
+    return magic == FROZEN_BLOB_MAGIC;
+}
+
+SizeT FrozenBlob::GetRequiredAlignment(const void* data, SizeT size)
+{
+    if (!IsFrozenBlob(data, size))
+    {
+        return 0;
+    }
+    FrozenBlobHeader header;
+    memcpy(&header, data, sizeof(header));
+    return static_cast<SizeT>(header.mAlignment);
+}
+
+} // namespace lf
@@ -0,0 +1,278 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Common/Types.h"
+#include "Core/Common/API.h"
+#include "Core/Common/Assert.h"
+#include "Core/Utility/Array.h"
+
+namespace lf {
+
+class Type;
+class MemoryBuffer;
+
+// **********************************
+// A pointer stored as an offset relative to its own address so a frozen blob
+// can be used from any address (eg. a read only memory mapped file) without
+// writing pointers.
+// **********************************
+template<typename T>
+class TFrozenPtr
+{
+    friend class FrozenBlobWriter;
+public:
+    TFrozenPtr() : mOffset(0) {}
+
+    LF_INLINE const T* Get() const
+    {
+        return mOffset == 0 ? nullptr : reinterpret_cast<const T*>(reinterpret_cast<UIntPtrT>(this) + static_cast<UIntPtrT>(mOffset));
+    }
+    LF_INLINE const T* operator->() const { return Get(); }
+    LF_INLINE const T& operator*() const { return *Get(); }
+    LF_INLINE bool IsNull() const { return mOffset == 0; }
+private:
+    Int64 mOffset;
+};
+
+// **********************************
+// A contiguous array within a frozen blob.
+// **********************************
+template<typename T>
+class TFrozenArray
+{
+    friend class FrozenBlobWriter;
+public:
+    using value_type = T;
+    TFrozenArray() : mData(), mSize(0) {}
+
+    LF_INLINE const T* begin() const { return mData.Get(); }
+    LF_INLINE const T* end() const { return mData.Get() + mSize; }
+    LF_INLINE const T* data() const { return mData.Get(); }
+    LF_INLINE SizeT size() const { return static_cast<SizeT>(mSize); }
+    LF_INLINE bool empty() const { return mSize == 0; }
+    LF_INLINE const T& operator[](SizeT index) const { return mData.Get()[index]; }
+private:
+    TFrozenPtr<T> mData;
+    UInt64        mSize;
+};
+
+// **********************************
+// The size/alignment of a structure stored in a frozen blob.
+// **********************************
+struct FrozenLayoutElement
+{
+    SizeT mSize;
+    SizeT mAlignment;
+};
+
+// **********************************
+// Identifies the memory layout of the data in a frozen blob, blobs that were
+// written with a different layout are rejected when opened.
+// **********************************
+struct LF_CORE_API FrozenLayout
+{
+    FrozenLayout() : mHash(0) {}
+    explicit FrozenLayout(UInt64 hash) : mHash(hash) {}
+
+    // **********************************
+    // Computes the layout from the reflected type (name, size and alignment
+    // including the super types) combined with the size/alignment of the root
+    // structure, the size/alignment of every element type stored in the blob
+    // and a version the owner bumps when any of those structures change.
+    // 
+    // note: The frozen structures are not reflected, a change that keeps the
+    //       sizes (eg. reordering fields) is only caught by the version.
+    // 
+    // @param type -- The reflected type that owns the frozen data
+    // @param rootSize -- sizeof the root structure
+    // @param rootAlignment -- alignof the root structure
+    // @param version -- Version of the frozen structures
+    // @param elements -- The element types referenced by the root (TFrozenPtr/TFrozenArray), in a fixed order
+    // @param numElements -- The number of element types
+    // **********************************
+    static FrozenLayout Compute(const Type* type, SizeT rootSize, SizeT rootAlignment, UInt32 version, const FrozenLayoutElement* elements = nullptr, SizeT numElements = 0);
+    template<typename RootT, typename ... ElementTs>
+    static FrozenLayout Compute(const Type* type, UInt32 version)
+    {
+        const FrozenLayoutElement elements[] = { { sizeof(RootT), alignof(RootT) }, { sizeof(ElementTs), alignof(ElementTs) }... };
+        return Compute(type, sizeof(RootT), alignof(RootT), version, elements + 1, LF_ARRAY_SIZE(elements) - 1);
+    }
+
+    bool operator==(const FrozenLayout& other) const { return mHash == other.mHash; }
+    bool operator!=(const FrozenLayout& other) const { return mHash != other.mHash; }
+
+    UInt64 mHash;
+};
+
+// **********************************
+// Builds a frozen blob. All allocations are addressed by their offset since the
+// storage may grow, pointers returned from Get are invalidated by Allocate.
+// 
+// Every TFrozenPtr/TFrozenArray must be set with SetPointer/SetArray so it is
+// recorded in the relocation table and validated when the blob is opened.
+// **********************************
+class LF_CORE_API FrozenBlobWriter
+{
+public:
+    FrozenBlobWriter();
+
+    // **********************************
+    // Allocates zero initialized memory within the blob.
+    // @returns Returns the offset of the memory
+    // **********************************
+    SizeT Allocate(SizeT size, SizeT alignment);
+    template<typename T>
+    SizeT Allocate(SizeT count = 1) { return Allocate(sizeof(T) * count, alignof(T)); }
+    // **********************************
+    // Allocates and copies data into the blob.
+    // @returns Returns the offset of the memory
+    // **********************************
+    SizeT Write(const void* data, SizeT size, SizeT alignment);
+
+    template<typename T>
+    T* Get(SizeT offset) { return reinterpret_cast<T*>(&mData[offset]); }
+
+    // **********************************
+    // Points the TFrozenPtr<T> at 'fieldOffset' to the T at 'targetOffset'
+    // **********************************
+    template<typename T>
+    void SetPointer(SizeT fieldOffset, SizeT targetOffset)
+    {
+        AddRelocation(fieldOffset, targetOffset, sizeof(T), 1, RELOCATION_POINTER);
+    }
+    // **********************************
+    // Points the TFrozenArray<T> at 'fieldOffset' to 'count' elements at 'targetOffset'
+    // **********************************
+    template<typename T>
+    void SetArray(SizeT fieldOffset, SizeT targetOffset, SizeT count)
+    {
+        Get<TFrozenArray<T>>(fieldOffset)->mSize = static_cast<UInt64>(count);
+        AddRelocation(fieldOffset, targetOffset, sizeof(T), count, RELOCATION_ARRAY);
+    }
+    // **********************************
+    // Copies 'count' elements into the blob and points the TFrozenArray<T> at 'fieldOffset' to them.
+    // **********************************
+    template<typename T>
+    void WriteArray(SizeT fieldOffset, const T* values, SizeT count)
+    {
+        SizeT targetOffset = count > 0 ? Write(values, sizeof(T) * count, alignof(T)) : 0;
+        SetArray<T>(fieldOffset, targetOffset, count);
+    }
+
+    // **********************************
+    // Writes the blob (header, data and relocation table) to the buffer.
+    // 
+    // @param rootOffset -- The offset of the root structure
+    // @param rootSize -- The size of the root structure
+    // @param layout -- The layout readers must match
+    // **********************************
+    bool Finish(SizeT rootOffset, SizeT rootSize, const FrozenLayout& layout, MemoryBuffer& buffer) const;
+    template<typename RootT>
+    bool Finish(SizeT rootOffset, const FrozenLayout& layout, MemoryBuffer& buffer) const { return Finish(rootOffset, sizeof(RootT), layout, buffer); }
+private:
+    enum RelocationKind
+    {
+        RELOCATION_POINTER,
+        RELOCATION_ARRAY
+    };
+    struct Relocation
+    {
+        UInt64 mField;
+        UInt32 mElementSize;
+        UInt32 mKind;
+    };
+    void AddRelocation(SizeT fieldOffset, SizeT targetOffset, SizeT elementSize, SizeT count, RelocationKind kind);
+
+    TVector<ByteT>      mData;
+    TVector<Relocation> mRelocations;
+    SizeT               mAlignment;
+};
+
+// **********************************
+// A read only view of a frozen blob. Opening the blob validates the header,
+// the layout and every relocation (pointer and array) against the bounds of
+// the blob, the memory is never written to so it can be used directly from a
+// memory mapped file.
+// 
+// note: The memory must outlive the FrozenBlob.
+// **********************************
+class LF_CORE_API FrozenBlob
+{
+public:
+    enum OpenResult
+    {
+        OR_SUCCESS,
+        OR_INVALID_HEADER,
+        OR_LAYOUT_MISMATCH,
+        OR_MISALIGNED,
+        OR_INVALID_RELOCATION
+    };
+
+    FrozenBlob();
+
+    // **********************************
+    // Validates and opens the blob in place.
+    // 
+    // @param data -- The blob, must be aligned to the alignment the blob was written with
+    // @param size -- The size of the blob in bytes
+    // @param layout -- The expected layout
+    // **********************************
+    OpenResult Open(const void* data, SizeT size, const FrozenLayout& layout);
+    void Close();
+
+    LF_INLINE bool IsOpen() const { return mData != nullptr; }
+    LF_INLINE const ByteT* GetData() const { return mData; }
+    LF_INLINE SizeT GetSize() const { return mSize; }
+
+    template<typename RootT>
+    const RootT* GetRoot() const
+    {
+        Assert(sizeof(RootT) <= mRootSize);
+        return IsOpen() && sizeof(RootT) <= mRootSize ? reinterpret_cast<const RootT*>(mData + mRootOffset) : nullptr;
+    }
+
+    // **********************************
+    // Checks the array/pointer lies within the data of the blob using the
+    // size of the readers element type. Open validates with the element size
+    // recorded by the writer, use this before reading elements whose type may
+    // not match what was written.
+    // **********************************
+    template<typename T>
+    bool Contains(const TFrozenArray<T>& array) const { return array.empty() || ContainsRange(array.data(), array.size(), sizeof(T)); }
+    template<typename T>
+    bool Contains(const TFrozenPtr<T>& pointer) const { return pointer.IsNull() || ContainsRange(pointer.Get(), 1, sizeof(T)); }
+
+    // ** Returns true if the data starts with a frozen blob header
+    static bool IsFrozenBlob(const void* data, SizeT size);
+    // ** Returns the alignment the blob requires, 0 if the data is not a frozen blob
+    static SizeT GetRequiredAlignment(const void* data, SizeT size);
+private:
+    bool ContainsRange(const void* data, SizeT count, SizeT elementSize) const;
+
+    const ByteT* mData;
+    SizeT        mSize;
+    SizeT        mRootOffset;
+    SizeT        mRootSize;
+    // ** The end of the data section (the relocation table follows it)
+    SizeT        mDataEnd;
+};
+
+} // namespace lf
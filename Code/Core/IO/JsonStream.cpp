@@ -71,13 +71,35 @@ public:
     rapidjson::PrettyWriter<rapidjson::StringBuffer> mWriter;
 };
 
+// ** Base class for the read modes, all reads are relative to the value selected last.
 class JsonReadStreamContext : public JsonStreamContext
 {
 public:
-    JsonReadStreamContext()
-    : JsonStreamContext()
+    JsonReadStreamContext() : JsonStreamContext() {}
+
+    // ** Parses the text, the text must outlive the context.
+    virtual bool Parse(const String& text) = 0;
+    // ** Selects the member of the current struct
+    virtual void Select(const char* key) = 0;
+    // ** Selects the element of the current array
+    virtual void SelectIndex(SizeT index) = 0;
+    // ** Returns the selected value and deselects it, the value is valid until the next read.
+    virtual const rapidjson::Value* Read() = 0;
+    virtual bool BeginStruct() = 0;
+    virtual void EndStruct() = 0;
+    virtual bool BeginArray() = 0;
+    virtual void EndArray() = 0;
+    virtual SizeT GetArraySize() = 0;
+};
+
+class JsonDocumentReadStreamContext : public JsonReadStreamContext
+{
+public:
+    JsonDocumentReadStreamContext()
+    : JsonReadStreamContext()
     , mDocument()
     , mTop()
+    , mValueReady(false)
     {
     }
 
@@ -90,7 +112,26 @@ public:
         return mValueReady ? mTop.back() : End();
     }
 
-    void Select(const char* key)
+    void Pop()
+    {
+        if (!mTop.empty())
+        {
+            mTop.pop_back();
+        }
+        mValueReady = false;
+    }
+
+    rapidjson::Value* End()
+    {
+        return nullptr;
+    }
+
+    bool Parse(const String& text) override
+    {
+        return !mDocument.Parse(text.CStr()).HasParseError();
+    }
+
+    void Select(const char* key) override
     {
         auto iter = mTop.empty() ? mDocument.FindMember(key) : mTop.back()->FindMember(key);
         auto end = mTop.empty() ? mDocument.MemberEnd() : mTop.back()->MemberEnd();
@@ -105,54 +146,530 @@ public:
         }
     }
 
-    void Pop()
+    void SelectIndex(SizeT index) override
     {
-        if (!mTop.empty())
+        auto iter = mTop.empty() ? End() : mTop.back();
+        if (iter != End() && iter->IsArray())
         {
-            mTop.pop_back();
+            mTop.push_back(&iter->GetArray()[static_cast<rapidjson::SizeType>(index)]);
+            mValueReady = true;
         }
-        mValueReady = false;
     }
 
-    rapidjson::Value* End()
+    const rapidjson::Value* Read() override
     {
-        return nullptr;
+        rapidjson::Value* value = Top();
+        if (value != End())
+        {
+            Pop();
+        }
+        return value;
     }
 
-    /*
-    rapidjson::Document::MemberIterator Top()
+    bool BeginStruct() override
     {
-        return mValueReady ? mTop.GetLast() : End();
+        return Top() != End() ? Top()->IsObject() : false;
     }
 
-    void Select(const char* key)
+    void EndStruct() override
     {
-        auto iter = mTop.Empty() ? mDocument.FindMember(key) : mTop.GetLast()->value.FindMember(key);
-        if (iter != mDocument.MemberEnd())
+        Pop();
+    }
+
+    bool BeginArray() override
+    {
+        return Top() != End() ? Top()->IsArray() : false;
+    }
+
+    void EndArray() override
+    {
+        Pop();
+    }
+
+    SizeT GetArraySize() override
+    {
+        auto iter = Top();
+        return iter != End() && iter->IsArray() ? static_cast<SizeT>(iter->GetArray().Size()) : 0;
+    }
+};
+
+// ** Captures a single value with the SAX reader, containers are rejected.
+class JsonScalarHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JsonScalarHandler>
+{
+public:
+    JsonScalarHandler(rapidjson::Value& value, lf::String& string) : mValue(value), mString(string) {}
+
+    bool Null() { mValue.SetNull(); return true; }
+    bool Bool(bool value) { mValue.SetBool(value); return true; }
+    bool Int(int value) { mValue.SetInt(value); return true; }
+    bool Uint(unsigned value) { mValue.SetUint(value); return true; }
+    bool Int64(int64_t value) { mValue.SetInt64(value); return true; }
+    bool Uint64(uint64_t value) { mValue.SetUint64(value); return true; }
+    bool Double(double value) { mValue.SetDouble(value); return true; }
+    bool String(const char* value, rapidjson::SizeType length, bool)
+    {
+        mString = lf::String(static_cast<SizeT>(length), value);
+        mValue.SetString(rapidjson::StringRef(mString.CStr(), static_cast<rapidjson::SizeType>(mString.Size())));
+        return true;
+    }
+    bool StartObject() { return false; }
+    bool StartArray() { return false; }
+private:
+    rapidjson::Value& mValue;
+    lf::String&       mString;
+};
+
+// ********************************************************************
+// Reads the text with the rapidjson SAX reader instead of building a document.
+// 
+// Each struct/array that is being read keeps a cursor to the next member/element
+// in the text. Members are expected in the order they are serialized (the order
+// they were written) so selecting a member is usually just comparing the key at
+// the cursor. Members that are skipped to find an out of order key are kept in
+// a small lookup until the struct ends, elements are found by scanning from
+// the cursor or the start of the array.
+// 
+// Memory use is bounded by the depth of the text and the number of out of order
+// members, the values themselves are only parsed when they are read.
+// ********************************************************************
+class JsonSaxReadStreamContext : public JsonReadStreamContext
+{
+public:
+    enum FrameState : UInt8
+    {
+        // ** The value was selected but not read yet
+        FS_PENDING,
+        // ** BeginStruct/BeginArray succeeded on the value
+        FS_ENTERED,
+        // ** BeginStruct/BeginArray failed on the value
+        FS_REJECTED
+    };
+
+    struct Frame
+    {
+        // ** Position of the value
+        SizeT      mBegin;
+        // ** [Entered] Position of the next member/element or the closing bracket
+        SizeT      mCursor;
+        // ** [Entered Array] Index of the element at the cursor
+        SizeT      mIndex;
+        // ** First entry of mLookup that belongs to the struct
+        SizeT      mLookup;
+        FrameState mState;
+        // ** The value is at the cursor of the parent, finishing the value moves the parent cursor past it.
+        bool       mInOrder;
+    };
+
+    struct Member
+    {
+        // ** Position and length of the key (excluding quotes)
+        SizeT mKey;
+        SizeT mKeyLength;
+        // ** Position of the value
+        SizeT mValue;
+    };
+
+    JsonSaxReadStreamContext()
+    : JsonReadStreamContext()
+    , mText(nullptr)
+    , mLength(0)
+    , mParser()
+    , mFrames()
+    , mLookup()
+    , mScalar()
+    , mScalarString()
+    {
+    }
+
+    bool Parse(const String& text) override
+    {
+        mText = text.CStr();
+        mLength = text.Size();
+
+        // ** Validate the whole text up front so a bad source fails to open like it does with a document.
+        rapidjson::StringStream stream(mText);
+        rapidjson::BaseReaderHandler<rapidjson::UTF8<>> handler;
+        if (mParser.Parse(stream, handler).IsError())
         {
-            mTop.Add(iter);
-            mValueReady = true;
+            return false;
         }
-        else
+
+        const SizeT root = SkipWhitespace(0);
+        if (root >= mLength || mText[root] != '{')
         {
-            mValueReady = false;
+            return false;
         }
+        Push(root, false);
+        mFrames.back().mState = FS_ENTERED;
+        mFrames.back().mCursor = SkipWhitespace(root + 1);
+        return true;
     }
 
-    void Pop()
+    void Select(const char* key) override
     {
-        if (!mTop.Empty())
+        Frame* object = GetContainer('{');
+        if (!object)
         {
-            mTop.Remove(mTop.rbegin().GetBase());
+            return;
         }
-        mValueReady = false;
+        const SizeT keyLength = StrLen(key);
+
+        // ** Members skipped over by a previous select
+        for (SizeT i = object->mLookup; i < mLookup.size(); ++i)
+        {
+            if (KeyEquals(mLookup[i].mKey, mLookup[i].mKeyLength, key, keyLength))
+            {
+                Push(mLookup[i].mValue, false);
+                return;
+            }
+        }
+
+        // ** Fast path is the member at the cursor, otherwise skip forward remembering the members we pass.
+        SizeT pos = object->mCursor;
+        while (true)
+        {
+            Member member;
+            member.mValue = ScanMember(pos, member.mKey, member.mKeyLength);
+            if (Invalid(member.mValue))
+            {
+                object->mCursor = pos;
+                return;
+            }
+            if (KeyEquals(member.mKey, member.mKeyLength, key, keyLength))
+            {
+                object->mCursor = pos;
+                Push(member.mValue, true);
+                return;
+            }
+            const SizeT end = SkipValue(member.mValue);
+            if (Invalid(end))
+            {
+                object->mCursor = pos;
+                return;
+            }
+            mLookup.push_back(member);
+            pos = SkipSeparator(end);
+        }
+    }
+
+    void SelectIndex(SizeT index) override
+    {
+        Frame* array = GetContainer('[');
+        if (!array)
+        {
+            return;
+        }
+
+        const bool inOrder = index == array->mIndex;
+        SizeT current = index >= array->mIndex ? array->mIndex : 0;
+        SizeT pos = index >= array->mIndex ? array->mCursor : SkipWhitespace(array->mBegin + 1);
+        for (; current < index && pos < mLength && mText[pos] != ']'; ++current)
+        {
+            pos = SkipValue(pos);
+            if (Invalid(pos))
+            {
+                return;
+            }
+            pos = SkipSeparator(pos);
+        }
+        if (current == index && pos < mLength && mText[pos] != ']')
+        {
+            Push(pos, inOrder);
+        }
+    }
+
+    const rapidjson::Value* Read() override
+    {
+        if (mFrames.size() <= 1 || mFrames.back().mState != FS_PENDING)
+        {
+            return nullptr;
+        }
+
+        const SizeT begin = mFrames.back().mBegin;
+        rapidjson::StringStream stream(mText + begin);
+        JsonScalarHandler handler(mScalar, mScalarString);
+        const bool parsed = !mParser.Parse<rapidjson::kParseStopWhenDoneFlag>(stream, handler).IsError();
+        Pop(parsed ? begin + stream.Tell() : INVALID);
+        return parsed ? &mScalar : nullptr;
+    }
+
+    bool BeginStruct() override
+    {
+        return Enter('{');
+    }
+
+    void EndStruct() override
+    {
+        Exit('{');
+    }
+
+    bool BeginArray() override
+    {
+        return Enter('[');
+    }
+
+    void EndArray() override
+    {
+        Exit('[');
     }
 
-    rapidjson::Document::MemberIterator End()
+    SizeT GetArraySize() override
     {
-        return mDocument.MemberEnd();
-    }*/
+        if (mFrames.back().mState != FS_ENTERED || mText[mFrames.back().mBegin] != '[')
+        {
+            return 0;
+        }
 
+        const Frame& array = mFrames.back();
+        SizeT size = array.mIndex;
+        for (SizeT pos = array.mCursor; pos < mLength && mText[pos] != ']'; ++size)
+        {
+            pos = SkipValue(pos);
+            if (Invalid(pos))
+            {
+                return 0;
+            }
+            pos = SkipSeparator(pos);
+        }
+        return size;
+    }
+
+private:
+    void Push(SizeT begin, bool inOrder)
+    {
+        Frame frame;
+        frame.mBegin = begin;
+        frame.mCursor = INVALID;
+        frame.mIndex = 0;
+        frame.mLookup = mLookup.size();
+        frame.mState = FS_PENDING;
+        frame.mInOrder = inOrder;
+        mFrames.push_back(frame);
+    }
+
+    // ** Finishes the top value, 'end' is the position after the value if it is already known.
+    void Pop(SizeT end = INVALID)
+    {
+        if (mFrames.size() <= 1)
+        {
+            return;
+        }
+        const Frame frame = mFrames.back();
+        mFrames.pop_back();
+        mLookup.resize(frame.mLookup);
+        if (!frame.mInOrder)
+        {
+            return;
+        }
+
+        if (Invalid(end))
+        {
+            end = FindEnd(frame);
+        }
+        if (Invalid(end))
+        {
+            return;
+        }
+        Frame& parent = mFrames.back();
+        parent.mCursor = SkipSeparator(end);
+        if (mText[parent.mBegin] == '[')
+        {
+            ++parent.mIndex;
+        }
+    }
+
+    // ** Discards any values that were selected but never read, returns the top if it is an entered struct/array
+    Frame* GetContainer(char bracket)
+    {
+        while (mFrames.size() > 1 && mFrames.back().mState != FS_ENTERED)
+        {
+            Pop();
+        }
+        Frame& top = mFrames.back();
+        return top.mState == FS_ENTERED && mText[top.mBegin] == bracket ? &top : nullptr;
+    }
+
+    bool Enter(char bracket)
+    {
+        Frame& frame = mFrames.back();
+        if (mFrames.size() <= 1 || frame.mState != FS_PENDING)
+        {
+            return false;
+        }
+        if (mText[frame.mBegin] != bracket)
+        {
+            frame.mState = FS_REJECTED;
+            return false;
+        }
+        frame.mState = FS_ENTERED;
+        frame.mCursor = SkipWhitespace(frame.mBegin + 1);
+        frame.mIndex = 0;
+        return true;
+    }
+
+    void Exit(char bracket)
+    {
+        while (mFrames.size() > 1 && mFrames.back().mState == FS_PENDING)
+        {
+            Pop();
+        }
+        if (mFrames.size() > 1 && (mFrames.back().mState == FS_REJECTED || mText[mFrames.back().mBegin] == bracket))
+        {
+            Pop();
+        }
+    }
+
+    SizeT SkipWhitespace(SizeT pos) const
+    {
+        while (pos < mLength && (mText[pos] == ' ' || mText[pos] == '\n' || mText[pos] == '\r' || mText[pos] == '\t'))
+        {
+            ++pos;
+        }
+        return pos;
+    }
+
+    // ** Skips the separator after a value, returns the position of the next member/element or the closing bracket
+    SizeT SkipSeparator(SizeT pos) const
+    {
+        pos = SkipWhitespace(pos);
+        if (pos < mLength && mText[pos] == ',')
+        {
+            pos = SkipWhitespace(pos + 1);
+        }
+        return pos;
+    }
+
+    // ** Returns the position after the string that starts at 'pos'
+    SizeT SkipString(SizeT pos) const
+    {
+        for (++pos; pos < mLength && mText[pos] != '"'; ++pos)
+        {
+            if (mText[pos] == '\\')
+            {
+                ++pos;
+            }
+        }
+        return pos < mLength ? pos + 1 : INVALID;
+    }
+
+    // ** Returns the position after the value at 'pos'. The text was validated when it was parsed so
+    // values are skipped by matching brackets instead of parsing them.
+    SizeT SkipValue(SizeT pos) const
+    {
+        SizeT depth = 0;
+        for (; pos < mLength; ++pos)
+        {
+            const char c = mText[pos];
+            if (c == '"')
+            {
+                const SizeT end = SkipString(pos);
+                if (Invalid(end) || depth == 0)
+                {
+                    return end;
+                }
+                pos = end - 1;
+            }
+            else if (c == '{' || c == '[')
+            {
+                ++depth;
+            }
+            else if (c == '}' || c == ']')
+            {
+                if (depth == 0)
+                {
+                    return pos;
+                }
+                if (--depth == 0)
+                {
+                    return pos + 1;
+                }
+            }
+            else if (depth == 0 && (c == ',' || c == ' ' || c == '\n' || c == '\r' || c == '\t'))
+            {
+                return pos;
+            }
+        }
+        return depth == 0 ? pos : INVALID;
+    }
+
+    // ** Returns the position of the value of the member at 'pos', INVALID at the end of the struct
+    SizeT ScanMember(SizeT pos, SizeT& outKey, SizeT& outKeyLength) const
+    {
+        pos = SkipWhitespace(pos);
+        if (pos >= mLength || mText[pos] != '"')
+        {
+            return INVALID;
+        }
+        outKey = pos + 1;
+        pos = SkipString(pos);
+        if (Invalid(pos))
+        {
+            return INVALID;
+        }
+        outKeyLength = pos - 1 - outKey;
+        pos = SkipWhitespace(pos);
+        if (pos >= mLength || mText[pos] != ':')
+        {
+            return INVALID;
+        }
+        return SkipWhitespace(pos + 1);
+    }
+
+    bool KeyEquals(SizeT key, SizeT keyLength, const char* other, SizeT otherLength)
+    {
+        const char* raw = mText + key;
+        if (memchr(raw, '\\', keyLength) == nullptr)
+        {
+            return keyLength == otherLength && memcmp(raw, other, keyLength) == 0;
+        }
+
+        // ** Escaped keys are rare, decode them to compare.
+        rapidjson::StringStream stream(raw - 1);
+        JsonScalarHandler handler(mScalar, mScalarString);
+        return !mParser.Parse<rapidjson::kParseStopWhenDoneFlag>(stream, handler).IsError()
+            && mScalarString.Size() == otherLength
+            && memcmp(mScalarString.CStr(), other, otherLength) == 0;
+    }
+
+    // ** Returns the position after a value that may have been partially read
+    SizeT FindEnd(const Frame& frame)
+    {
+        if (frame.mState != FS_ENTERED)
+        {
+            return SkipValue(frame.mBegin);
+        }
+
+        const char bracket = mText[frame.mBegin] == '{' ? '}' : ']';
+        SizeT pos = frame.mCursor;
+        while (pos < mLength && mText[pos] != bracket)
+        {
+            if (bracket == '}')
+            {
+                SizeT key = 0;
+                SizeT keyLength = 0;
+                pos = ScanMember(pos, key, keyLength);
+                if (Invalid(pos))
+                {
+                    return INVALID;
+                }
+            }
+            pos = SkipValue(pos);
+            if (Invalid(pos))
+            {
+                return INVALID;
+            }
+            pos = SkipSeparator(pos);
+        }
+        return pos < mLength ? pos + 1 : INVALID;
+    }
+
+    const char*       mText;
+    SizeT             mLength;
+    rapidjson::Reader mParser;
+    TVector<Frame>    mFrames;
+    TVector<Member>   mLookup;
+    rapidjson::Value  mScalar;
+    String            mScalarString;
 };
 
 
@@ -160,6 +677,7 @@ JsonStream::JsonStream()
 : Stream()
 , mMemory()
 , mContext(nullptr)
+, mReadMode(RM_DOCUMENT)
 {
     memset(mMemory, 0, sizeof(mMemory));
 }
@@ -167,6 +685,15 @@ JsonStream::JsonStream(Stream::StreamText, String* text, StreamMode mode)
 : Stream()
 , mMemory()
 , mContext(nullptr)
+, mReadMode(RM_DOCUMENT)
+{
+    Open(Stream::TEXT, text, mode);
+}
+JsonStream::JsonStream(Stream::StreamText, String* text, StreamMode mode, ReadMode readMode)
+: Stream()
+, mMemory()
+, mContext(nullptr)
+, mReadMode(readMode)
 {
     Open(Stream::TEXT, text, mode);
 }
@@ -180,7 +707,8 @@ void JsonStream::Open(Stream::StreamText, String* text, StreamMode mode)
 {
     LF_STATIC_ASSERT(sizeof(mMemory) >= sizeof(JsonWriteStreamContext));
     LF_STATIC_ASSERT(sizeof(mMemory) >= sizeof(JsonPrettyWriteStreamContext));
-    LF_STATIC_ASSERT(sizeof(mMemory) >= sizeof(JsonReadStreamContext));
+    LF_STATIC_ASSERT(sizeof(mMemory) >= sizeof(JsonDocumentReadStreamContext));
+    LF_STATIC_ASSERT(sizeof(mMemory) >= sizeof(JsonSaxReadStreamContext));
     if (!text || (text->Empty() && mode == SM_READ))
     {
         return;
@@ -190,8 +718,13 @@ void JsonStream::Open(Stream::StreamText, String* text, StreamMode mode)
         Close();
     }
 
+    const ReadMode readMode = mReadMode == RM_AUTO
+        ? text->Size() >= STREAMING_READ_THRESHOLD ? RM_STREAMING : RM_DOCUMENT
+        : mReadMode;
     mContext = mode == SM_READ
-        ? static_cast<JsonStreamContext*>(new(mMemory)JsonReadStreamContext())
+        ? readMode == RM_STREAMING
+            ? static_cast<JsonStreamContext*>(new(mMemory)JsonSaxReadStreamContext())
+            : static_cast<JsonStreamContext*>(new(mMemory)JsonDocumentReadStreamContext())
         : mode == SM_PRETTY_WRITE
             ? static_cast<JsonStreamContext*>(new(mMemory)JsonPrettyWriteStreamContext())
             : static_cast<JsonStreamContext*>(new(mMemory)JsonWriteStreamContext());
@@ -205,7 +738,7 @@ void JsonStream::Open(Stream::StreamText, String* text, StreamMode mode)
     {
         case SM_READ:
         {
-            if (Reader()->mDocument.Parse(text->CStr()).HasParseError())
+            if (!Reader()->Parse(*text))
             {
                 Close();
                 return;
@@ -275,14 +808,10 @@ void JsonStream::Serialize(UInt32& value)
     {
         case SM_READ:
         {
-            auto iter = Reader()->Top();
-            if (iter != Reader()->End())
+            const rapidjson::Value* iter = Reader()->Read();
+            if (iter && iter->IsUint())
             {
-                if (iter->IsUint())
-                {
-                    value = iter->GetUint();
-                }
-                Reader()->Pop();
+                value = iter->GetUint();
             }
         } break;
         case SM_WRITE:
@@ -301,14 +830,10 @@ void JsonStream::Serialize(UInt64& value)
     {
         case SM_READ:
         {
-            auto iter = Reader()->Top();
-            if (iter != Reader()->End())
+            const rapidjson::Value* iter = Reader()->Read();
+            if (iter && iter->IsUint64())
             {
-                if (iter->IsUint64())
-                {
-                    value = iter->GetUint64();
-                }
-                Reader()->Pop();
+                value = iter->GetUint64();
             }
         } break;
         case SM_WRITE:
@@ -339,14 +864,10 @@ void JsonStream::Serialize(Int32& value)
     {
         case SM_READ:
         {
-            auto iter = Reader()->Top();
-            if (iter != Reader()->End())
+            const rapidjson::Value* iter = Reader()->Read();
+            if (iter && iter->IsInt())
             {
-                if (iter->IsInt())
-                {
-                    value = iter->GetInt();
-                }
-                Reader()->Pop();
+                value = iter->GetInt();
             }
         } break;
         case SM_WRITE:
@@ -365,14 +886,10 @@ void JsonStream::Serialize(Int64& value)
     {
         case SM_READ:
         {
-            auto iter = Reader()->Top();
-            if (iter != Reader()->End())
+            const rapidjson::Value* iter = Reader()->Read();
+            if (iter && iter->IsInt64())
             {
-                if (iter->IsInt64())
-                {
-                    value = iter->GetInt64();
-                }
-                Reader()->Pop();
+                value = iter->GetInt64();
             }
         } break;
         case SM_WRITE:
@@ -391,14 +908,10 @@ void JsonStream::Serialize(Float32& value)
     {
         case SM_READ:
         {
-            auto iter = Reader()->Top();
-            if (iter != Reader()->End())
+            const rapidjson::Value* iter = Reader()->Read();
+            if (iter && iter->IsFloat())
             {
-                if (iter->IsFloat())
-                {
-                    value = iter->GetFloat();
-                }
-                Reader()->Pop();
+                value = iter->GetFloat();
             }
         } break;
         case SM_WRITE:
@@ -417,14 +930,10 @@ void JsonStream::Serialize(Float64& value)
     {
         case SM_READ:
         {
-            auto iter = Reader()->Top();
-            if (iter != Reader()->End())
+            const rapidjson::Value* iter = Reader()->Read();
+            if (iter && iter->IsDouble())
             {
-                if (iter->IsDouble())
-                {
-                    value = iter->GetDouble();
-                }
-                Reader()->Pop();
+                value = iter->GetDouble();
             }
         } break;
         case SM_WRITE:
@@ -499,11 +1008,10 @@ void JsonStream::Serialize(String& value)
     {
         case SM_READ:
         {
-            auto iter = Reader()->Top();
-            if (iter != Reader()->End())
+            const rapidjson::Value* iter = Reader()->Read();
+            if (iter && iter->IsString())
             {
-                value = iter->GetString();
-                Reader()->Pop();
+                value = String(static_cast<SizeT>(iter->GetStringLength()), iter->GetString());
             }
         } break;
         case SM_WRITE:
@@ -596,12 +1104,7 @@ void JsonStream::Serialize(const ArrayPropertyInfo& info)
     {
         case SM_READ:
         {
-            auto iter = Reader()->mTop.empty() ? Reader()->End() : Reader()->mTop.back();
-            if (iter != Reader()->End() && iter->IsArray())
-            {
-                Reader()->mTop.push_back(&iter->GetArray()[static_cast<rapidjson::SizeType>(info.index)]);
-                Reader()->mValueReady = true;
-            }
+            Reader()->SelectIndex(info.index);
         } break;
         case SM_WRITE:
         {
@@ -648,8 +1151,7 @@ bool JsonStream::BeginStruct()
     {
         case SM_READ:
         {
-            bool isObject = Reader()->Top() != Reader()->End() ? Reader()->Top()->IsObject() : false;
-            return isObject;
+            return Reader()->BeginStruct();
         } break;
         case SM_WRITE:
         {
@@ -668,7 +1170,7 @@ void JsonStream::EndStruct()
     {
         case SM_READ:
         {
-            Reader()->Pop();
+            Reader()->EndStruct();
         } break;
         case SM_WRITE:
         {
@@ -687,8 +1189,7 @@ bool JsonStream::BeginArray()
     {
         case SM_READ:
         {
-            bool isArray = Reader()->Top() != Reader()->End() ? Reader()->Top()->IsArray() : false;
-            return isArray;
+            return Reader()->BeginArray();
         } break;
         case SM_WRITE:
         {
@@ -707,7 +1208,7 @@ void JsonStream::EndArray()
     {
         case SM_READ:
         {
-            Reader()->Pop();
+            Reader()->EndArray();
         } break;
         case SM_WRITE:
         {
@@ -723,12 +1224,7 @@ size_t JsonStream::GetArraySize() const
 {
     if (GetMode() == SM_READ)
     {
-        auto iter = const_cast<JsonStream*>(this)->Reader()->Top();
-        if (iter != const_cast<JsonStream*>(this)->Reader()->End() && iter->IsArray())
-        {
-            SizeT size = iter->GetArray().Size();
-            return size;
-        }
+        return const_cast<JsonStream*>(this)->Reader()->GetArraySize();
     }
     return 0;
 }
@@ -777,6 +1273,11 @@ JsonObjectStream::JsonObjectStream(Stream::StreamText, String* text, StreamMode
 , mSerializingObject(false)
 , mCurrentSuper()
 {}
+JsonObjectStream::JsonObjectStream(Stream::StreamText, String* text, StreamMode mode, ReadMode readMode)
+: JsonStream(Stream::TEXT, text, mode, readMode)
+, mSerializingObject(false)
+, mCurrentSuper()
+{}
 
 bool JsonObjectStream::BeginObject(const String& name, const String& super)
 {
@@ -31,8 +31,24 @@ class JsonReadStreamContext;
 class LF_CORE_API JsonStream : public Stream
 {
 public:
+    enum ReadMode
+    {
+        // ** Parses the text into a document, members can be read in any order.
+        RM_DOCUMENT,
+        // ** Reads the text with a SAX reader without building a document. Members
+        // are fastest to read in the order they were written, the text must not
+        // change until the stream is closed.
+        RM_STREAMING,
+        // ** Uses RM_STREAMING for text of at least STREAMING_READ_THRESHOLD bytes
+        // and RM_DOCUMENT otherwise. Streaming validates the text before reading
+        // it so it is slower on small text, where the document is cheap anyway.
+        RM_AUTO
+    };
+    static const SizeT STREAMING_READ_THRESHOLD = 64 * 1024;
+
     JsonStream();
     JsonStream(Stream::StreamText, String* text, StreamMode mode);
+    JsonStream(Stream::StreamText, String* text, StreamMode mode, ReadMode readMode);
     ~JsonStream() override;
 
 
@@ -40,6 +56,10 @@ public:
     void Close() override;
     void Clear() override;
 
+    // ** Sets how the text is read the next time the stream is opened with SM_READ
+    void SetReadMode(ReadMode value) { mReadMode = value; }
+    ReadMode GetReadMode() const { return mReadMode; }
+
     // Normal Value Serialization
     void Serialize(UInt8& value) override;
     void Serialize(UInt16& value) override;
@@ -87,8 +107,9 @@ private:
 
 
 
-    ByteT      mMemory[200];
+    ByteT      mMemory[320];
     JsonStreamContext* mContext;
+    ReadMode   mReadMode;
 };
 
 /// JsonObjectStream is similar to Json stream
@@ -105,6 +126,7 @@ class LF_CORE_API JsonObjectStream : public JsonStream
 public:
     JsonObjectStream();
     JsonObjectStream(Stream::StreamText, String* text, StreamMode mode);
+    JsonObjectStream(Stream::StreamText, String* text, StreamMode mode, ReadMode readMode);
 
     bool BeginObject(const String& name, const String& super) override;
     void EndObject();
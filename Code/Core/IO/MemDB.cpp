@@ -21,12 +21,16 @@
 #include "Core/PCH.h"
 #include "MemDB.h"
 #include "Core/IO/JsonStream.h"
+#include "Core/IO/MemDBIndex.h"
 #include "Core/Platform/Atomic.h"
 #include "Core/Platform/File.h"
 #include "Core/Platform/FileSystem.h"
 #include "Core/Platform/MappedFile.h"
+#include "Core/Platform/Thread.h"
 #include "Core/Utility/Crc32.h"
+#include "Core/Utility/FNVHash.h"
 #include "Core/Utility/Log.h"
+#include "Core/Utility/Utility.h"
 #include <algorithm>
 
 
@@ -38,24 +42,26 @@ DECLARE_PTR(File);
 namespace MemDBTypes
 {
 
-struct EntryIndex
-{
-    bool operator==(const EntryIndex& other) const
-    {
-        return mValue == other.mValue;
-    }
+// ** Number of op counter stripes, threads are assigned a stripe so counting an op doesn't contend on one cache line.
+static const SizeT OP_COUNTER_STRIPES = 8;
 
-    bool operator<(const EntryIndex& other) const
-    {
-        return mValue < other.mValue;
-    }
-    bool operator>(const EntryIndex& other) const
+struct LF_ALIGN(64) TableOpCounter
+{
+    TableOpCounter()
     {
-        return mValue > other.mValue;
+        for (SizeT i = 0; i < OpTypes::MAX_VALUE; ++i)
+        {
+            mValues[i] = 0;
+        }
     }
+    volatile Atomic64 mValues[OpTypes::MAX_VALUE];
+};
 
-    NumericalVariant mValue;
-    EntryID          mID;
+// ** Number of optimistic readers in flight on a stripe, padded so readers on different stripes don't share a line.
+struct LF_ALIGN(64) TableReaderCounter
+{
+    TableReaderCounter() : mValue(0) {}
+    volatile Atomic32 mValue;
 };
 
 struct TableIndex
@@ -66,10 +72,8 @@ struct TableIndex
     SizeT                           mOffset;
     // ** How to interpret the data.
     NumericalVariant::VariantType   mDataType;
-    // ** 
-    TVector<EntryIndex>              mCollection;
-    // ** 
-    bool                            mSorted;
+    // ** Ordered (value, id) records
+    MemDBIndexTree                  mTree;
 
     bool                            mAllowDuplicates;
 };
@@ -77,23 +81,35 @@ struct TableIndex
 struct Table
 {
     Table()
-    : mName()
+    : mLock()
+    , mSequence(0)
+    , mName()
+    , mNameHash(0)
     , mEntrySize(0)
     , mEntryAlignment(0)
     , mEntryCapacity(0)
     , mBase(nullptr)
     , mEnd(nullptr)
     , mIndices()
+    , mHashIndices()
     , mScratchEntry(nullptr)
     , mNextFree(0)
     , mFreeList()
-    , mOpCounts{ 0 }
+    , mRetired()
+    , mReaders()
+    , mOpCounts()
     , mCount(0)
     , mPendingWrites(0)
     , mResizeCount(0)
     {}
+    // ** Guards the entries, indices and bookkeeping of the table.
+    mutable RWSpinLock mLock;
+    // ** Sequence for optimistic readers, odd while a writer is modifying the table.
+    volatile Atomic32 mSequence;
     // ** The name of the table
     String mName;
+    // ** Hash of the name, identifies the table in journal records
+    UInt64 mNameHash;
     // ** The size of each entry in the table (including the base Entry type)
     SizeT  mEntrySize;
     // ** 
@@ -106,6 +122,8 @@ struct Table
     ByteT* mEnd;
 
     TVector<TableIndex> mIndices;
+    // ** Hash indices, referenced by HashIndexID
+    TVector<MemDBHashIndex> mHashIndices;
     // ** Pointer to memory used for storing a 'prev' for delta checks
     ByteT* mScratchEntry;
 
@@ -115,8 +133,13 @@ struct Table
     TVector<EntryID> mFreeList;
     // ** [OPTIMIZATION], keep track of dirty entries to flush
     TVector<EntryID> mDirtyEntries;
+    // ** Entry buffers replaced while optimistic readers may still be copying from them, freed by the next
+    //    writer that observes no optimistic readers.
+    TVector<ByteT*> mRetired;
+    // ** Optimistic readers currently reading the table (striped like the op counters)
+    mutable TableReaderCounter mReaders[OP_COUNTER_STRIPES];
 
-    mutable volatile Atomic64 mOpCounts[MemDBTypes::OpTypes::MAX_VALUE];
+    mutable TableOpCounter mOpCounts[OP_COUNTER_STRIPES];
 
     // ** The number of elements added to this table
     SizeT mCount;
@@ -153,11 +176,98 @@ static void UnsetFlag(MemDBTypes::Entry& entry, MemDBTypes::EntryFlag flag)
     entry.mReservedFlags = entry.mReservedFlags & (~flag);
 }
 
+// ** Entries up to this size/alignment are read optimistically (copied without taking the table lock)
+static const SizeT OPTIMISTIC_READ_MAX_SIZE = 256;
+static const SizeT OPTIMISTIC_READ_MAX_ALIGNMENT = 16;
+static const SizeT OPTIMISTIC_READ_ATTEMPTS = 8;
+
+static volatile Atomic32 gOpCounterStripeNext = 0;
+LF_THREAD_LOCAL SizeT gOpCounterStripe = INVALID;
+
+static SizeT OpCounterStripe()
+{
+    if (Invalid(gOpCounterStripe))
+    {
+        gOpCounterStripe = static_cast<SizeT>(AtomicIncrement32(&gOpCounterStripeNext)) % MemDBTypes::OP_COUNTER_STRIPES;
+    }
+    return gOpCounterStripe;
+}
+
 static void TableOp(const MemDBTypes::Table& table, MemDBTypes::OpTypes::Value type)
 {
-    AtomicIncrement64(&table.mOpCounts[type]);
+    AtomicIncrement64(&table.mOpCounts[OpCounterStripe()].mValues[type]);
+}
+
+static Atomic64 TableOpCount(const MemDBTypes::Table& table, SizeT type)
+{
+    Atomic64 count = 0;
+    for (SizeT i = 0; i < MemDBTypes::OP_COUNTER_STRIPES; ++i)
+    {
+        count += AtomicLoad(&table.mOpCounts[i].mValues[type]);
+    }
+    return count;
+}
+
+// ** Marks an optimistic reader for the lifetime of the scope, retired buffers are not freed while any are active.
+struct ScopeTableOptimisticRead
+{
+    ScopeTableOptimisticRead(const MemDBTypes::Table& table) : mCounter(table.mReaders[OpCounterStripe()])
+    {
+        AtomicIncrement32(&mCounter.mValue);
+    }
+    ~ScopeTableOptimisticRead()
+    {
+        AtomicDecrement32(&mCounter.mValue);
+    }
+private:
+    ScopeTableOptimisticRead(const ScopeTableOptimisticRead&) = delete;
+    ScopeTableOptimisticRead& operator=(const ScopeTableOptimisticRead&) = delete;
+    MemDBTypes::TableReaderCounter& mCounter;
+};
+
+static void TableFreeRetired(MemDBTypes::Table& table);
+
+// ** Frees the retired buffers if no optimistic reader can still hold one. Must be called by the writer while the
+// sequence is odd: A reader registers before it loads the sequence, so either we see the reader here or the reader
+// sees the odd sequence and retries (and only ever loads the new buffer afterwards).
+static void TableReclaimRetired(MemDBTypes::Table& table)
+{
+    if (table.mRetired.empty())
+    {
+        return;
+    }
+    AtomicRWBarrier();
+    for (SizeT i = 0; i < MemDBTypes::OP_COUNTER_STRIPES; ++i)
+    {
+        if (AtomicLoad(&table.mReaders[i].mValue) != 0)
+        {
+            return; // Try again on the next write.
+        }
+    }
+    TableFreeRetired(table);
 }
 
+// ** Acquires the table for writing, the sequence is odd for the lifetime of the scope so optimistic readers
+// retry instead of using a torn copy.
+struct ScopeTableWrite
+{
+    ScopeTableWrite(MemDBTypes::Table& table) : mTable(table)
+    {
+        mTable.mLock.AcquireWrite();
+        AtomicIncrement32(&mTable.mSequence);
+    }
+    ~ScopeTableWrite()
+    {
+        TableReclaimRetired(mTable);
+        AtomicIncrement32(&mTable.mSequence);
+        mTable.mLock.ReleaseWrite();
+    }
+private:
+    ScopeTableWrite(const ScopeTableWrite&) = delete;
+    ScopeTableWrite& operator=(const ScopeTableWrite&) = delete;
+    MemDBTypes::Table& mTable;
+};
+
 static SizeT TableByteCapacity(MemDBTypes::Table& table)
 {
     return table.mEntryCapacity * table.mEntrySize;
@@ -187,14 +297,29 @@ static void TableAlloc(MemDBTypes::Table& table)
     }
 }
 
-static void TableRelease(MemDBTypes::Table& table)
+// ** Detach the entry buffer, optimistic readers may still be copying from it so it's kept until they're done.
+static void TableRetire(MemDBTypes::Table& table)
 {
     if (table.mBase != nullptr)
     {
-        LFFree(table.mBase);
+        table.mRetired.push_back(table.mBase);
         table.mBase = nullptr;
         table.mEnd = nullptr;
     }
+}
+
+static void TableFreeRetired(MemDBTypes::Table& table)
+{
+    for (ByteT* base : table.mRetired)
+    {
+        LFFree(base);
+    }
+    table.mRetired.clear();
+}
+
+static void TableRelease(MemDBTypes::Table& table)
+{
+    TableRetire(table);
 
     if (table.mScratchEntry != nullptr)
     {
@@ -203,12 +328,30 @@ static void TableRelease(MemDBTypes::Table& table)
     }
 }
 
-static void TableAllocCopy(MemDBTypes::Table& oldTable, MemDBTypes::Table& newTable)
-{
-    Assert(oldTable.mEntrySize == newTable.mEntrySize || oldTable.mEntryAlignment == newTable.mEntryAlignment)
-    TableAlloc(newTable);
-    SizeT capacity = TableByteCapacity(oldTable);
-    memcpy(newTable.mBase, oldTable.mBase, capacity);
+// ** Reset the table to the default 'unused' state, the lock, sequence and retired buffers are preserved.
+static void TableReset(MemDBTypes::Table& table)
+{
+    table.mName.Clear();
+    table.mNameHash = 0;
+    table.mEntrySize = 0;
+    table.mEntryAlignment = 0;
+    table.mEntryCapacity = 0;
+    table.mIndices.clear();
+    table.mHashIndices.clear();
+    table.mNextFree = 0;
+    table.mFreeList.clear();
+    table.mDirtyEntries.clear();
+    for (MemDBTypes::TableOpCounter& counter : table.mOpCounts)
+    {
+        for (SizeT i = 0; i < MemDBTypes::OpTypes::MAX_VALUE; ++i)
+        {
+            AtomicStore(&counter.mValues[i], 0);
+        }
+    }
+    table.mCount = 0;
+    table.mPendingWrites = 0;
+    table.mFileHandle.Release();
+    table.mResizeCount = 0;
 }
 
 static bool TableGetEntry(MemDBTypes::Table& table, MemDBTypes::EntryID id, MemDBTypes::Entry& outEntry)
@@ -223,29 +366,6 @@ static bool TableGetEntry(MemDBTypes::Table& table, MemDBTypes::EntryID id, MemD
     return true;
 }
 
-// ** Use this before attempting to read from table (to ensure its sorted)
-static void TableIndexReadBarrier(MemDBTypes::TableIndex& index)
-{
-    if (!index.mSorted)
-    {
-        std::sort(index.mCollection.begin(), index.mCollection.end());
-        index.mSorted = true;
-    }
-}
-// ** Use this after writing to barrier to ensure the sorted flags are set properly.
-static void TableIndexWriteBarrier(MemDBTypes::TableIndex& index, bool doSort)
-{
-    if (doSort)
-    {
-        std::sort(index.mCollection.begin(), index.mCollection.end());
-        index.mSorted = true;
-    }
-    else
-    {
-        index.mSorted = false;
-    }
-}
-
 // ** Check the table to see if an entry can be inserted or if it will break the 'unique' rules required for
 // an index.
 static bool TableCheckIndex(MemDBTypes::Table& table, const ByteT* entryBytes)
@@ -264,14 +384,14 @@ static bool TableCheckIndex(MemDBTypes::Table& table, const ByteT* entryBytes)
         }
         const ByteT* member = entryBytes + index.mOffset;
         NumericalVariant value = NumericalVariant::Cast(index.mDataType, member);
-
-        MemDBTypes::EntryIndex searchKey;
-        searchKey.mValue = value;
-        TableIndexReadBarrier(index);
-
-        auto it = std::lower_bound(index.mCollection.begin(), index.mCollection.end(), searchKey);
-        auto result = (it != index.mCollection.end() && it->mValue == value) ? it : index.mCollection.end();
-        if (result != index.mCollection.end())
+        if (index.mTree.Contains(value))
+        {
+            return false;
+        }
+    }
+    for (const MemDBHashIndex& index : table.mHashIndices)
+    {
+        if (!index.AllowDuplicates() && Valid(index.FindOne(table.mBase, table.mEntrySize, entryBytes)))
         {
             return false;
         }
@@ -279,83 +399,132 @@ static bool TableCheckIndex(MemDBTypes::Table& table, const ByteT* entryBytes)
     return true;
 }
 
-static void TableInsertIndex(MemDBTypes::Table& table, MemDBTypes::EntryID id, const ByteT* entryBytes, bool doSort = true)
+static MemDBTypes::EntryIndex TableMakeIndex(const MemDBTypes::TableIndex& index, MemDBTypes::EntryID id, const ByteT* entryBytes)
+{
+    MemDBTypes::EntryIndex indexValue;
+    indexValue.mValue = NumericalVariant::Cast(index.mDataType, entryBytes + index.mOffset);
+    indexValue.mID = id;
+    return indexValue;
+}
+
+static void TableInsertIndex(MemDBTypes::Table& table, MemDBTypes::EntryID id, const ByteT* entryBytes)
 {
     for (MemDBTypes::TableIndex& index : table.mIndices)
     {
-        const ByteT* member = entryBytes + index.mOffset;
-        NumericalVariant value = NumericalVariant::Cast(index.mDataType, member);
-
-        MemDBTypes::EntryIndex indexValue;
-        indexValue.mValue = value;
-        indexValue.mID = id;
-
-        index.mCollection.push_back(indexValue);
-        TableIndexWriteBarrier(index, doSort);
+        index.mTree.Insert(TableMakeIndex(index, id, entryBytes));
+    }
+    for (MemDBHashIndex& index : table.mHashIndices)
+    {
+        index.Insert(id, entryBytes);
     }
 }
 
-static void TableUpdateIndex(MemDBTypes::Table& table, MemDBTypes::EntryID id, const ByteT* beforeBytes, const ByteT* entryBytes, bool doSort = true)
+// ** Insert many entries at once, when the entries are a significant portion of the index it's
+// rebuilt bottom-up instead of inserting one at a time.
+static void TableBulkInsertIndex(MemDBTypes::Table& table, const TVector<MemDBTypes::EntryID>& ids, const ByteT* entryBytes)
 {
     for (MemDBTypes::TableIndex& index : table.mIndices)
     {
-        const ByteT* member = entryBytes + index.mOffset;
-        const ByteT* beforePtr = beforeBytes + index.mOffset;
-        NumericalVariant value = NumericalVariant::Cast(index.mDataType, member);
-        NumericalVariant before = NumericalVariant::Cast(index.mDataType, beforePtr);
-
-        TableIndexReadBarrier(index);
-
-        MemDBTypes::EntryIndex searchKey;
-        searchKey.mValue = before;
-
-        auto it = std::lower_bound(index.mCollection.begin(), index.mCollection.end(), searchKey);
-        auto result = (it != index.mCollection.end() && it->mValue == value) ? it : index.mCollection.end();
-        if (result != index.mCollection.end())
+        if (ids.size() < index.mTree.Size())
         {
-            if (result->mValue != value)
+            for (SizeT i = 0; i < ids.size(); ++i)
             {
-                index.mCollection.swap_erase(result);
-                TableIndexWriteBarrier(index, doSort);
+                index.mTree.Insert(TableMakeIndex(index, ids[i], entryBytes + (table.mEntrySize * i)));
             }
+            continue;
         }
-        else
+
+        TVector<MemDBTypes::EntryIndex> keys;
+        keys.reserve(index.mTree.Size() + ids.size());
+        index.mTree.CopyTo(keys);
+        for (SizeT i = 0; i < ids.size(); ++i)
         {
-            it = std::find_if(
-                index.mCollection.begin(),
-                index.mCollection.end(),
-                [id](const MemDBTypes::EntryIndex& entryIndex)
-                {
-                    return entryIndex.mID == id;
-                });
+            keys.push_back(TableMakeIndex(index, ids[i], entryBytes + (table.mEntrySize * i)));
+        }
+        index.mTree.BulkLoad(keys);
+    }
+    for (MemDBHashIndex& index : table.mHashIndices)
+    {
+        index.Reserve(index.Size() + ids.size());
+        for (SizeT i = 0; i < ids.size(); ++i)
+        {
+            index.Insert(ids[i], entryBytes + (table.mEntrySize * i));
+        }
+    }
+}
 
-            if (it != index.mCollection.end() && it->mValue != value)
-            {
-                index.mCollection.swap_erase(it);
-                TableIndexWriteBarrier(index, doSort);
-            }
+static void TableUpdateIndex(MemDBTypes::Table& table, MemDBTypes::EntryID id, const ByteT* beforeBytes, const ByteT* entryBytes)
+{
+    for (MemDBTypes::TableIndex& index : table.mIndices)
+    {
+        MemDBTypes::EntryIndex value = TableMakeIndex(index, id, entryBytes);
+        MemDBTypes::EntryIndex before = TableMakeIndex(index, id, beforeBytes);
+        if (value.mValue != before.mValue)
+        {
+            index.mTree.Remove(before);
+            index.mTree.Insert(value);
+        }
+    }
+    for (MemDBHashIndex& index : table.mHashIndices)
+    {
+        if (!index.KeyEquals(beforeBytes, entryBytes))
+        {
+            index.Remove(id, beforeBytes);
+            index.Insert(id, entryBytes);
         }
     }
 }
 
-static void TableRemoveIndex(MemDBTypes::Table& table, MemDBTypes::EntryID id, bool doSort = true)
+static void TableRemoveIndex(MemDBTypes::Table& table, MemDBTypes::EntryID id, const ByteT* entryBytes)
 {
     for (MemDBTypes::TableIndex& index : table.mIndices)
     {
-        auto it = std::find_if(
-                        index.mCollection.begin(), 
-                        index.mCollection.end(), 
-                        [id](const MemDBTypes::EntryIndex& entryIndex) 
-                        { 
-                            return entryIndex.mID == id; 
-                        });
+        index.mTree.Remove(TableMakeIndex(index, id, entryBytes));
+    }
+    for (MemDBHashIndex& index : table.mHashIndices)
+    {
+        index.Remove(id, entryBytes);
+    }
+}
+
+// ** Rebuild the hash index from the used entries of the table.
+static void TableBuildHashIndex(MemDBTypes::Table& table, MemDBHashIndex& index)
+{
+    index.Clear();
+    index.Reserve(table.mCount);
+    const ByteT* ptr = table.mBase;
+    for (SizeT i = 0; i < table.mEntryCapacity; ++i)
+    {
+        if (EntryUsed(*reinterpret_cast<const MemDBTypes::Entry*>(ptr)))
+        {
+            index.Insert(static_cast<MemDBTypes::EntryID>(i), ptr);
+        }
+        ptr += table.mEntrySize;
+    }
+}
 
-        if (it != index.mCollection.end())
+// ** @returns Returns false if the index doesn't allow duplicates and has duplicate values.
+static bool TableIndexUnique(const MemDBTypes::TableIndex& index)
+{
+    if (index.mAllowDuplicates)
+    {
+        return true;
+    }
+    MemDBIndexTree::Iterator it = index.mTree.Begin();
+    if (!it.Valid())
+    {
+        return true;
+    }
+    NumericalVariant last = it->mValue;
+    for (++it; it.Valid(); ++it)
+    {
+        if (it->mValue == last)
         {
-            index.mCollection.swap_erase(it);
-            TableIndexWriteBarrier(index, doSort);
+            return false;
         }
+        last = it->mValue;
     }
+    return true;
 }
 
 // ** Ensure file handles are open
@@ -401,18 +570,151 @@ static bool TableCloseFiles(MemDBTypes::Table& table)
     return true;
 }
 
-static void TableSave(MemDBTypes::Table& table, MemDB::SaveMode mode)
+// ** Double the capacity of the table, the old buffer is retired.
+static void TableGrow(MemDBTypes::Table& table)
+{
+    SizeT oldByteCapacity = TableByteCapacity(table);
+    ByteT* oldBase = table.mBase;
+
+    // note: The table is grown in place rather than copied, the indices are not copyable.
+    table.mEntryCapacity = Max<SizeT>(table.mEntryCapacity * 2, 1);
+    table.mBase = nullptr;
+    table.mEnd = nullptr;
+    TableAlloc(table);
+    if (oldBase)
+    {
+        memcpy(table.mBase, oldBase, oldByteCapacity);
+        // Optimistic readers may still be reading the old buffer.
+        table.mRetired.push_back(oldBase);
+    }
+    ++table.mResizeCount;
+}
+
+// ** Ensure the table files have reached the disk, returns false if any flush failed.
+static bool TableFlushFiles(MemDBTypes::Table& table)
+{
+    bool result = true;
+    if (table.mFileHandle && !table.mFileHandle->Flush())
+    {
+        result = false;
+    }
+    for (MemDBTypes::TableIndex& index : table.mIndices)
+    {
+        if (index.mFileHandle && !index.mFileHandle->Flush())
+        {
+            result = false;
+        }
+    }
+    return result;
+}
+
+// ** Rebuild the bookkeeping and indices of the table from the entries.
+static void TableRebuild(MemDBTypes::Table& table)
+{
+    table.mCount = 0;
+    table.mNextFree = 0;
+    table.mFreeList.clear();
+    const ByteT* ptr = table.mBase;
+    for (SizeT i = 0; i < table.mEntryCapacity; ++i)
+    {
+        if (EntryUsed(*reinterpret_cast<const MemDBTypes::Entry*>(ptr)))
+        {
+            ++table.mCount;
+        }
+        ptr += table.mEntrySize;
+    }
+
+    TVector<MemDBTypes::EntryIndex> keys;
+    keys.reserve(table.mCount);
+    for (MemDBTypes::TableIndex& index : table.mIndices)
+    {
+        keys.resize(0);
+        ptr = table.mBase;
+        for (SizeT i = 0; i < table.mEntryCapacity; ++i)
+        {
+            if (EntryUsed(*reinterpret_cast<const MemDBTypes::Entry*>(ptr)))
+            {
+                keys.push_back(TableMakeIndex(index, static_cast<MemDBTypes::EntryID>(i), ptr));
+            }
+            ptr += table.mEntrySize;
+        }
+        index.mTree.BulkLoad(keys);
+    }
+
+    for (MemDBHashIndex& index : table.mHashIndices)
+    {
+        TableBuildHashIndex(table, index);
+    }
+}
+
+// ** Apply a journal record, the record holds the full entry image so applying a record twice is harmless.
+static bool TableApplyRecord(MemDBTypes::Table& table, const MemDBJournal::Record& record)
+{
+    if (record.mType != MemDBJournal::RECORD_DELETE && record.mSize != table.mEntrySize)
+    {
+        return false;
+    }
+
+    while (record.mEntryID >= table.mEntryCapacity)
+    {
+        if (TableByteCapacity(table) >= ToGB<SizeT>(1))
+        {
+            return false;
+        }
+        TableGrow(table);
+    }
+
+    ByteT* ptr = table.mBase + (table.mEntrySize * record.mEntryID);
+    MemDBTypes::Entry* entry = reinterpret_cast<MemDBTypes::Entry*>(ptr);
+    if (!EntryDirty(*entry))
+    {
+        ++table.mPendingWrites;
+        table.mDirtyEntries.push_back(record.mEntryID);
+    }
+
+    if (record.mType == MemDBJournal::RECORD_DELETE)
+    {
+        memset(ptr, 0, table.mEntrySize);
+        entry->mReservedFlags = MemDBTypes::EF_DIRTY;
+    }
+    else
+    {
+        memcpy(ptr, record.mBytes, table.mEntrySize);
+        entry->mReservedFlags = MemDBTypes::EF_USED | MemDBTypes::EF_DIRTY;
+    }
+    entry->mReservedID = record.mEntryID;
+    return true;
+}
+
+// ** Write a dirty entry to the table file, the entry stays dirty if the write fails.
+static bool TableSaveEntry(MemDBTypes::Table& table, ByteT* ptr)
+{
+    MemDBTypes::Entry* entry = reinterpret_cast<MemDBTypes::Entry*>(ptr);
+    UnsetFlag(*entry, MemDBTypes::EF_DIRTY);
+    table.mFileHandle->SetCursor(static_cast<FileCursor>(ptr - table.mBase), FILE_CURSOR_BEGIN);
+    if (table.mFileHandle->Write(ptr, table.mEntrySize) != table.mEntrySize)
+    {
+        SetFlag(*entry, MemDBTypes::EF_DIRTY);
+        return false;
+    }
+    return true;
+}
+
+// ** Write the table to its files, returns false if any write failed. Entries that failed to write
+//    are kept in the dirty list so the next save retries them.
+static bool TableSave(MemDBTypes::Table& table, MemDB::SaveMode mode)
 {
     if (!table.mFileHandle)
     {
-        return;
+        return true;
     }
 
     if (!table.mBase)
     {
-        return;
+        return true;
     }
 
+    bool result = true;
     if (mode == MemDB::SAVE_FULL)
     {
         ByteT* ptr = table.mBase;
@@ -423,20 +725,26 @@ static void TableSave(MemDBTypes::Table& table, MemDB::SaveMode mode)
             ptr += table.mEntrySize;
         }
 
+        const SizeT numBytes = static_cast<SizeT>(table.mEnd - table.mBase);
         table.mFileHandle->SetCursor(0, FILE_CURSOR_BEGIN);
-        table.mFileHandle->Write(table.mBase, table.mEnd - table.mBase);
+        if (table.mFileHandle->Write(table.mBase, numBytes) != numBytes)
+        {
+            // Every dirty entry is still in the dirty list.
+            for (MemDBTypes::EntryID id : table.mDirtyEntries)
+            {
+                SetFlag(*reinterpret_cast<MemDBTypes::Entry*>(table.mBase + (id * table.mEntrySize)), MemDBTypes::EF_DIRTY);
+            }
+            result = false;
+        }
     }
     else if (mode == MemDB::SAVE_DIRTY)
     {
         ByteT* ptr = table.mBase;
         for (SizeT i = 0; i < table.mEntryCapacity; ++i)
         {
-            MemDBTypes::Entry* entry = reinterpret_cast<MemDBTypes::Entry*>(ptr);
-            if (EntryDirty(*entry))
+            if (EntryDirty(*reinterpret_cast<MemDBTypes::Entry*>(ptr)) && !TableSaveEntry(table, ptr))
             {
-                UnsetFlag(*entry, MemDBTypes::EF_DIRTY);
-                table.mFileHandle->SetCursor(static_cast<FileCursor>(ptr - table.mBase), FILE_CURSOR_BEGIN);
-                table.mFileHandle->Write(ptr, table.mEntrySize);
+                result = false;
             }
             ptr += table.mEntrySize;
         }
@@ -445,25 +753,47 @@ static void TableSave(MemDBTypes::Table& table, MemDB::SaveMode mode)
     {
         for (MemDBTypes::EntryID id : table.mDirtyEntries)
         {
-            ByteT* ptr = table.mBase + (id * table.mEntrySize);
-            MemDBTypes::Entry* entry = reinterpret_cast<MemDBTypes::Entry*>(ptr);
-            UnsetFlag(*entry, MemDBTypes::EF_DIRTY);
-            table.mFileHandle->SetCursor(static_cast<FileCursor>(ptr - table.mBase), FILE_CURSOR_BEGIN);
-            table.mFileHandle->Write(ptr, table.mEntrySize);
+            if (!TableSaveEntry(table, table.mBase + (id * table.mEntrySize)))
+            {
+                result = false;
+            }
         }
     }
 
+    TVector<MemDBTypes::EntryIndex> keys;
     for (MemDBTypes::TableIndex& index : table.mIndices)
     {
-        if (index.mFileHandle && !index.mCollection.data())
+        if (index.mFileHandle && !index.mTree.Empty())
         {
+            keys.resize(0);
+            index.mTree.CopyTo(keys);
+            const SizeT numBytes = keys.size() * sizeof(MemDBTypes::EntryIndex);
             index.mFileHandle->SetCursor(0, FILE_CURSOR_BEGIN);
-            index.mFileHandle->Write(index.mCollection.data(), index.mCollection.size() * sizeof(MemDBTypes::EntryIndex));
+            if (index.mFileHandle->Write(keys.data(), numBytes) != numBytes)
+            {
+                result = false;
+            }
         }
     }
 
-    table.mDirtyEntries.resize(0);
-    table.mPendingWrites = 0;
+    if (result)
+    {
+        table.mDirtyEntries.resize(0);
+    }
+    else
+    {
+        SizeT numDirty = 0;
+        for (MemDBTypes::EntryID id : table.mDirtyEntries)
+        {
+            if (EntryDirty(*reinterpret_cast<const MemDBTypes::Entry*>(table.mBase + (id * table.mEntrySize))))
+            {
+                table.mDirtyEntries[numDirty++] = id;
+            }
+        }
+        table.mDirtyEntries.resize(numDirty);
+    }
+    table.mPendingWrites = table.mDirtyEntries.size();
+    return result;
 }
 
 static void TableLoad(MemDBTypes::Table& table)
@@ -483,11 +813,7 @@ static void TableLoad(MemDBTypes::Table& table)
     // Allocate space.
     if (capacity != table.mEntryCapacity)
     {
-        if (table.mBase)
-        {
-            LFFree(table.mBase);
-            table.mBase = nullptr;
-        }
+        TableRetire(table);
 
         table.mBase = static_cast<ByteT*>(LFAlloc(capacity * table.mEntrySize, table.mEntryAlignment));
         table.mEnd = table.mBase + (capacity * table.mEntrySize);
@@ -515,14 +841,20 @@ static void TableLoad(MemDBTypes::Table& table)
         fileSize = static_cast<SizeT>(index.mFileHandle->GetSize());
         capacity = fileSize / sizeof(MemDBTypes::EntryIndex);
         Assert(fileSize == capacity * sizeof(MemDBTypes::EntryIndex));
+        TVector<MemDBTypes::EntryIndex> keys;
         if (capacity > 0)
         {
-            index.mCollection.resize(capacity);
+            keys.resize(capacity);
             index.mFileHandle->SetCursor(0, FILE_CURSOR_BEGIN);
-            index.mFileHandle->Read(index.mCollection.data(), capacity * sizeof(MemDBTypes::EntryIndex));
+            index.mFileHandle->Read(keys.data(), capacity * sizeof(MemDBTypes::EntryIndex));
         }
+        index.mTree.BulkLoad(keys);
+    }
 
-        index.mSorted = false;
+    // Hash indices are not saved, they're rebuilt from the table.
+    for (MemDBHashIndex& index : table.mHashIndices)
+    {
+        TableBuildHashIndex(table, index);
     }
 }
 
@@ -543,11 +875,7 @@ bool TableReadFullBinary(File& file, MemDBTypes::Table& table)
 
     if (size != currentSize)
     {
-        if (table.mBase)
-        {
-            LFFree(table.mBase);
-            table.mBase = table.mEnd = nullptr;
-        }
+        TableRetire(table);
         table.mBase = static_cast<ByteT*>(LFAlloc(size, table.mEntryAlignment));
         table.mEnd = table.mBase + size;
     }
@@ -568,10 +896,15 @@ bool TableReadFullBinary(File& file, MemDBTypes::Table& table)
 MemDB::MemDB()
 : mLock()
 , mTables()
+, mTableLookup()
 , mDataBytesReserved(0)
 , mDataBytesUsed(0)
 , mRuntimeBytesUsed(0)
 , mRuntimeBytesReserved(0)
+, mJournal()
+, mJournalConfig()
+, mJournalThread()
+, mJournalRunning(0)
 {
 
 }
@@ -583,12 +916,12 @@ MemDB::~MemDB()
 
 void MemDB::WriteToFile(TableID index, const String& filename, bool fullFlush)
 {
-    ScopeRWSpinLockRead lock(mLock);
     Table* t = GetTable(index);
     if (!t)
     {
         return;
     }
+    ScopeTableWrite lock(*t);
     
     File file;
     if (!file.Open(filename, FF_WRITE | FF_SHARE_READ | FF_RANDOM_ACCESS, FILE_OPEN_ALWAYS))
@@ -644,12 +977,12 @@ void MemDB::WriteToFile(TableID index, const String& filename, bool fullFlush)
 
 void MemDB::ReadFromFile(TableID index, const String& filename)
 {
-    ScopeRWSpinLockWrite lock(mLock);
     Table* t = GetTable(index);
     if (!t)
     {
         return;
     }
+    ScopeTableWrite lock(*t);
 
     File file;
     if (!file.Open(filename, FF_READ | FF_SHARE_READ, FILE_OPEN_EXISTING))
@@ -691,6 +1024,7 @@ void MemDB::Open(const String& filename)
             continue;
         }
 
+        ScopeTableWrite tableLock(*tbl);
         TableOpenFiles(mFilePath, *tbl);
     }
 
@@ -698,6 +1032,8 @@ void MemDB::Open(const String& filename)
 
 void MemDB::Close()
 {
+    DisableJournal();
+
     ScopeRWSpinLockWrite lock(mLock);
     for (Table* tbl : mTables)
     {
@@ -706,6 +1042,7 @@ void MemDB::Close()
             continue;
         }
 
+        ScopeTableWrite tableLock(*tbl);
         TableCloseFiles(*tbl);
     }
 }
@@ -718,14 +1055,22 @@ void MemDB::Save(SaveMode mode)
     }
 
     ScopeRWSpinLockRead lock(mLock);
-    for (Table* tbl : mTables)
+    // Records appended while we save go into the next journal file.
+    const bool checkpoint = mJournal.IsOpen() && mJournal.BeginCheckpoint();
+    const bool saved = SaveTables(mode);
+    if (!saved)
     {
-        if (tbl->mName.Empty())
-        {
-            continue;
-        }
-
-        TableSave(*tbl, mode);
+        // Keep the journal, it still holds the changes that didn't reach the table files.
+        gSysLog.Error(LogMessage("Failed to save db tables ") << mFilePath);
+    }
+    else if (checkpoint)
+    {
+        mJournal.EndCheckpoint();
+    }
+    else if (!mJournal.IsOpen())
+    {
+        // The tables are up to date, a stale journal would overwrite newer data on recovery.
+        MemDBJournal::Delete(mFilePath);
     }
 
     String fullpath = mFilePath + ".json";
@@ -739,6 +1084,7 @@ void MemDB::Save(SaveMode mode)
         {
             continue;
         }
+        ScopeRWSpinLockRead tableLock(table->mLock);
         js.Serialize(StreamPropertyInfo(table->mName));
         js.BeginStruct();
             SERIALIZE_NAMED(js, "EntrySize", table->mEntrySize, "");
@@ -781,6 +1127,7 @@ void MemDB::Load()
     }
 
     ScopeRWSpinLockRead lock(mLock);
+    TVector<Table*> tables;
     for (Table* tbl : mTables)
     {
         if (tbl->mName.Empty())
@@ -788,14 +1135,149 @@ void MemDB::Load()
             continue;
         }
 
+        ScopeTableWrite tableLock(*tbl);
         TableLoad(*tbl);
+        tables.push_back(tbl);
+    }
+
+    // Recover changes made since the last checkpoint.
+    MemDBJournal::Replay(mFilePath, [](const MemDBJournal::Record& record, void* userData)
+    {
+        const TVector<Table*>& tables = *reinterpret_cast<const TVector<Table*>*>(userData);
+        for (Table* tbl : tables)
+        {
+            if (tbl->mNameHash == record.mTableHash)
+            {
+                ScopeTableWrite tableLock(*tbl);
+                if (!TableApplyRecord(*tbl, record))
+                {
+                    gSysLog.Warning(LogMessage("Failed to apply journal record to db table ") << tbl->mName);
+                }
+                return;
+            }
+        }
+    }, &tables);
+
+    for (Table* tbl : tables)
+    {
+        ScopeTableWrite tableLock(*tbl);
+        if (tbl->mPendingWrites > 0)
+        {
+            TableRebuild(*tbl);
+        }
+    }
+}
+
+bool MemDB::EnableJournal(const MemDBJournalConfig& config)
+{
+    if (mFilePath.Empty() || mJournal.IsOpen())
+    {
+        return false;
+    }
+
+    // Start from a checkpoint, anything recovered by Load is written to the tables before the old journal is deleted.
+    {
+        ScopeRWSpinLockRead lock(mLock);
+        if (!SaveTables(SAVE_DIRTY_LIST))
+        {
+            gSysLog.Error(LogMessage("Failed to save db tables, the journal was not enabled ") << mFilePath);
+            return false;
+        }
+    }
+
+    if (!mJournal.Open(mFilePath, config.mSyncToDisk))
+    {
+        return false;
+    }
+
+    mJournalConfig = config;
+    if (mJournalConfig.mBackgroundThread)
+    {
+        AtomicStore(&mJournalRunning, 1);
+        mJournalThread.Fork(JournalThread, this);
+        mJournalThread.SetDebugName("MemDB Journal");
+    }
+    return true;
+}
+
+void MemDB::DisableJournal()
+{
+    if (!mJournal.IsOpen())
+    {
+        return;
+    }
+
+    if (mJournalThread.IsRunning())
+    {
+        AtomicStore(&mJournalRunning, 0);
+        mJournalThread.Join();
+    }
+    mJournalThread = Thread();
+
+    // Fold the journal into the tables, the journal is no longer required. If that fails the journal
+    // files are kept so the next Load recovers the changes.
+    const bool checkpoint = Checkpoint();
+    mJournal.Close();
+    if (checkpoint)
+    {
+        MemDBJournal::Delete(mFilePath);
+    }
+}
+
+bool MemDB::CommitJournal()
+{
+    return mJournal.IsOpen() && mJournal.CommitAll();
+}
+
+bool MemDB::Checkpoint()
+{
+    ScopeRWSpinLockRead lock(mLock);
+    if (!mJournal.IsOpen() || !mJournal.BeginCheckpoint())
+    {
+        return false;
+    }
+
+    // The previous journal file is only deleted once every table reached the disk, otherwise the
+    // next checkpoint retries the entries that are still dirty.
+    if (!SaveTables(SAVE_DIRTY_LIST))
+    {
+        gSysLog.Error(LogMessage("Failed to checkpoint db tables ") << mFilePath);
+        return false;
+    }
+    mJournal.EndCheckpoint();
+    return true;
+}
+
+bool MemDB::SaveTables(SaveMode mode)
+{
+    // note: Called with mLock acquired.
+    // note: A table that fails to flush is flushed again by the next save, which covers the entries
+    //       that were written (and are no longer dirty) by this save.
+    bool result = true;
+    for (Table* tbl : mTables)
+    {
+        if (tbl->mName.Empty())
+        {
+            continue;
+        }
+
+        ScopeTableWrite tableLock(*tbl);
+        if (!TableSave(*tbl, mode))
+        {
+            result = false;
+        }
+        if (!TableFlushFiles(*tbl))
+        {
+            result = false;
+        }
     }
+    return result;
 }
 
 void MemDB::CommitDirty(TableID table, MemDBTypes::EntryWriter* writer, SaveMode mode)
 {
-    ScopeRWSpinLockWrite lock(mLock);
     Table* t = GetTable(table);
+    ScopeTableWrite lock(*t);
 
     if (!writer->BeginCommit(TableByteCapacity(*t), t->mEntryAlignment))
     {
@@ -850,8 +1332,8 @@ void MemDB::CommitDirty(TableID table, MemDBTypes::EntryWriter* writer, SaveMode
 
 bool MemDB::LoadTableData(TableID table, const ByteT* bytes, SizeT numBytes)
 {
-    ScopeRWSpinLockWrite lock(mLock);
     Table* t = GetTable(table);
+    ScopeTableWrite lock(*t);
 
     // Table Validation: (All 'entries' must be valid)
     const SizeT numEntries = numBytes / t->mEntrySize;
@@ -910,6 +1392,30 @@ bool MemDB::LoadTableData(TableID table, const ByteT* bytes, SizeT numBytes)
             }
         }
     }
+    for (const MemDBHashIndex& index : t->mHashIndices)
+    {
+        if (index.AllowDuplicates())
+        {
+            continue;
+        }
+
+        MemDBHashIndex uniqueCheck;
+        uniqueCheck.Initialize(index.GetColumns().data(), index.GetColumns().size(), false);
+        uniqueCheck.Reserve(numUsed);
+        for (SizeT i = 0; i < numEntries; ++i)
+        {
+            const ByteT* entryBytes = bytes + (t->mEntrySize * i);
+            if (!EntryUsed(*reinterpret_cast<const Entry*>(entryBytes)))
+            {
+                continue;
+            }
+            if (Valid(uniqueCheck.FindOne(bytes, t->mEntrySize, entryBytes)))
+            {
+                return false; // Can only contain unique items!
+            }
+            uniqueCheck.Insert(static_cast<EntryID>(i), entryBytes);
+        }
+    }
 
     // Initialize the table
     TableRelease(*t);
@@ -919,11 +1425,11 @@ bool MemDB::LoadTableData(TableID table, const ByteT* bytes, SizeT numBytes)
     memcpy(t->mBase, bytes, numBytes);
 
     // Create indices
+    TVector<MemDBTypes::EntryIndex> keys;
+    keys.reserve(numUsed);
     for (MemDBTypes::TableIndex& index : t->mIndices)
     {
-        index.mCollection.clear();
-        index.mCollection.reserve(numEntries);
-        
+        keys.resize(0);
         for (SizeT i = 0; i < numEntries; ++i)
         {
             const ByteT* entryBytes = bytes + (t->mEntrySize * i);
@@ -937,11 +1443,9 @@ bool MemDB::LoadTableData(TableID table, const ByteT* bytes, SizeT numBytes)
             MemDBTypes::EntryIndex item;
             item.mID = entry->mReservedID;
             item.mValue = NumericalVariant::Cast(index.mDataType, itemBytes);
-            index.mCollection.push_back(item);
+            keys.push_back(item);
         }
-
-        std::sort(index.mCollection.begin(), index.mCollection.end());
-        index.mSorted = true;
+        index.mTree.BulkLoad(keys);
     }
 
     t->mNextFree = nextFree;
@@ -949,18 +1453,29 @@ bool MemDB::LoadTableData(TableID table, const ByteT* bytes, SizeT numBytes)
     t->mDirtyEntries.clear();
     t->mPendingWrites = 0;
     t->mCount = numUsed;
+    for (MemDBHashIndex& index : t->mHashIndices)
+    {
+        TableBuildHashIndex(*t, index);
+    }
     // TODO: We can optionally clear stats.
     return true;
 }
 
 void MemDB::Release()
 {
+    DisableJournal();
+
     ScopeRWSpinLockWrite lock(mLock);
     for (Table* tbl : mTables)
     {
         TableRelease(*tbl);
+        TableFreeRetired(*tbl);
     }
     mTables.clear();
+    for (SizeT i = 0; i < MAX_TABLES; ++i)
+    {
+        mTableLookup[i] = nullptr;
+    }
 
     mDataBytesReserved = 0;
     mDataBytesUsed = 0;
@@ -1025,13 +1540,22 @@ bool MemDB::CreateTable(const String& name, SizeT entrySize, SizeT entryAlignmen
         }
     }
     // Allocate:
+    bool published = true;
     if (!table)
     {
+        if (mTables.size() >= MAX_TABLES)
+        {
+            return false;
+        }
         outIndex = static_cast<TableID>(mTables.size());
         mTables.push_back(TablePtr(LFNew<Table>()));
         table = mTables.back();
+        published = false;
     }
+
+    ScopeTableWrite tableLock(*table);
     table->mName = name;
+    table->mNameHash = FNV::Hash(name.CStr(), name.Size());
     table->mEntryCapacity = entryCapacity;
     table->mEntryAlignment = entryAlignment;
     table->mEntrySize = entrySize;
@@ -1043,6 +1567,10 @@ bool MemDB::CreateTable(const String& name, SizeT entrySize, SizeT entryAlignmen
     AtomicAdd64(&mDataBytesReserved, static_cast<Atomic64>(TableByteCapacity(*table)));
     AtomicAdd64(&mRuntimeBytesReserved, static_cast<Atomic64>(table->mEntrySize));
     AtomicAdd64(&mRuntimeBytesUsed, static_cast<Atomic64>(table->mEntrySize));
+    if (!published)
+    {
+        AtomicStorePointer(&mTableLookup[outIndex], table);
+    }
     return true;
 }
 bool MemDB::DeleteTable(const String& name)
@@ -1057,12 +1585,14 @@ bool MemDB::DeleteTable(TableID index)
     {
         return false;
     }
-    AtomicSub64(&mDataBytesReserved, static_cast<Atomic64>(TableByteCapacity(*mTables[index])));
-    AtomicSub64(&mRuntimeBytesReserved, static_cast<Atomic64>(mTables[index]->mEntrySize));
-    AtomicSub64(&mRuntimeBytesUsed, static_cast<Atomic64>(mTables[index]->mEntrySize));
-    TableCloseFiles(*mTables[index]);
-    TableRelease(*mTables[index]);
-    *mTables[index] = Table();
+    Table& table = *mTables[index];
+    ScopeTableWrite tableLock(table);
+    AtomicSub64(&mDataBytesReserved, static_cast<Atomic64>(TableByteCapacity(table)));
+    AtomicSub64(&mRuntimeBytesReserved, static_cast<Atomic64>(table.mEntrySize));
+    AtomicSub64(&mRuntimeBytesUsed, static_cast<Atomic64>(table.mEntrySize));
+    TableCloseFiles(table);
+    TableRelease(table);
+    TableReset(table);
     return true;
 }
 bool MemDB::FindTable(const String& name, TableID& outIndex) const
@@ -1095,12 +1625,12 @@ bool MemDB::CreateIndex(TableID table, NumericalVariant::VariantType dataType, S
         return false;
     }
 
-    ScopeRWSpinLockWrite lock(mLock);
     Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
+    ScopeTableWrite lock(*t);
 
     for (const MemDBTypes::TableIndex& index : t->mIndices)
     {
@@ -1121,7 +1651,6 @@ bool MemDB::CreateIndex(TableID table, NumericalVariant::VariantType dataType, S
     MemDBTypes::TableIndex& tblIndex = t->mIndices.back();
     tblIndex.mDataType = dataType;
     tblIndex.mOffset = dataOffset;
-    tblIndex.mSorted = false;
     tblIndex.mAllowDuplicates = allowDuplicates;
     if (!mFilePath.Empty())
     {
@@ -1129,6 +1658,8 @@ bool MemDB::CreateIndex(TableID table, NumericalVariant::VariantType dataType, S
     }
 
     //
+    TVector<EntryIndex> keys;
+    keys.reserve(t->mCount);
     ByteT* ptr = t->mBase;
     for (SizeT i = 0; i < t->mEntryCapacity; ++i)
     {
@@ -1144,38 +1675,89 @@ bool MemDB::CreateIndex(TableID table, NumericalVariant::VariantType dataType, S
             entryIndex.mValue = variant;
             entryIndex.mID = entry.mReservedID;
 
-            tblIndex.mCollection.push_back(entryIndex);
+            keys.push_back(entryIndex);
         }
         
         ptr += t->mEntrySize;
     }
     
-    TableIndexWriteBarrier(tblIndex, true);
+    tblIndex.mTree.BulkLoad(keys);
+    if (!TableIndexUnique(tblIndex))
+    {
+        tblIndex.mTree.Clear();
+        return false;
+    }
+
+    return true;
+}
 
-    if (!tblIndex.mCollection.empty())
+bool MemDB::CreateHashIndex(TableID table, const MemDBTypes::HashKeyColumn* columns, SizeT numColumns, bool allowDuplicates, MemDBTypes::HashIndexID& outIndex)
+{
+    outIndex = INVALID;
+    if (!columns || numColumns == 0)
+    {
+        return false;
+    }
+
+    Table* t = GetTable(table);
+    if (!t)
     {
-        auto first = tblIndex.mCollection.begin();
-        for (auto it = first + 1; it != tblIndex.mCollection.end(); ++it)
+        return false;
+    }
+    ScopeTableWrite lock(*t);
+
+    for (SizeT i = 0; i < numColumns; ++i)
+    {
+        const MemDBTypes::HashKeyColumn& column = columns[i];
+        if (column.mOffset < sizeof(Entry) || (column.mOffset + column.mSize) > t->mEntrySize)
+        {
+            return false;
+        }
+    }
+
+    for (const MemDBHashIndex& index : t->mHashIndices)
+    {
+        if (index.HasColumns(columns, numColumns))
+        {
+            return false;
+        }
+    }
+
+    MemDBHashIndex index;
+    if (!index.Initialize(columns, numColumns, allowDuplicates))
+    {
+        return false;
+    }
+
+    // Build the index and verify the existing entries are unique.
+    index.Reserve(t->mCount);
+    const ByteT* ptr = t->mBase;
+    for (SizeT i = 0; i < t->mEntryCapacity; ++i)
+    {
+        if (EntryUsed(*reinterpret_cast<const Entry*>(ptr)))
         {
-            if (!(*first < *it))
+            if (!allowDuplicates && Valid(index.FindOne(t->mBase, t->mEntrySize, ptr)))
             {
-                tblIndex.mCollection.clear();
                 return false;
             }
+            index.Insert(static_cast<EntryID>(i), ptr);
         }
+        ptr += t->mEntrySize;
     }
 
+    outIndex = t->mHashIndices.size();
+    t->mHashIndices.push_back(std::move(index));
     return true;
 }
 
 bool MemDB::FindOne(TableID table, SizeT entrySize, SizeT entryAlignment, EntryFindCallback findCallback, void* findUserData, EntryID& outID) const
 {
-    ScopeRWSpinLockRead lock(mLock);
     const Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
+    ScopeRWSpinLockRead lock(t->mLock);
     TableOp(*t, MemDBTypes::OpTypes::OP_FIND_ONE);
 
     if (t->mEntrySize != entrySize || t->mEntryAlignment != entryAlignment)
@@ -1205,12 +1787,12 @@ bool MemDB::FindOne(TableID table, SizeT entrySize, SizeT entryAlignment, EntryF
 bool MemDB::FindOneIndexed(TableID table, NumericalVariant value, SizeT dataOffset, EntryID& outID)
 {
     using namespace MemDBTypes;
-    ScopeRWSpinLockRead lock(mLock);
     Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
+    ScopeRWSpinLockRead lock(t->mLock);
     TableOp(*t, MemDBTypes::OpTypes::OP_FIND_ONE_INDEXED);
 
     TableIndex* tblIndex = nullptr;
@@ -1232,15 +1814,10 @@ bool MemDB::FindOneIndexed(TableID table, NumericalVariant value, SizeT dataOffs
     {
         return false; 
     }
-    EntryIndex searchKey;
-    searchKey.mValue = value;
-    TableIndexReadBarrier(*tblIndex);
-
-    auto it = std::lower_bound(tblIndex->mCollection.begin(), tblIndex->mCollection.end(), searchKey);
-    auto result = (it != tblIndex->mCollection.end() && it->mValue == value) ? it : tblIndex->mCollection.end();
-    if (result != tblIndex->mCollection.end())
+    MemDBIndexTree::Iterator it = tblIndex->mTree.LowerBound(value);
+    if (it.Valid() && it->mValue == value)
     {
-        outID = result->mID;
+        outID = it->mID;
         return true;
     }
     return false;
@@ -1249,12 +1826,12 @@ bool MemDB::FindOneIndexed(TableID table, NumericalVariant value, SizeT dataOffs
 bool MemDB::FindRangeIndexed(TableID table, NumericalVariant value, SizeT dataOffset, TVector<EntryID>& outIDs)
 {
     using namespace MemDBTypes;
-    ScopeRWSpinLockRead lock(mLock);
     Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
+    ScopeRWSpinLockRead lock(t->mLock);
     TableOp(*t, MemDBTypes::OpTypes::OP_FIND_RANGE_INDEXED);
 
     TableIndex* tblIndex = nullptr;
@@ -1277,35 +1854,62 @@ bool MemDB::FindRangeIndexed(TableID table, NumericalVariant value, SizeT dataOf
         return false;
     }
 
-    EntryIndex searchKey;
-    searchKey.mValue = value;
-    TableIndexReadBarrier(*tblIndex);
+    for (MemDBIndexTree::Iterator it = tblIndex->mTree.LowerBound(value); it.Valid() && it->mValue == value; ++it)
+    {
+        outIDs.push_back(it->mID);
+    }
+    return true;
+
+}
+
+bool MemDB::FindOneHashed(TableID table, MemDBTypes::HashIndexID index, const Entry* keyData, SizeT entrySize, SizeT entryAlignment, EntryID& outID) const
+{
+    const Table* t = GetTable(table);
+    if (!t)
+    {
+        return false;
+    }
+    ScopeRWSpinLockRead lock(t->mLock);
+    TableOp(*t, MemDBTypes::OpTypes::OP_FIND_ONE_HASHED);
+
+    if (!keyData || t->mEntrySize != entrySize || t->mEntryAlignment != entryAlignment || index >= t->mHashIndices.size())
+    {
+        return false;
+    }
+
+    outID = t->mHashIndices[index].FindOne(t->mBase, t->mEntrySize, reinterpret_cast<const ByteT*>(keyData));
+    return Valid(outID);
+}
 
-    auto it = std::lower_bound(tblIndex->mCollection.begin(), tblIndex->mCollection.end(), searchKey);
-    auto result = (it != tblIndex->mCollection.end() && it->mValue == value) ? it : tblIndex->mCollection.end();
-    if (result == tblIndex->mCollection.end())
+bool MemDB::FindAllHashed(TableID table, MemDBTypes::HashIndexID index, const Entry* keyData, SizeT entrySize, SizeT entryAlignment, TVector<EntryID>& outIDs) const
+{
+    const Table* t = GetTable(table);
+    if (!t)
     {
-        return true;
+        return false;
     }
-    auto last = std::upper_bound(tblIndex->mCollection.begin(), tblIndex->mCollection.end(), searchKey);
-    for (; it != last; ++it)
+    ScopeRWSpinLockRead lock(t->mLock);
+    TableOp(*t, MemDBTypes::OpTypes::OP_FIND_ALL_HASHED);
+
+    if (!keyData || t->mEntrySize != entrySize || t->mEntryAlignment != entryAlignment || index >= t->mHashIndices.size())
     {
-        outIDs.push_back(it->mID);
+        return false;
     }
-    return true;
 
+    t->mHashIndices[index].FindAll(t->mBase, t->mEntrySize, reinterpret_cast<const ByteT*>(keyData), outIDs);
+    return true;
 }
 
 bool MemDB::FindAll(TableID table, SizeT entrySize, SizeT entryAlignment, EntryFindCallback findCallback, void* findUserData, TVector<EntryID>& outIDs) const
 {
     outIDs.clear();
 
-    ScopeRWSpinLockRead lock(mLock);
     const Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
+    ScopeRWSpinLockRead lock(t->mLock);
     TableOp(*t, MemDBTypes::OpTypes::OP_FIND_ALL);
 
     if (t->mEntrySize != entrySize || t->mEntryAlignment != entryAlignment)
@@ -1334,12 +1938,12 @@ bool MemDB::Insert(TableID table, const Entry* entryData, SizeT entrySize, SizeT
 {
     outID = INVALID32;
 
-    ScopeRWSpinLockWrite lock(mLock);
     Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
+    ScopeTableWrite lock(*t);
     TableOp(*t, MemDBTypes::OpTypes::OP_INSERT);
 
     if (entryData == nullptr)
@@ -1353,7 +1957,7 @@ bool MemDB::Insert(TableID table, const Entry* entryData, SizeT entrySize, SizeT
     }
 
     // Indexes require unique elements.
-    if (!t->mIndices.empty())
+    if (!t->mIndices.empty() || !t->mHashIndices.empty())
     {
         if (!TableCheckIndex(*t, reinterpret_cast<const ByteT*>(entryData)))
         {
@@ -1371,7 +1975,7 @@ bool MemDB::Insert(TableID table, const Entry* entryData, SizeT entrySize, SizeT
         SetFlag(*entry, MemDBTypes::EF_USED);
         SetFlag(*entry, MemDBTypes::EF_DIRTY);
 
-        TableInsertIndex(*t, outID, reinterpret_cast<const ByteT*>(entryData), false);
+        TableInsertIndex(*t, outID, reinterpret_cast<const ByteT*>(entryData));
         ++t->mCount;
         ++t->mPendingWrites;
 
@@ -1381,6 +1985,7 @@ bool MemDB::Insert(TableID table, const Entry* entryData, SizeT entrySize, SizeT
         ByteT* destPtr = ptr + sizeof(Entry);
         memcpy(destPtr, srcPtr, t->mEntrySize - sizeof(Entry));
         AtomicAdd64(&mDataBytesUsed, t->mEntrySize);
+        JournalEntry(t, MemDBJournal::RECORD_INSERT, outID);
         return true;
     }
     return false;
@@ -1388,12 +1993,12 @@ bool MemDB::Insert(TableID table, const Entry* entryData, SizeT entrySize, SizeT
 
 bool MemDB::BulkInsert(TableID table, const Entry* entryData, SizeT entrySize, SizeT entryAlignment, SizeT numEntries, TVector<EntryID>& outIDs)
 {
-    ScopeRWSpinLockWrite lock(mLock);
     Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
+    ScopeTableWrite lock(*t);
     TableOp(*t, MemDBTypes::OpTypes::OP_BULK_INSERT);
 
     if (entryData == nullptr)
@@ -1453,18 +2058,23 @@ bool MemDB::BulkInsert(TableID table, const Entry* entryData, SizeT entrySize, S
         CleanUpBulkInsert(t, outIDs);
         return false;
     }
+
+    for (EntryID id : outIDs)
+    {
+        JournalEntry(t, MemDBJournal::RECORD_INSERT, id);
+    }
     return true;
 
 }
 
 bool MemDB::UpdateOne(TableID table, EntryID entryID, const Entry* entryData, SizeT entrySize, SizeT entryAlignment)
 {
-    ScopeRWSpinLockWrite lock(mLock);
     Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
+    ScopeTableWrite lock(*t);
     TableOp(*t, MemDBTypes::OpTypes::OP_UPDATE_ONE);
 
     if (entryData == nullptr)
@@ -1502,18 +2112,19 @@ bool MemDB::UpdateOne(TableID table, EntryID entryID, const Entry* entryData, Si
         t->mDirtyEntries.push_back(entryID);
     }
     SetFlag(*entry, MemDBTypes::EF_DIRTY);
+    JournalEntry(t, MemDBJournal::RECORD_UPDATE, entryID);
     return true;
 
 }
 
 bool MemDB::Delete(TableID table, EntryID id)
 {
-    ScopeRWSpinLockWrite lock(mLock);
     Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
+    ScopeTableWrite lock(*t);
     TableOp(*t, MemDBTypes::OpTypes::OP_DELETE);
 
     if (id >= t->mEntryCapacity)
@@ -1530,7 +2141,7 @@ bool MemDB::Delete(TableID table, EntryID id)
         return false;
     }
 
-    TableRemoveIndex(*t, id);
+    TableRemoveIndex(*t, id, ptr);
 
     UnsetFlag(*entry, MemDBTypes::EF_USED);
     if (!EntryDirty(*entry))
@@ -1546,18 +2157,18 @@ bool MemDB::Delete(TableID table, EntryID id)
     memset(destPtr, 0, t->mEntrySize - sizeof(Entry));
 
     AtomicSub64(&mDataBytesUsed, t->mEntrySize);
-
+    JournalEntry(t, MemDBJournal::RECORD_DELETE, id);
     return true;
 }
 
 bool MemDB::Select(TableID table, EntryID entryID, SizeT entrySize, SizeT entryAlignment, EntryReadWriteCallback selectCallback, void* selectUserData)
 {
-    ScopeRWSpinLockWrite lock(mLock);
     Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
+    ScopeTableWrite lock(*t);
     TableOp(*t, MemDBTypes::OpTypes::OP_SELECT_WRITE);
 
     Entry* entry = SelectUsedEntry(t, entrySize, entryAlignment, entryID);
@@ -1586,6 +2197,7 @@ bool MemDB::Select(TableID table, EntryID entryID, SizeT entrySize, SizeT entryA
         }
         SetFlag(*entry, MemDBTypes::EF_DIRTY);
         TableUpdateIndex(*t, entryID, t->mScratchEntry, reinterpret_cast<const ByteT*>(entry));
+        JournalEntry(t, MemDBJournal::RECORD_UPDATE, entryID);
     }
 
     return true;
@@ -1593,13 +2205,39 @@ bool MemDB::Select(TableID table, EntryID entryID, SizeT entrySize, SizeT entryA
 
 bool MemDB::Select(TableID table, EntryID entryID, SizeT entrySize, SizeT entryAlignment, EntryReadCallback selectCallback, void* selectUserData)
 {
-    ScopeRWSpinLockRead lock(mLock);
     Table* t = GetTable(table);
     if (!t)
     {
         return false;
     }
     TableOp(*t, MemDBTypes::OpTypes::OP_SELECT_READ);
+
+    // ** Optimistic read, copy the entry without acquiring the lock and retry if a writer touched the table
+    // in the meantime. The callback only ever sees the consistent copy.
+    if (entrySize <= OPTIMISTIC_READ_MAX_SIZE && entryAlignment <= OPTIMISTIC_READ_MAX_ALIGNMENT)
+    {
+        LF_ALIGN(16) ByteT copy[OPTIMISTIC_READ_MAX_SIZE];
+        for (SizeT attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; ++attempt)
+        {
+            SelectResult result = SELECT_RETRY;
+            {
+                ScopeTableOptimisticRead reader(*t);
+                result = SelectOptimistic(t, entrySize, entryAlignment, entryID, copy);
+            }
+            if (result == SELECT_RETRY)
+            {
+                continue;
+            }
+            if (result == SELECT_SUCCESS)
+            {
+                selectCallback(copy, selectUserData);
+                return true;
+            }
+            return false;
+        }
+    }
+
+    ScopeRWSpinLockRead lock(t->mLock);
     const Entry* entry = SelectUsedEntry(t, entrySize, entryAlignment, entryID);
     if (!entry)
     {
@@ -1631,22 +2269,28 @@ MemDBStats MemDB::GetStats() const
     ScopeRWSpinLockRead lock(mLock);
     for (const Table* t : mTables)
     {
+        ScopeRWSpinLockRead tableLock(t->mLock);
         stats.mRuntimeBytesReserved += t->mFreeList.capacity() * sizeof(EntryID);
         stats.mRuntimeBytesUsed += t->mFreeList.size() * sizeof(EntryID);
 
         for (const TableIndex& index : t->mIndices)
         {
-            SizeT dataSize = NumericalVariant::GetSize(index.mDataType);
-            stats.mRuntimeBytesReserved += dataSize * index.mCollection.size();
-            stats.mRuntimeBytesUsed += dataSize * index.mCollection.size();
+            stats.mRuntimeBytesReserved += index.mTree.GetBytesReserved();
+            stats.mRuntimeBytesUsed += index.mTree.Size() * sizeof(EntryIndex);
+        }
+        for (const MemDBHashIndex& index : t->mHashIndices)
+        {
+            stats.mRuntimeBytesReserved += index.GetBytesReserved();
+            stats.mRuntimeBytesUsed += index.Size() * sizeof(EntryID);
         }
 
         for (SizeT i = 0; i < MemDBTypes::OpTypes::MAX_VALUE; ++i)
         {
-            stats.mOpCounts[i] += AtomicLoad(&t->mOpCounts[i]);
+            stats.mOpCounts[i] += TableOpCount(*t, i);
         }
 
         stats.mResizeCount += t->mResizeCount;
+        stats.mRetiredBuffers += t->mRetired.size();
     }
 
     return stats;
@@ -1672,49 +2316,85 @@ MemDBStats MemDB::GetTableStats(TableID table) const
     MemDBStats stats;
     memset(&stats, 0, sizeof(stats));
 
-    ScopeRWSpinLockRead lock(mLock);
     const Table* t = GetTable(table);
+    ScopeRWSpinLockRead lock(t->mLock);
 
     stats.mRuntimeBytesReserved += t->mFreeList.capacity() * sizeof(EntryID);
     stats.mRuntimeBytesUsed += t->mFreeList.size() * sizeof(EntryID);
 
     for (const TableIndex& index : t->mIndices)
     {
-        SizeT dataSize = NumericalVariant::GetSize(index.mDataType);
-        stats.mRuntimeBytesReserved += dataSize * index.mCollection.size();
-        stats.mRuntimeBytesUsed += dataSize * index.mCollection.size();
+        stats.mRuntimeBytesReserved += index.mTree.GetBytesReserved();
+        stats.mRuntimeBytesUsed += index.mTree.Size() * sizeof(EntryIndex);
+    }
+    for (const MemDBHashIndex& index : t->mHashIndices)
+    {
+        stats.mRuntimeBytesReserved += index.GetBytesReserved();
+        stats.mRuntimeBytesUsed += index.Size() * sizeof(EntryID);
     }
 
     for (SizeT i = 0; i < MemDBTypes::OpTypes::MAX_VALUE; ++i)
     {
-        stats.mOpCounts[i] += AtomicLoad(&t->mOpCounts[i]);
+        stats.mOpCounts[i] += TableOpCount(*t, i);
     }
 
     stats.mDataBytesReserved = t->mEntryCapacity * t->mEntrySize;
     stats.mDataBytesUsed = t->mCount * t->mEntrySize;
 
     stats.mResizeCount += t->mResizeCount;
+    stats.mRetiredBuffers += t->mRetired.size();
 
     return stats;
 }
 
 void MemDB::SetTableFreeCache(TableID table, SizeT cacheSize)
 {
-    ScopeRWSpinLockWrite lock(mLock);
     Table* t = GetTable(table);
     if (t != nullptr)
     {
+        ScopeTableWrite lock(*t);
         t->mFreeList.reserve(cacheSize);
     }
 }
 
+void MemDB::JournalEntry(const Table* t, MemDBJournal::RecordType type, EntryID entryID)
+{
+    if (!mJournal.IsOpen())
+    {
+        return;
+    }
+
+    if (type == MemDBJournal::RECORD_DELETE)
+    {
+        mJournal.Append(type, t->mNameHash, entryID, nullptr, 0);
+    }
+    else
+    {
+        mJournal.Append(type, t->mNameHash, entryID, t->mBase + (t->mEntrySize * entryID), t->mEntrySize);
+    }
+}
+
+void MemDB::JournalThread(void* data)
+{
+    MemDB* db = reinterpret_cast<MemDB*>(data);
+    while (AtomicLoad(&db->mJournalRunning) != 0)
+    {
+        SleepCallingThread(db->mJournalConfig.mGroupCommitMilliseconds);
+        db->mJournal.CommitAll();
+        if (db->mJournal.GetFileBytes() >= db->mJournalConfig.mCheckpointBytes)
+        {
+            db->Checkpoint();
+        }
+    }
+}
+
 MemDB::Table* MemDB::GetTable(TableID index)
 {
-    return (index < mTables.size()) ? mTables[index].AsPtr() : nullptr;
+    return (index < MAX_TABLES) ? AtomicLoadPointer(&mTableLookup[index]) : nullptr;
 }
 const MemDB::Table* MemDB::GetTable(TableID index) const
 {
-    return (index < mTables.size()) ? mTables[index].AsPtr() : nullptr;
+    return (index < MAX_TABLES) ? AtomicLoadPointer(&mTableLookup[index]) : nullptr;
 }
 
 MemDB::Entry* MemDB::SelectUsedEntry(Table* t, SizeT size, SizeT alignment, EntryID entryID)
@@ -1740,6 +2420,40 @@ MemDB::Entry* MemDB::SelectUsedEntry(Table* t, SizeT size, SizeT alignment, Entr
     return entry;
 }
 
+MemDB::SelectResult MemDB::SelectOptimistic(const Table* t, SizeT size, SizeT alignment, EntryID entryID, ByteT* outEntry) const
+{
+    const Atomic32 sequence = AtomicLoad(&t->mSequence);
+    if ((sequence & 1) != 0)
+    {
+        return SELECT_RETRY;
+    }
+
+    // Snapshot the layout, the sequence is checked before the buffer is read so base/capacity are from the
+    // same write. (Replaced buffers are retired and only freed once no optimistic readers are registered)
+    const SizeT entrySize = t->mEntrySize;
+    const SizeT entryAlignment = t->mEntryAlignment;
+    const SizeT entryCapacity = t->mEntryCapacity;
+    const ByteT* base = t->mBase;
+    AtomicRWBarrier();
+    if (AtomicLoad(&t->mSequence) != sequence)
+    {
+        return SELECT_RETRY;
+    }
+
+    if (entrySize != size || entryAlignment != alignment || entryID >= entryCapacity || base == nullptr)
+    {
+        return SELECT_FAILED;
+    }
+
+    memcpy(outEntry, base + (entrySize * entryID), entrySize);
+    AtomicRWBarrier();
+    if (AtomicLoad(&t->mSequence) != sequence)
+    {
+        return SELECT_RETRY;
+    }
+    return EntryUsed(*reinterpret_cast<const Entry*>(outEntry)) ? SELECT_SUCCESS : SELECT_FAILED;
+}
+
 void MemDB::AllocateID(Table* t, ByteT*& ptr, EntryID& outID)
 {
     outID = INVALID32;
@@ -1821,17 +2535,11 @@ void MemDB::AllocateID(Table* t, ByteT*& ptr, EntryID& outID)
     if (Invalid(outID) && TableByteCapacity(*t) < ToGB<SizeT>(1))
     {
         SizeT oldCapacity = t->mEntryCapacity;
+        SizeT oldByteCapacity = TableByteCapacity(*t);
 
-        Table oldTable = *t;
-        t->mEntryCapacity *= 2;
-        t->mBase = nullptr;
-        t->mEnd = nullptr;
-        t->mScratchEntry = nullptr;
-
-        AtomicSub64(&mDataBytesReserved, TableByteCapacity(oldTable));
+        TableGrow(*t);
+        AtomicSub64(&mDataBytesReserved, oldByteCapacity);
         AtomicAdd64(&mDataBytesReserved, TableByteCapacity(*t));
-        TableAllocCopy(oldTable, *t);
-        TableRelease(oldTable);
 
         // Allocate Again:
         ptr = t->mBase;
@@ -1849,14 +2557,12 @@ void MemDB::AllocateID(Table* t, ByteT*& ptr, EntryID& outID)
             }
             ptr += t->mEntrySize;
         }
-
-        ++t->mResizeCount;
     }
 }
 
 bool MemDB::TryBulkInsert(Table* t, const Entry* entryData, SizeT numEntries, TVector<EntryID>& outIDs)
 {
-    if (!t->mIndices.empty())
+    if (!t->mIndices.empty() || !t->mHashIndices.empty())
     {
         for (SizeT i = 0; i < numEntries; ++i)
         {
@@ -1883,7 +2589,6 @@ bool MemDB::TryBulkInsert(Table* t, const Entry* entryData, SizeT numEntries, TV
             const ByteT* srcBasePtr = reinterpret_cast<const ByteT*>(entryData) + (t->mEntrySize * i);
             const ByteT* srcPtr = srcBasePtr + sizeof(Entry);
 
-            TableInsertIndex(*t, outID, srcBasePtr, false);
             ++t->mCount;
             ++t->mPendingWrites;
 
@@ -1900,6 +2605,7 @@ bool MemDB::TryBulkInsert(Table* t, const Entry* entryData, SizeT numEntries, TV
         }
     }
 
+    TableBulkInsertIndex(*t, outIDs, reinterpret_cast<const ByteT*>(entryData));
     return true;
 }
 
@@ -1910,7 +2616,7 @@ void MemDB::CleanUpBulkInsert(Table* t, TVector<EntryID>& outIDs)
         ByteT* ptr = t->mBase;
         ptr += (t->mEntrySize * id);
         Entry* entry = reinterpret_cast<Entry*>(ptr);
-        TableRemoveIndex(*t, id);
+        TableRemoveIndex(*t, id, ptr);
         UnsetFlag(*entry, MemDBTypes::EF_USED);
         if (!EntryDirty(*entry))
         {
@@ -26,7 +26,9 @@
 #include "Core/Memory/SmartPointer.h"
 #include "Core/Utility/Array.h"
 #include "Core/Utility/NumericalVariant.h"
+#include "Core/IO/MemDBJournal.h"
 #include "Core/Platform/RWSpinLock.h"
+#include "Core/Platform/Thread.h"
 
 namespace lf 
 {
@@ -70,10 +72,46 @@ OP_BULK_INSERT,
 OP_DELETE,
 OP_UPDATE_ONE,
 OP_SELECT_READ,
-OP_SELECT_WRITE);
+OP_SELECT_WRITE,
+OP_FIND_ONE_HASHED,
+OP_FIND_ALL_HASHED);
 
 enum : EntryID { INVALID_ENTRY_ID = INVALID32 };
 
+using HashIndexID = SizeT;
+
+// ********************************************************************
+// How the bytes of a hash index column are compared.
+// ********************************************************************
+enum HashKeyType
+{
+    HKT_BYTES,  // ** Compare all bytes of the column
+    HKT_CHAR,   // ** Compare a null terminated char string (MemDBChar)
+    HKT_WCHAR   // ** Compare a null terminated wchar_t string (MemDBWChar)
+};
+
+// ********************************************************************
+// A column of a hash index key, a key may be made up of multiple
+// columns (composite key).
+// ********************************************************************
+struct HashKeyColumn
+{
+    template<typename T>
+    static HashKeyColumn Value(SizeT offset)
+    {
+        return HashKeyColumn{ offset, sizeof(T), HKT_BYTES };
+    }
+    template<typename StringT>
+    static HashKeyColumn String(SizeT offset)
+    {
+        return HashKeyColumn{ offset, sizeof(StringT), sizeof(typename StringT::CharType) == sizeof(char) ? HKT_CHAR : HKT_WCHAR };
+    }
+
+    SizeT       mOffset;
+    SizeT       mSize;
+    HashKeyType mType;
+};
+
 } // namespace MemDBTypes
 
 struct MemDBStats
@@ -86,6 +124,8 @@ struct MemDBStats
     SizeT mOpCounts[MemDBTypes::OpTypes::MAX_VALUE];
 
     SizeT mResizeCount;
+    // Old table buffers waiting for optimistic readers to drain.
+    SizeT mRetiredBuffers;
 };
 
 
@@ -152,8 +192,16 @@ using MemDBField = MemDBChar<80>;
 // MemDB intended usage is going to be reading/writing binary data by editing 
 // small portions of a file rather then re-writing the whole thing everytime.
 //
-// All operations are intended to be 'threadsafe' however they are not optimized
-// for multithreaded access (eg theres only one lock on the whole DB)
+// All operations are intended to be 'threadsafe'. The database lock only guards
+// the table list (create/delete/find), each table has its own reader/writer lock.
+// SelectRead on small entries (<= 256 bytes) is optimistic, the entry is copied
+// without acquiring the table lock and retried if a writer modified the table,
+// the callback receives the copy.
+//
+// Changes can be persisted through a write-ahead journal (see EnableJournal),
+// each insert/update/delete appends a record that is committed with one
+// sequential write. Checkpoints fold the journal into the table files and
+// Load replays whatever the last checkpoint missed.
 // 
 // Management of EntryID/TableID is on the user. The DB does not use any 
 // type of serial to verify data integrity.
@@ -200,8 +248,39 @@ public:
     void CommitDirty(TableID table, MemDBTypes::EntryWriter* writer, SaveMode mode = SAVE_DIRTY);
     bool LoadTableData(TableID table, const ByteT* bytes, SizeT numBytes);
 
+    // ********************************************************************
+    // Starts journaling changes to <filename>.journal0/1, the database must
+    // be open. The tables are saved first, call Load before enabling the
+    // journal to recover from an existing journal otherwise it is discarded.
+    //
+    // note: LoadTableData/ReadFromFile are not journaled, call Checkpoint
+    //       after using them.
+    // @returns Returns false if the journal could not be created.
+    // ********************************************************************
+    bool EnableJournal(const MemDBJournalConfig& config = MemDBJournalConfig());
+    // ********************************************************************
+    // Checkpoints and stops journaling, the journal files are deleted.
+    // ********************************************************************
+    void DisableJournal();
+    bool IsJournalEnabled() const { return mJournal.IsOpen(); }
+    // ********************************************************************
+    // Writes all journal records appended so far (group commit), concurrent
+    // callers share a single write.
+    // ********************************************************************
+    bool CommitJournal();
+    // ********************************************************************
+    // Saves dirty entries to the table files and truncates the journal.
+    // ********************************************************************
+    bool Checkpoint();
+
     void Release();
 
+    // ********************************************************************
+    // Creates a table, fails if the name is taken or the database already
+    // holds MAX_TABLES (64) tables. Deleted tables free their slot for reuse.
+    //
+    // note: The limit bounds the lock free table lookup used by readers.
+    // ********************************************************************
     bool CreateTable(const String& name, SizeT entrySize, SizeT entryAlignment, TableID& outIndex);
     bool CreateTable(const String& name, SizeT entrySize, SizeT entryAlignment, SizeT entryCapacity, TableID& outIndex);
     bool DeleteTable(const String& name);
@@ -210,6 +289,15 @@ public:
     
 
     bool CreateIndex(TableID table, NumericalVariant::VariantType dataType, SizeT dataOffset, bool allowDuplicates = false);
+    // ********************************************************************
+    // Creates a hash index over the key columns for O(1) equality lookups
+    // with FindOneHashed/FindAllHashed.
+    // 
+    // @param columns -- The columns that make up the key, eg. a MemDBField path
+    // @param allowDuplicates -- If false inserts with an existing key fail
+    // @param outIndex -- The id of the index used for lookups
+    // ********************************************************************
+    bool CreateHashIndex(TableID table, const MemDBTypes::HashKeyColumn* columns, SizeT numColumns, bool allowDuplicates, MemDBTypes::HashIndexID& outIndex);
 
     template<typename EntryT>
     bool CreateTable(const String& name, TableID& outIndex)
@@ -229,6 +317,10 @@ public:
     bool FindOneIndexed(TableID table, NumericalVariant value, SizeT dataOffset, EntryID& outID);
     // Read only operation,
     bool FindRangeIndexed(TableID table, NumericalVariant value, SizeT dataOffset, TVector<EntryID>& outIDs);
+    // Read only operation, 'keyData' is an entry with the key columns of the index set
+    bool FindOneHashed(TableID table, MemDBTypes::HashIndexID index, const Entry* keyData, SizeT entrySize, SizeT entryAlignment, EntryID& outID) const;
+    // Read only operation, 'keyData' is an entry with the key columns of the index set
+    bool FindAllHashed(TableID table, MemDBTypes::HashIndexID index, const Entry* keyData, SizeT entrySize, SizeT entryAlignment, TVector<EntryID>& outIDs) const;
     // Read only operation, does not affect the index
     bool FindAll(TableID table, SizeT entrySize, SizeT entryAlignment, EntryFindCallback findCallback, void* findUserData, TVector<EntryID>& outIDs) const;
     // Write operation, can affect the index
@@ -271,6 +363,20 @@ public:
             outIDs);
     }
 
+    template<typename EntryT>
+    bool FindOneHashed(TableID table, MemDBTypes::HashIndexID index, const EntryT& keyData, EntryID& outID) const
+    {
+        LF_STATIC_IS_A(EntryT, Entry);
+        return FindOneHashed(table, index, &keyData, sizeof(EntryT), alignof(EntryT), outID);
+    }
+
+    template<typename EntryT>
+    bool FindAllHashed(TableID table, MemDBTypes::HashIndexID index, const EntryT& keyData, TVector<EntryID>& outIDs) const
+    {
+        LF_STATIC_IS_A(EntryT, Entry);
+        return FindAllHashed(table, index, &keyData, sizeof(EntryT), alignof(EntryT), outIDs);
+    }
+
     template<typename EntryT>
     bool Insert(TableID table, const EntryT& entryData, EntryID& outID)
     {
@@ -326,8 +432,15 @@ public:
     // number of re-allocs & copying.
     // ********************************************************************
     void SetTableFreeCache(TableID table, SizeT cacheSize);
+    enum { MAX_TABLES = 64 };
 private:
     using TablePtr = TStrongPointer<Table>;
+    enum SelectResult
+    {
+        SELECT_SUCCESS,
+        SELECT_FAILED,
+        SELECT_RETRY
+    };
 
     MemDB(const MemDB&) = delete;
     MemDB& operator=(const MemDB&) = delete;
@@ -336,13 +449,22 @@ private:
     const Table* GetTable(TableID index) const;
 
     Entry* SelectUsedEntry(Table* t, SizeT size, SizeT alignment, EntryID entryID);
+    SelectResult SelectOptimistic(const Table* t, SizeT size, SizeT alignment, EntryID entryID, ByteT* outEntry) const;
 
     void AllocateID(Table* t, ByteT*& ptr, EntryID& outID);
     bool TryBulkInsert(Table* table, const Entry* entryData, SizeT numEntries, TVector<EntryID>& outID);
     void CleanUpBulkInsert(Table* table, TVector<EntryID>& outID);
+
+    void JournalEntry(const Table* t, MemDBJournal::RecordType type, EntryID entryID);
+    static void JournalThread(void* data);
+    // ** Saves and flushes every table, returns false if any table failed to reach the disk.
+    bool SaveTables(SaveMode mode);
     
+    // ** Guards the table list, tables have their own lock.
     mutable RWSpinLock mLock;
     TVector<TablePtr>   mTables;
+    // ** Tables published for lookup without the database lock, tables are recycled and only freed on Release.
+    Table* volatile    mTableLookup[MAX_TABLES];
     String             mFilePath;
 
     volatile Atomic64  mDataBytesReserved;
@@ -350,6 +472,10 @@ private:
     volatile Atomic64  mRuntimeBytesUsed;
     volatile Atomic64  mRuntimeBytesReserved;
 
+    MemDBJournal       mJournal;
+    MemDBJournalConfig mJournalConfig;
+    Thread             mJournalThread;
+    volatile Atomic32  mJournalRunning;
 };
 
 template<typename CharT, SizeT CArrayLength>
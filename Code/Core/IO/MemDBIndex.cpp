@@ -0,0 +1,1117 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "MemDBIndex.h"
+#include "Core/Common/Assert.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Utility/FNVHash.h"
+#include "Core/Utility/Utility.h"
+#include <algorithm>
+#include <emmintrin.h> // SSE 2
+#if defined(LF_OS_WINDOWS)
+#include <intrin.h>
+#endif
+
+namespace lf
+{
+
+// ** Nodes with fewer records than this borrow from or merge with a sibling.
+static const SizeT LEAF_MIN = MemDBIndexTree::LEAF_CAPACITY / 2;
+static const SizeT INNER_MIN = MemDBIndexTree::INNER_CAPACITY / 2;
+// ** Bulk loaded nodes are left partially empty so subsequent inserts don't immediately split.
+static const SizeT LEAF_BULK_FILL = (MemDBIndexTree::LEAF_CAPACITY * 3) / 4;
+static const SizeT INNER_BULK_FILL = (MemDBIndexTree::INNER_CAPACITY * 3) / 4;
+
+struct MemDBIndexTree::Node
+{
+    SizeT mCount;
+    bool  mLeaf;
+};
+
+struct MemDBIndexTree::LeafNode : public MemDBIndexTree::Node
+{
+    Key       mKeys[LEAF_CAPACITY];
+    LeafNode* mPrev;
+    LeafNode* mNext;
+};
+
+// ** Child i contains records less than mKeys[i], child i + 1 contains records greater or equal to mKeys[i]
+struct MemDBIndexTree::InnerNode : public MemDBIndexTree::Node
+{
+    Key   mKeys[INNER_CAPACITY];
+    Node* mChildren[INNER_CAPACITY + 1];
+};
+
+// ** Strict weak ordering on (value, id)
+LF_FORCE_INLINE static bool KeyLess(const MemDBTypes::EntryIndex& a, const MemDBTypes::EntryIndex& b)
+{
+    if (a.mValue < b.mValue)
+    {
+        return true;
+    }
+    if (b.mValue < a.mValue)
+    {
+        return false;
+    }
+    return a.mID < b.mID;
+}
+
+// ** @returns Returns the index of the first key not less than 'key'
+LF_FORCE_INLINE static SizeT KeyLowerBound(const MemDBTypes::EntryIndex* keys, SizeT count, const MemDBTypes::EntryIndex& key)
+{
+    return static_cast<SizeT>(std::lower_bound(keys, keys + count, key, KeyLess) - keys);
+}
+
+// ** @returns Returns the index of the child that may contain 'key'
+LF_FORCE_INLINE static SizeT KeyChildIndex(const MemDBTypes::EntryIndex* keys, SizeT count, const MemDBTypes::EntryIndex& key)
+{
+    return static_cast<SizeT>(std::upper_bound(keys, keys + count, key, KeyLess) - keys);
+}
+
+template<typename T>
+static void ArrayInsert(T* items, SizeT count, SizeT index, const T& item)
+{
+    for (SizeT i = count; i > index; --i)
+    {
+        items[i] = items[i - 1];
+    }
+    items[index] = item;
+}
+
+template<typename T>
+static void ArrayErase(T* items, SizeT count, SizeT index)
+{
+    for (SizeT i = index + 1; i < count; ++i)
+    {
+        items[i - 1] = items[i];
+    }
+}
+
+MemDBIndexTree::Iterator::Iterator(const LeafNode* leaf, SizeT index)
+: mLeaf(leaf)
+, mIndex(index)
+{
+    Normalize();
+}
+
+const MemDBIndexTree::Key& MemDBIndexTree::Iterator::operator*() const
+{
+    Assert(Valid());
+    return mLeaf->mKeys[mIndex];
+}
+
+MemDBIndexTree::Iterator& MemDBIndexTree::Iterator::operator++()
+{
+    if (mLeaf)
+    {
+        ++mIndex;
+        Normalize();
+    }
+    return *this;
+}
+
+void MemDBIndexTree::Iterator::Normalize()
+{
+    while (mLeaf && mIndex >= mLeaf->mCount)
+    {
+        mLeaf = mLeaf->mNext;
+        mIndex = 0;
+    }
+}
+
+MemDBIndexTree::MemDBIndexTree()
+: mRoot(nullptr)
+, mSize(0)
+, mBytesReserved(0)
+{}
+
+MemDBIndexTree::MemDBIndexTree(MemDBIndexTree&& other)
+: mRoot(other.mRoot)
+, mSize(other.mSize)
+, mBytesReserved(other.mBytesReserved)
+{
+    other.mRoot = nullptr;
+    other.mSize = 0;
+    other.mBytesReserved = 0;
+}
+
+MemDBIndexTree::~MemDBIndexTree()
+{
+    Clear();
+}
+
+MemDBIndexTree& MemDBIndexTree::operator=(MemDBIndexTree&& other)
+{
+    if (this != &other)
+    {
+        Clear();
+        mRoot = other.mRoot;
+        mSize = other.mSize;
+        mBytesReserved = other.mBytesReserved;
+        other.mRoot = nullptr;
+        other.mSize = 0;
+        other.mBytesReserved = 0;
+    }
+    return *this;
+}
+
+bool MemDBIndexTree::Insert(const Key& key)
+{
+    if (!mRoot)
+    {
+        mRoot = AllocateLeaf();
+    }
+
+    Key splitKey;
+    Node* splitNode = nullptr;
+    if (!InsertRecursive(mRoot, key, splitKey, splitNode))
+    {
+        return false;
+    }
+
+    // Root split, grow the tree.
+    if (splitNode)
+    {
+        InnerNode* root = AllocateInner();
+        root->mCount = 1;
+        root->mKeys[0] = splitKey;
+        root->mChildren[0] = mRoot;
+        root->mChildren[1] = splitNode;
+        mRoot = root;
+    }
+    ++mSize;
+    return true;
+}
+
+bool MemDBIndexTree::Remove(const Key& key)
+{
+    if (!mRoot || !RemoveRecursive(mRoot, key))
+    {
+        return false;
+    }
+    --mSize;
+
+    // Shrink the tree
+    if (mRoot->mLeaf)
+    {
+        if (mRoot->mCount == 0)
+        {
+            FreeNode(mRoot);
+            mRoot = nullptr;
+        }
+    }
+    else if (mRoot->mCount == 0)
+    {
+        Node* child = static_cast<InnerNode*>(mRoot)->mChildren[0];
+        FreeNode(mRoot);
+        mRoot = child;
+    }
+    return true;
+}
+
+bool MemDBIndexTree::Contains(const NumericalVariant& value) const
+{
+    Iterator it = LowerBound(value);
+    return it.Valid() && it->mValue == value;
+}
+
+MemDBIndexTree::Iterator MemDBIndexTree::LowerBound(const NumericalVariant& value) const
+{
+    Node* node = mRoot;
+    if (!node)
+    {
+        return Iterator();
+    }
+
+    // Records equal to 'value' may exist left of a separator equal to 'value' (smaller ids) so
+    // descend into the first child whose separator is not less than 'value'
+    const auto valueLess = [](const Key& key, const NumericalVariant& v) { return key.mValue < v; };
+    while (!node->mLeaf)
+    {
+        InnerNode* inner = static_cast<InnerNode*>(node);
+        SizeT index = static_cast<SizeT>(std::lower_bound(inner->mKeys, inner->mKeys + inner->mCount, value, valueLess) - inner->mKeys);
+        node = inner->mChildren[index];
+    }
+
+    LeafNode* leaf = static_cast<LeafNode*>(node);
+    SizeT index = static_cast<SizeT>(std::lower_bound(leaf->mKeys, leaf->mKeys + leaf->mCount, value, valueLess) - leaf->mKeys);
+    return Iterator(leaf, index);
+}
+
+MemDBIndexTree::Iterator MemDBIndexTree::Begin() const
+{
+    Node* node = mRoot;
+    if (!node)
+    {
+        return Iterator();
+    }
+    while (!node->mLeaf)
+    {
+        node = static_cast<InnerNode*>(node)->mChildren[0];
+    }
+    return Iterator(static_cast<LeafNode*>(node), 0);
+}
+
+void MemDBIndexTree::BulkLoad(TVector<Key>& keys)
+{
+    Clear();
+    if (keys.empty())
+    {
+        return;
+    }
+    std::sort(keys.begin(), keys.end(), KeyLess);
+
+    // Build the leaves, distributing the records evenly so no leaf is left nearly empty.
+    TVector<Node*> level;
+    TVector<Key> levelKeys; // ** The smallest record of each node in 'level'
+    SizeT numNodes = (keys.size() + LEAF_BULK_FILL - 1) / LEAF_BULK_FILL;
+    level.reserve(numNodes);
+    levelKeys.reserve(numNodes);
+
+    LeafNode* prev = nullptr;
+    SizeT offset = 0;
+    for (SizeT i = 0; i < numNodes; ++i)
+    {
+        const SizeT count = (keys.size() / numNodes) + (i < (keys.size() % numNodes) ? 1 : 0);
+        LeafNode* leaf = AllocateLeaf();
+        std::copy(keys.begin() + offset, keys.begin() + offset + count, leaf->mKeys);
+        leaf->mCount = count;
+        leaf->mPrev = prev;
+        if (prev)
+        {
+            prev->mNext = leaf;
+        }
+        prev = leaf;
+        level.push_back(leaf);
+        levelKeys.push_back(keys[offset]);
+        offset += count;
+    }
+
+    // Build the inner levels until there is a single root.
+    const SizeT childrenPerNode = INNER_BULK_FILL + 1;
+    while (level.size() > 1)
+    {
+        numNodes = (level.size() + childrenPerNode - 1) / childrenPerNode;
+        TVector<Node*> parents;
+        TVector<Key> parentKeys;
+        parents.reserve(numNodes);
+        parentKeys.reserve(numNodes);
+
+        offset = 0;
+        for (SizeT i = 0; i < numNodes; ++i)
+        {
+            const SizeT count = (level.size() / numNodes) + (i < (level.size() % numNodes) ? 1 : 0);
+            InnerNode* inner = AllocateInner();
+            for (SizeT k = 0; k < count; ++k)
+            {
+                inner->mChildren[k] = level[offset + k];
+                if (k > 0)
+                {
+                    inner->mKeys[k - 1] = levelKeys[offset + k];
+                }
+            }
+            inner->mCount = count - 1;
+            parents.push_back(inner);
+            parentKeys.push_back(levelKeys[offset]);
+            offset += count;
+        }
+        level.swap(parents);
+        levelKeys.swap(parentKeys);
+    }
+
+    mRoot = level[0];
+    mSize = keys.size();
+}
+
+void MemDBIndexTree::CopyTo(TVector<Key>& outKeys) const
+{
+    outKeys.reserve(outKeys.size() + mSize);
+    for (Iterator it = Begin(); it.Valid(); ++it)
+    {
+        outKeys.push_back(*it);
+    }
+}
+
+bool MemDBIndexTree::Validate() const
+{
+    SizeT count = 0;
+    const Key* last = nullptr;
+    for (Iterator it = Begin(); it.Valid(); ++it)
+    {
+        if (last && !KeyLess(*last, *it))
+        {
+            return false;
+        }
+        last = &(*it);
+        ++count;
+    }
+    if (count != mSize)
+    {
+        return false;
+    }
+
+    // Verify each separator bounds its subtrees
+    struct Bounds
+    {
+        const Node* mNode;
+        const Key*  mLower;
+        const Key*  mUpper;
+    };
+    TVector<Bounds> stack;
+    if (mRoot)
+    {
+        stack.push_back({ mRoot, nullptr, nullptr });
+    }
+    while (!stack.empty())
+    {
+        Bounds bounds = stack.back();
+        stack.pop_back();
+        if (bounds.mNode->mLeaf)
+        {
+            const LeafNode* leaf = static_cast<const LeafNode*>(bounds.mNode);
+            for (SizeT i = 0; i < leaf->mCount; ++i)
+            {
+                if ((bounds.mLower && KeyLess(leaf->mKeys[i], *bounds.mLower)) || (bounds.mUpper && !KeyLess(leaf->mKeys[i], *bounds.mUpper)))
+                {
+                    return false;
+                }
+            }
+            continue;
+        }
+
+        const InnerNode* inner = static_cast<const InnerNode*>(bounds.mNode);
+        if (inner->mCount == 0)
+        {
+            return false;
+        }
+        for (SizeT i = 0; i <= inner->mCount; ++i)
+        {
+            const Key* lower = i == 0 ? bounds.mLower : &inner->mKeys[i - 1];
+            const Key* upper = i == inner->mCount ? bounds.mUpper : &inner->mKeys[i];
+            stack.push_back({ inner->mChildren[i], lower, upper });
+        }
+    }
+    return true;
+}
+
+void MemDBIndexTree::Clear()
+{
+    if (mRoot)
+    {
+        FreeRecursive(mRoot);
+        mRoot = nullptr;
+    }
+    mSize = 0;
+    Assert(mBytesReserved == 0);
+}
+
+MemDBIndexTree::LeafNode* MemDBIndexTree::AllocateLeaf()
+{
+    LeafNode* leaf = static_cast<LeafNode*>(LFAlloc(sizeof(LeafNode), alignof(LeafNode)));
+    CriticalAssert(leaf);
+    leaf->mCount = 0;
+    leaf->mLeaf = true;
+    leaf->mPrev = nullptr;
+    leaf->mNext = nullptr;
+    mBytesReserved += sizeof(LeafNode);
+    return leaf;
+}
+
+MemDBIndexTree::InnerNode* MemDBIndexTree::AllocateInner()
+{
+    InnerNode* inner = static_cast<InnerNode*>(LFAlloc(sizeof(InnerNode), alignof(InnerNode)));
+    CriticalAssert(inner);
+    inner->mCount = 0;
+    inner->mLeaf = false;
+    mBytesReserved += sizeof(InnerNode);
+    return inner;
+}
+
+void MemDBIndexTree::FreeNode(Node* node)
+{
+    mBytesReserved -= node->mLeaf ? sizeof(LeafNode) : sizeof(InnerNode);
+    LFFree(node);
+}
+
+void MemDBIndexTree::FreeRecursive(Node* node)
+{
+    if (!node->mLeaf)
+    {
+        InnerNode* inner = static_cast<InnerNode*>(node);
+        for (SizeT i = 0; i <= inner->mCount; ++i)
+        {
+            FreeRecursive(inner->mChildren[i]);
+        }
+    }
+    FreeNode(node);
+}
+
+bool MemDBIndexTree::InsertRecursive(Node* node, const Key& key, Key& outSplitKey, Node*& outSplitNode)
+{
+    outSplitNode = nullptr;
+    if (node->mLeaf)
+    {
+        LeafNode* leaf = static_cast<LeafNode*>(node);
+        SizeT index = KeyLowerBound(leaf->mKeys, leaf->mCount, key);
+        if (index < leaf->mCount && !KeyLess(key, leaf->mKeys[index]))
+        {
+            return false; // Duplicate (value, id)
+        }
+
+        if (leaf->mCount < LEAF_CAPACITY)
+        {
+            ArrayInsert(leaf->mKeys, leaf->mCount, index, key);
+            ++leaf->mCount;
+            return true;
+        }
+
+        // Split the upper half into a new leaf and insert into whichever side the key belongs.
+        LeafNode* right = AllocateLeaf();
+        const SizeT half = LEAF_CAPACITY / 2;
+        std::copy(leaf->mKeys + half, leaf->mKeys + LEAF_CAPACITY, right->mKeys);
+        right->mCount = LEAF_CAPACITY - half;
+        leaf->mCount = half;
+
+        right->mNext = leaf->mNext;
+        right->mPrev = leaf;
+        if (leaf->mNext)
+        {
+            leaf->mNext->mPrev = right;
+        }
+        leaf->mNext = right;
+
+        if (index > half)
+        {
+            ArrayInsert(right->mKeys, right->mCount, index - half, key);
+            ++right->mCount;
+        }
+        else
+        {
+            ArrayInsert(leaf->mKeys, leaf->mCount, index, key);
+            ++leaf->mCount;
+        }
+
+        outSplitKey = right->mKeys[0];
+        outSplitNode = right;
+        return true;
+    }
+
+    InnerNode* inner = static_cast<InnerNode*>(node);
+    const SizeT childIndex = KeyChildIndex(inner->mKeys, inner->mCount, key);
+    Key childSplitKey;
+    Node* childSplitNode = nullptr;
+    if (!InsertRecursive(inner->mChildren[childIndex], key, childSplitKey, childSplitNode))
+    {
+        return false;
+    }
+    if (!childSplitNode)
+    {
+        return true;
+    }
+
+    if (inner->mCount < INNER_CAPACITY)
+    {
+        ArrayInsert(inner->mKeys, inner->mCount, childIndex, childSplitKey);
+        ArrayInsert(inner->mChildren, inner->mCount + 1, childIndex + 1, childSplitNode);
+        ++inner->mCount;
+        return true;
+    }
+
+    // Split the inner node, the middle separator moves up to the parent.
+    Key keys[INNER_CAPACITY + 1];
+    Node* children[INNER_CAPACITY + 2];
+    std::copy(inner->mKeys, inner->mKeys + INNER_CAPACITY, keys);
+    std::copy(inner->mChildren, inner->mChildren + INNER_CAPACITY + 1, children);
+    ArrayInsert(keys, static_cast<SizeT>(INNER_CAPACITY), childIndex, childSplitKey);
+    ArrayInsert(children, static_cast<SizeT>(INNER_CAPACITY + 1), childIndex + 1, childSplitNode);
+
+    const SizeT total = INNER_CAPACITY + 1;
+    const SizeT middle = total / 2;
+    InnerNode* right = AllocateInner();
+
+    std::copy(keys, keys + middle, inner->mKeys);
+    std::copy(children, children + middle + 1, inner->mChildren);
+    inner->mCount = middle;
+
+    std::copy(keys + middle + 1, keys + total, right->mKeys);
+    std::copy(children + middle + 1, children + total + 1, right->mChildren);
+    right->mCount = total - middle - 1;
+
+    outSplitKey = keys[middle];
+    outSplitNode = right;
+    return true;
+}
+
+bool MemDBIndexTree::RemoveRecursive(Node* node, const Key& key)
+{
+    if (node->mLeaf)
+    {
+        LeafNode* leaf = static_cast<LeafNode*>(node);
+        SizeT index = KeyLowerBound(leaf->mKeys, leaf->mCount, key);
+        if (index >= leaf->mCount || KeyLess(key, leaf->mKeys[index]))
+        {
+            return false;
+        }
+        ArrayErase(leaf->mKeys, leaf->mCount, index);
+        --leaf->mCount;
+        return true;
+    }
+
+    InnerNode* inner = static_cast<InnerNode*>(node);
+    const SizeT childIndex = KeyChildIndex(inner->mKeys, inner->mCount, key);
+    Node* child = inner->mChildren[childIndex];
+    if (!RemoveRecursive(child, key))
+    {
+        return false;
+    }
+
+    const SizeT minCount = child->mLeaf ? LEAF_MIN : INNER_MIN;
+    if (child->mCount < minCount)
+    {
+        RebalanceChild(inner, childIndex);
+    }
+    return true;
+}
+
+void MemDBIndexTree::RebalanceChild(InnerNode* parent, SizeT childIndex)
+{
+    Node* child = parent->mChildren[childIndex];
+    Node* left = childIndex > 0 ? parent->mChildren[childIndex - 1] : nullptr;
+    Node* right = childIndex < parent->mCount ? parent->mChildren[childIndex + 1] : nullptr;
+    const SizeT minCount = child->mLeaf ? LEAF_MIN : INNER_MIN;
+
+    if (child->mLeaf)
+    {
+        LeafNode* leaf = static_cast<LeafNode*>(child);
+        LeafNode* leftLeaf = static_cast<LeafNode*>(left);
+        LeafNode* rightLeaf = static_cast<LeafNode*>(right);
+        if (leftLeaf && leftLeaf->mCount > minCount)
+        {
+            ArrayInsert(leaf->mKeys, leaf->mCount, 0, leftLeaf->mKeys[leftLeaf->mCount - 1]);
+            ++leaf->mCount;
+            --leftLeaf->mCount;
+            parent->mKeys[childIndex - 1] = leaf->mKeys[0];
+        }
+        else if (rightLeaf && rightLeaf->mCount > minCount)
+        {
+            leaf->mKeys[leaf->mCount++] = rightLeaf->mKeys[0];
+            ArrayErase(rightLeaf->mKeys, rightLeaf->mCount, 0);
+            --rightLeaf->mCount;
+            parent->mKeys[childIndex] = rightLeaf->mKeys[0];
+        }
+        else
+        {
+            // Merge with a sibling, always merging the right node into the left one.
+            SizeT separator = leftLeaf ? childIndex - 1 : childIndex;
+            LeafNode* into = leftLeaf ? leftLeaf : leaf;
+            LeafNode* from = leftLeaf ? leaf : rightLeaf;
+            std::copy(from->mKeys, from->mKeys + from->mCount, into->mKeys + into->mCount);
+            into->mCount += from->mCount;
+            into->mNext = from->mNext;
+            if (from->mNext)
+            {
+                from->mNext->mPrev = into;
+            }
+            ArrayErase(parent->mKeys, parent->mCount, separator);
+            ArrayErase(parent->mChildren, parent->mCount + 1, separator + 1);
+            --parent->mCount;
+            FreeNode(from);
+        }
+        return;
+    }
+
+    InnerNode* inner = static_cast<InnerNode*>(child);
+    InnerNode* leftInner = static_cast<InnerNode*>(left);
+    InnerNode* rightInner = static_cast<InnerNode*>(right);
+    if (leftInner && leftInner->mCount > minCount)
+    {
+        // Rotate right through the parent separator
+        ArrayInsert(inner->mKeys, inner->mCount, 0, parent->mKeys[childIndex - 1]);
+        ArrayInsert(inner->mChildren, inner->mCount + 1, 0, leftInner->mChildren[leftInner->mCount]);
+        ++inner->mCount;
+        parent->mKeys[childIndex - 1] = leftInner->mKeys[leftInner->mCount - 1];
+        --leftInner->mCount;
+    }
+    else if (rightInner && rightInner->mCount > minCount)
+    {
+        // Rotate left through the parent separator
+        inner->mKeys[inner->mCount] = parent->mKeys[childIndex];
+        inner->mChildren[inner->mCount + 1] = rightInner->mChildren[0];
+        ++inner->mCount;
+        parent->mKeys[childIndex] = rightInner->mKeys[0];
+        ArrayErase(rightInner->mKeys, rightInner->mCount, 0);
+        ArrayErase(rightInner->mChildren, rightInner->mCount + 1, 0);
+        --rightInner->mCount;
+    }
+    else
+    {
+        // Merge with a sibling, pulling the separator down between the two.
+        SizeT separator = leftInner ? childIndex - 1 : childIndex;
+        InnerNode* into = leftInner ? leftInner : inner;
+        InnerNode* from = leftInner ? inner : rightInner;
+        into->mKeys[into->mCount] = parent->mKeys[separator];
+        std::copy(from->mKeys, from->mKeys + from->mCount, into->mKeys + into->mCount + 1);
+        std::copy(from->mChildren, from->mChildren + from->mCount + 1, into->mChildren + into->mCount + 1);
+        into->mCount += from->mCount + 1;
+        ArrayErase(parent->mKeys, parent->mCount, separator);
+        ArrayErase(parent->mChildren, parent->mCount + 1, separator + 1);
+        --parent->mCount;
+        FreeNode(from);
+    }
+}
+
+// ** Control bytes, full slots store the low 7 bits of the hash.
+static const ByteT CONTROL_EMPTY = 0x80;
+static const ByteT CONTROL_DELETED = 0xFE;
+static const SizeT HASH_MIN_CAPACITY = MemDBHashIndex::GROUP_SIZE;
+
+LF_FORCE_INLINE static UInt32 LowestBit(UInt32 mask)
+{
+#if defined(LF_OS_WINDOWS)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<UInt32>(index);
+#else
+    return static_cast<UInt32>(__builtin_ctz(mask));
+#endif
+}
+
+// ** @returns Returns a bit mask of the slots in the group with the control byte
+LF_FORCE_INLINE static UInt32 GroupMatch(const ByteT* group, ByteT control)
+{
+    __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<UInt32>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(control)))));
+}
+// ** @returns Returns a bit mask of the empty or deleted slots in the group (both have the high bit set)
+LF_FORCE_INLINE static UInt32 GroupMatchFree(const ByteT* group)
+{
+    __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<UInt32>(_mm_movemask_epi8(ctrl));
+}
+
+LF_FORCE_INLINE static ByteT HashTag(UInt32 hash) { return static_cast<ByteT>(hash & 0x7F); }
+LF_FORCE_INLINE static SizeT HashGroup(UInt32 hash, SizeT groupMask) { return static_cast<SizeT>(hash >> 7) & groupMask; }
+
+template<typename CharT>
+static UInt64 HashString(UInt64 hash, const ByteT* bytes, SizeT size)
+{
+    const CharT* it = reinterpret_cast<const CharT*>(bytes);
+    const CharT* last = it + (size / sizeof(CharT));
+    for (; it != last && *it != 0; ++it)
+    {
+        const ByteT* charBytes = reinterpret_cast<const ByteT*>(it);
+        for (SizeT i = 0; i < sizeof(CharT); ++i)
+        {
+            hash = (hash ^ charBytes[i]) * FNV::FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+template<typename CharT>
+static bool StringEquals(const ByteT* a, const ByteT* b, SizeT size)
+{
+    const CharT* itA = reinterpret_cast<const CharT*>(a);
+    const CharT* itB = reinterpret_cast<const CharT*>(b);
+    const CharT* last = itA + (size / sizeof(CharT));
+    for (; itA != last; ++itA, ++itB)
+    {
+        if (*itA != *itB)
+        {
+            return false;
+        }
+        if (*itA == 0)
+        {
+            return true;
+        }
+    }
+    return true;
+}
+
+MemDBHashIndex::MemDBHashIndex()
+: mColumns()
+, mControl(nullptr)
+, mSlots(nullptr)
+, mCapacity(0)
+, mSize(0)
+, mDeleted(0)
+, mAllowDuplicates(false)
+{}
+
+MemDBHashIndex::MemDBHashIndex(MemDBHashIndex&& other)
+: mColumns(other.mColumns)
+, mControl(other.mControl)
+, mSlots(other.mSlots)
+, mCapacity(other.mCapacity)
+, mSize(other.mSize)
+, mDeleted(other.mDeleted)
+, mAllowDuplicates(other.mAllowDuplicates)
+{
+    other.mControl = nullptr;
+    other.mSlots = nullptr;
+    other.mCapacity = 0;
+    other.mSize = 0;
+    other.mDeleted = 0;
+}
+
+MemDBHashIndex::~MemDBHashIndex()
+{
+    Release();
+}
+
+MemDBHashIndex& MemDBHashIndex::operator=(MemDBHashIndex&& other)
+{
+    if (this != &other)
+    {
+        Release();
+        mColumns = other.mColumns;
+        mControl = other.mControl;
+        mSlots = other.mSlots;
+        mCapacity = other.mCapacity;
+        mSize = other.mSize;
+        mDeleted = other.mDeleted;
+        mAllowDuplicates = other.mAllowDuplicates;
+        other.mControl = nullptr;
+        other.mSlots = nullptr;
+        other.mCapacity = 0;
+        other.mSize = 0;
+        other.mDeleted = 0;
+    }
+    return *this;
+}
+
+bool MemDBHashIndex::Initialize(const KeyColumn* columns, SizeT numColumns, bool allowDuplicates)
+{
+    if (!columns || numColumns == 0 || mSize > 0)
+    {
+        return false;
+    }
+
+    mColumns.resize(0);
+    for (SizeT i = 0; i < numColumns; ++i)
+    {
+        if (columns[i].mSize == 0)
+        {
+            return false;
+        }
+        mColumns.push_back(columns[i]);
+    }
+    mAllowDuplicates = allowDuplicates;
+    return true;
+}
+
+void MemDBHashIndex::Insert(EntryID id, const ByteT* entryBytes)
+{
+    if ((mSize + mDeleted + 1) * 8 > mCapacity * 7)
+    {
+        // Grow if we're mostly full, otherwise just clean up the tombstones.
+        Rehash((mSize + 1) * 8 > mCapacity * 4 ? Max(mCapacity * 2, HASH_MIN_CAPACITY) : mCapacity);
+    }
+
+    const UInt32 hash = Hash(entryBytes);
+    const SizeT groupMask = (mCapacity / GROUP_SIZE) - 1;
+    SizeT group = HashGroup(hash, groupMask);
+    for (SizeT probe = 1; ; ++probe)
+    {
+        UInt32 mask = GroupMatchFree(mControl + group * GROUP_SIZE);
+        if (mask != 0)
+        {
+            SizeT slot = group * GROUP_SIZE + LowestBit(mask);
+            if (mControl[slot] == CONTROL_DELETED)
+            {
+                --mDeleted;
+            }
+            mControl[slot] = HashTag(hash);
+            mSlots[slot].mID = id;
+            mSlots[slot].mHash = hash;
+            ++mSize;
+            return;
+        }
+        group = (group + probe) & groupMask;
+    }
+}
+
+bool MemDBHashIndex::Remove(EntryID id, const ByteT* entryBytes)
+{
+    if (mSize == 0)
+    {
+        return false;
+    }
+
+    const UInt32 hash = Hash(entryBytes);
+    const SizeT groupMask = (mCapacity / GROUP_SIZE) - 1;
+    SizeT group = HashGroup(hash, groupMask);
+    for (SizeT probe = 1; probe <= groupMask + 1; ++probe)
+    {
+        const ByteT* control = mControl + group * GROUP_SIZE;
+        for (UInt32 mask = GroupMatch(control, HashTag(hash)); mask != 0; mask &= mask - 1)
+        {
+            SizeT slot = group * GROUP_SIZE + LowestBit(mask);
+            if (mSlots[slot].mID == id && mSlots[slot].mHash == hash)
+            {
+                // If the group has an empty slot no probe continues past it, so the slot can be empty rather than deleted.
+                if (GroupMatch(control, CONTROL_EMPTY) != 0)
+                {
+                    mControl[slot] = CONTROL_EMPTY;
+                }
+                else
+                {
+                    mControl[slot] = CONTROL_DELETED;
+                    ++mDeleted;
+                }
+                --mSize;
+                return true;
+            }
+        }
+        if (GroupMatch(control, CONTROL_EMPTY) != 0)
+        {
+            break;
+        }
+        group = (group + probe) & groupMask;
+    }
+    return false;
+}
+
+MemDBHashIndex::EntryID MemDBHashIndex::FindOne(const ByteT* tableBase, SizeT entrySize, const ByteT* keyBytes) const
+{
+    if (mSize == 0)
+    {
+        return MemDBTypes::INVALID_ENTRY_ID;
+    }
+
+    const UInt32 hash = Hash(keyBytes);
+    const SizeT groupMask = (mCapacity / GROUP_SIZE) - 1;
+    SizeT group = HashGroup(hash, groupMask);
+    for (SizeT probe = 1; probe <= groupMask + 1; ++probe)
+    {
+        const ByteT* control = mControl + group * GROUP_SIZE;
+        for (UInt32 mask = GroupMatch(control, HashTag(hash)); mask != 0; mask &= mask - 1)
+        {
+            const Slot& slot = mSlots[group * GROUP_SIZE + LowestBit(mask)];
+            if (slot.mHash == hash && KeyEquals(tableBase + (slot.mID * entrySize), keyBytes))
+            {
+                return slot.mID;
+            }
+        }
+        if (GroupMatch(control, CONTROL_EMPTY) != 0)
+        {
+            break;
+        }
+        group = (group + probe) & groupMask;
+    }
+    return MemDBTypes::INVALID_ENTRY_ID;
+}
+
+void MemDBHashIndex::FindAll(const ByteT* tableBase, SizeT entrySize, const ByteT* keyBytes, TVector<EntryID>& outIDs) const
+{
+    if (mSize == 0)
+    {
+        return;
+    }
+
+    const UInt32 hash = Hash(keyBytes);
+    const SizeT groupMask = (mCapacity / GROUP_SIZE) - 1;
+    SizeT group = HashGroup(hash, groupMask);
+    for (SizeT probe = 1; probe <= groupMask + 1; ++probe)
+    {
+        const ByteT* control = mControl + group * GROUP_SIZE;
+        for (UInt32 mask = GroupMatch(control, HashTag(hash)); mask != 0; mask &= mask - 1)
+        {
+            const Slot& slot = mSlots[group * GROUP_SIZE + LowestBit(mask)];
+            if (slot.mHash == hash && KeyEquals(tableBase + (slot.mID * entrySize), keyBytes))
+            {
+                outIDs.push_back(slot.mID);
+            }
+        }
+        if (GroupMatch(control, CONTROL_EMPTY) != 0)
+        {
+            break;
+        }
+        group = (group + probe) & groupMask;
+    }
+}
+
+bool MemDBHashIndex::KeyEquals(const ByteT* a, const ByteT* b) const
+{
+    for (const KeyColumn& column : mColumns)
+    {
+        const ByteT* columnA = a + column.mOffset;
+        const ByteT* columnB = b + column.mOffset;
+        switch (column.mType)
+        {
+            case MemDBTypes::HKT_CHAR:
+                if (!StringEquals<char>(columnA, columnB, column.mSize))
+                {
+                    return false;
+                }
+                break;
+            case MemDBTypes::HKT_WCHAR:
+                if (!StringEquals<wchar_t>(columnA, columnB, column.mSize))
+                {
+                    return false;
+                }
+                break;
+            default:
+                if (memcmp(columnA, columnB, column.mSize) != 0)
+                {
+                    return false;
+                }
+                break;
+        }
+    }
+    return true;
+}
+
+UInt32 MemDBHashIndex::Hash(const ByteT* entryBytes) const
+{
+    UInt64 hash = FNV::FNV_OFFSET_BASIS;
+    for (const KeyColumn& column : mColumns)
+    {
+        const ByteT* bytes = entryBytes + column.mOffset;
+        switch (column.mType)
+        {
+            case MemDBTypes::HKT_CHAR:
+                hash = HashString<char>(hash, bytes, column.mSize);
+                break;
+            case MemDBTypes::HKT_WCHAR:
+                hash = HashString<wchar_t>(hash, bytes, column.mSize);
+                break;
+            default:
+                for (SizeT i = 0; i < column.mSize; ++i)
+                {
+                    hash = (hash ^ bytes[i]) * FNV::FNV_PRIME;
+                }
+                break;
+        }
+        // Separate the columns so ("ab", "c") and ("a", "bc") don't collide
+        hash = (hash ^ 0xFF) * FNV::FNV_PRIME;
+    }
+
+    // FNV doesn't mix the low bits well, finalize so the tag and group bits are both usable.
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return static_cast<UInt32>(hash);
+}
+
+void MemDBHashIndex::Reserve(SizeT count)
+{
+    SizeT capacity = Max(mCapacity, HASH_MIN_CAPACITY);
+    while (count * 8 > capacity * 7)
+    {
+        capacity *= 2;
+    }
+    if (capacity != mCapacity)
+    {
+        Rehash(capacity);
+    }
+}
+
+void MemDBHashIndex::Clear()
+{
+    if (mControl)
+    {
+        memset(mControl, CONTROL_EMPTY, mCapacity);
+    }
+    mSize = 0;
+    mDeleted = 0;
+}
+
+bool MemDBHashIndex::HasColumns(const KeyColumn* columns, SizeT numColumns) const
+{
+    if (numColumns != mColumns.size())
+    {
+        return false;
+    }
+    for (SizeT i = 0; i < numColumns; ++i)
+    {
+        if (columns[i].mOffset != mColumns[i].mOffset || columns[i].mSize != mColumns[i].mSize || columns[i].mType != mColumns[i].mType)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+SizeT MemDBHashIndex::GetBytesReserved() const
+{
+    return mCapacity * (sizeof(ByteT) + sizeof(Slot));
+}
+
+void MemDBHashIndex::Rehash(SizeT capacity)
+{
+    Assert(capacity >= HASH_MIN_CAPACITY && (capacity & (capacity - 1)) == 0);
+    ByteT* oldControl = mControl;
+    Slot* oldSlots = mSlots;
+    const SizeT oldCapacity = mCapacity;
+
+    mControl = static_cast<ByteT*>(LFAlloc(capacity, GROUP_SIZE));
+    mSlots = static_cast<Slot*>(LFAlloc(capacity * sizeof(Slot), alignof(Slot)));
+    CriticalAssert(mControl && mSlots);
+    memset(mControl, CONTROL_EMPTY, capacity);
+    mCapacity = capacity;
+    mDeleted = 0;
+
+    const SizeT groupMask = (mCapacity / GROUP_SIZE) - 1;
+    for (SizeT i = 0; i < oldCapacity; ++i)
+    {
+        if ((oldControl[i] & CONTROL_EMPTY) != 0)
+        {
+            continue;
+        }
+        const Slot& item = oldSlots[i];
+        SizeT group = HashGroup(item.mHash, groupMask);
+        for (SizeT probe = 1; ; ++probe)
+        {
+            UInt32 mask = GroupMatchFree(mControl + group * GROUP_SIZE);
+            if (mask != 0)
+            {
+                SizeT slot = group * GROUP_SIZE + LowestBit(mask);
+                mControl[slot] = HashTag(item.mHash);
+                mSlots[slot] = item;
+                break;
+            }
+            group = (group + probe) & groupMask;
+        }
+    }
+
+    if (oldControl)
+    {
+        LFFree(oldControl);
+        LFFree(oldSlots);
+    }
+}
+
+void MemDBHashIndex::Release()
+{
+    if (mControl)
+    {
+        LFFree(mControl);
+        LFFree(mSlots);
+        mControl = nullptr;
+        mSlots = nullptr;
+    }
+    mCapacity = 0;
+    mSize = 0;
+    mDeleted = 0;
+}
+
+} // namespace lf
@@ -0,0 +1,266 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Common/Types.h"
+#include "Core/Common/API.h"
+#include "Core/Utility/Array.h"
+#include "Core/IO/MemDB.h"
+#include "Core/Utility/NumericalVariant.h"
+
+namespace lf
+{
+namespace MemDBTypes
+{
+
+// ********************************************************************
+// An index record mapping an indexed value to the entry it came from.
+// ********************************************************************
+struct EntryIndex
+{
+    bool operator==(const EntryIndex& other) const
+    {
+        return mValue == other.mValue;
+    }
+
+    bool operator<(const EntryIndex& other) const
+    {
+        return mValue < other.mValue;
+    }
+    bool operator>(const EntryIndex& other) const
+    {
+        return mValue > other.mValue;
+    }
+
+    NumericalVariant mValue;
+    EntryID          mID;
+};
+
+} // namespace MemDBTypes
+
+// ********************************************************************
+// Ordered B+tree of EntryIndex records used by the MemDB secondary indices.
+//
+// Records are ordered by (value, id) so duplicate values are allowed
+// and every record is unique, which allows O(log n) insert and remove
+// without scanning for the id. The leaves are linked so range queries
+// iterate the records in order.
+//
+// Nodes are sized to a handful of cache lines, leaves hold LEAF_CAPACITY
+// records and inner nodes hold INNER_CAPACITY separators.
+//
+// note: The tree is not threadsafe, MemDB guards it with the table lock.
+// ********************************************************************
+class LF_CORE_API MemDBIndexTree
+{
+public:
+    using Key = MemDBTypes::EntryIndex;
+    enum : SizeT
+    {
+        LEAF_CAPACITY = 32,
+        INNER_CAPACITY = 32
+    };
+    struct Node;
+    struct LeafNode;
+    struct InnerNode;
+
+    // ********************************************************************
+    // Forward iterator over the records of the tree in order. The iterator
+    // is invalidated by any modification to the tree.
+    // ********************************************************************
+    class Iterator
+    {
+    public:
+        Iterator() : mLeaf(nullptr), mIndex(0) {}
+        Iterator(const LeafNode* leaf, SizeT index);
+
+        bool Valid() const { return mLeaf != nullptr; }
+        const Key& operator*() const;
+        const Key* operator->() const { return &(**this); }
+        Iterator& operator++();
+    private:
+        void Normalize();
+        const LeafNode* mLeaf;
+        SizeT           mIndex;
+    };
+
+    MemDBIndexTree();
+    MemDBIndexTree(MemDBIndexTree&& other);
+    ~MemDBIndexTree();
+    MemDBIndexTree& operator=(MemDBIndexTree&& other);
+
+    // ********************************************************************
+    // Insert the record into the tree.
+    // @returns Returns false if the (value, id) pair is already in the tree.
+    // ********************************************************************
+    bool Insert(const Key& key);
+    // ********************************************************************
+    // Remove the record matching the (value, id) pair from the tree.
+    // @returns Returns true if the record was removed.
+    // ********************************************************************
+    bool Remove(const Key& key);
+    // ********************************************************************
+    // @returns Returns true if there is at least one record with the value.
+    // ********************************************************************
+    bool Contains(const NumericalVariant& value) const;
+    // ********************************************************************
+    // @returns Returns an iterator to the first record with a value not less
+    // than 'value'.
+    // ********************************************************************
+    Iterator LowerBound(const NumericalVariant& value) const;
+    // ********************************************************************
+    // @returns Returns an iterator to the first record.
+    // ********************************************************************
+    Iterator Begin() const;
+    // ********************************************************************
+    // Replaces the contents of the tree with the records, the tree is built
+    // bottom-up in O(n) after sorting the records.
+    //
+    // @param keys -- The records to load, sorted in place. Records must be unique.
+    // ********************************************************************
+    void BulkLoad(TVector<Key>& keys);
+    // ********************************************************************
+    // Appends all the records to 'outKeys' in order.
+    // ********************************************************************
+    void CopyTo(TVector<Key>& outKeys) const;
+    // ********************************************************************
+    // @returns Returns true if the records are in strictly ascending order
+    // and the separators bound their subtrees. (Used by tests)
+    // ********************************************************************
+    bool Validate() const;
+
+    void Clear();
+    SizeT Size() const { return mSize; }
+    bool Empty() const { return mSize == 0; }
+    SizeT GetBytesReserved() const { return mBytesReserved; }
+private:
+    MemDBIndexTree(const MemDBIndexTree&) = delete;
+    MemDBIndexTree& operator=(const MemDBIndexTree&) = delete;
+
+    LeafNode* AllocateLeaf();
+    InnerNode* AllocateInner();
+    void FreeNode(Node* node);
+    void FreeRecursive(Node* node);
+
+    bool InsertRecursive(Node* node, const Key& key, Key& outSplitKey, Node*& outSplitNode);
+    bool RemoveRecursive(Node* node, const Key& key);
+    void RebalanceChild(InnerNode* parent, SizeT childIndex);
+
+    Node* mRoot;
+    SizeT mSize;
+    SizeT mBytesReserved;
+};
+
+// ********************************************************************
+// Open addressing hash table of EntryIDs keyed on one or more columns
+// of the entry, used by the MemDB hash indices.
+//
+// The table stores a 7 bit tag of each hash in a control byte array that
+// is probed GROUP_SIZE slots at a time with SSE2, only slots with a
+// matching tag have their key compared with the entry in the table.
+// Keys are not copied into the index, lookups compare against the
+// table data directly.
+//
+// note: The index is not threadsafe, MemDB guards it with the table lock.
+// ********************************************************************
+class LF_CORE_API MemDBHashIndex
+{
+public:
+    using EntryID = MemDBTypes::EntryID;
+    using KeyColumn = MemDBTypes::HashKeyColumn;
+    enum : SizeT { GROUP_SIZE = 16 };
+
+    MemDBHashIndex();
+    MemDBHashIndex(MemDBHashIndex&& other);
+    ~MemDBHashIndex();
+    MemDBHashIndex& operator=(MemDBHashIndex&& other);
+
+    // ********************************************************************
+    // Sets the key columns of the index, the index must be empty.
+    // @returns Returns false if the columns are invalid.
+    // ********************************************************************
+    bool Initialize(const KeyColumn* columns, SizeT numColumns, bool allowDuplicates);
+    // ********************************************************************
+    // Insert the entry into the index, uniqueness is not checked.
+    // @param entryBytes -- The entry data the key columns are read from
+    // ********************************************************************
+    void Insert(EntryID id, const ByteT* entryBytes);
+    // ********************************************************************
+    // Remove the entry from the index.
+    // @param entryBytes -- The entry data when it was inserted
+    // ********************************************************************
+    bool Remove(EntryID id, const ByteT* entryBytes);
+    // ********************************************************************
+    // @param tableBase -- Pointer to the first entry of the table
+    // @param entrySize -- Size of each entry in the table
+    // @param keyBytes -- Entry with the key columns set
+    // @returns Returns the id of the first entry with an equal key or INVALID_ENTRY_ID
+    // ********************************************************************
+    EntryID FindOne(const ByteT* tableBase, SizeT entrySize, const ByteT* keyBytes) const;
+    // ********************************************************************
+    // Appends the ids of all entries with an equal key to 'outIDs'
+    // ********************************************************************
+    void FindAll(const ByteT* tableBase, SizeT entrySize, const ByteT* keyBytes, TVector<EntryID>& outIDs) const;
+    // ********************************************************************
+    // @returns Returns true if the key columns of 'a' and 'b' are equal.
+    // ********************************************************************
+    bool KeyEquals(const ByteT* a, const ByteT* b) const;
+    // ********************************************************************
+    // @returns Returns the hash of the key columns of the entry.
+    // ********************************************************************
+    UInt32 Hash(const ByteT* entryBytes) const;
+    // ********************************************************************
+    // Ensure the index can hold 'count' entries without rehashing.
+    // ********************************************************************
+    void Reserve(SizeT count);
+    // ********************************************************************
+    // Removes all entries, the key columns are kept.
+    // ********************************************************************
+    void Clear();
+
+    bool HasColumns(const KeyColumn* columns, SizeT numColumns) const;
+    const TVector<KeyColumn>& GetColumns() const { return mColumns; }
+    bool AllowDuplicates() const { return mAllowDuplicates; }
+    SizeT Size() const { return mSize; }
+    SizeT Capacity() const { return mCapacity; }
+    SizeT GetBytesReserved() const;
+private:
+    MemDBHashIndex(const MemDBHashIndex&) = delete;
+    MemDBHashIndex& operator=(const MemDBHashIndex&) = delete;
+
+    struct Slot
+    {
+        EntryID mID;
+        UInt32  mHash;
+    };
+
+    void Rehash(SizeT capacity);
+    void Release();
+
+    TVector<KeyColumn> mColumns;
+    ByteT*             mControl;
+    Slot*              mSlots;
+    SizeT              mCapacity;
+    SizeT              mSize;
+    SizeT              mDeleted;
+    bool               mAllowDuplicates;
+};
+
+} // namespace lf
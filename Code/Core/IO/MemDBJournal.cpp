@@ -0,0 +1,348 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "MemDBJournal.h"
+#include "Core/Platform/FileSystem.h"
+#include "Core/String/StringCommon.h"
+#include "Core/Utility/Crc32.h"
+#include "Core/Utility/Log.h"
+#include <algorithm>
+
+namespace lf
+{
+
+static const UInt32 JOURNAL_MAGIC = 0x4C4A4442; // 'BDJL'
+static const UInt32 JOURNAL_VERSION = 1;
+static const SizeT  JOURNAL_SLOTS = 2;
+
+struct JournalFileHeader
+{
+    UInt32 mMagic;
+    UInt32 mVersion;
+    UInt64 mGeneration;
+};
+
+struct JournalRecordHeader
+{
+    // ** Crc32 of the record header (excluding the crc) and the record bytes.
+    UInt32 mCrc;
+    UInt32 mSize;
+    UInt64 mTableHash;
+    UInt32 mEntryID;
+    UInt32 mType;
+};
+
+static UInt32 JournalCrc(const JournalRecordHeader& header, const ByteT* bytes, SizeT size)
+{
+    UInt32 crc = Crc32Update(0, reinterpret_cast<const ByteT*>(&header) + sizeof(header.mCrc), sizeof(header) - sizeof(header.mCrc));
+    return Crc32Update(crc, bytes, size);
+}
+
+static bool ReadJournalFile(const String& filename, JournalFileHeader& outHeader, TVector<ByteT>& outBytes)
+{
+    File file;
+    if (!file.Open(filename, FF_READ | FF_SHARE_READ | FF_SHARE_WRITE, FILE_OPEN_EXISTING))
+    {
+        return false;
+    }
+
+    const SizeT size = static_cast<SizeT>(file.GetSize());
+    if (size < sizeof(JournalFileHeader) || file.Read(&outHeader, sizeof(outHeader)) != sizeof(outHeader))
+    {
+        return false;
+    }
+
+    if (outHeader.mMagic != JOURNAL_MAGIC || outHeader.mVersion != JOURNAL_VERSION)
+    {
+        return false;
+    }
+
+    outBytes.resize(size - sizeof(JournalFileHeader));
+    return outBytes.empty() || file.Read(outBytes.data(), outBytes.size()) == outBytes.size();
+}
+
+MemDBJournal::MemDBJournal()
+: mAppendLock()
+, mWriteLock()
+, mPending()
+, mWriting()
+, mPath()
+, mFile()
+, mPreviousFile()
+, mGeneration(0)
+, mSyncToDisk(true)
+, mAppendedSequence(0)
+, mCommittedSequence(0)
+, mFileBytes(0)
+{
+    mWriteLock.Initialize();
+}
+
+MemDBJournal::~MemDBJournal()
+{
+    Close();
+}
+
+bool MemDBJournal::Open(const String& path, bool syncToDisk)
+{
+    Close();
+    Delete(path);
+
+    ScopedCriticalSection lock(mWriteLock);
+    mPath = path;
+    mSyncToDisk = syncToDisk;
+    AtomicStore(&mAppendedSequence, 0);
+    AtomicStore(&mCommittedSequence, 0);
+    return OpenGeneration(1);
+}
+
+void MemDBJournal::Close()
+{
+    if (!IsOpen())
+    {
+        return;
+    }
+
+    ScopedCriticalSection lock(mWriteLock);
+    if (!WritePending())
+    {
+        gSysLog.Error(LogMessage("Closing the MemDB journal with uncommitted records ") << mPath);
+    }
+    mFile.Close();
+    mPreviousFile.Close();
+    mPending.clear();
+    mWriting.clear();
+    AtomicStore(&mFileBytes, 0);
+}
+
+UInt64 MemDBJournal::Append(RecordType type, UInt64 tableHash, UInt32 entryID, const ByteT* bytes, SizeT size)
+{
+    JournalRecordHeader header;
+    header.mSize = static_cast<UInt32>(size);
+    header.mTableHash = tableHash;
+    header.mEntryID = entryID;
+    header.mType = static_cast<UInt32>(type);
+    header.mCrc = JournalCrc(header, bytes, size);
+
+    ScopeLock lock(mAppendLock);
+    const SizeT offset = mPending.size();
+    mPending.resize(offset + sizeof(header) + size);
+    memcpy(&mPending[offset], &header, sizeof(header));
+    if (size > 0)
+    {
+        memcpy(&mPending[offset + sizeof(header)], bytes, size);
+    }
+    return static_cast<UInt64>(AtomicIncrement64(&mAppendedSequence));
+}
+
+bool MemDBJournal::Commit(UInt64 sequence)
+{
+    if (GetCommittedSequence() >= sequence)
+    {
+        return true;
+    }
+
+    ScopedCriticalSection lock(mWriteLock);
+    // Group Commit: Another thread may have written our record while we waited.
+    if (GetCommittedSequence() >= sequence)
+    {
+        return true;
+    }
+    return WritePending();
+}
+
+bool MemDBJournal::CommitAll()
+{
+    return Commit(GetAppendedSequence());
+}
+
+bool MemDBJournal::BeginCheckpoint()
+{
+    ScopedCriticalSection lock(mWriteLock);
+    if (!mFile.IsOpen())
+    {
+        return false;
+    }
+
+    if (!WritePending())
+    {
+        return false;
+    }
+
+    // The last checkpoint failed to save the tables, retry it. The current file only holds records
+    // appended since that checkpoint began, both files are kept until the tables are saved.
+    if (mPreviousFile.IsOpen())
+    {
+        return true;
+    }
+    return OpenGeneration(mGeneration + 1);
+}
+
+void MemDBJournal::EndCheckpoint()
+{
+    ScopedCriticalSection lock(mWriteLock);
+    if (mPreviousFile.IsOpen())
+    {
+        mPreviousFile.Close();
+        FileSystem::FileDelete(GetFilename(mPath, static_cast<SizeT>((mGeneration - 1) % JOURNAL_SLOTS)));
+    }
+}
+
+SizeT MemDBJournal::Replay(const String& path, ReplayCallback callback, void* userData)
+{
+    struct JournalFile
+    {
+        JournalFileHeader mHeader;
+        TVector<ByteT>    mBytes;
+    };
+
+    JournalFile files[JOURNAL_SLOTS];
+    SizeT numFiles = 0;
+    for (SizeT slot = 0; slot < JOURNAL_SLOTS; ++slot)
+    {
+        if (ReadJournalFile(GetFilename(path, slot), files[numFiles].mHeader, files[numFiles].mBytes))
+        {
+            ++numFiles;
+        }
+    }
+    std::sort(files, files + numFiles, [](const JournalFile& a, const JournalFile& b) { return a.mHeader.mGeneration < b.mHeader.mGeneration; });
+
+    SizeT numRecords = 0;
+    for (SizeT i = 0; i < numFiles; ++i)
+    {
+        const TVector<ByteT>& bytes = files[i].mBytes;
+        SizeT offset = 0;
+        while (offset + sizeof(JournalRecordHeader) <= bytes.size())
+        {
+            JournalRecordHeader header;
+            memcpy(&header, &bytes[offset], sizeof(header));
+            const SizeT recordSize = sizeof(header) + header.mSize;
+            if (offset + recordSize > bytes.size())
+            {
+                break; // Torn write
+            }
+
+            const ByteT* recordBytes = header.mSize > 0 ? &bytes[offset + sizeof(header)] : nullptr;
+            if (JournalCrc(header, recordBytes, header.mSize) != header.mCrc || header.mType > RECORD_DELETE)
+            {
+                break; // Corrupt record
+            }
+
+            Record record;
+            record.mTableHash = header.mTableHash;
+            record.mEntryID = header.mEntryID;
+            record.mType = static_cast<RecordType>(header.mType);
+            record.mBytes = recordBytes;
+            record.mSize = header.mSize;
+            callback(record, userData);
+
+            ++numRecords;
+            offset += recordSize;
+        }
+    }
+    return numRecords;
+}
+
+void MemDBJournal::Delete(const String& path)
+{
+    for (SizeT slot = 0; slot < JOURNAL_SLOTS; ++slot)
+    {
+        String filename = GetFilename(path, slot);
+        if (FileSystem::FileExists(filename))
+        {
+            FileSystem::FileDelete(filename);
+        }
+    }
+}
+
+String MemDBJournal::GetFilename(const String& path, SizeT slot)
+{
+    return path + ".journal" + ToString(slot);
+}
+
+bool MemDBJournal::OpenGeneration(UInt64 generation)
+{
+    File file;
+    if (!file.Open(GetFilename(mPath, static_cast<SizeT>(generation % JOURNAL_SLOTS)), FF_WRITE | FF_SHARE_READ, FILE_OPEN_CREATE_NEW))
+    {
+        return false;
+    }
+
+    JournalFileHeader header;
+    header.mMagic = JOURNAL_MAGIC;
+    header.mVersion = JOURNAL_VERSION;
+    header.mGeneration = generation;
+    if (file.Write(&header, sizeof(header)) != sizeof(header))
+    {
+        return false;
+    }
+
+    if (mSyncToDisk)
+    {
+        file.Flush();
+    }
+
+    mPreviousFile = std::move(mFile);
+    mFile = std::move(file);
+    mGeneration = generation;
+    AtomicStore(&mFileBytes, static_cast<Atomic64>(sizeof(header)));
+    return true;
+}
+
+bool MemDBJournal::WritePending()
+{
+    // note: Called with the write lock acquired, appends only contend on the swap.
+    // note: Records from a failed write stay in mWriting and are written ahead of the new records on the next
+    //       commit, the committed sequence does not advance past them until they reach the file.
+    Atomic64 sequence = 0;
+    {
+        ScopeLock lock(mAppendLock);
+        if (mWriting.empty())
+        {
+            mWriting.swap(mPending);
+        }
+        else
+        {
+            mWriting.insert(mWriting.end(), mPending.begin(), mPending.end());
+            mPending.resize(0);
+        }
+        sequence = AtomicLoad(&mAppendedSequence);
+    }
+
+    if (!mWriting.empty())
+    {
+        bool written = mFile.Write(mWriting.data(), mWriting.size()) == mWriting.size();
+        written = written && (!mSyncToDisk || mFile.Flush());
+        if (!written)
+        {
+            // Drop any partial record so the retry appends at the last committed record.
+            gSysLog.Error(LogMessage("Failed to write to the MemDB journal ") << mPath);
+            mFile.SetCursor(static_cast<FileCursor>(AtomicLoad(&mFileBytes)), FileCursorMode::FILE_CURSOR_BEGIN, true);
+            return false;
+        }
+        AtomicAdd64(&mFileBytes, static_cast<Atomic64>(mWriting.size()));
+        mWriting.resize(0);
+    }
+    AtomicStore(&mCommittedSequence, sequence);
+    return true;
+}
+
+} // namespace lf
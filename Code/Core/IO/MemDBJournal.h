@@ -0,0 +1,183 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Common/Types.h"
+#include "Core/Common/API.h"
+#include "Core/Platform/Atomic.h"
+#include "Core/Platform/CriticalSection.h"
+#include "Core/Platform/File.h"
+#include "Core/Platform/SpinLock.h"
+#include "Core/String/String.h"
+#include "Core/Utility/Array.h"
+
+namespace lf
+{
+
+// ********************************************************************
+// Configuration of the MemDB write-ahead journal.
+// ********************************************************************
+struct MemDBJournalConfig
+{
+    MemDBJournalConfig()
+    : mGroupCommitMilliseconds(10)
+    , mCheckpointBytes(8 * 1024 * 1024)
+    , mSyncToDisk(true)
+    , mBackgroundThread(true)
+    {}
+    // ** How often the background thread writes pending records to the journal.
+    SizeT mGroupCommitMilliseconds;
+    // ** The journal is folded into the table files once it grows beyond this size.
+    SizeT mCheckpointBytes;
+    // ** Flush the journal file to disk on commit, otherwise only the OS buffers are written.
+    bool  mSyncToDisk;
+    // ** Run group commit/checkpoints on a background thread, otherwise it's up to the user to call
+    //    MemDB::CommitJournal/MemDB::Checkpoint.
+    bool  mBackgroundThread;
+};
+
+// ********************************************************************
+// Append-only log of MemDB insert/update/delete records.
+//
+// Records are appended to an in-memory buffer and written to the
+// journal file with one sequential write on commit. Threads that commit
+// at the same time share the write (group commit): the first thread
+// writes everything appended so far and the others find their record
+// already durable.
+//
+// Each record stores the full entry image so replay is idempotent, a
+// record is applied by writing the image over the entry regardless of
+// the state of the table.
+//
+// The journal alternates between two files (<path>.journal0/1) tagged
+// with a generation. A checkpoint rotates to the other file, saves the
+// tables and then deletes the old file. Recovery replays whichever
+// files exist in generation order.
+//
+// File Format:
+//      FileHeader { Magic, Version, Generation }
+//      Record { Crc32, Size, TableHash, EntryID, Type } + Size bytes
+//      ...
+//
+// A torn or corrupt record (crc mismatch) ends the replay of a file.
+// ********************************************************************
+class LF_CORE_API MemDBJournal
+{
+public:
+    enum RecordType
+    {
+        RECORD_INSERT,
+        RECORD_UPDATE,
+        RECORD_DELETE
+    };
+
+    struct Record
+    {
+        UInt64       mTableHash;
+        UInt32       mEntryID;
+        RecordType   mType;
+        const ByteT* mBytes;
+        SizeT        mSize;
+    };
+    using ReplayCallback = void(*)(const Record&, void*);
+
+    MemDBJournal();
+    ~MemDBJournal();
+
+    // ********************************************************************
+    // Deletes any existing journal files and starts a new journal at 'path'
+    // @returns Returns false if the journal file could not be created.
+    // ********************************************************************
+    bool Open(const String& path, bool syncToDisk);
+    // ********************************************************************
+    // Commits pending records and closes the journal file. The journal
+    // file is kept for recovery.
+    // ********************************************************************
+    void Close();
+    bool IsOpen() const { return mFile.IsOpen(); }
+
+    // ********************************************************************
+    // Appends a record to the pending buffer, the record is not durable
+    // until it is committed.
+    // @returns Returns the sequence number of the record.
+    // ********************************************************************
+    UInt64 Append(RecordType type, UInt64 tableHash, UInt32 entryID, const ByteT* bytes, SizeT size);
+    // ********************************************************************
+    // Ensure the record with the sequence and all records before it are
+    // written to the journal file.
+    // @returns Returns false if the write failed, the records are kept
+    //          and retried by the next commit.
+    // ********************************************************************
+    bool Commit(UInt64 sequence);
+    bool CommitAll();
+
+    // ********************************************************************
+    // Begin a checkpoint, commits the pending records and switches to the
+    // next journal file. Records appended from this point are written to
+    // the new file. If the last checkpoint was never ended the checkpoint
+    // is retried without switching files.
+    // ********************************************************************
+    bool BeginCheckpoint();
+    // ********************************************************************
+    // End a checkpoint, the table files must be written and flushed. The
+    // previous journal file is deleted. Don't call this if saving the
+    // tables failed, the previous file still holds those changes.
+    // ********************************************************************
+    void EndCheckpoint();
+
+    // ** @returns Returns the number of bytes written to the current journal file.
+    SizeT GetFileBytes() const { return static_cast<SizeT>(AtomicLoad(&mFileBytes)); }
+    UInt64 GetCommittedSequence() const { return static_cast<UInt64>(AtomicLoad(&mCommittedSequence)); }
+    UInt64 GetAppendedSequence() const { return static_cast<UInt64>(AtomicLoad(&mAppendedSequence)); }
+
+    // ********************************************************************
+    // Replays the journal files at 'path' in generation order.
+    // @returns Returns the number of records replayed.
+    // ********************************************************************
+    static SizeT Replay(const String& path, ReplayCallback callback, void* userData);
+    // ** Deletes the journal files at 'path'
+    static void Delete(const String& path);
+    static String GetFilename(const String& path, SizeT slot);
+private:
+    MemDBJournal(const MemDBJournal&) = delete;
+    MemDBJournal& operator=(const MemDBJournal&) = delete;
+
+    bool OpenGeneration(UInt64 generation);
+    bool WritePending();
+
+    // ** Guards the pending buffer and append sequence.
+    SpinLock          mAppendLock;
+    // ** Serializes writes to the journal file.
+    CriticalSection   mWriteLock;
+    TVector<ByteT>    mPending;
+    TVector<ByteT>    mWriting;
+
+    String            mPath;
+    File              mFile;
+    File              mPreviousFile;
+    UInt64            mGeneration;
+    bool              mSyncToDisk;
+
+    volatile Atomic64 mAppendedSequence;
+    volatile Atomic64 mCommittedSequence;
+    volatile Atomic64 mFileBytes;
+};
+
+} // namespace lf
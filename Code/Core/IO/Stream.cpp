@@ -237,6 +237,11 @@ void Stream::Serialize(MemoryBuffer&)
 {
 }
 
+bool Stream::SerializeBulk(void*, SizeT, SizeT, SizeT)
+{
+    return false;
+}
+
 bool Stream::BeginObject(const String&, const String&)
 {
     return(false);
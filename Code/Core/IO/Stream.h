@@ -109,6 +109,31 @@ class Token;
 
 class StreamContext;
 
+// **********************************
+// Describes types that can be serialized as a contiguous range of bytes, see Stream::SerializeBulk
+// COMPONENT_SIZE is the size of the scalars that make up the type (used for byte swapping), 0 if the type
+// cannot be bulk serialized.
+// **********************************
+template<typename T>
+struct TStreamBulkTraits { enum { COMPONENT_SIZE = 0 }; };
+#define LF_STREAM_BULK_TYPE(Type_, ComponentSize_) \
+    template<> struct TStreamBulkTraits<Type_> { enum { COMPONENT_SIZE = ComponentSize_ }; }
+LF_STREAM_BULK_TYPE(UInt8, 1);
+LF_STREAM_BULK_TYPE(UInt16, 2);
+LF_STREAM_BULK_TYPE(UInt32, 4);
+LF_STREAM_BULK_TYPE(UInt64, 8);
+LF_STREAM_BULK_TYPE(Int8, 1);
+LF_STREAM_BULK_TYPE(Int16, 2);
+LF_STREAM_BULK_TYPE(Int32, 4);
+LF_STREAM_BULK_TYPE(Int64, 8);
+LF_STREAM_BULK_TYPE(Float32, 4);
+LF_STREAM_BULK_TYPE(Float64, 8);
+LF_STREAM_BULK_TYPE(Vector2, 4);
+LF_STREAM_BULK_TYPE(Vector3, 4);
+LF_STREAM_BULK_TYPE(Vector4, 4);
+LF_STREAM_BULK_TYPE(Color, 4);
+#undef LF_STREAM_BULK_TYPE
+
 // Extra information about the property
 // Todo: If we want to support flags they will have to be actual flags.
 struct LF_CORE_API StreamPropertyInfo
@@ -239,6 +264,35 @@ public:
     virtual void Serialize(const StreamPropertyInfo& info);
     virtual void Serialize(const ArrayPropertyInfo& info);
     virtual void Serialize(MemoryBuffer& value);
+    // **********************************
+    // Serializes a contiguous range of values as raw bytes. The array size is not serialized.
+    // 
+    // @param values -- Pointer to the first element
+    // @param count -- The number of elements
+    // @param elementSize -- The size of each element in bytes
+    // @param componentSize -- The size of the scalars within an element (see TStreamBulkTraits)
+    // @returns Returns false if the stream does not support bulk serialization, the caller must
+    //          serialize each element.
+    // **********************************
+    virtual bool SerializeBulk(void* values, SizeT count, SizeT elementSize, SizeT componentSize);
+
+    // **********************************
+    // Serializes a contiguous range of POD values, uses SerializeBulk when the stream supports it
+    // otherwise falls back to serializing each element. The array size is not serialized.
+    // **********************************
+    template<typename T>
+    void SerializeArray(T* values, SizeT count)
+    {
+        LF_STATIC_ASSERT(TStreamBulkTraits<T>::COMPONENT_SIZE != 0);
+        if (count == 0 || SerializeBulk(values, count, sizeof(T), TStreamBulkTraits<T>::COMPONENT_SIZE))
+        {
+            return;
+        }
+        for (SizeT i = 0; i < count; ++i)
+        {
+            Serialize(values[i]);
+        }
+    }
 
     // **********************************
     // Called to start writing an object. 
@@ -328,6 +382,22 @@ public:
     bool mLogWarnings;
 };
 
+template<typename T, bool BULK = (TStreamBulkTraits<T>::COMPONENT_SIZE != 0)>
+struct TStreamBulkArray
+{
+    template<typename TProp>
+    static bool Serialize(Stream&, TProp&, size_t) { return false; }
+};
+template<typename T>
+struct TStreamBulkArray<T, true>
+{
+    template<typename TProp>
+    static bool Serialize(Stream& s, TProp& prop, size_t size)
+    {
+        return size == 0 || s.SerializeBulk(&prop[0], size, sizeof(T), TStreamBulkTraits<T>::COMPONENT_SIZE);
+    }
+};
+
 template<typename TProp>
 void TSerializeArray(Stream& s, TProp& prop, const StreamPropertyInfo& propInfo)
 {
@@ -343,10 +413,15 @@ void TSerializeArray(Stream& s, TProp& prop, const StreamPropertyInfo& propInfo)
         size = prop.size();
         s.SetArraySize(size);
     }
-    for (size_t i = 0; i < size; ++i)
+    // ** POD arrays are serialized in one call if the stream supports it.
+    using ValueType = typename TProp::value_type;
+    if (!TStreamBulkArray<ValueType>::Serialize(s, prop, size))
     {
-        ArrayPropertyInfo arrayInfo(i);
-        s << arrayInfo << prop[i];
+        for (size_t i = 0; i < size; ++i)
+        {
+            ArrayPropertyInfo arrayInfo(i);
+            s << arrayInfo << prop[i];
+        }
     }
     s.EndArray();
 }
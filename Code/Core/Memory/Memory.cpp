@@ -20,6 +20,7 @@
 // ********************************************************************
 #include "Core/PCH.h"
 #include "Memory.h"
+#include "Core/Memory/ThreadCache.h"
 #include <memory>
 
 #if defined(LF_OS_WINDOWS)
@@ -48,7 +49,9 @@ struct MemoryHeader
     SizeT alignment;
     UInt8 tag;
     UInt8 headerSize;
+    UInt8 sizeClass;
 };
+static_assert(sizeof(MemoryHeader) < ThreadCache::THREAD_CACHE_HEADER_SIZE, "MemoryHeader must fit in the thread cache header.");
 
 #if defined(LF_TRACK_ALLOCS)
 LF_FORCE_INLINE static bool TrackAlloc()
@@ -73,6 +76,7 @@ mAllocs(0)
 
 }
 
+// Only updated by threads without a thread cache, see LFGetMemoryMarkup
 MemoryMarkup MEMORY_MARK_UP[MMT_MAX_VALUE];
 const char*  MEMORY_MARK_UP_STRING[MMT_MAX_VALUE];
 
@@ -87,6 +91,15 @@ void LFSetCurrentMemoryTag(MemoryMarkupTag tag)
     gCurrentMarkupTag = tag;
 }
 
+LF_FORCE_INLINE static void RecordAlloc(MemoryMarkupTag tag, Int64 bytes, Int64 allocs)
+{
+    if (!ThreadCache::Record(tag, bytes, allocs))
+    {
+        _InlineInterlockedAdd64(&MEMORY_MARK_UP[tag].mBytesAllocated, bytes);
+        _InlineInterlockedAdd64(&MEMORY_MARK_UP[tag].mAllocs, allocs);
+    }
+}
+
 
 void* LFAlloc(SizeT size, SizeT alignment)
 {
@@ -104,23 +117,37 @@ void* LFAlloc(SizeT size, SizeT alignment)
         OutputDebugString(buffer);
     }
 #endif
-    const SizeT actualHeaderSize = sizeof(MemoryHeader) + ((size + sizeof(MemoryHeader)) % alignment);
-    const SizeT sizeWithHeader = size + actualHeaderSize;
-    void* pointer = _aligned_malloc(sizeWithHeader, alignment);
+    // Small allocations are served by the calling thread's cache.
+    UInt8 sizeClass = ThreadCache::GetSizeClass(size, alignment);
+    void* pointer = nullptr;
+    SizeT actualHeaderSize = 0;
+    if (sizeClass != ThreadCache::THREAD_CACHE_INVALID_CLASS)
+    {
+        pointer = ThreadCache::Allocate(sizeClass);
+        actualHeaderSize = ThreadCache::THREAD_CACHE_HEADER_SIZE;
+    }
     if (!pointer)
     {
-        return nullptr;
+        sizeClass = ThreadCache::THREAD_CACHE_INVALID_CLASS;
+        actualHeaderSize = sizeof(MemoryHeader) + ((size + sizeof(MemoryHeader)) % alignment);
+        const SizeT sizeWithHeader = size + actualHeaderSize;
+        pointer = _aligned_malloc(sizeWithHeader, alignment);
+        if (!pointer)
+        {
+            return nullptr;
+        }
     }
+    const MemoryMarkupTag tag = LFGetCurrentMemoryTag();
     MemoryHeader* header = static_cast<MemoryHeader*>(pointer);
     header->size = size;
     header->alignment = alignment;
-    header->tag = static_cast<UInt8>(LFGetCurrentMemoryTag());
+    header->tag = static_cast<UInt8>(tag);
     header->headerSize = static_cast<ByteT>(actualHeaderSize);
+    header->sizeClass = sizeClass;
 
     ByteT* headerSize = static_cast<ByteT*>(PtrAdd(pointer, actualHeaderSize - 1));
     *headerSize = static_cast<ByteT>(actualHeaderSize);
-    _InlineInterlockedAdd64(&MEMORY_MARK_UP[LFGetCurrentMemoryTag()].mBytesAllocated, static_cast<long long>(size));
-    _InterlockedIncrement64(&MEMORY_MARK_UP[LFGetCurrentMemoryTag()].mAllocs);
+    RecordAlloc(tag, static_cast<Int64>(size), 1);
     return PtrAdd(pointer, actualHeaderSize);
 }
 void LFFree(void* pointer)
@@ -136,29 +163,65 @@ void LFFree(void* pointer)
         OutputDebugString(buffer);
     }
 #endif
-    _InlineInterlockedAdd64(&MEMORY_MARK_UP[header->tag].mBytesAllocated, -static_cast<long long>(header->size));
-    _InterlockedDecrement64(&MEMORY_MARK_UP[header->tag].mAllocs);
-    _aligned_free(header);
+    RecordAlloc(static_cast<MemoryMarkupTag>(header->tag), -static_cast<Int64>(header->size), -1);
+    if (header->sizeClass != ThreadCache::THREAD_CACHE_INVALID_CLASS)
+    {
+        ThreadCache::Free(header->sizeClass, header);
+    }
+    else
+    {
+        _aligned_free(header);
+    }
+}
+
+static void CollectMemoryMarkup(MemoryMarkup (&markup)[MMT_MAX_VALUE])
+{
+    for (SizeT i = 0; i < LF_ARRAY_SIZE(MEMORY_MARK_UP); ++i)
+    {
+        markup[i].mBytesAllocated = _InterlockedCompareExchange64(&MEMORY_MARK_UP[i].mBytesAllocated, 0, 0);
+        markup[i].mAllocs = _InterlockedCompareExchange64(&MEMORY_MARK_UP[i].mAllocs, 0, 0);
+    }
+    ThreadCache::Collect(markup);
 }
 
 SizeT LFGetBytesAllocated()
 {
+    MemoryMarkup markup[MMT_MAX_VALUE];
+    CollectMemoryMarkup(markup);
     SizeT result = 0;
-    for (SizeT i = 0; i < LF_ARRAY_SIZE(MEMORY_MARK_UP); ++i)
+    for (SizeT i = 0; i < LF_ARRAY_SIZE(markup); ++i)
     {
-        result += static_cast<SizeT>(MEMORY_MARK_UP[i].mBytesAllocated);
+        if (i != MMT_ALLOCATOR)
+        {
+            result += static_cast<SizeT>(markup[i].mBytesAllocated);
+        }
     }
     return result;
 }
 SizeT LFGetAllocations()
 {
+    MemoryMarkup markup[MMT_MAX_VALUE];
+    CollectMemoryMarkup(markup);
     SizeT result = 0;
-    for (SizeT i = 0; i < LF_ARRAY_SIZE(MEMORY_MARK_UP); ++i)
+    for (SizeT i = 0; i < LF_ARRAY_SIZE(markup); ++i)
     {
-        result += static_cast<SizeT>(MEMORY_MARK_UP[i].mAllocs);
+        if (i != MMT_ALLOCATOR)
+        {
+            result += static_cast<SizeT>(markup[i].mAllocs);
+        }
     }
     return result;
 }
+MemoryMarkup LFGetMemoryMarkup(MemoryMarkupTag tag)
+{
+    MemoryMarkup markup[MMT_MAX_VALUE];
+    CollectMemoryMarkup(markup);
+    return markup[tag];
+}
+void LFReleaseThreadCache()
+{
+    ThreadCache::Release();
+}
 
 void LFEnterTrackAllocs()
 {
@@ -31,6 +31,8 @@ enum MemoryMarkupTag
     MMT_GENERAL,
     MMT_POINTER_NODE,
     MMT_GRAPHICS,
+    // Memory held by the allocator itself (eg. thread cache slabs), excluded from LFGetBytesAllocated/LFGetAllocations
+    MMT_ALLOCATOR,
     MMT_MAX_VALUE
 };
 struct MemoryMarkup
@@ -70,6 +72,15 @@ LF_CORE_API void* LFAlloc(SizeT size, SizeT alignment);
 LF_CORE_API void  LFFree(void* pointer);
 LF_CORE_API SizeT LFGetBytesAllocated();
 LF_CORE_API SizeT LFGetAllocations();
+// **********************************
+// Statistics are accumulated per-thread, this merges the statistics of all threads for the tag.
+// **********************************
+LF_CORE_API MemoryMarkup LFGetMemoryMarkup(MemoryMarkupTag tag);
+// **********************************
+// Returns the calling thread's cached allocations to the shared heaps. Called when a lf::Thread
+// exits, threads created by other means should call this before they exit.
+// **********************************
+LF_CORE_API void  LFReleaseThreadCache();
 LF_CORE_API void  LFEnterTrackAllocs();
 LF_CORE_API void  LFExitTrackAllocs();
 
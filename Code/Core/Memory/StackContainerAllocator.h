@@ -256,6 +256,7 @@ public:
 
     void clear() { container().clear(); }
     void resize(size_type size) { container().resize(size); }
+    void resize(size_type size, const value_type& value) { container().resize(size, value); }
     void reserve(size_type size) { container().reserve(size); }
 
     bool empty() const { return container().empty(); }
@@ -0,0 +1,263 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "ThreadCache.h"
+#include "Core/Memory/DynamicPoolHeap.h"
+#include "Core/Platform/Atomic.h"
+
+namespace lf {
+namespace ThreadCache {
+
+static const SizeT SIZE_CLASSES[THREAD_CACHE_NUM_CLASSES] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024 };
+// Bytes per PoolHeap slab
+static const SizeT SLAB_SIZE = 64 * 1024;
+// Max slabs per size class before allocations fall back to the system allocator
+static const SizeT MAX_SLABS = 64;
+// Bytes moved between the thread cache and the central heap per refill/flush
+static const SizeT TRANSFER_SIZE = 8 * 1024;
+// Max number of threads with a cache, threads beyond this use the system allocator with global statistics
+static const SizeT MAX_THREAD_CACHES = 256;
+
+enum CentralState
+{
+    CS_UNINITIALIZED,
+    CS_INITIALIZING,
+    CS_READY
+};
+
+// Thread caches are POD records in static memory rather than thread-local objects so they're
+// zero initialized before any static constructor runs, and so the statistics of threads that
+// exit without calling Release are never lost.
+struct LF_ALIGN(64) ThreadCacheRecord
+{
+    volatile Atomic32   mInUse;
+    // Non-zero while the thread is allocating on behalf of the cache (refill, central heap setup)
+    UInt32              mDepth;
+    void*               mBins[THREAD_CACHE_NUM_CLASSES];
+    SizeT               mBinCounts[THREAD_CACHE_NUM_CLASSES];
+    // Only written by the owning thread, read by Collect
+    volatile Atomic64   mBytesAllocated[MMT_MAX_VALUE];
+    volatile Atomic64   mAllocs[MMT_MAX_VALUE];
+};
+
+static ThreadCacheRecord gRecords[MAX_THREAD_CACHES];
+LF_THREAD_LOCAL ThreadCacheRecord* gThreadRecord = nullptr;
+LF_THREAD_LOCAL bool gThreadRecordUnavailable = false;
+
+// Central heaps are constructed on first use, LFAlloc may be called before static initialization.
+LF_ALIGN(16) static ByteT gCentralStorage[sizeof(DynamicPoolHeap) * THREAD_CACHE_NUM_CLASSES];
+static volatile Atomic32 gCentralState = CS_UNINITIALIZED;
+
+LF_FORCE_INLINE static SizeT GetBlockSize(UInt8 sizeClass) { return THREAD_CACHE_HEADER_SIZE + SIZE_CLASSES[sizeClass]; }
+LF_FORCE_INLINE static DynamicPoolHeap& GetCentral(UInt8 sizeClass) { return reinterpret_cast<DynamicPoolHeap*>(gCentralStorage)[sizeClass]; }
+LF_FORCE_INLINE static void*& NextBlock(void* block) { return *reinterpret_cast<void**>(block); }
+
+static ThreadCacheRecord* GetRecord()
+{
+    if (gThreadRecord || gThreadRecordUnavailable)
+    {
+        return gThreadRecord;
+    }
+
+    for (ThreadCacheRecord& record : gRecords)
+    {
+        if (AtomicLoad(&record.mInUse) == 0 && AtomicCompareExchange(&record.mInUse, 1, 0) == 0)
+        {
+            gThreadRecord = &record;
+            return gThreadRecord;
+        }
+    }
+    gThreadRecordUnavailable = true;
+    return nullptr;
+}
+
+// Memory allocated by the cache itself is tagged MMT_ALLOCATOR and bypasses the cache.
+struct ScopedCacheAllocation
+{
+    ScopedCacheAllocation(ThreadCacheRecord* record) : mRecord(record), mTag(MMT_ALLOCATOR)
+    {
+        ++mRecord->mDepth;
+    }
+    ~ScopedCacheAllocation()
+    {
+        --mRecord->mDepth;
+    }
+    ThreadCacheRecord* mRecord;
+    ScopedMemoryTag    mTag;
+};
+
+static bool InitializeCentral(ThreadCacheRecord* record)
+{
+    Atomic32 state = AtomicLoad(&gCentralState);
+    if (state == CS_READY)
+    {
+        return true;
+    }
+    // Someone else is initializing, use the system allocator until they're done.
+    if (state == CS_INITIALIZING || AtomicCompareExchange(&gCentralState, CS_INITIALIZING, CS_UNINITIALIZED) != CS_UNINITIALIZED)
+    {
+        return false;
+    }
+
+    ScopedCacheAllocation scope(record);
+    for (UInt8 i = 0; i < THREAD_CACHE_NUM_CLASSES; ++i)
+    {
+        DynamicPoolHeap* heap = new(&GetCentral(i))DynamicPoolHeap();
+        const SizeT blockSize = GetBlockSize(i);
+        CriticalAssert(heap->Initialize(blockSize, THREAD_CACHE_ALIGNMENT, SLAB_SIZE / blockSize, MAX_SLABS));
+    }
+    AtomicStore(&gCentralState, CS_READY);
+    return true;
+}
+
+// Returns half of the bin to the central heap.
+static void Flush(ThreadCacheRecord* record, UInt8 sizeClass, SizeT count)
+{
+    ScopedCacheAllocation scope(record);
+    DynamicPoolHeap& central = GetCentral(sizeClass);
+    while (count > 0 && record->mBins[sizeClass])
+    {
+        void* block = record->mBins[sizeClass];
+        record->mBins[sizeClass] = NextBlock(block);
+        --record->mBinCounts[sizeClass];
+        --count;
+        central.Free(block);
+    }
+}
+
+UInt8 GetSizeClass(SizeT size, SizeT alignment)
+{
+    if (size > THREAD_CACHE_MAX_SIZE || alignment > THREAD_CACHE_ALIGNMENT)
+    {
+        return THREAD_CACHE_INVALID_CLASS;
+    }
+    for (UInt8 i = 0; i < THREAD_CACHE_NUM_CLASSES; ++i)
+    {
+        if (size <= SIZE_CLASSES[i])
+        {
+            return i;
+        }
+    }
+    return THREAD_CACHE_INVALID_CLASS;
+}
+
+void* Allocate(UInt8 sizeClass)
+{
+    ThreadCacheRecord* record = GetRecord();
+    if (!record || record->mDepth > 0 || !InitializeCentral(record))
+    {
+        return nullptr;
+    }
+
+    if (!record->mBins[sizeClass])
+    {
+        ScopedCacheAllocation scope(record);
+        DynamicPoolHeap& central = GetCentral(sizeClass);
+        const SizeT refill = TRANSFER_SIZE / GetBlockSize(sizeClass);
+        for (SizeT i = 0; i < refill; ++i)
+        {
+            void* block = central.Allocate();
+            if (!block)
+            {
+                break;
+            }
+            NextBlock(block) = record->mBins[sizeClass];
+            record->mBins[sizeClass] = block;
+            ++record->mBinCounts[sizeClass];
+        }
+        // Central heap is at capacity
+        if (!record->mBins[sizeClass])
+        {
+            return nullptr;
+        }
+    }
+
+    void* block = record->mBins[sizeClass];
+    record->mBins[sizeClass] = NextBlock(block);
+    --record->mBinCounts[sizeClass];
+    return block;
+}
+
+void Free(UInt8 sizeClass, void* block)
+{
+    ThreadCacheRecord* record = GetRecord();
+    if (!record || record->mDepth > 0)
+    {
+        // The block came from a central heap so it must be initialized.
+        GetCentral(sizeClass).Free(block);
+        return;
+    }
+
+    NextBlock(block) = record->mBins[sizeClass];
+    record->mBins[sizeClass] = block;
+    const SizeT transfer = TRANSFER_SIZE / GetBlockSize(sizeClass);
+    if (++record->mBinCounts[sizeClass] > transfer * 2)
+    {
+        Flush(record, sizeClass, transfer);
+    }
+}
+
+bool Record(MemoryMarkupTag tag, Int64 bytes, Int64 allocs)
+{
+    ThreadCacheRecord* record = GetRecord();
+    if (!record)
+    {
+        return false;
+    }
+    // Only the owning thread writes, so there is no need for an interlocked add.
+    record->mBytesAllocated[tag] = record->mBytesAllocated[tag] + bytes;
+    record->mAllocs[tag] = record->mAllocs[tag] + allocs;
+    return true;
+}
+
+void Collect(MemoryMarkup (&markup)[MMT_MAX_VALUE])
+{
+    // Released records keep their statistics, so every record is part of the total.
+    for (const ThreadCacheRecord& record : gRecords)
+    {
+        for (SizeT tag = 0; tag < MMT_MAX_VALUE; ++tag)
+        {
+            markup[tag].mBytesAllocated += AtomicLoad(&record.mBytesAllocated[tag]);
+            markup[tag].mAllocs += AtomicLoad(&record.mAllocs[tag]);
+        }
+    }
+}
+
+void Release()
+{
+    ThreadCacheRecord* record = gThreadRecord;
+    if (!record)
+    {
+        return;
+    }
+    if (AtomicLoad(&gCentralState) == CS_READY)
+    {
+        for (UInt8 i = 0; i < THREAD_CACHE_NUM_CLASSES; ++i)
+        {
+            Flush(record, i, record->mBinCounts[i]);
+        }
+    }
+    gThreadRecord = nullptr;
+    AtomicStore(&record->mInUse, 0);
+}
+
+} // namespace ThreadCache
+} // namespace lf
@@ -0,0 +1,83 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Common/Types.h"
+#include "Core/Memory/Memory.h"
+
+namespace lf {
+
+// **********************************
+// Per-thread caching front-end for LFAlloc/LFFree.
+//
+// Small allocations (<= THREAD_CACHE_MAX_SIZE, alignment <= THREAD_CACHE_ALIGNMENT) are rounded up
+// to a size class and served from a thread-local free list. When a free list is empty it's refilled
+// with a batch from a central DynamicPoolHeap (PoolHeap slabs) for the size class, when a free list
+// grows too long half of it is returned to the central heap. Blocks may be freed on any thread, they
+// simply end up in the freeing thread's cache.
+//
+// Memory statistics (MEMORY_MARK_UP) are accumulated per-thread as well and merged lazily by
+// LFGetMemoryMarkup, so the hot path doesn't touch any shared cache lines.
+//
+// note: This is an internal interface of Core/Memory, use LFAlloc/LFFree.
+// **********************************
+namespace ThreadCache {
+
+// Number of bytes reserved before each cached block for the MemoryHeader
+const SizeT THREAD_CACHE_HEADER_SIZE = 32;
+// Largest alignment a cached block satisfies
+const SizeT THREAD_CACHE_ALIGNMENT = 16;
+// Largest allocation served by the cache
+const SizeT THREAD_CACHE_MAX_SIZE = 1024;
+// Number of size classes
+const SizeT THREAD_CACHE_NUM_CLASSES = 12;
+// Size class of allocations that bypass the cache
+const UInt8 THREAD_CACHE_INVALID_CLASS = 0xFF;
+
+// **********************************
+// @returns Returns the size class for the allocation or THREAD_CACHE_INVALID_CLASS if it's not cached.
+// **********************************
+UInt8 GetSizeClass(SizeT size, SizeT alignment);
+// **********************************
+// Allocates a block (including THREAD_CACHE_HEADER_SIZE) of the size class.
+// @returns Returns the start of the block or nullptr if the caller should use the system allocator.
+// **********************************
+void* Allocate(UInt8 sizeClass);
+// **********************************
+// Frees a block previously returned from Allocate.
+// **********************************
+void Free(UInt8 sizeClass, void* block);
+// **********************************
+// Records an allocation (positive) or free (negative) in the calling thread's statistics.
+// @returns Returns false if the thread has no cache, the caller must update MEMORY_MARK_UP itself.
+// **********************************
+bool Record(MemoryMarkupTag tag, Int64 bytes, Int64 allocs);
+// **********************************
+// Adds every thread's statistics to 'markup'.
+// **********************************
+void Collect(MemoryMarkup (&markup)[MMT_MAX_VALUE]);
+// **********************************
+// Returns the calling thread's cached blocks to the central heaps and releases the thread's cache
+// so another thread can use it. The statistics are kept so they remain part of the totals.
+// **********************************
+void Release();
+
+} // namespace ThreadCache
+} // namespace lf
@@ -38,6 +38,7 @@ namespace Crypto {
 class AESKey;
 class RSAKey;
 class HMACKey;
+class AEADContext;
 }
 
 namespace NetProtocol
@@ -117,6 +118,7 @@ namespace NetPacketFlag
 
         NET_PACKET_FLAG_HMAC,        // If this flag is turned on the packet contains a HMAC on the end. (Before Signature)
         NET_PACKET_FLAG_SIGNED,      // If this flag is turned on the packet contains a signature on the end. (After HMAC)
+        NET_PACKET_FLAG_AEAD,        // If this flag is turned on the packet data is sealed with an AEAD cipher and the header carries the tag instead of an HMAC.
 
         MAX_VALUE,
         INVALID_ENUM = NetPacketFlag::MAX_VALUE
@@ -681,6 +683,10 @@ struct NetServerDriverConfig
     , mPort(0)
     , mMaxRetransmit(3)
     , mProtocol(NetProtocol::NET_PROTOCOL_IPV4_UDP)
+    , mReceiveThreads(1)
+    , mWorkerThreads(2)
+    , mMaxPendingPackets(1024)
+    , mAllowAEAD(true)
     {}
 
     UInt16 mAppID;
@@ -689,6 +695,16 @@ struct NetServerDriverConfig
     UInt16 mPort;
     SizeT  mMaxRetransmit;
     NetProtocol::Value mProtocol;
+    // The number of threads blocking on the socket for incoming packets.
+    SizeT  mReceiveThreads;
+    // The number of threads verifying/decrypting packets, packets are sharded by session so
+    // a connection's packets are always processed in the order they were received.
+    SizeT  mWorkerThreads;
+    // The number of packet buffers allocated per pool heap, packets are dropped once every heap is in use.
+    SizeT  mMaxPendingPackets;
+    // Whether or not connections requesting AEAD (AES-256-GCM) packet protection are allowed to use it,
+    // otherwise they fall back to AES-CBC + HMAC.
+    bool   mAllowAEAD;
 
     // TStrongPointer<NetMessageController> mControllers[NetDriver::MessageType::MAX_VALUE];
 };
@@ -702,6 +718,7 @@ struct NetClientDriverConfig
         , mEndPoint()
         , mMaxRetransmit(3)
         , mProtocol(NetProtocol::NET_PROTOCOL_IPV4_UDP)
+        , mRequestAEAD(true)
     {}
 
     UInt16 mAppID;
@@ -710,6 +727,8 @@ struct NetClientDriverConfig
     IPEndPointAny mEndPoint;
     SizeT  mMaxRetransmit;
     NetProtocol::Value mProtocol;
+    // Whether or not to request AEAD (AES-256-GCM) packet protection in the client hello.
+    bool   mRequestAEAD;
 };
 
 struct NetKeySet
@@ -718,6 +737,8 @@ struct NetKeySet
     const Crypto::HMACKey* mHmacKey;
     const Crypto::RSAKey* mSigningKey;
     const Crypto::RSAKey* mVerifyKey;
+    // When set the message is sealed with this context instead of AES-CBC + HMAC.
+    Crypto::AEADContext* mAEAD;
 };
 
 struct PacketData
@@ -762,9 +783,30 @@ const RouteIndex INVALID_ROUTE = INVALID16;
 const SizeT NET_CLIENT_CHALLENGE_SIZE = 32;
 const SizeT NET_HEARTBEAT_NONCE_SIZE = 32;
 
+// A single datagram of a UDPSocket batch operation.
+struct UDPPacketBuffer
+{
+    UDPPacketBuffer()
+    : mBytes(nullptr)
+    , mSize(0)
+    , mEndPoint()
+    {}
+
+    // Receive: The memory the datagram is written to. Send: The datagram to send.
+    ByteT*        mBytes;
+    // Receive: The capacity of mBytes on input and the size of the datagram on output.
+    // Send: The number of bytes to send.
+    SizeT         mSize;
+    // Receive: The sender of the datagram. Send: The target of the datagram.
+    IPEndPointAny mEndPoint;
+};
+
 #if defined(LF_OS_WINDOWS)
 class LF_IMPL_OPAQUE(UDPSocketWindows);
 using LF_IMPL_OPAQUE(UDPSocket) = LF_IMPL_OPAQUE(UDPSocketWindows);
+#elif defined(LF_OS_POSIX)
+class LF_IMPL_OPAQUE(UDPSocketPosix);
+using LF_IMPL_OPAQUE(UDPSocket) = LF_IMPL_OPAQUE(UDPSocketPosix);
 #else
 #error Missing platform implementation.
 #endif
@@ -21,7 +21,11 @@
 #include "Core/PCH.h"
 #include "UDPSocket.h"
 #if !defined(LF_IMPL_OPAQUE_OPTIMIZE)
+#if defined(LF_OS_WINDOWS)
 #include "Core/Net/UDPSocketWindows.h"
+#elif defined(LF_OS_POSIX)
+#include "Core/Net/UDPSocketPosix.h"
+#endif
 
 namespace lf {
 
@@ -60,7 +64,16 @@ bool UDPSocket::SendTo(const ByteT* bytes, SizeT& inOutBytes, const IPEndPointAn
 {
     return mImpl->SendTo(bytes, inOutBytes, endPoint);
 }
+bool UDPSocket::ReceiveBatch(UDPPacketBuffer* packets, SizeT& inOutCount)
+{
+    return mImpl->ReceiveBatch(packets, inOutCount);
+}
+bool UDPSocket::SendBatch(const UDPPacketBuffer* packets, SizeT& inOutCount)
+{
+    return mImpl->SendBatch(packets, inOutCount);
+}
 
+SizeT UDPSocket::GetMaxReceiveBatch() const { return mImpl->GetMaxReceiveBatch(); }
 NetProtocol::Value UDPSocket::GetProtocol() const { return mImpl->GetProtocol(); }
 UInt16 UDPSocket::GetBoundPort() const { return mImpl->GetBoundPort(); }
 bool UDPSocket::IsAwaitingReceive() const { return mImpl->IsAwaitingReceive(); }
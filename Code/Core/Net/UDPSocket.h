@@ -25,6 +25,8 @@
 #if defined(LF_IMPL_OPAQUE_OPTIMIZE)
 #if defined(LF_OS_WINDOWS)
 #include "Core/Net/UDPSocketWindows.h"
+#elif defined(LF_OS_POSIX)
+#include "Core/Net/UDPSocketPosix.h"
 #else
 #error Missing platform implementation.
 #endif
@@ -113,6 +115,36 @@ public:
     // **********************************
     bool SendTo(const ByteT* bytes, SizeT& inOutBytes, const IPEndPointAny& endPoint);
     // **********************************
+    // Blocks until at least one datagram is received then receives as many of the pending
+    // datagrams as will fit in 'packets' with a single system call where the platform supports
+    // it. (recvmmsg)
+    //
+    // note: If this method returns false, it doesn't necessarilly mean that it failed,
+    //       it could have simply been unblocked by a shutdown operation.
+    //
+    // @param packets    -- The packet buffers to receive into, each mSize must be the capacity
+    //                   of its mBytes. On success mSize/mEndPoint hold the datagram size/sender.
+    // @param inOutCount -- The number of packet buffers, if the function succeeds the number
+    //                   of datagrams received is written to this argument.
+    // @return Returns true if there we're not error receiving datagrams.
+    // **********************************
+    bool ReceiveBatch(UDPPacketBuffer* packets, SizeT& inOutCount);
+    // **********************************
+    // Sends each packet to its mEndPoint with a single system call where the platform supports
+    // it. (sendmmsg)
+    //
+    // @param packets    -- The datagrams to send.
+    // @param inOutCount -- The number of datagrams to send, when the function returns this holds
+    //                   the number of datagrams actually sent. (Datagrams are sent in order)
+    // @return Returns true if all datagrams were sent.
+    // **********************************
+    bool SendBatch(const UDPPacketBuffer* packets, SizeT& inOutCount);
+    // **********************************
+    // @return Returns the most datagrams a single ReceiveBatch call can fill, buffers past this
+    //         count are never touched. (1 when the platform has no batched receive)
+    // **********************************
+    SizeT GetMaxReceiveBatch() const;
+    // **********************************
     // @return Returns the protocol the socket is using
     // **********************************
     NetProtocol::Value GetProtocol() const;
@@ -0,0 +1,621 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "UDPSocket.h"
+#if !defined(LF_IMPL_OPAQUE_OPTIMIZE)
+#include "UDPSocketPosix.h"
+#endif
+#include "Core/Common/Assert.h"
+#include "Core/Platform/Atomic.h" 
+#include "Core/Platform/Thread.h"
+#include "Core/Net/NetFramework.h"
+#include "Core/Utility/ErrorCore.h"
+#include "Core/Utility/Utility.h"
+
+#if defined(LF_OS_POSIX)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+namespace lf {
+
+const SizeT LF_MAX_MTU = 2048;
+// The maximum number of datagrams handed to a single recvmmsg/sendmmsg call, larger sends are split.
+const SizeT LF_MAX_BATCH = 64;
+const int LF_INVALID_SOCKET = -1;
+
+// See UDPSocketWindows.cpp for the IPv4/IPv6 translation rules.
+static void Translate(IPEndPointAny& endPoint)
+{
+    if (endPoint.mAddressFamily == NetAddressFamily::NET_ADDRESS_FAMILY_IPV4)
+    {
+        return;
+    }
+
+    for (SizeT i = 0; i < 10; ++i)
+    {
+        if (endPoint.mPadding.mBytes[i] != 0)
+        {
+            return;
+        }
+    }
+
+    if (endPoint.mPadding.mBytes[10] != 0xFF || endPoint.mPadding.mBytes[11] != 0xFF)
+    {
+        return;
+    }
+
+    endPoint.mPadding.mWord[0] = endPoint.mPadding.mWord[3];
+    endPoint.mPadding.mWord[2] = endPoint.mPadding.mWord[3] = 0;
+    endPoint.mAddressFamily = NetAddressFamily::NET_ADDRESS_FAMILY_IPV4;
+}
+
+static bool ToEndPoint(const sockaddr_storage& address, NetProtocol::Value protocol, IPEndPointAny& outEndPoint)
+{
+    if (address.ss_family == AF_INET)
+    {
+        const sockaddr_in* v4In = reinterpret_cast<const sockaddr_in*>(&address);
+        IPv4EndPoint* v4Out = reinterpret_cast<IPv4EndPoint*>(&outEndPoint);
+
+        v4Out->mAddressFamily = NetAddressFamily::NET_ADDRESS_FAMILY_IPV4;
+        v4Out->mPort = v4In->sin_port;
+        v4Out->mAddress.mWord = v4In->sin_addr.s_addr;
+        return true;
+    }
+    else if (address.ss_family == AF_INET6)
+    {
+        const sockaddr_in6* v6In = reinterpret_cast<const sockaddr_in6*>(&address);
+        IPv6EndPoint* v6Out = reinterpret_cast<IPv6EndPoint*>(&outEndPoint);
+
+        v6Out->mAddressFamily = NetAddressFamily::NET_ADDRESS_FAMILY_IPV6;
+        v6Out->mPort = v6In->sin6_port;
+        memcpy(&v6Out->mAddress.mBytes[0], &v6In->sin6_addr.s6_addr[0], 16);
+
+        if (protocol == NetProtocol::NET_PROTOCOL_UDP)
+        {
+            Translate(outEndPoint);
+        }
+        return true;
+    }
+    return false; // Unsupported address family (or the socket was shutdown)
+}
+
+static bool FromEndPoint(const IPEndPointAny& endPoint, NetProtocol::Value protocol, sockaddr_storage& outAddress, socklen_t& outAddressSize)
+{
+    memset(&outAddress, 0, sizeof(outAddress));
+    outAddressSize = 0;
+
+    if (endPoint.mAddressFamily == NetAddressFamily::NET_ADDRESS_FAMILY_IPV6)
+    {
+        if (protocol == NetProtocol::NET_PROTOCOL_IPV4_UDP)
+        {
+            LogSocketError("SendTo", "Cannot send to IPV6 address family as the socket has been created for the IPV4 address family.");
+            return false;
+        }
+
+        sockaddr_in6* v6 = reinterpret_cast<sockaddr_in6*>(&outAddress);
+        const IPv6EndPoint* v6EndPoint = reinterpret_cast<const IPv6EndPoint*>(&endPoint);
+        v6->sin6_family = AF_INET6;
+        v6->sin6_port = v6EndPoint->mPort; // The port should be in network byte order already.
+        memcpy(&v6->sin6_addr.s6_addr[0], &v6EndPoint->mAddress.mBytes[0], sizeof(v6EndPoint->mAddress.mBytes));
+        outAddressSize = sizeof(sockaddr_in6);
+        return true;
+    }
+    else if (endPoint.mAddressFamily == NetAddressFamily::NET_ADDRESS_FAMILY_IPV4)
+    {
+        const IPv4EndPoint* v4EndPoint = reinterpret_cast<const IPv4EndPoint*>(&endPoint);
+        if (protocol == NetProtocol::NET_PROTOCOL_IPV6_UDP)
+        {
+            LogSocketError("SendTo", "Cannot send to IPV4 address family as the socket has been created for the IPV6 address family.");
+            return false;
+        }
+        else if (protocol == NetProtocol::NET_PROTOCOL_UDP)
+        {
+            // Dual stack sockets only speak IPv6, map the address to ::ffff:a.b.c.d
+            sockaddr_in6* v6 = reinterpret_cast<sockaddr_in6*>(&outAddress);
+            v6->sin6_family = AF_INET6;
+            v6->sin6_port = v4EndPoint->mPort;
+            v6->sin6_addr.s6_addr[10] = 0xFF;
+            v6->sin6_addr.s6_addr[11] = 0xFF;
+            memcpy(&v6->sin6_addr.s6_addr[12], &v4EndPoint->mAddress.mWord, sizeof(v4EndPoint->mAddress.mWord));
+            outAddressSize = sizeof(sockaddr_in6);
+        }
+        else
+        {
+            sockaddr_in* v4 = reinterpret_cast<sockaddr_in*>(&outAddress);
+            v4->sin_family = AF_INET;
+            v4->sin_port = v4EndPoint->mPort; // The port should be in network byte order already.
+            v4->sin_addr.s_addr = v4EndPoint->mAddress.mWord;
+            outAddressSize = sizeof(sockaddr_in);
+        }
+        return true;
+    }
+
+    CriticalAssertMsgEx("SendTo failed to sent to endPoint, Unknown endpoint address family.", LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+    return false;
+}
+
+// Errors we expect from a receive that was interrupted by Shutdown, or on 'localhost' when the peer is gone.
+static bool IsExpectedReceiveError(int error)
+{
+    return error == EINTR
+        || error == EBADF
+#if defined(LF_TEST) || defined(LF_DEBUG)
+        || error == ECONNREFUSED
+#endif
+        ;
+}
+
+LF_IMPL_OPAQUE(UDPSocketPosix)::LF_IMPL_OPAQUE(UDPSocketPosix)()
+: mSocket(LF_INVALID_SOCKET)
+, mProtocol(NetProtocol::INVALID_ENUM)
+, mBoundPort(0)
+, mReceiving(0)
+, mShutdown(0)
+{
+    LF_STATIC_ASSERT(sizeof(sockaddr_in6::sin6_addr) == sizeof(IPv6EndPoint::mAddress));
+    LF_STATIC_ASSERT(sizeof(sockaddr_in::sin_addr) == sizeof(IPv4EndPoint::mAddress));
+    LF_STATIC_ASSERT(sizeof(sockaddr_in::sin_addr.s_addr) == sizeof(IPv4EndPoint::mAddress.mWord));
+}
+LF_IMPL_OPAQUE(UDPSocketPosix)::LF_IMPL_OPAQUE(UDPSocketPosix)(LF_IMPL_OPAQUE(UDPSocketPosix) && other)
+: mSocket(other.mSocket)
+, mProtocol(other.mProtocol)
+, mBoundPort(other.mBoundPort)
+, mReceiving(other.mReceiving)
+, mShutdown(other.mShutdown)
+{
+    other.mSocket = LF_INVALID_SOCKET;
+    other.mProtocol = NetProtocol::INVALID_ENUM;
+    other.mBoundPort = 0;
+    other.mReceiving = 0;
+    other.mShutdown = 0;
+}
+LF_IMPL_OPAQUE(UDPSocketPosix)::~LF_IMPL_OPAQUE(UDPSocketPosix)()
+{
+    Close();
+}
+
+LF_IMPL_OPAQUE(UDPSocketPosix)& LF_IMPL_OPAQUE(UDPSocketPosix)::operator=(LF_IMPL_OPAQUE(UDPSocketPosix) && other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    mSocket = other.mSocket;
+    mProtocol = other.mProtocol;
+    mBoundPort = other.mBoundPort;
+    mReceiving = other.mReceiving;
+    mShutdown = other.mShutdown;
+    other.mSocket = LF_INVALID_SOCKET;
+    other.mProtocol = NetProtocol::INVALID_ENUM;
+    other.mBoundPort = 0;
+    other.mReceiving = 0;
+    other.mShutdown = 0;
+    return *this;
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketPosix)::Create(NetProtocol::Value protocol)
+{
+    if (protocol != NetProtocol::NET_PROTOCOL_IPV4_UDP && protocol != NetProtocol::NET_PROTOCOL_IPV6_UDP && protocol != NetProtocol::NET_PROTOCOL_UDP)
+    {
+        return false;
+    }
+
+    if (mSocket != LF_INVALID_SOCKET)
+    {
+        return false;
+    }
+
+    mSocket = socket(protocol == NetProtocol::NET_PROTOCOL_IPV4_UDP ? AF_INET : AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+    if (mSocket == LF_INVALID_SOCKET)
+    {
+        LogSocketOperationFailure("socket");
+        return false;
+    }
+
+    if (protocol == NetProtocol::NET_PROTOCOL_UDP)
+    {
+        int value = 0;
+        if (setsockopt(mSocket, IPPROTO_IPV6, IPV6_V6ONLY, &value, sizeof(value)) != 0)
+        {
+            LogSocketOperationFailure("setsocketopt -- IPPROTO_IPV6 - IPV6_V6ONLY - FALSE");
+            if (close(mSocket) != 0)
+            {
+                LogSocketOperationFailure("close");
+            }
+            mSocket = LF_INVALID_SOCKET;
+            return false;
+        }
+    }
+
+    mProtocol = protocol;
+    AtomicStore(&mShutdown, 0);
+    return true;
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketPosix)::Close()
+{
+    AssertEx(!IsAwaitingReceive(), LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+
+    bool success = true;
+    if (mSocket != LF_INVALID_SOCKET)
+    {
+        if (close(mSocket) != 0)
+        {
+            LogSocketOperationFailure("close");
+            success = false;
+        }
+        mSocket = LF_INVALID_SOCKET;
+        mProtocol = NetProtocol::INVALID_ENUM;
+        mBoundPort = 0;
+    }
+    return success;
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketPosix)::Bind(UInt16 port)
+{
+    if (mSocket == LF_INVALID_SOCKET)
+    {
+        return false;
+    }
+
+    sockaddr_storage addr;
+    memset(&addr, 0, sizeof(addr));
+    socklen_t addrSize = 0;
+
+    if (mProtocol == NetProtocol::NET_PROTOCOL_IPV6_UDP || mProtocol == NetProtocol::NET_PROTOCOL_UDP)
+    {
+        sockaddr_in6* v6 = reinterpret_cast<sockaddr_in6*>(&addr);
+        v6->sin6_family = AF_INET6;
+        v6->sin6_port = htons(port);
+        v6->sin6_addr = in6addr_any;
+        addrSize = sizeof(sockaddr_in6);
+    }
+    else if (mProtocol == NetProtocol::NET_PROTOCOL_IPV4_UDP)
+    {
+        sockaddr_in* v4 = reinterpret_cast<sockaddr_in*>(&addr);
+        v4->sin_family = AF_INET;
+        v4->sin_port = htons(port);
+        v4->sin_addr.s_addr = htonl(INADDR_ANY);
+        addrSize = sizeof(sockaddr_in);
+    }
+    else
+    {
+        CriticalAssertMsgEx("Unexpected network protocol for UDPSocket", LF_ERROR_MISSING_IMPLEMENTATION, ERROR_API_CORE)
+    }
+
+    if (bind(mSocket, reinterpret_cast<sockaddr*>(&addr), addrSize) != 0)
+    {
+        LogSocketOperationFailure("bind");
+        return false;
+    }
+
+    mBoundPort = port;
+    return true;
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketPosix)::ReceiveFrom(ByteT* outBytes, SizeT& inOutBytes, IPEndPointAny& outEndPoint)
+{
+    if (outBytes == nullptr || inOutBytes == 0)
+    {
+        return false;
+    }
+
+    sockaddr_storage sender;
+    sender.ss_family = AF_UNSPEC;
+    socklen_t senderAddrSize = sizeof(sender);
+
+    if (!BeginReceive())
+    {
+        inOutBytes = 0;
+        return false;
+    }
+    ssize_t result = recvfrom(mSocket, outBytes, inOutBytes, 0, reinterpret_cast<sockaddr*>(&sender), &senderAddrSize);
+    AtomicDecrement32(&mReceiving);
+    inOutBytes = 0;
+    if (result < 0)
+    {
+        if (!IsExpectedReceiveError(errno))
+        {
+            LogSocketOperationFailure("recvfrom");
+        }
+        return false;
+    }
+
+    if (!ToEndPoint(sender, mProtocol, outEndPoint))
+    {
+        return false;
+    }
+    inOutBytes = static_cast<SizeT>(result);
+    return true;
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketPosix)::SendTo(const ByteT* bytes, SizeT& inOutBytes, const IPEndPointAny& endPoint)
+{
+    if (bytes == nullptr || inOutBytes == 0)
+    {
+        return false;
+    }
+    // todo: Calculate an actual MTU
+    ReportBug(inOutBytes <= LF_MAX_MTU); // Greater than 'MTU', sanity check for now. 
+    if (inOutBytes > LF_MAX_MTU)
+    {
+        return false;
+    }
+
+    sockaddr_storage receiver;
+    socklen_t receiverSize = 0;
+    if (!FromEndPoint(endPoint, mProtocol, receiver, receiverSize))
+    {
+        return false;
+    }
+
+    ssize_t result = sendto(mSocket, bytes, inOutBytes, 0, reinterpret_cast<sockaddr*>(&receiver), receiverSize);
+    inOutBytes = 0;
+    if (result < 0)
+    {
+        LogSocketOperationFailure("sendto");
+        return false;
+    }
+    inOutBytes = static_cast<SizeT>(result);
+    return true;
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketPosix)::ReceiveBatch(UDPPacketBuffer* packets, SizeT& inOutCount)
+{
+    if (packets == nullptr || inOutCount == 0)
+    {
+        return false;
+    }
+
+#if defined(__linux__)
+    const SizeT count = Min(inOutCount, LF_MAX_BATCH);
+    mmsghdr messages[LF_MAX_BATCH];
+    iovec vectors[LF_MAX_BATCH];
+    sockaddr_storage senders[LF_MAX_BATCH];
+    memset(messages, 0, sizeof(messages[0]) * count);
+    for (SizeT i = 0; i < count; ++i)
+    {
+        vectors[i].iov_base = packets[i].mBytes;
+        vectors[i].iov_len = packets[i].mSize;
+        senders[i].ss_family = AF_UNSPEC;
+        messages[i].msg_hdr.msg_name = &senders[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(senders[i]);
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // MSG_WAITFORONE blocks for the first datagram only, then takes whatever else is already queued.
+    if (!BeginReceive())
+    {
+        inOutCount = 0;
+        return false;
+    }
+    int result = recvmmsg(mSocket, messages, static_cast<unsigned int>(count), MSG_WAITFORONE, nullptr);
+    AtomicDecrement32(&mReceiving);
+    inOutCount = 0;
+    if (result < 0)
+    {
+        if (!IsExpectedReceiveError(errno))
+        {
+            LogSocketOperationFailure("recvmmsg");
+        }
+        return false;
+    }
+
+    for (SizeT i = 0; i < static_cast<SizeT>(result); ++i)
+    {
+        // A shutdown wakes the receiver with an empty sender, nothing after it is valid.
+        if (!ToEndPoint(senders[i], mProtocol, packets[i].mEndPoint))
+        {
+            break;
+        }
+        packets[i].mSize = static_cast<SizeT>(messages[i].msg_len);
+        ++inOutCount;
+    }
+    return inOutCount > 0;
+#else
+    inOutCount = 0;
+    if (!ReceiveFrom(packets[0].mBytes, packets[0].mSize, packets[0].mEndPoint))
+    {
+        return false;
+    }
+    inOutCount = 1;
+    return true;
+#endif
+}
+
+SizeT LF_IMPL_OPAQUE(UDPSocketPosix)::GetMaxReceiveBatch() const
+{
+#if defined(__linux__)
+    return LF_MAX_BATCH;
+#else
+    return 1;
+#endif
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketPosix)::SendBatch(const UDPPacketBuffer* packets, SizeT& inOutCount)
+{
+    if (packets == nullptr || inOutCount == 0)
+    {
+        return false;
+    }
+
+    const SizeT count = inOutCount;
+    inOutCount = 0;
+#if defined(__linux__)
+    mmsghdr messages[LF_MAX_BATCH];
+    iovec vectors[LF_MAX_BATCH];
+    sockaddr_storage receivers[LF_MAX_BATCH];
+    while (inOutCount < count)
+    {
+        const UDPPacketBuffer* batch = packets + inOutCount;
+        SizeT batchSize = Min(count - inOutCount, LF_MAX_BATCH);
+        memset(messages, 0, sizeof(messages[0]) * batchSize);
+        // Datagrams before an invalid one are still sent so inOutCount matches the per-datagram fallback.
+        bool invalid = false;
+        for (SizeT i = 0; i < batchSize; ++i)
+        {
+            ReportBug(batch[i].mSize <= LF_MAX_MTU);
+            socklen_t receiverSize = 0;
+            if (batch[i].mBytes == nullptr || batch[i].mSize == 0 || batch[i].mSize > LF_MAX_MTU
+                || !FromEndPoint(batch[i].mEndPoint, mProtocol, receivers[i], receiverSize))
+            {
+                batchSize = i;
+                invalid = true;
+                break;
+            }
+            vectors[i].iov_base = const_cast<ByteT*>(batch[i].mBytes);
+            vectors[i].iov_len = batch[i].mSize;
+            messages[i].msg_hdr.msg_name = &receivers[i];
+            messages[i].msg_hdr.msg_namelen = receiverSize;
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        if (batchSize == 0)
+        {
+            return false;
+        }
+
+        // sendmmsg stops at the first datagram that fails, resending from there surfaces its error.
+        int result = sendmmsg(mSocket, messages, static_cast<unsigned int>(batchSize), 0);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            LogSocketOperationFailure("sendmmsg");
+            return false;
+        }
+        inOutCount += static_cast<SizeT>(result);
+        if (invalid && static_cast<SizeT>(result) == batchSize)
+        {
+            return false;
+        }
+    }
+    return true;
+#else
+    for (SizeT i = 0; i < count; ++i)
+    {
+        SizeT bytesSent = packets[i].mSize;
+        if (!SendTo(packets[i].mBytes, bytesSent, packets[i].mEndPoint))
+        {
+            return false;
+        }
+        ++inOutCount;
+    }
+    return true;
+#endif
+}
+
+UInt16 LF_IMPL_OPAQUE(UDPSocketPosix)::GetBoundPort() const
+{
+    Atomic32 port = AtomicLoad(&mBoundPort);
+    if (port > 0)
+    {
+        return static_cast<UInt16>(port);
+    }
+
+    sockaddr_storage address;
+    socklen_t addressLength = sizeof(address);
+    if (getsockname(mSocket, reinterpret_cast<sockaddr*>(&address), &addressLength) != 0)
+    {
+        LogSocketOperationFailure("getsockname");
+        return 0;
+    }
+    if (address.ss_family == AF_INET)
+    {
+        AtomicStore(&mBoundPort, ntohs(reinterpret_cast<sockaddr_in*>(&address)->sin_port));
+    }
+    else if (address.ss_family == AF_INET6)
+    {
+        AtomicStore(&mBoundPort, ntohs(reinterpret_cast<sockaddr_in6*>(&address)->sin6_port));
+    }
+    else
+    {
+        ReportBugMsgEx("Unexpected socket family.", LF_ERROR_INTERNAL, ERROR_API_CORE);
+    }
+    return static_cast<UInt16>(AtomicLoad(&mBoundPort));
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketPosix)::BeginReceive()
+{
+    // Shutdown sets the flag before it waits on mReceiving, so either we see the flag or it waits for us.
+    AtomicIncrement32(&mReceiving);
+    if (AtomicLoad(&mShutdown) != 0)
+    {
+        AtomicDecrement32(&mReceiving);
+        return false;
+    }
+    return true;
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketPosix)::IsAwaitingReceive() const
+{
+    return AtomicLoad(&mReceiving) > 0;
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketPosix)::Shutdown()
+{
+    AssertEx(IsAwaitingReceive(), LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+
+    bool success = true;
+    if (mSocket != LF_INVALID_SOCKET)
+    {
+        // Stop new receivers before waking the blocked ones, see BeginReceive.
+        AtomicStore(&mShutdown, 1);
+
+        // Unlike closesocket on Windows, close does not wake a blocked recvfrom, shutdown does.
+        if (shutdown(mSocket, SHUT_RDWR) != 0 && errno != ENOTCONN)
+        {
+            LogSocketOperationFailure("shutdown");
+            success = false;
+        }
+
+        // The descriptor can't be closed while a receiver may still use it, it could be reused by another open.
+        while (IsAwaitingReceive())
+        {
+            Thread::Yield();
+        }
+
+        if (close(mSocket) != 0)
+        {
+            LogSocketOperationFailure("close");
+            success = false;
+        }
+        mSocket = LF_INVALID_SOCKET;
+        mProtocol = NetProtocol::INVALID_ENUM;
+        mBoundPort = 0;
+    }
+    return success;
+}
+
+} // namespace lf
+
+#endif // LF_OS_POSIX
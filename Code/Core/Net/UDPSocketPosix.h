@@ -0,0 +1,66 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+
+#include "Core/Common/API.h"
+#include "Core/Common/Types.h"
+#include "Core/Net/NetTypes.h"
+
+namespace lf {
+
+// **********************************
+// Socket implementation using the BSD socket api, batch operations use recvmmsg/sendmmsg on Linux.
+// **********************************
+class LF_CORE_API LF_IMPL_OPAQUE(UDPSocketPosix)
+{
+public:
+    LF_IMPL_OPAQUE(UDPSocketPosix)(const LF_IMPL_OPAQUE(UDPSocketPosix)&) = delete;
+    LF_IMPL_OPAQUE(UDPSocketPosix)& operator=(const LF_IMPL_OPAQUE(UDPSocketPosix)&) = delete;
+    LF_IMPL_OPAQUE(UDPSocketPosix)();
+    LF_IMPL_OPAQUE(UDPSocketPosix)(LF_IMPL_OPAQUE(UDPSocketPosix) && other);
+    ~LF_IMPL_OPAQUE(UDPSocketPosix)();
+    LF_IMPL_OPAQUE(UDPSocketPosix)& operator=(LF_IMPL_OPAQUE(UDPSocketPosix) && other);
+    bool Create(NetProtocol::Value protocol);
+    bool Close();
+    bool Bind(UInt16 port);
+    bool ReceiveFrom(ByteT* outBytes, SizeT& inOutBytes, IPEndPointAny& outEndPoint);
+    bool SendTo(const ByteT* bytes, SizeT& inOutBytes, const IPEndPointAny& endPoint);
+    bool ReceiveBatch(UDPPacketBuffer* packets, SizeT& inOutCount);
+    bool SendBatch(const UDPPacketBuffer* packets, SizeT& inOutCount);
+    SizeT GetMaxReceiveBatch() const;
+    NetProtocol::Value GetProtocol() const { return mProtocol; }
+    UInt16 GetBoundPort() const;
+    bool IsAwaitingReceive() const;
+    bool Shutdown();
+private:
+    // ** Registers a receiver, returns false once the socket has been shutdown.
+    bool BeginReceive();
+
+    using SocketType = int;
+    SocketType         mSocket;
+    NetProtocol::Value mProtocol;
+    volatile mutable Atomic32 mBoundPort;
+    volatile Atomic32  mReceiving;
+    // ** Set by Shutdown, receivers that start after it return immediately instead of using a closed socket.
+    volatile Atomic32  mShutdown;
+};
+
+} // namespace lf
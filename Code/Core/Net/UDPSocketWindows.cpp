@@ -269,8 +269,7 @@ bool LF_IMPL_OPAQUE(UDPSocketWindows)::ReceiveFrom(ByteT* outBytes, SizeT& inOut
         return false;
     }
 
-    AssertEx(!IsAwaitingReceive(), LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
-
+    // Multiple threads may receive on the same socket, mReceiving counts them so Shutdown knows to unblock.
     sockaddr_storage sender;
     int senderAddrSize = sizeof(sender);
 
@@ -410,6 +409,49 @@ bool LF_IMPL_OPAQUE(UDPSocketWindows)::SendTo(const ByteT* bytes, SizeT& inOutBy
     return true;
 }
 
+bool LF_IMPL_OPAQUE(UDPSocketWindows)::ReceiveBatch(UDPPacketBuffer* packets, SizeT& inOutCount)
+{
+    if (packets == nullptr || inOutCount == 0)
+    {
+        return false;
+    }
+
+    // WinSock has no recvmmsg equivalent (RIO would require registered buffers), so a batch is a single datagram.
+    inOutCount = 0;
+    if (!ReceiveFrom(packets[0].mBytes, packets[0].mSize, packets[0].mEndPoint))
+    {
+        return false;
+    }
+    inOutCount = 1;
+    return true;
+}
+
+SizeT LF_IMPL_OPAQUE(UDPSocketWindows)::GetMaxReceiveBatch() const
+{
+    return 1;
+}
+
+bool LF_IMPL_OPAQUE(UDPSocketWindows)::SendBatch(const UDPPacketBuffer* packets, SizeT& inOutCount)
+{
+    if (packets == nullptr || inOutCount == 0)
+    {
+        return false;
+    }
+
+    const SizeT count = inOutCount;
+    inOutCount = 0;
+    for (SizeT i = 0; i < count; ++i)
+    {
+        SizeT bytesSent = packets[i].mSize;
+        if (!SendTo(packets[i].mBytes, bytesSent, packets[i].mEndPoint))
+        {
+            return false;
+        }
+        ++inOutCount;
+    }
+    return true;
+}
+
 UInt16 LF_IMPL_OPAQUE(UDPSocketWindows)::GetBoundPort() const
 {
     Atomic32 port = AtomicLoad(&mBoundPort);
@@ -42,6 +42,9 @@ public:
     bool Bind(UInt16 port);
     bool ReceiveFrom(ByteT* outBytes, SizeT& inOutBytes, IPEndPointAny& outEndPoint);
     bool SendTo(const ByteT* bytes, SizeT& inOutBytes, const IPEndPointAny& endPoint);
+    bool ReceiveBatch(UDPPacketBuffer* packets, SizeT& inOutCount);
+    bool SendBatch(const UDPPacketBuffer* packets, SizeT& inOutCount);
+    SizeT GetMaxReceiveBatch() const;
     NetProtocol::Value GetProtocol() const { return mProtocol; }
     UInt16 GetBoundPort() const;
     bool IsAwaitingReceive() const; 
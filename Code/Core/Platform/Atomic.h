@@ -59,6 +59,10 @@ LF_FORCE_INLINE void AtomicStore(volatile Atomic32* target, Atomic32 value)
 {
     _InterlockedExchange(target, value);
 }
+LF_FORCE_INLINE void AtomicStore(volatile Atomic64* target, Atomic64 value)
+{
+    _InterlockedExchange64(target, value);
+}
 LF_FORCE_INLINE void AtomicStore(volatile AtomicU32* target, AtomicU32 value)
 {
     AtomicStore(reinterpret_cast<volatile Atomic32*>(target), reinterpret_cast<Atomic32&>(value));
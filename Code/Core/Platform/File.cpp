@@ -608,6 +608,19 @@ SizeT File::Size() const
     return static_cast<SizeT>(GetSize());
 }
 
+bool File::Flush()
+{
+    if (!IsOpen() || !IsWriting())
+    {
+        return false;
+    }
+#if defined(LF_OS_WINDOWS)
+    return FlushFileBuffers(mHandle->mFileHandle) == TRUE;
+#else
+    LF_STATIC_CRASH("Missing implementation.");
+#endif
+}
+
 FileSize File::GetSize() const
 {
     if (!IsOpen())
@@ -66,6 +66,9 @@ public:
     // Submit a async write request, a call to this function will not block thread execution.
     // Returns true if the request was submitted succesfully
     bool WriteAsync(AsyncIOBuffer* buffer, SizeT bufferLength);
+    // Block thread execution until buffered writes have reached the disk.
+    // Returns true if the flush was successful
+    bool Flush();
     // Blocks thread execution until the async operation is complete.
     void Wait();
     // Blocks thread execution for a period of time or if the task is complete, whichever is less.
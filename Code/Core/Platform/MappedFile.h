@@ -26,17 +26,43 @@ namespace lf {
 
 struct MappedFileHandle;
 
+// **********************************
+// Maps the contents of a file into the address space of the process.
+//
+// Open maps the file for read/write access, OpenRead maps the file read-only and
+// allows other handles to keep reading/writing the file. The view returned by GetData
+// remains valid until the file is closed.
+// **********************************
 class LF_CORE_API MappedFile
 {
 public:
     MappedFile();
+    MappedFile(const MappedFile&) = delete;
     ~MappedFile();
+    MappedFile& operator=(const MappedFile&) = delete;
 
     bool Open(const char* filename);
+    // **********************************
+    // Opens an existing file and maps the entire file as a read-only view.
+    //
+    // note: Writes made to the file through other handles are visible through the view
+    //       but the size of the view is fixed at the time the file was opened.
+    // 
+    // @param filename -- The name of the file to map
+    // @returns Returns true if the file was opened and mapped.
+    // **********************************
+    bool OpenRead(const char* filename);
     void Close();
 
     bool Write(SizeT filePosition, const void* bytes, SizeT numBytes);
     bool Flush();
+
+    // ** Returns true if the file is open and mapped.
+    bool IsOpen() const;
+    // ** Returns a pointer to the beginning of the mapped view (or nullptr if not mapped)
+    const ByteT* GetData() const;
+    // ** Returns the size of the mapped view in bytes.
+    SizeT GetSize() const;
 private:
     MappedFileHandle* mHandle;
 
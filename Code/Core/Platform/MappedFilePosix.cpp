@@ -0,0 +1,163 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "Core/Common/Types.h"
+#if defined(LF_OS_POSIX)
+#include "MappedFile.h"
+#include "Core/Memory/Memory.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+namespace lf {
+
+struct MappedFileHandle
+{
+    MappedFileHandle()
+    : mFile(-1)
+    , mView(nullptr)
+    , mFileSize(0)
+    {}
+    int    mFile;
+    void*  mView;
+    SizeT  mFileSize;
+};
+
+MappedFile::MappedFile()
+: mHandle(LFNew<MappedFileHandle>())
+{}
+MappedFile::~MappedFile()
+{
+    Close();
+    LFDelete(mHandle);
+}
+
+static bool MapFile(MappedFileHandle* handle, const char* filename, int openFlags, int protection)
+{
+    handle->mFile = open(filename, openFlags, 0644);
+    if (handle->mFile == -1)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(handle->mFile, &info) != 0 || info.st_size <= 0)
+    {
+        return false;
+    }
+    handle->mFileSize = static_cast<SizeT>(info.st_size);
+
+    void* view = mmap(nullptr, handle->mFileSize, protection, MAP_SHARED, handle->mFile, 0);
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+    handle->mView = view;
+    return true;
+}
+
+bool MappedFile::Open(const char* filename)
+{
+    if (mHandle->mFile != -1)
+    {
+        return false;
+    }
+
+    if (!MapFile(mHandle, filename, O_RDWR | O_CREAT, PROT_READ | PROT_WRITE))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::OpenRead(const char* filename)
+{
+    if (mHandle->mFile != -1)
+    {
+        return false;
+    }
+
+    if (!MapFile(mHandle, filename, O_RDONLY, PROT_READ))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (mHandle->mView != nullptr)
+    {
+        munmap(mHandle->mView, mHandle->mFileSize);
+        mHandle->mView = nullptr;
+    }
+
+    if (mHandle->mFile != -1)
+    {
+        close(mHandle->mFile);
+        mHandle->mFile = -1;
+    }
+
+    mHandle->mFileSize = 0;
+}
+
+bool MappedFile::Write(SizeT filePosition, const void* bytes, SizeT numBytes)
+{
+    if (!mHandle->mView)
+    {
+        return false;
+    }
+
+    if (filePosition > mHandle->mFileSize || (filePosition + numBytes) > mHandle->mFileSize)
+    {
+        return false;
+    }
+
+    memcpy(reinterpret_cast<ByteT*>(mHandle->mView) + filePosition, bytes, numBytes);
+    return true;
+}
+
+bool MappedFile::Flush()
+{
+    return mHandle->mView && msync(mHandle->mView, mHandle->mFileSize, MS_SYNC) == 0;
+}
+
+bool MappedFile::IsOpen() const
+{
+    return mHandle->mView != nullptr;
+}
+
+const ByteT* MappedFile::GetData() const
+{
+    return reinterpret_cast<const ByteT*>(mHandle->mView);
+}
+
+SizeT MappedFile::GetSize() const
+{
+    return mHandle->mFileSize;
+}
+
+} // namespace lf
+#endif // LF_OS_POSIX
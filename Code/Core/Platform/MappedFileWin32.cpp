@@ -49,6 +49,7 @@ MappedFile::MappedFile()
 {}
 MappedFile::~MappedFile()
 {
+    Close();
     LFDelete(mHandle);
 }
 
@@ -102,9 +103,70 @@ bool MappedFile::Open(const char* filename)
         0,
         0,
         mHandle->mFileSize);
+    if (mHandle->mView == nullptr)
+    {
+        Close();
+        return false;
+    }
 
     return true;
 }
+
+bool MappedFile::OpenRead(const char* filename)
+{
+    if (mHandle->mFile != INVALID_HANDLE_VALUE
+    || mHandle->mMapping != NULL)
+    {
+        return false;
+    }
+
+    mHandle->mFile = CreateFile(
+        filename,
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+    if (mHandle->mFile == INVALID_HANDLE_VALUE)
+    {
+        Close();
+        return false;
+    }
+
+    LARGE_INTEGER filesize;
+    if (GetFileSizeEx(mHandle->mFile, &filesize) == FALSE || filesize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+    mHandle->mFileSize = static_cast<SizeT>(filesize.QuadPart);
+
+    mHandle->mMapping = CreateFileMappingA(
+        mHandle->mFile,
+        NULL,
+        PAGE_READONLY,
+        0,
+        0,
+        NULL);
+    if (mHandle->mMapping == NULL)
+    {
+        Close();
+        return false;
+    }
+
+    mHandle->mView = MapViewOfFile(mHandle->mMapping,
+        FILE_MAP_READ,
+        0,
+        0,
+        mHandle->mFileSize);
+    if (mHandle->mView == nullptr)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
 void MappedFile::Close()
 {
     if (mHandle->mView != nullptr)
@@ -140,7 +202,7 @@ bool MappedFile::Write(SizeT filePosition, const void* bytes, SizeT numBytes)
         return false;
     }
 
-    memcpy(mHandle->mView, bytes, numBytes);
+    memcpy(reinterpret_cast<ByteT*>(mHandle->mView) + filePosition, bytes, numBytes);
     return true;
 }
 
@@ -149,5 +211,20 @@ bool MappedFile::Flush()
     return FlushViewOfFile(mHandle->mView, 0) == TRUE;
 }
 
+bool MappedFile::IsOpen() const
+{
+    return mHandle->mView != nullptr;
+}
+
+const ByteT* MappedFile::GetData() const
+{
+    return reinterpret_cast<const ByteT*>(mHandle->mView);
+}
+
+SizeT MappedFile::GetSize() const
+{
+    return mHandle->mFileSize;
+}
+
 } // namespace lf
 #endif // LS_OS_WINDOWS
\ No newline at end of file
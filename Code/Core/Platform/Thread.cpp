@@ -70,6 +70,7 @@ DWORD WINAPI PlatformThreadCallback(LPVOID param)
     {
         thread->mCallback(thread->mArgs);
     }
+    LFReleaseThreadCache();
     gCurrentThread = nullptr;
     gCurrentThreadId = INVALID_THREAD_ID;
     AtomicDecrement32(&gActiveThreads);
@@ -76,7 +76,7 @@ ThreadFence& ThreadFence::operator=(ThreadFence&& other)
     return *this;
 }
 
-bool ThreadFence::Initialize()
+bool ThreadFence::Initialize(bool autoReset)
 {
 #if defined(LF_OS_WINDOWS)
     if (mHandle)
@@ -84,7 +84,7 @@ bool ThreadFence::Initialize()
         return false;
     }
 
-    HANDLE event = CreateEventA(NULL, TRUE, FALSE, NULL);;
+    HANDLE event = CreateEventA(NULL, autoReset ? FALSE : TRUE, FALSE, NULL);
     if (event == NULL)
     {
         return false;
@@ -52,7 +52,11 @@ public:
 
     // Initializes the thread fence, the sychronization functions below will
     // fail if the fence is not initialized.
-    bool Initialize();
+    //
+    // An auto reset fence releases a single waiter when it is Set(false) and then
+    // goes back to blocking. If nobody is waiting the fence stays open until the
+    // next Wait, so a wakeup raised just before a thread starts waiting is not lost.
+    bool Initialize(bool autoReset = false);
     // Destroys resources allocated by the thread fence (internal handle will be kept
     // until all references have been destroyed)
     void Destroy();
@@ -60,6 +64,7 @@ public:
     // Changes the fence value to suspend/resume execution of waiting threads.
     bool Set(bool isBlocking);
     // Sends a signal to all those waiting on the fence to continue execution
+    // note: Only threads already waiting are released, prefer Set(false) on an auto reset fence.
     bool Signal();
     // Wait for signal to be sent or for the event to resume execution.
     WaitStatus Wait(SizeT milliseconds = INVALID);
@@ -27,6 +27,8 @@ Type::Type() :
 mName(),
 mFullName(),
 mSuper(nullptr),
+mPreOrder(INVALID32),
+mPostOrder(INVALID32),
 mSize(0),
 mAlignment(0),
 mFlags(static_cast<TypeFlags>(0)),
@@ -37,7 +39,7 @@ mMethods(),
 mFunctions()
 {}
 
-bool Type::IsA(const Type* other) const
+bool Type::IsAHierarchy(const Type* other) const
 {
     const Type* iter = this;
     while (iter)
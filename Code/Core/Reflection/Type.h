@@ -48,7 +48,21 @@ public:
 
     Type();
 
-    bool IsA(const Type* other) const;
+    // ********************************************************************
+    // Returns true if this type is 'other' or derives from 'other'.
+    //
+    // Once the ReflectionMgr has built the types every type is numbered with
+    // a pre-order and post-order traversal of the class hierarchy, a type is
+    // an ancestor of another if its interval contains the others interval.
+    // ********************************************************************
+    LF_INLINE bool IsA(const Type* other) const
+    {
+        if (other && Valid(mPreOrder) && Valid(other->mPreOrder))
+        {
+            return other->mPreOrder <= mPreOrder && mPostOrder <= other->mPostOrder;
+        }
+        return IsAHierarchy(other);
+    }
     // ********************************************************************
     // Returns the inheritence distance between two types.
     // 
@@ -82,9 +96,16 @@ public:
     LF_INLINE bool IsEnum() const { return (mFlags & TF_ENUM) > 0; }
     LF_INLINE bool IsNative() const { return (mFlags & TF_NATIVE) > 0; }
 private:
+    // ** Walks the super chain, used for types that have not been numbered.
+    bool IsAHierarchy(const Type* other) const;
+
     Token               mName;
     Token               mFullName;
     const Type*         mSuper;
+    // ** Position of the type in a pre-order traversal of the class hierarchy
+    UInt32              mPreOrder;
+    // ** Position of the type in a post-order traversal of the class hierarchy
+    UInt32              mPostOrder;
     SizeT               mSize;
     SizeT               mAlignment;
     UInt8               mFlags;
@@ -36,7 +36,7 @@ StringHashTable::HashedString StringHashTable::Create(const char* string, SizeT
     const char* stringEnd = string + len;
 
     // hash(s)
-    HashType hash = FNV::Hash(string, len);
+    HashType hash = WyHash::Hash(string, len);
     Assert(Valid(hash));
     // bucket(h, s)
     auto& bucket = mMap[hash];
@@ -78,7 +78,7 @@ StringHashTable::HashedString StringHashTable::Find(const char* string, SizeT le
     const char* stringEnd = string + len;
 
     // hash(s)
-    HashType hash = FNV::Hash(string, len);
+    HashType hash = WyHash::Hash(string, len);
     Assert(Valid(hash));
 
     // bucket(h, s)
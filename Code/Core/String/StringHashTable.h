@@ -24,7 +24,7 @@
 #include "Core/Common/API.h"
 #include "Core/String/StringUtil.h"
 #include "Core/Utility/Array.h"
-#include "Core/Utility/FNVHash.h"
+#include "Core/Utility/WyHash.h"
 #include <unordered_map>
 
 namespace lf {
@@ -33,7 +33,7 @@ namespace lf {
 class LF_CORE_API StringHashTable
 {
 public:
-    using HashType = FNV::HashT;
+    using HashType = WyHash::HashT;
     struct HashedString
     {
         HashedString() : mHash(0), mString(nullptr) {}
@@ -48,6 +48,9 @@ public:
     LF_FORCE_INLINE Token(const value_type* string, CopyOnWriteTag);
     LF_FORCE_INLINE Token(const String& string);
     LF_FORCE_INLINE Token(const String& string, AcquireTag);
+    // ** Creates an immortal token, copies and destruction of immortal tokens are not reference counted.
+    LF_FORCE_INLINE Token(const value_type* string, ImmortalTag);
+    LF_FORCE_INLINE Token(const String& string, ImmortalTag);
     LF_INLINE ~Token();
 
     LF_INLINE Token& operator=(const Token& other)
@@ -89,6 +92,8 @@ public:
     const char* CStr() const;
     SizeT Size() const;
     bool Empty() const;
+    // ** Returns true if the token is not reference counted. (Created with IMMORTAL or COPY_ON_WRITE)
+    bool IsImmortal() const;
 
     bool AlphaLess(const String& string) const;
     bool AlphaLess(const value_type* string) const;
@@ -118,6 +123,8 @@ private:
     void LookUp(const value_type* string);
     void LookUp(const String& string);
     void LookUp(const String& string, AcquireTag);
+    void LookUp(const value_type* string, ImmortalTag);
+    void LookUp(const String& string, ImmortalTag);
 
     const value_type* mString;
     UInt16 mKey;
@@ -184,6 +191,20 @@ Token::Token(const String& string, AcquireTag)
 {
     LookUp(string, ACQUIRE);
 }
+Token::Token(const value_type* string, ImmortalTag)
+: mString(gNullString)
+, mKey(INVALID16)
+, mSize(0)
+{
+    LookUp(string, IMMORTAL);
+}
+Token::Token(const String& string, ImmortalTag)
+: mString(gNullString)
+, mKey(INVALID16)
+, mSize(0)
+{
+    LookUp(string, IMMORTAL);
+}
 Token::~Token()
 {
     Clear();
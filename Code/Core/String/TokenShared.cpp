@@ -24,6 +24,7 @@
 #include "Core/Common/Assert.h"
 #include "Core/Utility/ErrorCore.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Platform/Atomic.h"
 #include "Core/String/StringUtil.h"
 #include "Core/String/String.h"
 
@@ -36,6 +37,18 @@ const Token EMPTY_TOKEN;
 TokenTable* gTokenTable = nullptr;
 static const SizeT TOKEN_TABLE_SIZE = 20000;
 static const SizeT MAX_TOKEN_SIZE = 0xFFFF;
+LF_STATIC_ASSERT(TOKEN_TABLE_SIZE < TokenTable::IMMORTAL_KEY);
+// ** The node has been unlinked, it can no longer be referenced.
+static const Atomic32 DEAD_REF = -1;
+// ** An immortal token shares the string, the node is never reclaimed.
+static const Atomic32 PIN_REF = 0x40000000;
+static const Atomic32 REF_MASK = PIN_REF - 1;
+// ** The number of releases (per thread) between reclaim passes.
+static const SizeT RECLAIM_INTERVAL = 4096;
+
+static volatile Atomic32 gTokenReaderStripeNext = 0;
+LF_THREAD_LOCAL SizeT gTokenReaderStripe = INVALID;
+LF_THREAD_LOCAL SizeT gTokenReleaseCount = 0;
 static UInt32 HashString(const char*& string)
 {
     const UInt32 magic = 0x3CD6432D;
@@ -49,19 +62,99 @@ static UInt32 HashString(const char*& string)
     return seed;
 }
 
+// ** Registers a look up with the current epoch, nodes it can reach are not freed until the scope ends.
+struct TokenTable::ReadScope
+{
+    ReadScope(TokenTable& table) : mCounter(nullptr)
+    {
+        if (Invalid(gTokenReaderStripe))
+        {
+            gTokenReaderStripe = static_cast<SizeT>(AtomicIncrement32(&gTokenReaderStripeNext)) % READER_STRIPES;
+        }
+        ReaderCounter& stripe = table.mReaders[gTokenReaderStripe];
+        while (true)
+        {
+            // ** A reclaim pass that advances the epoch after we registered must see our counter, otherwise we retry.
+            const Atomic32 epoch = AtomicLoad(&table.mEpoch);
+            mCounter = &stripe.mValue[epoch & 1];
+            AtomicIncrement32(mCounter);
+            if (AtomicLoad(&table.mEpoch) == epoch)
+            {
+                break;
+            }
+            AtomicDecrement32(mCounter);
+        }
+    }
+    ~ReadScope()
+    {
+        AtomicDecrement32(mCounter);
+    }
+
+    volatile Atomic32* mCounter;
+};
+
+// ** Adds a reference if the reference count is at least 'minCount', dead nodes are never revived.
+static bool TryAddReference(TokenTable::HashNode* node, Atomic32 minCount)
+{
+    Atomic32 count = AtomicLoad(&node->mRefCount);
+    while (count >= minCount && count >= 0)
+    {
+        const Atomic32 previous = AtomicCompareExchange(&node->mRefCount, count + 1, count);
+        if (previous == count)
+        {
+            return true;
+        }
+        count = previous;
+    }
+    return false;
+}
+
+// ** Marks the node as shared with an immortal token so it's never reclaimed.
+static bool TryPin(TokenTable::HashNode* node)
+{
+    Atomic32 count = AtomicLoad(&node->mRefCount);
+    while (count >= 0)
+    {
+        if ((count & PIN_REF) != 0)
+        {
+            return true;
+        }
+        const Atomic32 previous = AtomicCompareExchange(&node->mRefCount, count | PIN_REF, count);
+        if (previous == count)
+        {
+            return true;
+        }
+        count = previous;
+    }
+    return false;
+}
+
 TokenTable::TokenTable() :
 mMap(nullptr),
 mMapSize(0),
-mLock(),
-mShutdown(false)
+mShutdown(false),
+mReaders(),
+mEpoch(0),
+mReclaimLock(),
+mRetired(nullptr)
 {
-
+    for (SizeT i = 0; i < READER_STRIPES; ++i)
+    {
+        mReaders[i].mValue[0] = 0;
+        mReaders[i].mValue[1] = 0;
+    }
 }
 TokenTable::~TokenTable()
 {
     CriticalAssertEx(mMap == nullptr, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
 }
 
+// ** Mortal tokens always reference a string stored immediately after its node.
+static LF_INLINE TokenTable::HashNode* GetMortalNode(const char* string)
+{
+    return reinterpret_cast<TokenTable::HashNode*>(const_cast<char*>(string)) - 1;
+}
+
 void TokenTable::LookUp(const char* string, Token& token, AcquireTag)
 {
     if (mMap == nullptr)
@@ -85,8 +178,25 @@ void TokenTable::LookUp(const char* string, Token& token, AcquireTag)
         return;
     }
 
-    ScopedCriticalSection lock(mLock);
-    AcquireNode(token, key, string, end, static_cast<UInt16>(hashIdx));
+    ReadScope scope(*this);
+    HashNode* node = Find(AtomicLoadPointer(&key.mHead), nullptr, string, static_cast<SizeT>(end - string), hash);
+    if (!node)
+    {
+        return;
+    }
+
+    if (node->mOwnsString)
+    {
+        // ** An unreferenced string is treated as missing, it may be reclaimed at any time.
+        if (TryAddReference(node, 1))
+        {
+            Assign(token, node, static_cast<UInt16>(hashIdx));
+        }
+    }
+    else
+    {
+        Assign(token, node, IMMORTAL_KEY);
+    }
 }
 void TokenTable::LookUp(const char* string, Token& token, CopyOnWriteTag)
 {
@@ -111,23 +221,10 @@ void TokenTable::LookUp(const char* string, Token& token, CopyOnWriteTag)
         return;
     }
 
-    // Node LookUp:
-    ScopedCriticalSection lock(mLock);
-    bool found = AcquireNode(token, key, string, end, static_cast<UInt16>(hashIdx));
-    if (!found)
-    {
-        // Allocate node:
-        HashNode& node = AllocateNode(key);
-        // Initialize node:
-        node.mString = const_cast<char*>(string);
-        _InterlockedExchange(&node.mRefCount, 1);
-        node.mReleaseOnDestroy = false;
-        node.mSize = static_cast<UInt16>(end - string);
-
-        token.mSize = node.mSize;
-        token.mString = node.mString;
-        token.mKey = static_cast<UInt16>(hashIdx);
-    }
+    // Copy-on-write strings are assumed static so the token never has to be reference counted.
+    ReadScope scope(*this);
+    HashNode* node = FindOrInsert(key, string, static_cast<SizeT>(end - string), hash, false, true);
+    Assign(token, node, IMMORTAL_KEY);
 }
 void TokenTable::LookUp(const char* string, Token& token)
 {
@@ -152,25 +249,36 @@ void TokenTable::LookUp(const char* string, Token& token)
         return;
     }
 
-    // Node LookUp:
-    ScopedCriticalSection lock(mLock);
-    bool found = AcquireNode(token, key, string, end, static_cast<UInt16>(hashIdx));
-    if (!found)
+    ReadScope scope(*this);
+    HashNode* node = FindOrInsert(key, string, static_cast<SizeT>(end - string), hash, true, false);
+    Assign(token, node, node->mOwnsString ? static_cast<UInt16>(hashIdx) : IMMORTAL_KEY);
+}
+void TokenTable::LookUp(const char* string, Token& token, ImmortalTag)
+{
+    if (mMap == nullptr)
+    {
+        CriticalAssertMsgEx("Token table not initialized! Use STATIC_TOKEN instead.", LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
+        return;
+    }
+    if (string == gNullString || string == nullptr || *string == '\0')
     {
-        // Allocate node:
-        HashNode& node = AllocateNode(key);
-        // Initialize node:
-        const SizeT bufferSize = (end - string) + 1;
-        node.mString = static_cast<char*>(LFAlloc(bufferSize, 16));
-        memcpy(node.mString, string, bufferSize);
-        _InterlockedExchange(&node.mRefCount, 1);
-        node.mReleaseOnDestroy = true;
-        node.mSize = static_cast<UInt16>(end - string);
+        return;
+    }
 
-        token.mSize = node.mSize;
-        token.mString = node.mString;
-        token.mKey = static_cast<UInt16>(hashIdx);
+    const char* end = string;
+    UInt32 hash = HashString(end);
+    UInt32 hashIdx = hash % mMapSize;
+    HashKey& key = mMap[hashIdx];
+
+    if ((end - string) > MAX_TOKEN_SIZE)
+    {
+        CriticalAssertMsgEx("Token string is too large.", LF_ERROR_INVALID_ARGUMENT, ERROR_API_CORE);
+        return;
     }
+
+    ReadScope scope(*this);
+    HashNode* node = FindOrInsert(key, string, static_cast<SizeT>(end - string), hash, true, true);
+    Assign(token, node, IMMORTAL_KEY);
 }
 
 void TokenTable::IncrementReference(Token& token)
@@ -180,21 +288,15 @@ void TokenTable::IncrementReference(Token& token)
         CriticalAssertMsgEx("Token table not initialized! Use STATIC_TOKEN instead.", LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
         return;
     }
-    if (token.mString == gNullString)
+    if (token.mString == gNullString || token.mKey >= IMMORTAL_KEY)
     {
         return;
     }
     AssertEx(token.mKey < mMapSize, LF_ERROR_BAD_STATE, ERROR_API_CORE);
-    HashKey& key = mMap[token.mKey];
-    ScopedCriticalSection lock(mLock);
-    HashNode* node = AcquireNode(token, key);
-    if (node)
-    {
-        const long MAX_TOKEN_REF = 0x7FFFFFFF;
-        _ReadWriteBarrier();
-        AssertEx(node->mRefCount != MAX_TOKEN_REF, LF_ERROR_BAD_STATE, ERROR_API_CORE);
-        _InterlockedIncrement(&node->mRefCount);
-    }
+    HashNode* node = GetMortalNode(token.mString);
+    // ** The token holds a reference so the node can't die while we add another.
+    AssertEx((AtomicLoad(&node->mRefCount) & REF_MASK) != REF_MASK, LF_ERROR_BAD_STATE, ERROR_API_CORE);
+    AtomicIncrement32(&node->mRefCount);
 }
 void TokenTable::DecrementReference(Token& token)
 {
@@ -203,79 +305,113 @@ void TokenTable::DecrementReference(Token& token)
         CriticalAssertMsgEx("Token table not initialized! Use STATIC_TOKEN instead.", LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
         return;
     }
-    if (token.mString == gNullString)
+    if (token.mString == gNullString || token.mKey >= IMMORTAL_KEY)
     {
         return;
     }
     AssertEx(token.mKey < mMapSize, LF_ERROR_BAD_STATE, ERROR_API_CORE);
-    HashKey& key = mMap[token.mKey];
-    ScopedCriticalSection lock(mLock);
-    HashNode* node = AcquireNode(token, key);
-    if (node)
-    {
-        _ReadWriteBarrier();
-        AssertEx(node->mRefCount > 0, LF_ERROR_BAD_STATE, ERROR_API_CORE);
-        if (_InterlockedDecrement(&node->mRefCount) == 0)
+    HashNode* node = GetMortalNode(token.mString);
+    // ** Unreferenced nodes stay in the table until the next reclaim pass.
+    const Atomic32 count = AtomicDecrement32(&node->mRefCount);
+    AssertEx(count >= 0 && (count & REF_MASK) != REF_MASK, LF_ERROR_BAD_STATE, ERROR_API_CORE);
+    if (count == 0 && ++gTokenReleaseCount >= RECLAIM_INTERVAL)
+    {
+        gTokenReleaseCount = 0;
+        ScopeTryLock lock(mReclaimLock);
+        if (lock.IsLocked())
         {
-            // Deallocate:
-            if (node->mReleaseOnDestroy)
+            ReclaimLocked();
+        }
+    }
+}
+
+SizeT TokenTable::Reclaim()
+{
+    if (mMap == nullptr)
+    {
+        return 0;
+    }
+    ScopeLock lock(mReclaimLock);
+    return ReclaimLocked();
+}
+
+SizeT TokenTable::ReclaimLocked()
+{
+    SizeT numFreed = 0;
+    const Atomic32 epoch = AtomicLoad(&mEpoch);
+    if (mRetired)
+    {
+        // ** The retired nodes were unlinked before the epoch advanced, only look ups of the previous epoch can see them.
+        const SizeT previous = static_cast<SizeT>(epoch - 1) & 1;
+        for (SizeT i = 0; i < READER_STRIPES; ++i)
+        {
+            if (AtomicLoad(&mReaders[i].mValue[previous]) != 0)
             {
-                LFFree(node->mString);
+                return 0; // Try again on the next pass.
             }
+        }
 
-            if (key.UsePrimary())
+        while (mRetired)
+        {
+            HashNode* next = mRetired->mNextRetired;
+            LFFree(mRetired);
+            mRetired = next;
+            ++numFreed;
+        }
+    }
+
+    bool retired = false;
+    for (SizeT k = 0; k < mMapSize; ++k)
+    {
+        HashKey& key = mMap[k];
+        HashNode* previous = nullptr;
+        HashNode* node = AtomicLoadPointer(&key.mHead);
+        while (node)
+        {
+            HashNode* next = AtomicLoadPointer(&node->mNext);
+            if (!node->mOwnsString || AtomicCompareExchange(&node->mRefCount, DEAD_REF, 0) != 0)
             {
-                node->mRefCount = 0;
-                node->mReleaseOnDestroy = 0;
-                node->mSize = 0;
-                node->mString = nullptr;
+                previous = node;
+                node = next;
+                continue;
             }
-            else
-            {
-
-                const SizeT oldSize = key.GetSize();
-                const SizeT newSize = oldSize - 1;
 
-                if (newSize == 1)
-                {
-                    AssertEx(oldSize == 2, LF_ERROR_BAD_STATE, ERROR_API_CORE);
-                    if (node->mString == key.mList[0].mString)
-                    {
-                        node = &key.mList[1];
-                    }
-                    else
-                    {
-                        node = &key.mList[0];
-                    }
-                    HashNode& primary = key.mPrimary;
-                    primary.mString = node->mString;
-                    primary.mSize = node->mSize;
-                    primary.mReleaseOnDestroy = node->mReleaseOnDestroy;
-                    primary.mRefCount = node->mRefCount;
-                    node = nullptr;
-
-                    LFFree(key.mList);
-                    key.mList = nullptr;
-                }
-                else
+            // ** Only the reclaim pass writes the next pointer of a published node, inserts only move the head.
+            if (!previous && AtomicCompareExchangePointer(&key.mHead, next, node) != node)
+            {
+                previous = AtomicLoadPointer(&key.mHead);
+                while (AtomicLoadPointer(&previous->mNext) != node)
                 {
-                    // Swap Erase:
-                    HashNode* last = &(key.mList[newSize]);
-                    node->mString = last->mString;
-                    node->mRefCount = last->mRefCount;
-                    node->mSize = last->mSize;
-                    node->mReleaseOnDestroy = last->mReleaseOnDestroy;
-                    node = nullptr;
-
-                    HashNode* newList = static_cast<HashNode*>(LFAlloc(newSize * sizeof(HashNode), 16));
-                    memcpy(newList, key.mList, sizeof(HashNode) * newSize);
-                    LFFree(key.mList);
-                    key.mList = newList;
-                    key.mPrimary.mSize = static_cast<UInt16>(newSize);
+                    previous = AtomicLoadPointer(&previous->mNext);
                 }
             }
+            if (previous)
+            {
+                AtomicStorePointer(&previous->mNext, next);
+            }
+
+            // ** Look ups walking the bucket may still be on the node, its next pointer is left intact.
+            node->mNextRetired = mRetired;
+            mRetired = node;
+            retired = true;
+            node = next;
         }
     }
+
+    if (retired)
+    {
+        AtomicIncrement32(&mEpoch);
+    }
+    return numFreed;
+}
+
+SizeT TokenTable::GetReferenceCount(const Token& token) const
+{
+    if (mMap == nullptr || token.mString == gNullString || token.mKey >= IMMORTAL_KEY)
+    {
+        return 0;
+    }
+    return static_cast<SizeT>(AtomicLoad(&GetMortalNode(token.mString)->mRefCount) & REF_MASK);
 }
 
 void TokenTable::Initialize()
@@ -285,44 +421,30 @@ void TokenTable::Initialize()
     mMapSize = TOKEN_TABLE_SIZE;
     for (SizeT i = 0; i < mMapSize; ++i)
     {
-        mMap[i] = HashKey();
+        mMap[i].mHead = nullptr;
     }
-    mLock.Initialize();
 }
 void TokenTable::Release()
 {
     AssertEx(mMap != nullptr, LF_ERROR_INVALID_OPERATION, ERROR_API_CORE);
-    mLock.Destroy();
-    // Release all string memory...
-    // Release all nodes...
-    // Release all keys...
-
+    // Release all nodes, (strings are stored with their node)
     for (SizeT k = 0; k < mMapSize; ++k)
     {
-        HashKey& key = mMap[k];
-        if (key.UsePrimary())
-        {
-            if (key.mPrimary.mString && key.mPrimary.mReleaseOnDestroy)
-            {
-                LFFree(key.mPrimary.mString);
-            }
-        }
-        else
+        HashNode* node = mMap[k].mHead;
+        while (node)
         {
-            SizeT size = key.GetSize();
-            for (SizeT i = 0; i < size; ++i)
-            {
-                HashNode& node = key.mList[i];
-                if (node.mString && node.mReleaseOnDestroy)
-                {
-                    LFFree(node.mString);
-                }
-            }
-            // Assumed static.. This memory will be freed with the process!
-            LFFree(key.mList);
-            key.mList = nullptr;
-            key.mPrimary.mSize = 0;
+            HashNode* next = node->mNext;
+            LFFree(node);
+            node = next;
         }
+        mMap[k].mHead = nullptr;
+    }
+    // Unlinked nodes are no longer in any bucket.
+    while (mRetired)
+    {
+        HashNode* next = mRetired->mNextRetired;
+        LFFree(mRetired);
+        mRetired = next;
     }
     // Assumed static..
     LFFree(mMap);
@@ -335,104 +457,82 @@ void TokenTable::Shutdown()
     mShutdown = true;
 }
 
-bool TokenTable::AcquireNode(Token& token, HashKey& key, const char* begin, const char* end, UInt16 hashIdx)
+TokenTable::HashNode* TokenTable::Find(HashNode* first, HashNode* last, const char* begin, SizeT size, UInt32 hash) const
 {
-    if (key.UsePrimary())
+    // ** 'last' may have been unlinked, so the walk also stops at the end of the bucket.
+    for (HashNode* node = first; node && node != last; node = AtomicLoadPointer(&node->mNext))
     {
-        char* other = key.mPrimary.mString;
-        char* otherEnd = other + key.mPrimary.mSize;
-        if (StrEqual(begin, other, end, otherEnd))
+        if (node->mHash == hash && node->mSize == size && AtomicLoad(&node->mRefCount) != DEAD_REF && memcmp(node->mString, begin, size) == 0)
         {
-            token.mKey = hashIdx;
-            token.mString = other;
-            token.mSize = static_cast<UInt16>(end - begin);
-            _InterlockedIncrement(&key.mPrimary.mRefCount);
-            return true;
+            return node;
         }
     }
-    else
-    {
-        const SizeT size = key.GetSize();
-        for (SizeT i = 0; i < size; ++i)
-        {
-            HashNode& node = key.mList[i];
-            char* other = node.mString;
-            char* otherEnd = other + node.mSize;
-            if (StrEqual(begin, other, end, otherEnd))
-            {
-                token.mKey = hashIdx;
-                token.mString = other;
-                token.mSize = static_cast<UInt16>(end - begin);
-                _InterlockedIncrement(&key.mList[i].mRefCount);
-                return true;
-            }
-        }
-    }
-    return false;
+    return nullptr;
 }
-TokenTable::HashNode* TokenTable::AcquireNode(Token& token, HashKey& key)
+
+// ** Returns a node that holds a reference (or a pin if immortal) for the caller. Must be called within a ReadScope.
+TokenTable::HashNode* TokenTable::FindOrInsert(HashKey& key, const char* begin, SizeT size, UInt32 hash, bool copyString, bool immortal)
 {
-    if (key.UsePrimary())
-    {
-        return &key.mPrimary;
-    }
-    else
+    HashNode* head = AtomicLoadPointer(&key.mHead);
+    HashNode* node = Find(head, nullptr, begin, size, hash);
+    while (node)
     {
-        const SizeT size = key.GetSize();
-        for (SizeT i = 0; i < size; ++i)
+        if (!node->mOwnsString || (immortal ? TryPin(node) : TryAddReference(node, 0)))
         {
-            // Token should have localized string, so this is valid compare!
-            if (key.mList[i].mString == token.mString)
-            {
-                return &key.mList[i];
-            }
+            return node;
         }
+        // ** The node was reclaimed before we got a reference, look for a newer node before inserting one.
+        head = AtomicLoadPointer(&key.mHead);
+        node = Find(head, nullptr, begin, size, hash);
     }
-    return nullptr;
-}
-TokenTable::HashNode& TokenTable::AllocateNode(HashKey& key)
-{
-    if (key.GetSize() == 0)
+
+    HashNode* created = nullptr;
+    if (copyString)
     {
-        return key.mPrimary;
+        created = static_cast<HashNode*>(LFAlloc(sizeof(HashNode) + size + 1, alignof(HashNode)));
+        char* string = reinterpret_cast<char*>(created + 1);
+        memcpy(string, begin, size);
+        string[size] = '\0';
+        created->mString = string;
     }
-    
-    // Reallocate from using single to chained tokens:
-    if (key.UsePrimary())
+    else
     {
-        HashNode data = key.mPrimary;
-        key.mPrimary = HashNode();
-        key.mList = static_cast<HashNode*>(LFAlloc(2 * sizeof(HashNode), 16));
-        key.mList[0] = data;
-        key.mPrimary.mSize = 2;
-        return key.mList[1];
+        created = static_cast<HashNode*>(LFAlloc(sizeof(HashNode), alignof(HashNode)));
+        created->mString = begin;
     }
-    else
+    created->mRefCount = immortal ? PIN_REF : 1;
+    created->mNextRetired = nullptr;
+    created->mHash = hash;
+    created->mSize = static_cast<UInt16>(size);
+    created->mOwnsString = copyString;
+
+    while (true)
     {
-        HashNode* oldList = key.mList;
-        const SizeT oldSize = key.GetSize();
-        HashNode* newList = static_cast<HashNode*>(LFAlloc((oldSize + 1) * sizeof(HashNode), 16));
-        if (oldList)
+        created->mNext = head;
+        HashNode* previous = AtomicCompareExchangePointer(&key.mHead, created, head);
+        if (previous == head)
         {
-            for (SizeT i = 0; i < oldSize; ++i)
-            {
-                newList[i] = oldList[i];
-            }
-            LFFree(oldList);
+            return created;
         }
-        else
+
+        // ** Another thread pushed onto the bucket, only the nodes it pushed have to be checked for our string.
+        node = Find(previous, head, begin, size, hash);
+        if (node && (!node->mOwnsString || (immortal ? TryPin(node) : TryAddReference(node, 0))))
         {
-            newList[0] = key.mPrimary;
-            key.mPrimary.mString = nullptr;
-            key.mPrimary.mRefCount = 0;
-            key.mPrimary.mReleaseOnDestroy = false;
+            LFFree(created);
+            return node;
         }
-        key.mList = newList;
-        key.mPrimary.mSize = static_cast<UInt16>(oldSize + 1);
-        return newList[oldSize];
+        head = previous;
     }
 }
 
+void TokenTable::Assign(Token& token, const HashNode* node, UInt16 key)
+{
+    token.mString = node->mString;
+    token.mSize = node->mSize;
+    token.mKey = key;
+}
+
 void Token::Clear()
 {
     if (mString != gNullString)
@@ -529,13 +629,24 @@ SizeT Token::FindLastAgnostic(const value_type* string) const
 {
     return StrFindLastAgnostic(mString, mString + mSize, string);
 }
+bool Token::IsImmortal() const
+{
+    return mKey == TokenTable::IMMORTAL_KEY;
+}
 void Token::DecrementRef()
 {
-    gTokenTable->DecrementReference(*this);
+    // ** Null and immortal tokens don't reference count, avoid the call entirely.
+    if (mKey < TokenTable::IMMORTAL_KEY)
+    {
+        gTokenTable->DecrementReference(*this);
+    }
 }
 void Token::IncrementRef()
 {
-    gTokenTable->IncrementReference(*this);
+    if (mKey < TokenTable::IMMORTAL_KEY)
+    {
+        gTokenTable->IncrementReference(*this);
+    }
 }
 void Token::LookUp(const value_type* string, AcquireTag)
 {
@@ -557,5 +668,13 @@ void Token::LookUp(const String& string, AcquireTag)
 {
     gTokenTable->LookUp(string.CStr(), *this, ACQUIRE);
 }
+void Token::LookUp(const value_type* string, ImmortalTag)
+{
+    gTokenTable->LookUp(string, *this, IMMORTAL);
+}
+void Token::LookUp(const String& string, ImmortalTag)
+{
+    gTokenTable->LookUp(string.CStr(), *this, IMMORTAL);
+}
 
 } // namespace lf
\ No newline at end of file
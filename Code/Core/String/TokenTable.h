@@ -22,7 +22,7 @@
 
 #include "Core/Common/Types.h"
 #include "Core/Common/API.h"
-#include "Core/Platform/CriticalSection.h"
+#include "Core/Platform/SpinLock.h"
 
 namespace lf {
 
@@ -30,60 +30,100 @@ class Token;
 class TokenTable;
 LF_CORE_API extern TokenTable* gTokenTable;
 
+// **********************************
+// Interns the strings used by Tokens.
+//
+// The table is lock-free. Each bucket is a singly linked list of nodes, new nodes are pushed onto the
+// head with a compare-exchange so inserts never block. A node that is no longer referenced stays in the
+// table until the next reclaim pass, until then a look up of the same string picks it up again.
+//
+// Reclamation is epoch based: look ups register with the current epoch while they walk a bucket. A
+// reclaim pass (one at a time) marks unreferenced nodes dead, unlinks them and advances the epoch, the
+// unlinked nodes are freed by a later pass once no look up of the previous epoch is still running.
+// Passes run every RECLAIM_INTERVAL releases (per thread) or when Reclaim is called.
+//
+// Tokens are reference counted with a single atomic operation on their node. Immortal tokens (created
+// with IMMORTAL, and every COPY_ON_WRITE token) skip reference counting entirely which makes copying
+// and destroying them free of any shared memory traffic.
+// **********************************
 class LF_CORE_API TokenTable
 {
 public:
+    // ** The key given to tokens that are not reference counted.
+    static const UInt16 IMMORTAL_KEY = 0xFFFE;
+
     struct HashNode
     {
-        HashNode() :
-            mString(nullptr),
-            mRefCount(0),
-            mReleaseOnDestroy(false),
-            mSize(0)
-        {}
-        char* mString;
-        long  mRefCount;
-        UInt16 mSize;
-        bool   mReleaseOnDestroy;
+        // ** Next node in the bucket. Once the node is published only ReclaimLocked rewrites it (under mReclaimLock)
+        //    to unlink a dead successor, inserts only move the bucket head. Readers may still be walking an unlinked
+        //    node, its own mNext is left intact and the epoch keeps it alive until they leave.
+        HashNode* volatile mNext;
+        // ** The string of the node, stored immediately after the node unless it's a copy-on-write node.
+        const char*        mString;
+        // ** The reference count of mortal tokens, PIN_REF is set once an immortal token shares the string and
+        //    DEAD_REF once the node is unlinked.
+        volatile Atomic32  mRefCount;
+        // ** Next node in the list of nodes waiting to be freed.
+        HashNode*          mNextRetired;
+        UInt32             mHash;
+        UInt16             mSize;
+        // ** Whether or not the string is stored with the node (copy-on-write strings are not)
+        bool               mOwnsString;
     };
     struct HashKey
     {
-        HashKey() :
-            mPrimary(),
-            mList(nullptr)
-        {}
-        bool UsePrimary() const { return mList == nullptr; }
-        SizeT GetSize() const { return UsePrimary() ? (mPrimary.mString ? 1 : 0) : mPrimary.mSize; }
-
-        HashNode mPrimary; // Note: mPrimary.mSize == sizeof list when mList != nullptr
-        HashNode* mList;
+        HashNode* volatile mHead;
     };
+
     TokenTable();
     ~TokenTable();
 
     // Look up token info. ( Do not allocate if it doesn't exist. )
     void LookUp(const char* string, Token& token, AcquireTag);
-    // Look up token info. ( Will not copy the string to StringHeap )
+    // Look up token info. ( Will not copy the string to StringHeap, the string must outlive the table. The token is immortal. )
     void LookUp(const char* string, Token& token, CopyOnWriteTag);
     // Look up token info. ( Will copy to StringHeap if it does not exist. )
     void LookUp(const char* string, Token& token);
+    // Look up token info. ( Will copy to StringHeap if it does not exist. The token is immortal. )
+    void LookUp(const char* string, Token& token, ImmortalTag);
 
     void IncrementReference(Token& token);
     void DecrementReference(Token& token);
 
+    // ** Unlinks unreferenced strings and frees the strings unlinked by the previous call if no look up can still see them.
+    // @returns Returns the number of nodes freed.
+    SizeT Reclaim();
+
+    // ** Returns the number of references held by mortal tokens of the string (for debugging)
+    SizeT GetReferenceCount(const Token& token) const;
+
     void Initialize();
     void Release();
     void Shutdown();
 private:
-    bool AcquireNode(Token& token, HashKey& key, const char* begin, const char* end, UInt16 hashIdx);
-    HashNode* AcquireNode(Token& token, HashKey& key);
-    HashNode& AllocateNode(HashKey& key);
+    enum { READER_STRIPES = 8 };
+    struct LF_ALIGN(64) ReaderCounter
+    {
+        // ** Look ups in progress, indexed by the parity of the epoch they registered with.
+        volatile Atomic32 mValue[2];
+    };
+    struct ReadScope;
+
+    HashNode* Find(HashNode* first, HashNode* last, const char* begin, SizeT size, UInt32 hash) const;
+    HashNode* FindOrInsert(HashKey& key, const char* begin, SizeT size, UInt32 hash, bool copyString, bool immortal);
+    SizeT ReclaimLocked();
+    static void Assign(Token& token, const HashNode* node, UInt16 key);
 
     HashKey* mMap;
     SizeT    mMapSize;
+    bool     mShutdown;
 
-    CriticalSection mLock;
-    bool mShutdown;
+    ReaderCounter     mReaders[READER_STRIPES];
+    volatile Atomic32 mEpoch;
+    // ** Serializes reclaim passes.
+    SpinLock          mReclaimLock;
+    // ** Nodes unlinked by the last reclaim pass, freed once the look ups of the previous epoch finish.
+    HashNode*         mRetired;
 };
 
 
@@ -86,4 +86,29 @@ LF_INLINE bool IsLittleEndian()
     return !IsBigEndian();
 }
 
+// **********************************
+// Reverses the byte order of each component in a contiguous range.
+// 
+// @param data -- Pointer to the first component
+// @param numComponents -- The number of components
+// @param componentSize -- The size of each component in bytes (1, 2, 4 or 8)
+// **********************************
+LF_INLINE void SwapBytesArray(void* data, SizeT numComponents, SizeT componentSize)
+{
+    ByteT* bytes = reinterpret_cast<ByteT*>(data);
+    if (componentSize <= 1)
+    {
+        return;
+    }
+    for (SizeT i = 0; i < numComponents; ++i, bytes += componentSize)
+    {
+        for (SizeT low = 0, high = componentSize - 1; low < high; ++low, --high)
+        {
+            ByteT tmp = bytes[low];
+            bytes[low] = bytes[high];
+            bytes[high] = tmp;
+        }
+    }
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,284 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/PCH.h"
+#include "Crc32.h"
+
+#include <cstring>
+#include <emmintrin.h> // SSE2
+#include <smmintrin.h> // SSE4.1
+#include <wmmintrin.h> // PCLMULQDQ
+#if defined(LF_OS_WINDOWS)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// MSVC allows intrinsics regardless of the target architecture flags, GCC/Clang must enable them per function.
+#if defined(__GNUC__)
+#define LF_CRC32_CLMUL_TARGET __attribute__((target("pclmul,sse4.1")))
+#else
+#define LF_CRC32_CLMUL_TARGET
+#endif
+
+namespace lf {
+
+struct Crc32SliceTables
+{
+    Crc32SliceTables()
+    {
+        memcpy(mTables[0], CRC_32_TABLE, sizeof(mTables[0]));
+        for (SizeT i = 0; i < 256; ++i)
+        {
+            for (SizeT k = 1; k < 8; ++k)
+            {
+                const UInt32 previous = mTables[k - 1][i];
+                mTables[k][i] = (previous >> 8) ^ mTables[0][previous & 0xFF];
+            }
+        }
+    }
+    UInt32 mTables[8][256];
+};
+
+static const Crc32SliceTables& GetSliceTables()
+{
+    static const Crc32SliceTables sTables;
+    return sTables;
+}
+
+static bool DetectClmul()
+{
+    // CPUID.1:ECX PCLMULQDQ = bit 1, SSE4.1 = bit 19
+    const UInt32 PCLMULQDQ_BIT = 1 << 1;
+    const UInt32 SSE41_BIT = 1 << 19;
+    UInt32 ecx = 0;
+#if defined(LF_OS_WINDOWS)
+    int info[4] = { 0 };
+    __cpuid(info, 1);
+    ecx = static_cast<UInt32>(info[2]);
+#else
+    unsigned int eax = 0, ebx = 0, ecxValue = 0, edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecxValue, &edx))
+    {
+        ecx = ecxValue;
+    }
+#endif
+    return (ecx & PCLMULQDQ_BIT) != 0 && (ecx & SSE41_BIT) != 0;
+}
+
+// Updates the (non inverted) crc state.
+static UInt32 Crc32UpdateSlice8(UInt32 crc, const ByteT* data, SizeT dataLength)
+{
+    const Crc32SliceTables& tables = GetSliceTables();
+    const UInt32 (&t)[8][256] = tables.mTables;
+    while (dataLength >= 8)
+    {
+        UInt32 one;
+        UInt32 two;
+        memcpy(&one, data, sizeof(one));
+        memcpy(&two, data + 4, sizeof(two));
+        one ^= crc;
+        crc = t[7][one & 0xFF] 
+            ^ t[6][(one >> 8) & 0xFF] 
+            ^ t[5][(one >> 16) & 0xFF] 
+            ^ t[4][one >> 24]
+            ^ t[3][two & 0xFF] 
+            ^ t[2][(two >> 8) & 0xFF] 
+            ^ t[1][(two >> 16) & 0xFF] 
+            ^ t[0][two >> 24];
+        data += 8;
+        dataLength -= 8;
+    }
+
+    while (dataLength > 0)
+    {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xFF];
+        ++data;
+        --dataLength;
+    }
+    return crc;
+}
+
+// Updates the (non inverted) crc state, dataLength must be at least 64 and a multiple of 16.
+// Constants are the bit reflected fold/Barrett constants for the CRC-32 polynomial.
+LF_CRC32_CLMUL_TARGET static UInt32 Crc32UpdateClmul(UInt32 crc, const ByteT* data, SizeT dataLength)
+{
+    alignas(16) static const UInt64 K1K2[] = { 0x0154442BD4ULL, 0x01C6E41596ULL };
+    alignas(16) static const UInt64 K3K4[] = { 0x01751997D0ULL, 0x00CCAA009EULL };
+    alignas(16) static const UInt64 K5K0[] = { 0x0163CD6124ULL, 0x0000000000ULL };
+    alignas(16) static const UInt64 POLY[] = { 0x01DB710641ULL, 0x01F7011641ULL };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(K1K2));
+    data += 64;
+    dataLength -= 64;
+
+    // Fold 4 x 128 bits in parallel
+    while (dataLength >= 64)
+    {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        y5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+        y6 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+        y7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+        y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+        data += 64;
+        dataLength -= 64;
+    }
+
+    // Fold into 128 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(K3K4));
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // Fold the remaining 128 bit blocks
+    while (dataLength >= 16)
+    {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+        data += 16;
+        dataLength -= 16;
+    }
+
+    // Fold 128 bits to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(K5K0));
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduce to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(POLY));
+
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<UInt32>(_mm_extract_epi32(x1, 1));
+}
+
+// Updates the (non inverted) crc state with the clmul kernel, the tail is finished with slicing-by-8.
+static UInt32 Crc32UpdateClmulTail(UInt32 crc, const ByteT* data, SizeT dataLength)
+{
+    const SizeT CLMUL_MIN_LENGTH = 64;
+    if (dataLength >= CLMUL_MIN_LENGTH)
+    {
+        const SizeT chunk = dataLength & ~static_cast<SizeT>(15);
+        crc = Crc32UpdateClmul(crc, data, chunk);
+        data += chunk;
+        dataLength -= chunk;
+    }
+    return Crc32UpdateSlice8(crc, data, dataLength);
+}
+
+static UInt32 Crc32ClmulImpl(const ByteT* data, SizeT dataLength)
+{
+    return Crc32UpdateClmulTail(0xFFFFFFFF, data, dataLength) ^ 0xFFFFFFFF;
+}
+
+bool Crc32HasClmul()
+{
+    static const bool sHasClmul = DetectClmul();
+    return sHasClmul;
+}
+
+UInt32 Crc32Slice8(const ByteT* data, SizeT dataLength)
+{
+    if (!data || dataLength == 0)
+    {
+        return INVALID32;
+    }
+    return Crc32UpdateSlice8(0xFFFFFFFF, data, dataLength) ^ 0xFFFFFFFF;
+}
+
+UInt32 Crc32Clmul(const ByteT* data, SizeT dataLength)
+{
+    if (!data || dataLength == 0)
+    {
+        return INVALID32;
+    }
+    return Crc32HasClmul() ? Crc32ClmulImpl(data, dataLength) : Crc32Slice8(data, dataLength);
+}
+
+UInt32 Crc32(const ByteT* data, SizeT dataLength)
+{
+    using Crc32Func = UInt32(*)(const ByteT*, SizeT);
+    static const Crc32Func sKernel = Crc32HasClmul() ? Crc32ClmulImpl : Crc32Slice8;
+    if (!data || dataLength == 0)
+    {
+        return INVALID32;
+    }
+    return sKernel(data, dataLength);
+}
+
+UInt32 Crc32Update(UInt32 crc, const ByteT* data, SizeT dataLength)
+{
+    using Crc32UpdateFunc = UInt32(*)(UInt32, const ByteT*, SizeT);
+    static const Crc32UpdateFunc sKernel = Crc32HasClmul() ? Crc32UpdateClmulTail : Crc32UpdateSlice8;
+    if (!data || dataLength == 0)
+    {
+        return crc;
+    }
+    return sKernel(crc ^ 0xFFFFFFFF, data, dataLength) ^ 0xFFFFFFFF;
+}
+
+} // namespace lf
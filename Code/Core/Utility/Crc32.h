@@ -21,6 +21,7 @@
 
 #pragma once
 #include "Core/Common/Types.h"
+#include "Core/Common/API.h"
 
 namespace lf {
 
@@ -101,9 +102,22 @@ const UInt32 CRC_32_TABLE[] =
     0xB40BBE37,  0xC30C8EA1,  0x5A05DF1B,  0x2D02EF8D
 };
 
-// https://create.stephan-brumme.com/crc32/ We can make it faster probably.
-// https://github.com/stbrumme/crc32
-LF_INLINE UInt32 Crc32(const ByteT* data, SizeT dataLength)
+// **********************************
+// Computes the CRC-32 of the data with the fastest kernel the CPU supports (selected once at runtime)
+// 
+// note: All kernels produce identical results, an empty/null buffer returns INVALID32.
+// **********************************
+LF_CORE_API UInt32 Crc32(const ByteT* data, SizeT dataLength);
+// **********************************
+// Continues a CRC-32 over another buffer so a checksum can span several buffers, start with a crc of 0.
+// eg. Crc32Update(Crc32Update(0, a, aLength), b, bLength) == Crc32(ab, aLength + bLength)
+// 
+// note: An empty/null buffer returns crc unchanged.
+// **********************************
+LF_CORE_API UInt32 Crc32Update(UInt32 crc, const ByteT* data, SizeT dataLength);
+
+// Reference implementation, one table lookup per byte.
+LF_INLINE UInt32 Crc32Bytewise(const ByteT* data, SizeT dataLength)
 {
     if (!data || dataLength == 0)
     {
@@ -119,6 +133,16 @@ LF_INLINE UInt32 Crc32(const ByteT* data, SizeT dataLength)
     return crc32 = crc32 ^ 0xFFFFFFFF;
 }
 
+// https://create.stephan-brumme.com/crc32/ 
+// Slicing-by-8, processes 8 bytes per iteration with 8 lookup tables.
+LF_CORE_API UInt32 Crc32Slice8(const ByteT* data, SizeT dataLength);
+// Folds 64 bytes per iteration with carry-less multiplication (PCLMULQDQ), based on
+// Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+// 
+// note: Falls back to Crc32Slice8 if the CPU does not support it. (see Crc32HasClmul)
+LF_CORE_API UInt32 Crc32Clmul(const ByteT* data, SizeT dataLength);
+LF_CORE_API bool Crc32HasClmul();
+
 LF_INLINE void Crc32ComputeTable(UInt32* table, const SizeT tableLength)
 {
     if (!table || tableLength < 256)
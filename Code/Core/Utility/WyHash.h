@@ -0,0 +1,138 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+
+#include "Core/Common/Types.h"
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace lf {
+
+// **********************************
+// wyhash (final4): https://github.com/wangyi-fudan/wyhash
+// 
+// A fast 64-bit hash that consumes 8-48 bytes per step with 64x64->128 bit multiplies, use
+// this over FNV for in memory hash tables.
+// 
+// note: 
+//   - This hash function is not a cryptographic hash function
+//   - Do not persist these hashes, use FNV for values stored on disk (eg CacheDB paths)
+// **********************************
+namespace WyHash {
+using HashT = UInt64;
+const UInt64 WY_SECRET[4] = { 0x2D358DCCAA6C78A5ULL, 0x8BB84B93962EACC9ULL, 0x4B33A62ED433D4A3ULL, 0x4D5A2DA51DE1AA47ULL };
+
+LF_INLINE void Multiply(UInt64& a, UInt64& b)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = a;
+    r *= b;
+    a = static_cast<UInt64>(r);
+    b = static_cast<UInt64>(r >> 64);
+#elif defined(_MSC_VER) && defined(LF_PLATFORM_64)
+    a = _umul128(a, b, &b);
+#else
+    const UInt64 ha = a >> 32, hb = b >> 32, la = static_cast<UInt32>(a), lb = static_cast<UInt32>(b);
+    const UInt64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+    UInt64 c = t < rl;
+    const UInt64 lo = t + (rm1 << 32);
+    c += lo < t;
+    const UInt64 hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    a = lo;
+    b = hi;
+#endif
+}
+
+LF_INLINE UInt64 Mix(UInt64 a, UInt64 b)
+{
+    Multiply(a, b);
+    return a ^ b;
+}
+
+LF_INLINE UInt64 Read8(const ByteT* p) { UInt64 v; memcpy(&v, p, 8); return v; }
+LF_INLINE UInt64 Read4(const ByteT* p) { UInt32 v; memcpy(&v, p, 4); return v; }
+LF_INLINE UInt64 Read3(const ByteT* p, SizeT k) { return (static_cast<UInt64>(p[0]) << 16) | (static_cast<UInt64>(p[k >> 1]) << 8) | p[k - 1]; }
+
+LF_INLINE HashT Hash(const ByteT* data, SizeT numBytes, UInt64 seed = 0)
+{
+    const ByteT* p = data;
+    seed ^= Mix(seed ^ WY_SECRET[0], WY_SECRET[1]);
+    UInt64 a;
+    UInt64 b;
+    if (numBytes <= 16)
+    {
+        if (numBytes >= 4)
+        {
+            a = (Read4(p) << 32) | Read4(p + ((numBytes >> 3) << 2));
+            b = (Read4(p + numBytes - 4) << 32) | Read4(p + numBytes - 4 - ((numBytes >> 3) << 2));
+        }
+        else if (numBytes > 0)
+        {
+            a = Read3(p, numBytes);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        SizeT i = numBytes;
+        if (i > 48)
+        {
+            UInt64 see1 = seed;
+            UInt64 see2 = seed;
+            do
+            {
+                seed = Mix(Read8(p) ^ WY_SECRET[1], Read8(p + 8) ^ seed);
+                see1 = Mix(Read8(p + 16) ^ WY_SECRET[2], Read8(p + 24) ^ see1);
+                see2 = Mix(Read8(p + 32) ^ WY_SECRET[3], Read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = Mix(Read8(p) ^ WY_SECRET[1], Read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = Read8(p + i - 16);
+        b = Read8(p + i - 8);
+    }
+    a ^= WY_SECRET[1];
+    b ^= seed;
+    Multiply(a, b);
+    return Mix(a ^ WY_SECRET[0] ^ numBytes, b ^ WY_SECRET[1]);
+}
+
+LF_INLINE HashT Hash(const SByteT* data, SizeT numBytes, UInt64 seed = 0)
+{
+    return Hash(reinterpret_cast<const ByteT*>(data), numBytes, seed);
+}
+
+}
+
+} // namespace lf
@@ -54,7 +54,17 @@ namespace lf
         using ComponentType = ComponentT;
         using ComponentDataType = typename ComponentT::ComponentDataType;
         using ArrayType = TVector<ComponentDataType>;
+
+        // The storage of the component type within one collection
+        struct CollectionBinding
+        {
+            EntityCollection* mCollection;
+            ArrayType*        mArray;     // EntityStorageMode::VECTOR
+            SizeT             mTypeIndex; // EntityStorageMode::BLOCK
+        };
         static constexpr SizeT ARG_COUNT = TSystemTupleCount<ComponentT, ArgsT...>::VALUE;
+        // Size in bytes of the component data of one entity in the tuple
+        static constexpr SizeT ITEM_SIZE = sizeof(ComponentDataType) + TComponentSystemTupleBase<ArgsT...>::ITEM_SIZE;
 
         TComponentSystemTupleBase()
             : mComponents()
@@ -67,7 +77,7 @@ namespace lf
         {
             for (EntityCollection* collection : collections)
             {
-                mCollections.push_back(collection->GetCurrentArray<ComponentT>());
+                mCollections.push_back({ collection, collection->GetCurrentArray<ComponentT>(), collection->GetTypeIndex(typeof(ComponentT)) });
             }
             mNext.Initialize(collections);
         }
@@ -93,22 +103,42 @@ namespace lf
         }
 
         SizeT CollectionCount() const { return mCollections.size(); }
-        SizeT Count(SizeT collectionID) const { return mCollections[collectionID]->size(); }
+        SizeT Count(SizeT collectionID) const { return mCollections[collectionID].mCollection->Size(); }
         SizeT Count() const
         {
             SizeT count = 0;
             for (SizeT i = 0; i < mCollections.size(); ++i)
             {
-                count += mCollections[i]->size();
+                count += Count(i);
             }
             return count;
         }
+        // Returns the number of items that are contiguous in a collection (INVALID if the whole collection is contiguous)
+        SizeT BlockCapacity(SizeT collectionID) const { return mCollections[collectionID].mCollection->GetBlockCapacity(); }
 
         // Return pointer to item.
         ComponentDataType* GetItem(SizeT collectionID, SizeT itemID)
         {
             CriticalAssert(collectionID < CollectionCount() && itemID < Count(collectionID));
-            return &(*mCollections[collectionID])[itemID];
+            const CollectionBinding& binding = mCollections[collectionID];
+            if (binding.mArray)
+            {
+                return &(*binding.mArray)[itemID];
+            }
+            return reinterpret_cast<ComponentDataType*>(binding.mCollection->GetBlockItem(itemID, binding.mTypeIndex));
+        }
+
+        // Return pointer to the first item of a contiguous span of items. (A span cannot cross a block, see BlockCapacity)
+        ComponentDataType* GetSpan(SizeT collectionID, SizeT itemID, SizeT count)
+        {
+            CriticalAssert(collectionID < CollectionCount() && itemID + count <= Count(collectionID));
+            const CollectionBinding& binding = mCollections[collectionID];
+            if (binding.mArray)
+            {
+                return binding.mArray->data() + itemID;
+            }
+            CriticalAssert(count == 0 || itemID / BlockCapacity(collectionID) == (itemID + count - 1) / BlockCapacity(collectionID));
+            return reinterpret_cast<ComponentDataType*>(binding.mCollection->GetBlockItem(itemID, binding.mTypeIndex));
         }
 
         // Recursive invoke function that invokes the callback given with the component data pointers
@@ -119,6 +149,22 @@ namespace lf
             mNext.InvokeWithItems(callback, collectionID, itemID, args..., GetItem(collectionID, itemID));
         }
 
+        // Recursive invoke function that invokes the callback with the count and the pointers to the 
+        // first item of each span. (Bounds are checked once per span rather than once per item)
+        template<typename CallbackT, typename ... ArgsT>
+        void InvokeWithSpans(const CallbackT& callback, SizeT collectionID, SizeT itemID, SizeT count, ArgsT ... args)
+        {
+            mNext.InvokeWithSpans(callback, collectionID, itemID, count, args..., GetSpan(collectionID, itemID, count));
+        }
+
+        // Recursive invoke function that invokes the callback with the component data pointers of 
+        // each item in a contiguous span of items.
+        template<typename CallbackT, typename ... ArgsT>
+        void InvokeWithSpanItems(const CallbackT& callback, SizeT collectionID, SizeT itemID, SizeT count, ArgsT ... args)
+        {
+            mNext.InvokeWithSpanItems(callback, collectionID, itemID, count, args..., GetSpan(collectionID, itemID, count));
+        }
+
         template<typename CallbackT, typename ... ArgsT>
         void InvokeWithEntityItems(const CallbackT& callback, SizeT collectionID, SizeT itemID)
         {
@@ -137,13 +183,15 @@ namespace lf
             mNext.Clear();
         }
 
-        TVector<ArrayType*> mCollections;
+        TVector<CollectionBinding> mCollections;
         TComponentSystemTupleBase<ArgsT...> mNext;
     };
     // dummy template
     template<>
     struct TComponentSystemTupleBase<SystemTupleVoid>
     {
+        static constexpr SizeT ITEM_SIZE = 0;
+
         TComponentSystemTupleBase()
         {}
 
@@ -159,6 +207,21 @@ namespace lf
             callback(args...);
         }
 
+        template<typename CallbackT, typename ... ArgsT>
+        void InvokeWithSpans(const CallbackT& callback, SizeT, SizeT, SizeT count, ArgsT ... args)
+        {
+            callback(count, args...);
+        }
+
+        template<typename CallbackT, typename ... ArgsT>
+        void InvokeWithSpanItems(const CallbackT& callback, SizeT, SizeT, SizeT count, ArgsT ... args)
+        {
+            for (SizeT i = 0; i < count; ++i)
+            {
+                callback((args + i)...);
+            }
+        }
+
         EntityId GetEntityId(SizeT collectionID, SizeT itemID)
         {
             return mCollections[collectionID]->GetEntity(itemID);
@@ -21,6 +21,7 @@
 #include "Engine/PCH.h"
 #include "WorldImpl.h"
 
+#include "Core/Platform/Thread.h"
 #include "Core/Utility/Error.h"
 #include "Runtime/Async/Async.h"
 #include "Runtime/Reflection/ReflectionMgr.h"
@@ -49,6 +50,7 @@ WorldConfig::WorldConfig()
 , mLogEntityAddRemove(false)
 , mLogFenceUpdate(false)
 , mLogFenceUpdateVerbose(false)
+, mBlockEntityStorage(false)
 {
 
 }
@@ -58,6 +60,7 @@ void WorldConfig::Serialize(Stream& s)
     SERIALIZE(s, mLogEntityAddRemove, "");
     SERIALIZE(s, mLogFenceUpdate, "");
     SERIALIZE(s, mLogFenceUpdateVerbose, "");
+    SERIALIZE(s, mBlockEntityStorage, "");
 }
 
 static bool IsSerialUpdate(ECSUtil::UpdateType updateType)
@@ -112,8 +115,11 @@ WorldImpl::WorldImpl()
 , mWriteComponents()
 , mComponentTypes()
 , mSystems()
+, mEntityStorageMode(ECSUtil::EntityStorageMode::VECTOR)
+, mBlockPool()
 , mCollections()
 , mEntities()
+, mEntityIndex()
 , mRegisteringEntities()
 , mUnregisteringEntities()
 , mState(INITIALIZE)
@@ -123,16 +129,23 @@ WorldImpl::WorldImpl()
 , mIndexDirty(true)
 , mRebindNextUpdate(true)
 , mEntityIDGen()
+, mEntityGenerations()
+, mReleasedEntityIds()
 , mFences()
 , mUnsortedFences()
 , mBuiltInFences()
 , mAppService(nullptr)
+, mScheduler()
 {
 
 }
 WorldImpl::~WorldImpl()
 {
     ResetWorld(); // Destruction Order is kinda important
+    if (mScheduler.IsRunning())
+    {
+        mScheduler.Shutdown();
+    }
 }
 
 ComponentSequence WorldImpl::GetSequence(const EntityDefinition* definition)
@@ -386,6 +399,7 @@ APIResult<bool> WorldImpl::StartConstantUpdate(const UpdateInfo& info)
     update.mTaskState = TS_NONE;
     
     fence->mConstantUpdates.push_back(update);
+    ++fence->mConstantUpdatesVersion;
     // update.
     return APIResult<bool>(true);
 }
@@ -413,6 +427,7 @@ APIResult<bool> WorldImpl::StopConstantUpdate(const Token& name)
         if (it->mName == name)
         {
             fence->mConstantUpdates.swap_erase(it);
+            ++fence->mConstantUpdatesVersion;
             return APIResult<bool>(true);
         }
     }
@@ -447,6 +462,45 @@ void WorldImpl::RegisterScene(const WorldSceneAtomicPtr& scene)
     mScenes.push_back(scene);
 }
 
+TaskSchedulerBase& WorldImpl::GetScheduler()
+{
+    return mScheduler;
+}
+
+EntityCommandBuffer& WorldImpl::GetCommandBuffer()
+{
+    if (!mCommandBufferSlots.empty())
+    {
+        if (Async::GetAppThreadId() == APP_THREAD_ID_MAIN)
+        {
+            return *mCommandBufferSlots[0];
+        }
+        const SizeT workerIndex = mScheduler.GetCurrentWorkerIndex();
+        if (Valid(workerIndex) && workerIndex + 1 < mCommandBufferSlots.size())
+        {
+            return *mCommandBufferSlots[workerIndex + 1];
+        }
+    }
+
+    // Threads outside of the world are rare, they share a list.
+    const SizeT threadId = GetPlatformThreadId();
+    ScopeLock lock(mCommandBufferLock);
+    for (EntityCommandBuffer* buffer : mCommandBuffers)
+    {
+        if (buffer->GetThreadId() == threadId)
+        {
+            return *buffer;
+        }
+    }
+    mCommandBuffers.push_back(EntityCommandBufferPtr(LFNew<EntityCommandBuffer>(threadId)));
+    return *mCommandBuffers.back();
+}
+
+ECSUtil::EntityStorageMode WorldImpl::GetEntityStorageMode() const
+{
+    return BlockEntityStorage() ? ECSUtil::EntityStorageMode::BLOCK : mEntityStorageMode;
+}
+
 APIResult<ServiceResult::Value> WorldImpl::OnStart()
 {
     APIResult<ServiceResult::Value> super = Super::OnStart();
@@ -457,6 +511,23 @@ APIResult<ServiceResult::Value> WorldImpl::OnStart()
 
     mAppService = GetServices()->GetService<AppService>();
 
+    if (!mScheduler.IsRunning())
+    {
+        TaskScheduler::OptionsType options;
+        options.mMode = TaskTypes::TSM_WORK_STEALING;
+#if defined(LF_DEBUG) || defined(LF_TEST)
+        options.mWorkerName = "World_Worker";
+#endif
+        mScheduler.Initialize(options, true);
+    }
+
+    mCommandBufferSlots.clear();
+    mCommandBufferSlots.resize(mScheduler.GetNumWorkers() + 1);
+    for (EntityCommandBufferPtr& buffer : mCommandBufferSlots)
+    {
+        buffer = EntityCommandBufferPtr(LFNew<EntityCommandBuffer>(GetPlatformThreadId()));
+    }
+
     return APIResult<ServiceResult::Value>(ServiceResult::SERVICE_RESULT_SUCCESS);
 }
 
@@ -506,6 +577,7 @@ APIResult<ServiceResult::Value> WorldImpl::OnEndFrame()
     {
         return super;
     }
+    PlaybackCommandBuffers();
     UpdateUnregistered();
     UpdateCollections();
 
@@ -536,6 +608,11 @@ APIResult<ServiceResult::Value> WorldImpl::OnShutdown(ServiceShutdownMode mode)
     }
 
     ResetWorld();
+    if (mScheduler.IsRunning())
+    {
+        mScheduler.Shutdown();
+    }
+    mCommandBufferSlots.clear();
 
     return APIResult<ServiceResult::Value>(ServiceResult::SERVICE_RESULT_SUCCESS);
 }
@@ -584,6 +661,8 @@ void WorldImpl::ResetWorld()
     mState = SHUTDOWN;
 
     mEntities.clear();
+    mEntityIndex.Clear();
+    mReleasedEntityIds.clear();
     mNewEntities.clear();
     mRegisteringEntities.clear();
     mUnregisteringEntities.clear();
@@ -598,7 +677,13 @@ void WorldImpl::ResetWorld()
     mBuiltInFences.clear();
     mUnsortedFences.clear();
 
+    for (EntityCommandBuffer* buffer : mCommandBufferSlots)
+    {
+        buffer->Reset();
+    }
+    mCommandBuffers.clear();
     mCollections.clear();
+    mBlockPool.Trim();
 
     mRebindNextUpdate = true;
     mIndexDirty = true;
@@ -844,12 +929,14 @@ void WorldImpl::RegisterInternalUpdates()
     update.mName = Token("WorldImpl.RegisterEntities");
     update.mUpdateCallback = ECSUtil::UpdateCallback::Make(this, &WorldImpl::UpdateRegistered);
     fence->mConstantUpdates.push_back(update);
+    ++fence->mConstantUpdatesVersion;
 
     fence = GetFence(typeof(ComponentSystemUnregisterFence));
     Assert(fence != nullptr);
     update.mName = Token("WorldImpl.UnregisterEntities");
     update.mUpdateCallback = ECSUtil::UpdateCallback::Make([this]() { TAtomicStore(&mUpdateState, US_UNREGISTER); });
     fence->mConstantUpdates.push_back(update);
+    ++fence->mConstantUpdatesVersion;
 }
 
 void WorldImpl::RegisterEntityDefinition(const EntityDefinitionAsset& definition)
@@ -891,7 +978,7 @@ void WorldImpl::RegisterEntityDefinition(const EntityDefinitionAsset& definition
     Assert(mCollections.size() <= MAX_COLLECTION); // If this trips, consider changing the data types...
     if (!collection)
     {
-        collection = EntityCollectionPtr(LFNew<EntityCollection>());
+        collection = EntityCollectionPtr(LFNew<EntityCollection>(GetEntityStorageMode(), &mBlockPool));
     }
     collection->Initialize(definition, components);
 
@@ -960,7 +1047,7 @@ void WorldImpl::RegisterStaticEntityDefinition(const EntityDefinition* definitio
     Assert(mCollections.size() <= MAX_COLLECTION); // If this trips, consider changing the data types...
     if (!collection)
     {
-        collection = EntityCollectionPtr(LFNew<EntityCollection>());
+        collection = EntityCollectionPtr(LFNew<EntityCollection>(GetEntityStorageMode(), &mBlockPool));
     }
     collection->Initialize(EntityDefinitionAsset(), components);
 
@@ -1017,6 +1104,12 @@ EntityAtomicWPtr WorldImpl::CreateEntityInternal(const EntityDefinitionAssetType
     // no flags should be set at this point!
     Assert((id & ECSUtil::ENTITY_FLAG_BITMASK) == 0);
 
+    if (id >= mEntityGenerations.size())
+    {
+        mEntityGenerations.resize(id + 1, 0);
+    }
+    id = ECSUtil::SetGeneration(id, mEntityGenerations[id]);
+
     ECSUtil::SetNormalPriority(id); // noop
     ECSUtil::SetRegister(id); // noop
 
@@ -1069,7 +1162,6 @@ void WorldImpl::UpdateEntityId(EntityId oldId, const Entity* entity)
         return;
     }
 
-    auto it = mEntities.end();
     if (ECSUtil::IsLifeChanged(oldId, entity->GetId()))
     {
         ECSUtil::EntityLifeState oldLifeState = ECSUtil::GetLifeState(oldId);
@@ -1089,18 +1181,12 @@ void WorldImpl::UpdateEntityId(EntityId oldId, const Entity* entity)
             switch (newLifeState)
             {
             case ECSUtil::EntityLifeState::ALIVE: // no-op
-                it = mEntities.find(oldId);
-                Assert(it != mEntities.end());
-                mEntities.insert(std::make_pair(entity->GetId(), GetAtomicPointer(entity)));
-                mEntities.erase(it);
+                Assert(FindEntity(entity->GetId()) == entity);
                 return;
-            case ECSUtil::EntityLifeState::DESTROYED: // no-op
+            case ECSUtil::EntityLifeState::DESTROYED: // no-op (id is released when the new entity is dropped)
                 return;
             case ECSUtil::EntityLifeState::UNREGISTER:
-                it = mEntities.find(oldId);
-                Assert(it != mEntities.end());
-                mEntities.insert(std::make_pair(entity->GetId(), GetAtomicPointer(entity)));
-                mEntities.erase(it);
+                Assert(FindEntity(entity->GetId()) == entity);
                 mUnregisteringEntities.push_back(GetAtomicPointer(entity));
                 return;
             case ECSUtil::EntityLifeState::REGISTER:
@@ -1116,10 +1202,7 @@ void WorldImpl::UpdateEntityId(EntityId oldId, const Entity* entity)
             switch (newLifeState)
             {
             case ECSUtil::EntityLifeState::UNREGISTER:
-                it = mEntities.find(oldId);
-                Assert(it != mEntities.end());
-                mEntities.insert(std::make_pair(entity->GetId(), GetAtomicPointer(entity)));
-                mEntities.erase(it);
+                Assert(FindEntity(entity->GetId()) == entity);
                 mUnregisteringEntities.push_back(GetAtomicPointer(entity));
                 return;
             case ECSUtil::EntityLifeState::REGISTER:
@@ -1137,9 +1220,9 @@ void WorldImpl::UpdateEntityId(EntityId oldId, const Entity* entity)
             switch (newLifeState)
             {
             case ECSUtil::EntityLifeState::DESTROYED: // no-op
-                it = mEntities.find(oldId);
-                Assert(it != mEntities.end()); // Entity should be registered!
-                mEntities.erase(it);
+                Assert(FindEntity(entity->GetId()) == entity); // Entity should be registered!
+                RemoveEntity(entity->GetId());
+                ReleaseEntityId(entity->GetId());
                 return;
             case ECSUtil::EntityLifeState::REGISTER:
             case ECSUtil::EntityLifeState::ALIVE:
@@ -1174,17 +1257,15 @@ void WorldImpl::UpdateEntityId(EntityId oldId, const Entity* entity)
         return;
     }
 
-    it = mEntities.find(oldId);
-    if (it != mEntities.end())
+    // The sparse set is keyed by the raw id, flag changes only need to verify the mapping.
+    const SizeT index = mEntityIndex.Get(oldId);
+    if (index < mEntities.size() && ECSUtil::GetHandle(mEntities[index]->GetId()) == ECSUtil::GetHandle(oldId))
     {
-        if (it->second != entity)
+        if (mEntities[index] != entity)
         {
             gSysLog.Info(LogMessage("Entity id mismatch! Id=") << oldId);
             return;
         }
-        Assert(mEntities.find(entity->GetId()) == mEntities.end());
-        mEntities.insert(std::make_pair(entity->GetId(), it->second));
-        mEntities.erase(it);
     }
     else
     {
@@ -1209,11 +1290,12 @@ void WorldImpl::UpdateCollections()
     {
         if (ECSUtil::IsRegister(entity->GetId()))
         {
-            mEntities.insert(std::make_pair(entity->GetId(), entity));
+            AddEntity(entity);
             mRegisteringEntities.push_back(entity);
             continue;
         }
         Assert(ECSUtil::IsDestroyed(entity->GetId()));
+        ReleaseEntityId(entity->GetId());
     }
     mNewEntities.resize(0);
 
@@ -1221,6 +1303,14 @@ void WorldImpl::UpdateCollections()
     {
         pair.second->CommitChanges();
     }
+
+    // Destroyed entities are no longer in any collection, their raw ids can be reused with the next generation.
+    for (EntityId id : mReleasedEntityIds)
+    {
+        ++mEntityGenerations[id];
+        mEntityIDGen.Free(id);
+    }
+    mReleasedEntityIds.resize(0);
     mState = READY;
 }
 
@@ -1259,19 +1349,19 @@ void WorldImpl::UpdateFences()
         mState = READY;
         return;
     }
-    // Serial Update:
-    // TODO: Apply update type logic
-
     // Algo:
     //  Foreach Fence
     //      arr.push {Serial, NonSerial } GetUpdates
     //      arr.push {Serial, NonSerial } GetConstantUpdates
     //     
     //      Execute arr { Serial }
-    //      while !arr { NonSerial }.Empty
-    //          if Execute(arr.Item)
-    //              arr.Remove(arr.Item)
-    //  
+    //      Graph = Cached(Fence) or Build(arr { NonSerial })
+    //      Graph.Submit(Scheduler)
+    //      Graph.Wait()
+    //
+    // The graph has an edge between every two updates that conflict (one writes a component the other reads
+    // or writes), an update is dispatched as soon as all of the conflicting updates before it have completed.
+    // The main thread sleeps on the graph until the fence is complete instead of polling the updates.
     
     TVector<SchedulerUpdateData> serialUpdates;
     TVector<SchedulerUpdateData> nonSerialUpdates;
@@ -1289,6 +1379,7 @@ void WorldImpl::UpdateFences()
         nonSerialUpdates.reserve(fence.mUpdates.size() + fence.mConstantUpdates.size());
 
         // Gather:
+        bool hasOneTimeUpdates = false;
         for (FenceUpdate& update : fence.mUpdates)
         {
             if (IsSerialUpdate(update.mUpdateType))
@@ -1298,6 +1389,7 @@ void WorldImpl::UpdateFences()
             else
             {
                 nonSerialUpdates.push_back(SchedulerUpdateData(&update));
+                hasOneTimeUpdates = true;
             }
         }
         for (FenceConstantUpdate& update : fence.mConstantUpdates)
@@ -1340,86 +1432,28 @@ void WorldImpl::UpdateFences()
                     break;
             }
         }
-        // Repurpose as 'pending updates'
-        serialUpdates.resize(0);
 
         // NonSerial:
-        while (!nonSerialUpdates.empty())
-        {
-            for(auto update = nonSerialUpdates.begin(); update != nonSerialUpdates.end();)
+        if (!nonSerialUpdates.empty())
+        {
+            // One time updates change every frame, constant updates only when started/stopped.
+            const bool graphValid = fence.mGraph
+                && !hasOneTimeUpdates
+                && fence.mGraphVersion == fence.mConstantUpdatesVersion
+                && fence.mGraphUpdates.size() == nonSerialUpdates.size()
+                && std::equal(nonSerialUpdates.begin(), nonSerialUpdates.end(), fence.mGraphUpdates.begin(),
+                    [](const SchedulerUpdateData& a, const SchedulerUpdateData& b) { return a.mData == b.mData; });
+            if (!graphValid)
             {
-                switch (update->mType)
-                {
-                    case SUT_CONSTANT_UPDATE:
-                    {
-                        FenceConstantUpdate* updateData = static_cast<FenceConstantUpdate*>(update->mData);
-                        if (ExecuteNonSerialUpdate(updateData))
-                        {
-                            serialUpdates.push_back(*update);
-                            update = nonSerialUpdates.swap_erase(update);
-                        }
-                        else
-                        {
-                            ++update;
-                        }
-                    } break;
-                    case SUT_UPDATE:
-                    {
-                        FenceUpdate* updateData = static_cast<FenceUpdate*>(update->mData);
-                        if (ExecuteNonSerialUpdate(updateData))
-                        {
-                            serialUpdates.push_back(*update);
-                            update = nonSerialUpdates.swap_erase(update);
-                        }
-                        else
-                        {
-                            ++update;
-                        }
-                    } break;
-                    default:
-                        CriticalAssertMsg("Unknown update type!");
-                        break;
-                }
+                BuildFenceGraph(fence, nonSerialUpdates);
             }
-        }
 
-        // Wait for non-serial
-        while (!serialUpdates.empty())
-        {
-            for (auto update = serialUpdates.begin(); update != serialUpdates.end();)
-            {
-                switch (update->mType)
-                {
-                case SUT_CONSTANT_UPDATE:
-                {
-                    FenceConstantUpdate* updateData = static_cast<FenceConstantUpdate*>(update->mData);
-                    if (AtomicLoad(&updateData->mTaskState) == TS_FINISHED)
-                    {
-                        update = serialUpdates.swap_erase(update);
-                    }
-                    else
-                    {
-                        ++update;
-                    }
-                } break;
-                case SUT_UPDATE:
-                {
-                    FenceUpdate* updateData = static_cast<FenceUpdate*>(update->mData);
-                    if (AtomicLoad(&updateData->mTaskState) == TS_FINISHED)
-                    {
-                        update = serialUpdates.swap_erase(update);
-                    }
-                    else
-                    {
-                        ++update;
-                    }
-                } break;
-                default:
-                    CriticalAssertMsg("Unknown update type!");
-                    break;
-                }
-            }
+            fence.mGraph->Submit(mScheduler);
+            fence.mGraph->Wait();
         }
+
+        // One time updates have been executed.
+        fence.mUpdates.resize(0);
     }
     mState = READY;
 }
@@ -1449,14 +1483,177 @@ void WorldImpl::UpdateNewEntities()
     {
         if (ECSUtil::IsRegister(entity->GetId()))
         {
-            mEntities.insert(std::make_pair(entity->GetId(), entity));
+            AddEntity(entity);
             mRegisteringEntities.push_back(entity);
         }
+        else if (ECSUtil::IsDestroyed(entity->GetId()))
+        {
+            ReleaseEntityId(entity->GetId());
+        }
     }
 
     mNewEntities.clear();
 }
 
+void WorldImpl::PlaybackCommandBuffers()
+{
+    if (mState != READY)
+    {
+        return;
+    }
+
+    using Command = EntityCommandBuffer::Command;
+    struct PlaybackCommand
+    {
+        const Command* mCommand;
+        SizeT          mBuffer;
+        SizeT          mSequence;
+    };
+
+    // Fences have completed so no thread is recording. The fixed slots come first (main thread then
+    // workers by index) followed by the buffers of other threads in the order they were created.
+    TVector<const EntityCommandBuffer*> buffers;
+    buffers.reserve(mCommandBufferSlots.size() + mCommandBuffers.size());
+    for (const EntityCommandBuffer* buffer : mCommandBufferSlots)
+    {
+        buffers.push_back(buffer);
+    }
+    for (const EntityCommandBuffer* buffer : mCommandBuffers)
+    {
+        buffers.push_back(buffer);
+    }
+
+    TVector<PlaybackCommand> commands;
+    TVector<TVector<EntityAtomicWPtr>> deferredEntities;
+    deferredEntities.resize(buffers.size());
+    for (SizeT i = 0; i < buffers.size(); ++i)
+    {
+        const EntityCommandBuffer* buffer = buffers[i];
+        deferredEntities[i].resize(buffer->GetDeferredCount());
+        SizeT sequence = 0;
+        for (const Command* command = buffer->GetFirstCommand(); command; command = command->mNext)
+        {
+            commands.push_back({ command, i, sequence++ });
+        }
+    }
+    if (commands.empty())
+    {
+        return;
+    }
+
+    // Batch by command type then sort key, equal keys are ordered by the buffer index then the recorded order.
+    std::sort(commands.begin(), commands.end(), [](const PlaybackCommand& a, const PlaybackCommand& b)
+        {
+            if (a.mCommand->mType != b.mCommand->mType)
+            {
+                return a.mCommand->mType < b.mCommand->mType;
+            }
+            if (a.mCommand->mSortKey != b.mCommand->mSortKey)
+            {
+                return a.mCommand->mSortKey < b.mCommand->mSortKey;
+            }
+            if (a.mBuffer != b.mBuffer)
+            {
+                return a.mBuffer < b.mBuffer;
+            }
+            return a.mSequence < b.mSequence;
+        });
+
+    // Entities created this frame are not in the sparse set yet, they're looked up by handle. Built on first use.
+    TMap<EntityId, EntityAtomicWPtr> newEntities;
+    bool newEntitiesBuilt = false;
+    auto findTarget = [this, &deferredEntities, &newEntities, &newEntitiesBuilt](const PlaybackCommand& playback) -> EntityAtomicWPtr
+    {
+        const Command* command = playback.mCommand;
+        if (Valid(command->mDeferred))
+        {
+            return deferredEntities[playback.mBuffer][command->mDeferred];
+        }
+        EntityAtomicWPtr entity = FindEntitySlow(command->mEntity).second;
+        if (entity)
+        {
+            return entity;
+        }
+        if (!newEntitiesBuilt)
+        {
+            for (const EntityAtomicPtr& newEntity : mNewEntities)
+            {
+                newEntities[ECSUtil::GetHandle(newEntity->GetId())] = newEntity;
+            }
+            newEntitiesBuilt = true;
+        }
+        auto it = newEntities.find(ECSUtil::GetHandle(command->mEntity));
+        return it != newEntities.end() ? it->second : EntityAtomicWPtr();
+    };
+
+    for (const PlaybackCommand& playback : commands)
+    {
+        const Command* command = playback.mCommand;
+        switch (command->mType)
+        {
+            case EntityCommandBuffer::CT_CREATE:
+            {
+                EntityAtomicWPtr& entity = deferredEntities[playback.mBuffer][command->mDeferred];
+                entity = CreateEntityInternal(EntityDefinitionAssetType(), command->mDefinition);
+                if (!entity)
+                {
+                    gSysLog.Warning(LogMessage("Failed to create entity from command buffer, the definition is not registered."));
+                }
+            } break;
+            case EntityCommandBuffer::CT_SET_COMPONENT:
+            {
+                EntityAtomicWPtr entity = findTarget(playback);
+                if (!entity || ECSUtil::IsDestroyed(entity->GetId()))
+                {
+                    break;
+                }
+                EntityCollection* collection = const_cast<EntityCollection*>(entity->GetCollection());
+                const SizeT typeIndex = collection->GetTypeIndex(command->mComponentType);
+                if (Invalid(typeIndex))
+                {
+                    gSysLog.Warning(LogMessage("Failed to set component from command buffer, the entity does not have component ") << command->mComponentType->GetFullName());
+                    break;
+                }
+
+                ComponentData* component = nullptr;
+                SizeT index = collection->GetNewIndexSlow(entity->GetId());
+                if (Valid(index))
+                {
+                    component = collection->GetNewComponent(index, typeIndex);
+                }
+                else if (Valid(index = collection->GetIndexSlow(entity->GetId())))
+                {
+                    component = collection->GetCurrentComponent(index, typeIndex);
+                }
+                if (component)
+                {
+                    command->mCopy(component, command->mData);
+                }
+            } break;
+            case EntityCommandBuffer::CT_DESTROY:
+            {
+                EntityAtomicWPtr entity = findTarget(playback);
+                if (entity)
+                {
+                    entity->Destroy();
+                }
+            } break;
+            default:
+                CriticalAssertMsg("Invalid command type");
+                break;
+        }
+    }
+
+    for (EntityCommandBuffer* buffer : mCommandBufferSlots)
+    {
+        buffer->Reset();
+    }
+    for (EntityCommandBuffer* buffer : mCommandBuffers)
+    {
+        buffer->Reset();
+    }
+}
+
 void WorldImpl::UpdateRegistered()
 {
     for (EntityAtomicPtr& entity : mRegisteringEntities)
@@ -1513,8 +1710,12 @@ void WorldImpl::UpdateUnregistered()
 
 EntityAtomicWPtr WorldImpl::FindEntity(EntityId id)
 {
-    auto it = mEntities.find(id);
-    return it == mEntities.end() ? EntityAtomicWPtr() : it->second;
+    const SizeT index = mEntityIndex.Get(id);
+    if (index < mEntities.size() && mEntities[index]->GetId() == id)
+    {
+        return mEntities[index];
+    }
+    return EntityAtomicWPtr();
 }
 EntityAtomicWPtr WorldImpl::FindNewEntity(EntityId id)
 {
@@ -1543,17 +1744,47 @@ EntityAtomicWPtr WorldImpl::FindUnregistered(EntityId id)
 
 std::pair<EntityId, EntityAtomicWPtr> WorldImpl::FindEntitySlow(EntityId id)
 {
-    EntityId rawId = ECSUtil::GetId(id);
-    for (auto& pair : mEntities)
+    const SizeT index = mEntityIndex.Get(id);
+    if (index < mEntities.size())
     {
-        if (rawId == ECSUtil::GetId(pair.first))
+        const EntityId entityId = mEntities[index]->GetId();
+        if (ECSUtil::GetHandle(entityId) == ECSUtil::GetHandle(id))
         {
-            return std::make_pair(pair.first, pair.second);
+            return std::make_pair(entityId, EntityAtomicWPtr(mEntities[index]));
         }
     }
     return std::make_pair(INVALID_ENTITY_ID, EntityAtomicWPtr());
 }
 
+void WorldImpl::AddEntity(const EntityAtomicPtr& entity)
+{
+    Assert(Invalid(FindEntitySlow(entity->GetId()).first));
+    mEntityIndex.Set(entity->GetId(), mEntities.size());
+    mEntities.push_back(entity);
+}
+
+void WorldImpl::RemoveEntity(EntityId id)
+{
+    const SizeT index = mEntityIndex.Get(id);
+    if (index >= mEntities.size() || ECSUtil::GetHandle(mEntities[index]->GetId()) != ECSUtil::GetHandle(id))
+    {
+        return;
+    }
+
+    mEntityIndex.Reset(id);
+    if (index != mEntities.size() - 1)
+    {
+        mEntities[index] = mEntities.back();
+        mEntityIndex.Set(mEntities[index]->GetId(), index);
+    }
+    mEntities.pop_back();
+}
+
+void WorldImpl::ReleaseEntityId(EntityId id)
+{
+    mReleasedEntityIds.push_back(ECSUtil::GetId(id));
+}
+
 SizeT WorldImpl::GetFenceIndex(const Type* target)
 {
     auto it = std::find_if(mFences.begin(), mFences.end(), [target](const FenceData& fence) { return fence.mType == target; });
@@ -1580,6 +1811,10 @@ bool WorldImpl::LogFenceUpdateVerbose() const
 {
     return mAppService ? mAppService->GetConfigObject<WorldConfig>()->mLogFenceUpdateVerbose : false;
 }
+bool WorldImpl::BlockEntityStorage() const
+{
+    return mAppService ? mAppService->GetConfigObject<WorldConfig>()->mBlockEntityStorage : false;
+}
 
 bool WorldImpl::AllowUpdateScheduling()
 {
@@ -1896,15 +2131,113 @@ bool WorldImpl::ExecuteNonSerialUpdate(FenceUpdate* updateData)
         return false;
     }
 
-    // todo: run on separate thread.
     AtomicStore(&updateData->mTaskState, TS_RUNNING);
     if (LogFenceUpdateVerbose())
     {
         gSysLog.Info(LogMessage("Update.Invoke"));
     }
     updateData->mUpdateCallback();
+
+    ReleaseLock(false, updateData->mReadComponents);
+    ReleaseLock(true, updateData->mWriteComponents);
+
     AtomicStore(&updateData->mTaskState, TS_FINISHED);
     return true;
 }
 
+void WorldImpl::ExecuteNonSerialUpdate(const SchedulerUpdateData& update)
+{
+    // The fence graph orders conflicting updates so the locks are expected to be free, a lock
+    // held by something outside of the graph is retried for a short while before giving up.
+    const SizeT NON_SERIAL_LOCK_ATTEMPTS = 64;
+    bool executed = false;
+    for (SizeT attempt = 0; !executed && attempt < NON_SERIAL_LOCK_ATTEMPTS; ++attempt)
+    {
+        if (attempt > 0)
+        {
+            Thread::Yield();
+        }
+        switch (update.mType)
+        {
+            case SUT_CONSTANT_UPDATE:
+                executed = ExecuteNonSerialUpdate(static_cast<FenceConstantUpdate*>(update.mData));
+                break;
+            case SUT_UPDATE:
+                executed = ExecuteNonSerialUpdate(static_cast<FenceUpdate*>(update.mData));
+                break;
+            default:
+                CriticalAssertMsg("Unknown update type!");
+                return;
+        }
+    }
+
+    // Skipping the update silently would leave the world in a state nobody asked for, report it in all builds.
+    if (!executed)
+    {
+        const char* name = update.mType == SUT_CONSTANT_UPDATE ? static_cast<FenceConstantUpdate*>(update.mData)->mName.CStr() : "<update>";
+        gSysLog.Error(LogMessage("Failed to acquire the component locks of a fence update, the update was skipped. Update=") << name);
+        ReportBugMsg("Failed to acquire the component locks of a fence update, the fence graph is missing a conflict.");
+    }
+}
+
+static bool Intersects(const TVector<ComponentId>& a, const TVector<ComponentId>& b)
+{
+    for (ComponentId component : a)
+    {
+        if (std::find(b.begin(), b.end(), component) != b.end())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorldImpl::BuildFenceGraph(FenceData& fence, const TVector<SchedulerUpdateData>& updates)
+{
+    // Always a new graph, copies of the fence may still reference the old one.
+    fence.mGraph = TaskGraphPtr(LFNew<TaskGraph>());
+    fence.mGraphUpdates = updates;
+    fence.mGraphVersion = fence.mConstantUpdatesVersion;
+
+    TaskGraph& graph = *fence.mGraph;
+    for (const SchedulerUpdateData& update : fence.mGraphUpdates)
+    {
+        graph.AddNode(TaskGraph::NodeCallback::Make([this, update]() { ExecuteNonSerialUpdate(update); }));
+    }
+
+    auto readComponents = [](const SchedulerUpdateData& update) -> const TVector<ComponentId>&
+    {
+        return update.mType == SUT_CONSTANT_UPDATE
+            ? static_cast<FenceConstantUpdate*>(update.mData)->mReadComponents
+            : static_cast<FenceUpdate*>(update.mData)->mReadComponents;
+    };
+    auto writeComponents = [](const SchedulerUpdateData& update) -> const TVector<ComponentId>&
+    {
+        return update.mType == SUT_CONSTANT_UPDATE
+            ? static_cast<FenceConstantUpdate*>(update.mData)->mWriteComponents
+            : static_cast<FenceUpdate*>(update.mData)->mWriteComponents;
+    };
+
+    for (SizeT i = 0; i < updates.size(); ++i)
+    {
+        const TVector<ComponentId>& readA = readComponents(updates[i]);
+        const TVector<ComponentId>& writeA = writeComponents(updates[i]);
+        for (SizeT k = i + 1; k < updates.size(); ++k)
+        {
+            const TVector<ComponentId>& readB = readComponents(updates[k]);
+            const TVector<ComponentId>& writeB = writeComponents(updates[k]);
+            if (Intersects(writeA, writeB) || Intersects(writeA, readB) || Intersects(readA, writeB))
+            {
+                graph.AddEdge(i, k);
+            }
+        }
+    }
+
+    // Edges only go forward in the list so the graph can't contain a cycle.
+    if (!graph.Build())
+    {
+        CriticalAssertMsg("Failed to build the fence graph.");
+    }
+}
+
 } // namespace lf
\ No newline at end of file
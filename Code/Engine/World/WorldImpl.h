@@ -21,6 +21,8 @@
 #pragma once
 
 #include "AbstractEngine/World/World.h"
+#include "Core/Concurrent/TaskGraph.h"
+#include "Core/Concurrent/TaskScheduler.h"
 #include "Core/Utility/StdMap.h"
 #include "Core/Utility/StdVector.h"
 #include "Core/Utility/UniqueNumber.h"
@@ -28,6 +30,9 @@
 #include "AbstractEngine/App/AppConfig.h"
 #include "AbstractEngine/World/ComponentSystem.h"
 #include "AbstractEngine/World/EntityCollection.h"
+#include "AbstractEngine/World/EntitySparseIndex.h"
+#include "AbstractEngine/World/EntityBlockPool.h"
+#include "AbstractEngine/World/EntityCommandBuffer.h"
 
 namespace lf
 {
@@ -40,6 +45,7 @@ DECLARE_WPTR(EntityCollection);
 DECLARE_ASSET_TYPE(EntityDefinition);
 DECLARE_ASSET(EntityDefinition);
 DECLARE_PTR(ComponentSystem);
+DECLARE_PTR(TaskGraph);
 class AppService;
 
 class LF_ENGINE_API WorldConfig : public AppConfigObject
@@ -53,6 +59,8 @@ public:
     bool mLogEntityAddRemove;
     bool mLogFenceUpdate;
     bool mLogFenceUpdateVerbose;
+    // Store entity components in fixed size blocks (ECSUtil::EntityStorageMode::BLOCK)
+    bool mBlockEntityStorage;
 };
 
 
@@ -79,7 +87,7 @@ class LF_ENGINE_API WorldImpl : public World
     using ComponentTypeMap = TMap<const Type*, ComponentPtr>;
     using ComponentSystemArray = TVector<ComponentSystemPtr>;
     using EntityTypeMap = TMap<ComponentSequence, EntityCollectionPtr>;
-    using EntityMap = TMap<EntityId, EntityAtomicPtr>;
+    using EntityArray = TVector<EntityAtomicPtr>;
 
     using ComponentLockMap = TVector<Atomic32>;
 
@@ -148,11 +156,19 @@ class LF_ENGINE_API WorldImpl : public World
         : mType(nullptr)
         , mTargetBefore(nullptr)
         , mTargetAfter(nullptr)
+        , mConstantUpdatesVersion(0)
+        , mGraph()
+        , mGraphUpdates()
+        , mGraphVersion(0)
         {}
         explicit FenceData(const Type* type)
         : mType(type)
         , mTargetBefore(nullptr)
         , mTargetAfter(nullptr)
+        , mConstantUpdatesVersion(0)
+        , mGraph()
+        , mGraphUpdates()
+        , mGraphVersion(0)
         {}
 
         const Type* mType;
@@ -160,6 +176,12 @@ class LF_ENGINE_API WorldImpl : public World
         const Type* mTargetAfter;  // Create the fence after this target.
         TVector<FenceUpdate>         mUpdates;
         TVector<FenceConstantUpdate> mConstantUpdates;
+        UInt32                       mConstantUpdatesVersion; // Incremented when mConstantUpdates is modified
+
+        // Conflict graph of the non-serial updates. Reused while the fence only has the same constant updates.
+        TaskGraphPtr                 mGraph;
+        TVector<SchedulerUpdateData> mGraphUpdates;
+        UInt32                       mGraphVersion;
     };
 
     enum State
@@ -240,6 +262,16 @@ public:
 
     ComponentSystem* GetSystem(const Type* type) override;
     void RegisterScene(const WorldSceneAtomicPtr& scene) override;
+    TaskSchedulerBase& GetScheduler() override;
+    EntityCommandBuffer& GetCommandBuffer() override;
+
+    // ********************************************************************
+    // Sets the storage mode of entity collections created after the call. 
+    // (Collections are created when entity definitions are registered, so
+    // this is expected to be called before the world starts)
+    // ********************************************************************
+    void SetEntityStorageMode(ECSUtil::EntityStorageMode value) { mEntityStorageMode = value; }
+    ECSUtil::EntityStorageMode GetEntityStorageMode() const;
 
 protected:
     // Service Impl
@@ -290,6 +322,8 @@ public: // private:
 
     void UpdateNewEntities();
     void UpdateRegistered();
+    // Executes the commands recorded in all command buffers, see EntityCommandBuffer
+    void PlaybackCommandBuffers();
     void UpdateUnregistered();
 
     EntityAtomicWPtr FindEntity(EntityId id);
@@ -299,6 +333,13 @@ public: // private:
 
     std::pair<EntityId, EntityAtomicWPtr> FindEntitySlow(EntityId id);
 
+    // Adds a registering entity to the sparse set of entities
+    void AddEntity(const EntityAtomicPtr& entity);
+    // Removes the entity from the sparse set of entities, the last entity takes its place
+    void RemoveEntity(EntityId id);
+    // Queue the raw id to be recycled once the collections have committed the destroyed entity
+    void ReleaseEntityId(EntityId id);
+
     SizeT GetFenceIndex(const Type* target);
 
 public:
@@ -307,6 +348,7 @@ public:
     bool LogEntityAddRemove() const;
     bool LogFenceUpdate() const;
     bool LogFenceUpdateVerbose() const;
+    bool BlockEntityStorage() const;
     // \ Config Accessors
 private:
     bool AllowUpdateScheduling();
@@ -325,6 +367,10 @@ private:
 
     bool ExecuteNonSerialUpdate(FenceConstantUpdate* updateData);
     bool ExecuteNonSerialUpdate(FenceUpdate* updateData);
+    void ExecuteNonSerialUpdate(const SchedulerUpdateData& update);
+
+    // Builds the graph of the non-serial updates, conflicting updates are ordered by their position in 'updates'
+    void BuildFenceGraph(FenceData& fence, const TVector<SchedulerUpdateData>& updates);
 
     bool                            mForceUpdateSerial;
 
@@ -332,8 +378,11 @@ private:
     ComponentLockMap                mWriteComponents;
     ComponentTypeMap                mComponentTypes;
     ComponentSystemArray            mSystems;
+    ECSUtil::EntityStorageMode      mEntityStorageMode;
+    EntityBlockPool                 mBlockPool; // Must outlive the collections
     EntityTypeMap                   mCollections;
-    EntityMap                       mEntities;
+    EntityArray                     mEntities;    // Dense
+    EntitySparseIndex               mEntityIndex; // Raw Id => mEntities index
 
     TVector<EntityAtomicPtr>         mNewEntities;
     TVector<EntityAtomicPtr>         mRegisteringEntities;
@@ -348,12 +397,21 @@ private:
     bool                         mRebindNextUpdate;
 
     UniqueNumber<EntityId, 64>   mEntityIDGen;
+    TVector<UInt8>               mEntityGenerations; // Raw Id => Generation of the next entity to use the id
+    TVector<EntityId>            mReleasedEntityIds; // Raw Ids of destroyed entities waiting for CommitChanges
 
     TVector<FenceData>           mFences;
     TVector<FenceData>           mUnsortedFences;
     TVector<const Type*>         mBuiltInFences;
 
     AppService*                 mAppService;
+    TaskScheduler               mScheduler;
+
+    // Fixed slots created on start, the main thread first then one per scheduler worker. The slot
+    // index is stable so playback order doesn't depend on which thread asked for a buffer first.
+    TVector<EntityCommandBufferPtr> mCommandBufferSlots;
+    SpinLock                       mCommandBufferLock;
+    TVector<EntityCommandBufferPtr> mCommandBuffers; // One per other thread that requested a buffer
 
     TVector<WorldSceneAtomicPtr> mScenes;
 };
@@ -19,15 +19,20 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // ********************************************************************
 #include "Core/Test/Test.h"
+#include "Core/Platform/Thread.h"
 #include "AbstractEngine/World/Entity.h"
 #include "AbstractEngine/World/ComponentSystem.h"
 #include "Engine/World/WorldImpl.h"
+#include "Engine/World/ComponentSystemTuple.h"
+#include "AbstractEngine/World/EntityCommandBuffer.h"
 #include "Game/Test/TestUtils.h"
 
 #include "Game/Artherion/ComponentTypes/TransformComponent.h"
 #include "Game/Artherion/ComponentTypes/BoundsComponent.h"
 #include "Game/Artherion/ComponentTypes/ModelComponent.h"
 
+#include <algorithm>
+
 // TODO: System Update Scheduling
 // TODO: Soft Data Locks
 // TODO: Entity External Modification
@@ -423,6 +428,160 @@ DEFINE_CLASS(lf::TestDeleteEntitySystem) { NO_REFLECTION; }
 EntityId TestDeleteEntitySystem::sDestroyOnRegister = INVALID_ENTITY_ID;
 EntityId TestDeleteEntitySystem::sDestroyOnUnregister = INVALID_ENTITY_ID;
 
+class TestParallelForEachSystem : public ComponentSystem, public TSystemTestAttributes<TestParallelForEachSystem>
+{
+    DECLARE_CLASS(TestParallelForEachSystem, ComponentSystem);
+public:
+    using Tuple = TComponentSystemTuple<TransformComponent, BoundsComponent>;
+    static SizeT sGrainSize;
+    static volatile Atomic32 sVisited;
+    static volatile Atomic32 sChunks;
+
+    Tuple mTuple;
+    bool mRegistered;
+    bool IsEnabled() const override { return sEnable; }
+    bool OnInitialize() override
+    {
+        mRegistered = false;
+        return true;
+    }
+    void OnBindTuples() override
+    {
+        BindTuple(mTuple);
+    }
+    void OnScheduleUpdates() override
+    {
+        if (!mRegistered)
+        {
+            if (StartConstantUpdate(String(), ECSUtil::UpdateCallback::Make(this, &TestParallelForEachSystem::Update), typeof(ComponentSystemUpdateFence), sUpdateType))
+            {
+                mRegistered = true;
+            }
+        }
+    }
+    void Update()
+    {
+        ParallelForEach(mTuple, [](SizeT count, TransformComponentData* transforms, BoundsComponentData* bounds)
+            {
+                for (SizeT i = 0; i < count; ++i)
+                {
+                    transforms[i].mPosition.x += 1.0f;
+                    bounds[i].mMax.x = transforms[i].mPosition.x;
+                }
+                AtomicAdd32(&sVisited, static_cast<Atomic32>(count));
+                AtomicIncrement32(&sChunks);
+            }, sGrainSize);
+    }
+};
+DEFINE_CLASS(lf::TestParallelForEachSystem) { NO_REFLECTION; }
+SizeT TestParallelForEachSystem::sGrainSize = 0;
+volatile Atomic32 TestParallelForEachSystem::sVisited = 0;
+volatile Atomic32 TestParallelForEachSystem::sChunks = 0;
+
+// Spawns entities from a parallel loop through the command buffers
+class TestCommandBufferSystem : public ComponentSystem, public TSystemTestAttributes<TestCommandBufferSystem>
+{
+    DECLARE_CLASS(TestCommandBufferSystem, ComponentSystem);
+public:
+    static const EntityDefinition* sDefinition;
+    static SizeT sSpawnCount;
+
+    bool mRegistered;
+    bool IsEnabled() const override { return sEnable; }
+    bool OnInitialize() override
+    {
+        mRegistered = false;
+        return true;
+    }
+    void OnScheduleUpdates() override
+    {
+        if (!mRegistered)
+        {
+            if (StartConstantUpdate(String(), ECSUtil::UpdateCallback::Make(this, &TestCommandBufferSystem::Update), typeof(ComponentSystemUpdateFence), ECSUtil::UpdateType::CONCURRENT))
+            {
+                mRegistered = true;
+            }
+        }
+    }
+    void Update()
+    {
+        if (sSpawnCount == 0)
+        {
+            return;
+        }
+
+        ParallelFor(GetWorld()->GetScheduler(), 0, sSpawnCount, 64, [this](SizeT begin, SizeT end)
+            {
+                EntityCommandBuffer& buffer = GetWorld()->GetCommandBuffer();
+                for (SizeT i = begin; i < end; ++i)
+                {
+                    const UInt32 sortKey = static_cast<UInt32>(i);
+                    EntityCommandBuffer::DeferredEntity entity = buffer.Create(sDefinition, sortKey);
+                    TransformComponentData transform;
+                    transform.mPosition.y = static_cast<Float32>(i);
+                    buffer.SetComponent<TransformComponent>(entity, transform, sortKey);
+                }
+            });
+        sSpawnCount = 0;
+    }
+};
+DEFINE_CLASS(lf::TestCommandBufferSystem) { NO_REFLECTION; }
+const EntityDefinition* TestCommandBufferSystem::sDefinition = nullptr;
+SizeT TestCommandBufferSystem::sSpawnCount = 0;
+
+// Two concurrent updates writing the same component and one reading another component, all in the same fence.
+class TestFenceConflictSystem : public ComponentSystem, public TSystemTestAttributes<TestFenceConflictSystem>
+{
+    DECLARE_CLASS(TestFenceConflictSystem, ComponentSystem);
+public:
+    static volatile Atomic32 sWriters;
+    static volatile Atomic32 sMaxWriters;
+    static volatile Atomic32 sUpdates;
+
+    bool mRegistered;
+    bool IsEnabled() const override { return sEnable; }
+    bool OnInitialize() override
+    {
+        mRegistered = false;
+        return true;
+    }
+    void OnScheduleUpdates() override
+    {
+        if (mRegistered)
+        {
+            return;
+        }
+        const ECSUtil::UpdateType updateType = ECSUtil::UpdateType::CONCURRENT;
+        const TVector<const Type*> none;
+        const TVector<const Type*> transform = { typeof(TransformComponent) };
+        const TVector<const Type*> bounds = { typeof(BoundsComponent) };
+        mRegistered = StartConstantUpdate("WriterA", UpdateCallback::Make(this, &TestFenceConflictSystem::Write), typeof(ComponentSystemUpdateFence), updateType, none, transform)
+                   && StartConstantUpdate("WriterB", UpdateCallback::Make(this, &TestFenceConflictSystem::Write), typeof(ComponentSystemUpdateFence), updateType, none, transform)
+                   && StartConstantUpdate("Reader", UpdateCallback::Make(this, &TestFenceConflictSystem::Read), typeof(ComponentSystemUpdateFence), updateType, bounds, none);
+    }
+
+    void Write()
+    {
+        const Atomic32 writers = AtomicIncrement32(&sWriters);
+        if (writers > AtomicLoad(&sMaxWriters))
+        {
+            AtomicStore(&sMaxWriters, writers);
+        }
+        SleepCallingThread(2);
+        AtomicDecrement32(&sWriters);
+        AtomicIncrement32(&sUpdates);
+    }
+
+    void Read()
+    {
+        AtomicIncrement32(&sUpdates);
+    }
+};
+DEFINE_CLASS(lf::TestFenceConflictSystem) { NO_REFLECTION; }
+volatile Atomic32 TestFenceConflictSystem::sWriters = 0;
+volatile Atomic32 TestFenceConflictSystem::sMaxWriters = 0;
+volatile Atomic32 TestFenceConflictSystem::sUpdates = 0;
+
 struct TestEnableSystem
 {
     TestEnableSystem(bool& value) : mValue(value) { mValue = true; }
@@ -551,6 +710,40 @@ REGISTER_TEST(World_EntityFlag_Tests, "AbstractEngine.World")
     TEST(ECSUtil::IsDestroyed(id) == true);
     TEST(ECSUtil::GetLifeState(id) == ECSUtil::EntityLifeState::DESTROYED);
     TEST(ECSUtil::GetId(id) == DEFAULT_ID);
+
+    // Generation doesn't change the id or flags
+    id = ECSUtil::SetGeneration(DEFAULT_ID, 0xAB);
+    TEST(ECSUtil::GetGeneration(id) == 0xAB);
+    TEST(ECSUtil::GetId(id) == DEFAULT_ID);
+    TEST(ECSUtil::IsRegister(id) == true);
+    TEST(ECSUtil::IsNormalPriority(id) == true);
+
+    id = ECSUtil::SetHighPriority(ECSUtil::SetUnregister(id));
+    TEST(ECSUtil::GetGeneration(id) == 0xAB);
+    TEST(ECSUtil::GetHandle(id) == ECSUtil::SetGeneration(DEFAULT_ID, 0xAB));
+    TEST(ECSUtil::GetGeneration(ECSUtil::SetGeneration(id, 0x100)) == 0);
+}
+
+REGISTER_TEST(World_EntitySparseIndex_Test, "AbstractEngine.World")
+{
+    EntitySparseIndex index;
+    TEST(Invalid(index.Get(0)));
+    TEST(Invalid(index.Get(ECSUtil::ENTITY_ID_BITMASK)));
+
+    index.Set(7, 3);
+    index.Set(ECSUtil::ENTITY_ID_BITMASK, 12);
+    TEST(index.Get(7) == 3);
+    // Flags and generation are ignored by the sparse index.
+    TEST(index.Get(ECSUtil::SetGeneration(ECSUtil::SetAlive(7), 2)) == 3);
+    TEST(index.Get(ECSUtil::ENTITY_ID_BITMASK) == 12);
+    TEST(Invalid(index.Get(8)));
+
+    index.Reset(7);
+    TEST(Invalid(index.Get(7)));
+    TEST(index.Get(ECSUtil::ENTITY_ID_BITMASK) == 12);
+
+    index.Clear();
+    TEST(Invalid(index.Get(ECSUtil::ENTITY_ID_BITMASK)));
 }
 
 REGISTER_TEST(World_Fence_Test, "AbstractEngine.World")
@@ -658,6 +851,40 @@ REGISTER_TEST(World_Update_Test, "AbstractEngine.World")
     TEST(cUpdate < unregisterUpdate);
 }
 
+REGISTER_TEST(World_FenceConflict_Test, "AbstractEngine.World")
+{
+    TestEnableSystem conflictEnable(TestFenceConflictSystem::sEnable);
+    AtomicStore(&TestFenceConflictSystem::sWriters, 0);
+    AtomicStore(&TestFenceConflictSystem::sMaxWriters, 0);
+    AtomicStore(&TestFenceConflictSystem::sUpdates, 0);
+
+    TStrongPointer<WorldImpl> world(LFNew<WorldImpl>());
+    world->SetType(typeof(WorldImpl));
+
+    // Simulate Services...
+    ServiceContainer container({ typeof(World) });
+    container.Register(world);
+    TestUtils::RegisterDefaultServices(container);
+
+    TEST_CRITICAL(container.Start() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.TryInitialize() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.PostInitialize() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    const SizeT FRAME_COUNT = 8;
+    for (SizeT i = 0; i < FRAME_COUNT; ++i)
+    {
+        TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+        TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+        TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    }
+
+    // The fence completes before the frame does and the writers never overlap.
+    TEST(AtomicLoad(&TestFenceConflictSystem::sWriters) == 0);
+    TEST(AtomicLoad(&TestFenceConflictSystem::sMaxWriters) == 1);
+    TEST(AtomicLoad(&TestFenceConflictSystem::sUpdates) > 0);
+    TEST(AtomicLoad(&TestFenceConflictSystem::sUpdates) % 3 == 0);
+}
+
 REGISTER_TEST(World_EntityCommonLifeTime_Test, "AbstractEngine.World", TestFlags::TF_DISABLED)
 {
     TStrongPointer<WorldImpl> world(LFNew<WorldImpl>());
@@ -935,6 +1162,341 @@ REGISTER_TEST(World_LifeTime_Tests, "AbstractEngine.World")
     TEST(weakEntity == NULL_PTR);
 }
 
+REGISTER_TEST(World_EntityIdRecycle_Test, "AbstractEngine.World")
+{
+    TStrongPointer<WorldImpl> world(LFNew<WorldImpl>());
+    world->SetType(typeof(WorldImpl));
+
+    // Simulate Services...
+    ServiceContainer container({ typeof(World) });
+    container.Register(world);
+    TestUtils::RegisterDefaultServices(container);
+
+    TEST_CRITICAL(container.Start() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.TryInitialize() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.PostInitialize() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    auto mobType = GetMobType();
+    world->RegisterStaticEntityDefinition(&mobType);
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    // Fill the collection so the destroyed entity is swapped with the last row.
+    TVector<EntityAtomicPtr> entities;
+    for (SizeT i = 0; i < 8; ++i)
+    {
+        entities.push_back(world->CreateEntity(&mobType));
+        TEST_CRITICAL(entities.back() != NULL_PTR);
+    }
+
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    EntityAtomicPtr entity = entities[2];
+    entities.erase(entities.begin() + 2);
+    TEST(ECSUtil::IsAlive(entity->GetId()));
+    entity->Destroy();
+
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    const EntityId staleId = entity->GetId();
+    TEST(ECSUtil::IsDestroyed(staleId));
+    TEST(world->FindEntity(staleId) == NULL_PTR);
+    TEST(Invalid(entity->GetCollection()->GetIndexSlow(staleId)));
+
+    // Remaining entities are still mapped to their row after the swap remove.
+    for (EntityAtomicPtr& other : entities)
+    {
+        TEST(world->FindEntity(other->GetId()) == other);
+        TEST(VerifyFlags(world, other));
+    }
+
+    // The raw id is recycled with the next generation, the stale id must not resolve to the new entity.
+    EntityAtomicPtr recycled = world->CreateEntity(&mobType);
+    TEST_CRITICAL(recycled != NULL_PTR);
+    TEST(ECSUtil::GetId(recycled->GetId()) == ECSUtil::GetId(staleId));
+    TEST(ECSUtil::GetGeneration(recycled->GetId()) == ((ECSUtil::GetGeneration(staleId) + 1) & 0xFF));
+    TEST(Valid(recycled->GetCollection()->GetNewIndex(recycled->GetId())));
+    TEST(Invalid(recycled->GetCollection()->GetNewIndexSlow(staleId)));
+
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    TEST(world->FindEntity(recycled->GetId()) == recycled);
+    TEST(VerifyFlags(world, recycled));
+    TEST(Invalid(world->FindEntitySlow(staleId).first));
+    TEST(Invalid(recycled->GetCollection()->GetIndexSlow(staleId)));
+}
+
+REGISTER_TEST(World_ParallelForEach_Test, "AbstractEngine.World")
+{
+    TestEnableSystem parallelEnable(TestParallelForEachSystem::sEnable);
+    TestParallelForEachSystem::sGrainSize = 100;
+    AtomicStore(&TestParallelForEachSystem::sVisited, 0);
+    AtomicStore(&TestParallelForEachSystem::sChunks, 0);
+
+    TStrongPointer<WorldImpl> world(LFNew<WorldImpl>());
+    world->SetType(typeof(WorldImpl));
+
+    // Simulate Services...
+    ServiceContainer container({ typeof(World) });
+    container.Register(world);
+    TestUtils::RegisterDefaultServices(container);
+
+    TEST_CRITICAL(container.Start() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.TryInitialize() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.PostInitialize() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    auto mobType = GetMobType();
+    world->RegisterStaticEntityDefinition(&mobType);
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    // Not a multiple of the grain size so the last chunk is partial.
+    const SizeT ENTITY_COUNT = 1050;
+    TVector<EntityAtomicPtr> entities;
+    for (SizeT i = 0; i < ENTITY_COUNT; ++i)
+    {
+        entities.push_back(world->CreateEntity(&mobType));
+        TEST_CRITICAL(entities.back() != NULL_PTR);
+    }
+
+    // Commit the new entities to the collection
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    AtomicStore(&TestParallelForEachSystem::sVisited, 0);
+    AtomicStore(&TestParallelForEachSystem::sChunks, 0);
+
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    TEST(AtomicLoad(&TestParallelForEachSystem::sVisited) == static_cast<Atomic32>(ENTITY_COUNT));
+    TEST(AtomicLoad(&TestParallelForEachSystem::sChunks) == static_cast<Atomic32>((ENTITY_COUNT + 99) / 100));
+
+    // Every entity is visited exactly once per update
+    Float32 expected = -1.0f;
+    for (EntityAtomicPtr& entity : entities)
+    {
+        TransformComponentData* transform = entity->GetComponent<TransformComponent>();
+        BoundsComponentData* bounds = entity->GetComponent<BoundsComponent>();
+        TEST_CRITICAL(transform != nullptr && bounds != nullptr);
+        if (expected < 0.0f)
+        {
+            expected = transform->mPosition.x;
+            TEST(expected >= 1.0f);
+        }
+        TEST(transform->mPosition.x == expected);
+        TEST(bounds->mMax.x == expected);
+    }
+    TestParallelForEachSystem::sGrainSize = 0;
+}
+
+REGISTER_TEST(World_EntityBlockPool_Test, "AbstractEngine.World")
+{
+    EntityBlockPool pool;
+    UInt8* a = pool.Allocate();
+    UInt8* b = pool.Allocate();
+    TEST_CRITICAL(a != nullptr && b != nullptr && a != b);
+    TEST((reinterpret_cast<UIntPtrT>(a) % ENTITY_BLOCK_ALIGNMENT) == 0);
+    TEST(pool.GetBlockCount() == 2);
+    TEST(pool.GetFreeCount() == 0);
+
+    // Freed blocks are recycled
+    pool.Free(a);
+    TEST(pool.GetFreeCount() == 1);
+    UInt8* c = pool.Allocate();
+    TEST(c == a);
+    TEST(pool.GetBlockCount() == 2);
+
+    pool.Free(b);
+    pool.Free(c);
+    TEST(pool.GetFreeCount() == 2);
+    pool.Trim();
+    TEST(pool.GetFreeCount() == 0);
+    TEST(pool.GetBlockCount() == 0);
+}
+
+REGISTER_TEST(World_EntityBlockStorage_Test, "AbstractEngine.World")
+{
+    TestEnableSystem parallelEnable(TestParallelForEachSystem::sEnable);
+    TestParallelForEachSystem::sGrainSize = 0;
+    AtomicStore(&TestParallelForEachSystem::sVisited, 0);
+    AtomicStore(&TestParallelForEachSystem::sChunks, 0);
+
+    TStrongPointer<WorldImpl> world(LFNew<WorldImpl>());
+    world->SetType(typeof(WorldImpl));
+    world->SetEntityStorageMode(ECSUtil::EntityStorageMode::BLOCK);
+
+    // Simulate Services...
+    ServiceContainer container({ typeof(World) });
+    container.Register(world);
+    TestUtils::RegisterDefaultServices(container);
+
+    TEST_CRITICAL(container.Start() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.TryInitialize() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.PostInitialize() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    auto mobType = GetMobType();
+    world->RegisterStaticEntityDefinition(&mobType);
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    const SizeT ENTITY_COUNT = 2000;
+    TVector<EntityAtomicPtr> entities;
+    for (SizeT i = 0; i < ENTITY_COUNT; ++i)
+    {
+        entities.push_back(world->CreateEntity(&mobType));
+        TEST_CRITICAL(entities.back() != NULL_PTR);
+        entities.back()->GetComponent<TransformComponent>()->mPosition.y = static_cast<Float32>(i);
+    }
+
+    // Commit the new entities to the collection
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    const EntityCollection* collection = entities[0]->GetCollection();
+    TEST_CRITICAL(collection != nullptr);
+    TEST_CRITICAL(collection->GetStorageMode() == ECSUtil::EntityStorageMode::BLOCK);
+    TEST(Valid(collection->GetBlockCapacity()));
+    TEST(collection->GetBlockCount() == (ENTITY_COUNT + collection->GetBlockCapacity() - 1) / collection->GetBlockCapacity());
+    TEST(collection->GetBlockCount() > 1);
+
+    // Growing the collection never moves existing rows.
+    TransformComponentData* first = entities[0]->GetComponent<TransformComponent>();
+    TransformComponentData* last = entities.back()->GetComponent<TransformComponent>();
+    TEST_CRITICAL(first != nullptr && last != nullptr);
+    for (SizeT i = 0; i < ENTITY_COUNT; ++i)
+    {
+        entities.push_back(world->CreateEntity(&mobType));
+        TEST_CRITICAL(entities.back() != NULL_PTR);
+        entities.back()->GetComponent<TransformComponent>()->mPosition.y = static_cast<Float32>(ENTITY_COUNT + i);
+    }
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST(entities[0]->GetComponent<TransformComponent>() == first);
+    TEST(entities[ENTITY_COUNT - 1]->GetComponent<TransformComponent>() == last);
+
+    // Destroy every other entity, the last rows fill the holes and the empty blocks are released.
+    for (SizeT i = 0; i < entities.size(); i += 2)
+    {
+        entities[i]->Destroy();
+    }
+    for (SizeT i = 0; i < 3; ++i)
+    {
+        TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+        TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+        TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    }
+    TEST(collection->Size() == ENTITY_COUNT);
+    TEST(collection->GetBlockCount() == (ENTITY_COUNT + collection->GetBlockCapacity() - 1) / collection->GetBlockCapacity());
+
+    AtomicStore(&TestParallelForEachSystem::sVisited, 0);
+    AtomicStore(&TestParallelForEachSystem::sChunks, 0);
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST(AtomicLoad(&TestParallelForEachSystem::sVisited) == static_cast<Atomic32>(ENTITY_COUNT));
+    TEST(AtomicLoad(&TestParallelForEachSystem::sChunks) >= static_cast<Atomic32>(collection->GetBlockCount()));
+
+    // The surviving entities kept their data
+    for (SizeT i = 1; i < entities.size(); i += 2)
+    {
+        TransformComponentData* transform = entities[i]->GetComponent<TransformComponent>();
+        BoundsComponentData* bounds = entities[i]->GetComponent<BoundsComponent>();
+        TEST_CRITICAL(transform != nullptr && bounds != nullptr);
+        TEST(transform->mPosition.y == static_cast<Float32>(i));
+        TEST(bounds->mMax.x == transform->mPosition.x);
+    }
+}
+
+REGISTER_TEST(World_EntityCommandBuffer_Test, "AbstractEngine.World")
+{
+    TestEnableSystem commandBufferEnable(TestCommandBufferSystem::sEnable);
+
+    TStrongPointer<WorldImpl> world(LFNew<WorldImpl>());
+    world->SetType(typeof(WorldImpl));
+
+    // Simulate Services...
+    ServiceContainer container({ typeof(World) });
+    container.Register(world);
+    TestUtils::RegisterDefaultServices(container);
+
+    TEST_CRITICAL(container.Start() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.TryInitialize() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.PostInitialize() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    auto mobType = GetMobType();
+    world->RegisterStaticEntityDefinition(&mobType);
+    TestCommandBufferSystem::sDefinition = &mobType;
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+
+    // Spawn from the worker threads, the commands are played back at the end of the frame.
+    const SizeT SPAWN_COUNT = 1000;
+    TestCommandBufferSystem::sSpawnCount = SPAWN_COUNT;
+    TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    TEST(TestCommandBufferSystem::sSpawnCount == 0);
+
+    TVector<EntityCollection*> collections = world->FindCollections({ typeof(TransformComponent), typeof(BoundsComponent) }, {});
+    TEST_CRITICAL(collections.size() == 1);
+    EntityCollection* collection = collections[0];
+    TEST_CRITICAL(collection->Size() == SPAWN_COUNT);
+
+    // Playback is sorted by the sort key, so the entities are created (and get their ids) in key order.
+    TVector<std::pair<EntityId, Float32>> rows;
+    for (SizeT i = 0; i < collection->Size(); ++i)
+    {
+        rows.push_back(std::make_pair(ECSUtil::GetId(collection->GetEntity(i)), collection->GetCurrentItem<TransformComponent>(i)->mPosition.y));
+    }
+    std::sort(rows.begin(), rows.end());
+    for (SizeT i = 0; i < rows.size(); ++i)
+    {
+        TEST(rows[i].second == static_cast<Float32>(i));
+    }
+
+    // Destroy half of them from the main thread, the main thread always gets the same buffer
+    EntityCommandBuffer& buffer = world->GetCommandBuffer();
+    TEST(&buffer == &world->GetCommandBuffer());
+    for (SizeT i = 0; i < collection->Size(); ++i)
+    {
+        if (static_cast<SizeT>(collection->GetCurrentItem<TransformComponent>(i)->mPosition.y) % 2 == 1)
+        {
+            buffer.Destroy(collection->GetEntity(i));
+        }
+    }
+    TEST(buffer.GetCommandCount() == SPAWN_COUNT / 2);
+    for (SizeT i = 0; i < 3; ++i)
+    {
+        TEST_CRITICAL(container.BeginFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+        TEST_CRITICAL(container.FrameUpdate() == ServiceResult::SERVICE_RESULT_SUCCESS);
+        TEST_CRITICAL(container.EndFrame() == ServiceResult::SERVICE_RESULT_SUCCESS);
+    }
+    TEST(buffer.Empty());
+    TEST(collection->Size() == SPAWN_COUNT / 2);
+    for (SizeT i = 0; i < collection->Size(); ++i)
+    {
+        TEST(static_cast<SizeT>(collection->GetCurrentItem<TransformComponent>(i)->mPosition.y) % 2 == 0);
+    }
+    TestCommandBufferSystem::sDefinition = nullptr;
+}
+
 REGISTER_TEST(World_DestroyRegister_Test, "AbtractEngine.World")
 {
     TestEnableSystem deleteEntityEnable(TestDeleteEntitySystem::sEnable);
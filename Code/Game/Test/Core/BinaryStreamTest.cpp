@@ -20,7 +20,11 @@
 // ********************************************************************
 #include "Core/Test/Test.h"
 #include "Core/IO/BinaryStream.h"
+#include "Core/Math/Vector3.h"
 #include "Core/Utility/Log.h"
+#include "Core/Utility/Time.h"
+#include "Runtime/Reflection/ReflectionMgr.h"
+#include "Game/Test/TestUtils.h"
 
 namespace lf {
 
@@ -216,4 +220,205 @@ REGISTER_TEST(BinaryStream_StructTest, "Core.IO")
 
 }
 
+struct BinaryStreamCompactData
+{
+    void Serialize(Stream& s)
+    {
+        SERIALIZE_STRUCT(s, mStruct, "");
+        SERIALIZE_ARRAY(s, mTokens, "");
+        SERIALIZE_ARRAY(s, mTypes, "");
+        SERIALIZE_ARRAY(s, mPositions, "");
+        SERIALIZE_ARRAY(s, mWeights, "");
+        SERIALIZE(s, mName, "");
+        SERIALIZE(s, mVersion, "");
+    }
+
+    DummyStruct         mStruct;
+    TVector<Token>      mTokens;
+    TVector<const Type*> mTypes;
+    TVector<Vector3>    mPositions;
+    TVector<Float32>    mWeights;
+    String              mName;
+    UInt64              mVersion;
+};
+LF_INLINE Stream& operator<<(Stream& s, BinaryStreamCompactData& self)
+{
+    self.Serialize(s);
+    return s;
+}
+
+static void FillCompactData(BinaryStreamCompactData& data, SizeT count)
+{
+    const Token names[] = { Token("engine//test/Alpha.lob"), Token("engine//test/Beta.lob"), Token() };
+    data.mStruct.mValue = 1337;
+    data.mStruct.mStruct.mSimpleValue = 173829;
+    data.mStruct.mStructArray.push_back({ 1292 });
+    for (SizeT i = 0; i < count; ++i)
+    {
+        data.mStruct.mValueArray.push_back(static_cast<Int32>(i) * -7);
+        data.mTokens.push_back(names[i % LF_ARRAY_SIZE(names)]);
+        data.mTypes.push_back((i % 3) == 0 ? nullptr : ((i % 3) == 1 ? typeof(TestDynamicStreamDataA) : typeof(TestDynamicStreamDataB)));
+        data.mPositions.push_back(Vector3(static_cast<Float32>(i), 0.5f, -static_cast<Float32>(i)));
+        data.mWeights.push_back(static_cast<Float32>(i) * 0.25f);
+    }
+    data.mName = "BinaryStreamCompactData";
+    data.mVersion = 0x0123456789ABCDEFULL;
+}
+
+static void WriteCompactData(BinaryStreamCompactData& data, MemoryBuffer& buffer, BinaryStream::Format format)
+{
+    BinaryStream bs(Stream::MEMORY, &buffer, Stream::SM_WRITE);
+    bs.SetFormat(format);
+    if (bs.BeginObject("TestName", "TestSuper"))
+    {
+        bs << data;
+        bs.EndObject();
+    }
+    bs.Close();
+}
+
+static bool ReadCompactData(BinaryStreamCompactData& data, MemoryBuffer& buffer, BinaryStream::Format expectedFormat)
+{
+    BinaryStream bs(Stream::MEMORY, &buffer, Stream::SM_READ);
+    if (bs.GetFormat() != expectedFormat || !bs.BeginObject("TestName", "TestSuper"))
+    {
+        return false;
+    }
+    bs << data;
+    bs.EndObject();
+    bs.Close();
+    return true;
+}
+
+static bool CompactDataEquals(const BinaryStreamCompactData& a, const BinaryStreamCompactData& b)
+{
+    return a.mStruct == b.mStruct
+        && a.mTokens == b.mTokens
+        && a.mTypes == b.mTypes
+        && a.mPositions == b.mPositions
+        && a.mWeights == b.mWeights
+        && a.mName == b.mName
+        && a.mVersion == b.mVersion;
+}
+
+REGISTER_TEST(BinaryStream_CompactRoundTripTest, "Core.IO")
+{
+    BinaryStreamCompactData data;
+    FillCompactData(data, 64);
+
+    MemoryBuffer compactBuffer;
+    WriteCompactData(data, compactBuffer, BinaryStream::FORMAT_COMPACT);
+    BinaryStreamCompactData compactResult;
+    TEST(ReadCompactData(compactResult, compactBuffer, BinaryStream::FORMAT_COMPACT));
+    TEST(CompactDataEquals(data, compactResult));
+
+    // ** The legacy format must still be written and read.
+    MemoryBuffer legacyBuffer;
+    WriteCompactData(data, legacyBuffer, BinaryStream::FORMAT_LEGACY);
+    BinaryStreamCompactData legacyResult;
+    TEST(ReadCompactData(legacyResult, legacyBuffer, BinaryStream::FORMAT_LEGACY));
+    TEST(CompactDataEquals(data, legacyResult));
+
+    gTestLog.Info(LogMessage("Legacy Size=") << legacyBuffer.GetSize() << ", Compact Size=" << compactBuffer.GetSize());
+    TEST(compactBuffer.GetSize() < legacyBuffer.GetSize());
+
+    // ** Object names are stored in the string table.
+    BinaryStream bs(Stream::MEMORY, &compactBuffer, Stream::SM_READ);
+    TEST(bs.GetObjectCount() == 1);
+    TEST(bs.GetObjectName(0) == "TestName");
+    TEST(bs.GetObjectSuper(0) == "TestSuper");
+    TEST(!bs.BeginObject("TestName", "OtherSuper"));
+    bs.Close();
+}
+
+REGISTER_TEST(BinaryStream_BulkArrayTest, "Core.IO")
+{
+    // ** Bulk arrays must produce the same bytes as serializing each element.
+    TVector<Int32> values;
+    for (Int32 i = 0; i < 100; ++i)
+    {
+        values.push_back(i * 31 - 1000);
+    }
+
+    MemoryBuffer bulkBuffer;
+    {
+        BinaryStream bs(Stream::MEMORY, &bulkBuffer, Stream::SM_WRITE);
+        bs.BeginObject("TestName", "TestSuper");
+        SERIALIZE_ARRAY(bs, values, "");
+        bs.EndObject();
+        bs.Close();
+    }
+
+    MemoryBuffer elementBuffer;
+    {
+        BinaryStream bs(Stream::MEMORY, &elementBuffer, Stream::SM_WRITE);
+        bs.BeginObject("TestName", "TestSuper");
+        bs.SetArraySize(values.size());
+        for (Int32& value : values)
+        {
+            bs.Serialize(value);
+        }
+        bs.EndObject();
+        bs.Close();
+    }
+
+    TEST_CRITICAL(bulkBuffer.GetSize() == elementBuffer.GetSize());
+    TEST(memcmp(bulkBuffer.GetData(), elementBuffer.GetData(), bulkBuffer.GetSize()) == 0);
+
+    Float32 weights[] = { 0.0f, 1.5f, -2.25f, 1000.125f };
+    Float32 weightsResult[LF_ARRAY_SIZE(weights)] = { 0.0f };
+    MemoryBuffer rawBuffer;
+    {
+        BinaryStream bs(Stream::MEMORY, &rawBuffer, Stream::SM_WRITE);
+        bs.SetFormat(BinaryStream::FORMAT_COMPACT);
+        bs.BeginObject("TestName", "TestSuper");
+        bs.SerializeArray(weights, LF_ARRAY_SIZE(weights));
+        bs.EndObject();
+        bs.Close();
+    }
+    {
+        BinaryStream bs(Stream::MEMORY, &rawBuffer, Stream::SM_READ);
+        TEST_CRITICAL(bs.BeginObject("TestName", "TestSuper"));
+        bs.SerializeArray(weightsResult, LF_ARRAY_SIZE(weightsResult));
+        bs.EndObject();
+        bs.Close();
+    }
+    TEST(memcmp(weights, weightsResult, sizeof(weights)) == 0);
+}
+
+REGISTER_TEST(BinaryStream_CompactBenchmark, "Core.IO", TestFlags::TF_BENCHMARK)
+{
+    const SizeT ITERATIONS = 100;
+    BinaryStreamCompactData data;
+    FillCompactData(data, 4096);
+
+    const BinaryStream::Format formats[] = { BinaryStream::FORMAT_LEGACY, BinaryStream::FORMAT_COMPACT };
+    const char* formatNames[] = { "Legacy", "Compact" };
+    for (SizeT f = 0; f < LF_ARRAY_SIZE(formats); ++f)
+    {
+        MemoryBuffer buffer;
+        Timer writeTimer;
+        writeTimer.Start();
+        for (SizeT i = 0; i < ITERATIONS; ++i)
+        {
+            WriteCompactData(data, buffer, formats[f]);
+        }
+        writeTimer.Stop();
+
+        Timer readTimer;
+        readTimer.Start();
+        for (SizeT i = 0; i < ITERATIONS; ++i)
+        {
+            BinaryStreamCompactData result;
+            TEST_CRITICAL(ReadCompactData(result, buffer, formats[f]));
+        }
+        readTimer.Stop();
+
+        gTestLog.Info(LogMessage(formatNames[f])
+            << ": Size=" << buffer.GetSize()
+            << ", Write=" << ToMilliseconds(TimeTypes::Seconds(writeTimer.GetDelta())).mValue << "ms"
+            << ", Read=" << ToMilliseconds(TimeTypes::Seconds(readTimer.GetDelta())).mValue << "ms");
+    }
+}
+
 }
\ No newline at end of file
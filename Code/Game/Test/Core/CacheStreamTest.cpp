@@ -569,11 +569,50 @@ REGISTER_TEST(CacheBlob_FailReserveTest, "Runtime.Asset")
     TEST_CRITICAL(Invalid(blob.Reserve(1, 0)));
     TEST_CRITICAL(BUG_MESSAGE == CacheBlobError::ERROR_MSG_INVALID_ARGUMENT_SIZE);
     BUG_MESSAGE = NULL_MSG;
+
+    TEST_CRITICAL(Invalid(blob.Reserve(1, 450, 3)));
+    TEST_CRITICAL(BUG_MESSAGE == CacheBlobError::ERROR_MSG_INVALID_ARGUMENT_ALIGNMENT);
+    BUG_MESSAGE = NULL_MSG;
     
     TEST_CRITICAL(Invalid(blob.Reserve(1, 10 * MB + 1)));
     TEST_CRITICAL(BUG_MESSAGE == NULL_MSG);
 }
 
+REGISTER_TEST(CacheBlob_AlignedReserveTest, "Runtime.Asset")
+{
+    CacheBlob blob;
+    blob.Initialize(TVector<CacheObject>(), 4 * KB);
+
+    CacheObject object;
+    CacheObjectId a = blob.Reserve(1, 13);
+    TEST_CRITICAL(Valid(a));
+    CacheObjectId b = blob.Reserve(2, 100, 64);
+    TEST_CRITICAL(Valid(b));
+    TEST_CRITICAL(blob.GetObject(b, object));
+    TEST(object.mLocation == 64);
+    // ** The padding is given to the previous object so the objects stay contiguous.
+    TEST_CRITICAL(blob.GetObject(a, object));
+    TEST(object.mSize == 13);
+    TEST(object.mCapacity == 64);
+    TEST(blob.GetBytesUsed() == 113);
+    TEST(blob.GetBytesReserved() == 164);
+
+    // ** Null objects are only reused when their location is aligned
+    TEST(blob.Destroy(b));
+    CacheObjectId c = blob.Reserve(3, 8, 128);
+    TEST_CRITICAL(Valid(c));
+    TEST(c != b);
+    TEST_CRITICAL(blob.GetObject(c, object));
+    TEST(object.mLocation == 256);
+    CacheObjectId d = blob.Reserve(4, 8, 16);
+    TEST(d == b);
+    TEST(blob.GetBytesReserved() == 264);
+
+    // ** The padding counts against the free bytes
+    TEST(Invalid(blob.Reserve(5, 4 * KB - 264, 512)));
+    TEST(Valid(blob.Reserve(5, 4 * KB - 264)));
+}
+
 REGISTER_TEST(CacheBlob_FailUpdateTest, "Runtime.Asset")
 {
     gReportBugCallback = TestBugReporter;
@@ -1469,6 +1508,64 @@ REGISTER_TEST(CacheReader_ReadTest, "Runtime.Asset")
     }
 }
 
+REGISTER_TEST(CacheReader_ReadViewTest, "Runtime.Asset")
+{
+    const String testBlock = CacheWriterSetup();
+
+    CacheBlock block;
+    block.Initialize(Token("test_cache"), 8 * KB);
+    block.SetFilename(Token(testBlock));
+    CacheIndex i0 = block.Create(0, 1 * KB);
+    CacheIndex i1 = block.Create(1, 2 * KB);
+
+    ByteT source[2 * KB];
+    memset(source, 0x01, sizeof(source));
+    {
+        CacheWriter cw;
+        TEST_CRITICAL(cw.Open(block, i0, source, 1 * KB));
+        TEST_CRITICAL(cw.Write());
+    }
+
+    // ** A reader that was never opened has nothing to view.
+    CacheView view;
+    CacheReader cr;
+    TEST(!cr.ReadView(view));
+    TEST(cr.Open(block, i0, nullptr, 0));
+    TEST_CRITICAL(cr.ReadView(view));
+    TEST(view.mData != nullptr);
+    TEST(view.mSize == 1 * KB);
+    TEST(memcmp(view.mData, source, view.mSize) == 0);
+
+    // ** Writes made after the block was mapped are visible through the view
+    memset(source, 0x02, sizeof(source));
+    {
+        CacheWriter cw;
+        TEST_CRITICAL(cw.Open(block, i0, source, 1 * KB));
+        TEST_CRITICAL(cw.Write());
+        TEST_CRITICAL(cw.Open(block, i1, source, 2 * KB));
+        TEST_CRITICAL(cw.Write());
+    }
+    TEST(memcmp(view.mData, source, view.mSize) == 0);
+
+    CacheView view1;
+    TEST_CRITICAL(block.GetView(i1, view1));
+    TEST(view1.mSize == 2 * KB);
+    TEST(memcmp(view1.mData, source, view1.mSize) == 0);
+
+    // ** Read copies out of the mapping
+    ByteT output[2 * KB];
+    memset(output, 0, sizeof(output));
+    TEST(cr.Open(block, i1, output, sizeof(output)));
+    TEST(cr.Read());
+    TEST(memcmp(output, source, sizeof(output)) == 0);
+
+    // ** Views keep the mapping alive after the block is released
+    block.Release();
+    TEST(view1.mMapping);
+    TEST(memcmp(view1.mData, source, view1.mSize) == 0);
+    TEST(!block.GetView(i0, view));
+}
+
 #if 0
 REGISTER_TEST(CacheBlock_TestEx, "Runtime.Asset")
 {
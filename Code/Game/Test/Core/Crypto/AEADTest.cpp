@@ -0,0 +1,362 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+
+#include "Core/Test/Test.h"
+#include "Core/Crypto/AEAD.h"
+#include "Core/Crypto/AES.h"
+#include "Core/Crypto/HMAC.h"
+#include "Core/Crypto/SecureRandom.h"
+#include "Core/Utility/Log.h"
+#include "Core/Utility/Time.h"
+#include "Runtime/Net/PacketSerializer.h"
+#include <cstring>
+#include <utility>
+
+namespace lf {
+
+REGISTER_TEST(AEADTest, "Core.Crypto")
+{
+    const char MESSAGE[] = "ehre is my message its a bunch of text of a odd length but should encrypt just fine?";
+    const SizeT MESSAGE_SIZE = sizeof(MESSAGE) - 1;
+    const ByteT AAD[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 };
+    ByteT nonce[Crypto::AEAD_NONCE_SIZE] = { 38, 18, 21, 99, 21, 239, 40, 99, 04, 90, 83, 40 };
+
+    Crypto::AESKey key;
+    TEST_CRITICAL(key.Generate(Crypto::AES_KEY_256));
+
+    Crypto::AESKey smallKey;
+    TEST_CRITICAL(smallKey.Generate(Crypto::AES_KEY_128));
+
+    for (Crypto::AEADCipher cipher : { Crypto::AEAD_AES_256_GCM, Crypto::AEAD_CHACHA20_POLY1305 })
+    {
+        Crypto::AEADContext encrypt;
+        Crypto::AEADContext decrypt;
+        TEST(!encrypt.IsInitialized());
+        TEST(!encrypt.Initialize(cipher, &smallKey, true));
+        TEST(!encrypt.Initialize(Crypto::AEAD_Unknown, &key, true));
+        TEST_CRITICAL(encrypt.Initialize(cipher, &key, true));
+        TEST_CRITICAL(decrypt.Initialize(cipher, &key, false));
+        TEST(encrypt.GetCipher() == cipher);
+        TEST(encrypt.IsEncrypt() && !decrypt.IsEncrypt());
+
+        ByteT cipherText[128] = { 0 };
+        ByteT plainText[128] = { 0 };
+        ByteT tag[Crypto::AEAD_TAG_SIZE] = { 0 };
+        const ByteT* message = reinterpret_cast<const ByteT*>(MESSAGE);
+
+        TEST(encrypt.Encrypt(nonce, AAD, sizeof(AAD), message, MESSAGE_SIZE, cipherText, tag));
+        TEST(memcmp(cipherText, message, MESSAGE_SIZE) != 0);
+        TEST(decrypt.Decrypt(nonce, AAD, sizeof(AAD), cipherText, MESSAGE_SIZE, plainText, tag));
+        TEST(memcmp(plainText, message, MESSAGE_SIZE) == 0);
+
+        // The context is reused, a second message must produce the same output for the same nonce.
+        ByteT cipherTextB[128] = { 0 };
+        ByteT tagB[Crypto::AEAD_TAG_SIZE] = { 0 };
+        TEST(encrypt.Encrypt(nonce, AAD, sizeof(AAD), message, MESSAGE_SIZE, cipherTextB, tagB));
+        TEST(memcmp(cipherText, cipherTextB, MESSAGE_SIZE) == 0);
+        TEST(memcmp(tag, tagB, sizeof(tag)) == 0);
+
+        // Wrong direction
+        TEST(!decrypt.Encrypt(nonce, AAD, sizeof(AAD), message, MESSAGE_SIZE, cipherTextB, tagB));
+        TEST(!encrypt.Decrypt(nonce, AAD, sizeof(AAD), cipherText, MESSAGE_SIZE, plainText, tag));
+
+        // Tampering with the aad, cipher text, tag or nonce must fail
+        ByteT badAAD[sizeof(AAD)];
+        memcpy(badAAD, AAD, sizeof(AAD));
+        badAAD[3] ^= 0x01;
+        TEST(!decrypt.Decrypt(nonce, badAAD, sizeof(badAAD), cipherText, MESSAGE_SIZE, plainText, tag));
+        cipherTextB[10] ^= 0x01;
+        TEST(!decrypt.Decrypt(nonce, AAD, sizeof(AAD), cipherTextB, MESSAGE_SIZE, plainText, tag));
+        tagB[0] ^= 0x01;
+        TEST(!decrypt.Decrypt(nonce, AAD, sizeof(AAD), cipherText, MESSAGE_SIZE, plainText, tagB));
+        nonce[0] ^= 0x01;
+        TEST(!decrypt.Decrypt(nonce, AAD, sizeof(AAD), cipherText, MESSAGE_SIZE, plainText, tag));
+        nonce[0] ^= 0x01;
+
+        // A failed decrypt must not break the context
+        TEST(decrypt.Decrypt(nonce, AAD, sizeof(AAD), cipherText, MESSAGE_SIZE, plainText, tag));
+
+        // In place
+        memcpy(plainText, message, MESSAGE_SIZE);
+        TEST(encrypt.Encrypt(nonce, AAD, sizeof(AAD), plainText, MESSAGE_SIZE, plainText, tag));
+        TEST(memcmp(plainText, cipherText, MESSAGE_SIZE) == 0);
+        TEST(decrypt.Decrypt(nonce, AAD, sizeof(AAD), plainText, MESSAGE_SIZE, plainText, tag));
+        TEST(memcmp(plainText, message, MESSAGE_SIZE) == 0);
+
+        Crypto::AEADContext moved(std::move(encrypt));
+        TEST(!encrypt.IsInitialized());
+        TEST(moved.IsInitialized());
+        moved.Release();
+        TEST(!moved.IsInitialized());
+        TEST(moved.GetCipher() == Crypto::AEAD_Unknown);
+    }
+}
+
+static ByteT HexToNibble(char c)
+{
+    if (c >= '0' && c <= '9') { return static_cast<ByteT>(c - '0'); }
+    if (c >= 'a' && c <= 'f') { return static_cast<ByteT>(c - 'a' + 10); }
+    if (c >= 'A' && c <= 'F') { return static_cast<ByteT>(c - 'A' + 10); }
+    return 0;
+}
+
+static SizeT HexToBytes(const char* hex, ByteT* outBytes, SizeT capacity)
+{
+    const SizeT size = strlen(hex) / 2;
+    if (size > capacity)
+    {
+        return 0;
+    }
+    for (SizeT i = 0; i < size; ++i)
+    {
+        outBytes[i] = static_cast<ByteT>((HexToNibble(hex[i * 2]) << 4) | HexToNibble(hex[i * 2 + 1]));
+    }
+    return size;
+}
+
+struct AEADKnownAnswer
+{
+    Crypto::AEADCipher mCipher;
+    const char* mKey;
+    const char* mNonce;
+    const char* mAAD;
+    const char* mPlainText;
+    const char* mCipherText;
+    const char* mTag;
+};
+
+// Test the AEAD ciphers against published vectors. AES-256-GCM is Test Case 16 from the GCM specification
+// (McGrew/Viega, as used by NIST CAVP) and ChaCha20-Poly1305 is the RFC 8439 section 2.8.2 example.
+REGISTER_TEST(AEADKnownAnswerTest, "Core.Crypto")
+{
+    const AEADKnownAnswer VECTORS[] =
+    {
+        {
+            Crypto::AEAD_AES_256_GCM,
+            "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308",
+            "cafebabefacedbaddecaf888",
+            "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+            "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+            "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+            "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+            "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662",
+            "76fc6ece0f4e1768cddf8853bb2d551b"
+        },
+        {
+            Crypto::AEAD_CHACHA20_POLY1305,
+            "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f",
+            "070000004041424344454647",
+            "50515253c0c1c2c3c4c5c6c7",
+            // "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it."
+            "4c616469657320616e642047656e746c656d656e206f662074686520636c6173"
+            "73206f66202739393a204966204920636f756c64206f6666657220796f75206f"
+            "6e6c79206f6e652074697020666f7220746865206675747572652c2073756e73"
+            "637265656e20776f756c642062652069742e",
+            "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+            "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+            "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+            "3ff4def08e4b7a9de576d26586cec64b6116",
+            "1ae10b594f09e26a7e902ecbd0600691"
+        }
+    };
+
+    for (const AEADKnownAnswer& vector : VECTORS)
+    {
+        ByteT keyBytes[32];
+        ByteT nonce[Crypto::AEAD_NONCE_SIZE];
+        ByteT aad[32];
+        ByteT plainText[128];
+        ByteT expectedCipherText[128];
+        ByteT expectedTag[Crypto::AEAD_TAG_SIZE];
+        TEST_CRITICAL(HexToBytes(vector.mKey, keyBytes, sizeof(keyBytes)) == sizeof(keyBytes));
+        TEST_CRITICAL(HexToBytes(vector.mNonce, nonce, sizeof(nonce)) == sizeof(nonce));
+        TEST_CRITICAL(HexToBytes(vector.mTag, expectedTag, sizeof(expectedTag)) == sizeof(expectedTag));
+        const SizeT aadSize = HexToBytes(vector.mAAD, aad, sizeof(aad));
+        const SizeT plainTextSize = HexToBytes(vector.mPlainText, plainText, sizeof(plainText));
+        TEST_CRITICAL(aadSize > 0);
+        TEST_CRITICAL(plainTextSize > 0);
+        TEST_CRITICAL(HexToBytes(vector.mCipherText, expectedCipherText, sizeof(expectedCipherText)) == plainTextSize);
+
+        Crypto::AESKey key;
+        TEST_CRITICAL(key.Load(Crypto::AES_KEY_256, keyBytes));
+        Crypto::AEADContext encrypt;
+        Crypto::AEADContext decrypt;
+        TEST_CRITICAL(encrypt.Initialize(vector.mCipher, &key, true));
+        TEST_CRITICAL(decrypt.Initialize(vector.mCipher, &key, false));
+
+        ByteT cipherText[128] = { 0 };
+        ByteT tag[Crypto::AEAD_TAG_SIZE] = { 0 };
+        TEST(encrypt.Encrypt(nonce, aad, aadSize, plainText, plainTextSize, cipherText, tag));
+        TEST(memcmp(cipherText, expectedCipherText, plainTextSize) == 0);
+        TEST(memcmp(tag, expectedTag, sizeof(tag)) == 0);
+
+        ByteT decrypted[128] = { 0 };
+        TEST(decrypt.Decrypt(nonce, aad, aadSize, expectedCipherText, plainTextSize, decrypted, expectedTag));
+        TEST(memcmp(decrypted, plainText, plainTextSize) == 0);
+    }
+}
+
+// Test that a sealed packet only opens if neither its header nor its data were modified.
+REGISTER_TEST(PacketSerializerSealOpenTest, "Core.Crypto")
+{
+    const char MESSAGE[] = "A sealed packet payload.";
+    const SizeT MESSAGE_SIZE = sizeof(MESSAGE) - 1;
+
+    Crypto::AESKey key;
+    TEST_CRITICAL(key.Generate(Crypto::AES_KEY_256));
+    Crypto::AEADContext encrypt;
+    Crypto::AEADContext decrypt;
+    TEST_CRITICAL(encrypt.Initialize(Crypto::AEAD_AES_256_GCM, &key, true));
+    TEST_CRITICAL(decrypt.Initialize(Crypto::AEAD_AES_256_GCM, &key, false));
+
+    SessionID sessionID;
+    Crypto::SecureRandomBytes(sessionID.Bytes(), sessionID.Size());
+    Crypto::AESIV iv;
+    Crypto::SecureRandomBytes(iv.mBytes, sizeof(iv.mBytes));
+
+    ByteT packet[256] = { 0 };
+    SizeT packetSize = 0;
+    {
+        PacketSerializer ps;
+        TEST_CRITICAL(ps.SetBuffer(packet, sizeof(packet)));
+        ps.SetAppId(1);
+        ps.SetAppVersion(2);
+        ps.SetFlags(0);
+        ps.SetType(NetPacketType::NET_PACKET_TYPE_REQUEST);
+        ps.SetPacketUID(42);
+        ps.SetSessionID(sessionID);
+        ps.SetIV(iv);
+        TEST_CRITICAL(ps.SetData(reinterpret_cast<const ByteT*>(MESSAGE), MESSAGE_SIZE));
+        TEST_CRITICAL(ps.Seal(&encrypt));
+        TEST(ps.HasFlag(NetPacketFlag::NET_PACKET_FLAG_AEAD));
+        ps.SetCrc32(ps.CalcCrc32());
+        packetSize = ps.GetPacketSize();
+    }
+    TEST(memcmp(packet + PacketSerializer::GetFullHeaderSize(), MESSAGE, MESSAGE_SIZE) != 0);
+
+    auto open = [&decrypt, packetSize](const ByteT* bytes, ByteT* outData, SizeT& inOutSize)
+    {
+        PacketSerializer ps;
+        return ps.SetBuffer(bytes, packetSize) && ps.Open(&decrypt, outData, inOutSize);
+    };
+
+    ByteT plainText[256] = { 0 };
+    SizeT plainTextSize = sizeof(plainText);
+    TEST(open(packet, plainText, plainTextSize));
+    TEST(plainTextSize == MESSAGE_SIZE);
+    TEST(memcmp(plainText, MESSAGE, MESSAGE_SIZE) == 0);
+
+    // Each header field in the associated data, the tag and the data must be covered.
+    using TamperCallback = void(*)(PacketSerializer& ps, ByteT* bytes);
+    const TamperCallback TAMPERS[] =
+    {
+        [](PacketSerializer& ps, ByteT*) { ps.SetType(NetPacketType::NET_PACKET_TYPE_MESSAGE); },
+        [](PacketSerializer& ps, ByteT*) { ps.SetPacketUID(43); },
+        [](PacketSerializer& ps, ByteT*) { ps.SetFlag(NetPacketFlag::NET_PACKET_FLAG_RELIABILITY); },
+        [](PacketSerializer& ps, ByteT*) { SessionID other = ps.GetSessionID(); other.Bytes()[0] ^= 0x01; ps.SetSessionID(other); },
+        [](PacketSerializer& ps, ByteT*) { Crypto::AESIV other = ps.GetIV(); other.mBytes[0] ^= 0x01; ps.SetIV(other); },
+        [](PacketSerializer& ps, ByteT*) { Crypto::HMACBuffer tag = ps.GetEncryptedHMAC(); tag.Bytes()[0] ^= 0x01; ps.SetEncryptedHMAC(tag); },
+        [](PacketSerializer&, ByteT* bytes) { bytes[PacketSerializer::GetFullHeaderSize()] ^= 0x01; },
+    };
+    for (TamperCallback tamper : TAMPERS)
+    {
+        ByteT tampered[sizeof(packet)];
+        memcpy(tampered, packet, sizeof(packet));
+        PacketSerializer ps;
+        TEST_CRITICAL(ps.SetBuffer(tampered, sizeof(tampered)));
+        tamper(ps, tampered);
+
+        plainTextSize = sizeof(plainText);
+        TEST(!open(tampered, plainText, plainTextSize));
+    }
+
+    // A failed open doesn't break the decrypt context.
+    plainTextSize = sizeof(plainText);
+    TEST(open(packet, plainText, plainTextSize));
+}
+
+// Compares the per packet cost of the AES-CBC + header HMAC path against the cached AEAD contexts
+// for a typical packet payload. (encrypt + decrypt)
+REGISTER_TEST(AEADBenchmark, "Core.Crypto", TestFlags::TF_BENCHMARK)
+{
+    const SizeT NUM_PACKETS = 100000;
+    const SizeT PAYLOAD_SIZE = 1200;
+    const SizeT HEADER_SIZE = 43; // Flags through IV
+
+    Crypto::AESKey key;
+    TEST_CRITICAL(key.Generate(Crypto::AES_KEY_256));
+    Crypto::HMACKey hmacKey;
+    TEST_CRITICAL(hmacKey.Generate());
+
+    ByteT header[HEADER_SIZE];
+    ByteT payload[PAYLOAD_SIZE];
+    Crypto::SecureRandomBytes(header, sizeof(header));
+    Crypto::SecureRandomBytes(payload, sizeof(payload));
+    ByteT cipherText[PAYLOAD_SIZE + Crypto::AES_IV_SIZE];
+    ByteT plainText[PAYLOAD_SIZE + Crypto::AES_IV_SIZE];
+    const Float64 megabytes = static_cast<Float64>(NUM_PACKETS * PAYLOAD_SIZE) / (1024.0 * 1024.0);
+
+    {
+        Crypto::AESIV iv;
+        Crypto::SecureRandomBytes(iv.mBytes, sizeof(iv.mBytes));
+        Timer timer;
+        timer.Start();
+        for (SizeT i = 0; i < NUM_PACKETS; ++i)
+        {
+            Crypto::HMACBuffer hmac;
+            SizeT cipherTextLength = sizeof(cipherText);
+            SizeT plainTextLength = sizeof(plainText);
+            TEST_CRITICAL(Crypto::AESEncrypt(&key, iv.mBytes, payload, sizeof(payload), cipherText, cipherTextLength));
+            TEST_CRITICAL(hmacKey.Compute(header, sizeof(header), hmac));
+            TEST_CRITICAL(hmacKey.Compute(header, sizeof(header), hmac));
+            TEST_CRITICAL(Crypto::AESDecrypt(&key, iv.mBytes, cipherText, cipherTextLength, plainText, plainTextLength));
+        }
+        timer.Stop();
+        const Float64 ms = ToMilliseconds(TimeTypes::Seconds(timer.GetDelta())).mValue;
+        gTestLog.Info(LogMessage("AES-256-CBC + HMAC x") << NUM_PACKETS << " in " << ms << "ms, " << (megabytes / (ms / 1000.0)) << "MB/s");
+    }
+
+    for (Crypto::AEADCipher cipher : { Crypto::AEAD_AES_256_GCM, Crypto::AEAD_CHACHA20_POLY1305 })
+    {
+        Crypto::AEADContext encrypt;
+        Crypto::AEADContext decrypt;
+        TEST_CRITICAL(encrypt.Initialize(cipher, &key, true));
+        TEST_CRITICAL(decrypt.Initialize(cipher, &key, false));
+
+        ByteT nonce[Crypto::AEAD_NONCE_SIZE];
+        Crypto::SecureRandomBytes(nonce, sizeof(nonce));
+        Timer timer;
+        timer.Start();
+        for (SizeT i = 0; i < NUM_PACKETS; ++i)
+        {
+            ByteT tag[Crypto::AEAD_TAG_SIZE];
+            TEST_CRITICAL(encrypt.Encrypt(nonce, header, sizeof(header), payload, sizeof(payload), cipherText, tag));
+            TEST_CRITICAL(decrypt.Decrypt(nonce, header, sizeof(header), cipherText, sizeof(payload), plainText, tag));
+        }
+        timer.Stop();
+        const Float64 ms = ToMilliseconds(TimeTypes::Seconds(timer.GetDelta())).mValue;
+        gTestLog.Info(LogMessage(cipher == Crypto::AEAD_AES_256_GCM ? "AES-256-GCM" : "ChaCha20-Poly1305") 
+            << " x" << NUM_PACKETS << " in " << ms << "ms, " << (megabytes / (ms / 1000.0)) << "MB/s");
+        TEST(memcmp(plainText, payload, sizeof(payload)) == 0);
+    }
+}
+
+} // namespace lf
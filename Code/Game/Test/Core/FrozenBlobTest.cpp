@@ -0,0 +1,221 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/Test/Test.h"
+#include "Core/IO/FrozenBlob.h"
+#include "Core/Memory/MemoryBuffer.h"
+#include "Runtime/Reflection/ReflectionMgr.h"
+#include "Game/Test/TestUtils.h"
+
+#include <cstddef>
+
+namespace lf {
+
+struct FrozenTestNode
+{
+    UInt32 mID;
+    Float32 mWeight;
+};
+
+// ** Wider than FrozenTestNode, used to read the nodes back with the wrong element type.
+struct FrozenTestWideNode
+{
+    UInt64 mData[8];
+};
+
+struct FrozenTestRoot
+{
+    UInt32                       mVersion;
+    UInt32                       mFlags;
+    TFrozenArray<FrozenTestNode> mNodes;
+    TFrozenArray<char>           mName;
+    TFrozenArray<UInt32>         mEmpty;
+    TFrozenPtr<FrozenTestNode>   mLast;
+    TFrozenPtr<FrozenTestNode>   mNull;
+};
+
+static const UInt32 FROZEN_TEST_VERSION = 1;
+static const SizeT FROZEN_TEST_NUM_NODES = 64;
+
+static FrozenLayout GetFrozenTestLayout()
+{
+    return FrozenLayout::Compute<FrozenTestRoot, FrozenTestNode, char, UInt32>(typeof(TestDynamicStreamDataA), FROZEN_TEST_VERSION);
+}
+
+static SizeT WriteFrozenTestBlob(MemoryBuffer& buffer)
+{
+    FrozenTestNode nodes[FROZEN_TEST_NUM_NODES];
+    for (SizeT i = 0; i < FROZEN_TEST_NUM_NODES; ++i)
+    {
+        nodes[i].mID = static_cast<UInt32>(i * 3);
+        nodes[i].mWeight = static_cast<Float32>(i) * 0.5f;
+    }
+    const char name[] = "FrozenTestRoot";
+
+    FrozenBlobWriter writer;
+    const SizeT root = writer.Allocate<FrozenTestRoot>();
+    writer.Get<FrozenTestRoot>(root)->mVersion = 7;
+    writer.Get<FrozenTestRoot>(root)->mFlags = 0xCAFEBABE;
+
+    const SizeT nodesOffset = writer.Write(nodes, sizeof(nodes), alignof(FrozenTestNode));
+    writer.SetArray<FrozenTestNode>(root + offsetof(FrozenTestRoot, mNodes), nodesOffset, FROZEN_TEST_NUM_NODES);
+    writer.WriteArray<char>(root + offsetof(FrozenTestRoot, mName), name, sizeof(name));
+    writer.WriteArray<UInt32>(root + offsetof(FrozenTestRoot, mEmpty), nullptr, 0);
+    writer.SetPointer<FrozenTestNode>(root + offsetof(FrozenTestRoot, mLast), nodesOffset + sizeof(FrozenTestNode) * (FROZEN_TEST_NUM_NODES - 1));
+
+    TEST(writer.Finish<FrozenTestRoot>(root, GetFrozenTestLayout(), buffer));
+    return root;
+}
+
+// ** MemoryBuffer::Copy does not keep the alignment
+static void CopyFrozenTestBlob(MemoryBuffer& output, const MemoryBuffer& input)
+{
+    output.Free();
+    TEST_CRITICAL(output.Allocate(input.GetSize(), FrozenBlob::GetRequiredAlignment(input.GetData(), input.GetSize())));
+    output.SetSize(input.GetSize());
+    memcpy(output.GetData(), input.GetData(), input.GetSize());
+}
+
+REGISTER_TEST(FrozenBlob_RoundTripTest, "Core.IO")
+{
+    MemoryBuffer buffer;
+    WriteFrozenTestBlob(buffer);
+    TEST_CRITICAL(FrozenBlob::IsFrozenBlob(buffer.GetData(), buffer.GetSize()));
+    TEST((reinterpret_cast<UIntPtrT>(buffer.GetData()) % FrozenBlob::GetRequiredAlignment(buffer.GetData(), buffer.GetSize())) == 0);
+
+    FrozenBlob blob;
+    TEST_CRITICAL(blob.Open(buffer.GetData(), buffer.GetSize(), GetFrozenTestLayout()) == FrozenBlob::OR_SUCCESS);
+    TEST_CRITICAL(blob.IsOpen());
+
+    const FrozenTestRoot* root = blob.GetRoot<FrozenTestRoot>();
+    TEST_CRITICAL(root != nullptr);
+    TEST(root->mVersion == 7);
+    TEST(root->mFlags == 0xCAFEBABE);
+    TEST_CRITICAL(root->mNodes.size() == FROZEN_TEST_NUM_NODES);
+    for (SizeT i = 0; i < FROZEN_TEST_NUM_NODES; ++i)
+    {
+        TEST(root->mNodes[i].mID == static_cast<UInt32>(i * 3));
+        TEST(root->mNodes[i].mWeight == static_cast<Float32>(i) * 0.5f);
+    }
+    TEST(strcmp(root->mName.data(), "FrozenTestRoot") == 0);
+    TEST(root->mEmpty.empty());
+    TEST(root->mEmpty.begin() == root->mEmpty.end());
+    TEST(!root->mLast.IsNull());
+    TEST(root->mLast->mID == static_cast<UInt32>((FROZEN_TEST_NUM_NODES - 1) * 3));
+    TEST(root->mLast.Get() == &root->mNodes[FROZEN_TEST_NUM_NODES - 1]);
+    TEST(root->mNull.IsNull());
+    TEST(root->mNull.Get() == nullptr);
+
+    // ** Offsets are self relative so the blob can be moved without fixing up pointers.
+    MemoryBuffer moved;
+    CopyFrozenTestBlob(moved, buffer);
+    memset(buffer.GetData(), 0, buffer.GetSize());
+    FrozenBlob movedBlob;
+    TEST_CRITICAL(movedBlob.Open(moved.GetData(), moved.GetSize(), GetFrozenTestLayout()) == FrozenBlob::OR_SUCCESS);
+    TEST(movedBlob.GetRoot<FrozenTestRoot>()->mLast->mID == static_cast<UInt32>((FROZEN_TEST_NUM_NODES - 1) * 3));
+    TEST(strcmp(movedBlob.GetRoot<FrozenTestRoot>()->mName.data(), "FrozenTestRoot") == 0);
+}
+
+REGISTER_TEST(FrozenBlob_ValidationTest, "Core.IO")
+{
+    MemoryBuffer buffer;
+    const SizeT rootOffset = WriteFrozenTestBlob(buffer);
+    const SizeT size = buffer.GetSize();
+    const SizeT alignment = FrozenBlob::GetRequiredAlignment(buffer.GetData(), size);
+    TEST_CRITICAL(alignment >= 16);
+
+    FrozenBlob blob;
+    // ** Stale layouts are rejected, the layout changes with the version and the reflected type.
+    FrozenLayout stale = FrozenLayout::Compute<FrozenTestRoot, FrozenTestNode, char, UInt32>(typeof(TestDynamicStreamDataA), FROZEN_TEST_VERSION + 1);
+    FrozenLayout otherType = FrozenLayout::Compute<FrozenTestRoot, FrozenTestNode, char, UInt32>(typeof(TestDynamicStreamDataB), FROZEN_TEST_VERSION);
+    // ** The element types are part of the layout (eg. the node grew but the root did not change)
+    FrozenLayout otherElement = FrozenLayout::Compute<FrozenTestRoot, FrozenTestWideNode, char, UInt32>(typeof(TestDynamicStreamDataA), FROZEN_TEST_VERSION);
+    FrozenLayout rootOnly = FrozenLayout::Compute<FrozenTestRoot>(typeof(TestDynamicStreamDataA), FROZEN_TEST_VERSION);
+    TEST(stale != GetFrozenTestLayout());
+    TEST(otherType != GetFrozenTestLayout());
+    TEST(otherElement != GetFrozenTestLayout());
+    TEST(rootOnly != GetFrozenTestLayout());
+    TEST(GetFrozenTestLayout() == GetFrozenTestLayout());
+    TEST(blob.Open(buffer.GetData(), size, otherElement) == FrozenBlob::OR_LAYOUT_MISMATCH);
+    TEST(blob.Open(buffer.GetData(), size, stale) == FrozenBlob::OR_LAYOUT_MISMATCH);
+    TEST(blob.Open(buffer.GetData(), size, otherType) == FrozenBlob::OR_LAYOUT_MISMATCH);
+    TEST(!blob.IsOpen());
+
+    // ** Truncated or garbage data
+    TEST(blob.Open(buffer.GetData(), size - 8, GetFrozenTestLayout()) == FrozenBlob::OR_INVALID_HEADER);
+    TEST(blob.Open(buffer.GetData(), 32, GetFrozenTestLayout()) == FrozenBlob::OR_INVALID_HEADER);
+    TEST(blob.Open(nullptr, 0, GetFrozenTestLayout()) == FrozenBlob::OR_INVALID_HEADER);
+
+    // ** Misaligned
+    MemoryBuffer misaligned;
+    TEST_CRITICAL(misaligned.Allocate(size + alignment, alignment));
+    ByteT* misalignedData = reinterpret_cast<ByteT*>(misaligned.GetData()) + 8;
+    memcpy(misalignedData, buffer.GetData(), size);
+    TEST(blob.Open(misalignedData, size, GetFrozenTestLayout()) == FrozenBlob::OR_MISALIGNED);
+    TEST(!blob.IsOpen());
+
+    // ** Pointers outside of the blob
+    MemoryBuffer corrupt;
+    CopyFrozenTestBlob(corrupt, buffer);
+    Int64 badOffset = static_cast<Int64>(size) * 2;
+    memcpy(reinterpret_cast<ByteT*>(corrupt.GetData()) + rootOffset + offsetof(FrozenTestRoot, mLast), &badOffset, sizeof(badOffset));
+    TEST(blob.Open(corrupt.GetData(), size, GetFrozenTestLayout()) == FrozenBlob::OR_INVALID_RELOCATION);
+    badOffset = -static_cast<Int64>(rootOffset + offsetof(FrozenTestRoot, mLast));
+    memcpy(reinterpret_cast<ByteT*>(corrupt.GetData()) + rootOffset + offsetof(FrozenTestRoot, mLast), &badOffset, sizeof(badOffset));
+    TEST(blob.Open(corrupt.GetData(), size, GetFrozenTestLayout()) == FrozenBlob::OR_INVALID_RELOCATION);
+
+    // ** Arrays that extend past the data
+    CopyFrozenTestBlob(corrupt, buffer);
+    UInt64 badCount = FROZEN_TEST_NUM_NODES * 1024;
+    memcpy(reinterpret_cast<ByteT*>(corrupt.GetData()) + rootOffset + offsetof(FrozenTestRoot, mNodes) + sizeof(Int64), &badCount, sizeof(badCount));
+    TEST(blob.Open(corrupt.GetData(), size, GetFrozenTestLayout()) == FrozenBlob::OR_INVALID_RELOCATION);
+    TEST(!blob.IsOpen());
+
+    // ** A zero element size would let any count through
+    CopyFrozenTestBlob(corrupt, buffer);
+    UInt64 relocationOffset = 0;
+    UInt64 relocationCount = 0;
+    memcpy(&relocationOffset, reinterpret_cast<ByteT*>(corrupt.GetData()) + 40, sizeof(relocationOffset));
+    memcpy(&relocationCount, reinterpret_cast<ByteT*>(corrupt.GetData()) + 48, sizeof(relocationCount));
+    TEST_CRITICAL(relocationCount > 0);
+    for (UInt64 i = 0; i < relocationCount; ++i)
+    {
+        const UInt32 zero = 0;
+        memcpy(reinterpret_cast<ByteT*>(corrupt.GetData()) + relocationOffset + i * sizeof(UInt64[2]) + sizeof(UInt64), &zero, sizeof(zero));
+    }
+    TEST(blob.Open(corrupt.GetData(), size, GetFrozenTestLayout()) == FrozenBlob::OR_INVALID_RELOCATION);
+    TEST(!blob.IsOpen());
+
+    TEST(blob.Open(buffer.GetData(), size, GetFrozenTestLayout()) == FrozenBlob::OR_SUCCESS);
+    const FrozenTestRoot* root = blob.GetRoot<FrozenTestRoot>();
+    TEST_CRITICAL(root != nullptr);
+    TEST(blob.Contains(root->mNodes));
+    TEST(blob.Contains(root->mName));
+    TEST(blob.Contains(root->mEmpty));
+    TEST(blob.Contains(root->mLast));
+    TEST(blob.Contains(root->mNull));
+    // ** Open validated with the writers element size, reading with a wider type must be checked by the reader.
+    TEST(!blob.Contains(reinterpret_cast<const TFrozenArray<FrozenTestWideNode>&>(root->mNodes)));
+    TEST(!blob.Contains(reinterpret_cast<const TFrozenPtr<FrozenTestWideNode>&>(root->mLast)));
+    blob.Close();
+    TEST(!blob.IsOpen());
+}
+
+} // namespace lf
@@ -20,11 +20,16 @@
 // ********************************************************************
 #include "Core/Test/Test.h"
 #include "Core/IO/MemDB.h"
+#include "Core/IO/MemDBIndex.h"
+#include "Core/IO/MemDBJournal.h"
 #include "Core/Utility/Log.h"
 #include "Core/Utility/Time.h"
 #include "Core/Utility/NumericalVariant.h"
 #include "Core/Math/Random.h"
+#include "Core/Platform/Atomic.h"
 #include "Core/Platform/FileSystem.h"
+#include "Core/Platform/Thread.h"
+#include "Core/String/StringCommon.h"
 
 #include <algorithm>
 
@@ -720,6 +725,40 @@ REGISTER_TEST(MemDB_InsertStress_Test, "Core.IO")
     LogStats(db);
 }
 
+// Test that buffers retired by table growth are freed once no reader can see them.
+REGISTER_TEST(MemDB_RetiredReclaim_Test, "Core.IO")
+{
+    Int32 seed = 0x3876239;
+
+    MemDB db;
+    TableID info;
+    TEST_CRITICAL(db.CreateTable<TestInfo_DO>("info", info));
+
+    TestInfo_DO infoDO;
+    EntryID infoID;
+    for (SizeT i = 0; i < 4096; ++i)
+    {
+        infoDO.Generate(seed);
+        infoDO.mItemID = static_cast<UInt32>(i);
+        TEST(db.Insert(info, infoDO, infoID));
+    }
+
+    MemDBStats stats = db.GetTableStats(info);
+    TEST(stats.mResizeCount > 1);
+    TEST(stats.mRetiredBuffers == 0);
+
+    // Delete and recreate, the freed slot is reused and nothing is left retired.
+    TEST(db.DeleteTable(info));
+    TEST_CRITICAL(db.CreateTable<TestInfo_DO>("info", info));
+    for (SizeT i = 0; i < 4096; ++i)
+    {
+        infoDO.Generate(seed);
+        TEST(db.Insert(info, infoDO, infoID));
+    }
+    stats = db.GetStats();
+    TEST(stats.mRetiredBuffers == 0);
+}
+
 // Test the performance of insert into memdb which has 
 // random deletions
 REGISTER_TEST(MemDB_RandomInsertStress_Test, "Core.IO")
@@ -943,4 +982,508 @@ REGISTER_TEST(MemDB_FindIndexedStress_Test, "Core.IO")
     LogStats(db);
 }
 
+REGISTER_TEST(MemDB_IndexTree_Test, "Core.IO")
+{
+    Int32 seed = 0x1F3A21;
+    const SizeT COUNT = 20000;
+    const UInt32 VALUE_RANGE = 500; // Force lots of duplicate values
+
+    MemDBIndexTree tree;
+    TVector<EntryIndex> records;
+    records.reserve(COUNT);
+    for (SizeT i = 0; i < COUNT; ++i)
+    {
+        EntryIndex record;
+        record.mValue = NumericalVariant(static_cast<UInt32>(Random::Mod(seed, VALUE_RANGE)));
+        record.mID = static_cast<EntryID>(i);
+        TEST(tree.Insert(record));
+        records.push_back(record);
+    }
+    TEST(tree.Size() == COUNT);
+    TEST(tree.Validate());
+    TEST(!tree.Insert(records[0]));
+
+    // Every record with the value is returned in id order
+    for (UInt32 value = 0; value < VALUE_RANGE; ++value)
+    {
+        SizeT expected = 0;
+        for (const EntryIndex& record : records)
+        {
+            expected += record.mValue == NumericalVariant(value) ? 1 : 0;
+        }
+        SizeT found = 0;
+        EntryID lastID = 0;
+        for (MemDBIndexTree::Iterator it = tree.LowerBound(NumericalVariant(value)); it.Valid() && it->mValue == NumericalVariant(value); ++it)
+        {
+            TEST(found == 0 || it->mID > lastID);
+            lastID = it->mID;
+            ++found;
+        }
+        TEST(found == expected);
+        TEST(tree.Contains(NumericalVariant(value)) == (expected > 0));
+    }
+
+    // Remove every other record
+    for (SizeT i = 0; i < COUNT; i += 2)
+    {
+        TEST(tree.Remove(records[i]));
+        TEST(!tree.Remove(records[i]));
+    }
+    TEST(tree.Size() == COUNT / 2);
+    TEST(tree.Validate());
+
+    // Bulk load builds the same tree
+    TVector<EntryIndex> remaining;
+    tree.CopyTo(remaining);
+    TEST(remaining.size() == COUNT / 2);
+    MemDBIndexTree bulkTree;
+    bulkTree.BulkLoad(remaining);
+    TEST(bulkTree.Size() == COUNT / 2);
+    TEST(bulkTree.Validate());
+    MemDBIndexTree::Iterator a = tree.Begin();
+    MemDBIndexTree::Iterator b = bulkTree.Begin();
+    for (; a.Valid() && b.Valid(); ++a, ++b)
+    {
+        TEST(a->mValue == b->mValue && a->mID == b->mID);
+    }
+    TEST(!a.Valid() && !b.Valid());
+
+    for (SizeT i = 1; i < COUNT; i += 2)
+    {
+        TEST(tree.Remove(records[i]));
+    }
+    TEST(tree.Empty());
+    TEST(tree.GetBytesReserved() == 0);
+    TEST(tree.Validate());
+}
+
+REGISTER_TEST(MemDB_IndexedCRUD_Test, "Core.IO")
+{
+    Int32 seed = 0x77A1C3;
+    MemDB db;
+    TableID info;
+    TEST_CRITICAL(db.CreateTable<TestInfo_DO>("info", info));
+    TEST_CRITICAL(db.CreateIndex(info, NumericalVariantType::VT_U32, offsetof(TestInfo_DO, mItemID)));
+    TEST_CRITICAL(db.CreateIndex(info, NumericalVariantType::VT_U32, offsetof(TestInfo_DO, mParentID), true));
+
+    const SizeT COUNT = 5000;
+    const UInt32 NUM_PARENTS = 50;
+    TVector<TestInfo_DO> objects;
+    objects.resize(COUNT);
+    for (SizeT i = 0; i < COUNT; ++i)
+    {
+        objects[i].Generate(seed);
+        objects[i].mItemID = static_cast<UInt32>(i);
+        objects[i].mParentID = static_cast<UInt32>(i % NUM_PARENTS);
+    }
+
+    // Bulk load the first half, insert the second half one at a time.
+    TVector<TestInfo_DO> firstHalf;
+    firstHalf.insert(firstHalf.end(), objects.begin(), objects.begin() + COUNT / 2);
+    TVector<EntryID> ids;
+    TEST_CRITICAL(db.BulkInsert(info, firstHalf, ids));
+    for (SizeT i = 0; i < ids.size(); ++i)
+    {
+        objects[i].mReservedID = ids[i];
+    }
+    for (SizeT i = COUNT / 2; i < COUNT; ++i)
+    {
+        TEST_CRITICAL(db.Insert(info, objects[i], objects[i].mReservedID));
+    }
+
+    // Unique index rejects duplicates
+    EntryID duplicateID;
+    TEST(!db.Insert(info, objects[0], duplicateID));
+    TVector<TestInfo_DO> duplicates;
+    duplicates.insert(duplicates.end(), objects.begin(), objects.begin() + 2);
+    TEST(!db.BulkInsert(info, duplicates, ids));
+
+    for (const TestInfo_DO& object : objects)
+    {
+        EntryID resultID;
+        TEST(db.FindOneIndexed(info, NumericalVariant(object.mItemID), offsetof(TestInfo_DO, mItemID), resultID));
+        TEST(resultID == object.mReservedID);
+    }
+
+    TVector<EntryID> children;
+    TEST(db.FindRangeIndexed(info, NumericalVariant(UInt32(7)), offsetof(TestInfo_DO, mParentID), children));
+    TEST(children.size() == COUNT / NUM_PARENTS);
+
+    // Update moves the entry in the index
+    TestInfo_DO updated = objects[7];
+    updated.mItemID = static_cast<UInt32>(COUNT + 7);
+    TEST(db.UpdateOne(info, updated.mReservedID, &updated));
+    EntryID resultID;
+    TEST(!db.FindOneIndexed(info, NumericalVariant(objects[7].mItemID), offsetof(TestInfo_DO, mItemID), resultID));
+    TEST(db.FindOneIndexed(info, NumericalVariant(updated.mItemID), offsetof(TestInfo_DO, mItemID), resultID));
+    TEST(resultID == updated.mReservedID);
+
+    // Delete removes the entry from every index
+    for (SizeT i = 0; i < COUNT; i += NUM_PARENTS)
+    {
+        TEST(db.Delete(info, objects[i].mReservedID));
+    }
+    children.clear();
+    TEST(db.FindRangeIndexed(info, NumericalVariant(UInt32(0)), offsetof(TestInfo_DO, mParentID), children));
+    TEST(children.empty());
+    TEST(!db.FindOneIndexed(info, NumericalVariant(objects[NUM_PARENTS].mItemID), offsetof(TestInfo_DO, mItemID), resultID));
+    LogStats(db);
+}
+
+REGISTER_TEST(MemDB_HashIndex_Test, "Core.IO")
+{
+    MemDB db;
+    TableID idToName;
+    TEST_CRITICAL(db.CreateTable<TestIDToName_DO>("idToName", idToName));
+
+    const SizeT COUNT = 2000;
+    TVector<TestIDToName_DO> objects;
+    objects.resize(COUNT);
+    for (SizeT i = 0; i < COUNT; ++i)
+    {
+        objects[i].mItemID = static_cast<UInt32>(i % 10);
+        objects[i].mName.Assign((String("engine//test/object_") + ToString(i) + ".lob").CStr());
+    }
+
+    TVector<EntryID> ids;
+    TEST_CRITICAL(db.BulkInsert(idToName, objects, ids));
+    for (SizeT i = 0; i < COUNT; ++i)
+    {
+        objects[i].mReservedID = ids[i];
+    }
+
+    // Unique string key
+    HashKeyColumn nameColumn = HashKeyColumn::String<MemDBChar<64>>(offsetof(TestIDToName_DO, mName));
+    HashIndexID nameIndex;
+    TEST_CRITICAL(db.CreateHashIndex(idToName, &nameColumn, 1, false, nameIndex));
+    HashIndexID duplicateIndex;
+    TEST(!db.CreateHashIndex(idToName, &nameColumn, 1, false, duplicateIndex));
+
+    // Composite multi-valued key
+    HashKeyColumn compositeColumns[] = 
+    {
+        HashKeyColumn::Value<UInt32>(offsetof(TestIDToName_DO, mItemID)),
+        HashKeyColumn::String<MemDBChar<64>>(offsetof(TestIDToName_DO, mName))
+    };
+    HashIndexID compositeIndex;
+    TEST_CRITICAL(db.CreateHashIndex(idToName, compositeColumns, LF_ARRAY_SIZE(compositeColumns), true, compositeIndex));
+    HashKeyColumn itemColumn = HashKeyColumn::Value<UInt32>(offsetof(TestIDToName_DO, mItemID));
+    HashIndexID itemIndex;
+    TEST_CRITICAL(db.CreateHashIndex(idToName, &itemColumn, 1, true, itemIndex));
+    // Not unique
+    TEST(!db.CreateHashIndex(idToName, compositeColumns, 1, false, duplicateIndex));
+
+    for (const TestIDToName_DO& object : objects)
+    {
+        TestIDToName_DO key;
+        key.mName = object.mName;
+        EntryID resultID;
+        TEST(db.FindOneHashed(idToName, nameIndex, key, resultID));
+        TEST(resultID == object.mReservedID);
+
+        key.mItemID = object.mItemID;
+        TEST(db.FindOneHashed(idToName, compositeIndex, key, resultID));
+        TEST(resultID == object.mReservedID);
+    }
+
+    TestIDToName_DO key;
+    key.mItemID = 3;
+    TVector<EntryID> results;
+    TEST(db.FindAllHashed(idToName, itemIndex, key, results));
+    TEST(results.size() == COUNT / 10);
+
+    // Unique key rejects inserts
+    EntryID insertID;
+    TEST(!db.Insert(idToName, objects[5], insertID));
+
+    // Updating the key moves the entry in the index
+    TestIDToName_DO renamed = objects[5];
+    renamed.mName = MemDBField("engine//test/renamed.lob");
+    TEST(db.UpdateOne(idToName, renamed.mReservedID, &renamed));
+    EntryID resultID;
+    TEST(!db.FindOneHashed(idToName, nameIndex, objects[5], resultID));
+    TEST(db.FindOneHashed(idToName, nameIndex, renamed, resultID));
+    TEST(resultID == renamed.mReservedID);
+
+    // Delete removes the entry from the index
+    TEST(db.Delete(idToName, renamed.mReservedID));
+    TEST(!db.FindOneHashed(idToName, nameIndex, renamed, resultID));
+    TEST(db.Insert(idToName, objects[5], insertID));
+    TEST(db.FindOneHashed(idToName, nameIndex, objects[5], resultID));
+    TEST(resultID == insertID);
+    LogStats(db);
+}
+
+static void CopyTestFile(const String& source, const String& destination)
+{
+    File sourceFile;
+    if (!sourceFile.Open(source, FF_READ | FF_SHARE_READ | FF_SHARE_WRITE, FILE_OPEN_EXISTING))
+    {
+        return;
+    }
+    TVector<ByteT> bytes;
+    bytes.resize(static_cast<SizeT>(sourceFile.GetSize()));
+    TEST(sourceFile.Read(bytes.data(), bytes.size()) == bytes.size());
+
+    File destinationFile;
+    TEST_CRITICAL(destinationFile.Open(destination, FF_WRITE, FILE_OPEN_CREATE_NEW));
+    TEST(destinationFile.Write(bytes.data(), bytes.size()) == bytes.size());
+}
+
+static void DeleteJournalTestFiles(const String& path)
+{
+    MemDBJournal::Delete(path);
+    const String tablePath = path + "_info.db";
+    if (FileSystem::FileExists(tablePath))
+    {
+        FileSystem::FileDelete(tablePath);
+    }
+}
+
+static void VerifyJournalTest(MemDB& db, TableID info, const TVector<TestInfo_DO>& objects, const TVector<bool>& deleted)
+{
+    for (SizeT i = 0; i < objects.size(); ++i)
+    {
+        bool found = false;
+        bool equal = false;
+        const TestInfo_DO& expected = objects[i];
+        found = db.SelectRead<TestInfo_DO>(info, expected.mReservedID, [&expected, &equal](const TestInfo_DO* item)
+        {
+            equal = *item == expected;
+        });
+        TEST(found != deleted[i]);
+        TEST(deleted[i] || equal);
+    }
+}
+
+REGISTER_TEST(MemDB_Journal_Test, "Core.IO")
+{
+    const String path = FileSystem::PathJoin(TestFramework::GetTempDirectory(), "MemDB_Journal_Test");
+    const String recoveryPath = FileSystem::PathJoin(TestFramework::GetTempDirectory(), "MemDB_JournalRecovery_Test");
+    DeleteJournalTestFiles(path);
+    DeleteJournalTestFiles(recoveryPath);
+
+    const SizeT COUNT = 100;
+    Int32 seed = 0x2C41;
+    TVector<TestInfo_DO> objects;
+    TVector<bool> deleted;
+    {
+        MemDB db;
+        TableID info;
+        TEST_CRITICAL(db.CreateTable<TestInfo_DO>("info", info));
+        db.Open(path);
+
+        MemDBJournalConfig config;
+        config.mBackgroundThread = false;
+        config.mSyncToDisk = false;
+        TEST_CRITICAL(db.EnableJournal(config));
+        TEST(db.IsJournalEnabled());
+
+        TestInfo_DO infoDO;
+        for (SizeT i = 0; i < COUNT; ++i)
+        {
+            EntryID id;
+            TEST_CRITICAL(db.Insert(info, infoDO.Generate(seed), id));
+            infoDO.mReservedID = id;
+            objects.push_back(infoDO);
+            deleted.push_back(false);
+        }
+        for (SizeT i = 0; i < COUNT; i += 5)
+        {
+            objects[i].mInstanceCount += 1000;
+            TEST(db.UpdateOne(info, objects[i].mReservedID, &objects[i]));
+        }
+        for (SizeT i = 1; i < COUNT; i += 10)
+        {
+            TEST(db.Delete(info, objects[i].mReservedID));
+            deleted[i] = true;
+        }
+        TEST(db.CommitJournal());
+
+        // Snapshot the journal as if the process crashed before a checkpoint.
+        for (SizeT slot = 0; slot < 2; ++slot)
+        {
+            CopyTestFile(MemDBJournal::GetFilename(path, slot), MemDBJournal::GetFilename(recoveryPath, slot));
+        }
+
+        // Close checkpoints the journal into the table files.
+        db.Close();
+        TEST(!FileSystem::FileExists(MemDBJournal::GetFilename(path, 0)));
+        TEST(!FileSystem::FileExists(MemDBJournal::GetFilename(path, 1)));
+    }
+
+    // Recover from the journal alone
+    {
+        MemDB db;
+        TableID info;
+        TEST_CRITICAL(db.CreateTable<TestInfo_DO>("info", info));
+        db.Open(recoveryPath);
+        db.Load();
+        VerifyJournalTest(db, info, objects, deleted);
+        db.Close();
+    }
+
+    // Load the checkpointed tables
+    {
+        MemDB db;
+        TableID info;
+        TEST_CRITICAL(db.CreateTable<TestInfo_DO>("info", info));
+        db.Open(path);
+        db.Load();
+        VerifyJournalTest(db, info, objects, deleted);
+        db.Close();
+    }
+
+    DeleteJournalTestFiles(path);
+    DeleteJournalTestFiles(recoveryPath);
+}
+
+struct ConcurrentEntry_DO : public MemDBTypes::Entry
+{
+    UInt32 mValues[8];
+};
+
+struct MemDBConcurrencyState
+{
+    MemDB*            mDB;
+    TableID           mTables[2];
+    SizeT             mNumEntries;
+    SizeT             mIterations;
+    SizeT             mWritePercent;
+    volatile Atomic32 mExecute;
+    volatile Atomic32 mTornReads;
+};
+
+struct MemDBConcurrencyThread
+{
+    MemDBConcurrencyState* mState;
+    Thread                 mThread;
+    Int32                  mSeed;
+    SizeT                  mTableIndex;
+};
+
+static void MemDBConcurrencyWorker(void* data)
+{
+    MemDBConcurrencyThread* self = reinterpret_cast<MemDBConcurrencyThread*>(data);
+    MemDBConcurrencyState* state = self->mState;
+    const TableID table = state->mTables[self->mTableIndex];
+
+    while (AtomicLoad(&state->mExecute) == 0)
+    {
+
+    }
+
+    ConcurrentEntry_DO update;
+    for (SizeT i = 0; i < state->mIterations; ++i)
+    {
+        const EntryID id = static_cast<EntryID>(Random::Range(self->mSeed, 0, static_cast<Int32>(state->mNumEntries - 1)));
+        if (static_cast<SizeT>(Random::Range(self->mSeed, 0, 99)) < state->mWritePercent)
+        {
+            // Every value in the entry is the same, readers can detect a torn copy.
+            const UInt32 value = static_cast<UInt32>(i);
+            for (UInt32& item : update.mValues)
+            {
+                item = value;
+            }
+            state->mDB->UpdateOne(table, id, &update);
+        }
+        else
+        {
+            state->mDB->SelectRead<ConcurrentEntry_DO>(table, id, [state](const ConcurrentEntry_DO* entry)
+            {
+                for (UInt32 item : entry->mValues)
+                {
+                    if (item != entry->mValues[0])
+                    {
+                        AtomicIncrement32(&state->mTornReads);
+                        break;
+                    }
+                }
+            });
+        }
+    }
+}
+
+// Runs 'numThreads' threads doing 'writePercent' updates and selects for the rest, when 'splitTables'
+// is true the threads are split between two tables.
+static Float64 RunMemDBConcurrency(SizeT numThreads, SizeT writePercent, bool splitTables, SizeT iterations, Atomic32& outTornReads)
+{
+    const SizeT NUM_ENTRIES = 1024;
+
+    MemDB db;
+    MemDBConcurrencyState state;
+    state.mDB = &db;
+    state.mNumEntries = NUM_ENTRIES;
+    state.mIterations = iterations;
+    state.mWritePercent = writePercent;
+    AtomicStore(&state.mExecute, 0);
+    AtomicStore(&state.mTornReads, 0);
+
+    TVector<ConcurrentEntry_DO> entries;
+    entries.resize(NUM_ENTRIES);
+    memset(entries.data(), 0, entries.size() * sizeof(ConcurrentEntry_DO));
+    TVector<EntryID> ids;
+    for (SizeT i = 0; i < LF_ARRAY_SIZE(state.mTables); ++i)
+    {
+        TEST(db.CreateTable<ConcurrentEntry_DO>(String("concurrent_") + ToString(i), NUM_ENTRIES, state.mTables[i]));
+        TEST(db.BulkInsert(state.mTables[i], entries, ids));
+    }
+
+    TVector<MemDBConcurrencyThread> threads;
+    threads.resize(numThreads);
+    for (SizeT i = 0; i < numThreads; ++i)
+    {
+        threads[i].mState = &state;
+        threads[i].mSeed = static_cast<Int32>(0x1F3A + i * 97);
+        threads[i].mTableIndex = splitTables ? (i % 2) : 0;
+        threads[i].mThread.Fork(MemDBConcurrencyWorker, &threads[i]);
+    }
+
+    Timer timer;
+    timer.Start();
+    AtomicStore(&state.mExecute, 1);
+    for (MemDBConcurrencyThread& thread : threads)
+    {
+        thread.mThread.Join();
+    }
+    timer.Stop();
+
+    outTornReads = AtomicLoad(&state.mTornReads);
+    return timer.GetDelta();
+}
+
+REGISTER_TEST(MemDB_ConcurrentSelect_Test, "Core.IO", TestFlags::TF_STRESS)
+{
+    Atomic32 tornReads = 0;
+    RunMemDBConcurrency(8, 25, false, 100000, tornReads);
+    TEST(tornReads == 0);
+}
+
+REGISTER_TEST(MemDB_ConcurrencyBenchmark, "Core.IO", TestFlags::TF_BENCHMARK)
+{
+    const SizeT ITERATIONS = 200000;
+    const SizeT THREAD_COUNTS[] = { 1, 2, 4, 8 };
+    const SizeT WRITE_PERCENTS[] = { 0, 5, 50 };
+
+    for (SizeT writePercent : WRITE_PERCENTS)
+    {
+        for (SizeT split = 0; split < 2; ++split)
+        {
+            for (SizeT numThreads : THREAD_COUNTS)
+            {
+                Atomic32 tornReads = 0;
+                Float64 seconds = RunMemDBConcurrency(numThreads, writePercent, split != 0, ITERATIONS, tornReads);
+                TEST(tornReads == 0);
+
+                const Float64 opsPerSecond = static_cast<Float64>(numThreads * ITERATIONS) / seconds;
+                gTestLog.Info(LogMessage("MemDB threads=") << numThreads 
+                    << " writes=" << writePercent << "%" 
+                    << " tables=" << (split != 0 ? 2 : 1)
+                    << " took " << ToMilliseconds(TimeTypes::Seconds(seconds)).mValue << "ms"
+                    << " (" << static_cast<SizeT>(opsPerSecond) << " ops/s)");
+            }
+        }
+    }
+}
+
 } // namespace lf 
\ No newline at end of file
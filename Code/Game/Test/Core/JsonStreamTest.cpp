@@ -21,6 +21,7 @@
 #include "Core/Test/Test.h"
 #include "Core/IO/JsonStream.h"
 #include "Core/Utility/Log.h"
+#include "Core/Utility/Time.h"
 #include "Game/Test/TestUtils.h"
 
 namespace lf {
@@ -117,4 +118,186 @@ REGISTER_TEST(JsonStream_DynamicTypeTest, "Core.IO")
 
 }
 
+static void MakeDummyStruct(DummyStruct& data)
+{
+    data.mValue = 1337;
+    data.mStruct.mSimpleValue = 173829;
+    data.mValueArray.clear();
+    data.mValueArray.push_back(28131);
+    data.mValueArray.push_back(-1828);
+    data.mValueArray.push_back(1992921);
+    data.mStructArray.clear();
+    data.mStructArray.push_back({ 1292 });
+    data.mStructArray.push_back({ -1292 });
+}
+
+static bool ReadDummyStruct(String& text, JsonStream::ReadMode readMode, DummyStruct& output)
+{
+    output.mValue = 0;
+    output.mStruct.mSimpleValue = 0;
+    output.mValueArray.clear();
+    output.mStructArray.clear();
+
+    JsonStream ts(Stream::TEXT, &text, Stream::SM_READ, readMode);
+    if (ts.GetMode() != Stream::SM_READ)
+    {
+        return false;
+    }
+    ts << output;
+    ts.Close();
+    return true;
+}
+
+REGISTER_TEST(JsonStream_StreamingReadTest, "Core.IO")
+{
+    DummyStruct data;
+    MakeDummyStruct(data);
+
+    // ** Members in the order they are serialized
+    String inOrder = "{\"Struct\":{\"SimpleValue\":173829},\"StructArray\":[{\"SimpleValue\":1292},{\"SimpleValue\":-1292}],\"ValueArray\":[28131,-1828,1992921],\"Value\":1337}";
+    // ** Members out of order, unknown members and whitespace
+    String outOfOrder = "{ \"Unknown\" : { \"Value\" : [1, 2, {\"Struct\":3}] },\n"
+        "  \"Value\" : 1337,\n"
+        "  \"ValueArray\" : [ 28131 , -1828 , 1992921 ],\n"
+        "  \"StructArray\" : [ { \"Other\" : \"}]\\\"\", \"SimpleValue\" : 1292 }, { \"SimpleValue\" : -1292 } ],\n"
+        "  \"Str\\u0075ct\" : { \"SimpleValue\" : 173829 }\n"
+        "}";
+
+    DummyStruct output;
+    TEST(ReadDummyStruct(inOrder, JsonStream::RM_STREAMING, output));
+    TEST(output == data);
+    TEST(ReadDummyStruct(outOfOrder, JsonStream::RM_STREAMING, output));
+    TEST(output == data);
+    TEST(ReadDummyStruct(outOfOrder, JsonStream::RM_DOCUMENT, output));
+    TEST(output == data);
+
+    // ** Round trip through the writer
+    String written;
+    JsonStream ws(Stream::TEXT, &written, Stream::SM_PRETTY_WRITE);
+    ws << data;
+    ws.Close();
+    TEST(ReadDummyStruct(written, JsonStream::RM_STREAMING, output));
+    TEST(output == data);
+
+    // ** Invalid text fails to open the same as a document
+    String invalid = "{\"Value\":1337,";
+    TEST(!ReadDummyStruct(invalid, JsonStream::RM_STREAMING, output));
+    String notObject = "[1, 2, 3]";
+    TEST(!ReadDummyStruct(notObject, JsonStream::RM_STREAMING, output));
+
+    // ** Auto reads small text as a document and large text with the streaming reader
+    TEST(ReadDummyStruct(outOfOrder, JsonStream::RM_AUTO, output));
+    TEST(output == data);
+    DummyStruct large;
+    MakeDummyStruct(large);
+    for (Int32 i = 0; i < 16 * 1024; ++i)
+    {
+        large.mValueArray.push_back(i * 13 - 4096);
+    }
+    String largeText;
+    JsonStream lws(Stream::TEXT, &largeText, Stream::SM_WRITE);
+    lws << large;
+    lws.Close();
+    TEST_CRITICAL(largeText.Size() >= JsonStream::STREAMING_READ_THRESHOLD);
+    TEST(ReadDummyStruct(largeText, JsonStream::RM_AUTO, output));
+    TEST(output == large);
+    TEST(!ReadDummyStruct(invalid, JsonStream::RM_AUTO, output));
+}
+
+REGISTER_TEST(JsonStream_StreamingMismatchTest, "Core.IO")
+{
+    // ** Members that are missing or of the wrong type are skipped without disturbing the members after them.
+    String text = "{\"Struct\":12,\"StructArray\":{\"SimpleValue\":5},\"ValueArray\":[1,\"two\",3],\"Value\":\"1337\",\"Extra\":[[1],[2]]}";
+    DummyStruct output;
+    TEST_CRITICAL(ReadDummyStruct(text, JsonStream::RM_STREAMING, output));
+    TEST(output.mStruct.mSimpleValue == 0);
+    TEST(output.mStructArray.empty());
+    TEST_CRITICAL(output.mValueArray.size() == 3);
+    TEST(output.mValueArray[0] == 1);
+    TEST(output.mValueArray[2] == 3);
+    TEST(output.mValue == 0);
+
+    String missing = "{\"Value\":42}";
+    TEST_CRITICAL(ReadDummyStruct(missing, JsonStream::RM_STREAMING, output));
+    TEST(output.mValue == 42);
+    TEST(output.mStructArray.empty());
+    TEST(output.mValueArray.empty());
+}
+
+REGISTER_TEST(JsonStream_StreamingDynamicTypeTest, "Core.IO")
+{
+    TestDynamicStreamDataAPtr a(LFNew<TestDynamicStreamDataA>()); a->SetType(typeof(TestDynamicStreamDataA));
+    TestDynamicStreamDataBPtr b(LFNew<TestDynamicStreamDataB>()); b->SetType(typeof(TestDynamicStreamDataB));
+
+    a->mValueString = "This is a string";
+    a->mValueUInt = 300;
+    a->mValueInt = -1002;
+    b->mValueString = 9390;
+    b->mValueInt = 2002;
+
+    TestDynamicStreamDataType write;
+    write.Add(a);
+    write.Add(b);
+
+    String text;
+    JsonObjectStream ts(Stream::TEXT, &text, Stream::SM_PRETTY_WRITE);
+    ts.BeginObject("StreamData", "Native");
+    write.Serialize(ts);
+    ts.EndObject();
+    ts.Close();
+
+    TestDynamicStreamDataType read;
+    JsonObjectStream rs(Stream::TEXT, &text, Stream::SM_READ, JsonStream::RM_STREAMING);
+    TEST_CRITICAL(rs.BeginObject("StreamData", "Native"));
+    TEST(rs.GetCurrentSuper() == "Native");
+    read.Serialize(rs);
+    rs.EndObject();
+    rs.Close();
+
+    TEST_CRITICAL(write.mObjects.size() == read.mObjects.size());
+    for (SizeT i = 0; i < write.mObjects.size(); ++i)
+    {
+        TEST(write.mObjects[i].mType == read.mObjects[i].mType);
+    }
+}
+
+REGISTER_TEST(JsonStream_StreamingBenchmark, "Core.IO", TestFlags::TF_BENCHMARK)
+{
+    const SizeT NUM_ELEMENTS = 100000;
+    const SizeT ITERATIONS = 10;
+
+    DummyStruct data;
+    MakeDummyStruct(data);
+    data.mValueArray.resize(NUM_ELEMENTS);
+    data.mStructArray.resize(NUM_ELEMENTS);
+    for (SizeT i = 0; i < NUM_ELEMENTS; ++i)
+    {
+        data.mValueArray[i] = static_cast<Int32>(i * 7) - 1000;
+        data.mStructArray[i].mSimpleValue = static_cast<Int32>(i);
+    }
+
+    String text;
+    JsonStream ws(Stream::TEXT, &text, Stream::SM_PRETTY_WRITE);
+    ws << data;
+    ws.Close();
+
+    const JsonStream::ReadMode modes[] = { JsonStream::RM_DOCUMENT, JsonStream::RM_STREAMING };
+    const char* modeNames[] = { "Document", "Streaming" };
+    for (SizeT m = 0; m < LF_ARRAY_SIZE(modes); ++m)
+    {
+        Timer timer;
+        timer.Start();
+        for (SizeT i = 0; i < ITERATIONS; ++i)
+        {
+            DummyStruct output;
+            TEST_CRITICAL(ReadDummyStruct(text, modes[m], output));
+            TEST_CRITICAL(output == data);
+        }
+        timer.Stop();
+        gTestLog.Info(LogMessage(modeNames[m])
+            << ": Size=" << text.Size()
+            << ", Read=" << ToMilliseconds(TimeTypes::Seconds(timer.GetDelta())).mValue << "ms");
+    }
+}
+
 } // namespace lf
\ No newline at end of file
@@ -34,6 +34,7 @@
 #include "Core/Utility/Array.h"
 #include "Core/Utility/Log.h"
 #include "Core/Utility/StdMap.h"
+#include "Core/Utility/Time.h"
 
 #include <utility>
 #include <Windows.h>
@@ -923,6 +924,149 @@ REGISTER_TEST(DynamicPoolHeapTestMultithreaded, "Core.Memory")
 
 }
 
+struct ThreadCacheTestData
+{
+    SizeT         mSeed;
+    TVector<void*> mOut;
+    Thread        mThread;
+    Thread        mFreeThread;
+};
+
+static const SizeT THREAD_CACHE_TEST_SIZES[] = { 1, 8, 16, 24, 40, 64, 100, 200, 500, 1000, 1024, 1025, 4096 };
+static const SizeT THREAD_CACHE_TEST_ALIGNMENTS[] = { 1, 4, 8, 16, 32, 64 };
+
+static void ThreadCacheAllocate(void* param)
+{
+    ThreadCacheTestData* data = reinterpret_cast<ThreadCacheTestData*>(param);
+    const SizeT capacity = data->mOut.capacity();
+    for (SizeT i = 0; i < capacity; ++i)
+    {
+        const SizeT size = THREAD_CACHE_TEST_SIZES[(i + data->mSeed) % LF_ARRAY_SIZE(THREAD_CACHE_TEST_SIZES)];
+        const SizeT alignment = THREAD_CACHE_TEST_ALIGNMENTS[(i * 7 + data->mSeed) % LF_ARRAY_SIZE(THREAD_CACHE_TEST_ALIGNMENTS)];
+        void* pointer = LFAlloc(size, alignment);
+        if (pointer)
+        {
+            memset(pointer, static_cast<int>(data->mSeed), size);
+        }
+        data->mOut.push_back(pointer);
+
+        // Free some on the same thread to recycle the thread cache.
+        if ((i % 3) == 0 && i > 0)
+        {
+            LFFree(data->mOut[i - 1]);
+            data->mOut[i - 1] = nullptr;
+        }
+    }
+}
+
+static void ThreadCacheFree(void* param)
+{
+    ThreadCacheTestData* data = reinterpret_cast<ThreadCacheTestData*>(param);
+    for (void*& pointer : data->mOut)
+    {
+        if (pointer)
+        {
+            LFFree(pointer);
+            pointer = nullptr;
+        }
+    }
+}
+
+REGISTER_TEST(ThreadCacheTest, "Core.Memory")
+{
+    const SizeT NUM_THREADS = 4;
+    const SizeT NUM_ALLOCATIONS = 20000;
+    const SizeT bytesBefore = LFGetBytesAllocated();
+    const SizeT allocsBefore = LFGetAllocations();
+
+    // Small allocations must still honor the alignment.
+    for (SizeT size : THREAD_CACHE_TEST_SIZES)
+    {
+        for (SizeT alignment : THREAD_CACHE_TEST_ALIGNMENTS)
+        {
+            void* pointer = LFAlloc(size, alignment);
+            TEST_CRITICAL(pointer != nullptr);
+            TEST((reinterpret_cast<UIntPtrT>(pointer) % alignment) == 0);
+            memset(pointer, 0xCD, size);
+            LFFree(pointer);
+        }
+    }
+    TEST(LFGetBytesAllocated() == bytesBefore);
+
+    {
+        ThreadCacheTestData threads[NUM_THREADS];
+        for (SizeT i = 0; i < NUM_THREADS; ++i)
+        {
+            threads[i].mSeed = i + 1;
+            threads[i].mOut.reserve(NUM_ALLOCATIONS);
+        }
+        const SizeT bytesReserved = LFGetBytesAllocated();
+
+        for (ThreadCacheTestData& data : threads)
+        {
+            data.mThread.Fork(ThreadCacheAllocate, &data);
+        }
+        for (ThreadCacheTestData& data : threads)
+        {
+            data.mThread.Join();
+        }
+        TEST(LFGetBytesAllocated() > bytesReserved);
+
+        // Verify the memory didn't overlap and free everything on a thread that didn't allocate it.
+        for (SizeT i = 0; i < NUM_THREADS; ++i)
+        {
+            ThreadCacheTestData& data = threads[i];
+            for (SizeT k = 0; k < data.mOut.size(); ++k)
+            {
+                if (data.mOut[k])
+                {
+                    const SizeT size = THREAD_CACHE_TEST_SIZES[(k + data.mSeed) % LF_ARRAY_SIZE(THREAD_CACHE_TEST_SIZES)];
+                    const ByteT* bytes = reinterpret_cast<const ByteT*>(data.mOut[k]);
+                    TEST(bytes[0] == static_cast<ByteT>(data.mSeed) && bytes[size - 1] == static_cast<ByteT>(data.mSeed));
+                }
+            }
+        }
+        for (SizeT i = 0; i < NUM_THREADS; ++i)
+        {
+            threads[i].mFreeThread.Fork(ThreadCacheFree, &threads[(i + 1) % NUM_THREADS]);
+        }
+        for (ThreadCacheTestData& data : threads)
+        {
+            data.mFreeThread.Join();
+        }
+    }
+
+    // Statistics of the exited threads must still be part of the totals.
+    TEST(LFGetBytesAllocated() == bytesBefore);
+    TEST(LFGetAllocations() == allocsBefore);
+}
+
+REGISTER_TEST(ThreadCacheBenchmark, "Core.Memory", TestFlags::TF_BENCHMARK)
+{
+    const SizeT NUM_ALLOCATIONS = 1000000;
+    const SizeT BATCH_SIZE = 64;
+    void* pointers[BATCH_SIZE];
+
+    for (SizeT size : { 16, 64, 256, 1024, 4096 })
+    {
+        Timer timer;
+        timer.Start();
+        for (SizeT i = 0; i < NUM_ALLOCATIONS; i += BATCH_SIZE)
+        {
+            for (SizeT k = 0; k < BATCH_SIZE; ++k)
+            {
+                pointers[k] = LFAlloc(size, 8);
+            }
+            for (SizeT k = 0; k < BATCH_SIZE; ++k)
+            {
+                LFFree(pointers[k]);
+            }
+        }
+        timer.Stop();
+        gTestLog.Info(LogMessage("LFAlloc/LFFree size=") << size << " x" << NUM_ALLOCATIONS << " took " << ToMilliseconds(TimeTypes::Seconds(timer.GetDelta())).mValue << "ms");
+    }
+}
+
 struct ConvertibleAtomicPtr : public TAtomicWeakPointerConvertible<ConvertibleAtomicPtr>
 {
 
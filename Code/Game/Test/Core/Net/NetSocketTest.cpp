@@ -25,6 +25,9 @@
 #include "Core/Platform/Atomic.h"
 #include "Core/Platform/Thread.h"
 #include "Core/Platform/ThreadFence.h"
+#include "Core/Utility/Log.h"
+#include "Core/Utility/Time.h"
+#include "Core/Utility/Utility.h"
 
 #include "Game/Test/Core/Net/NetTestUtils.h"
 
@@ -259,4 +262,244 @@ REGISTER_TEST(UDPSocketIPV6SendReceive, "Core.Net")
     TEST(AtomicLoad(&context.mServerThreadStatus) == 1);
 }
 
+// Each test datagram is filled with its index and is 'index + 16' bytes so a receiver can tell them apart.
+static void FillBatchPacket(ByteT* bytes, SizeT index, SizeT& outSize)
+{
+    outSize = index + 16;
+    memset(bytes, static_cast<int>(index & 0xFF), outSize);
+}
+
+static bool IsBatchPacket(const UDPPacketBuffer& packet, SizeT index)
+{
+    if (packet.mSize != index + 16)
+    {
+        return false;
+    }
+    for (SizeT i = 0; i < packet.mSize; ++i)
+    {
+        if (packet.mBytes[i] != static_cast<ByteT>(index & 0xFF))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Receives 'indices' in order with batches of at most 'capacity' datagrams, checking the sender of each one.
+static void ReceiveBatchPackets(UDPSocket& socket, const TVector<SizeT>& indices, SizeT capacity, const IPEndPointAny& sender)
+{
+    const SizeT MAX_CAPACITY = 8;
+    ByteT bytes[MAX_CAPACITY][2048];
+    UDPPacketBuffer packets[MAX_CAPACITY];
+    TEST_CRITICAL(capacity <= MAX_CAPACITY);
+
+    SizeT received = 0;
+    while (received < indices.size())
+    {
+        SizeT count = capacity;
+        for (SizeT i = 0; i < count; ++i)
+        {
+            packets[i].mBytes = bytes[i];
+            packets[i].mSize = sizeof(bytes[i]);
+        }
+        TEST_CRITICAL(socket.ReceiveBatch(packets, count));
+        TEST_CRITICAL(count >= 1 && count <= capacity);
+        TEST_CRITICAL(received + count <= indices.size());
+        for (SizeT i = 0; i < count; ++i)
+        {
+            TEST(IsBatchPacket(packets[i], indices[received + i]));
+            TEST(packets[i].mEndPoint == sender);
+        }
+        received += count;
+    }
+}
+
+// Test SendBatch/ReceiveBatch deliver datagrams in order to each of their endpoints, across the platform batch limit
+// and for different receive capacities, and that a failed SendBatch reports how many datagrams it sent.
+REGISTER_TEST(UDPSocketBatchSendReceive, "Core.Net")
+{
+    NetTestInitializer netInit;
+    TEST_CRITICAL(netInit.mSuccess);
+
+    const UInt16 SERVER_A_PORT = TEST_PORT;
+    const UInt16 SERVER_B_PORT = TEST_PORT + 1;
+    const UInt16 CLIENT_PORT = TEST_PORT + 2;
+    // More than a single recvmmsg/sendmmsg call takes.
+    const SizeT NUM_DATAGRAMS = 70;
+
+    IPEndPointAny targetA;
+    IPEndPointAny targetB;
+    IPEndPointAny clientEndPoint;
+    TEST_CRITICAL(IPV4(targetA, TEST_IPV4_TARGET, SERVER_A_PORT));
+    TEST_CRITICAL(IPV4(targetB, TEST_IPV4_TARGET, SERVER_B_PORT));
+    TEST_CRITICAL(IPV4(clientEndPoint, TEST_IPV4_TARGET, CLIENT_PORT));
+
+    UDPSocket serverA;
+    UDPSocket serverB;
+    UDPSocket client;
+    TEST_CRITICAL(serverA.Create(NetProtocol::NET_PROTOCOL_IPV4_UDP));
+    TEST_CRITICAL(serverA.Bind(SERVER_A_PORT));
+    TEST_CRITICAL(serverB.Create(NetProtocol::NET_PROTOCOL_IPV4_UDP));
+    TEST_CRITICAL(serverB.Bind(SERVER_B_PORT));
+    TEST_CRITICAL(client.Create(NetProtocol::NET_PROTOCOL_IPV4_UDP));
+    TEST_CRITICAL(client.Bind(CLIENT_PORT));
+
+    // Alternate the endpoints within a single batch:
+    TVector<TVector<ByteT>> payloads;
+    TVector<UDPPacketBuffer> packets;
+    payloads.resize(NUM_DATAGRAMS);
+    packets.resize(NUM_DATAGRAMS);
+    TVector<SizeT> indicesA;
+    TVector<SizeT> indicesB;
+    for (SizeT i = 0; i < NUM_DATAGRAMS; ++i)
+    {
+        payloads[i].resize(2048);
+        packets[i].mBytes = payloads[i].data();
+        FillBatchPacket(packets[i].mBytes, i, packets[i].mSize);
+        packets[i].mEndPoint = (i % 2) == 0 ? targetA : targetB;
+        ((i % 2) == 0 ? indicesA : indicesB).push_back(i);
+    }
+
+    SizeT count = NUM_DATAGRAMS;
+    TEST(client.SendBatch(packets.data(), count));
+    TEST(count == NUM_DATAGRAMS);
+    ReceiveBatchPackets(serverA, indicesA, 8, clientEndPoint);
+    ReceiveBatchPackets(serverB, indicesB, 1, clientEndPoint);
+
+    // A datagram that can't be sent stops the batch, everything before it is still sent.
+    const SizeT INVALID_INDEX = 2;
+    for (SizeT i = 0; i < 5; ++i)
+    {
+        packets[i].mEndPoint = targetA;
+    }
+    packets[INVALID_INDEX].mBytes = nullptr;
+    count = 5;
+    TEST(!client.SendBatch(packets.data(), count));
+    TEST(count == INVALID_INDEX);
+
+    // The datagram after the partial batch must be the next one received, nothing past the invalid datagram was sent.
+    const SizeT SENTINEL_INDEX = 42;
+    packets[SENTINEL_INDEX].mEndPoint = targetA;
+    count = 1;
+    TEST(client.SendBatch(&packets[SENTINEL_INDEX], count));
+    TEST(count == 1);
+    ReceiveBatchPackets(serverA, { 0, 1, SENTINEL_INDEX }, 4, clientEndPoint);
+
+    TEST(client.Close());
+    TEST(serverB.Close());
+    TEST(serverA.Close());
+}
+
+static const SizeT BENCHMARK_BATCH_SIZE = 32;
+static const SizeT BENCHMARK_DATAGRAM_SIZE = 1200;
+
+// Compares per-datagram SendTo/ReceiveFrom against SendBatch/ReceiveBatch over loopback.
+REGISTER_TEST(UDPSocketBatchBenchmark, "Core.Net", TestFlags::TF_BENCHMARK)
+{
+    NetTestInitializer netInit;
+    TEST_CRITICAL(netInit.mSuccess);
+
+    const SizeT NUM_DATAGRAMS = 100000;
+    IPEndPointAny target;
+    TEST_CRITICAL(IPV4(target, TEST_IPV4_TARGET, TEST_PORT));
+
+    struct Context
+    {
+        UDPSocket mServer;
+        bool      mBatched;
+        volatile Atomic32 mReceived;
+    };
+
+    for (bool batched : { false, true })
+    {
+        Context context;
+        context.mBatched = batched;
+        AtomicStore(&context.mReceived, 0);
+        TEST_CRITICAL(context.mServer.Create(NetProtocol::NET_PROTOCOL_IPV4_UDP));
+        TEST_CRITICAL(context.mServer.Bind(TEST_PORT));
+        UDPSocket client;
+        TEST_CRITICAL(client.Create(NetProtocol::NET_PROTOCOL_IPV4_UDP));
+
+        Thread serverThread;
+        serverThread.Fork([](void* param)
+        {
+            Context* context = reinterpret_cast<Context*>(param);
+            ByteT bytes[BENCHMARK_BATCH_SIZE][2048];
+            UDPPacketBuffer packets[BENCHMARK_BATCH_SIZE];
+            while (true)
+            {
+                SizeT count = BENCHMARK_BATCH_SIZE;
+                for (SizeT i = 0; i < count; ++i)
+                {
+                    packets[i].mBytes = bytes[i];
+                    packets[i].mSize = sizeof(bytes[i]);
+                }
+
+                if (context->mBatched)
+                {
+                    if (!context->mServer.ReceiveBatch(packets, count))
+                    {
+                        break;
+                    }
+                }
+                else
+                {
+                    if (!context->mServer.ReceiveFrom(packets[0].mBytes, packets[0].mSize, packets[0].mEndPoint))
+                    {
+                        break;
+                    }
+                    count = 1;
+                }
+                AtomicAdd32(&context->mReceived, static_cast<Atomic32>(count));
+            }
+        }, &context);
+        SleepCallingThread(100);
+
+        ByteT payload[BENCHMARK_DATAGRAM_SIZE];
+        memset(payload, 0xCD, sizeof(payload));
+        UDPPacketBuffer packets[BENCHMARK_BATCH_SIZE];
+        for (UDPPacketBuffer& packet : packets)
+        {
+            packet.mBytes = payload;
+            packet.mSize = sizeof(payload);
+            packet.mEndPoint = target;
+        }
+
+        Timer timer;
+        timer.Start();
+        for (SizeT sent = 0; sent < NUM_DATAGRAMS;)
+        {
+            if (batched)
+            {
+                SizeT count = Min(BENCHMARK_BATCH_SIZE, NUM_DATAGRAMS - sent);
+                TEST_CRITICAL(client.SendBatch(packets, count));
+                sent += count;
+            }
+            else
+            {
+                SizeT size = sizeof(payload);
+                TEST_CRITICAL(client.SendTo(payload, size, target));
+                ++sent;
+            }
+        }
+        timer.Stop();
+
+        // Loopback may still drop under load, we only wait for the receiver to drain what it has.
+        SleepCallingThread(250);
+        TEST(context.mServer.Shutdown());
+        serverThread.Join();
+        client.Close();
+
+#if defined(LF_OS_WINDOWS)
+        // WinSock has no recvmmsg/sendmmsg, on Windows both runs measure the per-datagram path.
+        const char* BATCH_NAME = "SendBatch/ReceiveBatch (per-datagram fallback)";
+#else
+        const char* BATCH_NAME = "SendBatch/ReceiveBatch";
+#endif
+        gTestLog.Info(LogMessage(batched ? BATCH_NAME : "SendTo/ReceiveFrom") 
+            << " x" << NUM_DATAGRAMS << " sent in " << ToMilliseconds(TimeTypes::Seconds(timer.GetDelta())).mValue << "ms"
+            << ", received " << static_cast<Int32>(AtomicLoad(&context.mReceived)));
+    }
+}
+
 } // namespace lf
\ No newline at end of file
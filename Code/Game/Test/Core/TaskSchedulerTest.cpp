@@ -0,0 +1,255 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/Test/Test.h"
+#include "Core/Common/Assert.h"
+#include "Core/Concurrent/ParallelFor.h"
+#include "Core/Concurrent/TaskGraph.h"
+#include "Core/Concurrent/TaskScheduler.h"
+#include "Core/Platform/Atomic.h"
+#include "Core/Platform/Thread.h"
+#include "Core/Utility/Time.h"
+
+namespace lf {
+
+struct TaskSchedulerTestData
+{
+    TaskScheduler*    mScheduler;
+    volatile Atomic32 mExecuted;
+};
+
+// Each root task fans out child tasks from the worker thread so they land on the worker's local deque.
+static void SpawnChildren(TaskSchedulerTestData& data, SizeT numChildren)
+{
+    for (SizeT i = 0; i < numChildren; ++i)
+    {
+        data.mScheduler->RunTask(TaskCallback::Make([&data](void*) { AtomicIncrement32(&data.mExecuted); }));
+    }
+    AtomicIncrement32(&data.mExecuted);
+}
+
+REGISTER_TEST(TaskScheduler_WorkStealingTest, "Core.Concurrent")
+{
+    const SizeT NUM_ROOTS = 64;
+    const SizeT NUM_CHILDREN = 32;
+    const Atomic32 EXPECTED = static_cast<Atomic32>(NUM_ROOTS + NUM_ROOTS * NUM_CHILDREN);
+
+    TaskTypes::TaskSchedulerOptions options;
+    options.mNumWorkerThreads = 4;
+    options.mMode = TaskTypes::TSM_WORK_STEALING;
+    // Small deques so we exercise the overflow into the dispatcher queue as well.
+    options.mLocalQueueSize = 16;
+
+    TaskSchedulerTestData data;
+    data.mScheduler = nullptr;
+    data.mExecuted = 0;
+
+    TaskScheduler scheduler;
+    scheduler.Initialize(options, true);
+    TEST_CRITICAL(scheduler.IsRunning());
+    TEST(scheduler.GetMode() == TaskTypes::TSM_WORK_STEALING);
+    TEST(scheduler.GetNumWorkers() == 4);
+    TEST(Invalid(scheduler.GetCurrentWorkerIndex()));
+    data.mScheduler = &scheduler;
+
+    for (SizeT i = 0; i < NUM_ROOTS; ++i)
+    {
+        scheduler.RunTask(TaskCallback::Make([&data, NUM_CHILDREN](void*) { SpawnChildren(data, NUM_CHILDREN); }));
+    }
+
+    Timer timer;
+    timer.Start();
+    while (AtomicLoad(&data.mExecuted) != EXPECTED && timer.PeekDelta() < 10.0)
+    {
+        SleepCallingThread(1);
+    }
+    TEST(AtomicLoad(&data.mExecuted) == EXPECTED);
+    scheduler.Shutdown();
+    // Shutdown runs anything that was left over.
+    TEST(AtomicLoad(&data.mExecuted) == EXPECTED);
+}
+
+REGISTER_TEST(TaskScheduler_WorkStealingSyncTest, "Core.Concurrent")
+{
+    TaskTypes::TaskSchedulerOptions options;
+    options.mMode = TaskTypes::TSM_WORK_STEALING;
+
+    TaskSchedulerTestData data;
+    data.mScheduler = nullptr;
+    data.mExecuted = 0;
+
+    TaskScheduler scheduler;
+    scheduler.Initialize(options, false);
+    TEST_CRITICAL(scheduler.IsRunning());
+    data.mScheduler = &scheduler;
+
+    scheduler.RunTask(TaskCallback::Make([&data](void*) { SpawnChildren(data, 8); }));
+    scheduler.UpdateSync(1.0);
+    TEST(AtomicLoad(&data.mExecuted) == 9);
+
+    // ** Tasks know which worker of the scheduler runs them
+    SizeT workerIndex = INVALID;
+    scheduler.RunTask(TaskCallback::Make([&scheduler, &workerIndex](void*) { workerIndex = scheduler.GetCurrentWorkerIndex(); }));
+    scheduler.UpdateSync(1.0);
+    TEST(workerIndex == 0);
+    TEST(Invalid(scheduler.GetCurrentWorkerIndex()));
+    scheduler.Shutdown();
+}
+
+REGISTER_TEST(TaskGraph_DependencyTest, "Core.Concurrent")
+{
+    TaskScheduler scheduler;
+    scheduler.Initialize(true);
+    TEST_CRITICAL(scheduler.IsRunning());
+
+    // Diamond: a -> (b, c) -> d
+    volatile Atomic32 sequence = 0;
+    Atomic32 order[4] = { 0, 0, 0, 0 };
+    auto record = [&sequence, &order](SizeT index) { order[index] = AtomicIncrement32(&sequence); };
+
+    TaskGraph graph;
+    TaskGraph::NodeId a = graph.AddNode(TaskGraph::NodeCallback::Make([&record]() { record(0); }));
+    TaskGraph::NodeId b = graph.AddNode(TaskGraph::NodeCallback::Make([&record]() { record(1); }));
+    TaskGraph::NodeId c = graph.AddNode(TaskGraph::NodeCallback::Make([&record]() { record(2); }));
+    TaskGraph::NodeId d = graph.AddNode(TaskGraph::NodeCallback::Make([&record]() { record(3); }));
+    graph.AddEdge(a, b);
+    graph.AddEdge(a, c);
+    graph.AddEdge(b, d);
+    graph.AddEdge(c, d);
+    TEST_CRITICAL(graph.Build());
+
+    // The graph is built once and can be submitted every frame.
+    for (SizeT frame = 0; frame < 16; ++frame)
+    {
+        AtomicStore(&sequence, 0);
+        graph.Submit(scheduler);
+        graph.Wait();
+        TEST(graph.IsComplete());
+        TEST(AtomicLoad(&sequence) == 4);
+        TEST(order[a] < order[b] && order[a] < order[c]);
+        TEST(order[b] < order[d] && order[c] < order[d]);
+    }
+
+    scheduler.Shutdown();
+}
+
+static const char* gTaskGraphBugMessage = nullptr;
+
+REGISTER_TEST(TaskGraph_CycleTest, "Core.Concurrent")
+{
+    BugCallback previous = gReportBugCallback;
+    gReportBugCallback = [](const char* msg, const StackTrace&, UInt32, UInt32) { gTaskGraphBugMessage = msg; };
+    gTaskGraphBugMessage = nullptr;
+
+    TaskGraph graph;
+    TaskGraph::NodeId a = graph.AddNode(TaskGraph::NodeCallback::Make([]() {}));
+    TaskGraph::NodeId b = graph.AddNode(TaskGraph::NodeCallback::Make([]() {}));
+    graph.AddEdge(a, b);
+    graph.AddEdge(b, a);
+    TEST(!graph.Build());
+    TEST(!graph.IsBuilt());
+    TEST(gTaskGraphBugMessage != nullptr);
+    gReportBugCallback = previous;
+}
+
+REGISTER_TEST(ParallelFor_Test, "Core.Concurrent")
+{
+    const SizeT NUM_ITEMS = 100000;
+    TVector<UInt32> items;
+    items.resize(NUM_ITEMS, 0);
+
+    TaskTypes::TaskSchedulerOptions options;
+    options.mMode = TaskTypes::TSM_WORK_STEALING;
+    TaskScheduler scheduler;
+    scheduler.Initialize(options, true);
+    TEST_CRITICAL(scheduler.IsRunning());
+
+    // Every item is visited exactly once.
+    ParallelFor(scheduler, 0, items.size(), 512, [&items](SizeT begin, SizeT end)
+    {
+        for (SizeT i = begin; i < end; ++i)
+        {
+            items[i] += static_cast<UInt32>(i) + 1;
+        }
+    });
+    bool visitedOnce = true;
+    for (SizeT i = 0; i < items.size(); ++i)
+    {
+        visitedOnce = visitedOnce && items[i] == static_cast<UInt32>(i) + 1;
+    }
+    TEST(visitedOnce);
+
+    // Automatic grain size and a result that does not depend on the chunk schedule.
+    UInt64 sum = ParallelReduce(scheduler, 0, items.size(), 0, UInt64(0),
+        [&items](SizeT begin, SizeT end)
+        {
+            UInt64 partial = 0;
+            for (SizeT i = begin; i < end; ++i)
+            {
+                partial += items[i];
+            }
+            return partial;
+        },
+        [](UInt64 a, UInt64 b) { return a + b; });
+    TEST(sum == (static_cast<UInt64>(NUM_ITEMS) * (NUM_ITEMS + 1)) / 2);
+
+    // Empty ranges don't invoke the callback.
+    bool invoked = false;
+    ParallelFor(scheduler, 10, 10, 1, [&invoked](SizeT, SizeT) { invoked = true; });
+    TEST(!invoked);
+
+    scheduler.Shutdown();
+}
+
+REGISTER_TEST(ParallelFor_SyncTest, "Core.Concurrent")
+{
+    // A synchronous scheduler never runs the tasks by itself, the caller has to execute them all.
+    TaskScheduler scheduler;
+    scheduler.Initialize(false);
+    TEST_CRITICAL(scheduler.IsRunning());
+
+    volatile Atomic32 count = 0;
+    ParallelFor(scheduler, 0, 1000, 10, [&count](SizeT begin, SizeT end)
+    {
+        AtomicAdd32(&count, static_cast<Atomic32>(end - begin));
+    });
+    TEST(AtomicLoad(&count) == 1000);
+
+    // More chunks than the dispatcher queue can hold.
+    const SizeT numItems = TaskTypes::TaskSchedulerOptions().mDispatcherSize * 4;
+    AtomicStore(&count, 0);
+    ParallelFor(scheduler, 0, numItems, 1, [&count](SizeT begin, SizeT end)
+    {
+        AtomicAdd32(&count, static_cast<Atomic32>(end - begin));
+    });
+    TEST(AtomicLoad(&count) == static_cast<Atomic32>(numItems));
+
+    // Tasks run once the queue is full execute inline instead of waiting on a slot.
+    AtomicStore(&count, 0);
+    for (SizeT i = 0; i < numItems; ++i)
+    {
+        scheduler.RunTask(TaskCallback::Make([&count](void*) { AtomicIncrement32(&count); }));
+    }
+    scheduler.UpdateSync(60.0);
+    TEST(AtomicLoad(&count) == static_cast<Atomic32>(numItems));
+    scheduler.Shutdown();
+}
+
+} // namespace lf
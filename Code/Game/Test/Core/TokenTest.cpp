@@ -0,0 +1,306 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/Test/Test.h"
+#include "Core/String/String.h"
+#include "Core/String/StringCommon.h"
+#include "Core/String/Token.h"
+#include "Core/String/TokenTable.h"
+#include "Core/Platform/Atomic.h"
+#include "Core/Platform/Thread.h"
+#include "Core/Utility/Log.h"
+#include "Core/Utility/Time.h"
+
+#include <utility>
+
+namespace lf {
+
+REGISTER_TEST(Token_InterningTest, "Core.String")
+{
+    const char* TEXT = "Token_InterningTest_Text";
+
+    Token a(TEXT);
+    Token b = Token(String(TEXT));
+    TEST(a == b);
+    TEST(a.CStr() == b.CStr());
+    TEST(a.CStr() != TEXT);
+    TEST(!a.IsImmortal());
+    TEST(gTokenTable->GetReferenceCount(a) == 2);
+
+    // ** Acquire never inserts
+    Token missing("Token_InterningTest_Missing", ACQUIRE);
+    TEST(missing.Empty());
+    Token acquired(TEXT, ACQUIRE);
+    TEST(acquired == a);
+    TEST(gTokenTable->GetReferenceCount(a) == 3);
+
+    {
+        Token copy(a);
+        Token moved(std::move(copy));
+        TEST(moved == a);
+        TEST(gTokenTable->GetReferenceCount(a) == 4);
+    }
+    TEST(gTokenTable->GetReferenceCount(a) == 3);
+
+    // ** Immortal tokens share the same string but are never reference counted.
+    Token immortal(TEXT, IMMORTAL);
+    TEST(immortal.IsImmortal());
+    TEST(immortal == a);
+    {
+        Token copy(immortal);
+        Token assigned;
+        assigned = immortal;
+        TEST(copy.IsImmortal() && assigned.IsImmortal());
+        TEST(gTokenTable->GetReferenceCount(a) == 3);
+    }
+    TEST(gTokenTable->GetReferenceCount(immortal) == 0);
+
+    // ** Copy on write tokens reference the original string and are immortal
+    static const char* COW_TEXT = "Token_InterningTest_CopyOnWrite";
+    Token cow(COW_TEXT, COPY_ON_WRITE);
+    TEST(cow.IsImmortal());
+    TEST(cow.CStr() == COW_TEXT);
+    Token cowLookup(COW_TEXT);
+    TEST(cowLookup == cow);
+    TEST(cowLookup.IsImmortal());
+
+    // ** Immortal tokens pin the string, acquire still finds it without mortal references.
+    a.Clear();
+    b.Clear();
+    acquired.Clear();
+    TEST(a.Empty());
+    gTokenTable->Reclaim();
+    gTokenTable->Reclaim();
+    Token pinned(TEXT, ACQUIRE);
+    TEST(pinned == immortal);
+    TEST(gTokenTable->GetReferenceCount(pinned) == 1);
+}
+
+REGISTER_TEST(Token_ReclaimTest, "Core.String")
+{
+    const char* TEXT = "Token_ReclaimTest_Text";
+
+    Token a(TEXT);
+    TEST(gTokenTable->GetReferenceCount(a) == 1);
+    a.Clear();
+
+    // ** Unreferenced strings are treated as missing by acquire, even before they are reclaimed.
+    Token acquired(TEXT, ACQUIRE);
+    TEST(acquired.Empty());
+
+    // ** A normal look up revives an unreferenced string that has not been reclaimed.
+    Token revived(TEXT);
+    TEST(gTokenTable->GetReferenceCount(revived) == 1);
+
+    // ** Referenced strings are never reclaimed.
+    const char* address = revived.CStr();
+    gTokenTable->Reclaim();
+    gTokenTable->Reclaim();
+    Token again(TEXT, ACQUIRE);
+    TEST(again.CStr() == address);
+    TEST(gTokenTable->GetReferenceCount(again) == 2);
+
+    // ** Once unreferenced the first pass unlinks the string and a later pass frees it.
+    revived.Clear();
+    again.Clear();
+    gTokenTable->Reclaim();
+    Token missing(TEXT, ACQUIRE);
+    TEST(missing.Empty());
+    gTokenTable->Reclaim();
+
+    Token inserted(TEXT);
+    TEST(!inserted.Empty());
+    TEST(gTokenTable->GetReferenceCount(inserted) == 1);
+}
+
+struct TokenThreadState
+{
+    const TVector<String>* mStrings;
+    TVector<const char*>   mResults;
+    Thread                 mThread;
+    SizeT                  mIterations;
+    SizeT                  mOffset;
+    bool                   mImmortal;
+    volatile Atomic32*     mExecute;
+    const Token*           mShared;
+};
+
+static void TokenInternWorker(void* data)
+{
+    TokenThreadState* self = reinterpret_cast<TokenThreadState*>(data);
+    while (AtomicLoad(self->mExecute) == 0)
+    {
+
+    }
+
+    // ** Insert the strings in a thread specific order so threads race on different buckets.
+    const SizeT count = self->mStrings->size();
+    const SizeT offset = self->mOffset % count;
+    self->mResults.resize(count);
+    TVector<Token> tokens;
+    tokens.resize(count);
+    for (SizeT i = 0; i < count; ++i)
+    {
+        const SizeT index = (i + offset) % count;
+        tokens[index] = self->mImmortal ? Token((*self->mStrings)[index], IMMORTAL) : Token((*self->mStrings)[index]);
+        self->mResults[index] = tokens[index].CStr();
+    }
+}
+
+REGISTER_TEST(Token_ConcurrentInterningTest, "Core.String", TestFlags::TF_STRESS)
+{
+    const SizeT NUM_STRINGS = 4000;
+    const SizeT NUM_THREADS = 8;
+
+    TVector<String> strings;
+    for (SizeT i = 0; i < NUM_STRINGS; ++i)
+    {
+        strings.push_back(String("Token_ConcurrentInterningTest_") + ToString(i));
+    }
+
+    volatile Atomic32 execute = 0;
+    TVector<TokenThreadState> threads;
+    threads.resize(NUM_THREADS);
+    for (SizeT i = 0; i < NUM_THREADS; ++i)
+    {
+        threads[i].mStrings = &strings;
+        threads[i].mIterations = 0;
+        threads[i].mOffset = i * 997;
+        threads[i].mImmortal = (i % 2) == 1;
+        threads[i].mExecute = &execute;
+        threads[i].mShared = nullptr;
+        threads[i].mThread.Fork(TokenInternWorker, &threads[i]);
+    }
+    AtomicStore(&execute, 1);
+    for (TokenThreadState& thread : threads)
+    {
+        thread.mThread.Join();
+    }
+
+    // ** Every thread must have been given the same string for each token.
+    for (SizeT i = 0; i < NUM_STRINGS; ++i)
+    {
+        Token token(strings[i], ACQUIRE);
+        TEST_CRITICAL(!token.Empty());
+        TEST(gTokenTable->GetReferenceCount(token) == 1);
+        for (const TokenThreadState& thread : threads)
+        {
+            TEST(thread.mResults[i] == token.CStr());
+        }
+    }
+}
+
+static void TokenCopyWorker(void* data)
+{
+    TokenThreadState* self = reinterpret_cast<TokenThreadState*>(data);
+    while (AtomicLoad(self->mExecute) == 0)
+    {
+
+    }
+
+    for (SizeT i = 0; i < self->mIterations; ++i)
+    {
+        Token copy(*self->mShared);
+        Token other(copy);
+        if (other.Empty())
+        {
+            break;
+        }
+    }
+}
+
+static void TokenLookUpWorker(void* data)
+{
+    TokenThreadState* self = reinterpret_cast<TokenThreadState*>(data);
+    while (AtomicLoad(self->mExecute) == 0)
+    {
+
+    }
+
+    const SizeT count = self->mStrings->size();
+    for (SizeT i = 0; i < self->mIterations; ++i)
+    {
+        const String& string = (*self->mStrings)[i % count];
+        Token token = self->mImmortal ? Token(string, IMMORTAL) : Token(string);
+        if (token.Empty())
+        {
+            break;
+        }
+    }
+}
+
+static Float64 RunTokenContention(ThreadCallback callback, SizeT numThreads, SizeT iterations, bool immortal, const TVector<String>& strings)
+{
+    const Token shared = immortal ? Token(strings[0], IMMORTAL) : Token(strings[0]);
+
+    volatile Atomic32 execute = 0;
+    TVector<TokenThreadState> threads;
+    threads.resize(numThreads);
+    for (TokenThreadState& thread : threads)
+    {
+        thread.mStrings = &strings;
+        thread.mIterations = iterations;
+        thread.mOffset = 0;
+        thread.mImmortal = immortal;
+        thread.mExecute = &execute;
+        thread.mShared = &shared;
+        thread.mThread.Fork(callback, &thread);
+    }
+
+    Timer timer;
+    timer.Start();
+    AtomicStore(&execute, 1);
+    for (TokenThreadState& thread : threads)
+    {
+        thread.mThread.Join();
+    }
+    timer.Stop();
+    return timer.GetDelta();
+}
+
+REGISTER_TEST(Token_ContentionBenchmark, "Core.String", TestFlags::TF_BENCHMARK)
+{
+    const SizeT ITERATIONS = 1000000;
+    const SizeT THREAD_COUNTS[] = { 1, 2, 4, 8 };
+
+    TVector<String> strings;
+    for (SizeT i = 0; i < 256; ++i)
+    {
+        strings.push_back(String("Token_ContentionBenchmark_") + ToString(i));
+    }
+
+    for (SizeT immortal = 0; immortal < 2; ++immortal)
+    {
+        for (SizeT numThreads : THREAD_COUNTS)
+        {
+            const Float64 copySeconds = RunTokenContention(TokenCopyWorker, numThreads, ITERATIONS, immortal != 0, strings);
+            const Float64 lookUpSeconds = RunTokenContention(TokenLookUpWorker, numThreads, ITERATIONS, immortal != 0, strings);
+
+            gTestLog.Info(LogMessage("Token ") << (immortal != 0 ? "immortal" : "mortal")
+                << " threads=" << numThreads
+                << " copy=" << ToMilliseconds(TimeTypes::Seconds(copySeconds)).mValue << "ms"
+                << " (" << static_cast<SizeT>(static_cast<Float64>(numThreads * ITERATIONS * 2) / copySeconds) << " copies/s)"
+                << " lookup=" << ToMilliseconds(TimeTypes::Seconds(lookUpSeconds)).mValue << "ms"
+                << " (" << static_cast<SizeT>(static_cast<Float64>(numThreads * ITERATIONS) / lookUpSeconds) << " lookups/s)");
+        }
+    }
+}
+
+} // namespace lf
@@ -0,0 +1,176 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/Test/Test.h"
+#include "Core/Utility/Crc32.h"
+#include "Core/Utility/FNVHash.h"
+#include "Core/Utility/WyHash.h"
+#include "Core/Utility/Log.h"
+#include "Core/Utility/Time.h"
+#include "Core/String/String.h"
+#include "Core/String/StringCommon.h"
+
+namespace lf {
+
+static void FillTestBytes(ByteT* bytes, SizeT numBytes)
+{
+    UInt32 state = 0x12345678;
+    for (SizeT i = 0; i < numBytes; ++i)
+    {
+        state = state * 1664525 + 1013904223;
+        bytes[i] = static_cast<ByteT>(state >> 24);
+    }
+}
+
+REGISTER_TEST(Crc32Test, "Core.Utility")
+{
+    const char* CHECK = "123456789";
+    const ByteT* check = reinterpret_cast<const ByteT*>(CHECK);
+    TEST(Crc32Bytewise(check, 9) == 0xCBF43926);
+    TEST(Crc32Slice8(check, 9) == 0xCBF43926);
+    TEST(Crc32Clmul(check, 9) == 0xCBF43926);
+    TEST(Crc32(check, 9) == 0xCBF43926);
+
+    TEST(Crc32(nullptr, 0) == INVALID32);
+    TEST(Crc32(check, 0) == INVALID32);
+    TEST(Crc32Slice8(check, 0) == INVALID32);
+    TEST(Crc32Clmul(check, 0) == INVALID32);
+
+    gTestLog.Info(LogMessage("Crc32HasClmul=") << (Crc32HasClmul() ? "true" : "false"));
+
+    // Every kernel must match the reference for unaligned data and lengths around the fold sizes.
+    ByteT bytes[2048 + 16];
+    FillTestBytes(bytes, sizeof(bytes));
+    for (SizeT offset = 0; offset < 16; ++offset)
+    {
+        for (SizeT length = 1; length <= 2048; length += (length < 160 ? 1 : 61))
+        {
+            const UInt32 expected = Crc32Bytewise(bytes + offset, length);
+            TEST(Crc32Slice8(bytes + offset, length) == expected);
+            TEST(Crc32Clmul(bytes + offset, length) == expected);
+            TEST(Crc32(bytes + offset, length) == expected);
+
+            // Split anywhere, the running crc must match the single buffer crc.
+            const SizeT split = (length * 7) / 11;
+            TEST(Crc32Update(Crc32Update(0, bytes + offset, split), bytes + offset + split, length - split) == expected);
+        }
+    }
+    TEST(Crc32Update(0xCBF43926, check, 0) == 0xCBF43926);
+}
+
+REGISTER_TEST(WyHashTest, "Core.Utility")
+{
+    // Reference test vectors
+    TEST(WyHash::Hash(reinterpret_cast<const ByteT*>(""), 0, 0) == 0x93228A4DE0EEC5A2ULL);
+    TEST(WyHash::Hash(reinterpret_cast<const ByteT*>("a"), 1, 1) == 0xC5BAC3DB178713C4ULL);
+    TEST(WyHash::Hash(reinterpret_cast<const ByteT*>("abc"), 3, 2) == 0xA97F2F7B1D9B3314ULL);
+
+    const String path = "engine//test/assets/textures/character_diffuse.png";
+    TEST(WyHash::Hash(path.CStr(), path.Size()) == WyHash::Hash(reinterpret_cast<const ByteT*>(path.CStr()), path.Size()));
+    TEST(WyHash::Hash(path.CStr(), path.Size()) != WyHash::Hash(path.CStr(), path.Size(), 1));
+    TEST(WyHash::Hash(path.CStr(), path.Size()) != WyHash::Hash(path.CStr(), path.Size() - 1));
+
+    // Each length branch (0-3, 4-16, 17-48, 49+) should be sensitive to every byte.
+    ByteT bytes[128];
+    FillTestBytes(bytes, sizeof(bytes));
+    for (SizeT length = 1; length <= sizeof(bytes); ++length)
+    {
+        const WyHash::HashT hash = WyHash::Hash(bytes, length);
+        for (SizeT i = 0; i < length; ++i)
+        {
+            bytes[i] ^= 0x01;
+            TEST(WyHash::Hash(bytes, length) != hash);
+            bytes[i] ^= 0x01;
+        }
+    }
+}
+
+REGISTER_TEST(Crc32Benchmark, "Core.Utility", TestFlags::TF_BENCHMARK)
+{
+    const SizeT NUM_PACKETS = 100000;
+    const SizeT PACKET_SIZE = 1200;
+    ByteT bytes[PACKET_SIZE];
+    FillTestBytes(bytes, sizeof(bytes));
+
+    struct Kernel
+    {
+        const char* mName;
+        UInt32(*mFunc)(const ByteT*, SizeT);
+    };
+    const Kernel kernels[] = 
+    {
+        { "Crc32Bytewise", [](const ByteT* data, SizeT length) { return Crc32Bytewise(data, length); } },
+        { "Crc32Slice8", Crc32Slice8 },
+        { "Crc32Clmul", Crc32Clmul }
+    };
+
+    const UInt32 expected = Crc32Bytewise(bytes, sizeof(bytes));
+    for (const Kernel& kernel : kernels)
+    {
+        UInt32 result = 0;
+        Timer timer;
+        timer.Start();
+        for (SizeT i = 0; i < NUM_PACKETS; ++i)
+        {
+            result = kernel.mFunc(bytes, sizeof(bytes));
+        }
+        timer.Stop();
+        TEST(result == expected);
+        gTestLog.Info(LogMessage(kernel.mName) << " x" << NUM_PACKETS << " (" << PACKET_SIZE << " bytes) in " 
+            << ToMilliseconds(TimeTypes::Seconds(timer.GetDelta())).mValue << "ms");
+    }
+}
+
+REGISTER_TEST(HashBenchmark, "Core.Utility", TestFlags::TF_BENCHMARK)
+{
+    const SizeT NUM_ITERATIONS = 100;
+    TVector<String> paths;
+    for (SizeT i = 0; i < 10000; ++i)
+    {
+        paths.push_back("engine//test/assets/scope_" + ToString(i % 37) + "/asset_" + ToString(i) + ".png");
+    }
+
+    UInt64 fnvResult = 0;
+    Timer timer;
+    timer.Start();
+    for (SizeT k = 0; k < NUM_ITERATIONS; ++k)
+    {
+        for (const String& path : paths)
+        {
+            fnvResult ^= FNV::Hash(path.CStr(), path.Size());
+        }
+    }
+    timer.Stop();
+    gTestLog.Info(LogMessage("FNV::Hash x") << (NUM_ITERATIONS * paths.size()) << " in " << ToMilliseconds(TimeTypes::Seconds(timer.GetDelta())).mValue << "ms, result=" << fnvResult);
+
+    UInt64 wyResult = 0;
+    timer.Start();
+    for (SizeT k = 0; k < NUM_ITERATIONS; ++k)
+    {
+        for (const String& path : paths)
+        {
+            wyResult ^= WyHash::Hash(path.CStr(), path.Size());
+        }
+    }
+    timer.Stop();
+    gTestLog.Info(LogMessage("WyHash::Hash x") << (NUM_ITERATIONS * paths.size()) << " in " << ToMilliseconds(TimeTypes::Seconds(timer.GetDelta())).mValue << "ms, result=" << wyResult);
+}
+
+} // namespace lf
@@ -39,6 +39,7 @@
 #include "Runtime/Asset/AssetOp.h"
 #include "Runtime/Asset/AssetTypeInfo.h"
 #include "Runtime/Asset/AssetReferenceTypes.h"
+#include "Runtime/Asset/Controllers/AssetCacheController.h"
 #include "Game/Test/StressDataAsset.h"
 #include "Game/Test/TestUtils.h"
 
@@ -931,6 +932,158 @@ REGISTER_TEST(AssetMgr_LoadStress, "Runtime.Asset", TestFlags::TF_STRESS)
     mgr.Shutdown();
 }
 
+REGISTER_TEST(AssetMgr_LoadBatchStress, "Runtime.Asset", TestFlags::TF_STRESS)
+{
+    const SizeT COUNT = 2000;
+    Int32 seed = 0x3a1c55d7;
+    TMap<Token, TAtomicStrongPointer<StressDataAsset>> assets;
+
+    for (SizeT i = 0; i < COUNT; ++i)
+    {
+        ByteT bytes[16];
+        for (SizeT k = 0; k < LF_ARRAY_SIZE(bytes); ++k)
+        {
+            bytes[k] = static_cast<ByteT>(Random::Mod(seed, 0xFF));
+        }
+
+        Token name(String("engine//BatchStressAsset_") + ToString(bytes, sizeof(bytes)) + ".lob");
+        auto& asset = assets[name];
+        asset = MakeConvertibleAtomicPtr<StressDataAsset>();
+        asset->SetType(typeof(StressDataAsset));
+        asset->Generate(seed);
+    }
+
+    AssetMgr mgr;
+    DefaultInitialize(mgr);
+    TVector<AssetOpAtomicPtr> ops;
+    ops.reserve(assets.size());
+    for (const auto& pair : assets)
+    {
+        ops.push_back(mgr.Create(AssetPath(pair.first), pair.second, nullptr));
+        TEST(ops.back()->IsRunning());
+    }
+
+    SizeT completed = 0;
+    while (completed != ops.size())
+    {
+        completed = 0;
+        for (const auto& op : ops)
+        {
+            if (op->IsComplete())
+            {
+                TEST(op->IsSuccess());
+                ++completed;
+            }
+        }
+        mgr.Update();
+    }
+
+    TVector<AssetTypeInfoCPtr> types;
+    for (const auto& pair : assets)
+    {
+        AssetTypeInfoCPtr type = mgr.FindType(AssetPath(pair.first));
+        TEST_CRITICAL(type);
+        types.push_back(type);
+    }
+
+    Timer t;
+    t.Start();
+    AssetOpAtomicPtr batch = mgr.LoadBatch(types, AssetLoadFlags::LF_IMMEDIATE_PROPERTIES | AssetLoadFlags::LF_RECURSIVE_PROPERTIES | AssetLoadFlags::LF_ASYNC);
+    while (!batch->IsComplete())
+    {
+        mgr.Update();
+    }
+    t.Stop();
+    TEST(batch->IsSuccess());
+    gTestLog.Info(LogMessage("Batch loaded all types in ") << t.GetDelta() << " seconds.");
+
+    for (const AssetTypeInfoCPtr& type : types)
+    {
+        TEST(type->GetLoadState() == AssetLoadState::ALS_LOADED);
+    }
+
+    // ** Everything is loaded, so the batch has nothing to do.
+    batch = mgr.LoadBatch(types, AssetLoadFlags::LF_IMMEDIATE_PROPERTIES | AssetLoadFlags::LF_RECURSIVE_PROPERTIES | AssetLoadFlags::LF_ASYNC);
+    TEST(batch->IsSuccess());
+
+    ops.clear();
+    for (const AssetTypeInfoCPtr& type : types)
+    {
+        ops.push_back(mgr.Delete(type));
+        TEST(ops.back()->IsRunning());
+        mgr.Update();
+    }
+    types.clear();
+
+    completed = 0;
+    while (completed != ops.size())
+    {
+        completed = 0;
+        for (const auto& op : ops)
+        {
+            if (op->IsComplete())
+            {
+                TEST(op->IsSuccess());
+                ++completed;
+            }
+        }
+        mgr.Update();
+    }
+
+    mgr.Shutdown();
+}
+
+REGISTER_TEST(AssetCacheController_CoalesceBatchReads, "Runtime.Asset")
+{
+    const SizeT GAP = AssetCacheController::BATCH_READ_MAX_GAP;
+    const SizeT MAX_SIZE = AssetCacheController::BATCH_READ_MAX_SIZE;
+    const CacheBlock* blockA = reinterpret_cast<const CacheBlock*>(0x1000);
+    const CacheBlock* blockB = reinterpret_cast<const CacheBlock*>(0x2000);
+
+    auto makeRead = [](const CacheBlock* block, UInt32 blobID, SizeT location, SizeT size)
+    {
+        AssetCacheBatchRead read;
+        read.mBlock = block;
+        read.mBlobID = blobID;
+        read.mLocation = location;
+        read.mSize = size;
+        read.mRequest = 0;
+        return read;
+    };
+
+    TVector<AssetCacheBatchRead> reads;
+    reads.push_back(makeRead(blockA, 0, 0, 100));                   // [0] begins range 0
+    reads.push_back(makeRead(blockA, 0, 100, 50));                  // [1] adjacent
+    reads.push_back(makeRead(blockA, 0, 150 + GAP, 10));            // [2] exactly max gap
+    reads.push_back(makeRead(blockA, 0, 160 + GAP, 5));             // [3] adjacent
+    reads.push_back(makeRead(blockA, 0, 165 + 2 * GAP + 1, 10));    // [4] gap too large, begins range 1
+    reads.push_back(makeRead(blockA, 1, 165 + 2 * GAP + 20, 10));   // [5] different blob, begins range 2
+    reads.push_back(makeRead(blockB, 1, 165 + 2 * GAP + 40, 10));   // [6] different block, begins range 3
+    reads.push_back(makeRead(blockB, 1, 165 + 2 * GAP + 50, MAX_SIZE)); // [7] exceeds max size, begins range 4
+    reads.push_back(makeRead(blockB, 1, 165 + 2 * GAP + 60, 10));   // [8] inside [7], coalesced
+
+    SizeT begin = 0;
+    SizeT end = 0;
+    TEST(AssetCacheController::CoalesceBatchReads(reads.data(), reads.size(), 0, begin, end) == 4);
+    TEST(begin == 0);
+    TEST(end == 165 + GAP);
+
+    TEST(AssetCacheController::CoalesceBatchReads(reads.data(), reads.size(), 4, begin, end) == 5);
+    TEST(begin == 165 + 2 * GAP + 1);
+    TEST(end == begin + 10);
+
+    TEST(AssetCacheController::CoalesceBatchReads(reads.data(), reads.size(), 5, begin, end) == 6);
+    TEST(AssetCacheController::CoalesceBatchReads(reads.data(), reads.size(), 6, begin, end) == 7);
+    TEST(end - begin == 10);
+
+    TEST(AssetCacheController::CoalesceBatchReads(reads.data(), reads.size(), 7, begin, end) == 9);
+    TEST(begin == 165 + 2 * GAP + 50);
+    TEST(end - begin == MAX_SIZE);
+
+    // A single read larger than the max size is still read on its own.
+    TEST(AssetCacheController::CoalesceBatchReads(reads.data(), 8, 7, begin, end) == 8);
+}
+
 REGISTER_TEST(AssetMgr_AssetHandleFunctions, "Runtime.Asset")
 {
     const AssetLoadFlags::Value flags = AssetLoadFlags::LF_IMMEDIATE_PROPERTIES | AssetLoadFlags::LF_RECURSIVE_PROPERTIES | AssetLoadFlags::LF_ASYNC;
@@ -19,10 +19,221 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // ********************************************************************
 #include "Game/Test/Runtime/NetDriverTestUtils.h"
+#include "Core/Math/Random.h"
+#include "Core/Platform/SpinLock.h"
+#include "Core/Platform/Thread.h"
+#include "Core/Platform/ThreadFence.h"
+#include "Core/Utility/Log.h"
 #include "Runtime/Net/Controllers/NullMessageController.h"
+#include "Runtime/Net/PacketSerializer.h"
 
 namespace lf {
 
+// **********************************
+// Simulates a lossy link with latency for the request packets (and their acks) between
+// a client/server. Dropped packets are discarded and the rest are queued and delivered
+// on Update once their latency has elapsed.
+// **********************************
+class LossyLinkSimulator
+{
+public:
+    LossyLinkSimulator(NetSecureServerDriver& server, NetSecureClientDriver& client, Float32 dropRate, Float32 minLatency, Float32 maxLatency)
+    : mServer(server)
+    , mClient(client)
+    , mDropRate(dropRate)
+    , mMinLatency(minLatency)
+    , mMaxLatency(maxLatency)
+    , mLock()
+    , mPackets()
+    , mSeed(0x5EED)
+    , mClock()
+    , mUpdateThreadID(GetCallingThreadId())
+    , mEnabled(0)
+    , mDropped(0)
+    {
+        mClock.Start();
+        mServer.SetPacketFilter(NetSecureServerDriver::PacketFilter::Make([this](const ByteT* bytes, SizeT numBytes, const IPEndPointAny& endPoint) -> bool {
+            return Filter(true, bytes, numBytes, endPoint);
+        }));
+        mClient.SetPacketFilter(NetSecureClientDriver::PacketFilter::Make([this](const ByteT* bytes, SizeT numBytes, const IPEndPointAny& endPoint) -> bool {
+            return Filter(false, bytes, numBytes, endPoint);
+        }));
+    }
+
+    void SetEnabled(bool value) { AtomicStore(&mEnabled, value ? 1 : 0); }
+    SizeT GetDropped() const { return static_cast<SizeT>(AtomicLoad(&mDropped)); }
+
+    void Update()
+    {
+        TVector<DelayedPacket> ready;
+        {
+            ScopeLock lock(mLock);
+            const Float64 now = mClock.PeekDelta();
+            for (auto iter = mPackets.begin(); iter != mPackets.end();)
+            {
+                if (iter->mDeliverTime <= now)
+                {
+                    ready.push_back(*iter);
+                    iter = mPackets.erase(iter);
+                }
+                else
+                {
+                    ++iter;
+                }
+            }
+        }
+
+        // note: Packets delivered from here pass through the filter again, they're let through since they're on the update thread.
+        for (const DelayedPacket& packet : ready)
+        {
+            if (packet.mToServer)
+            {
+                mServer.ProcessPacketData(packet.mBytes.data(), packet.mBytes.size(), packet.mEndPoint);
+            }
+            else
+            {
+                mClient.ProcessPacketData(packet.mBytes.data(), packet.mBytes.size(), packet.mEndPoint);
+            }
+        }
+    }
+
+private:
+    struct DelayedPacket
+    {
+        TVector<ByteT> mBytes;
+        IPEndPointAny  mEndPoint;
+        Float64        mDeliverTime;
+        bool           mToServer;
+    };
+
+    bool Filter(bool toServer, const ByteT* bytes, SizeT numBytes, const IPEndPointAny& endPoint)
+    {
+        if (AtomicLoad(&mEnabled) == 0 || GetCallingThreadId() == mUpdateThreadID)
+        {
+            return false;
+        }
+
+        PacketSerializer ps;
+        if (!ps.SetBuffer(bytes, numBytes) || ps.GetType() != NetPacketType::NET_PACKET_TYPE_REQUEST)
+        {
+            return false;
+        }
+
+        ScopeLock lock(mLock);
+        if (Random::RandF(mSeed) < mDropRate)
+        {
+            AtomicIncrement32(&mDropped);
+            return true;
+        }
+
+        DelayedPacket packet;
+        packet.mBytes.resize(numBytes);
+        memcpy(packet.mBytes.data(), bytes, numBytes);
+        packet.mEndPoint = endPoint;
+        packet.mDeliverTime = mClock.PeekDelta() + Random::Range(mSeed, mMinLatency, mMaxLatency);
+        packet.mToServer = toServer;
+        mPackets.push_back(packet);
+        return true;
+    }
+
+    NetSecureServerDriver& mServer;
+    NetSecureClientDriver& mClient;
+    Float32                mDropRate;
+    Float32                mMinLatency;
+    Float32                mMaxLatency;
+    SpinLock               mLock;
+    TVector<DelayedPacket> mPackets;
+    Int32                  mSeed;
+    Timer                  mClock;
+    SizeT                  mUpdateThreadID;
+    volatile Atomic32      mEnabled;
+    volatile Atomic32      mDropped;
+};
+
+// **********************************
+// Records the order messages arrive in for each session, the payload is the index the client sent it with.
+// It's thread-safe so the workers dispatch to it concurrently.
+// **********************************
+class OrderedMessageController : public NetMessageController
+{
+public:
+    OrderedMessageController()
+    : mLock()
+    , mMessages()
+    , mOutOfOrder(0)
+    , mReceived(0)
+    {}
+
+    void OnInitialize(NetDriver*) override {}
+    void OnShutdown() override {}
+    void OnConnect(NetConnection*) override {}
+    void OnDisconnect(NetConnection*) override {}
+    void OnMessageData(NetMessageDataArgs& args) override
+    {
+        UInt32 index = 0;
+        if (args.mAppDataSize != sizeof(index) || !args.mConnection)
+        {
+            return;
+        }
+        memcpy(&index, args.mAppData, sizeof(index));
+
+        ScopeLock lock(mLock);
+        auto iter = mMessages.find(args.mConnection->GetConnectionID());
+        if (iter != mMessages.end() && iter->second >= index)
+        {
+            ++mOutOfOrder;
+        }
+        mMessages[args.mConnection->GetConnectionID()] = index;
+        ++mReceived;
+    }
+    void OnMessageDataError(NetMessageDataErrorArgs&) override {}
+    bool IsThreadSafe() const override { return true; }
+
+    SizeT GetOutOfOrder() const { ScopeLock lock(mLock); return mOutOfOrder; }
+    SizeT GetReceived() const { ScopeLock lock(mLock); return mReceived; }
+    SizeT GetSessions() const { ScopeLock lock(mLock); return mMessages.size(); }
+private:
+    mutable SpinLock       mLock;
+    TMap<SessionID, UInt32> mMessages;
+    SizeT                  mOutOfOrder;
+    SizeT                  mReceived;
+};
+
+// **********************************
+// Holds the worker dispatching a message until the test releases it.
+// **********************************
+class BlockingMessageController : public NetMessageController
+{
+public:
+    BlockingMessageController()
+    : mFence()
+    , mEntered(0)
+    {
+        mFence.Initialize();
+    }
+    ~BlockingMessageController()
+    {
+        mFence.Destroy();
+    }
+
+    void OnInitialize(NetDriver*) override {}
+    void OnShutdown() override {}
+    void OnConnect(NetConnection*) override {}
+    void OnDisconnect(NetConnection*) override {}
+    void OnMessageData(NetMessageDataArgs&) override
+    {
+        AtomicStore(&mEntered, 1);
+        mFence.Wait();
+    }
+    void OnMessageDataError(NetMessageDataErrorArgs&) override {}
+
+    bool HasEntered() const { return AtomicLoad(&mEntered) != 0; }
+    void Release() { mFence.Set(false); }
+private:
+    ThreadFence       mFence;
+    volatile Atomic32 mEntered;
+};
+
 // Test that a client can send a message to server.
 REGISTER_TEST(ClientServerMessage_Test_000, "Core.Net.MessageTests")
 {
@@ -305,4 +516,248 @@ REGISTER_TEST(ClientServerMessage_Test_005, "Core.Net.MessageTests")
     client.Shutdown();
 }
 
-} // namespace lf
\ No newline at end of file
+// Test a client can deliver a burst of messages over a lossy link with latency. (Exercises the
+// congestion window, selective acks and retransmission timeouts)
+REGISTER_TEST(ClientServerMessage_Test_006, "Core.Net.MessageTests")
+{
+    const NetTestInitializer NET_INIT;
+    const SimpleConnectionConfig CONFIG;
+    const String MESSAGE_DATA = "Message text sent in a request!";
+    const SizeT MESSAGE_COUNT = 64;
+
+    NetSecureServerDriver server;
+    NetSecureClientDriver client;
+    LossyLinkSimulator link(server, client, 0.1f, 0.01f, 0.05f);
+
+    TEST(CONFIG.Initialize(server));
+    NetClientDriverConfig clientConfig;
+    clientConfig.mEndPoint = CONFIG.mIP;
+    clientConfig.mCertificate = &CONFIG.mServerCertification;
+    clientConfig.mMaxRetransmit = 10;
+    TEST(client.Initialize(clientConfig));
+
+    auto requestController = MakeConvertiblePtr<NullMessageController>();
+    server.SetMessageController(NetDriver::MESSAGE_REQUEST, requestController);
+
+    // Make a connection:
+    ExecuteUpdate(20.0f, 60, [&server, &client, &link] {
+        server.Update();
+        client.Update();
+        link.Update();
+        return !client.IsConnected();
+    });
+    TEST_CRITICAL(client.IsConnected());
+
+    link.SetEnabled(true);
+    SizeT succeeded = 0;
+    SizeT failed = 0;
+    for (SizeT i = 0; i < MESSAGE_COUNT; ++i)
+    {
+        TEST(client.Send(
+            NetDriver::MESSAGE_REQUEST,
+            GetStandardMessageOptions(),
+            reinterpret_cast<const ByteT*>(MESSAGE_DATA.CStr()),
+            MESSAGE_DATA.Size(),
+            NetDriver::OnSendSuccess::Make([&succeeded] { ++succeeded; }),
+            NetDriver::OnSendFailed::Make([&failed] { ++failed; })));
+    }
+
+    ExecuteUpdate(30.0f, 60, [&server, &client, &link, &succeeded, &failed, MESSAGE_COUNT] {
+        server.Update();
+        client.Update();
+        link.Update();
+        return (succeeded + failed) < MESSAGE_COUNT;
+    });
+
+    gTestLog.Info(LogMessage("Lossy link results: Succeeded=") << succeeded
+        << ", Failed=" << failed
+        << ", Dropped=" << link.GetDropped()
+        << ", Retransmits=" << client.GetRetransmits()
+        << ", FastRetransmits=" << client.GetFastRetransmits()
+        << ", SRTT=" << client.GetSmoothedRTT()
+        << ", RTO=" << client.GetRetransmitTimeout()
+        << ", Window=" << client.GetCongestionWindow());
+
+    TEST(succeeded == MESSAGE_COUNT);
+    TEST(failed == 0);
+    TEST(link.GetDropped() > 0);
+    TEST(client.GetRetransmits() > 0);
+    TEST(client.GetMessagesInFlight() == 0);
+    server.Shutdown();
+    client.Shutdown();
+}
+
+// Test several clients sending to a server with multiple workers, each session's messages must
+// be dispatched in the order they were sent even though the sessions are processed concurrently.
+REGISTER_TEST(ClientServerMessage_Test_007, "Core.Net.MessageTests")
+{
+    const NetTestInitializer NET_INIT;
+    const SimpleConnectionConfig CONFIG;
+    const SizeT CLIENT_COUNT = 4;
+    const SizeT MESSAGE_COUNT = 32;
+
+    NetServerDriverConfig serverConfig;
+    serverConfig.mCertificate = &CONFIG.mServerCertification;
+    serverConfig.mPort = 8080;
+    serverConfig.mReceiveThreads = 2;
+    serverConfig.mWorkerThreads = 4;
+
+    NetSecureServerDriver server;
+    NetSecureClientDriver clients[CLIENT_COUNT];
+    TEST_CRITICAL(server.Initialize(serverConfig));
+    TEST(server.GetWorkerCount() == serverConfig.mWorkerThreads);
+    for (NetSecureClientDriver& client : clients)
+    {
+        TEST_CRITICAL(CONFIG.Initialize(client));
+    }
+
+    auto requestController = MakeConvertiblePtr<OrderedMessageController>();
+    server.SetMessageController(NetDriver::MESSAGE_REQUEST, requestController);
+
+    auto updateAll = [&server, &clients]
+    {
+        server.Update();
+        for (NetSecureClientDriver& client : clients)
+        {
+            client.Update();
+        }
+    };
+
+    ExecuteUpdate(20.0f, 60, [&updateAll, &clients] {
+        updateAll();
+        for (NetSecureClientDriver& client : clients)
+        {
+            if (!client.IsConnected())
+            {
+                return true;
+            }
+        }
+        return false;
+    });
+    for (NetSecureClientDriver& client : clients)
+    {
+        TEST_CRITICAL(client.IsConnected());
+    }
+    TEST(server.GetConnectionCount() == CLIENT_COUNT);
+
+    SizeT succeeded = 0;
+    SizeT failed = 0;
+    for (UInt32 i = 0; i < MESSAGE_COUNT; ++i)
+    {
+        for (NetSecureClientDriver& client : clients)
+        {
+            TEST(client.Send(
+                NetDriver::MESSAGE_REQUEST,
+                GetStandardMessageOptions(),
+                reinterpret_cast<const ByteT*>(&i),
+                sizeof(i),
+                NetDriver::OnSendSuccess::Make([&succeeded] { ++succeeded; }),
+                NetDriver::OnSendFailed::Make([&failed] { ++failed; })));
+        }
+    }
+
+    const SizeT TOTAL_MESSAGES = CLIENT_COUNT * MESSAGE_COUNT;
+    ExecuteUpdate(30.0f, 60, [&updateAll, &succeeded, &failed, TOTAL_MESSAGES] {
+        updateAll();
+        return (succeeded + failed) < TOTAL_MESSAGES;
+    });
+
+    TEST(succeeded == TOTAL_MESSAGES);
+    TEST(failed == 0);
+    TEST(requestController->GetReceived() == TOTAL_MESSAGES);
+    TEST(requestController->GetSessions() == CLIENT_COUNT);
+    TEST(requestController->GetOutOfOrder() == 0);
+
+    server.Shutdown();
+    for (NetSecureClientDriver& client : clients)
+    {
+        client.Shutdown();
+    }
+}
+
+// Test the server drops packets once its packet pool is exhausted and recovers once the worker catches up.
+REGISTER_TEST(ClientServerMessage_Test_008, "Core.Net.MessageTests")
+{
+    const NetTestInitializer NET_INIT;
+    const SimpleConnectionConfig CONFIG;
+    const String MESSAGE_DATA = "Message text sent in a request!";
+    const SizeT FLOOD_COUNT = 128;
+
+    // A single worker with a small pool, the worker holds onto its batch while it's blocked. The pool
+    // (4 heaps of 16) is larger than a receiver's batch (1 on WinSock, 32 with recvmmsg) so some buffers
+    // are still free when the flood starts.
+    NetServerDriverConfig serverConfig;
+    serverConfig.mCertificate = &CONFIG.mServerCertification;
+    serverConfig.mPort = 8080;
+    serverConfig.mWorkerThreads = 1;
+    serverConfig.mReceiveThreads = 1;
+    serverConfig.mMaxPendingPackets = 16;
+
+    NetSecureServerDriver server;
+    NetSecureClientDriver client;
+    TEST_CRITICAL(server.Initialize(serverConfig));
+    TEST_CRITICAL(CONFIG.Initialize(client));
+
+    auto requestController = MakeConvertiblePtr<BlockingMessageController>();
+    server.SetMessageController(NetDriver::MESSAGE_REQUEST, requestController);
+
+    ExecuteUpdate(20.0f, 60, [&server, &client] {
+        server.Update();
+        client.Update();
+        return !client.IsConnected();
+    });
+    TEST_CRITICAL(client.IsConnected());
+
+    SizeT succeeded = 0;
+    auto sendMessage = [&client, &succeeded, &MESSAGE_DATA]
+    {
+        return client.Send(
+            NetDriver::MESSAGE_REQUEST,
+            GetStandardMessageOptions(),
+            reinterpret_cast<const ByteT*>(MESSAGE_DATA.CStr()),
+            MESSAGE_DATA.Size(),
+            NetDriver::OnSendSuccess::Make([&succeeded] { ++succeeded; }),
+            NetDriver::OnSendFailed());
+    };
+
+    // Block the worker inside the controller:
+    TEST(sendMessage());
+    ExecuteUpdate(20.0f, 60, [&server, &client, &requestController] {
+        server.Update();
+        client.Update();
+        return !requestController->HasEntered();
+    });
+    TEST_CRITICAL(requestController->HasEntered());
+
+    // Nothing is returned to the pool while the worker is blocked so every free buffer is queued and
+    // the rest of the flood is dropped. (The receiver may still be refilling its batch so the free
+    // count is an upper bound)
+    const SizeT freeBefore = server.GetFreePackets();
+    TEST_CRITICAL(freeBefore > 0 && freeBefore < FLOOD_COUNT);
+    const SizeT droppedBefore = server.GetDroppedPackets();
+    ByteT junk[16] = { 0 };
+    for (SizeT i = 0; i < FLOOD_COUNT; ++i)
+    {
+        server.ProcessPacketData(junk, sizeof(junk), CONFIG.mIP);
+    }
+    const SizeT dropped = server.GetDroppedPackets() - droppedBefore;
+    gTestLog.Info(LogMessage("Pool exhaustion results: Flooded=") << FLOOD_COUNT << ", Free=" << freeBefore << ", Dropped=" << dropped);
+    TEST(dropped >= FLOOD_COUNT - freeBefore);
+    TEST(dropped < FLOOD_COUNT);
+    TEST(server.GetFreePackets() == 0);
+
+    // Once released the worker drains the queue and later messages are processed again.
+    requestController->Release();
+    TEST(sendMessage());
+    ExecuteUpdate(20.0f, 60, [&server, &client, &succeeded] {
+        server.Update();
+        client.Update();
+        return succeeded < 2;
+    });
+    TEST(succeeded == 2);
+
+    server.Shutdown();
+    client.Shutdown();
+}
+
+} // namespace lf
@@ -0,0 +1,278 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/Test/Test.h"
+#include "Core/Crypto/HMAC.h"
+#include "Core/Crypto/SecureRandom.h"
+#include "Core/Math/MathFunctions.h"
+#include "Runtime/Net/NetReliability.h"
+#include "Runtime/Net/NetTransmit.h"
+#include "Runtime/Net/PacketSerializer.h"
+#include "Runtime/Net/Server/NetSecureServerConnection.h"
+
+namespace lf {
+
+REGISTER_TEST(NetSackWindowTest, "Core.Net.ReliabilityTests")
+{
+    NetSackWindow window;
+    TEST(window.Empty());
+
+    window.Record(10);
+    TEST(!window.Empty());
+    TEST(window.GetInfo().mLatest == 10);
+    TEST(window.GetInfo().mBits == 0);
+
+    // 11 is lost, 12 and 13 arrive
+    window.Record(12);
+    window.Record(13);
+    TEST(window.GetInfo().mLatest == 13);
+    TEST(NetSackContains(window.GetInfo(), 13));
+    TEST(NetSackContains(window.GetInfo(), 12));
+    TEST(!NetSackContains(window.GetInfo(), 11));
+    TEST(NetSackContains(window.GetInfo(), 10));
+    TEST(!NetSackContains(window.GetInfo(), 14));
+    TEST(NetSackCountAfter(window.GetInfo(), 11) == 2);
+    TEST(NetSackCountAfter(window.GetInfo(), 13) == 0);
+
+    // Out of order arrival fills the hole, duplicates are no-ops
+    window.Record(11);
+    window.Record(11);
+    TEST(window.GetInfo().mLatest == 13);
+    TEST(NetSackContains(window.GetInfo(), 11));
+
+    // Packets older than the window are forgotten
+    window.Record(13 + static_cast<UInt32>(NET_SACK_WINDOW_SIZE));
+    TEST(!NetSackContains(window.GetInfo(), 12));
+    TEST(NetSackContains(window.GetInfo(), 13));
+
+    // Wrap around
+    window.Clear();
+    window.Record(0xFFFFFFFE);
+    window.Record(1);
+    TEST(window.GetInfo().mLatest == 1);
+    TEST(NetSackContains(window.GetInfo(), 0xFFFFFFFE));
+    TEST(!NetSackContains(window.GetInfo(), 0xFFFFFFFF));
+    TEST(!NetSackContains(window.GetInfo(), 0));
+    TEST(NetSackCountAfter(window.GetInfo(), 0xFFFFFFFF) == 1);
+
+    // Ack payload round trip
+    ByteT ackData[NET_MESSAGE_DELAYED_ACK_SIZE];
+    TEST(NetWriteMessageAck(0xAABBCCDD11223344ULL, window.GetInfo(), 1500, ackData, NET_MESSAGE_SACK_ACK_SIZE) == 0);
+    TEST(NetWriteMessageAck(0xAABBCCDD11223344ULL, window.GetInfo(), 1500, ackData, sizeof(ackData)) == NET_MESSAGE_DELAYED_ACK_SIZE);
+    UInt64 transmitID = 0;
+    NetSackInfo sack;
+    bool hasSack = false;
+    UInt32 ackDelay = 0;
+    TEST(NetReadMessageAck(ackData, sizeof(ackData), transmitID, sack, hasSack, ackDelay));
+    TEST(hasSack);
+    TEST(ackDelay == 1500);
+    TEST(transmitID == 0xAABBCCDD11223344ULL);
+    TEST(sack.mLatest == window.GetInfo().mLatest && sack.mBits == window.GetInfo().mBits);
+    TEST(NetReadMessageAck(ackData, NET_MESSAGE_SACK_ACK_SIZE, transmitID, sack, hasSack, ackDelay));
+    TEST(hasSack);
+    TEST(ackDelay == 0);
+    TEST(NetReadMessageAck(ackData, NET_MESSAGE_ACK_SIZE, transmitID, sack, hasSack, ackDelay));
+    TEST(!hasSack);
+    TEST(!NetReadMessageAck(ackData, NET_MESSAGE_ACK_SIZE + 1, transmitID, sack, hasSack, ackDelay));
+}
+
+// Test the server holds every other ack and acks duplicates/out of order packets right away.
+REGISTER_TEST(NetDelayedAckTest, "Core.Net.ReliabilityTests")
+{
+    const Int64 DELAY = 100;
+    const NetPacketType::Value TYPE = NetPacketType::NET_PACKET_TYPE_REQUEST;
+    NetSecureServerConnection connection;
+    NetSecureServerConnection::PendingAck ack;
+
+    // The first packet is held, the second is acked and the sack covers the first.
+    TEST(!connection.RecordReceivedPacket(NetTransmitInfo(1, 0).Value(), TYPE, 1000, ack));
+    TEST(!connection.TakePendingAck(1000 + DELAY - 1, DELAY, ack));
+    TEST(connection.RecordReceivedPacket(NetTransmitInfo(2, 0).Value(), TYPE, 1010, ack));
+    TEST(NetTransmitInfo(ack.mTransmitID).GetID() == 2);
+    TEST(ack.mPacketType == TYPE);
+    TEST(ack.mReceiveTime == 1010);
+    TEST(NetSackContains(ack.mSack, 1));
+    TEST(!connection.TakePendingAck(5000, DELAY, ack));
+
+    // A held ack is flushed after the delay, with the latest sack.
+    TEST(!connection.RecordReceivedPacket(NetTransmitInfo(3, 0).Value(), TYPE, 2000, ack));
+    TEST(!connection.TakePendingAck(2000 + DELAY - 1, DELAY, ack));
+    TEST(connection.TakePendingAck(2000 + DELAY, DELAY, ack));
+    TEST(NetTransmitInfo(ack.mTransmitID).GetID() == 3);
+    TEST(ack.mSack.mLatest == 3);
+    TEST(!connection.TakePendingAck(2000 + DELAY, DELAY, ack));
+
+    // A gap (packet 4 missing) is acked right away so the client can detect the loss.
+    TEST(connection.RecordReceivedPacket(NetTransmitInfo(5, 0).Value(), TYPE, 3000, ack));
+    TEST(NetTransmitInfo(ack.mTransmitID).GetID() == 5);
+    TEST(!NetSackContains(ack.mSack, 4));
+
+    // The late packet and a duplicate are both acked right away.
+    TEST(connection.RecordReceivedPacket(NetTransmitInfo(4, 0).Value(), TYPE, 3010, ack));
+    TEST(NetTransmitInfo(ack.mTransmitID).GetID() == 4);
+    TEST(NetSackContains(ack.mSack, 4) && NetSackContains(ack.mSack, 5));
+    TEST(connection.RecordReceivedPacket(NetTransmitInfo(5, 0).Value(), TYPE, 3020, ack));
+    TEST(!connection.TakePendingAck(10000, DELAY, ack));
+}
+
+REGISTER_TEST(NetRttEstimatorTest, "Core.Net.ReliabilityTests")
+{
+    NetRttEstimator rtt;
+    rtt.SetBounds(0.2f, 60.0f);
+    rtt.Reset(3.0f);
+    TEST(!rtt.HasSample());
+    TEST(rtt.GetRTO() == 3.0f);
+
+    // First sample: SRTT = R, RTTVAR = R / 2, RTO = SRTT + 4 * RTTVAR
+    rtt.Sample(0.1f);
+    TEST(rtt.HasSample());
+    TEST(ApproxEquals(rtt.GetSmoothedRTT(), 0.1f, 0.0001f));
+    TEST(ApproxEquals(rtt.GetRTTVariance(), 0.05f, 0.0001f));
+    TEST(ApproxEquals(rtt.GetRTO(), 0.3f, 0.0001f));
+
+    // A steady RTT converges the RTO to the minimum
+    for (SizeT i = 0; i < 64; ++i)
+    {
+        rtt.Sample(0.1f);
+    }
+    TEST(ApproxEquals(rtt.GetSmoothedRTT(), 0.1f, 0.0001f));
+    TEST(rtt.GetRTO() == 0.2f);
+
+    rtt.Backoff();
+    TEST(ApproxEquals(rtt.GetRTO(), 0.4f, 0.0001f));
+    for (SizeT i = 0; i < 16; ++i)
+    {
+        rtt.Backoff();
+    }
+    TEST(rtt.GetRTO() == 60.0f);
+
+    // A new sample clears the backoff
+    rtt.Sample(0.1f);
+    TEST(rtt.GetRTO() < 1.0f);
+}
+
+REGISTER_TEST(NetCongestionWindowTest, "Core.Net.ReliabilityTests")
+{
+    NetCongestionWindow window;
+    window.Reset(4.0f, 256.0f);
+    TEST(window.CanSend(3));
+    TEST(!window.CanSend(4));
+
+    // Slow start: +1 per ack
+    UInt32 uid = 0;
+    for (SizeT i = 0; i < 4; ++i)
+    {
+        window.OnAck(++uid);
+    }
+    TEST(window.GetWindow() == 8.0f);
+
+    // Loss halves the window once per congestion event
+    TEST(window.OnLoss(uid, uid + 8));
+    TEST(window.GetWindow() == 4.0f);
+    TEST(window.GetSlowStartThreshold() == 4.0f);
+    TEST(!window.OnLoss(uid + 1, uid + 8));
+    TEST(window.GetWindow() == 4.0f);
+    TEST(window.InRecovery());
+
+    // Congestion avoidance: +1/window per ack
+    window.OnAck(uid + 9);
+    TEST(!window.InRecovery());
+    TEST(ApproxEquals(window.GetWindow(), 4.25f, 0.0001f));
+
+    // Timeout collapses to the minimum window then slow starts
+    TEST(window.OnTimeout(uid + 10, uid + 12));
+    TEST(window.GetWindow() == 1.0f);
+    TEST(window.GetSlowStartThreshold() == 2.125f);
+    window.OnAck(uid + 13);
+    TEST(window.GetWindow() == 2.0f);
+}
+
+// Test the ack hmac covers the ack data, so a sack can't be altered or moved onto another ack.
+REGISTER_TEST(NetAckAuthenticationTest, "Core.Net.ReliabilityTests")
+{
+    Crypto::HMACKey key;
+    TEST_CRITICAL(key.Generate());
+
+    const UInt32 packetUID = 1234;
+    NetSackInfo sack;
+    sack.mLatest = packetUID;
+    sack.mBits = 0x0F;
+    ByteT ackData[NET_MESSAGE_DELAYED_ACK_SIZE];
+    TEST_CRITICAL(NetWriteMessageAck(NetTransmitInfo(packetUID, 0xCAFE).Value(), sack, 0, ackData, sizeof(ackData)) == sizeof(ackData));
+
+    ByteT packet[256] = { 0 };
+    SizeT packetSize = 0;
+    {
+        PacketSerializer ps;
+        TEST_CRITICAL(ps.SetBuffer(packet, sizeof(packet)));
+        ps.SetFlag(NetPacketFlag::NET_PACKET_FLAG_ACK);
+        ps.SetType(NetPacketType::NET_PACKET_TYPE_REQUEST);
+        ps.SetPacketUID(packetUID);
+        Crypto::AESIV iv;
+        Crypto::SecureRandomBytes(iv.mBytes, sizeof(iv.mBytes));
+        ps.SetIV(iv);
+        TEST_CRITICAL(ps.SetData(ackData, sizeof(ackData)));
+
+        Crypto::HMACBuffer headerHmac;
+        Crypto::HMACBuffer packetHmac;
+        TEST(ps.ComputeHeaderHmac(&key, headerHmac));
+        TEST(ps.ComputePacketHmac(&key, packetHmac));
+        TEST(headerHmac != packetHmac);
+
+        ps.SetEncryptedHMAC(packetHmac);
+        packetSize = ps.GetPacketSize();
+    }
+
+    auto verify = [&key, packetSize](const ByteT* bytes)
+    {
+        PacketSerializer ps;
+        Crypto::HMACBuffer hmac;
+        return ps.SetBuffer(bytes, packetSize) && ps.ComputePacketHmac(&key, hmac) && hmac == ps.GetEncryptedHMAC();
+    };
+    TEST(verify(packet));
+
+    // Changing the sack bits
+    ByteT tampered[sizeof(packet)];
+    memcpy(tampered, packet, sizeof(packet));
+    tampered[PacketSerializer::GetFullHeaderSize() + NET_MESSAGE_SACK_ACK_SIZE - 1] ^= 0x01;
+    TEST(!verify(tampered));
+
+    // Changing the header
+    memcpy(tampered, packet, sizeof(packet));
+    {
+        PacketSerializer ps;
+        TEST_CRITICAL(ps.SetBuffer(tampered, sizeof(tampered)));
+        ps.SetPacketUID(packetUID + 1);
+    }
+    TEST(!verify(tampered));
+
+    // Without data the packet hmac is the header hmac. (Heartbeat acks carry no data)
+    {
+        PacketSerializer ps;
+        TEST_CRITICAL(ps.SetBuffer(packet, sizeof(packet)));
+        Crypto::HMACBuffer headerHmac;
+        Crypto::HMACBuffer packetHmac;
+        TEST(ps.ComputeHeaderHmac(&key, headerHmac));
+        TEST(ps.ComputePacketHmac(&key, packetHmac));
+        TEST(headerHmac == packetHmac);
+    }
+}
+
+} // namespace lf
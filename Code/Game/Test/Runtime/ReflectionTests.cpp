@@ -0,0 +1,130 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Core/Test/Test.h"
+#include "Core/Reflection/Type.h"
+#include "Core/Utility/Log.h"
+#include "Core/Utility/Time.h"
+#include "Runtime/Reflection/ReflectionMgr.h"
+#include "Game/Test/TestUtils.h"
+
+namespace lf {
+
+// ** Reference implementation, walks the super chain.
+static bool IsAChain(const Type* type, const Type* other)
+{
+    for (const Type* iter = type; iter; iter = iter->GetSuper())
+    {
+        if (iter == other)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+REGISTER_TEST(ReflectionMgr_FindTypeTest, "Runtime.Reflection")
+{
+    ReflectionMgr& mgr = GetReflectionMgr();
+    TEST(mgr.FindType(Token()) == nullptr);
+    TEST(mgr.FindType(Token("ThisTypeDoesNotExist_FindTypeTest")) == nullptr);
+
+    for (TypeIterator it = mgr.GetTypesBegin(); it != mgr.GetTypesEnd(); ++it)
+    {
+        const Type* type = &(*it);
+        TEST(mgr.FindType(type->GetFullName()) == type);
+
+        // ** Names are not unique, but the type found must have the name.
+        const Type* byName = mgr.FindType(type->GetName());
+        TEST_CRITICAL(byName != nullptr);
+        TEST(byName->GetName() == type->GetName() || byName->GetFullName() == type->GetName());
+    }
+
+    TEST(mgr.FindType(Token("TestDynamicStreamDataA")) == typeof(TestDynamicStreamDataA));
+}
+
+REGISTER_TEST(ReflectionMgr_IsATest, "Runtime.Reflection")
+{
+    ReflectionMgr& mgr = GetReflectionMgr();
+    TEST(typeof(TestDynamicStreamDataA)->IsA(typeof(Object)));
+    TEST(typeof(TestDynamicStreamDataA)->IsA(typeof(TestDynamicStreamDataA)));
+    TEST(!typeof(TestDynamicStreamDataA)->IsA(typeof(TestDynamicStreamDataB)));
+    TEST(!typeof(Object)->IsA(typeof(TestDynamicStreamDataA)));
+    TEST(!typeof(Object)->IsA(nullptr));
+
+    // ** Verify the interval test agrees with the super chain for every pair of types.
+    SizeT numTypes = 0;
+    SizeT numMismatch = 0;
+    for (TypeIterator a = mgr.GetTypesBegin(); a != mgr.GetTypesEnd(); ++a)
+    {
+        for (TypeIterator b = mgr.GetTypesBegin(); b != mgr.GetTypesEnd(); ++b)
+        {
+            if (a->IsA(&(*b)) != IsAChain(&(*a), &(*b)))
+            {
+                ++numMismatch;
+            }
+        }
+        ++numTypes;
+    }
+    gTestLog.Info(LogMessage("Verified IsA for ") << numTypes << " types.");
+    TEST(numMismatch == 0);
+}
+
+REGISTER_TEST(ReflectionMgr_LookupBenchmark, "Runtime.Reflection", TestFlags::TF_BENCHMARK)
+{
+    ReflectionMgr& mgr = GetReflectionMgr();
+    TVector<Token> names;
+    for (TypeIterator it = mgr.GetTypesBegin(); it != mgr.GetTypesEnd(); ++it)
+    {
+        names.push_back(it->GetFullName());
+        names.push_back(it->GetName());
+    }
+
+    const SizeT ITERATIONS = 1000;
+    SizeT found = 0;
+    Timer timer;
+    timer.Start();
+    for (SizeT i = 0; i < ITERATIONS; ++i)
+    {
+        for (const Token& name : names)
+        {
+            found += mgr.FindType(name) ? 1 : 0;
+        }
+    }
+    timer.Stop();
+    gTestLog.Info(LogMessage("FindType x ") << (ITERATIONS * names.size()) << " took " << ToMilliseconds(TimeTypes::Seconds(timer.GetDelta())).mValue << "ms");
+    TEST(found == ITERATIONS * names.size());
+
+    SizeT isA = 0;
+    const Type* object = typeof(Object);
+    timer.Start();
+    for (SizeT i = 0; i < ITERATIONS; ++i)
+    {
+        for (TypeIterator it = mgr.GetTypesBegin(); it != mgr.GetTypesEnd(); ++it)
+        {
+            isA += it->IsA(object) ? 1 : 0;
+        }
+    }
+    timer.Stop();
+    gTestLog.Info(LogMessage("IsA x ") << (ITERATIONS * (names.size() / 2)) << " took " << ToMilliseconds(TimeTypes::Seconds(timer.GetDelta())).mValue << "ms");
+    TEST(isA > 0);
+}
+
+} // namespace lf
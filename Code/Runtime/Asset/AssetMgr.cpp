@@ -36,6 +36,7 @@
 #include "Runtime/Asset/Ops/AssetCreateOp.h"
 #include "Runtime/Asset/Ops/AssetDeleteOp.h"
 #include "Runtime/Asset/Ops/AssetImportOp.h"
+#include "Runtime/Asset/Ops/AssetLoadBatchOp.h"
 #include "Runtime/Asset/Ops/AssetLoadOp.h"
 #include "Runtime/Asset/Ops/AssetRemoveOp.h"
 #include "Runtime/Asset/Ops/AssetUpdateOp.h"
@@ -217,42 +218,11 @@ AssetOpAtomicWPtr AssetMgr::Load(const AssetTypeInfo* type, AssetLoadFlags::Valu
         flags |= AssetLoadFlags::LF_SOURCE;
     }
 
-    // @!!!RACE CONDITION!!!
-    // If the data is unloaded 'AssetDataController::UnloadPrototype' then we'll need to load it now!
-    // If the data is not unloaded, then it's safe to return
-
-    AssetHandle* handle = mDataController->GetHandle(type);
-    Assert(handle);
-    AtomicIncrement32(&handle->mStrongRefs);
-
-    const AssetLoadState::Value loadState = type->GetLoadState();
-    if ((flags & AssetLoadFlags::LF_RECURSIVE_PROPERTIES) > 0)
-    {
-        if (loadState == AssetLoadState::ALS_LOADED)
-        {
-            AtomicDecrement32(&handle->mStrongRefs);
-            return mOpController->GetCompleted();
-        }
-    }
-    else if ((flags & AssetLoadFlags::LF_IMMEDIATE_PROPERTIES) > 0)
-    {
-        if (loadState == AssetLoadState::ALS_SERIALIZED_PROPERTIES)
-        {
-            AtomicDecrement32(&handle->mStrongRefs);
-            return mOpController->GetCompleted();
-        }
-    }
-    else if((flags & AssetLoadFlags::LF_ACQUIRE) == 0)
+    if (!IsLoadRequired(type, flags))
     {
-        if (loadState == AssetLoadState::ALS_CREATED)
-        {
-            AtomicDecrement32(&handle->mStrongRefs);
-            return mOpController->GetCompleted();
-        }
+        return mOpController->GetCompleted();
     }
 
-    AtomicDecrement32(&handle->mStrongRefs);
-
     const bool loadCache = (flags & AssetLoadFlags::LF_SOURCE) == 0;
 
     auto op = MakeConvertibleAtomicPtr<AssetLoadOp>(AssetTypeInfoCPtr(type), flags, loadCache, context);
@@ -368,6 +338,42 @@ AssetOpAtomicWPtr AssetMgr::Load(const AssetTypeInfo* type, AssetLoadFlags::Valu
 
 }
 
+AssetOpAtomicWPtr AssetMgr::LoadBatch(const TVector<AssetTypeInfoCPtr>& types, AssetLoadFlags::Value flags)
+{
+    AssetOpDependencyContext context = GetOpDependencyContext();
+    if (!mCacheEnabled)
+    {
+        flags |= AssetLoadFlags::LF_SOURCE;
+    }
+
+    TVector<AssetTypeInfoCPtr> pending;
+    pending.reserve(types.size());
+    for (const AssetTypeInfoCPtr& type : types)
+    {
+        if (type && IsLoadRequired(type, flags))
+        {
+            pending.push_back(type);
+        }
+    }
+
+    if (pending.empty())
+    {
+        return mOpController->GetCompleted();
+    }
+
+    const bool loadCache = (flags & AssetLoadFlags::LF_SOURCE) == 0;
+
+    auto op = MakeConvertibleAtomicPtr<AssetLoadBatchOp>(pending, flags, loadCache, context);
+    op->Start();
+
+    const bool async = (flags & AssetLoadFlags::LF_ASYNC) > 0;
+    if (!async)
+    {
+        Wait(op);
+    }
+    return op;
+}
+
 AssetOpAtomicWPtr AssetMgr::Create(const AssetPath& assetPath, const AssetObject* object, const AssetTypeInfo* parent)
 {
     AssetOpDependencyContext context = GetOpDependencyContext();
@@ -720,6 +726,35 @@ AssetOpDependencyContext AssetMgr::GetOpDependencyContext()
     return context;
 }
 
+bool AssetMgr::IsLoadRequired(const AssetTypeInfo* type, AssetLoadFlags::Value flags)
+{
+    // @!!!RACE CONDITION!!!
+    // If the data is unloaded 'AssetDataController::UnloadPrototype' then we'll need to load it now!
+    // If the data is not unloaded, then it's safe to return
+
+    AssetHandle* handle = mDataController->GetHandle(type);
+    Assert(handle);
+    AtomicIncrement32(&handle->mStrongRefs);
+
+    bool required = true;
+    const AssetLoadState::Value loadState = type->GetLoadState();
+    if ((flags & AssetLoadFlags::LF_RECURSIVE_PROPERTIES) > 0)
+    {
+        required = loadState != AssetLoadState::ALS_LOADED;
+    }
+    else if ((flags & AssetLoadFlags::LF_IMMEDIATE_PROPERTIES) > 0)
+    {
+        required = loadState != AssetLoadState::ALS_SERIALIZED_PROPERTIES;
+    }
+    else if ((flags & AssetLoadFlags::LF_ACQUIRE) == 0)
+    {
+        required = loadState != AssetLoadState::ALS_CREATED;
+    }
+
+    AtomicDecrement32(&handle->mStrongRefs);
+    return required;
+}
+
 AssetTypeInfoCPtr AssetMgr::FindType(const AssetPath& path)
 {
     auto result = mDataController->Find(path);
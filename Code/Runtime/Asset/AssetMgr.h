@@ -93,6 +93,19 @@ public:
     // AssetOpAtomicWPtr Load(const AssetPath& assetPath, UnknownAssetHandle*& unknownHandle, const Type* requiredType, AssetLoadFlags::Value flags);
 
     AssetOpAtomicWPtr Load(const AssetTypeInfo* type, AssetLoadFlags::Value flags);
+    // ********************************************************************
+    // Loads many assets with a single operation. Cache reads for the whole
+    // batch are grouped by cache block and coalesced into large sequential
+    // reads before the assets are deserialized on the worker threads.
+    //
+    // Prefer this over many calls to Load when loading lots of assets at
+    // once. (eg. Level loads)
+    //
+    // @param types -- The asset types to load, types that are already loaded are skipped.
+    // @param flags -- Load flags applied to every asset in the batch.
+    // @returns Returns an op that completes once every asset in the batch is loaded.
+    // ********************************************************************
+    AssetOpAtomicWPtr LoadBatch(const TVector<AssetTypeInfoCPtr>& types, AssetLoadFlags::Value flags);
     // ** Unload the specified asset
     // void Unload();
     // ** Create a new asset from concrete type
@@ -234,6 +247,8 @@ private:
     void UnloadDomain(const String& domain);
 
     AssetOpDependencyContext GetOpDependencyContext();
+    // ** Returns true if the type has to be loaded to satisfy the load flags
+    bool IsLoadRequired(const AssetTypeInfo* type, AssetLoadFlags::Value flags);
 
     String mContentSourcePath;
     String mContentCachePath;
@@ -37,6 +37,18 @@ void AssetProcessor::Initialize(AssetDependencyContext& context)
 {
     mContext = context;
 }
+bool AssetProcessor::SupportsInPlaceLoad() const
+{
+    return false;
+}
+SizeT AssetProcessor::GetCacheAlignment(const MemoryBuffer&) const
+{
+    return 1;
+}
+bool AssetProcessor::PrepareAssetInPlace(AssetObject*, const CacheView&, AssetLoadFlags::Value) const
+{
+    return false;
+}
 AssetDataController& AssetProcessor::GetDataController() const
 {
     return *mContext.mDataController;
@@ -30,6 +30,7 @@ struct AssetDependencyContext;
 class Type;
 class AssetObject;
 class AssetPath;
+struct CacheView;
 DECLARE_ATOMIC_PTR(AssetObject);
 DECLARE_MANAGED_CPTR(AssetTypeInfo);
 
@@ -178,6 +179,27 @@ public:
     // ********************************************************************
     virtual bool PrepareAsset(AssetObject* object, const MemoryBuffer& buffer, AssetLoadFlags::Value loadFlags) const = 0;
     // ********************************************************************
+    // Returns true if the processor can load the asset directly from the
+    // memory mapped cache with PrepareAssetInPlace instead of reading the
+    // cached data into a buffer first.
+    // ********************************************************************
+    virtual bool SupportsInPlaceLoad() const;
+    // ********************************************************************
+    // Returns the alignment the exported cache data should be written with
+    // so PrepareAssetInPlace can use the view without copying it.
+    // 
+    // @param buffer -- The data exported for the cache
+    // ********************************************************************
+    virtual SizeT GetCacheAlignment(const MemoryBuffer& buffer) const;
+    // ********************************************************************
+    // Gets called to load the data into the prototype from a view of the
+    // cache. The data remains mapped while the view (or a copy of its
+    // mapping) is held, objects that reference it must keep the mapping.
+    // 
+    // @threading: AssetWorker
+    // ********************************************************************
+    virtual bool PrepareAssetInPlace(AssetObject* object, const CacheView& view, AssetLoadFlags::Value loadFlags) const;
+    // ********************************************************************
     // Gets called when the asset is loaded (ALS_LOADED)
     //
     // @threading: AssetWorker
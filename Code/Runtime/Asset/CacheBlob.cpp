@@ -31,6 +31,7 @@ const char* ERROR_MSG_INVALID_OPERATION_BLOB_NOT_INITIALIZED = "CacheBlob is not
 const char* ERROR_MSG_INVALID_ARGUMENT_CAPACITY = "Invalid argument 'capacity'";
 const char* ERROR_MSG_INVALID_ARGUMENT_ASSET_ID = "Invalid argument 'assetID'";
 const char* ERROR_MSG_INVALID_ARGUMENT_SIZE = "Invalid argument 'size'";
+const char* ERROR_MSG_INVALID_ARGUMENT_ALIGNMENT = "Invalid argument 'alignment'";
 const char* ERROR_MSG_INVALID_ARGUMENT_OBJECT_ID = "Invalid argument 'objectID'";
 const char* ERROR_MSG_INVALID_OPERATION_ASSOC_OBJECT_ID = "Invalid operation, 'objectID' is not associated with this CacheBlob";
 const char* ERROR_MSG_INVALID_OPERATION_OBJECT_NULL = "Invalid operation, the cache object associated with 'objectID' is null.";
@@ -83,7 +84,7 @@ void CacheBlob::Serialize(Stream& s)
     SERIALIZE_STRUCT_ARRAY(s, mObjects, "");
 }
 
-CacheObjectId CacheBlob::Reserve(UInt32 assetID, UInt32 size)
+CacheObjectId CacheBlob::Reserve(UInt32 assetID, UInt32 size, UInt32 alignment)
 {
     if (Invalid(assetID))
     {
@@ -95,6 +96,11 @@ CacheObjectId CacheBlob::Reserve(UInt32 assetID, UInt32 size)
         ReportBugMsgEx(ERROR_MSG_INVALID_ARGUMENT_SIZE, LF_ERROR_INVALID_ARGUMENT, ERROR_API_RUNTIME);
         return INVALID16;
     }
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        ReportBugMsgEx(ERROR_MSG_INVALID_ARGUMENT_ALIGNMENT, LF_ERROR_INVALID_ARGUMENT, ERROR_API_RUNTIME);
+        return INVALID16;
+    }
     if (mCapacity == 0)
     {
         ReportBugMsgEx(ERROR_MSG_INVALID_OPERATION_BLOB_NOT_INITIALIZED, LF_ERROR_INVALID_OPERATION, ERROR_API_RUNTIME);
@@ -110,7 +116,7 @@ CacheObjectId CacheBlob::Reserve(UInt32 assetID, UInt32 size)
     // Check if we can re-use a null object
     for (SizeT i = 0, objectSize = mObjects.size(); i < objectSize; ++i)
     {
-        if (Invalid(mObjects[i].mUID) && mObjects[i].mCapacity >= size)
+        if (Invalid(mObjects[i].mUID) && mObjects[i].mCapacity >= size && (mObjects[i].mLocation & (alignment - 1)) == 0)
         {
             mObjects[i].mUID = assetID;
             mObjects[i].mSize = size;
@@ -121,13 +127,22 @@ CacheObjectId CacheBlob::Reserve(UInt32 assetID, UInt32 size)
 
     // Check if space exists on the end.
     UInt32 freeBytes = mCapacity - mReserved;
-    if (freeBytes >= size)
+    UInt32 location = 0;
+    UInt32 padding = 0;
+    if (!mObjects.empty())
+    {
+        location = mObjects.back().mLocation + mObjects.back().mCapacity;
+        padding = ((location + alignment - 1) & ~(alignment - 1)) - location;
+    }
+    if (freeBytes >= size && freeBytes - size >= padding)
     {
-        UInt32 location = 0;
         SizeT id = mObjects.size();
-        if (id > 0)
+        // ** The padding belongs to the previous object so locations stay contiguous.
+        if (padding > 0)
         {
-            location = mObjects.back().mLocation + mObjects.back().mCapacity;
+            mObjects.back().mCapacity += padding;
+            mReserved += padding;
+            location += padding;
         }
 
         mObjects.push_back(CacheObject());
@@ -36,6 +36,7 @@ LF_RUNTIME_API extern const char* ERROR_MSG_INVALID_OPERATION_BLOB_NOT_INITIALIZ
 LF_RUNTIME_API extern const char* ERROR_MSG_INVALID_ARGUMENT_CAPACITY;
 LF_RUNTIME_API extern const char* ERROR_MSG_INVALID_ARGUMENT_ASSET_ID;
 LF_RUNTIME_API extern const char* ERROR_MSG_INVALID_ARGUMENT_SIZE;
+LF_RUNTIME_API extern const char* ERROR_MSG_INVALID_ARGUMENT_ALIGNMENT;
 LF_RUNTIME_API extern const char* ERROR_MSG_INVALID_ARGUMENT_OBJECT_ID;
 LF_RUNTIME_API extern const char* ERROR_MSG_INVALID_OPERATION_ASSOC_OBJECT_ID;
 LF_RUNTIME_API extern const char* ERROR_MSG_INVALID_OPERATION_OBJECT_NULL;
@@ -92,14 +93,17 @@ public:
     // Failure:
     //    (Bug) If the 'assetID' is invalid (aka null)
     //    (Bug) If the 'size' of the asset is 0 bytes.
+    //    (Bug) If the 'alignment' is not a power of two.
     //    (Bug) If the blob has not been initialized yet.
     //    If there isn't enough memory in any of the null CacheObjects or the reserved space of the cache blob
     // 
     // @param assetID -- An ID corresponding to an asset
     // @param size -- The size of the asset in bytes
+    // @param alignment -- The alignment of the location of the object within the blob, appended
+    //                     objects pad the capacity of the previous object to reach it.
     // @returns INVALID16 if a CacheObject was not allocated, otherwise an ID corresponding to the CacheObject allocated.
     // **********************************
-    CacheObjectId Reserve(UInt32 assetID, UInt32 size);
+    CacheObjectId Reserve(UInt32 assetID, UInt32 size, UInt32 alignment = 1);
     // **********************************
     // Updates the CacheObject, associated with the objectID, size property
     // 
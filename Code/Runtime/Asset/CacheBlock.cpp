@@ -21,6 +21,9 @@
 #include "Runtime/PCH.h"
 #include "CacheBlock.h"
 #include "Core/IO/Stream.h"
+#include "Core/Memory/Memory.h"
+#include "Core/String/String.h"
+#include "Core/String/StringCommon.h"
 #include <algorithm>
 
 namespace lf {
@@ -43,9 +46,13 @@ CacheBlock::CacheBlock()
 , mIndices()
 , mBlobs()
 , mLock()
+, mMappings()
+, mMappingLock()
 {}
 CacheBlock::~CacheBlock()
-{}
+{
+    ReleaseMappings();
+}
 
 void CacheBlock::Initialize(const Token& name, UInt32 defaultCapacity)
 {
@@ -77,6 +84,7 @@ void CacheBlock::Release()
     mDefaultCapacity = 0;
     mIndices.clear();
     mBlobs.clear();
+    ReleaseMappings();
 }
 
 void CacheBlock::Serialize(Stream& s)
@@ -86,7 +94,7 @@ void CacheBlock::Serialize(Stream& s)
     SERIALIZE_STRUCT_ARRAY(s, mBlobs, "");
 }
 
-CacheIndex CacheBlock::Create(UInt32 uid, UInt32 size)
+CacheIndex CacheBlock::Create(UInt32 uid, UInt32 size, UInt32 alignment)
 {
     if (Invalid(uid))
     {
@@ -117,7 +125,7 @@ CacheIndex CacheBlock::Create(UInt32 uid, UInt32 size)
     for (SizeT i = 0; i < mBlobs.size(); ++i)
     {
         CacheBlob& blob = mBlobs[i];
-        CacheObjectId id = blob.Reserve(uid, size);
+        CacheObjectId id = blob.Reserve(uid, size, alignment);
         if (Valid(id))
         {
             result.mUID = uid;
@@ -131,7 +139,7 @@ CacheIndex CacheBlock::Create(UInt32 uid, UInt32 size)
     {
         CacheBlob& blob = mBlobs.back();
         blob.Initialize({}, mDefaultCapacity);
-        CacheObjectId id = blob.Reserve(uid, size);
+        CacheObjectId id = blob.Reserve(uid, size, alignment);
         Assert(Valid(id));
         result.mUID = uid;
         result.mObjectID = static_cast<UInt32>(id);
@@ -141,7 +149,7 @@ CacheIndex CacheBlock::Create(UInt32 uid, UInt32 size)
 
     return result;
 }
-CacheIndex CacheBlock::Update(CacheIndex index, UInt32 size)
+CacheIndex CacheBlock::Update(CacheIndex index, UInt32 size, UInt32 alignment)
 {
     ScopeRWSpinLockWrite writeLock(mLock);
     if (!index)
@@ -185,7 +193,7 @@ CacheIndex CacheBlock::Update(CacheIndex index, UInt32 size)
     if (!mBlobs[index.mBlobID].Update(static_cast<CacheObjectId>(index.mObjectID), size))
     {
         Assert(mBlobs[index.mBlobID].Destroy(static_cast<CacheObjectId>(index.mObjectID)));
-        CacheObjectId objectID = mBlobs[index.mBlobID].Reserve(index.mUID, size);
+        CacheObjectId objectID = mBlobs[index.mBlobID].Reserve(index.mUID, size, alignment);
         if (Valid(objectID))
         {
             result.mUID = index.mUID;
@@ -208,7 +216,7 @@ CacheIndex CacheBlock::Update(CacheIndex index, UInt32 size)
         {
             continue;
         }
-        CacheObjectId objectID = mBlobs[blobID].Reserve(index.mUID, size);
+        CacheObjectId objectID = mBlobs[blobID].Reserve(index.mUID, size, alignment);
         if (Valid(objectID))
         {
             result.mUID = index.mUID;
@@ -223,7 +231,7 @@ CacheIndex CacheBlock::Update(CacheIndex index, UInt32 size)
     // Allocate another blob
     mBlobs.push_back(CacheBlob());
     mBlobs.back().Initialize({}, mDefaultCapacity);
-    CacheObjectId id = mBlobs.back().Reserve(index.mUID, size);
+    CacheObjectId id = mBlobs.back().Reserve(index.mUID, size, alignment);
     Assert(Valid(id));
     result.mUID = index.mUID;
     result.mBlobID = static_cast<UInt32>(mBlobs.size() - 1);
@@ -347,6 +355,39 @@ bool CacheBlock::GetObject(CacheIndex index, CacheObject& outObject) const
     return false;
 }
 
+bool CacheBlock::GetView(CacheIndex index, CacheView& outView) const
+{
+    CacheObject object;
+    if (!GetObject(index, object))
+    {
+        return false;
+    }
+
+    SizeT readPos = static_cast<SizeT>(object.mLocation);
+    SizeT readEnd = readPos + static_cast<SizeT>(object.mSize);
+    CacheMappingPtr mapping = GetMapping(index.mBlobID, readEnd);
+    if (!mapping)
+    {
+        return false;
+    }
+
+    outView.mData = mapping->GetData() + readPos;
+    outView.mSize = static_cast<SizeT>(object.mSize);
+    outView.mMapping = mapping;
+    return true;
+}
+
+String CacheBlock::GetBlobFilename(UInt32 blobID) const
+{
+    String filename(GetFilename().CStr());
+    ByteT id = static_cast<ByteT>(blobID);
+    filename.Append('_');
+    filename.Append(ByteToHex(id & 0xF0));
+    filename.Append(ByteToHex(id & 0x0F));
+    filename.Append(".lfcache");
+    return filename;
+}
+
 CacheBlobStats CacheBlock::GetBlobStat(SizeT index) const
 {
     ScopeRWSpinLockRead readLock(mLock);
@@ -420,4 +461,43 @@ TVector<CacheDefragStep> CacheBlock::GetDefragSteps() const
     return steps;
 }
 
+CacheMappingPtr CacheBlock::GetMapping(UInt32 blobID, SizeT requiredSize) const
+{
+    {
+        ScopeRWSpinLockRead readLock(mMappingLock);
+        if (blobID < mMappings.size() && mMappings[blobID] && mMappings[blobID]->GetSize() >= requiredSize)
+        {
+            return mMappings[blobID];
+        }
+    }
+
+    ScopeRWSpinLockWrite writeLock(mMappingLock);
+    if (blobID >= mMappings.size())
+    {
+        mMappings.resize(blobID + 1);
+    }
+
+    CacheMappingPtr& mapping = mMappings[blobID];
+    if (mapping && mapping->GetSize() >= requiredSize)
+    {
+        return mapping;
+    }
+
+    CacheMappingPtr file(LFNew<MappedFile>());
+    if (!file->OpenRead(GetBlobFilename(blobID).CStr()) || file->GetSize() < requiredSize)
+    {
+        return NULL_PTR;
+    }
+
+    // ** Views of the previous mapping keep it alive.
+    mapping = file;
+    return mapping;
+}
+
+void CacheBlock::ReleaseMappings()
+{
+    ScopeRWSpinLockWrite writeLock(mMappingLock);
+    mMappings.clear();
+}
+
 } // namespace lf
\ No newline at end of file
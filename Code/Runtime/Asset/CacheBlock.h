@@ -22,9 +22,11 @@
 #define LF_RUNTIME_CACHE_BLOCK_H
 
 #include "Core/Common/API.h"
+#include "Core/String/String.h"
 #include "Core/String/Token.h"
 #include "Core/Utility/Array.h"
 #include "Core/Platform/RWSpinLock.h"
+#include "Core/Platform/MappedFile.h"
 #include "Runtime/Asset/CacheTypes.h"
 #include "Runtime/Asset/CacheBlob.h"
 
@@ -54,10 +56,10 @@ public:
 
     void Serialize(Stream& s);
 
-    // ** Creates a cache object ( if the uid does not exist within any blobs)
-    CacheIndex Create(UInt32 uid, UInt32 size);
-    // ** Updates the size of the cached object, final object location returned by cache index
-    CacheIndex Update(CacheIndex index, UInt32 size);
+    // ** Creates a cache object ( if the uid does not exist within any blobs), the location of the object within its blob is a multiple of 'alignment'
+    CacheIndex Create(UInt32 uid, UInt32 size, UInt32 alignment = 1);
+    // ** Updates the size of the cached object, final object location returned by cache index ('alignment' applies if the object is moved)
+    CacheIndex Update(CacheIndex index, UInt32 size, UInt32 alignment = 1);
     // #TODO [Nathan] If the returned CacheIndex == index then we should just return bool instead.
     CacheIndex Destroy(CacheIndex index);
 
@@ -72,6 +74,22 @@ public:
     const bool Empty() const { return mIndices.empty() && mBlobs.empty(); }
 
     bool GetObject(CacheIndex index, CacheObject& outObject) const;
+    // **********************************
+    // Retrieves a read-only view of the object data directly from the memory mapped blob file.
+    // Blob files are mapped once, the first time an object within them is viewed, and remain
+    // mapped until the block is released and every view of the mapping is destroyed.
+    //
+    // note: The view holds a reference to the mapping so the data stays readable after the
+    //       block is released. Writes made to the object after the view was acquired are
+    //       visible through the view.
+    //
+    // @param index -- The location of the object within the cache block
+    // @param outView -- The view of the object data
+    // @returns Returns true if the object exists and its blob file could be mapped.
+    // **********************************
+    bool GetView(CacheIndex index, CacheView& outView) const;
+    // ** Returns the filename of the blob file the blob id is stored in.
+    String GetBlobFilename(UInt32 blobID) const;
     CacheBlobStats GetBlobStat(SizeT index) const;
     SizeT GetNumBlobs() const { return mBlobs.size(); }
 
@@ -82,6 +100,10 @@ public:
 
     TVector<CacheDefragStep> GetDefragSteps() const;
 private:
+    // ** Returns the mapping of a blob file, (re)mapping the file if it's not large enough to contain 'requiredSize' bytes
+    CacheMappingPtr GetMapping(UInt32 blobID, SizeT requiredSize) const;
+    void ReleaseMappings();
+
     // ** The name of the cache block file
     Token              mName;
     // ** The full filename of the cache block
@@ -94,6 +116,11 @@ private:
     TVector<CacheBlob>  mBlobs;
     // ** Lock for accessing the indicies/blobs
     mutable RWSpinLock mLock;
+    // ** Memory mapped blob files (indexed by blob id), mapped on first view. Mappings replaced by
+    //    a larger mapping or released stay mapped until the last view referencing them is destroyed.
+    mutable TVector<CacheMappingPtr> mMappings;
+    // ** Lock for accessing the mappings
+    mutable RWSpinLock mMappingLock;
     
 };
 
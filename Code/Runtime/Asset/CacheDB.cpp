@@ -22,6 +22,7 @@
 #include "CacheDB.h"
 #include "Core/Reflection/Type.h"
 #include "Core/Platform/FileSystem.h"
+#include "Core/Utility/Log.h"
 #include "Runtime/Asset/AssetTypeInfo.h"
 
 namespace lf
@@ -381,11 +382,21 @@ void CacheDB::Shutdown()
 
 void CacheDB::Save()
 {
+    // The journal is folded into the table files by a background checkpoint, committing is a sequential append.
+    if (mDB.IsJournalEnabled())
+    {
+        mDB.CommitJournal();
+        return;
+    }
     mDB.Save(MemDB::SAVE_DIRTY_LIST);
 }
 void CacheDB::Load()
 {
     mDB.Load();
+    if (!mDB.EnableJournal())
+    {
+        gSysLog.Warning(LogMessage("CacheDB failed to enable the journal, changes are persisted on Save."));
+    }
 }
 
 CacheDBHandlePtr CacheDB::Create(const AssetTypeInfo* type)
@@ -37,7 +37,15 @@ const char* ERROR_MSG_INDEX_OUT_OF_BOUNDS = "Index out of bounds.";
 using namespace CacheReaderError;
 DECLARE_ATOMIC_PTR(CacheReader);
 
-CacheReader::CacheReader()
+CacheReader::CacheReader() :
+mOutputBuffer(nullptr),
+mOutputBufferSize(0),
+mInputBuffer(nullptr),
+mInputBufferSize(0),
+mObject(),
+mBlock(nullptr),
+mIndex(),
+mOutputFile()
 {
 }
 CacheReader::CacheReader(const CacheReader& other) :
@@ -46,6 +54,8 @@ mOutputBufferSize(other.mOutputBufferSize),
 mInputBuffer(other.mInputBuffer),
 mInputBufferSize(other.mInputBufferSize),
 mObject(other.mObject),
+mBlock(other.mBlock),
+mIndex(other.mIndex),
 mOutputFile(other.mOutputFile)
 {
 
@@ -56,6 +66,8 @@ mOutputBufferSize(other.mOutputBufferSize),
 mInputBuffer(other.mInputBuffer),
 mInputBufferSize(other.mInputBufferSize),
 mObject(other.mObject),
+mBlock(other.mBlock),
+mIndex(other.mIndex),
 mOutputFile(std::forward<Token&&>(other.mOutputFile))
 {
 
@@ -107,13 +119,9 @@ bool CacheReader::Open(const CacheBlock& block, CacheIndex index, void* outputBu
 {
     if (block.GetObject(index, mObject))
     {
-        String blockTitle(block.GetFilename().CStr(), COPY_ON_WRITE);
-        String blockExtension("_");
-        ByteT blobID = static_cast<ByteT>(index.mBlobID);
-        blockExtension.Append(ByteToHex(blobID & 0xF0));
-        blockExtension.Append(ByteToHex(blobID & 0x0F));
-        blockExtension.Append(".lfcache");
-        mOutputFile = Token(blockTitle + blockExtension);
+        mOutputFile = Token(block.GetBlobFilename(index.mBlobID));
+        mBlock = &block;
+        mIndex = index;
         mOutputBuffer = outputBuffer;
         mOutputBufferSize = outputBufferSize;
         return true;
@@ -126,6 +134,11 @@ void CacheReader::SetInputBuffer(const void* inputBuffer, SizeT inputBufferSize)
     mInputBufferSize = inputBufferSize;
 }
 
+bool CacheReader::ReadView(CacheView& outView) const
+{
+    return mBlock && mBlock->GetView(mIndex, outView);
+}
+
 const char* CacheReader::ReadCommon()
 {
     if (mInputBuffer && mInputBufferSize > 0)
@@ -163,6 +176,23 @@ const char* CacheReader::ReadInput()
     return nullptr;
 }
 const char* CacheReader::ReadFile()
+{
+    CacheView view;
+    if (!ReadView(view))
+    {
+        return ReadFileDirect();
+    }
+
+    if (view.mSize > mOutputBufferSize)
+    {
+        return ERROR_MSG_INDEX_OUT_OF_BOUNDS;
+    }
+
+    memcpy(mOutputBuffer, view.mData, view.mSize);
+    return nullptr;
+}
+
+const char* CacheReader::ReadFileDirect()
 {
     String filename(mOutputFile.CStr(), COPY_ON_WRITE);
     
@@ -85,6 +85,16 @@ public:
     // **********************************
     void SetInputBuffer(const void* inputBuffer, SizeT inputBufferSize);
     // **********************************
+    // Retrieves a read-only view of the object straight from the memory mapped cache block file,
+    // nothing is copied to the output buffer.
+    //
+    // note: The view keeps the cache block file mapped until it is destroyed.
+    //
+    // @param outView -- The view of the object data
+    // @returns Returns true if the reader is open and the cache block file could be mapped.
+    // **********************************
+    bool ReadView(CacheView& outView) const;
+    // **********************************
     // @returns Returns the name of the file that would be read from when the read function is called.
     // **********************************
     const Token& GetOutputFilename() const { return mOutputFile; }
@@ -93,8 +103,10 @@ private:
     const char* ReadCommon();
     // ** Reads the current data from the input buffer
     const char* ReadInput();
-    // ** Reads the current data from the file
+    // ** Reads the current data from the memory mapped file (falls back to reading the file if it cannot be mapped)
     const char* ReadFile();
+    // ** Reads the current data from the file
+    const char* ReadFileDirect();
 
     // ** Pointer to the buffer the reader will copy the 'read' data to
     void*       mOutputBuffer;
@@ -106,6 +118,10 @@ private:
     SizeT       mInputBufferSize;
     // ** Cache object retrieved from the 'CacheBlock' and 'index' when opened.
     CacheObject mObject;
+    // ** The cache block the reader was opened with, used to access the memory mapped file.
+    const CacheBlock* mBlock;
+    // ** The location of the object within the cache block
+    CacheIndex  mIndex;
     // ** The name of the output filename, determined by the 'CacheBlock' and 'index'
     Token       mOutputFile;
 };
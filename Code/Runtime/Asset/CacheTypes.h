@@ -25,6 +25,8 @@
 #include "Core/Common/API.h"
 #include "Core/Crypto/MD5.h"
 #include "Core/IO/MemDB.h"
+#include "Core/Memory/AtomicSmartPointer.h"
+#include "Core/Platform/MappedFile.h"
 #include "Core/Utility/DateTime.h"
 #include "Core/Utility/FNVHash.h"
 
@@ -182,6 +184,21 @@ struct LF_RUNTIME_API CacheBlobStats
     SizeT      mBlobID;
 };
 
+using CacheMappingPtr = TAtomicStrongPointer<MappedFile>;
+
+// ** A read-only view of a cache object's data within a memory mapped blob file
+struct CacheView
+{
+    LF_FORCE_INLINE CacheView() : mData(nullptr), mSize(0), mMapping() {}
+
+    // ** Pointer to the first byte of the object
+    const ByteT*    mData;
+    // ** Size in bytes of the object
+    SizeT           mSize;
+    // ** The mapping the data points into, keeps the blob file mapped while the view (or a copy of it) is held
+    CacheMappingPtr mMapping;
+};
+
 struct CacheDefragStep
 {
     UInt32 mUID;
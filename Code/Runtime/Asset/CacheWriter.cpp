@@ -123,14 +123,7 @@ bool CacheWriter::Open(const CacheBlock& block, CacheIndex index, const void* so
 {
     if (block.GetObject(index, mObject))
     {
-        String blockTitle(block.GetFilename().CStr(), COPY_ON_WRITE);
-        String blockExtension("_");
-
-        ByteT blobID = static_cast<ByteT>(index.mBlobID);
-        blockExtension.Append(ByteToHex(blobID & 0xF0));
-        blockExtension.Append(ByteToHex(blobID & 0x0F));
-        blockExtension.Append(".lfcache");
-        mOutputFile = Token(blockTitle + blockExtension);
+        mOutputFile = Token(block.GetBlobFilename(index.mBlobID));
         mSourceMemory = sourceMemory;
         mSourceMemorySize = sourceMemorySize;
         mReserveSize = block.GetDefaultCapacity();
@@ -210,7 +203,7 @@ const char* CacheWriter::WriteFile()
     }
 
     File file;
-    if (!file.Open(filename, FF_WRITE, FILE_OPEN_EXISTING))
+    if (!file.Open(filename, FF_WRITE | FF_SHARE_READ, FILE_OPEN_EXISTING))
     {
         return ERROR_MSG_FAILED_TO_OPEN_FILE;
     }
@@ -268,7 +261,7 @@ const char* CacheWriter::WriteZeroFile()
     }
 
     File file;
-    if (!file.Open(filename, FF_WRITE, FILE_OPEN_EXISTING))
+    if (!file.Open(filename, FF_WRITE | FF_SHARE_READ, FILE_OPEN_EXISTING))
     {
         return ERROR_MSG_FAILED_TO_OPEN_FILE;
     }
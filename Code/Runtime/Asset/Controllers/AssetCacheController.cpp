@@ -23,10 +23,13 @@
 #include "Core/IO/JsonStream.h"
 #include "Core/Platform/File.h"
 #include "Core/Memory/MemoryBuffer.h"
+#include "Core/Utility/Utility.h"
 #include "Runtime/Asset/AssetTypeInfo.h"
 #include "Runtime/Asset/CacheWriter.h"
 #include "Runtime/Asset/CacheReader.h"
 
+#include <algorithm>
+
 namespace lf {
 
 AssetCacheController::AssetCacheController()
@@ -134,9 +137,9 @@ bool AssetCacheController::Read(String& content, const AssetTypeInfo* type, Cach
     return ReadBytes(const_cast<char*>(content.CStr()), content.Size(), type, cacheIndex);
 }
 
-bool AssetCacheController::Write(const MemoryBuffer& buffer, const AssetTypeInfo* type, CacheIndex& cacheIndex)
+bool AssetCacheController::Write(const MemoryBuffer& buffer, const AssetTypeInfo* type, CacheIndex& cacheIndex, SizeT alignment)
 {
-    return WriteBytes(buffer.GetData(), buffer.GetSize(), type, cacheIndex);
+    return WriteBytes(buffer.GetData(), buffer.GetSize(), type, cacheIndex, alignment);
 }
 
 bool AssetCacheController::Read(MemoryBuffer& buffer, const AssetTypeInfo* type, CacheIndex& cacheIndex)
@@ -144,6 +147,170 @@ bool AssetCacheController::Read(MemoryBuffer& buffer, const AssetTypeInfo* type,
     return ReadBytes(buffer.GetData(), buffer.GetSize(), type, cacheIndex);
 }
 
+SizeT AssetCacheController::ReadBatch(AssetCacheReadRequest* requests, SizeT numRequests)
+{
+    // ** Keep the domains alive while we hold pointers to their blocks
+    TVector<DomainContextPtr> contexts;
+    TVector<AssetCacheBatchRead> reads;
+    reads.reserve(numRequests);
+
+    for (SizeT i = 0; i < numRequests; ++i)
+    {
+        AssetCacheReadRequest& request = requests[i];
+        request.mSuccess = false;
+        if (!request.mType || !request.mBuffer)
+        {
+            continue;
+        }
+
+        const AssetTypeInfo* type = request.mType;
+        DomainContextPtr context = GetDomainContext(type->GetPath().GetDomain());
+        if (!context)
+        {
+            continue;
+        }
+
+        CacheBlockType::Value blockType = CacheBlockType::ToEnum(type->GetPath());
+        CacheBlock& block = context->mBlocks[blockType];
+
+        CacheObject cacheObject;
+        CacheIndex cacheIndex = block.Find(type->GetCacheIndex().mUID);
+        if (!cacheIndex || !block.GetObject(cacheIndex, cacheObject) || cacheObject.mSize == 0)
+        {
+            continue;
+        }
+
+        if (!request.mBuffer->Allocate(cacheObject.mSize, 1))
+        {
+            continue;
+        }
+        request.mBuffer->SetSize(cacheObject.mSize);
+
+        AssetCacheBatchRead read;
+        read.mBlock = &block;
+        read.mBlobID = cacheIndex.mBlobID;
+        read.mLocation = static_cast<SizeT>(cacheObject.mLocation);
+        read.mSize = static_cast<SizeT>(cacheObject.mSize);
+        read.mRequest = i;
+        reads.push_back(read);
+
+        if (std::find(contexts.begin(), contexts.end(), context) == contexts.end())
+        {
+            contexts.push_back(context);
+        }
+    }
+
+    std::sort(reads.begin(), reads.end(), [](const AssetCacheBatchRead& a, const AssetCacheBatchRead& b)
+    {
+        if (a.mBlock != b.mBlock)
+        {
+            return a.mBlock < b.mBlock;
+        }
+        if (a.mBlobID != b.mBlobID)
+        {
+            return a.mBlobID < b.mBlobID;
+        }
+        return a.mLocation < b.mLocation;
+    });
+
+    SizeT numRead = 0;
+    File file;
+    const CacheBlock* fileBlock = nullptr;
+    UInt32 fileBlobID = INVALID32;
+    TVector<ByteT> staging;
+
+    SizeT first = 0;
+    while (first < reads.size())
+    {
+        const AssetCacheBatchRead& head = reads[first];
+        SizeT rangeBegin = 0;
+        SizeT rangeEnd = 0;
+        const SizeT last = CoalesceBatchReads(reads.data(), reads.size(), first, rangeBegin, rangeEnd);
+
+        if (head.mBlock != fileBlock || head.mBlobID != fileBlobID)
+        {
+            file.Close();
+            fileBlock = head.mBlock;
+            fileBlobID = head.mBlobID;
+            file.Open(head.mBlock->GetBlobFilename(head.mBlobID), FF_READ | FF_SHARE_READ | FF_SHARE_WRITE, FILE_OPEN_EXISTING);
+        }
+
+        const SizeT rangeSize = rangeEnd - rangeBegin;
+        if (file.IsOpen() 
+            && rangeEnd <= static_cast<SizeT>(file.GetSize()) 
+            && file.SetCursor(static_cast<FileCursor>(rangeBegin), FILE_CURSOR_BEGIN))
+        {
+            if ((last - first) == 1)
+            {
+                // ** Nothing to coalesce, read straight into the request buffer.
+                AssetCacheReadRequest& request = requests[head.mRequest];
+                if (file.Read(request.mBuffer->GetData(), rangeSize) == rangeSize)
+                {
+                    request.mSuccess = true;
+                    ++numRead;
+                }
+            }
+            else
+            {
+                staging.resize(rangeSize);
+                if (file.Read(staging.data(), rangeSize) == rangeSize)
+                {
+                    for (SizeT i = first; i < last; ++i)
+                    {
+                        const AssetCacheBatchRead& read = reads[i];
+                        AssetCacheReadRequest& request = requests[read.mRequest];
+                        memcpy(request.mBuffer->GetData(), &staging[read.mLocation - rangeBegin], read.mSize);
+                        request.mSuccess = true;
+                        ++numRead;
+                    }
+                }
+            }
+        }
+        first = last;
+    }
+    return numRead;
+}
+
+SizeT AssetCacheController::CoalesceBatchReads(const AssetCacheBatchRead* reads, SizeT numReads, SizeT first, SizeT& outRangeBegin, SizeT& outRangeEnd)
+{
+    // ** Extend the range while the next object is in the same blob and close enough to the range.
+    const AssetCacheBatchRead& head = reads[first];
+    SizeT rangeBegin = head.mLocation;
+    SizeT rangeEnd = head.mLocation + head.mSize;
+    SizeT last = first + 1;
+    for (; last < numReads; ++last)
+    {
+        const AssetCacheBatchRead& next = reads[last];
+        SizeT nextEnd = Max(rangeEnd, next.mLocation + next.mSize);
+        if (next.mBlock != head.mBlock 
+            || next.mBlobID != head.mBlobID 
+            || next.mLocation > rangeEnd + BATCH_READ_MAX_GAP
+            || (nextEnd - rangeBegin) > BATCH_READ_MAX_SIZE)
+        {
+            break;
+        }
+        rangeEnd = nextEnd;
+    }
+    outRangeBegin = rangeBegin;
+    outRangeEnd = rangeEnd;
+    return last;
+}
+
+bool AssetCacheController::ReadView(const AssetTypeInfo* type, CacheView& view)
+{
+    DomainContextPtr context = GetDomainContext(type->GetPath().GetDomain());
+    if (!context)
+    {
+        return false;
+    }
+
+    CacheBlockType::Value blockType = CacheBlockType::ToEnum(type->GetPath());
+    CacheBlock& block = context->mBlocks[blockType];
+
+    CacheIndex cacheIndex = block.Find(type->GetCacheIndex().mUID);
+    return cacheIndex && block.GetView(cacheIndex, view);
+}
+
 bool AssetCacheController::QuerySize(const AssetTypeInfo* type, SizeT& outSize)
 {
     DomainContextPtr context = GetDomainContext(type->GetPath().GetDomain());
@@ -296,7 +463,7 @@ AssetCacheController::DomainContextPtr AssetCacheController::GetDomainContext(co
     return NULL_PTR;
 }
 
-bool AssetCacheController::WriteBytes(const void* buffer, SizeT numBytes, const AssetTypeInfo* type, CacheIndex& cacheIndex)
+bool AssetCacheController::WriteBytes(const void* buffer, SizeT numBytes, const AssetTypeInfo* type, CacheIndex& cacheIndex, SizeT alignment)
 {
     DomainContextPtr context = GetDomainContext(type->GetPath().GetDomain());
     if (!context)
@@ -312,17 +479,17 @@ bool AssetCacheController::WriteBytes(const void* buffer, SizeT numBytes, const
     cacheIndex = block.Find(uid);
     if (!cacheIndex)
     {
-        cacheIndex = block.Create(uid, static_cast<UInt32>(numBytes));
+        cacheIndex = block.Create(uid, static_cast<UInt32>(numBytes), static_cast<UInt32>(alignment));
         Assert(block.GetObject(cacheIndex, cacheObject) && cacheObject.mCapacity >= numBytes);
     }
     else
     {
         // #TODO [Nathan] In what scenario can we have a valid cache index but invalid object?
         Assert(block.GetObject(cacheIndex, cacheObject));
-        if (cacheObject.mCapacity < numBytes)
+        if (cacheObject.mCapacity < numBytes || (cacheObject.mLocation & (alignment - 1)) != 0)
         {
             block.Destroy(cacheIndex);
-            cacheIndex = block.Create(uid, static_cast<UInt32>(numBytes));
+            cacheIndex = block.Create(uid, static_cast<UInt32>(numBytes), static_cast<UInt32>(alignment));
             Assert(block.GetObject(cacheIndex, cacheObject) && cacheObject.mCapacity >= numBytes);
         }
     }
@@ -332,7 +499,7 @@ bool AssetCacheController::WriteBytes(const void* buffer, SizeT numBytes, const
     {
         return false;
     }
-    cacheIndex = block.Update(cacheIndex, static_cast<UInt32>(numBytes));
+    cacheIndex = block.Update(cacheIndex, static_cast<UInt32>(numBytes), static_cast<UInt32>(alignment));
     return true;
 }
 
@@ -34,8 +34,41 @@ class MemoryBuffer;
 class AssetTypeInfo;
 struct CacheIndex;
 
+// ** A single read used with AssetCacheController::ReadBatch
+struct AssetCacheReadRequest
+{
+    AssetCacheReadRequest() : mType(nullptr), mBuffer(nullptr), mSuccess(false) {}
+
+    // ** [Input] The type to read the cached data of
+    const AssetTypeInfo* mType;
+    // ** [Output] The buffer the cached data is read into (allocated by ReadBatch)
+    MemoryBuffer*        mBuffer;
+    // ** [Output] Whether or not the data was read
+    bool                 mSuccess;
+};
+
+// ** A request of ReadBatch resolved to a location within a cache blob
+struct AssetCacheBatchRead
+{
+    const CacheBlock* mBlock;
+    UInt32            mBlobID;
+    SizeT             mLocation;
+    SizeT             mSize;
+    SizeT             mRequest;
+};
+
 class LF_RUNTIME_API AssetCacheController
 {
+public:
+    enum : SizeT
+    {
+        // ** Objects separated by fewer bytes than this are read together, the gap is read and discarded
+        BATCH_READ_MAX_GAP = 64 * 1024,
+        // ** The largest read a batch will coalesce objects into
+        BATCH_READ_MAX_SIZE = 4 * 1024 * 1024
+    };
+private:
+
     // Block -> Blob -> Object
     struct DomainContext
     {
@@ -64,8 +97,37 @@ public:
     bool Write(const String& content, const AssetTypeInfo* type, CacheIndex& cacheIndex);
     bool Read(String& content, const AssetTypeInfo* type, CacheIndex& cacheIndex);
 
-    bool Write(const MemoryBuffer& buffer, const AssetTypeInfo* type, CacheIndex& cacheIndex);
+    // ** 'alignment' is the alignment of the object within its cache blob (see AssetProcessor::GetCacheAlignment)
+    bool Write(const MemoryBuffer& buffer, const AssetTypeInfo* type, CacheIndex& cacheIndex, SizeT alignment = 1);
     bool Read(MemoryBuffer& buffer, const AssetTypeInfo* type, CacheIndex& cacheIndex);
+    // ********************************************************************
+    // Reads the cached data of many types at once. Requests are grouped by
+    // the cache blob they live in and sorted by location, objects that are
+    // close together are coalesced into a single sequential read.
+    //
+    // @param requests -- The requests to read, each request buffer is allocated to the size of the object.
+    // @param numRequests -- The number of requests
+    // @returns Returns the number of requests that were read successfully.
+    // @threadsafe
+    // ********************************************************************
+    SizeT ReadBatch(AssetCacheReadRequest* requests, SizeT numRequests);
+    // ********************************************************************
+    // Finds the reads ReadBatch coalesces into the sequential read that
+    // starts at reads[first].
+    //
+    // @param reads -- The reads sorted by block, blob and location.
+    // @param outRangeBegin/outRangeEnd -- The byte range of the sequential read.
+    // @returns Returns the index one past the last read in the range.
+    // ********************************************************************
+    static SizeT CoalesceBatchReads(const AssetCacheBatchRead* reads, SizeT numReads, SizeT first, SizeT& outRangeBegin, SizeT& outRangeEnd);
+    // ********************************************************************
+    // Acquires a read-only view of the cached data of a type directly from
+    // the memory mapped cache blob.
+    //
+    // note: The view keeps the cache blob mapped until it is destroyed.
+    // @threadsafe
+    // ********************************************************************
+    bool ReadView(const AssetTypeInfo* type, CacheView& view);
 
     // ********************************************************************
     // Query the size of an asset in the cache.
@@ -99,7 +161,7 @@ public:
     bool FindObject(const AssetTypeInfo* type, CacheObject& outObject, CacheIndex& outIndex);
 private:
     DomainContextPtr GetDomainContext(const String& domain) const;
-    bool WriteBytes(const void* buffer, SizeT numBytes, const AssetTypeInfo* type, CacheIndex& cacheIndex);
+    bool WriteBytes(const void* buffer, SizeT numBytes, const AssetTypeInfo* type, CacheIndex& cacheIndex, SizeT alignment = 1);
     bool ReadBytes(void* buffer, SizeT numBytes, const AssetTypeInfo* type, CacheIndex& cacheIndex);
     
     void SaveIndex(DomainContext* context);
@@ -682,6 +682,7 @@ AssetObjectAtomicPtr AssetDataController::CreateInstance(const AssetTypeInfo* as
     // TODO: Check asset flags (or processor) for 'IsCloneable'
     MemoryBuffer buffer;
     BinaryStream bs(Stream::MEMORY, &buffer, Stream::SM_WRITE);
+    bs.SetFormat(BinaryStream::FORMAT_COMPACT);
     bs.BeginObject("x", "y");
     assetType->mHandle->mPrototype->Serialize(bs);
     bs.EndObject();
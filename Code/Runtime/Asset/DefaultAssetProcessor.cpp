@@ -130,7 +130,7 @@ AssetImportResult DefaultAssetProcessor::Import(const AssetPath& assetPath) cons
     }
     else // Json
     {
-        JsonObjectStream js(Stream::TEXT, &content, Stream::SM_READ);
+        JsonObjectStream js(Stream::TEXT, &content, Stream::SM_READ, JsonStream::RM_AUTO);
         if (js.GetMode() != Stream::SM_READ)
         {
             gSysLog.Error(LogMessage("Failed to import asset, failed to parse the source content object. Asset=") << assetPath.CStr());
@@ -196,6 +196,7 @@ AssetDataType::Value DefaultAssetProcessor::Export(AssetObject* object, MemoryBu
     case AssetDataType::ADT_BINARY:
     {
         BinaryStream s(Stream::MEMORY, &buffer, Stream::SM_WRITE);
+        s.SetFormat(BinaryStream::FORMAT_COMPACT);
         if (s.BeginObject(name, super))
         {
             object->Serialize(s);
@@ -287,7 +288,7 @@ bool DefaultAssetProcessor::PrepareAsset(AssetObject* object, const MemoryBuffer
         }
         else
         {
-            JsonObjectStream js(Stream::TEXT, &text, Stream::SM_READ);
+            JsonObjectStream js(Stream::TEXT, &text, Stream::SM_READ, JsonStream::RM_AUTO);
             if (!js.BeginObject(name, super))
             {
                 return false;
@@ -0,0 +1,226 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Runtime/PCH.h"
+#include "FrozenAsset.h"
+#include "Core/Reflection/DynamicCast.h"
+#include "Core/Utility/Log.h"
+#include "Runtime/Asset/CacheTypes.h"
+
+namespace lf {
+
+DEFINE_ABSTRACT_CLASS(lf::FrozenAsset) { NO_REFLECTION; }
+
+static const char* FrozenOpenResultString(FrozenBlob::OpenResult result)
+{
+    switch (result)
+    {
+        case FrozenBlob::OR_SUCCESS: return "Success";
+        case FrozenBlob::OR_INVALID_HEADER: return "InvalidHeader";
+        case FrozenBlob::OR_LAYOUT_MISMATCH: return "LayoutMismatch";
+        case FrozenBlob::OR_MISALIGNED: return "Misaligned";
+        case FrozenBlob::OR_INVALID_RELOCATION: return "InvalidRelocation";
+        default: return "Unknown";
+    }
+}
+
+static bool BindFrozenAsset(AssetObject* object, const CacheView& view, bool inPlace)
+{
+    FrozenAsset* frozen = DynamicCast<FrozenAsset>(object);
+    if (!frozen)
+    {
+        return false;
+    }
+
+    FrozenBlob::OpenResult result = inPlace ? frozen->BindFrozen(view) : frozen->BindFrozen(view.mData, view.mSize, false);
+    if (result != FrozenBlob::OR_SUCCESS)
+    {
+        gSysLog.Error(LogMessage("Failed to bind frozen asset. Result=") << FrozenOpenResultString(result) << ", Asset=" << frozen->GetAssetPath().CStr());
+        return false;
+    }
+    return true;
+}
+
+const Type* FrozenAssetProcessor::GetTargetType() const
+{
+    return typeof(FrozenAsset);
+}
+
+void FrozenAssetProcessor::ReadBinary(AssetObject* object, const MemoryBuffer& buffer) const
+{
+    CacheView view;
+    view.mData = reinterpret_cast<const ByteT*>(buffer.GetData());
+    view.mSize = buffer.GetSize();
+    BindFrozenAsset(object, view, false);
+}
+
+void FrozenAssetProcessor::WriteBinary(AssetObject* object, MemoryBuffer& buffer) const
+{
+    FrozenAsset* frozen = DynamicCast<FrozenAsset>(object);
+    if (!frozen)
+    {
+        return;
+    }
+
+    FrozenBlobWriter writer;
+    SizeT rootOffset = 0;
+    SizeT rootSize = 0;
+    if (!frozen->Freeze(writer, rootOffset, rootSize) || !writer.Finish(rootOffset, rootSize, frozen->GetFrozenLayout(), buffer))
+    {
+        gSysLog.Error(LogMessage("Failed to freeze asset. Asset=") << frozen->GetAssetPath().CStr());
+    }
+}
+
+bool FrozenAssetProcessor::SupportsInPlaceLoad() const
+{
+    return true;
+}
+
+SizeT FrozenAssetProcessor::GetCacheAlignment(const MemoryBuffer& buffer) const
+{
+    const SizeT alignment = FrozenBlob::GetRequiredAlignment(buffer.GetData(), buffer.GetSize());
+    return alignment > 0 && (alignment & (alignment - 1)) == 0 ? alignment : 1;
+}
+
+bool FrozenAssetProcessor::PrepareAssetInPlace(AssetObject* object, const CacheView& view, AssetLoadFlags::Value) const
+{
+    ReportBug(object != nullptr);
+    if (object == nullptr)
+    {
+        return false;
+    }
+    return BindFrozenAsset(object, view, true);
+}
+
+FrozenAsset::FrozenAsset()
+: Super()
+, mFrozen()
+, mFrozenStorage()
+, mFrozenMapping()
+{}
+
+FrozenAsset::~FrozenAsset()
+{}
+
+void FrozenAsset::Serialize(Stream& s)
+{
+    Super::Serialize(s);
+    if (s.IsReading())
+    {
+        MemoryBuffer blob;
+        SERIALIZE(s, blob, "");
+        if (blob.GetSize() == 0)
+        {
+            UnbindFrozen();
+            return;
+        }
+
+        FrozenBlob::OpenResult result = BindFrozen(blob.GetData(), blob.GetSize(), false);
+        if (result != FrozenBlob::OR_SUCCESS)
+        {
+            gSysLog.Error(LogMessage("Failed to bind serialized frozen asset. Result=") << FrozenOpenResultString(result) << ", Asset=" << GetAssetPath().CStr());
+        }
+    }
+    else
+    {
+        // Write straight from the bound blob, this only reads the memory.
+        MemoryBuffer blob;
+        if (mFrozen.IsOpen())
+        {
+            blob = MemoryBuffer(mFrozen.GetData(), mFrozen.GetSize());
+            blob.SetSize(mFrozen.GetSize());
+        }
+        SERIALIZE(s, blob, "");
+    }
+}
+
+void FrozenAsset::OnClone(const Object& o)
+{
+    Super::OnClone(o);
+    const FrozenAsset& other = static_cast<const FrozenAsset&>(o);
+    if (!other.mFrozen.IsOpen())
+    {
+        UnbindFrozen();
+        return;
+    }
+
+    // The other asset holds the mapping alive for its own blob, holding it here keeps it alive for the clone too.
+    const bool inPlace = other.IsFrozenInPlace() && other.mFrozenMapping;
+    FrozenBlob::OpenResult result = BindFrozen(other.mFrozen.GetData(), other.mFrozen.GetSize(), inPlace);
+    if (result == FrozenBlob::OR_SUCCESS && IsFrozenInPlace())
+    {
+        mFrozenMapping = other.mFrozenMapping;
+    }
+}
+
+FrozenBlob::OpenResult FrozenAsset::BindFrozen(const void* data, SizeT size, bool inPlace)
+{
+    UnbindFrozen();
+
+    FrozenBlob::OpenResult result = FrozenBlob::OR_MISALIGNED;
+    if (inPlace)
+    {
+        result = mFrozen.Open(data, size, GetFrozenLayout());
+    }
+
+    // The cache aligns frozen objects up to the alignment of its blobs, copy the blob if it needs more.
+    if (result == FrozenBlob::OR_MISALIGNED)
+    {
+        const SizeT alignment = FrozenBlob::GetRequiredAlignment(data, size);
+        if (alignment == 0)
+        {
+            return FrozenBlob::OR_INVALID_HEADER;
+        }
+        if (!mFrozenStorage.Allocate(size, alignment))
+        {
+            return FrozenBlob::OR_MISALIGNED;
+        }
+        mFrozenStorage.SetSize(size);
+        memcpy(mFrozenStorage.GetData(), data, size);
+        result = mFrozen.Open(mFrozenStorage.GetData(), size, GetFrozenLayout());
+    }
+
+    if (result != FrozenBlob::OR_SUCCESS)
+    {
+        UnbindFrozen();
+        return result;
+    }
+    OnThaw();
+    return result;
+}
+
+FrozenBlob::OpenResult FrozenAsset::BindFrozen(const CacheView& view)
+{
+    FrozenBlob::OpenResult result = BindFrozen(view.mData, view.mSize, true);
+    if (result == FrozenBlob::OR_SUCCESS && IsFrozenInPlace())
+    {
+        mFrozenMapping = view.mMapping;
+    }
+    return result;
+}
+
+void FrozenAsset::UnbindFrozen()
+{
+    mFrozen.Close();
+    mFrozenStorage.Free();
+    mFrozenMapping = NULL_PTR;
+}
+
+} // namespace lf
@@ -0,0 +1,120 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+
+#include "Core/IO/FrozenBlob.h"
+#include "Core/Memory/MemoryBuffer.h"
+#include "Runtime/Asset/AssetObject.h"
+#include "Runtime/Asset/BinaryAssetProcessor.h"
+#include "Runtime/Asset/CacheTypes.h"
+
+namespace lf {
+
+// ********************************************************************
+// Loads FrozenAsset's from the cache without deserializing them. Frozen blobs
+// are written to the cache with the alignment they require so the asset can
+// reference the memory mapped cache directly, blobs that end up misaligned
+// are copied into an aligned buffer owned by the asset.
+// ********************************************************************
+class LF_RUNTIME_API FrozenAssetProcessor : public BinaryAssetProcessor
+{
+public:
+    using Super = BinaryAssetProcessor;
+
+    const Type* GetTargetType() const override;
+    void ReadBinary(AssetObject* object, const MemoryBuffer& buffer) const override;
+    void WriteBinary(AssetObject* object, MemoryBuffer& buffer) const override;
+    bool SupportsInPlaceLoad() const override;
+    SizeT GetCacheAlignment(const MemoryBuffer& buffer) const override;
+    bool PrepareAssetInPlace(AssetObject* object, const CacheView& view, AssetLoadFlags::Value loadFlags) const override;
+};
+
+// ********************************************************************
+// Base class for assets whose data is stored as a frozen blob. Derived
+// types write their data with Freeze and read it back with GetFrozenRoot.
+// 
+// note: The frozen data is read only, the root returned from GetFrozenRoot
+//       is valid until the asset is unbound or unloaded.
+// ********************************************************************
+class LF_RUNTIME_API FrozenAsset : public AssetObject
+{
+    DECLARE_CLASS(FrozenAsset, AssetObject);
+public:
+    FrozenAsset();
+    virtual ~FrozenAsset();
+
+    // ********************************************************************
+    // Serializes the frozen blob, a deserialized asset binds its own copy
+    // of the blob. (eg. Instances created from the prototype)
+    // ********************************************************************
+    void Serialize(Stream& s) override;
+
+    // ********************************************************************
+    // Returns the layout of the frozen data, blobs written with a different
+    // layout are rejected.
+    // ********************************************************************
+    virtual FrozenLayout GetFrozenLayout() const = 0;
+    // ********************************************************************
+    // Writes the frozen data of the asset.
+    // 
+    // @param writer -- The writer to allocate the data in
+    // @param rootOffset -- [Output] The offset of the root structure
+    // @param rootSize -- [Output] The size of the root structure
+    // ********************************************************************
+    virtual bool Freeze(FrozenBlobWriter& writer, SizeT& rootOffset, SizeT& rootSize) const = 0;
+    // ********************************************************************
+    // Gets called after new frozen data has been bound.
+    // ********************************************************************
+    virtual void OnThaw() {}
+
+    // ********************************************************************
+    // Binds the frozen blob to the asset.
+    // 
+    // @param data -- The frozen blob
+    // @param size -- The size of the blob in bytes
+    // @param inPlace -- Whether or not the asset can reference the memory directly,
+    //                   the memory must outlive the asset. If false or the memory
+    //                   is misaligned the blob is copied.
+    // ********************************************************************
+    FrozenBlob::OpenResult BindFrozen(const void* data, SizeT size, bool inPlace);
+    // ********************************************************************
+    // Binds the frozen blob in place from a view of the cache, the asset holds
+    // the views mapping until it is unbound so the data stays mapped.
+    // ********************************************************************
+    FrozenBlob::OpenResult BindFrozen(const CacheView& view);
+    void UnbindFrozen();
+
+    // ** Returns true if the asset references memory it does not own (eg. the cache)
+    bool IsFrozenInPlace() const { return mFrozen.IsOpen() && mFrozenStorage.GetSize() == 0; }
+    const FrozenBlob& GetFrozenBlob() const { return mFrozen; }
+    template<typename RootT>
+    const RootT* GetFrozenRoot() const { return mFrozen.GetRoot<RootT>(); }
+protected:
+    // ** Clones share the cache mapping of an in place blob, otherwise the blob is copied.
+    void OnClone(const Object& o) override;
+private:
+    FrozenBlob      mFrozen;
+    MemoryBuffer    mFrozenStorage;
+    // ** The cache mapping the blob references when bound in place from a CacheView
+    CacheMappingPtr mFrozenMapping;
+};
+
+} // namespace lf
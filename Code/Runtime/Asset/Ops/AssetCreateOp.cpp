@@ -132,7 +132,7 @@ void AssetCreateOp::OnUpdate()
             }
 
             CacheIndex index;
-            if (!GetCacheController().Write(content, mAssetType, index))
+            if (!GetCacheController().Write(content, mAssetType, index, processor->GetCacheAlignment(content)))
             {
                 SetFailed("Failed to write the asset content to cache.");
                 mCreateState = Done;
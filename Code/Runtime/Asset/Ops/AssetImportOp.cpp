@@ -153,7 +153,7 @@ void AssetImportOp::OnUpdate()
             }
 
             CacheIndex index;
-            if (!GetCacheController().Write(content, mCurrentAssetType, index))
+            if (!GetCacheController().Write(content, mCurrentAssetType, index, processor->GetCacheAlignment(content)))
             {
                 SetFailed("Failed to write the asset content to cache.");
                 mImportState = Done;
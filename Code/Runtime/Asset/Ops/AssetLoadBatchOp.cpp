@@ -0,0 +1,129 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Runtime/PCH.h"
+#include "AssetLoadBatchOp.h"
+#include "Core/String/StringCommon.h"
+#include "Runtime/Asset/AssetTypeInfo.h"
+#include "Runtime/Asset/Controllers/AssetCacheController.h"
+#include "Runtime/Asset/Ops/AssetLoadOp.h"
+
+namespace lf {
+
+AssetLoadBatchOp::AssetLoadBatchOp(const TVector<AssetTypeInfoCPtr>& types, AssetLoadFlags::Value flags, bool loadCache, const AssetOpDependencyContext& context)
+: Super(context)
+, mState(ReadCache)
+, mTypes(types)
+, mBuffers()
+, mBuffersRead()
+, mFlags(flags)
+, mLoadCache(loadCache)
+, mNumCompleted(0)
+, mNumFailed(0)
+{
+}
+
+AssetOpThread::Value AssetLoadBatchOp::GetExecutionThread() const { return AssetOpThread::WORKER_THREAD; }
+
+void AssetLoadBatchOp::OnUpdate()
+{
+    switch (mState)
+    {
+        case ReadCache:
+        {
+            mBuffers.resize(mTypes.size());
+            mBuffersRead.resize(mTypes.size(), false);
+
+            const bool loadProperties = (mFlags & (AssetLoadFlags::LF_IMMEDIATE_PROPERTIES | AssetLoadFlags::LF_RECURSIVE_PROPERTIES)) > 0;
+            const bool acquire = (mFlags & AssetLoadFlags::LF_ACQUIRE) > 0;
+            if (mLoadCache && loadProperties && !acquire)
+            {
+                TVector<AssetCacheReadRequest> requests;
+                requests.resize(mTypes.size());
+                for (SizeT i = 0; i < mTypes.size(); ++i)
+                {
+                    // ** Skip data that won't be needed
+                    if (mTypes[i] && !AssetLoadState::IsPropertyLoaded(mTypes[i]->GetLoadState()))
+                    {
+                        requests[i].mType = mTypes[i];
+                        requests[i].mBuffer = &mBuffers[i];
+                    }
+                }
+
+                GetCacheController().ReadBatch(requests.data(), requests.size());
+                for (SizeT i = 0; i < requests.size(); ++i)
+                {
+                    mBuffersRead[i] = requests[i].mSuccess;
+                }
+            }
+            mState = StartLoads;
+        } break;
+        case StartLoads:
+        {
+            mState = WaitingForLoads;
+            for (SizeT i = 0; i < mTypes.size(); ++i)
+            {
+                auto op = MakeConvertibleAtomicPtr<AssetLoadOp>(mTypes[i], mFlags, mLoadCache, GetContext());
+                if (mBuffersRead[i])
+                {
+                    op->SetPreloadedData(mBuffers[i]);
+                }
+                op->Start();
+                WaitFor(op);
+            }
+            mBuffers.clear();
+            mBuffersRead.clear();
+        } break;
+        case WaitingForLoads:
+        {
+            // ** Resume happens before OnWaitComplete, so make sure every load has reported in.
+            if (static_cast<SizeT>(AtomicLoad(&mNumCompleted)) < mTypes.size())
+            {
+                return;
+            }
+
+            mState = Done;
+            const SizeT numFailed = GetNumFailed();
+            if (numFailed > 0)
+            {
+                SetFailed(String("Failed to load ") + ToString(numFailed) + " of " + ToString(mTypes.size()) + " assets.");
+            }
+            else
+            {
+                SetComplete();
+            }
+        } break;
+        case Done:
+        {
+
+        } break;
+    }
+}
+
+void AssetLoadBatchOp::OnWaitComplete(AssetOp* op)
+{
+    if (!op || !op->IsSuccess())
+    {
+        AtomicIncrement32(&mNumFailed);
+    }
+    AtomicIncrement32(&mNumCompleted);
+}
+
+} // namespace lf
@@ -0,0 +1,75 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Memory/MemoryBuffer.h"
+#include "Core/Platform/Atomic.h"
+#include "Runtime/Asset/AssetOp.h"
+#include "Runtime/Asset/AssetTypes.h"
+
+namespace lf {
+
+DECLARE_MANAGED_CPTR(AssetTypeInfo);
+
+// An asset op to load many assets at once. 
+//
+// When loading from the cache all the asset data is read up front with AssetCacheController::ReadBatch
+// (which coalesces the reads by cache blob/location) and then an AssetLoadOp is started for each asset
+// with the data it needs, so deserialization is spread across the asset op worker threads.
+//
+// The op completes once all the loads have completed, it fails if any of the loads failed.
+class LF_RUNTIME_API AssetLoadBatchOp : public AssetOp
+{
+public:
+    using Super = AssetOp;
+
+    AssetLoadBatchOp(const TVector<AssetTypeInfoCPtr>& types, AssetLoadFlags::Value flags, bool loadCache, const AssetOpDependencyContext& context);
+    ~AssetLoadBatchOp() override = default;
+
+    AssetOpThread::Value GetExecutionThread() const override;
+
+    // ** Returns the number of assets in the batch that failed to load. (Valid once the op is complete)
+    SizeT GetNumFailed() const { return static_cast<SizeT>(AtomicLoad(&mNumFailed)); }
+private:
+    void OnUpdate() override;
+    void OnWaitComplete(AssetOp* op) override;
+
+    enum BatchState
+    {
+        ReadCache,
+        StartLoads,
+        WaitingForLoads,
+        Done
+    };
+
+    BatchState                  mState;
+    TVector<AssetTypeInfoCPtr>  mTypes;
+    // ** Data read for each type (parallel to mTypes)
+    TVector<MemoryBuffer>       mBuffers;
+    // ** Whether or not the data was read for each type (parallel to mTypes)
+    TVector<bool>               mBuffersRead;
+    AssetLoadFlags::Value       mFlags;
+    bool                        mLoadCache;
+
+    volatile Atomic32           mNumCompleted;
+    volatile Atomic32           mNumFailed;
+};
+
+} // namespace lf
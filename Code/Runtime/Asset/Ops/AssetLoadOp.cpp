@@ -26,6 +26,7 @@
 #include "Core/Utility/Log.h"
 #include "Runtime/Asset/AssetObject.h"
 #include "Runtime/Asset/AssetProcessor.h"
+#include "Runtime/Asset/CacheTypes.h"
 #include "Runtime/Asset/Controllers/AssetCacheController.h"
 #include "Runtime/Asset/Controllers/AssetDataController.h"
 #include "Runtime/Asset/Controllers/AssetSourceController.h"
@@ -91,6 +92,9 @@ AssetLoadOp::AssetLoadOp(const AssetTypeInfoCPtr& assetType, AssetLoadFlags::Val
 , mLoadCache(loadCache)
 , mLocked(false)
 , mHandle(nullptr)
+, mDependencies()
+, mPreloadedData()
+, mPreloaded(false)
 , mLatencyState(Validate)
 , mLatencyTimer()
 , mLatencyTimings{0.0f}
@@ -99,6 +103,13 @@ AssetLoadOp::AssetLoadOp(const AssetTypeInfoCPtr& assetType, AssetLoadFlags::Val
 
 AssetOpThread::Value AssetLoadOp::GetExecutionThread() const { return AssetOpThread::WORKER_THREAD; }
 
+void AssetLoadOp::SetPreloadedData(MemoryBuffer& buffer)
+{
+    ReportBug(GetState() == AOS_NONE);
+    mPreloadedData.Swap(buffer);
+    mPreloaded = true;
+}
+
 void AssetLoadOp::OnUpdate()
 {
     switch (mState)
@@ -194,21 +205,45 @@ void AssetLoadOp::OnUpdate()
 
             if (!AssetLoadState::IsPropertyLoaded(mType->GetLoadState()))
             {
-                // Load the data from the cache or the source.
-                MemoryBuffer buffer;
-                Timer loadTimer;
-                loadTimer.Start();
-                const bool success = mLoadCache ? ReadCache(buffer) : ReadSource(buffer);
-                loadTimer.Stop();
-                mLoadTime = loadTimer.GetDelta();
-                if (!success)
+                AssetProcessor* processor = GetDataController().GetProcessor(mType);
+
+                // Processors that support it load straight from the memory mapped cache, skipping the copy into a buffer.
+                CacheView view;
+                if (!mPreloaded && mLoadCache && processor->SupportsInPlaceLoad() && GetCacheController().ReadView(mType, view))
                 {
-                    return;
+                    if (!processor->PrepareAssetInPlace(mHandle->mPrototype, view, mFlags))
+                    {
+                        SetFailed("Failed to prepare the asset from the cache view.");
+                        return;
+                    }
                 }
+                else
+                {
+                    // Load the data from the cache or the source.
+                    MemoryBuffer buffer;
+                    Timer loadTimer;
+                    loadTimer.Start();
+                    bool success = false;
+                    if (mPreloaded)
+                    {
+                        buffer.Swap(mPreloadedData);
+                        mPreloaded = false;
+                        success = true;
+                    }
+                    else
+                    {
+                        success = mLoadCache ? ReadCache(buffer) : ReadSource(buffer);
+                    }
+                    loadTimer.Stop();
+                    mLoadTime = loadTimer.GetDelta();
+                    if (!success)
+                    {
+                        return;
+                    }
 
-                // Hand the data over to the processor to actually load it into the object correctly.
-                AssetProcessor* processor = GetDataController().GetProcessor(mType);
-                processor->PrepareAsset(mHandle->mPrototype, buffer, mFlags);
+                    // Hand the data over to the processor to actually load it into the object correctly.
+                    processor->PrepareAsset(mHandle->mPrototype, buffer, mFlags);
+                }
                 GetDataController().SetLoadState(mType, AssetLoadState::ALS_SERIALIZED_PROPERTIES);
             }
 
@@ -19,6 +19,7 @@
 // LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // ********************************************************************
+#include "Core/Memory/MemoryBuffer.h"
 #include "Runtime/Asset/AssetOp.h"
 #include "Runtime/Asset/AssetTypes.h"
 
@@ -35,6 +36,10 @@ public:
     ~AssetLoadOp() override = default;
 
     AssetOpThread::Value GetExecutionThread() const override;
+
+    // ** Hands the op data that was already read from the cache/source (eg. by a batch read) so it won't have
+    //    to be read again. Call before starting the op, the op takes ownership of the buffer contents.
+    void SetPreloadedData(MemoryBuffer& buffer);
 private:
     void OnUpdate() override;
 
@@ -71,6 +76,9 @@ private:
 
     TVector<AssetTypeInfoCPtr> mDependencies;
 
+    MemoryBuffer mPreloadedData;
+    bool         mPreloaded;
+
     void LogStats();
     LoadState mLatencyState;
     Timer mLatencyTimer;
@@ -90,7 +90,7 @@ void UpdateCacheOp::OnUpdate()
             }
 
             CacheIndex index;
-            if (!GetCacheController().Write(content, mType, index))
+            if (!GetCacheController().Write(content, mType, index, processor->GetCacheAlignment(content)))
             {
                 SetFailed("Failed to write the asset content to cache.");
                 return;
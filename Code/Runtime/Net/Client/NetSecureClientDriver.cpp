@@ -38,6 +38,12 @@ namespace lf {
 
 // note: If we ever change the signature key size we should change this
 static const SizeT SIGNATURE_KEY_SIZE = 256;
+// note: Must be a power of 2, this is also the upper bound of the congestion window
+static const SizeT IN_FLIGHT_TABLE_SIZE = 256;
+static const Float32 INITIAL_CONGESTION_WINDOW = 4.0f;
+LF_STATIC_ASSERT((IN_FLIGHT_TABLE_SIZE & (IN_FLIGHT_TABLE_SIZE - 1)) == 0);
+// note: Every packet a sack covers must map to a unique in flight slot
+LF_STATIC_ASSERT(NET_SACK_WINDOW_SIZE < IN_FLIGHT_TABLE_SIZE);
 
 
 NetSecureClientDriver::NetSecureClientDriver()
@@ -51,9 +57,12 @@ NetSecureClientDriver::NetSecureClientDriver()
 , mMaxRetransmit(3)
 , mHeartbeatDelta(2.0f)
 , mMaxHeartbeatDelta(20.0f)
+, mRequestAEAD(true)
 // ** Keys
 , mDerivedSecretKey()
 , mDerivedHMAC()
+, mAEADEncrypt()
+, mAEADDecrypt()
 , mClientSigningKey()
 , mServerSigningKey()
 , mSessionID()
@@ -68,11 +77,18 @@ NetSecureClientDriver::NetSecureClientDriver()
 // ** Message Processing
 , mMessageControllerLocks()
 , mMessageControllers()
-, mMessageMapLock()
-, mMessageMap()
 , mNewMessagesLock()
 , mNewMessages()
 , mMessages()
+// ** Reliability
+, mAckEventLock()
+, mAckEvents()
+, mAckEventsProcessing()
+, mInFlight()
+, mInFlightCount(0)
+, mHighestSentUID(0)
+, mRttEstimator()
+, mCongestionWindow()
 // ** Heartbeat Processing
 , mHeartbeatTimer()
 , mHeartbeatWait(false)
@@ -86,6 +102,7 @@ NetSecureClientDriver::NetSecureClientDriver()
 // ** Stats
 , mStats()
 {
+    mInFlight.resize(IN_FLIGHT_TABLE_SIZE);
 }
 
 NetSecureClientDriver::~NetSecureClientDriver()
@@ -120,6 +137,8 @@ bool NetSecureClientDriver::Initialize(const NetClientDriverConfig& config)
         return false;
     }
     mProtocol = config.mProtocol;
+    mMaxRetransmit = config.mMaxRetransmit;
+    mRequestAEAD = config.mRequestAEAD;
     Assert(mServerCertificateKey.GetKeySizeBytes() == SIGNATURE_KEY_SIZE);
     return true;
 }
@@ -407,6 +426,10 @@ SizeT NetSecureClientDriver::GetRetransmits() const
 {
     return static_cast<SizeT>(AtomicLoad(&mStats.mRetransmits));
 }
+SizeT NetSecureClientDriver::GetFastRetransmits() const
+{
+    return static_cast<SizeT>(AtomicLoad(&mStats.mFastRetransmits));
+}
 void NetSecureClientDriver::LogStats(LoggerMessage& msg) const
 {
     msg << "\n        Packets Sent= " << GetPacketsSent()
@@ -414,7 +437,8 @@ void NetSecureClientDriver::LogStats(LoggerMessage& msg) const
         << "\n    Packets Received= " << GetPacketsReceived()
         << "\n      Bytes Received= " << GetBytesReceived()
         << "\n     Dropped Packets= " << GetDroppedPackets()
-        << "\n         Retransmits= " << GetRetransmits() << "\n";
+        << "\n         Retransmits= " << GetRetransmits()
+        << "\n    Fast Retransmits= " << GetFastRetransmits() << "\n";
 }
 
 void NetSecureClientDriver::SetRunning(bool value)
@@ -533,6 +557,20 @@ void NetSecureClientDriver::OnServerHello(const ByteT* bytes, SizeT numBytes)
         return;
     }
 
+    // The server echoes the AEAD flag if it accepted the request.
+    mAEADEncrypt.Release();
+    mAEADDecrypt.Release();
+    if (mRequestAEAD && ps.HasFlag(NetPacketFlag::NET_PACKET_FLAG_AEAD))
+    {
+        if (!mAEADEncrypt.Initialize(Crypto::AEAD_AES_256_GCM, &mDerivedSecretKey, true)
+            || !mAEADDecrypt.Initialize(Crypto::AEAD_AES_256_GCM, &mDerivedSecretKey, false))
+        {
+            gNetLog.Error(LogMessage("ServerHello failed to create the AEAD cipher contexts."));
+            SetState(Failed);
+            return;
+        }
+    }
+
     mLocalConnection = MakeConvertibleAtomicPtr<NetSecureLocalClientConnection>();
     mLocalConnection->Initialize(mSessionID, mEndPoint);
 
@@ -574,6 +612,9 @@ void NetSecureClientDriver::UpdateInitNetwork()
         }
     }
 
+    mRttEstimator.Reset(mAckTimeout);
+    mCongestionWindow.Reset(INITIAL_CONGESTION_WINDOW, static_cast<Float32>(IN_FLIGHT_TABLE_SIZE));
+
     SetState(ClientHello);
     mStats = Stats();
 }
@@ -632,8 +673,20 @@ void NetSecureClientDriver::ProcessMessage(const ByteT* bytes, SizeT numBytes, N
     PacketSerializer ps;
     Assert(ps.SetBuffer(bytes, numBytes));
 
-    Crypto::HMACBuffer hmac;
-    if (!ps.ComputeHeaderHmac(&mDerivedHMAC, hmac) || hmac != ps.GetEncryptedHMAC())
+    bool authenticated = false;
+    if (mAEADDecrypt.IsInitialized())
+    {
+        ByteT plainText[1500];
+        SizeT plainTextLength = sizeof(plainText);
+        authenticated = ps.Open(&mAEADDecrypt, plainText, plainTextLength);
+    }
+    else
+    {
+        Crypto::HMACBuffer hmac;
+        authenticated = !ps.HasFlag(NetPacketFlag::NET_PACKET_FLAG_AEAD) && ps.ComputeHeaderHmac(&mDerivedHMAC, hmac) && hmac == ps.GetEncryptedHMAC();
+    }
+
+    if (!authenticated)
     {
         AtomicIncrement64(&mStats.mDroppedPackets);
         return;
@@ -653,28 +706,198 @@ void NetSecureClientDriver::ProcessMessageAck(const ByteT* bytes, SizeT numBytes
     PacketSerializer ps;
     Assert(ps.SetBuffer(bytes, numBytes));
 
+    // The header and the ack data are authenticated together, see NetSecureServerDriver::SendAck
     Crypto::HMACBuffer hmac;
-    if (!ps.ComputeHeaderHmac(&mDerivedHMAC, hmac) || hmac != ps.GetEncryptedHMAC())
+    if (!ps.ComputePacketHmac(&mDerivedHMAC, hmac) || hmac != ps.GetEncryptedHMAC())
     {
         AtomicIncrement64(&mStats.mDroppedPackets);
         return;
     }
 
-    UInt64 id;
-    SizeT dataSize = sizeof(id);
-    if (!ps.GetData(reinterpret_cast<ByteT*>(&id), dataSize)) // todo: We can put this is in the header?
+    ByteT ackData[NET_MESSAGE_DELAYED_ACK_SIZE];
+    SizeT dataSize = sizeof(ackData);
+    if (!ps.GetData(ackData, dataSize)) // todo: We can put this is in the header?
+    {
+        return;
+    }
+
+    // note: The messages are only touched by the thread calling Update, the ack is queued and
+    //       timestamped here so the RTT sample doesn't include the time spent waiting on Update.
+    AckEvent ackEvent;
+    ackEvent.mReceiveTime = GetClockTime();
+    ackEvent.mPacketType = static_cast<NetPacketType::Value>(ps.GetType());
+    if (!NetReadMessageAck(ackData, dataSize, ackEvent.mTransmitID, ackEvent.mSack, ackEvent.mHasSack, ackEvent.mAckDelay)
+        || NetTransmitInfo(ackEvent.mTransmitID).GetID() != ps.GetPacketUID())
+    {
+        AtomicIncrement64(&mStats.mDroppedPackets);
+        return;
+    }
+
+    ScopeLock lock(mAckEventLock);
+    mAckEvents.push_back(ackEvent);
+}
+
+void NetSecureClientDriver::ProcessAckEvents()
+{
+    {
+        ScopeLock lock(mAckEventLock);
+        mAckEventsProcessing.swap(mAckEvents);
+    }
+    if (mAckEventsProcessing.empty())
+    {
+        return;
+    }
+
+    bool hasSack = false;
+    NetSackInfo latestSack;
+    for (const AckEvent& ackEvent : mAckEventsProcessing)
+    {
+        const NetTransmitInfo transmitID(ackEvent.mTransmitID);
+        InFlightEntry& entry = mInFlight[transmitID.GetID() & (mInFlight.size() - 1)];
+        if (entry.mMessage && entry.mMessage->GetID() == ackEvent.mTransmitID && entry.mMessage->GetPacketType() == ackEvent.mPacketType)
+        {
+            AcknowledgeInFlight(entry, true, ackEvent.mReceiveTime, ackEvent.mAckDelay);
+        }
+
+        if (ackEvent.mHasSack)
+        {
+            AcknowledgeSack(ackEvent.mSack);
+            if (!hasSack || NetPacketUIDDelta(ackEvent.mSack.mLatest, latestSack.mLatest) > 0)
+            {
+                latestSack = ackEvent.mSack;
+                hasSack = true;
+            }
+        }
+    }
+    mAckEventsProcessing.resize(0);
+
+    if (hasSack)
+    {
+        DetectLoss(latestSack);
+    }
+}
+
+void NetSecureClientDriver::AcknowledgeSack(const NetSackInfo& sack)
+{
+    // The sack covers packets whose own ack may have been lost, the RTT is not sampled
+    // since the ack wasn't sent in response to those packets.
+    InFlightEntry* latest = FindInFlight(sack.mLatest);
+    if (latest)
+    {
+        AcknowledgeInFlight(*latest, false, 0, 0);
+    }
+
+    // Only visit the set bits, bit i is the packet 'mLatest - 1 - i'
+    UInt64 bits = sack.mBits;
+    for (UInt32 i = 0; bits != 0; ++i, bits >>= 1)
+    {
+        if ((bits & 1) == 0)
+        {
+            continue;
+        }
+        InFlightEntry* entry = FindInFlight(sack.mLatest - 1 - i);
+        if (entry)
+        {
+            AcknowledgeInFlight(*entry, false, 0, 0);
+        }
+    }
+}
+
+void NetSecureClientDriver::AcknowledgeInFlight(InFlightEntry& entry, bool sampleRtt, Int64 receiveTime, UInt32 ackDelay)
+{
+    NetMessage* message = entry.mMessage;
+    if (message->GetState() != NetMessage::Transmit)
     {
         return;
     }
 
-    ScopeRWSpinLockRead lock(mMessageMapLock);
-    auto iter = mMessageMap.find(id);
-    if (iter != mMessageMap.end() && iter->second)
+    // Karn's rule: The ack of a retransmitted packet is ambiguous
+    if (sampleRtt && entry.mTransmits == 1)
     {
-        // todo: Verify packet type.
-        NetMessage* message = iter->second;
-        message->SetState(NetMessage::Success);
+        // The server may hold the ack (delayed ack), that time isn't part of the path's round trip.
+        Float64 rtt = static_cast<Float64>(receiveTime - entry.mSendTime) / static_cast<Float64>(GetClockFrequency());
+        const Float64 delay = static_cast<Float64>(ackDelay) / 1000000.0;
+        if (delay < rtt)
+        {
+            rtt -= delay;
+        }
+        mRttEstimator.Sample(static_cast<Float32>(rtt));
     }
+    mCongestionWindow.OnAck(entry.mPacketUID);
+    message->SetState(NetMessage::Success);
+}
+
+void NetSecureClientDriver::DetectLoss(const NetSackInfo& sack)
+{
+    // Only the missing packets inside the sack window are candidates. Anything older slid out
+    // of the window after an earlier sack already had enough later acks to flag it, otherwise
+    // it's left to the retransmit timeout.
+    for (UInt32 i = 0; i < NET_SACK_WINDOW_SIZE; ++i)
+    {
+        if ((sack.mBits & (1ULL << i)) != 0)
+        {
+            continue;
+        }
+
+        const UInt32 packetUID = sack.mLatest - 1 - i;
+        InFlightEntry* entry = FindInFlight(packetUID);
+        if (!entry || entry->mLost || entry->mMessage->GetState() != NetMessage::Transmit)
+        {
+            continue;
+        }
+
+        if (NetSackCountAfter(sack, packetUID) >= NET_SACK_LOSS_THRESHOLD)
+        {
+            entry->mLost = true;
+            entry->mFastRetransmit = true;
+            mCongestionWindow.OnLoss(packetUID, mHighestSentUID);
+        }
+    }
+}
+
+bool NetSecureClientDriver::RegisterInFlight(const MessagePtr& message)
+{
+    const UInt32 packetUID = NetTransmitInfo(message->GetID()).GetID();
+    InFlightEntry& entry = mInFlight[packetUID & (mInFlight.size() - 1)];
+    if (entry.mMessage)
+    {
+        // An older message is still using the slot, try again next update.
+        return false;
+    }
+
+    entry = InFlightEntry();
+    entry.mMessage = message;
+    entry.mPacketUID = packetUID;
+    ++mInFlightCount;
+    if (NetPacketUIDDelta(packetUID, mHighestSentUID) > 0)
+    {
+        mHighestSentUID = packetUID;
+    }
+    message->SetState(NetMessage::Transmit);
+    return true;
+}
+
+void NetSecureClientDriver::ReleaseInFlight(NetMessage* message)
+{
+    InFlightEntry* entry = FindInFlight(message);
+    if (entry)
+    {
+        *entry = InFlightEntry();
+        --mInFlightCount;
+    }
+}
+
+NetSecureClientDriver::InFlightEntry* NetSecureClientDriver::FindInFlight(NetMessage* message)
+{
+    InFlightEntry& entry = mInFlight[NetTransmitInfo(message->GetID()).GetID() & (mInFlight.size() - 1)];
+    const NetMessage* current = entry.mMessage;
+    return current == message ? &entry : nullptr;
+}
+
+NetSecureClientDriver::InFlightEntry* NetSecureClientDriver::FindInFlight(UInt32 packetUID)
+{
+    InFlightEntry& entry = mInFlight[packetUID & (mInFlight.size() - 1)];
+    return entry.mMessage && entry.mPacketUID == packetUID ? &entry : nullptr;
 }
 
 void NetSecureClientDriver::UpdateClientHello()
@@ -738,6 +961,10 @@ void NetSecureClientDriver::UpdateClientHello()
     ps.SetAppId(mAppID);
     ps.SetAppVersion(mAppVersion);
     ps.SetFlags(0);
+    if (mRequestAEAD)
+    {
+        ps.SetFlag(NetPacketFlag::NET_PACKET_FLAG_AEAD);
+    }
     ps.SetType(static_cast<UInt8>(mHandshakeData->mPacketConnectionMessage.mType));
     ps.SetPacketUID(GetPacketUID());
     ps.SetSessionID(SessionID());
@@ -858,65 +1085,40 @@ void NetSecureClientDriver::UpdateClientReady()
 
 void NetSecureClientDriver::UpdateMessages()
 {
-    // Accept new messages:
+    // Accept new messages: (Appended so the congestion window serves the oldest messages first)
     {
         ScopeLock lock(mNewMessagesLock);
-        mMessages.insert(mMessages.begin(), mNewMessages.begin(), mNewMessages.end());
+        mMessages.insert(mMessages.end(), mNewMessages.begin(), mNewMessages.end());
         mNewMessages.resize(0);
     }
 
+    // Acknowledge:
+    ProcessAckEvents();
+
     // Update:
-    TVector<MessagePtr> messages;
     for (MessagePtr& message : mMessages)
     {
-        NetMessage::State oldState = message->GetState();
         UpdateMessage(message);
-        NetMessage::State newState = message->GetState();
-        if (oldState == NetMessage::SerializeData && newState == NetMessage::Register)
-        {
-            messages.push_back(message);
-        }
-    }
 
-    // Register:
-    if (!messages.empty())
-    {
-        ScopeRWSpinLockWrite lock(mMessageMapLock);
-        for (MessagePtr& message : messages)
+        // Register: The message is tracked in the in-flight table until it's acknowledged or fails.
+        if (message->GetState() == NetMessage::Register && RegisterInFlight(message))
         {
-            // todo: VERY unlikely but we could have 2 messages with same ID|Crc32...
-            Assert(mMessageMap.find(message->GetID()) == mMessageMap.end());
-            // For message tracking we could maybe offload it to the individual connections
-
-            mMessageMap.insert(std::make_pair(message->GetID(), message));
-            message->SetState(NetMessage::Transmit);
+            UpdateMessage(message);
         }
     }
 
-    // Mark
-    messages.resize(0);
+    // Sweep:
     for (auto iter = mMessages.begin(); iter != mMessages.end();)
     {
         if ((*iter)->GetState() == NetMessage::Garbage)
         {
-            messages.push_back(*iter);
-            iter = mMessages.swap_erase(iter);
+            iter = mMessages.erase(iter);
         }
         else
         {
             ++iter;
         }
     }
-
-    // Sweep:
-    if (!messages.empty())
-    {
-        ScopeRWSpinLockWrite lock(mMessageMapLock);
-        for (NetMessage* message : messages)
-        {
-            mMessageMap.erase(message->GetID());
-        }
-    }
 }
 
 void NetSecureClientDriver::UpdateMessage(NetMessage* message)
@@ -924,6 +1126,7 @@ void NetSecureClientDriver::UpdateMessage(NetMessage* message)
     switch (message->GetState())
     {
     case NetMessage::SerializeData: UpdateMessageSerialize(message); break;
+    case NetMessage::Register: break; // Waiting on a slot in the in-flight table
     case NetMessage::Transmit: UpdateMessageTransmit(message); break;
     case NetMessage::Failed:
     case NetMessage::Success:
@@ -939,11 +1142,18 @@ void NetSecureClientDriver::UpdateMessage(NetMessage* message)
 
 void NetSecureClientDriver::UpdateMessageSerialize(NetMessage* message)
 {
+    // Wait until the congestion window has room
+    if (!mCongestionWindow.CanSend(mInFlightCount))
+    {
+        return;
+    }
+
     NetKeySet keySet;
     keySet.mDerivedSecretKey = &mDerivedSecretKey;
     keySet.mHmacKey = &mDerivedHMAC;
     keySet.mSigningKey = &mClientSigningKey;
     keySet.mVerifyKey = nullptr; // Shouldn't be needed for this op
+    keySet.mAEAD = mAEADEncrypt.IsInitialized() ? &mAEADEncrypt : nullptr;
 
     NetServerDriverConfig config;
     config.mAppID = mAppID;
@@ -959,13 +1169,36 @@ void NetSecureClientDriver::UpdateMessageSerialize(NetMessage* message)
 }
 void NetSecureClientDriver::UpdateMessageTransmit(NetMessage* message)
 {
-    if (!message->GetConnection())
+    InFlightEntry* entry = FindInFlight(message);
+    if (!message->GetConnection() || !entry)
     {
         message->SetState(NetMessage::Failed);
         return;
     }
 
-    if (!message->HasTransmitStarted() || (message->GetTransmitRemaining() > 0 && message->GetTransmitDelta() > mAckTimeout))
+    bool transmit = !message->HasTransmitStarted();
+    if (!transmit && entry->mFastRetransmit && message->GetTransmitRemaining() > 0)
+    {
+        AtomicIncrement64(&mStats.mFastRetransmits);
+        transmit = true;
+    }
+    else if (!transmit && message->GetTransmitDelta() > mRttEstimator.GetRTO())
+    {
+        if (message->GetTransmitRemaining() == 0)
+        {
+            message->SetState(NetMessage::Failed);
+            return;
+        }
+
+        // Only back off once per congestion event, otherwise a burst of timeouts would compound the RTO.
+        if (mCongestionWindow.OnTimeout(entry->mPacketUID, mHighestSentUID))
+        {
+            mRttEstimator.Backoff();
+        }
+        transmit = true;
+    }
+
+    if (transmit)
     {
         IPEndPointAny endPoint = message->GetConnection()->GetEndPoint();
         SizeT numBytes = message->GetPacketBytesSize();
@@ -975,10 +1208,17 @@ void NetSecureClientDriver::UpdateMessageTransmit(NetMessage* message)
             return;
         }
         message->OnTransmit();
+        entry->mSendTime = GetClockTime();
+        entry->mFastRetransmit = false;
+        if (++entry->mTransmits > 1)
+        {
+            AtomicIncrement64(&mStats.mRetransmits);
+        }
     }
 }
 void NetSecureClientDriver::UpdateMessageFinal(NetMessage* message)
 {
+    ReleaseInFlight(message);
     if (message->GetState() == NetMessage::Failed)
     {
         message->OnFailed();
@@ -1122,7 +1362,7 @@ void NetSecureClientDriver::SendAck(const ByteT* bytes, SizeT numBytes, const By
         Crypto::HMACBuffer hmac;
         Crypto::SecureRandomBytes(iv.mBytes, sizeof(iv.mBytes));
         ack.SetIV(iv);
-        if (!ack.ComputeHeaderHmac(&mDerivedHMAC, hmac))
+        if (!ack.ComputePacketHmac(&mDerivedHMAC, hmac))
         {
             SetState(Failed);
             return;
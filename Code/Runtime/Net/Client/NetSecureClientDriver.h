@@ -21,6 +21,7 @@
 #pragma once
 #include "Runtime/Net/NetDriver.h"
 
+#include "Core/Crypto/AEAD.h"
 #include "Core/Crypto/ECDH.h"
 #include "Core/Crypto/RSA.h"
 #include "Core/Crypto/AES.h"
@@ -31,10 +32,10 @@
 #include "Core/Platform/SpinLock.h"
 #include "Core/Platform/Thread.h"
 #include "Core/Utility/SmartCallback.h"
-#include "Core/Utility/StdMap.h"
 #include "Core/Utility/Time.h"
 
 #include "Runtime/Net/Client/NetSecureLocalClientConnection.h"
+#include "Runtime/Net/NetReliability.h"
 
 namespace lf {
 
@@ -126,6 +127,10 @@ public:
     // **********************************
     // Sets the 'Ack Timeout' variable, which is the time in seconds before a message
     // can be retransmitted without receiving it's acknowledgement.
+    //
+    // note: Once messages are acknowledged the retransmission timeout is derived from the
+    //       measured round trip time, this is only used as the initial value. (Applied when
+    //       the network is initialized)
     // **********************************
     void SetAckTimeout(Float32 seconds) { mAckTimeout = seconds; }
     Float32 GetAckTimeout() const { return mAckTimeout; }
@@ -138,7 +143,17 @@ public:
     SizeT GetPacketsReceived() const;
     SizeT GetBytesReceived() const;
     SizeT GetRetransmits() const;
+    SizeT GetFastRetransmits() const;
     void LogStats(LoggerMessage& msg) const;
+
+    // **********************************
+    // Reliability state, these are updated with the messages and should only be read from the thread
+    // calling Update.
+    // **********************************
+    Float32 GetSmoothedRTT() const { return mRttEstimator.GetSmoothedRTT(); }
+    Float32 GetRetransmitTimeout() const { return mRttEstimator.GetRTO(); }
+    Float32 GetCongestionWindow() const { return mCongestionWindow.GetWindow(); }
+    SizeT GetMessagesInFlight() const { return mInFlightCount; }
 private:
     enum State
     {
@@ -155,7 +170,32 @@ private:
 
     using MessageID = UInt64;
     using MessagePtr = TAtomicStrongPointer<NetMessage>;
-    using MessageMap = TMap<MessageID, MessagePtr>;
+
+    // ** An acknowledgement read on the background thread, processed with the messages.
+    struct AckEvent
+    {
+        MessageID   mTransmitID;
+        NetPacketType::Value mPacketType;
+        NetSackInfo mSack;
+        bool        mHasSack;
+        Int64       mReceiveTime;
+        UInt32      mAckDelay; // microseconds the server held the ack
+    };
+
+    // ** A slot in the in-flight table, indexed by the low bits of the packet uid.
+    struct InFlightEntry
+    {
+        InFlightEntry() : mMessage(), mPacketUID(0), mTransmits(0), mSendTime(0), mLost(false), mFastRetransmit(false) {}
+
+        MessagePtr mMessage;
+        UInt32     mPacketUID;
+        UInt32     mTransmits;
+        Int64      mSendTime;
+        // ** The selective acks reported the packet as lost, (only detected once)
+        bool       mLost;
+        // ** The packet should be retransmitted without waiting on the timeout
+        bool       mFastRetransmit;
+    };
 
     void SetRunning(bool value);
     void SetState(State value);
@@ -177,6 +217,14 @@ private:
 
     void ProcessMessage(const ByteT* bytes, SizeT numBytes, NetMessageController* controller);
     void ProcessMessageAck(const ByteT* bytes, SizeT numBytes);
+    void ProcessAckEvents();
+    void AcknowledgeSack(const NetSackInfo& sack);
+    void AcknowledgeInFlight(InFlightEntry& entry, bool sampleRtt, Int64 receiveTime, UInt32 ackDelay);
+    void DetectLoss(const NetSackInfo& sack);
+    bool RegisterInFlight(const MessagePtr& message);
+    void ReleaseInFlight(NetMessage* message);
+    InFlightEntry* FindInFlight(NetMessage* message);
+    InFlightEntry* FindInFlight(UInt32 packetUID);
 
     void UpdateInitNetwork();
     void UpdateClientHello();
@@ -215,6 +263,8 @@ private:
     Float32         mHeartbeatDelta;
     // ** The maximum time allowed until the client is considered 'disconnected'.
     Float32         mMaxHeartbeatDelta;
+    // ** Whether or not the client requests AEAD packet protection in the ClientHello
+    bool            mRequestAEAD;
 
     struct HandshakeData
     {
@@ -232,6 +282,9 @@ private:
 
     Crypto::AESKey  mDerivedSecretKey;
     Crypto::HMACKey mDerivedHMAC;
+    // ** Cached AEAD cipher contexts keyed with the derived secret key, only initialized if the server accepted AEAD.
+    Crypto::AEADContext mAEADEncrypt;
+    Crypto::AEADContext mAEADDecrypt;
     Crypto::RSAKey  mClientSigningKey;
     Crypto::RSAKey  mServerSigningKey;
     SessionID       mSessionID;
@@ -252,12 +305,23 @@ private:
     // ********************************** 
     RWSpinLock         mMessageControllerLocks[MessageType::MAX_VALUE];
     TStrongPointer<NetMessageController> mMessageControllers[MessageType::MAX_VALUE];
-    mutable RWSpinLock mMessageMapLock;
-    MessageMap         mMessageMap;
     SpinLock           mNewMessagesLock;
     TVector<MessagePtr> mNewMessages;
     TVector<MessagePtr> mMessages;
 
+    // ********************************** 
+    // Reliability (Only accessed on the thread calling Update, except the ack events)
+    // ********************************** 
+    SpinLock              mAckEventLock;
+    TVector<AckEvent>     mAckEvents;
+    TVector<AckEvent>     mAckEventsProcessing;
+    // ** Messages awaiting acknowledgement, a message waits in 'Register' if its slot is still in use.
+    TVector<InFlightEntry> mInFlight;
+    SizeT                 mInFlightCount;
+    UInt32                mHighestSentUID;
+    NetRttEstimator       mRttEstimator;
+    NetCongestionWindow   mCongestionWindow;
+
     // ********************************** 
     // Heartbeat Processing
     // ********************************** 
@@ -281,6 +345,7 @@ private:
         , mPacketsReceived(0)
         , mBytesReceived(0)
         , mRetransmits(0)
+        , mFastRetransmits(0)
         {}
 
         // The number of received packets that we're dropped
@@ -295,6 +360,8 @@ private:
         volatile Atomic64 mBytesReceived;
         // The number of packets we had to retransmit.
         volatile Atomic64 mRetransmits;
+        // The number of retransmits triggered by selective acks rather than a timeout.
+        volatile Atomic64 mFastRetransmits;
     };
     Stats mStats;
 };
@@ -125,6 +125,11 @@ public:
     // This event is fired if the NetDriver fails to process a message. (OnMessageData will not be called)
     // ********************************** 
     virtual void OnMessageDataError(NetMessageDataErrorArgs& args) = 0;
+    // ********************************** 
+    // Controllers are called from the NetDriver's worker threads. By default the driver
+    // serializes the calls to a controller, return true to receive them concurrently.
+    // ********************************** 
+    virtual bool IsThreadSafe() const { return false; }
 };
 
 }
\ No newline at end of file
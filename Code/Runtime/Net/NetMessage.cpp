@@ -20,6 +20,7 @@
 // ********************************************************************
 #include "Runtime/PCH.h"
 #include "NetMessage.h"
+#include "Core/Crypto/AEAD.h"
 #include "Core/Crypto/AES.h"
 #include "Core/Crypto/HMAC.h"
 #include "Core/Crypto/RSA.h"
@@ -72,9 +73,19 @@ bool NetMessage::Serialize(UInt32 packetUID, const NetKeySet& keySet, const NetS
     }
 
     // Verify Arguments:
-    const bool encrypt = true; // todo: ((mOptions & NetDriver::OPTION_ENCRYPT) > 0);
+    // AEAD packets are encrypted and authenticated by the seal so the CBC encryption/data hmac are skipped.
+    const bool aead = keySet.mAEAD != nullptr;
+    const bool encrypt = !aead; // todo: ((mOptions & NetDriver::OPTION_ENCRYPT) > 0);
     const bool signCompute = ((mOptions & NetDriver::OPTION_SIGNED) > 0);
-    const bool hmacCompute = ((mOptions & NetDriver::OPTION_HMAC) > 0);
+    const bool hmacCompute = !aead && ((mOptions & NetDriver::OPTION_HMAC) > 0);
+    if (aead && (!keySet.mAEAD->IsInitialized() || !keySet.mAEAD->IsEncrypt()))
+    {
+        return false;
+    }
+    if (!aead && (!keySet.mHmacKey || keySet.mHmacKey->Empty()))
+    {
+        return false;
+    }
     if (encrypt && (!keySet.mDerivedSecretKey || keySet.mDerivedSecretKey->GetKeySize() == Crypto::AES_KEY_Unknown))
     {
         return false;
@@ -143,6 +154,18 @@ bool NetMessage::Serialize(UInt32 packetUID, const NetKeySet& keySet, const NetS
             return false;
         }
     }
+    if (aead)
+    {
+        // The flags are authenticated with the header so the signature flag must be set before sealing.
+        if (signCompute)
+        {
+            ps.SetFlag(NetPacketFlag::NET_PACKET_FLAG_SIGNED);
+        }
+        if (!ps.Seal(keySet.mAEAD))
+        {
+            return false;
+        }
+    }
     if (signCompute)
     {
         if (!ps.Sign(keySet.mSigningKey))
@@ -150,6 +173,7 @@ bool NetMessage::Serialize(UInt32 packetUID, const NetKeySet& keySet, const NetS
             return false;
         }
     }
+    if (!aead)
     {
         Crypto::HMACBuffer hmac;
         if (!ps.ComputeHeaderHmac(keySet.mHmacKey, hmac))
@@ -64,6 +64,7 @@ public:
     LF_INLINE Float64 GetTransmitDelta() const { return mRetransmitTimer.PeekDelta(); }
     LF_INLINE bool HasTransmitStarted() const { return mRetransmitTimer.IsRunning(); }
     LF_INLINE UInt64 GetID() const { return mID; }
+    NetPacketType::Value GetPacketType() const;
     LF_INLINE NetConnection* GetConnection() const { return mConnection; }
     LF_INLINE const ByteT* GetPacketBytes() const { return mPacketData.data(); }
     LF_INLINE SizeT GetPacketBytesSize() const { return mPacketData.size(); }
@@ -74,7 +75,6 @@ public:
 
 private:
     SizeT GetSizeEstimate() const;
-    NetPacketType::Value GetPacketType() const;
 
     // ** The current state of the message
     volatile Atomic32 mState;
@@ -0,0 +1,275 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#include "Runtime/PCH.h"
+#include "NetReliability.h"
+#include "Core/Common/Assert.h"
+#include "Core/Math/MathFunctions.h"
+#include "Core/Utility/Utility.h"
+
+namespace lf {
+
+// RFC 6298 gains
+static const Float32 RTT_ALPHA = 0.125f;
+static const Float32 RTT_BETA = 0.25f;
+static const Float32 RTT_VARIANCE_SCALE = 4.0f;
+
+static const Float32 DEFAULT_INITIAL_RTO = 3.0f;
+static const Float32 DEFAULT_MIN_RTO = 0.2f;
+static const Float32 DEFAULT_MAX_RTO = 60.0f;
+
+static const Float32 DEFAULT_INITIAL_WINDOW = 4.0f;
+static const Float32 DEFAULT_MAX_WINDOW = 256.0f;
+static const Float32 MIN_WINDOW = 1.0f;
+static const Float32 MIN_SLOW_START_THRESHOLD = 2.0f;
+
+bool NetSackContains(const NetSackInfo& sack, UInt32 packetUID)
+{
+    const Int32 delta = NetPacketUIDDelta(sack.mLatest, packetUID);
+    if (delta == 0)
+    {
+        return true;
+    }
+    if (delta < 0 || static_cast<SizeT>(delta) > NET_SACK_WINDOW_SIZE)
+    {
+        return false;
+    }
+    return (sack.mBits & (1ULL << (delta - 1))) != 0;
+}
+
+SizeT NetSackCountAfter(const NetSackInfo& sack, UInt32 packetUID)
+{
+    const Int32 delta = NetPacketUIDDelta(sack.mLatest, packetUID);
+    if (delta <= 0)
+    {
+        return 0;
+    }
+    // Bits [0, delta - 1) are the packets between packetUID and the latest
+    const SizeT between = static_cast<SizeT>(delta - 1);
+    const UInt64 mask = between >= NET_SACK_WINDOW_SIZE ? ~0ULL : ((1ULL << between) - 1);
+    return 1 + BitCount(sack.mBits & mask);
+}
+
+SizeT NetWriteMessageAck(UInt64 transmitID, const NetSackInfo& sack, UInt32 ackDelay, ByteT* outBytes, SizeT outSize)
+{
+    if (!outBytes || outSize < NET_MESSAGE_DELAYED_ACK_SIZE)
+    {
+        return 0;
+    }
+    memcpy(outBytes, &transmitID, sizeof(transmitID));
+    memcpy(outBytes + sizeof(transmitID), &sack.mLatest, sizeof(sack.mLatest));
+    memcpy(outBytes + sizeof(transmitID) + sizeof(sack.mLatest), &sack.mBits, sizeof(sack.mBits));
+    memcpy(outBytes + NET_MESSAGE_SACK_ACK_SIZE, &ackDelay, sizeof(ackDelay));
+    return NET_MESSAGE_DELAYED_ACK_SIZE;
+}
+
+bool NetReadMessageAck(const ByteT* bytes, SizeT numBytes, UInt64& outTransmitID, NetSackInfo& outSack, bool& outHasSack, UInt32& outAckDelay)
+{
+    outHasSack = false;
+    outAckDelay = 0;
+    if (!bytes || (numBytes != NET_MESSAGE_ACK_SIZE && numBytes != NET_MESSAGE_SACK_ACK_SIZE && numBytes != NET_MESSAGE_DELAYED_ACK_SIZE))
+    {
+        return false;
+    }
+    memcpy(&outTransmitID, bytes, sizeof(outTransmitID));
+    if (numBytes >= NET_MESSAGE_SACK_ACK_SIZE)
+    {
+        memcpy(&outSack.mLatest, bytes + sizeof(outTransmitID), sizeof(outSack.mLatest));
+        memcpy(&outSack.mBits, bytes + sizeof(outTransmitID) + sizeof(outSack.mLatest), sizeof(outSack.mBits));
+        outHasSack = true;
+    }
+    if (numBytes == NET_MESSAGE_DELAYED_ACK_SIZE)
+    {
+        memcpy(&outAckDelay, bytes + NET_MESSAGE_SACK_ACK_SIZE, sizeof(outAckDelay));
+    }
+    return true;
+}
+
+NetSackWindow::NetSackWindow()
+: mInfo()
+, mEmpty(true)
+{}
+
+void NetSackWindow::Record(UInt32 packetUID)
+{
+    if (mEmpty)
+    {
+        mInfo.mLatest = packetUID;
+        mInfo.mBits = 0;
+        mEmpty = false;
+        return;
+    }
+
+    const Int32 delta = NetPacketUIDDelta(packetUID, mInfo.mLatest);
+    if (delta > 0)
+    {
+        // Slide the window forward, the old latest becomes bit 'delta - 1'
+        const SizeT shift = static_cast<SizeT>(delta);
+        UInt64 bits = shift >= NET_SACK_WINDOW_SIZE ? 0 : (mInfo.mBits << shift);
+        if (shift - 1 < NET_SACK_WINDOW_SIZE)
+        {
+            bits |= 1ULL << (shift - 1);
+        }
+        mInfo.mBits = bits;
+        mInfo.mLatest = packetUID;
+    }
+    else if (delta < 0)
+    {
+        const SizeT index = static_cast<SizeT>(-delta) - 1;
+        if (index < NET_SACK_WINDOW_SIZE)
+        {
+            mInfo.mBits |= 1ULL << index;
+        }
+    }
+}
+
+void NetSackWindow::Clear()
+{
+    mInfo = NetSackInfo();
+    mEmpty = true;
+}
+
+NetRttEstimator::NetRttEstimator()
+: mSmoothedRTT(0.0f)
+, mRTTVariance(0.0f)
+, mRTO(DEFAULT_INITIAL_RTO)
+, mMinRTO(DEFAULT_MIN_RTO)
+, mMaxRTO(DEFAULT_MAX_RTO)
+, mHasSample(false)
+{}
+
+void NetRttEstimator::Reset(Float32 initialRTO)
+{
+    mSmoothedRTT = 0.0f;
+    mRTTVariance = 0.0f;
+    mHasSample = false;
+    mRTO = ClampRTO(initialRTO);
+}
+
+void NetRttEstimator::SetBounds(Float32 minRTO, Float32 maxRTO)
+{
+    Assert(minRTO > 0.0f && minRTO <= maxRTO);
+    mMinRTO = minRTO;
+    mMaxRTO = maxRTO;
+    mRTO = ClampRTO(mRTO);
+}
+
+void NetRttEstimator::Sample(Float32 rtt)
+{
+    if (rtt < 0.0f)
+    {
+        return;
+    }
+
+    if (!mHasSample)
+    {
+        mSmoothedRTT = rtt;
+        mRTTVariance = rtt * 0.5f;
+        mHasSample = true;
+    }
+    else
+    {
+        mRTTVariance = (1.0f - RTT_BETA) * mRTTVariance + RTT_BETA * Abs(mSmoothedRTT - rtt);
+        mSmoothedRTT = (1.0f - RTT_ALPHA) * mSmoothedRTT + RTT_ALPHA * rtt;
+    }
+    mRTO = ClampRTO(mSmoothedRTT + RTT_VARIANCE_SCALE * mRTTVariance);
+}
+
+void NetRttEstimator::Backoff()
+{
+    mRTO = ClampRTO(mRTO * 2.0f);
+}
+
+Float32 NetRttEstimator::ClampRTO(Float32 value) const
+{
+    return Clamp(value, mMinRTO, mMaxRTO);
+}
+
+NetCongestionWindow::NetCongestionWindow()
+: mWindow(DEFAULT_INITIAL_WINDOW)
+, mMaxWindow(DEFAULT_MAX_WINDOW)
+, mSlowStartThreshold(DEFAULT_MAX_WINDOW)
+, mRecoveryPoint(0)
+, mInRecovery(false)
+{}
+
+void NetCongestionWindow::Reset(Float32 initialWindow, Float32 maxWindow)
+{
+    Assert(initialWindow >= MIN_WINDOW && initialWindow <= maxWindow);
+    mWindow = initialWindow;
+    mMaxWindow = maxWindow;
+    mSlowStartThreshold = maxWindow;
+    mRecoveryPoint = 0;
+    mInRecovery = false;
+}
+
+void NetCongestionWindow::OnAck(UInt32 packetUID)
+{
+    if (mInRecovery && NetPacketUIDDelta(packetUID, mRecoveryPoint) > 0)
+    {
+        mInRecovery = false;
+    }
+
+    if (mWindow < mSlowStartThreshold)
+    {
+        mWindow += 1.0f;
+    }
+    else
+    {
+        mWindow += 1.0f / mWindow;
+    }
+    mWindow = Min(mWindow, mMaxWindow);
+}
+
+bool NetCongestionWindow::OnLoss(UInt32 packetUID, UInt32 highestSentUID)
+{
+    if (!BeginRecovery(packetUID, highestSentUID))
+    {
+        return false;
+    }
+    mSlowStartThreshold = Max(mWindow * 0.5f, MIN_SLOW_START_THRESHOLD);
+    mWindow = Max(mSlowStartThreshold, MIN_WINDOW);
+    return true;
+}
+
+bool NetCongestionWindow::OnTimeout(UInt32 packetUID, UInt32 highestSentUID)
+{
+    if (!BeginRecovery(packetUID, highestSentUID))
+    {
+        return false;
+    }
+    mSlowStartThreshold = Max(mWindow * 0.5f, MIN_SLOW_START_THRESHOLD);
+    mWindow = MIN_WINDOW;
+    return true;
+}
+
+bool NetCongestionWindow::BeginRecovery(UInt32 packetUID, UInt32 highestSentUID)
+{
+    // Packets sent before we reacted to the last loss are part of the same congestion event.
+    if (mInRecovery && NetPacketUIDDelta(packetUID, mRecoveryPoint) <= 0)
+    {
+        return false;
+    }
+    mInRecovery = true;
+    mRecoveryPoint = highestSentUID;
+    return true;
+}
+
+} // namespace lf
@@ -0,0 +1,174 @@
+// ********************************************************************
+// Copyright (c) 2022 Nathan Hanlan
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a 
+// copy of this software and associated documentation files(the "Software"), 
+// to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and / or sell copies of the Software, and to permit persons to whom the 
+// Software is furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in 
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ********************************************************************
+#pragma once
+#include "Core/Net/NetTypes.h"
+
+namespace lf {
+
+// ** The number of packets (before the latest) a selective ack can describe.
+static const SizeT NET_SACK_WINDOW_SIZE = 64;
+// ** The number of later packets that must be acknowledged before an unacknowledged packet is considered lost.
+static const SizeT NET_SACK_LOSS_THRESHOLD = 3;
+
+// **********************************
+// Returns the signed distance between two packet uids, this is safe across the 32 bit wrap.
+// (a > b = positive, a < b = negative)
+// **********************************
+LF_INLINE Int32 NetPacketUIDDelta(UInt32 a, UInt32 b) { return static_cast<Int32>(a - b); }
+
+// **********************************
+// The selective acknowledgement piggybacked on message acks.
+//
+// mLatest - The most recent packet uid the receiver has seen.
+// mBits   - Bit 'i' is set if the packet 'mLatest - 1 - i' was received.
+// **********************************
+struct NetSackInfo
+{
+    NetSackInfo() : mLatest(0), mBits(0) {}
+
+    UInt32 mLatest;
+    UInt64 mBits;
+};
+
+// **********************************
+// Returns true if the sack acknowledges the packet
+// **********************************
+LF_RUNTIME_API bool NetSackContains(const NetSackInfo& sack, UInt32 packetUID);
+// **********************************
+// Returns the number of packets acknowledged by the sack that were sent after the packet.
+// **********************************
+LF_RUNTIME_API SizeT NetSackCountAfter(const NetSackInfo& sack, UInt32 packetUID);
+
+// ** Size of a message ack payload: [UInt64 TransmitID]
+static const SizeT NET_MESSAGE_ACK_SIZE = sizeof(UInt64);
+// ** Size of a message ack payload with a selective ack: [UInt64 TransmitID][UInt32 Latest][UInt64 Bits]
+static const SizeT NET_MESSAGE_SACK_ACK_SIZE = sizeof(UInt64) + sizeof(UInt32) + sizeof(UInt64);
+// ** Size of a message ack payload with a selective ack and the ack delay: [SACK ACK][UInt32 AckDelay (microseconds)]
+static const SizeT NET_MESSAGE_DELAYED_ACK_SIZE = NET_MESSAGE_SACK_ACK_SIZE + sizeof(UInt32);
+// ** The receiver acks immediately once this many packets are waiting on an ack.
+static const SizeT NET_DELAYED_ACK_PACKETS = 2;
+// ** The longest time (in seconds) the receiver holds an ack before sending it.
+static const Float32 NET_DELAYED_ACK_TIME = 0.01f;
+
+// **********************************
+// Writes a message ack payload with the selective ack and the time (in microseconds) the receiver
+// held the ack, returns the number of bytes written or 0 if the buffer is too small.
+// **********************************
+LF_RUNTIME_API SizeT NetWriteMessageAck(UInt64 transmitID, const NetSackInfo& sack, UInt32 ackDelay, ByteT* outBytes, SizeT outSize);
+// **********************************
+// Reads a message ack payload, the selective ack and ack delay are optional (outHasSack is false if
+// the peer only sent the transmit id, outAckDelay is 0 if the peer didn't send it)
+// **********************************
+LF_RUNTIME_API bool NetReadMessageAck(const ByteT* bytes, SizeT numBytes, UInt64& outTransmitID, NetSackInfo& outSack, bool& outHasSack, UInt32& outAckDelay);
+
+// **********************************
+// Receiver side record of the most recent packets received from a peer, used to build the
+// NetSackInfo sent back with each ack.
+//
+// note: This is not thread safe.
+// **********************************
+class LF_RUNTIME_API NetSackWindow
+{
+public:
+    NetSackWindow();
+
+    void Record(UInt32 packetUID);
+    void Clear();
+    LF_INLINE bool Empty() const { return mEmpty; }
+    LF_INLINE const NetSackInfo& GetInfo() const { return mInfo; }
+private:
+    NetSackInfo mInfo;
+    bool        mEmpty;
+};
+
+// **********************************
+// Round trip time estimator based on RFC 6298. The retransmission timeout is
+// SRTT + 4 * RTTVAR clamped to [min,max]. Until the first sample is taken the
+// initial RTO is used.
+//
+// note: Callers should follow Karn's rule and not sample retransmitted packets.
+// note: This is not thread safe.
+// **********************************
+class LF_RUNTIME_API NetRttEstimator
+{
+public:
+    NetRttEstimator();
+
+    void Reset(Float32 initialRTO);
+    void SetBounds(Float32 minRTO, Float32 maxRTO);
+    // ** Adds a round trip time sample (in seconds), this also clears any backoff.
+    void Sample(Float32 rtt);
+    // ** Doubles the RTO after a retransmission timeout.
+    void Backoff();
+
+    LF_INLINE bool HasSample() const { return mHasSample; }
+    LF_INLINE Float32 GetSmoothedRTT() const { return mSmoothedRTT; }
+    LF_INLINE Float32 GetRTTVariance() const { return mRTTVariance; }
+    LF_INLINE Float32 GetRTO() const { return mRTO; }
+private:
+    Float32 ClampRTO(Float32 value) const;
+
+    Float32 mSmoothedRTT;
+    Float32 mRTTVariance;
+    Float32 mRTO;
+    Float32 mMinRTO;
+    Float32 mMaxRTO;
+    bool    mHasSample;
+};
+
+// **********************************
+// AIMD congestion window (Reno style) measured in packets.
+//
+// * Slow start grows the window by 1 per ack until the slow start threshold.
+// * Congestion avoidance grows the window by 1/window per ack.
+// * A loss halves the window, only once per window of data (the recovery point is the
+//   highest packet sent at the time of the loss).
+// * A retransmission timeout collapses the window to the minimum.
+//
+// note: This is not thread safe.
+// **********************************
+class LF_RUNTIME_API NetCongestionWindow
+{
+public:
+    NetCongestionWindow();
+
+    void Reset(Float32 initialWindow, Float32 maxWindow);
+    void OnAck(UInt32 packetUID);
+    // ** Returns true if the loss started a new congestion event (and the window was reduced)
+    bool OnLoss(UInt32 packetUID, UInt32 highestSentUID);
+    // ** Returns true if the timeout started a new congestion event (and the window was reduced)
+    bool OnTimeout(UInt32 packetUID, UInt32 highestSentUID);
+
+    LF_INLINE bool CanSend(SizeT inFlight) const { return static_cast<Float32>(inFlight) < mWindow; }
+    LF_INLINE bool InRecovery() const { return mInRecovery; }
+    LF_INLINE Float32 GetWindow() const { return mWindow; }
+    LF_INLINE Float32 GetSlowStartThreshold() const { return mSlowStartThreshold; }
+private:
+    bool BeginRecovery(UInt32 packetUID, UInt32 highestSentUID);
+
+    Float32 mWindow;
+    Float32 mMaxWindow;
+    Float32 mSlowStartThreshold;
+    UInt32  mRecoveryPoint;
+    bool    mInRecovery;
+};
+
+} // namespace lf
@@ -30,6 +30,7 @@ class LF_RUNTIME_API NetTransmitInfo
 public:
     NetTransmitInfo() : mData(0) {}
     NetTransmitInfo(UInt32 id, UInt32 crc32) : mData(0) { SetID(id), SetCrc32(crc32); }
+    explicit NetTransmitInfo(UInt64 value) : mData(value) {}
 
     LF_INLINE UInt32 GetID() const { return reinterpret_cast<const UInt32*>(&mData)[0]; }
     LF_INLINE UInt32 GetCrc32() const { return reinterpret_cast<const UInt32*>(&mData)[1]; }
@@ -21,6 +21,7 @@
 #include "Runtime/PCH.h"
 #include "PacketSerializer.h"
 #include "Core/Common/Assert.h"
+#include "Core/Crypto/AEAD.h"
 #include "Core/Crypto/RSA.h"
 #include "Core/Crypto/SHA256.h"
 #include "Core/Utility/Crc32.h"
@@ -385,6 +386,22 @@ bool PacketSerializer::ComputeHeaderHmac(const Crypto::HMACKey* key, Crypto::HMA
     return true;
 }
 
+bool PacketSerializer::ComputePacketHmac(const Crypto::HMACKey* key, Crypto::HMACBuffer& hmac) const
+{
+    CriticalAssert(mBuffer != nullptr);
+    if (key->Empty())
+    {
+        return false;
+    }
+
+    const FullHeader* header = reinterpret_cast<const FullHeader*>(mBuffer);
+
+    const ByteT* begin = &header->mBaseHeader.mFlags[0];
+    const ByteT* end = &header->mSecurityHeader.mEncryptedHMAC[0];
+
+    return key->Compute(begin, end - begin, GetDataPointer(), mDataSize, hmac);
+}
+
 bool PacketSerializer::SetDataHMAC(const Crypto::HMACBuffer& hmac)
 {
     CriticalAssert(mBuffer != nullptr);
@@ -502,6 +519,72 @@ bool PacketSerializer::Verify(const Crypto::RSAKey* key) const
     return true;
 }
 
+bool PacketSerializer::Seal(Crypto::AEADContext* context)
+{
+    CriticalAssert(mBuffer != nullptr);
+    if (mReadOnly)
+    {
+        ReportBugMsg("Invalid operation, the serializer is set to read only.");
+        return false;
+    }
+
+    if (!context || !context->IsInitialized() || !context->IsEncrypt())
+    {
+        ReportBugMsg("Invalid argument 'context'.");
+        return false;
+    }
+
+    if (HasFlag(NetPacketFlag::NET_PACKET_FLAG_HMAC))
+    {
+        ReportBugMsg("Invalid operation, AEAD packets cannot contain a data hmac.");
+        return false;
+    }
+
+    SetFlag(NetPacketFlag::NET_PACKET_FLAG_AEAD);
+    FullHeader* header = reinterpret_cast<FullHeader*>(mBuffer);
+    const ByteT* begin = &header->mBaseHeader.mFlags[0];
+    const ByteT* end = &header->mSecurityHeader.mEncryptedHMAC[0];
+
+    memset(header->mSecurityHeader.mEncryptedHMAC, 0, sizeof(header->mSecurityHeader.mEncryptedHMAC));
+    ByteT* data = GetDataPointer();
+    if (!context->Encrypt(header->mSecurityHeader.mIV, begin, end - begin, data, mDataSize, data, header->mSecurityHeader.mEncryptedHMAC))
+    {
+        UnsetFlag(NetPacketFlag::NET_PACKET_FLAG_AEAD);
+        return false;
+    }
+    return true;
+}
+
+bool PacketSerializer::Open(Crypto::AEADContext* context, ByteT* outData, SizeT& inOutSize) const
+{
+    CriticalAssert(mBuffer != nullptr);
+    if (!context || !context->IsInitialized() || context->IsEncrypt())
+    {
+        ReportBugMsg("Invalid argument 'context'.");
+        return false;
+    }
+
+    if (!HasFlag(NetPacketFlag::NET_PACKET_FLAG_AEAD) || HasFlag(NetPacketFlag::NET_PACKET_FLAG_HMAC))
+    {
+        return false;
+    }
+
+    if (mDataSize > inOutSize)
+    {
+        return false;
+    }
+
+    const FullHeader* header = reinterpret_cast<const FullHeader*>(mBuffer);
+    const ByteT* begin = &header->mBaseHeader.mFlags[0];
+    const ByteT* end = &header->mSecurityHeader.mEncryptedHMAC[0];
+    if (!context->Decrypt(header->mSecurityHeader.mIV, begin, end - begin, GetDataPointer(), mDataSize, outData, header->mSecurityHeader.mEncryptedHMAC))
+    {
+        return false;
+    }
+    inOutSize = mDataSize;
+    return true;
+}
+
 ByteT* PacketSerializer::GetHeaderPointer()
 {
     return mBuffer;
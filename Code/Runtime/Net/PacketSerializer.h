@@ -29,6 +29,7 @@
 namespace lf {
 namespace Crypto {
 class RSAKey;
+class AEADContext;
 } // namespace Crypto
 
 // Helper class eases the ability of setting certain attributes of a packet.
@@ -48,6 +49,9 @@ class RSAKey;
 // -------------
 // SetData
 // -------------
+// Seal           *AEAD packets only, authenticates the header so any flags (eg SIGNED) must be set before.
+//                 The tag is stored in place of the header hmac so SetHeaderHmac/SetDataHMAC are not used.
+// -------------
 // SetDataHMAC    *Hmac must know how much data there is in order to place it at the right spot
 // ------------- 
 // Sign           *Signature needs to know how much data there is
@@ -95,11 +99,27 @@ public:
 
     UInt32 CalcCrc32() const;
     bool ComputeHeaderHmac(const Crypto::HMACKey* key, Crypto::HMACBuffer& hmac);
+    // ********************************************************************
+    // Computes an hmac over the header (flags through IV) followed by the data, for packets
+    // like acks that carry unencrypted data which must not be swapped onto another header.
+    // (Equal to the header hmac if there is no data)
+    // ********************************************************************
+    bool ComputePacketHmac(const Crypto::HMACKey* key, Crypto::HMACBuffer& hmac) const;
 
     bool SetDataHMAC(const Crypto::HMACBuffer& hmac);
     bool GetDataHMAC(Crypto::HMACBuffer& hmac) const;
     bool Sign(const Crypto::RSAKey* key);
     bool Verify(const Crypto::RSAKey* key) const;
+
+    // ********************************************************************
+    // Encrypts the data in place with the first AEAD_NONCE_SIZE bytes of the IV as the
+    // nonce and the header (flags through IV) as associated data.
+    // ********************************************************************
+    bool Seal(Crypto::AEADContext* context);
+    // ********************************************************************
+    // Authenticates the header/data and decrypts the data into outData.
+    // ********************************************************************
+    bool Open(Crypto::AEADContext* context, ByteT* outData, SizeT& inOutSize) const;
 private:
     
 
@@ -37,11 +37,18 @@ NetSecureServerConnection::NetSecureServerConnection()
 , mServerSigningKey()
 , mDerivedSecretKey()
 , mDerivedHMAC()
+, mAEADCipher(Crypto::AEAD_Unknown)
+, mAEADEncrypt()
+, mAEADDecrypt()
 , mServerCertificate(nullptr)
 , mEndPoint()
 , mConnectionID()
 , mHeartbeatTimer()
 , mTransmitBuffers()
+, mSackWindow()
+, mPendingAck()
+, mPendingAckCount(0)
+, mSackLock()
 , mState(0)
 , mPacketUID(0)
 , mHandshakeLock()
@@ -113,6 +120,41 @@ bool NetSecureServerConnection::IsHandshakeComplete() const
 {
     return AtomicLoad(&mWaitingHandshake) == 0;
 }
+bool NetSecureServerConnection::RecordReceivedPacket(UInt64 transmitID, NetPacketType::Value packetType, Int64 receiveTime, PendingAck& outAck)
+{
+    const UInt32 packetUID = NetTransmitInfo(transmitID).GetID();
+    ScopeLock lock(mSackLock);
+    // Duplicates mean the client is missing our ack and gaps mean it may be missing a packet, ack those right away.
+    const bool duplicate = !mSackWindow.Empty() && NetSackContains(mSackWindow.GetInfo(), packetUID);
+    const bool inOrder = mSackWindow.Empty() || mSackWindow.GetInfo().mLatest + 1 == packetUID;
+    mSackWindow.Record(packetUID);
+
+    mPendingAck.mTransmitID = transmitID;
+    mPendingAck.mPacketType = packetType;
+    mPendingAck.mSack = mSackWindow.GetInfo();
+    mPendingAck.mReceiveTime = receiveTime;
+    ++mPendingAckCount;
+    if (duplicate || !inOrder || mPendingAckCount >= NET_DELAYED_ACK_PACKETS)
+    {
+        outAck = mPendingAck;
+        mPendingAckCount = 0;
+        return true;
+    }
+    return false;
+}
+
+bool NetSecureServerConnection::TakePendingAck(Int64 time, Int64 delay, PendingAck& outAck)
+{
+    ScopeLock lock(mSackLock);
+    if (mPendingAckCount == 0 || time - mPendingAck.mReceiveTime < delay)
+    {
+        return false;
+    }
+    outAck = mPendingAck;
+    outAck.mSack = mSackWindow.GetInfo();
+    mPendingAckCount = 0;
+    return true;
+}
 
 
 bool NetSecureServerConnection::Initialize(const SessionID& connectionID, Crypto::RSAKey* serverCertificate, const IPEndPointAny& endPoint)
@@ -141,6 +183,17 @@ bool NetSecureServerConnection::Initialize(const SessionID& connectionID, Crypto
     return true;
 }
 
+bool NetSecureServerConnection::SetAEADCipher(Crypto::AEADCipher cipher)
+{
+    if (GetState() != NetworkInit)
+    {
+        ReportBugMsg("Invalid operation 'NetSecureServerConnection cannot change the AEAD cipher after it's been NetworkInitialized.'");
+        return false;
+    }
+    mAEADCipher = cipher;
+    return true;
+}
+
 bool NetSecureServerConnection::SerializeClientHandshakeData(const ByteT* bytes, SizeT numBytes)
 {
     if (GetState() != NetworkInit)
@@ -200,6 +253,14 @@ bool NetSecureServerConnection::GenerateServerHandshakeData()
         return false;
     }
 
+    if (IsAEAD() 
+        && (!mAEADEncrypt.Initialize(mAEADCipher, &mDerivedSecretKey, true) 
+        || !mAEADDecrypt.Initialize(mAEADCipher, &mDerivedSecretKey, false)))
+    {
+        gNetLog.Error(LogMessage("GenerateServerHandshakeData failed to create the AEAD cipher contexts."));
+        return false;
+    }
+
     return true;
 }
 
@@ -237,6 +298,10 @@ bool NetSecureServerConnection::GenerateServerHelloPacket(const NetServerDriverC
     ps.SetAppId(config.mAppID);
     ps.SetAppVersion(config.mAppVersion);
     ps.SetFlags(0);
+    if (IsAEAD())
+    {
+        ps.SetFlag(NetPacketFlag::NET_PACKET_FLAG_AEAD);
+    }
     ps.SetType(static_cast<UInt8>(mHandshakeData->mServerHelloMsg.mType));
     ps.SetPacketUID(GetPacketUID());
     ps.SetSessionID(mConnectionID);
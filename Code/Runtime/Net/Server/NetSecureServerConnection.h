@@ -22,12 +22,14 @@
 
 #include "Runtime/Net/NetConnection.h"
 #include "Core/Crypto/ECDH.h"
+#include "Core/Crypto/AEAD.h"
 #include "Core/Crypto/AES.h"
 #include "Core/Crypto/HMAC.h"
 #include "Core/Crypto/RSA.h"
 #include "Core/Memory/SmartPointer.h"
 #include "Core/Platform/SpinLock.h"
 #include "Core/Utility/Time.h"
+#include "Runtime/Net/NetReliability.h"
 #include "Runtime/Net/NetTransmit.h"
 
 namespace lf
@@ -57,6 +59,17 @@ public:
         Failed
     };
 
+    // ** An acknowledgement for the most recent packet received, with the selective ack of the packets before it.
+    struct PendingAck
+    {
+        PendingAck() : mTransmitID(0), mPacketType(NetPacketType::INVALID_ENUM), mSack(), mReceiveTime(0) {}
+
+        UInt64               mTransmitID;
+        NetPacketType::Value mPacketType;
+        NetSackInfo          mSack;
+        Int64                mReceiveTime;
+    };
+
     NetSecureServerConnection();
 
     String GetConnectionName() const;
@@ -69,6 +82,21 @@ public:
     PacketUID GetPacketUID();
     Float64 GetHeartbeatDelta() const { return mHeartbeatTimer.PeekDelta(); }
     bool IsHandshakeComplete() const;
+    // ********************************** 
+    // Records an authenticated packet from the client. Acks are delayed, returns true if the ack
+    // should be sent now (every NET_DELAYED_ACK_PACKETS packets, a duplicate or a packet received out
+    // of order) otherwise the ack is held until the next packet or TakePendingAck.
+    //
+    // @param transmitID -- The transmit id of the packet.
+    // @param packetType -- The type of the packet.
+    // @param receiveTime -- The clock time the packet was received.
+    // @param outAck -- The ack to send, valid if this returns true.
+    // ********************************** 
+    bool RecordReceivedPacket(UInt64 transmitID, NetPacketType::Value packetType, Int64 receiveTime, PendingAck& outAck);
+    // ********************************** 
+    // Takes the held ack if it has been held for at least 'delay' clock ticks.
+    // ********************************** 
+    bool TakePendingAck(Int64 time, Int64 delay, PendingAck& outAck);
 
     // ********************************** 
     // Initializes some basic information for the NetConnection
@@ -78,6 +106,13 @@ public:
     // ********************************** 
     bool Initialize(const SessionID& connectionID, Crypto::RSAKey* serverCertificate, const IPEndPointAny& endPoint);
     // ********************************** 
+    // Selects the AEAD cipher negotiated with the client, the contexts are created once the
+    // shared secret is derived. (AEAD_Unknown uses AES-CBC + HMAC)
+    // 
+    // note: This method should only be called during NetworkInit state
+    // ********************************** 
+    bool SetAEADCipher(Crypto::AEADCipher cipher);
+    // ********************************** 
     // Serializes client handshake information from the given bytes.
     // 
     // note: This method may not be called on multiple threads at once.
@@ -109,6 +144,12 @@ public:
     LF_INLINE const Crypto::AESKey& GetDerivedSecretKey() const { return mDerivedSecretKey; }
     LF_INLINE Crypto::HMACKey& GetDerivedHMAC() { return mDerivedHMAC; }
     LF_INLINE const Crypto::HMACKey& GetDerivedHMAC() const { return mDerivedHMAC; }
+    LF_INLINE bool IsAEAD() const { return mAEADCipher != Crypto::AEAD_Unknown; }
+    LF_INLINE Crypto::AEADCipher GetAEADCipher() const { return mAEADCipher; }
+    // note: The encrypt context is only used by the thread serializing messages, the decrypt context is only
+    //       used by the worker the connection is sharded to.
+    LF_INLINE Crypto::AEADContext& GetAEADEncryptContext() { return mAEADEncrypt; }
+    LF_INLINE Crypto::AEADContext& GetAEADDecryptContext() { return mAEADDecrypt; }
     LF_INLINE NetTransmitBuffer& GetTransmitBuffer(NetPacketType::Value packetType) { return mTransmitBuffers[packetType]; }
 
     // Handshake Data -- This data is not thread safe, acquire and release the lock accordingly
@@ -147,6 +188,11 @@ private:
     Crypto::AESKey  mDerivedSecretKey;
     // ** The derived hmac used to sign headers and data.
     Crypto::HMACKey mDerivedHMAC;
+    // ** The negotiated AEAD cipher
+    Crypto::AEADCipher  mAEADCipher;
+    // ** Cached cipher contexts keyed with the derived secret key (AEAD only)
+    Crypto::AEADContext mAEADEncrypt;
+    Crypto::AEADContext mAEADDecrypt;
     // ** Certificate used to decrypt ServerHello messages
     Crypto::RSAKey* mServerCertificate;
     // ** The ipaddress/port of the client
@@ -157,6 +203,12 @@ private:
     Timer           mHeartbeatTimer;
     // ** Transmit buffer (per packet type) that provide protection/resistance to duplicate packets
     NetTransmitBuffer mTransmitBuffers[NetPacketType::MAX_VALUE];
+    // ** The most recent packets received from the client, sent back as a selective ack
+    NetSackWindow     mSackWindow;
+    // ** The ack held back by the delayed ack, mPendingAckCount packets are waiting on it
+    PendingAck        mPendingAck;
+    SizeT             mPendingAckCount;
+    SpinLock          mSackLock;
 
     volatile Atomic32 mState;
     volatile Atomic32 mPacketUID;
@@ -25,7 +25,9 @@
 #include "Core/Memory/MemoryBuffer.h"
 #include "Core/Platform/Atomic.h"
 #include "Core/Utility/Log.h"
+#include "Core/Utility/Utility.h"
 #include "Runtime/Net/NetMessage.h"
+#include "Runtime/Net/NetReliability.h"
 #include "Runtime/Net/NetSerialization.h"
 #include "Runtime/Net/PacketSerializer.h"
 #include "Runtime/Net/Controllers/NetMessageController.h"
@@ -41,10 +43,13 @@ NetSecureServerDriver::NetSecureServerDriver()
 , mMaxHeartbeatDelta(20.0f)
 , mAckTimeout(3.0f)
 , mMaxRetransmit(3)
+, mAllowAEAD(true)
 // ** Internal Server Resources
 , mSocket()
 , mRunning(0)
-, mThread()
+, mReceiveThreads()
+, mWorkers()
+, mPacketAllocator()
 // ** Connection Control
 , mPrimaryConnectionMapLock()
 , mPrimaryConnectionMap()
@@ -61,7 +66,10 @@ NetSecureServerDriver::NetSecureServerDriver()
 , mNewMessagesLock()
 , mNewMessages()
 , mClientHelloTransmitBuffer()
-, mPacketProcessLock()
+, mPacketFilter()
+, mPacketFilterLock()
+, mHasPacketFilter(0)
+, mDispatchLocks()
 , mStats()
 {
 
@@ -86,6 +94,7 @@ bool NetSecureServerDriver::Initialize(const NetServerDriverConfig& config)
 
     mAppID = config.mAppID;
     mAppVersion = config.mAppVersion;
+    mAllowAEAD = config.mAllowAEAD;
     mCertificateKey = *config.mCertificate;
 
     if (!mSocket.Create(config.mProtocol))
@@ -105,12 +114,42 @@ bool NetSecureServerDriver::Initialize(const NetServerDriverConfig& config)
     const SizeT NET_TRANSMIT_CLIENT_HELLO_SIZE = 100;
     mClientHelloTransmitBuffer.Resize(NET_TRANSMIT_CLIENT_HELLO_SIZE);
 
+    // Each heap holds 'mMaxPendingPackets' buffers, we allow a few heaps to absorb bursts of traffic.
+    const SizeT NET_PACKET_MAX_HEAPS = 4;
+    if (!mPacketAllocator.Initialize(Max<SizeT>(config.mMaxPendingPackets, 1), NET_PACKET_MAX_HEAPS, 0))
+    {
+        gNetLog.Info(LogMessage("Failed to initialize packet allocator."));
+        mSocket.Close();
+        return false;
+    }
+
     SetRunning(true);
 
-    mThread.Fork([](void* param) {
-        reinterpret_cast<NetSecureServerDriver*>(param)->ProcessBackground();
-    }, this);
-    mThread.SetDebugName("NetServer_Background");
+    // Workers must exist before the receivers start routing packets to them.
+    const SizeT workerThreads = Max<SizeT>(config.mWorkerThreads, 1);
+    mWorkers.reserve(workerThreads);
+    for (SizeT i = 0; i < workerThreads; ++i)
+    {
+        PacketWorkerPtr worker(LFNew<PacketWorker>());
+        worker->mDriver = this;
+        CriticalAssert(worker->mFence.Initialize(true));
+        worker->mThread.Fork([](void* param) {
+            PacketWorker* self = reinterpret_cast<PacketWorker*>(param);
+            self->mDriver->ProcessWorker(self);
+        }, static_cast<PacketWorker*>(worker));
+        worker->mThread.SetDebugName("NetServer_Worker");
+        mWorkers.push_back(worker);
+    }
+
+    const SizeT receiveThreads = Max<SizeT>(config.mReceiveThreads, 1);
+    mReceiveThreads.resize(receiveThreads);
+    for (Thread& thread : mReceiveThreads)
+    {
+        thread.Fork([](void* param) {
+            reinterpret_cast<NetSecureServerDriver*>(param)->ProcessBackground();
+        }, this);
+        thread.SetDebugName("NetServer_Background");
+    }
 
     return true;
 }
@@ -124,12 +163,28 @@ void NetSecureServerDriver::Shutdown()
         mSocket.Shutdown();
         closeSocket = false;
     }
-    mThread.Join();
+    for (Thread& thread : mReceiveThreads)
+    {
+        thread.Join();
+    }
+    mReceiveThreads.clear();
     if (closeSocket)
     {
         mSocket.Close();
     }
 
+    // Nothing produces packets anymore, release the workers and whatever they had left to process.
+    for (PacketWorker* worker : mWorkers)
+    {
+        worker->mFence.Set(false);
+        worker->mThread.Join();
+        worker->mFence.Destroy();
+        ReleasePackets(worker->mQueue);
+        ReleasePackets(worker->mProcessing);
+    }
+    mWorkers.clear();
+    mPacketAllocator.Release();
+
     for (SizeT i = 0; i < LF_ARRAY_SIZE(mMessageControllers); ++i)
     {
         ScopeRWSpinLockWrite lock(mMessageControllerLocks[i]);
@@ -213,22 +268,95 @@ bool NetSecureServerDriver::IsClient() const
 
 void NetSecureServerDriver::ProcessBackground()
 {
-    ByteT bytes[2048];
+    const SizeT NET_RECEIVE_BATCH_SIZE = 32;
+    PacketType* packets[NET_RECEIVE_BATCH_SIZE] = { nullptr };
+    UDPPacketBuffer buffers[NET_RECEIVE_BATCH_SIZE];
+    ByteT dropBytes[sizeof(PacketType::mBytes)];
+    // Only hold as many pooled buffers as the socket can fill in one call, the rest are left for the other receivers.
+    const SizeT batchSize = Max<SizeT>(1, Min(NET_RECEIVE_BATCH_SIZE, mSocket.GetMaxReceiveBatch()));
+    SizeT held = 0; // packets [0, held) are owned by this thread but haven't received anything yet
     while (IsRunning())
     {
-        SizeT receivedBytes = sizeof(bytes);
-        IPEndPointAny sender;
-        if (!mSocket.ReceiveFrom(bytes, receivedBytes, sender) || !IsRunning())
+        // Receive straight into pooled buffers so packets can be handed to a worker without a copy.
+        for (; held < batchSize; ++held)
+        {
+            packets[held] = mPacketAllocator.Allocate();
+            if (!packets[held])
+            {
+                break;
+            }
+        }
+
+        SizeT count = held;
+        for (SizeT i = 0; i < count; ++i)
         {
+            buffers[i].mBytes = packets[i]->mBytes;
+            buffers[i].mSize = sizeof(packets[i]->mBytes);
+        }
+
+        const bool exhausted = count == 0;
+        if (exhausted)
+        {
+            buffers[0].mBytes = dropBytes;
+            buffers[0].mSize = sizeof(dropBytes);
+            count = 1;
+        }
+
+        if (!mSocket.ReceiveBatch(buffers, count) || !IsRunning())
+        {
+            continue;
+        }
+
+        if (exhausted)
+        {
+            // Every buffer is in flight, the workers can't keep up so shed the load.
+            AtomicAdd64(&mStats.mDroppedPackets, static_cast<Atomic64>(count));
             continue;
         }
-        
-        ProcessPacketData(bytes, receivedBytes, sender);
+
+        for (SizeT i = 0; i < count; ++i)
+        {
+            packets[i]->mSize = static_cast<UInt16>(buffers[i].mSize);
+            packets[i]->mSender = buffers[i].mEndPoint;
+            EnqueuePacket(packets[i]);
+        }
+
+        // Compact the unused buffers to the front for the next batch.
+        for (SizeT i = count; i < held; ++i)
+        {
+            packets[i - count] = packets[i];
+        }
+        for (SizeT i = held - count; i < held; ++i)
+        {
+            packets[i] = nullptr;
+        }
+        held -= count;
+    }
+
+    for (SizeT i = 0; i < held; ++i)
+    {
+        mPacketAllocator.Free(packets[i]);
     }
 
     gSysLog.Info(LogMessage("Terminating NetSecureServerDriver::ProcessBackground"));
 }
 
+void NetSecureServerDriver::ReleasePackets(TVector<PacketType*>& packets)
+{
+    for (PacketType* packet : packets)
+    {
+        mPacketAllocator.Free(packet);
+    }
+    packets.clear();
+}
+
+void NetSecureServerDriver::SetPacketFilter(const PacketFilter& filter)
+{
+    ScopeLock lock(mPacketFilterLock);
+    mPacketFilter = filter;
+    AtomicStore(&mHasPacketFilter, mPacketFilter.IsValid() ? 1 : 0);
+}
+
 bool NetSecureServerDriver::IsRunning() const
 {
     return AtomicLoad(&mRunning) != 0;
@@ -236,15 +364,94 @@ bool NetSecureServerDriver::IsRunning() const
 
 void NetSecureServerDriver::ProcessPacketData(const ByteT* bytes, const SizeT numBytes, const IPEndPointAny& endPoint)
 {
-    ScopeLock lock(mPacketProcessLock);
+    PacketType* packet = numBytes <= sizeof(PacketType::mBytes) ? mPacketAllocator.Allocate() : nullptr;
+    if (!packet)
+    {
+        AtomicIncrement64(&mStats.mDroppedPackets);
+        return;
+    }
+
+    memcpy(packet->mBytes, bytes, numBytes);
+    packet->mSize = static_cast<UInt16>(numBytes);
+    packet->mSender = endPoint;
+    EnqueuePacket(packet);
+}
+
+void NetSecureServerDriver::ProcessWorker(PacketWorker* worker)
+{
+    // The fence is auto reset, a packet enqueued between the swap and the wait leaves it open
+    // so the wait returns immediately instead of missing the wakeup.
+    while (IsRunning())
+    {
+        {
+            ScopeLock lock(worker->mQueueLock);
+            worker->mQueue.swap(worker->mProcessing);
+        }
+
+        if (worker->mProcessing.empty())
+        {
+            worker->mFence.Wait();
+            continue;
+        }
+
+        for (PacketType* packet : worker->mProcessing)
+        {
+            ProcessPacket(packet->mBytes, packet->mSize, packet->mSender);
+        }
+        ReleasePackets(worker->mProcessing);
+    }
+
+    gSysLog.Info(LogMessage("Terminating NetSecureServerDriver::ProcessWorker"));
+}
+
+NetSecureServerDriver::PacketWorker* NetSecureServerDriver::SelectWorker(const ByteT* bytes, SizeT numBytes)
+{
+    // Client hellos carry no session and share the certificate key/hello transmit buffer, so they
+    // are always processed by the first worker. Malformed packets are dropped by whichever worker gets them.
+    PacketSerializer ps;
+    if (mWorkers.size() == 1 || !ps.SetBuffer(bytes, numBytes) || ps.GetType() == NetPacketType::NET_PACKET_TYPE_CLIENT_HELLO)
+    {
+        return mWorkers[0];
+    }
+
+    // Session IDs are securely random so the leading bytes are a good enough hash.
+    SessionID sessionID = ps.GetSessionID();
+    UInt32 hash = 0;
+    memcpy(&hash, sessionID.Bytes(), Min<SizeT>(sizeof(hash), sessionID.Size()));
+    return mWorkers[hash % mWorkers.size()];
+}
 
-    if (mPacketFilter.IsValid() && mPacketFilter.Invoke(bytes, numBytes, endPoint))
+void NetSecureServerDriver::EnqueuePacket(PacketType* packet)
+{
+    if (mWorkers.empty())
     {
+        AtomicIncrement64(&mStats.mDroppedPackets);
+        mPacketAllocator.Free(packet);
         return;
     }
+
+    if (AtomicLoad(&mHasPacketFilter) != 0)
+    {
+        ScopeLock lock(mPacketFilterLock);
+        if (mPacketFilter.IsValid() && mPacketFilter.Invoke(packet->mBytes, packet->mSize, packet->mSender))
+        {
+            mPacketAllocator.Free(packet);
+            return;
+        }
+    }
     AtomicIncrement64(&mStats.mPacketsReceived);
-    AtomicAdd64(&mStats.mBytesReceived, numBytes);
+    AtomicAdd64(&mStats.mBytesReceived, packet->mSize);
+
+    PacketWorker* worker = SelectWorker(packet->mBytes, packet->mSize);
+    {
+        ScopeLock lock(worker->mQueueLock);
+        worker->mQueue.push_back(packet);
+    }
+    worker->mFence.Set(false);
+}
 
+void NetSecureServerDriver::ProcessPacket(const ByteT* bytes, SizeT numBytes, const IPEndPointAny& endPoint)
+{
     PacketSerializer ps;
     if (!ps.SetBuffer(bytes, numBytes))
     {
@@ -353,6 +560,13 @@ SizeT NetSecureServerDriver::GetDroppedPackets() const
 {
     return static_cast<SizeT>(AtomicLoad(&mStats.mDroppedPackets));
 }
+SizeT NetSecureServerDriver::GetFreePackets() const
+{
+    const DynamicPoolHeap& heap = mPacketAllocator.GetHeap();
+    const SizeT allocations = heap.GetAllocations();
+    const SizeT maxAllocations = heap.GetMaxAllocations();
+    return allocations < maxAllocations ? maxAllocations - allocations : 0;
+}
 SizeT NetSecureServerDriver::GetPacketsSent() const
 {
     return static_cast<SizeT>(AtomicLoad(&mStats.mPacketsSent));
@@ -399,12 +613,12 @@ void NetSecureServerDriver::SetRunning(bool value)
     AtomicStore(&mRunning, value);
 }
 
-void NetSecureServerDriver::CreateSessionFromBytes(const ByteT* bytes, SizeT bytesSize, const IPEndPointAny& endPoint)
+void NetSecureServerDriver::CreateSessionFromBytes(const ByteT* bytes, SizeT bytesSize, const IPEndPointAny& endPoint, Crypto::AEADCipher cipher)
 {
     ConnectionPtr connection = MakeConvertibleAtomicPtr<NetSecureServerConnection>();
     
     connection->SetState(ConnectionState::NetworkInit);
-    if (!connection->SerializeClientHandshakeData(bytes, bytesSize))
+    if (!connection->SerializeClientHandshakeData(bytes, bytesSize) || !connection->SetAEADCipher(cipher))
     {
         return;
     }
@@ -501,7 +715,9 @@ void NetSecureServerDriver::AcceptConnection(const ByteT* bytes, SizeT bytesSize
     }
 
     gNetLog.Info(LogMessage("Creating session from bytes..."));
-    CreateSessionFromBytes(&plainText[KEY_SIZE], plainTextSize, endPoint);
+    // The client requests AEAD with the packet flag, the server acknowledges it with the same flag in the SERVER_HELLO
+    const Crypto::AEADCipher cipher = mAllowAEAD && ps.HasFlag(NetPacketFlag::NET_PACKET_FLAG_AEAD) ? Crypto::AEAD_AES_256_GCM : Crypto::AEAD_Unknown;
+    CreateSessionFromBytes(&plainText[KEY_SIZE], plainTextSize, endPoint, cipher);
 }
 
 void NetSecureServerDriver::OnHeartbeat(const ByteT* bytes, SizeT bytesSize, const IPEndPointAny& endPoint)
@@ -562,17 +778,17 @@ void NetSecureServerDriver::OnServerHelloAck(const ByteT* bytes, SizeT bytesSize
 void NetSecureServerDriver::OnResponse(const ByteT* bytes, SizeT numBytes)
 {
     ScopeRWSpinLockRead lock(mMessageControllerLocks[MESSAGE_RESPONSE]);
-    ProcessMessage(bytes, numBytes, mMessageControllers[MESSAGE_RESPONSE]);
+    ProcessMessage(bytes, numBytes, MESSAGE_RESPONSE);
 }
 void NetSecureServerDriver::OnRequest(const ByteT* bytes, SizeT numBytes)
 {
     ScopeRWSpinLockRead lock(mMessageControllerLocks[MESSAGE_REQUEST]);
-    ProcessMessage(bytes, numBytes, mMessageControllers[MESSAGE_REQUEST]);
+    ProcessMessage(bytes, numBytes, MESSAGE_REQUEST);
 }
 void NetSecureServerDriver::OnMessage(const ByteT* bytes, SizeT numBytes)
 {
     ScopeRWSpinLockRead lock(mMessageControllerLocks[MESSAGE_GENERIC]);
-    ProcessMessage(bytes, numBytes, mMessageControllers[MESSAGE_GENERIC]);
+    ProcessMessage(bytes, numBytes, MESSAGE_GENERIC);
 }
 void NetSecureServerDriver::OnResponseAck(const ByteT* bytes, SizeT numBytes)
 {
@@ -587,8 +803,9 @@ void NetSecureServerDriver::OnMessageAck(const ByteT* bytes, SizeT numBytes)
     ProcessMessageAck(bytes, numBytes);
 }
 
-void NetSecureServerDriver::ProcessMessage(const ByteT* bytes, SizeT numBytes, NetMessageController* controller)
+void NetSecureServerDriver::ProcessMessage(const ByteT* bytes, SizeT numBytes, MessageType messageType)
 {
+    NetMessageController* controller = mMessageControllers[messageType];
     PacketSerializer ps;
     Assert(ps.SetBuffer(bytes, numBytes));
     ConnectionPtr connection = StaticCast<ConnectionPtr>(FindConnection(ps.GetSessionID()));
@@ -598,8 +815,23 @@ void NetSecureServerDriver::ProcessMessage(const ByteT* bytes, SizeT numBytes, N
         return;
     }
 
+    // AEAD connections authenticate (and decrypt) the packet up front, the tag covers the header so a packet
+    // can't be acked/deduplicated without it. A packet that doesn't match the negotiated mode is rejected.
+    const bool aead = ps.HasFlag(NetPacketFlag::NET_PACKET_FLAG_AEAD);
+    ByteT plainText[1500] = { 0 };
+    SizeT plainTextLength = sizeof(plainText);
     Crypto::HMACBuffer hmac;
-    if (!ps.ComputeHeaderHmac(&connection->GetDerivedHMAC(), hmac) || hmac != ps.GetEncryptedHMAC())
+    bool authenticated = false;
+    if (connection->IsAEAD())
+    {
+        authenticated = aead && ps.Open(&connection->GetAEADDecryptContext(), plainText, plainTextLength);
+    }
+    else
+    {
+        authenticated = !aead && ps.ComputeHeaderHmac(&connection->GetDerivedHMAC(), hmac) && hmac == ps.GetEncryptedHMAC();
+    }
+
+    if (!authenticated)
     {
         if (controller)
         {
@@ -608,16 +840,21 @@ void NetSecureServerDriver::ProcessMessage(const ByteT* bytes, SizeT numBytes, N
             args.mPacketDataLength = numBytes;
             args.mConnection = connection;
             args.mError = NetMessageDataError::DATA_ERROR_INVALID_HEADER_HMAC;
-            controller->OnMessageDataError(args);
+            DispatchMessageDataError(messageType, args);
         }
         AtomicIncrement64(&mStats.mDroppedPackets);
         return;
     }
 
-    // Emit the Ack?
+    // Emit the Ack, with a selective ack of the recent packets so the client can recover from lost acks
+    // and detect loss without waiting on a timeout. The ack is cumulative so only every other packet is
+    // acked immediately, a held ack is flushed by UpdateServerReady after NET_DELAYED_ACK_TIME.
     NetTransmitInfo transmitID(ps.GetPacketUID(), ps.GetCrc32());
-    UInt64 id = transmitID.Value();
-    SendAck(bytes, numBytes, connection, reinterpret_cast<ByteT*>(&id), sizeof(id));
+    ConnectionType::PendingAck pendingAck;
+    if (connection->RecordReceivedPacket(transmitID.Value(), static_cast<NetPacketType::Value>(ps.GetType()), GetClockTime(), pendingAck))
+    {
+        SendMessageAck(connection, pendingAck);
+    }
     if (!controller)
     {
         return;
@@ -633,7 +870,7 @@ void NetSecureServerDriver::ProcessMessage(const ByteT* bytes, SizeT numBytes, N
     }
 
     const bool signVerify = ps.HasFlag(NetPacketFlag::NET_PACKET_FLAG_SIGNED);
-    const bool hmacVerify = ps.HasFlag(NetPacketFlag::NET_PACKET_FLAG_HMAC);
+    const bool hmacVerify = !aead && ps.HasFlag(NetPacketFlag::NET_PACKET_FLAG_HMAC);
     const bool encrypted = true; //  ps.HasFlag(NetPacketFlag::NET_PACKET_FLAG_SECURE); // todo: 
     if (signVerify && !ps.Verify(&connection->GetClientSigningKey()))
     {
@@ -642,58 +879,61 @@ void NetSecureServerDriver::ProcessMessage(const ByteT* bytes, SizeT numBytes, N
         args.mPacketDataLength = numBytes;
         args.mConnection = connection;
         args.mError = NetMessageDataError::DATA_ERROR_INVALID_SIGNATURE;
-        controller->OnMessageDataError(args);
+        DispatchMessageDataError(messageType, args);
         return;
     }
 
     ByteT cipherText[1500] = { 0 };
     SizeT cipherTextLength = sizeof(cipherText);
-    if (!ps.GetData(cipherText, cipherTextLength))
-    {
-        NetMessageDataErrorArgs args;
-        args.mPacketData = bytes;
-        args.mPacketDataLength = numBytes;
-        args.mConnection = connection;
-        args.mError = NetMessageDataError::DATA_ERROR_DATA_RETRIEVAL;
-        controller->OnMessageDataError(args);
-        return;
-    }
-
-    if (hmacVerify)
+    ByteT* dataPtr = plainText;
+    SizeT  dataLength = plainTextLength;
+    if (!aead)
     {
-        Crypto::HMACBuffer dataHmac;
-        if (!ps.GetDataHMAC(dataHmac)
-            || !connection->GetDerivedHMAC().Compute(cipherText, cipherTextLength, hmac)
-            || dataHmac != hmac)
+        if (!ps.GetData(cipherText, cipherTextLength))
         {
             NetMessageDataErrorArgs args;
             args.mPacketData = bytes;
             args.mPacketDataLength = numBytes;
             args.mConnection = connection;
-            args.mError = NetMessageDataError::DATA_ERROR_INVALID_HMAC;
-            controller->OnMessageDataError(args);
+            args.mError = NetMessageDataError::DATA_ERROR_DATA_RETRIEVAL;
+            DispatchMessageDataError(messageType, args);
             return;
         }
-    }
 
-    ByteT plainText[1500] = { 0 };
-    SizeT plainTextLength = sizeof(plainText);
-    ByteT* dataPtr = cipherText;
-    SizeT  dataLength = cipherTextLength;
-    if (encrypted)
-    {
-        if (!Crypto::AESDecrypt(&connection->GetDerivedSecretKey(), ps.GetIV().mBytes, cipherText, cipherTextLength, plainText, plainTextLength))
+        if (hmacVerify)
         {
-            NetMessageDataErrorArgs args;
-            args.mPacketData = bytes;
-            args.mPacketDataLength = numBytes;
-            args.mConnection = connection;
-            args.mError = NetMessageDataError::DATA_ERROR_DATA_DECRYPTION;
-            controller->OnMessageDataError(args);
-            return;
+            Crypto::HMACBuffer dataHmac;
+            if (!ps.GetDataHMAC(dataHmac)
+                || !connection->GetDerivedHMAC().Compute(cipherText, cipherTextLength, hmac)
+                || dataHmac != hmac)
+            {
+                NetMessageDataErrorArgs args;
+                args.mPacketData = bytes;
+                args.mPacketDataLength = numBytes;
+                args.mConnection = connection;
+                args.mError = NetMessageDataError::DATA_ERROR_INVALID_HMAC;
+                DispatchMessageDataError(messageType, args);
+                return;
+            }
+        }
+
+        dataPtr = cipherText;
+        dataLength = cipherTextLength;
+        if (encrypted)
+        {
+            if (!Crypto::AESDecrypt(&connection->GetDerivedSecretKey(), ps.GetIV().mBytes, cipherText, cipherTextLength, plainText, plainTextLength))
+            {
+                NetMessageDataErrorArgs args;
+                args.mPacketData = bytes;
+                args.mPacketDataLength = numBytes;
+                args.mConnection = connection;
+                args.mError = NetMessageDataError::DATA_ERROR_DATA_DECRYPTION;
+                DispatchMessageDataError(messageType, args);
+                return;
+            }
+            dataPtr = plainText;
+            dataLength = plainTextLength;
         }
-        dataPtr = plainText;
-        dataLength = plainTextLength;
     }
 
     {
@@ -704,8 +944,32 @@ void NetSecureServerDriver::ProcessMessage(const ByteT* bytes, SizeT numBytes, N
         args.mEncrypted = encrypted;
         args.mHmacVerified = hmacVerify;
         args.mSignatureVerified = signVerify;
+        DispatchMessageData(messageType, args);
+    }
+}
+
+void NetSecureServerDriver::DispatchMessageData(MessageType messageType, NetMessageDataArgs& args)
+{
+    NetMessageController* controller = mMessageControllers[messageType];
+    if (controller->IsThreadSafe())
+    {
         controller->OnMessageData(args);
+        return;
+    }
+    ScopeLock lock(mDispatchLocks[messageType]);
+    controller->OnMessageData(args);
+}
+
+void NetSecureServerDriver::DispatchMessageDataError(MessageType messageType, NetMessageDataErrorArgs& args)
+{
+    NetMessageController* controller = mMessageControllers[messageType];
+    if (controller->IsThreadSafe())
+    {
+        controller->OnMessageDataError(args);
+        return;
     }
+    ScopeLock lock(mDispatchLocks[messageType]);
+    controller->OnMessageDataError(args);
 }
 
 void NetSecureServerDriver::ProcessMessageAck(const ByteT* bytes, SizeT numBytes) 
@@ -721,7 +985,7 @@ void NetSecureServerDriver::ProcessMessageAck(const ByteT* bytes, SizeT numBytes
     }
 
     Crypto::HMACBuffer hmac;
-    if (!ps.ComputeHeaderHmac(&connection->GetDerivedHMAC(), hmac) || hmac != ps.GetEncryptedHMAC())
+    if (!ps.ComputePacketHmac(&connection->GetDerivedHMAC(), hmac) || hmac != ps.GetEncryptedHMAC())
     {
         AtomicIncrement64(&mStats.mDroppedPackets);
         return;
@@ -729,14 +993,21 @@ void NetSecureServerDriver::ProcessMessageAck(const ByteT* bytes, SizeT numBytes
     
     UInt64 id;
     SizeT  dataSize = sizeof(id);
-    if (!ps.GetData(reinterpret_cast<ByteT*>(&id), dataSize))
+    if (!ps.GetData(reinterpret_cast<ByteT*>(&id), dataSize) || dataSize != sizeof(id))
+    {
+        return;
+    }
+
+    // The ack must be for the packet its header says it acknowledges.
+    if (NetTransmitInfo(id).GetID() != ps.GetPacketUID())
     {
+        AtomicIncrement64(&mStats.mDroppedPackets);
         return;
     }
 
     ScopeRWSpinLockRead lock(mMessageMapLock);
     auto iter = mMessageMap.find(id);
-    if (iter != mMessageMap.end() && iter->second)
+    if (iter != mMessageMap.end() && iter->second && iter->second->GetPacketType() == ps.GetType())
     {
         NetMessage* message = iter->second;
         message->SetState(NetMessage::Success);
@@ -908,6 +1179,16 @@ void NetSecureServerDriver::UpdateServerReady(ConnectionType* connection)
         }
     }
 
+    if (connection->IsHandshakeComplete())
+    {
+        const Int64 delay = static_cast<Int64>(static_cast<Float64>(NET_DELAYED_ACK_TIME) * static_cast<Float64>(GetClockFrequency()));
+        ConnectionType::PendingAck pendingAck;
+        if (connection->TakePendingAck(GetClockTime(), delay, pendingAck))
+        {
+            SendMessageAck(connection, pendingAck);
+        }
+    }
+
     if (connection->GetHeartbeatDelta() > mMaxHeartbeatDelta)
     {
         gSysLog.Info(LogMessage("Server: Session disconnected ") << connection->GetConnectionName());
@@ -1009,6 +1290,7 @@ void NetSecureServerDriver::UpdateMessageSerialize(NetMessage* message)
     keySet.mHmacKey = &connection->GetDerivedHMAC();
     keySet.mSigningKey = &connection->GetServerSigningKey();
     keySet.mVerifyKey = nullptr; // Shouldn't be needed for this op
+    keySet.mAEAD = connection->IsAEAD() ? &connection->GetAEADEncryptContext() : nullptr;
 
     NetServerDriverConfig config;
     config.mAppID = mAppID;
@@ -1059,16 +1341,32 @@ void NetSecureServerDriver::SendAck(const ByteT* bytes, SizeT numBytes, Connecti
 {
     PacketSerializer ps;
     Assert(ps.SetBuffer(bytes, numBytes)); // This should not fail as we should've already passed basic header checks in the initial processing
+    SendAck(connection, static_cast<NetPacketType::Value>(ps.GetType()), ps.GetPacketUID(), data, dataLength);
+}
+
+void NetSecureServerDriver::SendMessageAck(ConnectionType* connection, const ConnectionType::PendingAck& pendingAck)
+{
+    // The client subtracts the time we held the ack from its RTT sample.
+    const Int64 heldTicks = Max<Int64>(GetClockTime() - pendingAck.mReceiveTime, 0);
+    const Float64 heldMicroseconds = static_cast<Float64>(heldTicks) * 1000000.0 / static_cast<Float64>(GetClockFrequency());
+    const UInt32 ackDelay = static_cast<UInt32>(Min(heldMicroseconds, 4294967295.0));
+
+    ByteT ackData[NET_MESSAGE_DELAYED_ACK_SIZE];
+    const SizeT ackDataLength = NetWriteMessageAck(pendingAck.mTransmitID, pendingAck.mSack, ackDelay, ackData, sizeof(ackData));
+    SendAck(connection, pendingAck.mPacketType, NetTransmitInfo(pendingAck.mTransmitID).GetID(), ackData, ackDataLength);
+}
 
+void NetSecureServerDriver::SendAck(ConnectionType* connection, NetPacketType::Value packetType, UInt32 packetUID, const ByteT* data, SizeT dataLength)
+{
     ByteT ackBytes[256] = { 0 };
     PacketSerializer ack;
     ack.SetBuffer(ackBytes, sizeof(ackBytes));
     ack.SetAppId(mAppID);
     ack.SetAppVersion(mAppVersion);
     ack.SetFlag(NetPacketFlag::NET_PACKET_FLAG_ACK);
-    ack.SetType(ps.GetType());
-    ack.SetPacketUID(ps.GetPacketUID());
-    ack.SetSessionID(ps.GetSessionID());
+    ack.SetType(packetType);
+    ack.SetPacketUID(packetUID);
+    ack.SetSessionID(connection->GetConnectionID());
 
     if (data && !ack.SetData(data, dataLength))
     {
@@ -1083,7 +1381,8 @@ void NetSecureServerDriver::SendAck(const ByteT* bytes, SizeT numBytes, Connecti
         Crypto::HMACBuffer hmac;
         Crypto::SecureRandomBytes(iv.mBytes, sizeof(iv.mBytes));
         ack.SetIV(iv);
-        if (!ack.ComputeHeaderHmac(&connection->GetDerivedHMAC(), hmac))
+        // The ack data (transmit id/sack) drives the client's retransmission and congestion control, so it's authenticated with the header.
+        if (!ack.ComputePacketHmac(&connection->GetDerivedHMAC(), hmac))
         {
             connection->SetState(ConnectionState::Failed);
             return;
@@ -28,6 +28,7 @@
 #include "Core/Crypto/HMAC.h"
 #include "Core/Concurrent/TaskScheduler.h"
 #include "Core/Platform/Thread.h"
+#include "Core/Platform/ThreadFence.h"
 #include "Core/Platform/SpinLock.h"
 #include "Core/Platform/RWSpinLock.h"
 #include "Core/Memory/SmartPointer.h"
@@ -39,6 +40,7 @@
 #include "Core/Utility/Time.h"
 
 #include "Runtime/Net/NetTransmit.h"
+#include "Runtime/Net/PacketAllocator.h"
 #include "Runtime/Net/Server/NetSecureServerConnection.h"
 
 namespace lf {
@@ -46,6 +48,8 @@ namespace lf {
 struct LoggerMessage;
 class NetMessage;
 class NetMessageController;
+struct NetMessageDataArgs;
+struct NetMessageDataErrorArgs;
 
 class LF_RUNTIME_API NetSecureServerDriver : public NetDriver
 {
@@ -86,7 +90,7 @@ public:
     bool IsRunning() const;
 
     void ProcessPacketData(const ByteT* bytes, const SizeT numBytes, const IPEndPointAny& endPoint);
-    void SetPacketFilter(const PacketFilter& filter) { mPacketFilter = filter; }
+    void SetPacketFilter(const PacketFilter& filter);
 
     void SetTimeout(Float32 seconds) { mMaxHeartbeatDelta = seconds; }
     Float32 GetTimeout() const { return mMaxHeartbeatDelta; }
@@ -101,6 +105,8 @@ public:
     SizeT GetRetransmits() const;
     SizeT GetConnectionsAccepted() const;
     SizeT GetDroppedDuplicatePackets() const;
+    SizeT GetWorkerCount() const { return mWorkers.size(); }
+    SizeT GetFreePackets() const; // Pooled packet buffers not held by a receiver, worker or queue
     void LogStats(LoggerMessage& msg) const;
 private:
     using ConnectionState = NetSecureServerConnection::State;
@@ -111,10 +117,41 @@ private:
     using MessageID = UInt64;
     using MessagePtr = TAtomicStrongPointer<NetMessage>;
     using MessageMap = TMap<MessageID, MessagePtr>;
+
+    using PacketType = PacketData2048;
+
+    // ** Processes the packets of the sessions that hash to it, in the order they were received.
+    struct PacketWorker
+    {
+        PacketWorker()
+        : mDriver(nullptr)
+        , mThread()
+        , mFence()
+        , mQueueLock()
+        , mQueue()
+        , mProcessing()
+        {}
+
+        NetSecureServerDriver* mDriver;
+        Thread               mThread;
+        ThreadFence          mFence;
+        SpinLock             mQueueLock;
+        // ** [ Lock on enqueue(RT) | swap(WT) ]
+        TVector<PacketType*> mQueue;
+        // ** Only accessed by the worker thread
+        TVector<PacketType*> mProcessing;
+    };
+    using PacketWorkerPtr = TStrongPointer<PacketWorker>;
     
     void SetRunning(bool value);
 
-    void CreateSessionFromBytes(const ByteT* bytes, SizeT bytesSize, const IPEndPointAny& endPoint);
+    void ProcessWorker(PacketWorker* worker);
+    PacketWorker* SelectWorker(const ByteT* bytes, SizeT numBytes);
+    void EnqueuePacket(PacketType* packet);
+    void ProcessPacket(const ByteT* bytes, SizeT numBytes, const IPEndPointAny& endPoint);
+    void ReleasePackets(TVector<PacketType*>& packets);
+
+    void CreateSessionFromBytes(const ByteT* bytes, SizeT bytesSize, const IPEndPointAny& endPoint, Crypto::AEADCipher cipher);
     void AcceptConnection(const ByteT* bytes, SizeT bytesSize, const IPEndPointAny& endPoint);
     void OnHeartbeat(const ByteT* bytes, SizeT bytesSize, const IPEndPointAny& endPoint);
     void OnServerHelloAck(const ByteT* bytes, SizeT bytesSize, const IPEndPointAny& endPoint);
@@ -126,8 +163,10 @@ private:
     void OnRequestAck(const ByteT* bytes, SizeT numBytes);
     void OnMessageAck(const ByteT* bytes, SizeT numBytes);
 
-    void ProcessMessage(const ByteT* bytes, SizeT numBytes, NetMessageController* controller);
+    void ProcessMessage(const ByteT* bytes, SizeT numBytes, MessageType messageType);
     void ProcessMessageAck(const ByteT* bytes, SizeT numBytes);
+    void DispatchMessageData(MessageType messageType, NetMessageDataArgs& args);
+    void DispatchMessageDataError(MessageType messageType, NetMessageDataErrorArgs& args);
 
     void UpdateConnections();
     void UpdateConnection(ConnectionType* connection);
@@ -142,6 +181,8 @@ private:
     void UpdateMessageFinal(NetMessage* message);
 
     void SendAck(const ByteT* bytes, SizeT numBytes, ConnectionType* connection, const ByteT* data, SizeT dataLength);
+    void SendAck(ConnectionType* connection, NetPacketType::Value packetType, UInt32 packetUID, const ByteT* data, SizeT dataLength);
+    void SendMessageAck(ConnectionType* connection, const ConnectionType::PendingAck& pendingAck);
     void SendAck(const ByteT* bytes, SizeT numBytes, const IPEndPointAny& endPoint);
 
     // ********************************** 
@@ -154,6 +195,7 @@ private:
     Float32   mMaxHeartbeatDelta; // Config at runtime
     Float32   mAckTimeout;        // Config at runtime
     SizeT     mMaxRetransmit;     // Config at runtime
+    bool      mAllowAEAD;         // Config on init
 
     // ********************************** 
     // Internal Server Resources
@@ -162,12 +204,14 @@ private:
     // ** The socket we use to receive all incoming traffic
     UDPSocket mSocket;
 
-    // ** Variable that controls whether or not the background receiver thread runs.
+    // ** Variable that controls whether or not the background receiver/worker threads run.
     volatile Atomic32  mRunning;
-    // ** The background receiver thread
-    Thread    mThread;
-    // ** A scheduler that dispatches packet processing tasks
-    TaskScheduler mProcessPacketDispatcher;
+    // ** The background receiver threads, they only filter and route packets to a worker
+    TVector<Thread> mReceiveThreads;
+    // ** The packet processing workers, a session is always routed to the same worker
+    TVector<PacketWorkerPtr> mWorkers;
+    // ** Pooled buffers handed from the receiver threads to the workers
+    TPacketAllocator<PacketType> mPacketAllocator;
     // ** A scheduler that dispatches tasks on the 'main' thread (when update is called)
     TaskScheduler mMainThreadDispatcher;
     
@@ -204,7 +248,13 @@ private:
 
     NetTransmitBuffer mClientHelloTransmitBuffer;
     PacketFilter mPacketFilter;
-    SpinLock     mPacketProcessLock;
+    // ** Packet filters are stateful, [ Lock on filter(RT) | SetPacketFilter ]
+    SpinLock     mPacketFilterLock;
+    // ** Lets the receivers skip the filter lock when there is no filter
+    volatile Atomic32 mHasPacketFilter;
+    // ** Controllers are not required to be thread-safe, each one is serialized on its own lock unless it opts out.
+    // ** [ Lock on OnMessageData/OnMessageDataError(WT) ]
+    SpinLock     mDispatchLocks[MessageType::MAX_VALUE];
 
     struct Stats
     {
@@ -63,6 +63,7 @@ ReflectionMgr& GetReflectionMgr()
 
 ReflectionMgr::ReflectionMgr() :
     mTypes(),
+    mTypeLookup(),
     mTypeUInt8(nullptr),
     mTypeUInt16(nullptr),
     mTypeUInt32(nullptr),
@@ -268,38 +269,153 @@ void ReflectionMgr::BuildTypes()
     }
     typeInfos.clear();
 
+    BuildTypeLookup();
+    BuildTypeHierarchy();
+
     InternalHooks::gFindType = FindTypeHook;
 }
 void ReflectionMgr::ReleaseTypes()
 {
+    mTypeLookup.clear();
     mTypes.clear();
 }
 
-const Type* ReflectionMgr::FindType(const Token& name) const
+// ** Tokens are interned so the string address identifies the name.
+static SizeT HashTypeName(const char* name)
 {
-    // todo: When we get 1000's of types we may want to precalculate this with a map
-    //       eg. return mTypesByName[name];
+    UInt64 value = static_cast<UInt64>(reinterpret_cast<UIntPtrT>(name));
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    return static_cast<SizeT>(value);
+}
 
-    if (name.Empty())
+const Type* ReflectionMgr::FindType(const Token& name) const
+{
+    if (name.Empty() || mTypeLookup.empty())
     {
         return nullptr;
     }
 
-    for (const Type& type : mTypes)
+    const SizeT mask = mTypeLookup.size() - 1;
+    for (SizeT i = HashTypeName(name.CStr()) & mask; ; i = (i + 1) & mask)
     {
-        if (type.GetFullName() == name)
+        const TypeLookupEntry& entry = mTypeLookup[i];
+        if (entry.mName == name.CStr())
+        {
+            return entry.mType;
+        }
+        if (entry.mName == nullptr)
         {
-            return &type;
+            return nullptr;
         }
     }
+}
+
+void ReflectionMgr::BuildTypeLookup()
+{
+    // ** Keep the load factor under 50%, every type can insert both its full name and name.
+    SizeT capacity = 16;
+    while (capacity < mTypes.size() * 4)
+    {
+        capacity <<= 1;
+    }
+
+    TypeLookupEntry empty;
+    empty.mName = nullptr;
+    empty.mType = nullptr;
+    mTypeLookup.clear();
+    mTypeLookup.resize(capacity, empty);
+
+    // ** Full names take priority over names, and the first type registered wins a name.
     for (const Type& type : mTypes)
     {
-        if (type.GetName() == name)
+        InsertTypeLookup(type.GetFullName(), &type);
+    }
+    for (const Type& type : mTypes)
+    {
+        InsertTypeLookup(type.GetName(), &type);
+    }
+}
+
+void ReflectionMgr::InsertTypeLookup(const Token& name, const Type* type)
+{
+    if (name.Empty())
+    {
+        return;
+    }
+
+    const SizeT mask = mTypeLookup.size() - 1;
+    for (SizeT i = HashTypeName(name.CStr()) & mask; ; i = (i + 1) & mask)
+    {
+        TypeLookupEntry& entry = mTypeLookup[i];
+        if (entry.mName == name.CStr())
+        {
+            return;
+        }
+        if (entry.mName == nullptr)
+        {
+            entry.mName = name.CStr();
+            entry.mType = type;
+            return;
+        }
+    }
+}
+
+void ReflectionMgr::BuildTypeHierarchy()
+{
+    const SizeT numTypes = mTypes.size();
+
+    // ** Children of each type as a linked list of indices (first child, next sibling)
+    TVector<SizeT> firstChild;
+    TVector<SizeT> nextSibling;
+    firstChild.resize(numTypes, INVALID);
+    nextSibling.resize(numTypes, INVALID);
+    for (SizeT i = numTypes; i > 0; --i)
+    {
+        const SizeT index = i - 1;
+        const Type* super = mTypes[index].mSuper;
+        if (super)
+        {
+            const SizeT superIndex = static_cast<SizeT>(super - mTypes.data());
+            nextSibling[index] = firstChild[superIndex];
+            firstChild[superIndex] = index;
+        }
+    }
+
+    // ** Depth first traversal of every root, with an explicit stack (the hierarchy can be deep)
+    UInt32 preOrder = 0;
+    UInt32 postOrder = 0;
+    TVector<SizeT> stack;
+    for (SizeT root = 0; root < numTypes; ++root)
+    {
+        if (mTypes[root].mSuper)
+        {
+            continue;
+        }
+
+        mTypes[root].mPreOrder = preOrder++;
+        stack.push_back(root);
+        TVector<SizeT> cursor; // ** Next child to visit of each type on the stack
+        cursor.push_back(firstChild[root]);
+        while (!stack.empty())
         {
-            return &type;
+            const SizeT child = cursor.back();
+            if (Valid(child))
+            {
+                cursor.back() = nextSibling[child];
+                mTypes[child].mPreOrder = preOrder++;
+                stack.push_back(child);
+                cursor.push_back(firstChild[child]);
+            }
+            else
+            {
+                mTypes[stack.back()].mPostOrder = postOrder++;
+                stack.pop_back();
+                cursor.pop_back();
+            }
         }
     }
-    return nullptr;
 }
 
 TVector<const Type*> ReflectionMgr::FindAll(const Type* base, bool includeAbstract) const
@@ -176,7 +176,20 @@ public:
     TypeIterator GetTypesEnd() const { return mTypes.end(); }
 
 private:
+    // ** An entry in the name lookup, keyed by the interned token string
+    struct TypeLookupEntry
+    {
+        const char* mName;
+        const Type* mType;
+    };
+
     void Inherit(Type* target, Type* source);
+    // ** Builds the hashed name -> type lookup used by FindType
+    void BuildTypeLookup();
+    // ** Inserts into the lookup unless the name is already present
+    void InsertTypeLookup(const Token& name, const Type* type);
+    // ** Numbers the types with a pre/post-order traversal of the class hierarchy, used by Type::IsA
+    void BuildTypeHierarchy();
 
     template<typename T>
     void InitializeConvertible(TAtomicStrongPointer<T>& object, PointerConvertibleType) const
@@ -201,6 +214,8 @@ private:
     }
 
     TVector<Type> mTypes;
+    // ** Open addressing table of type names (full names and names), size is a power of two
+    TVector<TypeLookupEntry> mTypeLookup;
 
     // Native types:
     const Type* mTypeUInt8;